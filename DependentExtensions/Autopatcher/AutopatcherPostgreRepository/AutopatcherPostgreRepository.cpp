@@ -63,6 +63,13 @@ AutopatcherPostgreRepository::~AutopatcherPostgreRepository()
 	if (filePartConnection)
 		PQfinish(filePartConnection);
 }
+void AutopatcherPostgreRepository::SetHashCache(const char *cacheFile)
+{
+	if (cacheFile==0)
+		hashCacheFile.Clear();
+	else
+		hashCacheFile=cacheFile;
+}
 bool AutopatcherPostgreRepository::CreateAutopatcherTables(void)
 {
 	if (isConnected==false)
@@ -1083,6 +1090,7 @@ bool AutopatcherPostgreRepository::UpdateApplicationFiles(const char *applicatio
 {
 	FileList filesOnHarddrive;
 	filesOnHarddrive.AddCallback(cb);
+	filesOnHarddrive.SetHashCache(hashCacheFile.C_String());
 	filesOnHarddrive.AddFilesFromDirectory(applicationDirectory,"", true, false, true, FileListNodeContext(0,0,0,0));
 	if (filesOnHarddrive.fileList.Size()==0)
 	{
@@ -1509,6 +1517,7 @@ bool AutopatcherPostgreRepository2::UpdateApplicationFiles(const char *applicati
 {
 	FileList filesOnHarddrive;
 	filesOnHarddrive.AddCallback(cb);
+	filesOnHarddrive.SetHashCache(hashCacheFile.C_String());
 	filesOnHarddrive.AddFilesFromDirectory(applicationDirectory,"", true, false, true, FileListNodeContext(0,0,0,0));
 	if (filesOnHarddrive.fileList.Size()==0)
 	{
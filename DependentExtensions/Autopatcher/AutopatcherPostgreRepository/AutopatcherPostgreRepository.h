@@ -77,6 +77,10 @@ public:
 	/// \return True on success, false on failure.
 	virtual bool UpdateApplicationFiles(const char *applicationName, const char *applicationDirectory, const char *userName, FileListProgress *cb);
 
+	/// Keep the hash of each file in \a cacheFile, so that UpdateApplicationFiles() only hashes the files that changed since the last update. See FileList::SetHashCache()
+	/// \param[in] cacheFile Path to the cache file, which does not have to exist yet. Pass 0 to stop using a cache
+	void SetHashCache(const char *cacheFile);
+
 	/// Get list of files added and deleted since a certain date.  This is used by AutopatcherServer and not usually explicitly called.
 	/// \param[in] applicationName A null terminated string previously passed to AddApplication
 	/// \param[out] addedFiles A list of the current versions of filenames with SHA1_LENGTH byte hashes as their data that were created after \a sinceData
@@ -124,6 +128,8 @@ public:
 
 protected:
 	virtual unsigned int GetPatchPart( const char *filename, unsigned int startReadBytes, unsigned int numBytesToRead, void *preallocatedDestination, FileListNodeContext context);
+
+	SLNet::RakString hashCacheFile;
 };
 
 
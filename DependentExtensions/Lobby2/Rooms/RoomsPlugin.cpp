@@ -2243,7 +2243,7 @@ void RoomsPlugin::Chat_Callback( const SystemAddress &senderAddress, Chat_Func *
 	notification.filteredChatMessage=callResult->chatMessage;
 	if (profanityFilter) {
 		char* buffer = notification.filteredChatMessage.C_StringUnsafe();
-		profanityFilter->FilterProfanity(notification.filteredChatMessage.C_String(), buffer, notification.filteredChatMessage.sharedString->bytesUsed, true);
+		profanityFilter->FilterProfanity(notification.filteredChatMessage.C_String(), buffer, notification.filteredChatMessage.GetCapacity(), true);
 	}
 	if (notification.filteredChatMessage==notification.chatMessage)
 		notification.filteredChatMessage.Clear(); // Save bandwidth
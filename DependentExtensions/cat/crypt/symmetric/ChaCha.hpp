@@ -70,6 +70,17 @@ namespace cat {
 		ChaChaOutput cco(cck, message_iv);
         cco.Crypt(ciphertext, decrypted, sizeof(decrypted));
 
+    To encrypt or decrypt several messages in place, each with its own IV:
+
+        u8 *messages[3]; // messages filled here
+        int message_bytes[3];
+        u64 message_ivs[3] = { iv, iv + 1, iv + 2 };
+
+        ChaChaOutput::CryptMany(cck, message_ivs, messages, message_bytes, 3);
+
+    CryptMany() generates the key stream for four blocks at once with SSE2,
+    also when the blocks belong to different short messages.
+
     Sending all 8 bytes of the IV in every packet is not necessary.
     Instead, only a few of the low bits of the IV need to be sent,
     if the IV is incremented by 1 each time.
@@ -137,6 +148,9 @@ public:
 
 	// Message with any number of bytes
 	void Crypt(const void *in, void *out, int bytes);
+
+	// Messages with any number of bytes, each with its own IV, crypted in place
+	static void CryptMany(const ChaChaKey &key, const u64 *ivs, u8 *const *buffers, const int *bytes, int count);
 };
 
 
@@ -117,6 +117,9 @@ protected:
     bool IsValidIV(u64 iv);
     void AcceptIV(u64 iv);
 
+    // Truncated MAC of the full IV and a message
+    void GenerateMAC(HMAC_MD5 *mac_key, u64 iv, const u8 *message, u32 msg_bytes, u8 *mac);
+
 public:
     // Generate a proof that the local host has the key
     bool GenerateProof(u8 *local_proof, int proof_bytes);
@@ -139,6 +142,16 @@ public:
     // msg_bytes: Number of bytes in the message, excluding the overhead
 	// If Encrypt() returns true, msg_bytes is set to the size of the encrypted message
     bool Encrypt(u8 *buffer, u32 buffer_bytes, u32 &msg_bytes);
+
+    // Decrypts several messages in place, with the same results as calling Decrypt() for each in turn
+	// The messages are decrypted together with ChaChaOutput::CryptMany()
+	// succeeded[i] is set to what Decrypt() would have returned for message i
+    void DecryptMany(u8 *const *buffers, u32 *buf_bytes, bool *succeeded, int count);
+
+    // Encrypts several messages in place, with the same results as calling Encrypt() for each in turn
+	// The messages are encrypted together with ChaChaOutput::CryptMany()
+	// Returns false without encrypting any message if one of the buffers is too small
+    bool EncryptMany(u8 *const *buffers, const u32 *buffer_bytes, u32 *msg_bytes, int count);
 };
 
 
@@ -31,6 +31,11 @@
 #include <string.h>
 using namespace cat;
 
+#if defined(CAT_ISA_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+# define CAT_CHACHA_SSE2
+# include <emmintrin.h>
+#endif
+
 
 //// ChaChaKey
 
@@ -73,11 +78,8 @@ void ChaChaKey::Set(const void *key, int bytes)
 	x[a] += x[b]; x[d] = CAT_ROL32(x[d] ^ x[a], 8); \
 	x[c] += x[d]; x[b] = CAT_ROL32(x[b] ^ x[c], 7);
 
-void ChaChaOutput::GenerateKeyStream(u32 *out_words)
+static void GenerateBlock(const u32 *state, u32 *out_words)
 {
-	// Update block counter
-	if (!++state[12]) state[13]++;
-
 	register u32 x[16];
 
 	// Copy state into work registers
@@ -102,6 +104,100 @@ void ChaChaOutput::GenerateKeyStream(u32 *out_words)
 		out_words[jj] = getLE(x[jj] + state[jj]);
 }
 
+#if defined(CAT_CHACHA_SSE2)
+
+#define ROL32X4(v, r) _mm_or_si128(_mm_slli_epi32(v, r), _mm_srli_epi32(v, 32 - (r)))
+
+#define QUARTERROUNDX4(a,b,c,d) \
+	x[a] = _mm_add_epi32(x[a], x[b]); x[d] = ROL32X4(_mm_xor_si128(x[d], x[a]), 16); \
+	x[c] = _mm_add_epi32(x[c], x[d]); x[b] = ROL32X4(_mm_xor_si128(x[b], x[c]), 12); \
+	x[a] = _mm_add_epi32(x[a], x[b]); x[d] = ROL32X4(_mm_xor_si128(x[d], x[a]), 8); \
+	x[c] = _mm_add_epi32(x[c], x[d]); x[b] = ROL32X4(_mm_xor_si128(x[b], x[c]), 7);
+
+// Four blocks at once, one in each 32-bit lane, so the states may differ in any word
+static void GenerateBlocks(const u32 *const *states, u32 (*out_words)[16], int count)
+{
+	(void) count;
+
+	__m128i x[16];
+
+	for (int ii = 0; ii < 16; ++ii)
+		x[ii] = _mm_set_epi32(states[3][ii], states[2][ii], states[1][ii], states[0][ii]);
+
+	for (int round = 12; round > 0; round -= 2)
+	{
+		QUARTERROUNDX4(0, 4, 8,  12)
+		QUARTERROUNDX4(1, 5, 9,  13)
+		QUARTERROUNDX4(2, 6, 10, 14)
+		QUARTERROUNDX4(3, 7, 11, 15)
+		QUARTERROUNDX4(0, 5, 10, 15)
+		QUARTERROUNDX4(1, 6, 11, 12)
+		QUARTERROUNDX4(2, 7, 8,  13)
+		QUARTERROUNDX4(3, 4, 9,  14)
+	}
+
+	// Add state to mixed state and transpose four words at a time back to one block per lane
+	for (int jj = 0; jj < 16; jj += 4)
+	{
+		__m128i a = _mm_add_epi32(x[jj], _mm_set_epi32(states[3][jj], states[2][jj], states[1][jj], states[0][jj]));
+		__m128i b = _mm_add_epi32(x[jj+1], _mm_set_epi32(states[3][jj+1], states[2][jj+1], states[1][jj+1], states[0][jj+1]));
+		__m128i c = _mm_add_epi32(x[jj+2], _mm_set_epi32(states[3][jj+2], states[2][jj+2], states[1][jj+2], states[0][jj+2]));
+		__m128i d = _mm_add_epi32(x[jj+3], _mm_set_epi32(states[3][jj+3], states[2][jj+3], states[1][jj+3], states[0][jj+3]));
+
+		__m128i ab_lo = _mm_unpacklo_epi32(a, b), cd_lo = _mm_unpacklo_epi32(c, d);
+		__m128i ab_hi = _mm_unpackhi_epi32(a, b), cd_hi = _mm_unpackhi_epi32(c, d);
+
+		_mm_storeu_si128((__m128i*)&out_words[0][jj], _mm_unpacklo_epi64(ab_lo, cd_lo));
+		_mm_storeu_si128((__m128i*)&out_words[1][jj], _mm_unpackhi_epi64(ab_lo, cd_lo));
+		_mm_storeu_si128((__m128i*)&out_words[2][jj], _mm_unpacklo_epi64(ab_hi, cd_hi));
+		_mm_storeu_si128((__m128i*)&out_words[3][jj], _mm_unpackhi_epi64(ab_hi, cd_hi));
+	}
+}
+
+#undef QUARTERROUNDX4
+#undef ROL32X4
+
+#else
+
+// Up to four blocks, one after another
+static void GenerateBlocks(const u32 *const *states, u32 (*out_words)[16], int count)
+{
+	for (int ii = 0; ii < count; ++ii)
+		GenerateBlock(states[ii], out_words[ii]);
+}
+
+#endif // CAT_CHACHA_SSE2
+
+// XOR up to 64 bytes of key stream into a message
+static void CryptBlock(const u32 *key32, const void *in_bytes, void *out_bytes, int bytes)
+{
+	const u32 *in32 = (const u32 *)in_bytes;
+	u32 *out32 = (u32 *)out_bytes;
+
+	int words = bytes / 4;
+	for (int ii = 0; ii < words; ++ii)
+		out32[ii] = in32[ii] ^ key32[ii];
+
+	const u8 *in8 = (const u8 *)(in32 + words);
+	u8 *out8 = (u8 *)(out32 + words);
+	const u8 *key8 = (const u8 *)(key32 + words);
+
+	switch (bytes % 4)
+	{
+	case 3: out8[2] = in8[2] ^ key8[2];
+	case 2: out8[1] = in8[1] ^ key8[1];
+	case 1: out8[0] = in8[0] ^ key8[0];
+	}
+}
+
+void ChaChaOutput::GenerateKeyStream(u32 *out_words)
+{
+	// Update block counter
+	if (!++state[12]) state[13]++;
+
+	GenerateBlock(state, out_words);
+}
+
 ChaChaOutput::ChaChaOutput(const ChaChaKey &key, u64 iv)
 {
 	for (int ii = 0; ii < 12; ++ii)
@@ -136,6 +232,31 @@ void ChaChaOutput::Crypt(const void *in_bytes, void *out_bytes, int bytes)
 	printf("\n");
 #endif
 
+	// Four blocks of key stream at a time
+	while (bytes >= 256)
+	{
+		u32 lane_states[4][16];
+		const u32 *lanes[4] = { lane_states[0], lane_states[1], lane_states[2], lane_states[3] };
+
+		for (int ii = 0; ii < 4; ++ii)
+		{
+			if (!++state[12]) state[13]++;
+			memcpy(lane_states[ii], state, sizeof(state));
+		}
+
+		u32 key32[4][16];
+		GenerateBlocks(lanes, key32, 4);
+
+		for (int ii = 0; ii < 4; ++ii)
+		{
+			CryptBlock(key32[ii], in32, out32, 64);
+
+			out32 += 16;
+			in32 += 16;
+		}
+		bytes -= 256;
+	}
+
 	while (bytes >= 64)
 	{
 		u32 key32[16];
@@ -154,20 +275,7 @@ void ChaChaOutput::Crypt(const void *in_bytes, void *out_bytes, int bytes)
 		u32 key32[16];
 		GenerateKeyStream(key32);
 
-		int words = bytes / 4;
-		for (int ii = 0; ii < words; ++ii)
-			out32[ii] = in32[ii] ^ key32[ii];
-
-		const u8 *in8 = (const u8 *)(in32 + words);
-		u8 *out8 = (u8 *)(out32 + words);
-		const u8 *key8 = (const u8 *)(key32 + words);
-
-		switch (bytes % 4)
-		{
-		case 3: out8[2] = in8[2] ^ key8[2];
-		case 2: out8[1] = in8[1] ^ key8[1];
-		case 1: out8[0] = in8[0] ^ key8[0];
-		}
+		CryptBlock(key32, in32, out32, bytes);
 	}
 
 #ifdef CAT_AUDIT
@@ -180,4 +288,62 @@ void ChaChaOutput::Crypt(const void *in_bytes, void *out_bytes, int bytes)
 #endif
 }
 
+// Messages with any number of bytes, each with its own IV, crypted in place
+void ChaChaOutput::CryptMany(const ChaChaKey &key, const u64 *ivs, u8 *const *buffers, const int *bytes, int count)
+{
+	// Blocks from any of the messages fill the four lanes
+	u32 lane_states[4][16];
+	const u32 *lanes[4] = { lane_states[0], lane_states[1], lane_states[2], lane_states[3] };
+	u8 *lane_buffers[4];
+	int lane_bytes[4];
+	int used = 0;
+
+	CAT_OBJCLR(lane_states);
+	for (int ii = 0; ii < 4; ++ii)
+		memcpy(lane_states[ii], key.state, 12 * sizeof(u32));
+
+	for (int ii = 0; ii < count; ++ii)
+	{
+		// Same block counter as ChaChaOutput, which starts at one
+		u64 counter = 0;
+
+		for (int offset = 0; offset < bytes[ii]; offset += 64)
+		{
+			u32 *lane = lane_states[used];
+
+			++counter;
+			lane[12] = (u32)counter;
+			lane[13] = (u32)(counter >> 32);
+			lane[14] = (u32)ivs[ii];
+			lane[15] = (u32)(ivs[ii] >> 32);
+
+			lane_buffers[used] = buffers[ii] + offset;
+			lane_bytes[used] = bytes[ii] - offset < 64 ? bytes[ii] - offset : 64;
+
+			if (++used == 4)
+			{
+				u32 key32[4][16];
+				GenerateBlocks(lanes, key32, used);
+
+				for (int jj = 0; jj < used; ++jj)
+					CryptBlock(key32[jj], lane_buffers[jj], lane_buffers[jj], lane_bytes[jj]);
+
+				used = 0;
+			}
+		}
+	}
+
+	// Blocks left over from the last messages, which may be followed by empty ones
+	if (used)
+	{
+		u32 key32[4][16];
+		GenerateBlocks(lanes, key32, used);
+
+		for (int jj = 0; jj < used; ++jj)
+			CryptBlock(key32[jj], lane_buffers[jj], lane_buffers[jj], lane_bytes[jj]);
+	}
+
+	CAT_OBJCLR(lane_states);
+}
+
 #undef QUARTERROUND
@@ -407,3 +407,136 @@ bool AuthenticatedEncryption::Encrypt(u8 *buffer, u32 buffer_bytes, u32 &msg_byt
 	msg_bytes = out_bytes;
 	return true;
 }
+
+// Messages per call to ChaChaOutput::CryptMany()
+static const int MANY_MESSAGES = 32;
+
+void AuthenticatedEncryption::GenerateMAC(HMAC_MD5 *mac_key, u64 iv, const u8 *message, u32 msg_bytes, u8 *mac)
+{
+	HMAC_MD5 message_mac;
+	message_mac.RekeyFromMD5(mac_key);
+    message_mac.BeginMAC();
+	u64 iv_neutral = getLE(iv);
+	message_mac.Crunch(&iv_neutral, sizeof(iv_neutral));
+    message_mac.Crunch(message, msg_bytes);
+    message_mac.End();
+    message_mac.Generate(mac, MAC_BYTES);
+}
+
+// Decrypt several packets from the remote host
+void AuthenticatedEncryption::DecryptMany(u8 *const *buffers, u32 *buf_bytes, bool *succeeded, int count)
+{
+	u32 trunc_ivs[MANY_MESSAGES];
+	u64 ivs[MANY_MESSAGES];
+	bool decrypted[MANY_MESSAGES];
+	u8 *crypt_buffers[MANY_MESSAGES];
+	u64 crypt_ivs[MANY_MESSAGES];
+	int crypt_bytes[MANY_MESSAGES];
+
+	for (int first = 0; first < count; first += MANY_MESSAGES)
+	{
+		int n = count - first < MANY_MESSAGES ? count - first : MANY_MESSAGES;
+		int crypted = 0;
+
+		// Reconstruct the IVs from the ones accepted before these messages
+		for (int ii = 0; ii < n; ++ii)
+		{
+			decrypted[ii] = false;
+			succeeded[first + ii] = false;
+
+			if (buf_bytes[first + ii] < OVERHEAD_BYTES) continue;
+
+			u8 *overhead = buffers[first + ii] + buf_bytes[first + ii] - OVERHEAD_BYTES;
+			u32 trunc_iv = ((u32)overhead[MAC_BYTES+2] << 16) | ((u32)overhead[MAC_BYTES+1] << 8) | (u32)overhead[MAC_BYTES];
+			trunc_ivs[ii] = IV_MASK & (trunc_iv ^ getLE(*(u32*)overhead) ^ IV_FUZZ);
+			ivs[ii] = ReconstructCounter<IV_BITS>(remote_iv, trunc_ivs[ii]);
+
+			if (!IsValidIV(ivs[ii])) continue;
+
+			crypt_buffers[crypted] = buffers[first + ii];
+			crypt_ivs[crypted] = ivs[ii];
+			crypt_bytes[crypted] = buf_bytes[first + ii] - IV_BYTES;
+			++crypted;
+			decrypted[ii] = true;
+		}
+
+		// Decrypt the messages and MACs together
+		ChaChaOutput::CryptMany(remote_cipher_key, crypt_ivs, crypt_buffers, crypt_bytes, crypted);
+
+		// Validate the MACs and accept the IVs in order
+		for (int ii = 0; ii < n; ++ii)
+		{
+			u8 *buffer = buffers[first + ii];
+
+			if (buf_bytes[first + ii] < OVERHEAD_BYTES) continue;
+
+			// If an IV accepted since moved the window, undo the decryption and decrypt this message on its own
+			u64 iv = ReconstructCounter<IV_BITS>(remote_iv, trunc_ivs[ii]);
+			if (iv != ivs[ii])
+			{
+				if (decrypted[ii])
+				{
+					ChaChaOutput remote_cipher(remote_cipher_key, ivs[ii]);
+					remote_cipher.Crypt(buffer, buffer, buf_bytes[first + ii] - IV_BYTES);
+				}
+				succeeded[first + ii] = Decrypt(buffer, buf_bytes[first + ii]);
+				continue;
+			}
+
+			// An earlier message may have had the same IV
+			if (!decrypted[ii] || !IsValidIV(iv)) continue;
+
+			u32 msg_bytes = buf_bytes[first + ii] - OVERHEAD_BYTES;
+			u8 expected[MAC_BYTES];
+			GenerateMAC(&remote_mac_key, iv, buffer, msg_bytes, expected);
+
+			if (!SecureEqual(expected, buffer + msg_bytes, MAC_BYTES)) continue;
+
+			AcceptIV(iv);
+
+			buf_bytes[first + ii] = msg_bytes;
+			succeeded[first + ii] = true;
+		}
+	}
+}
+
+// Encrypt several packets to send to the remote host
+bool AuthenticatedEncryption::EncryptMany(u8 *const *buffers, const u32 *buffer_bytes, u32 *msg_bytes, int count)
+{
+	for (int ii = 0; ii < count; ++ii)
+		if (msg_bytes[ii] + OVERHEAD_BYTES > buffer_bytes[ii]) return false;
+
+	u64 ivs[MANY_MESSAGES];
+	int crypt_bytes[MANY_MESSAGES];
+
+	for (int first = 0; first < count; first += MANY_MESSAGES)
+	{
+		int n = count - first < MANY_MESSAGES ? count - first : MANY_MESSAGES;
+
+		// Generate a MAC for each message and full IV
+		for (int ii = 0; ii < n; ++ii)
+		{
+			ivs[ii] = ++local_iv;
+			GenerateMAC(&local_mac_key, ivs[ii], buffers[first + ii], msg_bytes[first + ii], buffers[first + ii] + msg_bytes[first + ii]);
+			crypt_bytes[ii] = msg_bytes[first + ii] + MAC_BYTES;
+		}
+
+		// Encrypt the messages and MACs together
+		ChaChaOutput::CryptMany(local_cipher_key, ivs, buffers + first, crypt_bytes, n);
+
+		// Obfuscate the truncated IVs
+		for (int ii = 0; ii < n; ++ii)
+		{
+			u8 *overhead = buffers[first + ii] + msg_bytes[first + ii];
+			u32 trunc_iv = IV_MASK & ((u32)ivs[ii] ^ getLE(*(u32*)overhead) ^ IV_FUZZ);
+
+			overhead[MAC_BYTES] = (u8)trunc_iv;
+			overhead[MAC_BYTES+1] = (u8)(trunc_iv >> 8);
+			overhead[MAC_BYTES+2] = (u8)(trunc_iv >> 16);
+
+			msg_bytes[first + ii] += OVERHEAD_BYTES;
+		}
+	}
+
+	return true;
+}
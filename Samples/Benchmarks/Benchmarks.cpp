@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Runs the benchmarks named on the command line, or every benchmark if there are none.
+// Run with "list" to print the names.
+
+#include "Benchmarks.h"
+
+#include <cstdio>
+#include <string.h>
+// After string.h, which declares size_t for it
+#include "slikenet/LinuxStrings.h"
+
+struct Benchmark
+{
+	const char *name;
+	int (*function)(void);
+};
+
+static const Benchmark benchmarks[]=
+{
+	{"BitStream", BitStreamBenchmark},
+	{"StringCompressor", StringCompressorBenchmark},
+	{"RakString", RakStringBenchmark},
+	{"NetworkIDManager", NetworkIDManagerBenchmark},
+	{"TableQuery", TableQueryBenchmark},
+	{"FileListScan", FileListScanBenchmark},
+	{"PluginDispatch", PluginDispatchBenchmark},
+	{"CloudServer", CloudServerBenchmark},
+	{"NatPunchthroughServer", NatPunchthroughServerBenchmark},
+	{"SocketBatch", SocketBatchBenchmark},
+	{"SendToList", SendToListBenchmark},
+	{"ManyClientsOneServer", ManyClientsOneServerBenchmark},
+	{"EncryptionThroughput", EncryptionThroughputBenchmark},
+	{"SecureHandshake", SecureHandshakeBenchmark},
+	{"CongestionControl", CongestionControlComparison},
+	{"Pacing", PacingComparison},
+};
+static const int numBenchmarks=sizeof(benchmarks)/sizeof(benchmarks[0]);
+
+int main(int argc, char *argv[])
+{
+	printf("Benchmarks.\n");
+	printf("Measures the throughput and latency of parts of the library. Pass the names of the benchmarks to run, or none to run all.\n");
+	printf("Difficulty: Intermediate\n\n");
+
+	if (argc==2 && _stricmp(argv[1], "list")==0)
+	{
+		for (int i=0; i < numBenchmarks; i++)
+			printf("%s\n", benchmarks[i].name);
+		return 0;
+	}
+
+	int failedCount=0;
+	for (int i=0; i < numBenchmarks; i++)
+	{
+		bool selected=argc<=1;
+		for (int p=1; p < argc; p++)
+		{
+			if (_stricmp(argv[p], benchmarks[i].name)==0)
+				selected=true;
+		}
+		if (selected==false)
+			continue;
+
+		printf("\n\nRunning benchmark %s.\n\n", benchmarks[i].name);
+		if (benchmarks[i].function()!=0)
+		{
+			printf("Benchmark %s could not run\n", benchmarks[i].name);
+			failedCount++;
+		}
+	}
+
+	for (int p=1; p < argc; p++)
+	{
+		bool found=false;
+		for (int i=0; i < numBenchmarks; i++)
+		{
+			if (_stricmp(argv[p], benchmarks[i].name)==0)
+				found=true;
+		}
+		if (found==false)
+		{
+			printf("No benchmark named %s. Run with \"list\" to print the names.\n", argv[p]);
+			failedCount++;
+		}
+	}
+
+	return failedCount==0 ? 0 : 1;
+}
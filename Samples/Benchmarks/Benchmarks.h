@@ -0,0 +1,28 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Each benchmark prints what it measures and a table of results.
+// Returns 0, or 1 if it could not run, for example because a socket did not bind or the peers did not connect.
+// Correctness is checked by the Tests project, not here.
+int BitStreamBenchmark(void);
+int CloudServerBenchmark(void);
+int CongestionControlComparison(void);
+int EncryptionThroughputBenchmark(void);
+int FileListScanBenchmark(void);
+int ManyClientsOneServerBenchmark(void);
+int NatPunchthroughServerBenchmark(void);
+int NetworkIDManagerBenchmark(void);
+int PacingComparison(void);
+int PluginDispatchBenchmark(void);
+int RakStringBenchmark(void);
+int SecureHandshakeBenchmark(void);
+int SendToListBenchmark(void);
+int SocketBatchBenchmark(void);
+int StringCompressorBenchmark(void);
+int TableQueryBenchmark(void);
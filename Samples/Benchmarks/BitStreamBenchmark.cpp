@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures how fast BitStream writes and reads bits, in MB of serialized data per second.
+// Aligned: whole byte blocks at byte boundaries, which is a plain memory copy.
+// Unaligned: the same blocks one bit off the byte boundary, as after a serialized bool.
+// Mixed width: bools, compressed integers, integer ranges and floats, as written by ReplicaManager3 serialization.
+
+#include "Benchmarks.h"
+
+#include "slikenet/BitStream.h"
+#include "slikenet/GetTime.h"
+#include <cstdio>
+#include <string.h>
+
+using namespace SLNet;
+
+// Bytes written into one BitStream before it is read back and reset
+static const unsigned int BYTES_PER_STREAM=65536;
+// Bytes written and read per workload
+static const unsigned int BYTES_PER_RUN=256*1024*1024;
+static const int BLOCK_SIZE=256;
+
+static unsigned char block[BLOCK_SIZE];
+// Keeps the compiler from optimizing the reads away
+static unsigned int readChecksum;
+
+static void WriteAligned(BitStream *bitStream)
+{
+	bitStream->WriteBits(block, BLOCK_SIZE*8, true);
+}
+
+static void ReadAligned(BitStream *bitStream)
+{
+	unsigned char output[BLOCK_SIZE];
+	bitStream->ReadBits(output, BLOCK_SIZE*8, true);
+	readChecksum+=output[0];
+}
+
+static void WriteUnaligned(BitStream *bitStream)
+{
+	if (bitStream->GetNumberOfBitsUsed()==0)
+		bitStream->Write1();
+	bitStream->WriteBits(block, BLOCK_SIZE*8, true);
+}
+
+static void ReadUnaligned(BitStream *bitStream)
+{
+	unsigned char output[BLOCK_SIZE];
+	if (bitStream->GetReadOffset()==0)
+		bitStream->ReadBit();
+	bitStream->ReadBits(output, BLOCK_SIZE*8, true);
+	readChecksum+=output[0];
+}
+
+static void WriteMixedWidth(BitStream *bitStream)
+{
+	for (unsigned int i=0; i < 16; i++)
+	{
+		bitStream->Write((block[i]&1)!=0);
+		bitStream->WriteCompressed((unsigned int) block[i] * 37);
+		bitStream->WriteBitsFromIntegerRange((unsigned short) (block[i+16]*3), (unsigned short) 0, (unsigned short) 1000);
+		bitStream->Write((float) block[i+32]);
+		bitStream->WriteBits(block+i, 12, true);
+	}
+}
+
+static void ReadMixedWidth(BitStream *bitStream)
+{
+	bool b=false;
+	unsigned int compressed=0;
+	unsigned short range=0;
+	float f=0.0f;
+	unsigned char bits[2]={0,0};
+	for (unsigned int i=0; i < 16; i++)
+	{
+		bitStream->Read(b);
+		bitStream->ReadCompressed(compressed);
+		bitStream->ReadBitsFromIntegerRange(range, (unsigned short) 0, (unsigned short) 1000);
+		bitStream->Read(f);
+		bitStream->ReadBits(bits, 12, true);
+		readChecksum+=b+compressed+range+(unsigned int) f+bits[0];
+	}
+}
+
+static void RunTest(const char *name, void (*writeFunction)(BitStream*), void (*readFunction)(BitStream*))
+{
+	BitStream bitStream(BYTES_PER_STREAM+BLOCK_SIZE*2);
+	SLNet::TimeUS writeTime=0, readTime=0;
+	unsigned int bytesDone=0;
+	while (bytesDone < BYTES_PER_RUN)
+	{
+		bitStream.Reset();
+
+		SLNet::TimeUS startTime=SLNet::GetTimeUS();
+		while (bitStream.GetNumberOfBytesUsed() < BYTES_PER_STREAM)
+			writeFunction(&bitStream);
+		SLNet::TimeUS midTime=SLNet::GetTimeUS();
+		const BitSize_t bitsWritten=bitStream.GetNumberOfBitsUsed();
+		while (bitStream.GetReadOffset() < bitsWritten)
+			readFunction(&bitStream);
+		SLNet::TimeUS endTime=SLNet::GetTimeUS();
+
+		writeTime+=midTime-startTime;
+		readTime+=endTime-midTime;
+		bytesDone+=bitStream.GetNumberOfBytesUsed();
+	}
+
+	if (writeTime==0)
+		writeTime=1;
+	if (readTime==0)
+		readTime=1;
+	printf("%-12s write %8.1f MB/s, read %8.1f MB/s\n", name,
+		(double) bytesDone / (double) writeTime, (double) bytesDone / (double) readTime);
+}
+
+int BitStreamBenchmark(void)
+{
+	printf("BitStream benchmark.\n");
+	printf("Measures the throughput of BitStream serialization for aligned, unaligned and mixed width data.\n");
+	printf("\n");
+
+	for (int i=0; i < BLOCK_SIZE; i++)
+		block[i]=(unsigned char) (i*131+7);
+
+	RunTest("Aligned", WriteAligned, ReadAligned);
+	RunTest("Unaligned", WriteUnaligned, ReadUnaligned);
+	RunTest("Mixed width", WriteMixedWidth, ReadMixedWidth);
+
+	printf("\nChecksum %u\n", readChecksum);
+	return 0;
+}
@@ -0,0 +1,229 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Drives CloudServer in process with 10 thousand to 1 million keys and 100 thousand subscribers, as a presence service holds them.
+// Uploaders and subscribers are not connected. The harness passes post, get and subscribe requests with made up GUIDs to OnReceive() of the plugin,
+// and OnClosedConnection() when they leave. Responses and notifications to them are dropped by the peer, as the GUIDs are not connected.
+// Times posting new keys, subscribing, posting to keys that have subscribers, getting keys, and releasing the keys and subscriptions of every system.
+// CloudServerTest in the Tests project checks the results with connected clients.
+
+#include "Benchmarks.h"
+
+#include "slikenet/peerinterface.h"
+#include "slikenet/CloudServer.h"
+#include "slikenet/MessageIdentifiers.h"
+#include "slikenet/BitStream.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include "slikenet/linux_adapter.h"
+#include "slikenet/osx_adapter.h"
+#include <cstdio>
+
+using namespace SLNet;
+
+static const unsigned int keyCounts[]={10000, 100000, 1000000};
+static const unsigned int NUM_UPLOADERS=10000;
+static const unsigned int NUM_SUBSCRIBERS=100000;
+static const unsigned int NUM_PRIMARY_KEYS=16;
+// Posts to existing keys and gets, as a fraction of the key count
+static const unsigned int OPERATIONS_DIVISOR=10;
+static const SLNet::TimeMS TIMEOUT_MS=10000;
+
+static unsigned int seed=42;
+static unsigned int Random(unsigned int range)
+{
+	seed=seed*1103515245+12345;
+	return ((seed>>8) ^ (seed<<14))%range;
+}
+
+class CloudLoadHarness
+{
+public:
+	CloudLoadHarness(unsigned int _keyCount, SystemAddress _clientAddress) : keyCount(_keyCount), clientAddress(_clientAddress)
+	{
+		uploaders=new RakNetGUID[NUM_UPLOADERS];
+		subscribers=new RakNetGUID[NUM_SUBSCRIBERS];
+		versions=new unsigned int[keyCount];
+		unsigned int i;
+		for (i=0; i < NUM_UPLOADERS; i++)
+			uploaders[i]=RakNetGUID(((uint64_t) Random(0xFFFFFFFF) << 32) | (uint64_t) i);
+		for (i=0; i < NUM_SUBSCRIBERS; i++)
+			subscribers[i]=RakNetGUID(((uint64_t) Random(0xFFFFFFFF) << 32) | (uint64_t) (NUM_UPLOADERS+i));
+		for (i=0; i < NUM_PRIMARY_KEYS; i++)
+			primaryKeys[i]=RakString("presence/region%u", i);
+		for (i=0; i < keyCount; i++)
+			versions[i]=0;
+	}
+	~CloudLoadHarness()
+	{
+		delete [] uploaders;
+		delete [] subscribers;
+		delete [] versions;
+	}
+
+	CloudKey GetKey(unsigned int keyIndex) const {return CloudKey(primaryKeys[keyIndex%NUM_PRIMARY_KEYS], keyIndex);}
+	RakNetGUID GetUploader(unsigned int keyIndex) const {return uploaders[keyIndex%NUM_UPLOADERS];}
+
+	// The data of a key is its index and how often it was posted
+	void Post(CloudServer *server, unsigned int keyIndex, RakNetGUID guid)
+	{
+		CloudKey key=GetKey(keyIndex);
+		versions[keyIndex]++;
+		unsigned int data[2]={keyIndex, versions[keyIndex]};
+		BitStream bs;
+		bs.Write((MessageID) ID_CLOUD_POST_REQUEST);
+		key.Serialize(true, &bs);
+		uint32_t dataLengthBytes=sizeof(data);
+		bs.Write(dataLengthBytes);
+		bs.WriteAlignedBytes((const unsigned char*) data, dataLengthBytes);
+		Deliver(server, guid, bs);
+	}
+	void Get(CloudServer *server, unsigned int keyIndex, RakNetGUID guid, bool subscribe)
+	{
+		CloudQuery query;
+		query.keys.Push(GetKey(keyIndex), _FILE_AND_LINE_);
+		query.subscribeToResults=subscribe;
+		BitStream bs;
+		bs.Write((MessageID) ID_CLOUD_GET_REQUEST);
+		query.Serialize(true, &bs);
+		bs.WriteCasted<uint16_t>(0);
+		Deliver(server, guid, bs);
+	}
+	void Disconnect(CloudServer *server, RakNetGUID guid)
+	{
+		// Protected in CloudServer
+		PluginInterface2 *plugin=server;
+		plugin->OnClosedConnection(clientAddress, guid, LCR_DISCONNECTION_NOTIFICATION);
+	}
+
+	unsigned int keyCount;
+	RakNetGUID *uploaders;
+	RakNetGUID *subscribers;
+
+protected:
+	void Deliver(CloudServer *server, RakNetGUID guid, BitStream &bs)
+	{
+		// The address of the connected client, so the server can look up its external address for the rows
+		Packet packet;
+		packet.systemAddress=clientAddress;
+		packet.guid=guid;
+		packet.data=bs.GetData();
+		packet.length=bs.GetNumberOfBytesUsed();
+		packet.bitSize=bs.GetNumberOfBitsUsed();
+		packet.deleteData=false;
+		packet.wasGeneratedLocally=false;
+		PluginInterface2 *plugin=server;
+		plugin->OnReceive(&packet);
+	}
+
+	SystemAddress clientAddress;
+	RakString primaryKeys[NUM_PRIMARY_KEYS];
+	unsigned int *versions;
+};
+
+// Returns the next packet for the client with the ID, or 0 on timeout
+static Packet *WaitForPacket(RakPeerInterface *client, MessageID messageId)
+{
+	SLNet::TimeMS startTime=SLNet::GetTimeMS();
+	while (SLNet::GetTimeMS()-startTime < TIMEOUT_MS)
+	{
+		Packet *packet=client->Receive();
+		if (packet==0)
+		{
+			RakSleep(1);
+			continue;
+		}
+		if (packet->data[0]==messageId)
+			return packet;
+		client->DeallocatePacket(packet);
+	}
+	return 0;
+}
+
+int CloudServerBenchmark(void)
+{
+	printf("CloudServer benchmark.\n");
+	printf("Drives CloudServer in process with 10 thousand to 1 million keys and %u subscribers, and prints the time per operation.\n", NUM_SUBSCRIBERS);
+	printf("\n");
+
+	RakPeerInterface *rakPeer=RakPeerInterface::GetInstance();
+	RakPeerInterface *client=RakPeerInterface::GetInstance();
+	SocketDescriptor socketDescriptor(0, "127.0.0.1");
+	SocketDescriptor clientSocketDescriptor(0, "127.0.0.1");
+	if (rakPeer->Startup(1, &socketDescriptor, 1)!=RAKNET_STARTED || client->Startup(1, &clientSocketDescriptor, 1)!=RAKNET_STARTED)
+	{
+		printf("Startup failed\n");
+		return 1;
+	}
+	rakPeer->SetMaximumIncomingConnections(1);
+	client->Connect("127.0.0.1", rakPeer->GetMyBoundAddress().GetPort(), 0, 0);
+	Packet *packet=WaitForPacket(client, ID_CONNECTION_REQUEST_ACCEPTED);
+	if (packet==0)
+	{
+		printf("Failed to connect\n");
+		return 1;
+	}
+	client->DeallocatePacket(packet);
+	SystemAddress clientAddress=rakPeer->GetSystemAddressFromGuid(client->GetMyGUID());
+
+	printf("%8s %10s %12s %10s %10s %12s\n", "Keys", "Post ns", "Subscribe ns", "Update ns", "Get ns", "Release ns");
+	for (unsigned int i=0; i < sizeof(keyCounts)/sizeof(keyCounts[0]); i++)
+	{
+		CloudServer *server=CloudServer::GetInstance();
+		rakPeer->AttachPlugin(server);
+		CloudLoadHarness harness(keyCounts[i], clientAddress);
+		unsigned int operationCount=harness.keyCount/OPERATIONS_DIVISOR;
+		unsigned int j;
+
+		SLNet::TimeUS startTime=SLNet::GetTimeUS();
+		for (j=0; j < harness.keyCount; j++)
+			harness.Post(server, j, harness.GetUploader(j));
+		SLNet::TimeUS postTime=SLNet::GetTimeUS()-startTime;
+
+		startTime=SLNet::GetTimeUS();
+		for (j=0; j < NUM_SUBSCRIBERS; j++)
+			harness.Get(server, Random(harness.keyCount), harness.subscribers[j], true);
+		SLNet::TimeUS subscribeTime=SLNet::GetTimeUS()-startTime;
+
+		startTime=SLNet::GetTimeUS();
+		for (j=0; j < operationCount; j++)
+		{
+			unsigned int keyIndex=Random(harness.keyCount);
+			harness.Post(server, keyIndex, harness.GetUploader(keyIndex));
+		}
+		SLNet::TimeUS updateTime=SLNet::GetTimeUS()-startTime;
+
+		startTime=SLNet::GetTimeUS();
+		for (j=0; j < operationCount; j++)
+			harness.Get(server, Random(harness.keyCount), harness.subscribers[Random(NUM_SUBSCRIBERS)], false);
+		SLNet::TimeUS getTime=SLNet::GetTimeUS()-startTime;
+
+		startTime=SLNet::GetTimeUS();
+		for (j=0; j < NUM_UPLOADERS; j++)
+			harness.Disconnect(server, harness.uploaders[j]);
+		for (j=0; j < NUM_SUBSCRIBERS; j++)
+			harness.Disconnect(server, harness.subscribers[j]);
+		SLNet::TimeUS releaseTime=SLNet::GetTimeUS()-startTime;
+
+		printf("%8u %10.1f %12.1f %10.1f %10.1f %12.1f\n", harness.keyCount,
+			(double) postTime*1000.0/harness.keyCount,
+			(double) subscribeTime*1000.0/NUM_SUBSCRIBERS,
+			(double) updateTime*1000.0/operationCount,
+			(double) getTime*1000.0/operationCount,
+			(double) releaseTime*1000.0/harness.keyCount);
+
+		rakPeer->DetachPlugin(server);
+		CloudServer::DestroyInstance(server);
+	}
+
+	printf("\nRelease is the time to release every key and subscription, per key\n");
+	client->Shutdown(100);
+	rakPeer->Shutdown(100);
+	RakPeerInterface::DestroyInstance(client);
+	RakPeerInterface::DestroyInstance(rakPeer);
+	return 0;
+}
@@ -0,0 +1,195 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Compares the congestion controllers of RakPeer over loopback.
+// A sender streams reliable ordered messages to a receiver for a few seconds with each controller, under network conditions made with ApplyNetworkSimulator().
+// Reports goodput, message latency from Send() to Receive(), ping, and how much of the data sent was retransmitted.
+// ApplyNetworkSimulator() only works in debug builds. In release builds, every run has the conditions of loopback.
+
+#include "Benchmarks.h"
+
+#include "slikenet/peerinterface.h"
+#include "slikenet/MessageIdentifiers.h"
+#include "slikenet/BitStream.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include "slikenet/statistics.h"
+#include <cstdio>
+#include <string.h>
+
+using namespace SLNet;
+
+static const unsigned short SENDER_PORT=60200;
+static const unsigned short RECEIVER_PORT=60201;
+static const SLNet::TimeMS RUN_TIME_MS=3000;
+static const int MESSAGE_SIZE=1000;
+// Keep this much queued in the sender, so that only congestion control limits the rate
+static const double SEND_BUFFER_BYTES=256*1024;
+
+struct NetworkConditions
+{
+	float packetloss;
+	unsigned short minExtraPing;
+	unsigned short extraPingVariance;
+};
+
+static const NetworkConditions conditions[]=
+{
+	{0.0f, 0, 0},
+	{0.01f, 0, 0},
+	{0.05f, 0, 0},
+	{0.0f, 50, 0},
+	{0.01f, 50, 10},
+	{0.02f, 100, 20},
+};
+
+struct Controller
+{
+	CongestionControlType type;
+	const char *name;
+};
+
+static const Controller controllers[]=
+{
+	{SLIDING_WINDOW_CONGESTION_CONTROL, "SlidingWindow"},
+	{UDT_CONGESTION_CONTROL, "UDT"},
+	{BBR_CONGESTION_CONTROL, "BBR"},
+};
+
+static bool Connect(RakPeerInterface *sender, RakPeerInterface *receiver, SystemAddress *receiverAddress)
+{
+	if (receiver->Connect("127.0.0.1", SENDER_PORT, 0, 0)!=CONNECTION_ATTEMPT_STARTED)
+		return false;
+
+	SLNet::TimeMS timeout=SLNet::GetTimeMS()+5000;
+	bool senderConnected=false, receiverConnected=false;
+	while ((senderConnected==false || receiverConnected==false) && SLNet::GetTimeMS()<timeout)
+	{
+		Packet *p;
+		for (p=sender->Receive(); p; sender->DeallocatePacket(p), p=sender->Receive())
+		{
+			if (p->data[0]==ID_NEW_INCOMING_CONNECTION)
+			{
+				*receiverAddress=p->systemAddress;
+				senderConnected=true;
+			}
+		}
+		for (p=receiver->Receive(); p; receiver->DeallocatePacket(p), p=receiver->Receive())
+		{
+			if (p->data[0]==ID_CONNECTION_REQUEST_ACCEPTED)
+				receiverConnected=true;
+		}
+		RakSleep(10);
+	}
+	return senderConnected && receiverConnected;
+}
+
+static void RunTest(const Controller &controller, const NetworkConditions &networkConditions)
+{
+	RakPeerInterface *sender=RakPeerInterface::GetInstance();
+	RakPeerInterface *receiver=RakPeerInterface::GetInstance();
+	// Only the sender sends data, so only its controller matters
+	sender->SetCongestionControl(controller.type, UNASSIGNED_SYSTEM_ADDRESS);
+	sender->SetMaximumIncomingConnections(1);
+	SocketDescriptor senderSocket(SENDER_PORT, "127.0.0.1"), receiverSocket(RECEIVER_PORT, "127.0.0.1");
+	if (sender->Startup(1, &senderSocket, 1)!=RAKNET_STARTED || receiver->Startup(1, &receiverSocket, 1)!=RAKNET_STARTED)
+	{
+		printf("%-14s Startup failed\n", controller.name);
+		RakPeerInterface::DestroyInstance(sender);
+		RakPeerInterface::DestroyInstance(receiver);
+		return;
+	}
+
+	// Data is lost on the way to the receiver. The extra ping is split over both directions
+	// Applied before connecting, since a controller may keep the round trip time of a faster path for a while
+	sender->ApplyNetworkSimulator(networkConditions.packetloss, networkConditions.minExtraPing/2, networkConditions.extraPingVariance/2);
+	receiver->ApplyNetworkSimulator(0.0f, networkConditions.minExtraPing-networkConditions.minExtraPing/2, networkConditions.extraPingVariance-networkConditions.extraPingVariance/2);
+
+	SystemAddress receiverAddress;
+	if (Connect(sender, receiver, &receiverAddress)==false)
+	{
+		printf("%-14s Connect failed\n", controller.name);
+		sender->Shutdown(0);
+		receiver->Shutdown(0);
+		RakPeerInterface::DestroyInstance(sender);
+		RakPeerInterface::DestroyInstance(receiver);
+		return;
+	}
+
+	char message[MESSAGE_SIZE];
+	memset(message, 0, sizeof(message));
+	message[0]=ID_USER_PACKET_ENUM;
+
+	uint64_t bytesReceived=0;
+	SLNet::TimeUS latencySum=0;
+	unsigned int messagesReceived=0;
+	RakNetStatistics rns;
+	SLNet::TimeMS startTime=SLNet::GetTimeMS();
+	while (SLNet::GetTimeMS()-startTime < RUN_TIME_MS)
+	{
+		if (sender->GetStatistics(receiverAddress, &rns) && rns.bytesInSendBuffer[HIGH_PRIORITY] < SEND_BUFFER_BYTES)
+		{
+			for (int i=0; i < 64; i++)
+			{
+				SLNet::TimeUS sendTime=SLNet::GetTimeUS();
+				memcpy(message+1, &sendTime, sizeof(sendTime));
+				sender->Send(message, MESSAGE_SIZE, HIGH_PRIORITY, RELIABLE_ORDERED, 0, receiverAddress, false);
+			}
+		}
+
+		Packet *p;
+		for (p=receiver->Receive(); p; receiver->DeallocatePacket(p), p=receiver->Receive())
+		{
+			if (p->data[0]!=ID_USER_PACKET_ENUM || p->length!=MESSAGE_SIZE)
+				continue;
+			SLNet::TimeUS sendTime;
+			memcpy(&sendTime, p->data+1, sizeof(sendTime));
+			latencySum+=SLNet::GetTimeUS()-sendTime;
+			bytesReceived+=p->length;
+			messagesReceived++;
+		}
+		for (p=sender->Receive(); p; sender->DeallocatePacket(p), p=sender->Receive())
+			;
+		RakSleep(0);
+	}
+
+	double seconds=(double) (SLNet::GetTimeMS()-startTime) / 1000.0;
+	sender->GetStatistics(receiverAddress, &rns);
+	uint64_t bytesSent=rns.runningTotal[USER_MESSAGE_BYTES_SENT]+rns.runningTotal[USER_MESSAGE_BYTES_RESENT];
+	printf("%-14s %9.2f MB/s %10.1f ms %8i ms %9.2f %%\n",
+		controller.name,
+		(double) bytesReceived / seconds / 1000000.0,
+		messagesReceived ? (double) latencySum / (double) messagesReceived / 1000.0 : 0.0,
+		sender->GetAveragePing(receiverAddress),
+		bytesSent ? (double) rns.runningTotal[USER_MESSAGE_BYTES_RESENT] * 100.0 / (double) bytesSent : 0.0);
+
+	sender->Shutdown(0);
+	receiver->Shutdown(0);
+	RakPeerInterface::DestroyInstance(sender);
+	RakPeerInterface::DestroyInstance(receiver);
+}
+
+int CongestionControlComparison(void)
+{
+	printf("Congestion control comparison.\n");
+	printf("Streams reliable ordered messages over loopback with each congestion controller, under simulated loss and latency.\n");
+#ifndef _DEBUG
+	printf("Not a debug build, so the network simulator is inactive and every run has the conditions of loopback.\n");
+#endif
+	printf("\n");
+
+	for (unsigned int i=0; i < sizeof(conditions)/sizeof(conditions[0]); i++)
+	{
+		printf("Packetloss %.0f%%, extra ping %i ms, variance %i ms\n", conditions[i].packetloss*100.0f, conditions[i].minExtraPing, conditions[i].extraPingVariance);
+		printf("%-14s %14s %13s %11s %11s\n", "Controller", "Goodput", "Latency", "Ping", "Resent");
+		for (unsigned int j=0; j < sizeof(controllers)/sizeof(controllers[0]); j++)
+			RunTest(controllers[j], conditions[i]);
+		printf("\n");
+	}
+
+	return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures how much throughput encryption costs on a connection over the loopback address.
+// A client sends reliable ordered messages of 64 and 1024 bytes to a server, once with plaintext connections and once with security.
+// Runs with 1 update shard, where the network thread encrypts and decrypts every datagram, and with 4 shards, which decrypt the datagrams from one system together on their own threads.
+// Both ends encrypt the datagrams of each update pass together. On x86 libcat generates the ChaCha key stream four blocks at a time with SSE2.
+// UpdateShardsTest in the Tests project checks that the messages arrive unchanged, and that ChaChaOutput::CryptMany() gives the same bytes as ChaChaOutput::Crypt().
+
+#include "Benchmarks.h"
+
+#include "slikenet/peerinterface.h"
+#include "slikenet/MessageIdentifiers.h"
+#include "slikenet/NativeFeatureIncludes.h"
+#include "slikenet/SecureHandshake.h"
+#include "slikenet/BitStream.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include <cstdio>
+#include <ctime>
+#include <string.h>
+
+using namespace SLNet;
+
+static const int messageSizes[]={64, 1024};
+static const unsigned int shardCounts[]={1, 4};
+static const unsigned int BYTES_PER_RUN=16*1024*1024;
+// Messages the client may have sent that the server did not receive yet
+static const unsigned int MAX_MESSAGES_IN_FLIGHT=2000;
+static const SLNet::TimeMS TIMEOUT_MS=60000;
+
+// Process CPU time in seconds, summed over all threads
+static double GetCPUSeconds(void)
+{
+	return (double) clock() / (double) CLOCKS_PER_SEC;
+}
+
+static unsigned char PayloadByte(unsigned int messageIndex, int offset)
+{
+	return (unsigned char) (messageIndex*31+offset);
+}
+
+// Returns megabytes per second, or a negative value if the peers did not start or connect
+static double RunTransfer(int messageSize, unsigned int shardCount, bool secure, char *publicKey, char *privateKey, double *cpuSecondsPerMegabyte)
+{
+	RakPeerInterface *server=RakPeerInterface::GetInstance();
+	RakPeerInterface *client=RakPeerInterface::GetInstance();
+	server->SetNumberOfUpdateShards(shardCount);
+	client->SetNumberOfUpdateShards(shardCount);
+#if LIBCAT_SECURITY==1
+	if (secure)
+		server->InitializeSecurity(publicKey, privateKey);
+#else
+	(void) secure;
+	(void) publicKey;
+	(void) privateKey;
+#endif
+
+	SocketDescriptor socketDescriptor(0, "127.0.0.1");
+	SocketDescriptor clientSocketDescriptor(0, "127.0.0.1");
+	if (server->Startup(1, &socketDescriptor, 1)!=RAKNET_STARTED || client->Startup(1, &clientSocketDescriptor, 1)!=RAKNET_STARTED)
+	{
+		RakPeerInterface::DestroyInstance(client);
+		RakPeerInterface::DestroyInstance(server);
+		return -1.0;
+	}
+	server->SetMaximumIncomingConnections(1);
+
+#if LIBCAT_SECURITY==1
+	PublicKey pk;
+	pk.remoteServerPublicKey=publicKey;
+	pk.publicKeyMode=PKM_USE_KNOWN_PUBLIC_KEY;
+	client->Connect("127.0.0.1", server->GetMyBoundAddress().GetPort(), 0, 0, secure ? &pk : 0);
+#else
+	client->Connect("127.0.0.1", server->GetMyBoundAddress().GetPort(), 0, 0);
+#endif
+
+	bool connected=false;
+	SLNet::TimeMS startTime=SLNet::GetTimeMS();
+	Packet *packet;
+	while (connected==false && SLNet::GetTimeMS()-startTime < TIMEOUT_MS)
+	{
+		for (packet=client->Receive(); packet; client->DeallocatePacket(packet), packet=client->Receive())
+		{
+			if (packet->data[0]==ID_CONNECTION_REQUEST_ACCEPTED)
+				connected=true;
+		}
+		for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+			;
+		RakSleep(1);
+	}
+
+	double megabytesPerSecond=-1.0;
+	if (connected)
+	{
+		const unsigned int messageCount=BYTES_PER_RUN/messageSize;
+		unsigned int sentCount=0, receivedCount=0;
+		SystemAddress serverAddress=client->GetSystemAddressFromIndex(0);
+		unsigned char *message=new unsigned char[messageSize];
+
+		SLNet::TimeUS transferStartTime=SLNet::GetTimeUS();
+		double startCPU=GetCPUSeconds();
+		startTime=SLNet::GetTimeMS();
+		while (receivedCount < messageCount && SLNet::GetTimeMS()-startTime < TIMEOUT_MS)
+		{
+			while (sentCount < messageCount && sentCount-receivedCount < MAX_MESSAGES_IN_FLIGHT)
+			{
+				message[0]=ID_USER_PACKET_ENUM;
+				memcpy(message+1, &sentCount, sizeof(sentCount));
+				for (int i=1+sizeof(sentCount); i < messageSize; i++)
+					message[i]=PayloadByte(sentCount, i);
+				client->Send((const char*) message, messageSize, HIGH_PRIORITY, RELIABLE_ORDERED, 0, serverAddress, false);
+				sentCount++;
+			}
+
+			for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+			{
+				if (packet->data[0]==ID_USER_PACKET_ENUM)
+					receivedCount++;
+			}
+			for (packet=client->Receive(); packet; client->DeallocatePacket(packet), packet=client->Receive())
+				;
+			RakSleep(0);
+		}
+
+		double seconds=(double) (SLNet::GetTimeUS()-transferStartTime)/1000000.0;
+		double cpuSeconds=GetCPUSeconds()-startCPU;
+		double megabytes=(double) receivedCount*messageSize/(1024.0*1024.0);
+		megabytesPerSecond=megabytes/(seconds>0.0 ? seconds : 1.0);
+		*cpuSecondsPerMegabyte=cpuSeconds/(megabytes>0.0 ? megabytes : 1.0);
+		delete [] message;
+	}
+
+	client->Shutdown(100);
+	server->Shutdown(100);
+	RakPeerInterface::DestroyInstance(client);
+	RakPeerInterface::DestroyInstance(server);
+	return megabytesPerSecond;
+}
+
+int EncryptionThroughputBenchmark(void)
+{
+	printf("Encryption throughput benchmark.\n");
+	printf("Sends %u MB of reliable ordered messages over the loopback address with plaintext and with secure connections, and prints megabytes per second.\n", BYTES_PER_RUN/(1024*1024));
+	printf("\n");
+
+	char *publicKey=0, *privateKey=0;
+#if LIBCAT_SECURITY==1
+	cat::EasyHandshake handshake;
+	char serverPublicKey[cat::EasyHandshake::PUBLIC_KEY_BYTES];
+	char serverPrivateKey[cat::EasyHandshake::PRIVATE_KEY_BYTES];
+	if (handshake.GenerateServerKey(serverPublicKey, serverPrivateKey)==false)
+	{
+		printf("Failed to generate the server keys\n");
+		return 1;
+	}
+	publicKey=serverPublicKey;
+	privateKey=serverPrivateKey;
+#else
+	printf("Define LIBCAT_SECURITY 1 in NativeFeatureIncludesOverrides.h to compare with secure connections. Only measuring plaintext.\n\n");
+#endif
+
+	printf("%8s %7s %12s %12s %10s %12s %12s\n", "Message", "Shards", "Plain MB/s", "Secure MB/s", "Secure %", "Plain CPU", "Secure CPU");
+	for (unsigned int i=0; i < sizeof(messageSizes)/sizeof(messageSizes[0]); i++)
+	{
+		for (unsigned int j=0; j < sizeof(shardCounts)/sizeof(shardCounts[0]); j++)
+		{
+			double plainCPU=0.0, secureCPU=0.0, secure=0.0;
+			double plain=RunTransfer(messageSizes[i], shardCounts[j], false, publicKey, privateKey, &plainCPU);
+#if LIBCAT_SECURITY==1
+			secure=RunTransfer(messageSizes[i], shardCounts[j], true, publicKey, privateKey, &secureCPU);
+#endif
+			if (plain < 0.0 || secure < 0.0)
+			{
+				printf("Failed to connect\n");
+				return 1;
+			}
+			// CPU is in milliseconds per megabyte, summed over all threads
+			printf("%8i %7u %12.1f %12.1f %9.0f%% %12.2f %12.2f\n", messageSizes[i], shardCounts[j], plain, secure,
+				secure*100.0/plain, plainCPU*1000.0, secureCPU*1000.0);
+		}
+	}
+
+	printf("\nCPU columns are milliseconds of process CPU time per megabyte, summed over all threads\n");
+	return 0;
+}
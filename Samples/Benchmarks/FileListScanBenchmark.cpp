@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures how fast FileList::AddFilesFromDirectory() hashes a directory tree, with and without the file data, on 0 to 4 scan threads.
+// Writes many small files and a few large ones to a directory next to the executable, scans it, and deletes it again.
+// Then scans twice more with FileList::SetHashCache(), once to fill the cache and once with it filled.
+// FileListScanTest in the Tests project checks that every thread count, and the cache, give the same hashes and data as scanning on the calling thread.
+// Files that were just written are usually in the disk cache, so this measures reading from memory rather than from disk.
+
+#include "Benchmarks.h"
+
+#include "slikenet/FileList.h"
+#include "slikenet/FileOperations.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include "slikenet/linux_adapter.h"
+#include "slikenet/osx_adapter.h"
+#include <cstdio>
+#ifdef _WIN32
+#include <direct.h>
+#define rmdir _rmdir
+#else
+#include <unistd.h>
+#endif
+
+using namespace SLNet;
+
+static const char *SCAN_DIRECTORY="FileListScanBenchmarkFiles";
+static const char *HASH_CACHE_FILE="FileListScanBenchmarkHashes.bin";
+static const int NUM_SUBDIRECTORIES=16;
+static const int SMALL_FILES_PER_SUBDIRECTORY=250;
+static const unsigned int SMALL_FILE_SIZE=4*1024;
+static const int NUM_LARGE_FILES=16;
+static const unsigned int LARGE_FILE_SIZE=4*1024*1024;
+static const int threadCounts[]={0, 1, 2, 4};
+
+static bool WriteFiles(void)
+{
+	char *data=new char[LARGE_FILE_SIZE];
+	unsigned int seed=42;
+	for (unsigned int i=0; i < LARGE_FILE_SIZE; i++)
+	{
+		seed=seed*1103515245+12345;
+		data[i]=(char) (seed>>16);
+	}
+
+	char path[256];
+	bool succeeded=true;
+	for (int i=0; i < NUM_SUBDIRECTORIES && succeeded; i++)
+	{
+		for (int j=0; j < SMALL_FILES_PER_SUBDIRECTORY && succeeded; j++)
+		{
+			sprintf_s(path, "%s/dir%02i/file%03i.dat", SCAN_DIRECTORY, i, j);
+			// Different contents for each file
+			data[0]=(char) i;
+			data[1]=(char) j;
+			succeeded=WriteFileWithDirectories(path, data, SMALL_FILE_SIZE);
+		}
+	}
+	for (int i=0; i < NUM_LARGE_FILES && succeeded; i++)
+	{
+		sprintf_s(path, "%s/large%02i.dat", SCAN_DIRECTORY, i);
+		data[0]=(char) i;
+		succeeded=WriteFileWithDirectories(path, data, LARGE_FILE_SIZE);
+	}
+	delete [] data;
+	return succeeded;
+}
+
+static void DeleteFiles(void)
+{
+	FileList fileList;
+	fileList.AddFilesFromDirectory(0, SCAN_DIRECTORY, false, false, true, FileListNodeContext(0,0,0,0));
+	for (unsigned int i=0; i < fileList.fileList.Size(); i++)
+		remove(fileList.fileList[i].fullPathToFile.C_String());
+
+	char path[256];
+	for (int i=0; i < NUM_SUBDIRECTORIES; i++)
+	{
+		sprintf_s(path, "%s/dir%02i", SCAN_DIRECTORY, i);
+		rmdir(path);
+	}
+	rmdir(SCAN_DIRECTORY);
+}
+
+int FileListScanBenchmark(void)
+{
+	printf("FileList scan benchmark.\n");
+	printf("Hashes %i files of %u KB and %i files of %u MB with AddFilesFromDirectory() on 0 to 4 scan threads, and prints files and megabytes per second.\n",
+		NUM_SUBDIRECTORIES*SMALL_FILES_PER_SUBDIRECTORY, SMALL_FILE_SIZE/1024, NUM_LARGE_FILES, LARGE_FILE_SIZE/(1024*1024));
+	printf("0 threads reads and hashes on the calling thread. Then scans with a hash cache, first empty, then filled.\n");
+	printf("\n");
+
+	if (WriteFiles()==false)
+	{
+		printf("Failed to write the files to %s\n", SCAN_DIRECTORY);
+		DeleteFiles();
+		return 1;
+	}
+	SLNet::TimeMS filesWrittenTime=SLNet::GetTimeMS();
+
+	const int numFiles=NUM_SUBDIRECTORIES*SMALL_FILES_PER_SUBDIRECTORY+NUM_LARGE_FILES;
+	const double totalBytes=(double) NUM_SUBDIRECTORIES*SMALL_FILES_PER_SUBDIRECTORY*SMALL_FILE_SIZE+(double) NUM_LARGE_FILES*LARGE_FILE_SIZE;
+
+	printf("%-14s %7s %12s %12s\n", "Mode", "Threads", "Files/s", "MB/s");
+	for (int writeData=0; writeData < 2; writeData++)
+	{
+		for (unsigned int i=0; i < sizeof(threadCounts)/sizeof(threadCounts[0]); i++)
+		{
+			FileList fileList;
+			fileList.SetScanThreads(threadCounts[i]);
+			SLNet::TimeUS startTime=SLNet::GetTimeUS();
+			fileList.AddFilesFromDirectory(0, SCAN_DIRECTORY, true, writeData!=0, true, FileListNodeContext(0,0,0,0));
+			SLNet::TimeUS elapsed=SLNet::GetTimeUS()-startTime;
+			printf("%-14s %7i %12.0f %12.1f\n", writeData ? "Hash and data" : "Hash only", threadCounts[i],
+				(double) numFiles*1000000.0/(double) elapsed, totalBytes/(double) elapsed);
+		}
+	}
+
+	// Recently modified files are not cached
+	while (SLNet::GetTimeMS()-filesWrittenTime < 3000)
+		RakSleep(100);
+	remove(HASH_CACHE_FILE);
+	for (int i=0; i < 2; i++)
+	{
+		FileList fileList;
+		fileList.SetHashCache(HASH_CACHE_FILE);
+		SLNet::TimeUS startTime=SLNet::GetTimeUS();
+		fileList.AddFilesFromDirectory(0, SCAN_DIRECTORY, true, false, true, FileListNodeContext(0,0,0,0));
+		SLNet::TimeUS elapsed=SLNet::GetTimeUS()-startTime;
+		printf("%-14s %7i %12.0f %12.1f\n", i==0 ? "Cache, empty" : "Cache, filled", 0,
+			(double) numFiles*1000000.0/(double) elapsed, totalBytes/(double) elapsed);
+	}
+	remove(HASH_CACHE_FILE);
+
+	DeleteFiles();
+	return 0;
+}
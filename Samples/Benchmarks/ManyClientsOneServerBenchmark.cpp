@@ -0,0 +1,181 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures how a server with many connections scales with RakPeerInterface::SetNumberOfUpdateShards(), as in the ManyClientsOneServer tests.
+// For each number of clients and each number of update shards, a new server is started, and the clients connect to it over the loopback address.
+// Every client then sends messages to the server, which echoes each one back, with a fixed number of messages in flight per client.
+// Prints the time until every client connected, and the messages per second the server handled until every client got every echo back.
+// UpdateShardsTest in the Tests project checks that every echo arrives in order and unchanged.
+// Scaling with shards can only show on a machine with more cores than shards, as the clients run in the same process.
+
+#include "Benchmarks.h"
+
+#include "slikenet/peerinterface.h"
+#include "slikenet/MessageIdentifiers.h"
+#include "slikenet/BitStream.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include <cstdio>
+
+using namespace SLNet;
+
+static const unsigned int clientCounts[]={32, 128, 512};
+static const unsigned int shardCounts[]={1, 2, 4};
+static const unsigned int MESSAGES_PER_CLIENT=200;
+static const unsigned int MESSAGE_SIZE=64;
+// Messages a client sent that did not come back yet
+static const unsigned int MAX_MESSAGES_IN_FLIGHT=16;
+static const SLNet::TimeMS TIMEOUT_MS=120000;
+
+static unsigned char PayloadByte(unsigned int clientIndex, unsigned int messageIndex, unsigned int offset)
+{
+	return (unsigned char) (clientIndex*7+messageIndex*31+offset);
+}
+
+static void WriteMessage(BitStream *bs, unsigned int clientIndex, unsigned int messageIndex)
+{
+	bs->Reset();
+	bs->Write((MessageID) ID_USER_PACKET_ENUM);
+	bs->Write(clientIndex);
+	bs->Write(messageIndex);
+	for (unsigned int i=1+sizeof(clientIndex)+sizeof(messageIndex); i < MESSAGE_SIZE; i++)
+		bs->Write(PayloadByte(clientIndex, messageIndex, i));
+}
+
+// Returns false if not every client connected, or not every echo came back
+static bool RunServer(unsigned int clientCount, unsigned int shardCount, double *connectMilliseconds, double *messagesPerSecond)
+{
+	RakPeerInterface *server=RakPeerInterface::GetInstance();
+	server->SetNumberOfUpdateShards(shardCount);
+	SocketDescriptor socketDescriptor(0, "127.0.0.1");
+	if (server->Startup(clientCount, &socketDescriptor, 1)!=RAKNET_STARTED)
+	{
+		RakPeerInterface::DestroyInstance(server);
+		return false;
+	}
+	server->SetMaximumIncomingConnections((unsigned short) clientCount);
+	unsigned short serverPort=server->GetMyBoundAddress().GetPort();
+
+	RakPeerInterface **clients=new RakPeerInterface*[clientCount];
+	bool *connected=new bool[clientCount];
+	unsigned int *sentCounts=new unsigned int[clientCount];
+	unsigned int *receivedCounts=new unsigned int[clientCount];
+	unsigned int i;
+	SLNet::TimeUS startTime=SLNet::GetTimeUS();
+	for (i=0; i < clientCount; i++)
+	{
+		clients[i]=RakPeerInterface::GetInstance();
+		SocketDescriptor clientSocketDescriptor(0, "127.0.0.1");
+		clients[i]->Startup(1, &clientSocketDescriptor, 1);
+		clients[i]->Connect("127.0.0.1", serverPort, 0, 0);
+		connected[i]=false;
+		sentCounts[i]=0;
+		receivedCounts[i]=0;
+	}
+
+	bool completed=true;
+	Packet *packet;
+	unsigned int connectedCount=0;
+	SLNet::TimeMS startTimeMS=SLNet::GetTimeMS();
+	while (connectedCount < clientCount && SLNet::GetTimeMS()-startTimeMS < TIMEOUT_MS)
+	{
+		for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+			;
+		for (i=0; i < clientCount; i++)
+		{
+			for (packet=clients[i]->Receive(); packet; clients[i]->DeallocatePacket(packet), packet=clients[i]->Receive())
+			{
+				if (packet->data[0]==ID_CONNECTION_REQUEST_ACCEPTED)
+				{
+					connected[i]=true;
+					connectedCount++;
+				}
+			}
+		}
+		RakSleep(1);
+	}
+	*connectMilliseconds=(double) (SLNet::GetTimeUS()-startTime)/1000.0;
+	if (connectedCount!=clientCount)
+		completed=false;
+
+	BitStream bs;
+	unsigned int doneCount=0;
+	startTime=SLNet::GetTimeUS();
+	startTimeMS=SLNet::GetTimeMS();
+	while (completed && doneCount < clientCount && SLNet::GetTimeMS()-startTimeMS < TIMEOUT_MS)
+	{
+		for (i=0; i < clientCount; i++)
+		{
+			while (sentCounts[i] < MESSAGES_PER_CLIENT && sentCounts[i]-receivedCounts[i] < MAX_MESSAGES_IN_FLIGHT)
+			{
+				WriteMessage(&bs, i, sentCounts[i]);
+				clients[i]->Send(&bs, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true);
+				sentCounts[i]++;
+			}
+		}
+
+		for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+		{
+			if (packet->data[0]==ID_USER_PACKET_ENUM)
+				server->Send((const char*) packet->data, (int) packet->length, HIGH_PRIORITY, RELIABLE_ORDERED, 0, packet->guid, false);
+		}
+
+		for (i=0; i < clientCount; i++)
+		{
+			for (packet=clients[i]->Receive(); packet; clients[i]->DeallocatePacket(packet), packet=clients[i]->Receive())
+			{
+				if (packet->data[0]==ID_USER_PACKET_ENUM && ++receivedCounts[i]==MESSAGES_PER_CLIENT)
+					doneCount++;
+			}
+		}
+		RakSleep(0);
+	}
+	*messagesPerSecond=(double) clientCount*MESSAGES_PER_CLIENT*1000000.0/(double) (SLNet::GetTimeUS()-startTime);
+	if (doneCount!=clientCount)
+		completed=false;
+
+	for (i=0; i < clientCount; i++)
+	{
+		clients[i]->Shutdown(0);
+		RakPeerInterface::DestroyInstance(clients[i]);
+	}
+	server->Shutdown(0);
+	RakPeerInterface::DestroyInstance(server);
+	delete[] clients;
+	delete[] connected;
+	delete[] sentCounts;
+	delete[] receivedCounts;
+	return completed;
+}
+
+int ManyClientsOneServerBenchmark(void)
+{
+	printf("Many clients one server benchmark.\n");
+	printf("Connects clients to a server with different numbers of update shards, echoes %u messages of %u bytes per client, and prints the messages per second.\n", MESSAGES_PER_CLIENT, MESSAGE_SIZE);
+	printf("\n");
+
+	bool completed=true;
+	printf("%8s %8s %14s %14s\n", "Clients", "Shards", "Connect ms", "Messages/s");
+	for (unsigned int i=0; i < sizeof(clientCounts)/sizeof(clientCounts[0]); i++)
+	{
+		for (unsigned int j=0; j < sizeof(shardCounts)/sizeof(shardCounts[0]); j++)
+		{
+			double connectMilliseconds, messagesPerSecond;
+			if (RunServer(clientCounts[i], shardCounts[j], &connectMilliseconds, &messagesPerSecond))
+				printf("%8u %8u %14.1f %14.0f\n", clientCounts[i], shardCounts[j], connectMilliseconds, messagesPerSecond);
+			else
+			{
+				printf("%8u %8u %14s %14s\n", clientCounts[i], shardCounts[j], "failed", "failed");
+				completed=false;
+			}
+		}
+	}
+
+	if (completed==false)
+		printf("\nClients did not connect, or did not get every message back in time\n");
+	return completed ? 0 : 1;
+}
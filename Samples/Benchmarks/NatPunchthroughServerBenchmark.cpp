@@ -0,0 +1,194 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Drives NatPunchthroughServer in process with 1 thousand to 100 thousand users, as a matchmaking punch server holds them.
+// Users are not connected. The harness calls OnNewConnection(), OnReceive() and OnClosedConnection() on the plugin with made up GUIDs and addresses,
+// and answers ID_NAT_GET_MOST_RECENT_PORT and sends ID_NAT_CLIENT_READY the way NatPunchthroughClient does.
+// The peer is not started, so Send() returns at once and the times are the work of the server itself.
+// Times adding users, Update() with 100 attempts waiting for their timeout, complete punches between random users, and removing users.
+// NatPunchthroughServerTest in the Tests project checks that the punches complete and that the waiting attempts time out.
+
+#include "Benchmarks.h"
+
+#include "slikenet/peerinterface.h"
+#include "slikenet/NatPunchthroughServer.h"
+#include "slikenet/MessageIdentifiers.h"
+#include "slikenet/BitStream.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include "slikenet/linux_adapter.h"
+#include "slikenet/osx_adapter.h"
+#include <cstdio>
+
+using namespace SLNet;
+
+static const int userCounts[]={1000, 10000, 100000};
+// Attempts between the first users that never get an answer, so they wait for their timeout
+static const int PENDING_ATTEMPTS=100;
+static const int NUM_PUNCHES=20000;
+static const int UPDATE_SAMPLES=4;
+
+static unsigned int seed=42;
+static unsigned int Random(unsigned int range)
+{
+	seed=seed*1103515245+12345;
+	return ((seed>>8) ^ (seed<<14))%range;
+}
+
+class PunchthroughLoadHarness
+{
+public:
+	PunchthroughLoadHarness(int _userCount) : userCount(_userCount), nextSessionId(0)
+	{
+		guids=new RakNetGUID[userCount];
+		addresses=new SystemAddress[userCount];
+		char ip[32];
+		for (int i=0; i < userCount; i++)
+		{
+			guids[i]=RakNetGUID(((uint64_t) Random(0xFFFFFFFF) << 32) | (uint64_t) i);
+			sprintf_s(ip, "10.%i.%i.%i", (i>>16) & 255, (i>>8) & 255, i & 255);
+			addresses[i]=SystemAddress(ip, (unsigned short) (1024+Random(60000)));
+		}
+	}
+	~PunchthroughLoadHarness()
+	{
+		delete [] guids;
+		delete [] addresses;
+	}
+
+	void Connect(NatPunchthroughServer *server)
+	{
+		for (int i=0; i < userCount; i++)
+			server->OnNewConnection(addresses[i], guids[i], true);
+	}
+	void Disconnect(NatPunchthroughServer *server)
+	{
+		for (int i=0; i < userCount; i++)
+			server->OnClosedConnection(addresses[i], guids[i], LCR_DISCONNECTION_NOTIFICATION);
+	}
+
+	// Returns the session ID the server gives the attempt. Every request takes one, even if it is refused
+	uint16_t Request(NatPunchthroughServer *server, int sender, int recipient)
+	{
+		BitStream bs;
+		bs.Write((MessageID) ID_NAT_PUNCHTHROUGH_REQUEST);
+		bs.Write(guids[recipient]);
+		Deliver(server, sender, bs);
+		return nextSessionId++;
+	}
+	void SendMostRecentPort(NatPunchthroughServer *server, int user, uint16_t sessionId)
+	{
+		BitStream bs;
+		bs.Write((MessageID) ID_NAT_GET_MOST_RECENT_PORT);
+		bs.Write(sessionId);
+		bs.Write((unsigned short) (addresses[user].GetPort()+1));
+		Deliver(server, user, bs);
+	}
+	void SendReady(NatPunchthroughServer *server, int user)
+	{
+		BitStream bs;
+		bs.Write((MessageID) ID_NAT_CLIENT_READY);
+		Deliver(server, user, bs);
+	}
+	void Punch(NatPunchthroughServer *server, int sender, int recipient)
+	{
+		uint16_t sessionId=Request(server, sender, recipient);
+		SendMostRecentPort(server, sender, sessionId);
+		SendMostRecentPort(server, recipient, sessionId);
+		SendReady(server, sender);
+		SendReady(server, recipient);
+	}
+
+	// Two different users that are not in the pending attempts
+	void PickPair(int *sender, int *recipient)
+	{
+		*sender=PENDING_ATTEMPTS*2+(int) Random(userCount-PENDING_ATTEMPTS*2);
+		do
+		{
+			*recipient=PENDING_ATTEMPTS*2+(int) Random(userCount-PENDING_ATTEMPTS*2);
+		} while (*recipient==*sender);
+	}
+
+	int userCount;
+
+protected:
+	void Deliver(NatPunchthroughServer *server, int user, BitStream &bs)
+	{
+		Packet packet;
+		packet.systemAddress=addresses[user];
+		packet.guid=guids[user];
+		packet.data=bs.GetData();
+		packet.length=bs.GetNumberOfBytesUsed();
+		packet.bitSize=bs.GetNumberOfBitsUsed();
+		packet.deleteData=false;
+		packet.wasGeneratedLocally=false;
+		server->OnReceive(&packet);
+	}
+
+	RakNetGUID *guids;
+	SystemAddress *addresses;
+	uint16_t nextSessionId;
+};
+
+int NatPunchthroughServerBenchmark(void)
+{
+	printf("NAT punchthrough server benchmark.\n");
+	printf("Drives NatPunchthroughServer in process with 1 thousand to 100 thousand users, and prints the time per user, per Update() and per punch.\n");
+	printf("\n");
+
+	RakPeerInterface *rakPeer=RakPeerInterface::GetInstance();
+
+	printf("%8s %12s %12s %12s %12s\n", "Users", "Add ns", "Update us", "Punch ns", "Remove ns");
+	for (unsigned int i=0; i < sizeof(userCounts)/sizeof(userCounts[0]); i++)
+	{
+		NatPunchthroughServer *server=NatPunchthroughServer::GetInstance();
+		rakPeer->AttachPlugin(server);
+		PunchthroughLoadHarness harness(userCounts[i]);
+
+		SLNet::TimeUS startTime=SLNet::GetTimeUS();
+		harness.Connect(server);
+		SLNet::TimeUS addTime=SLNet::GetTimeUS()-startTime;
+
+		for (int j=0; j < PENDING_ATTEMPTS; j++)
+			harness.Request(server, j*2, j*2+1);
+
+		// Update() only does its work every 250 milliseconds
+		SLNet::TimeUS updateTime=0;
+		for (int j=0; j < UPDATE_SAMPLES; j++)
+		{
+			RakSleep(260);
+			startTime=SLNet::GetTimeUS();
+			server->Update();
+			updateTime+=SLNet::GetTimeUS()-startTime;
+		}
+
+		startTime=SLNet::GetTimeUS();
+		for (int j=0; j < NUM_PUNCHES; j++)
+		{
+			int sender, recipient;
+			harness.PickPair(&sender, &recipient);
+			harness.Punch(server, sender, recipient);
+		}
+		SLNet::TimeUS punchTime=SLNet::GetTimeUS()-startTime;
+
+		startTime=SLNet::GetTimeUS();
+		harness.Disconnect(server);
+		SLNet::TimeUS removeTime=SLNet::GetTimeUS()-startTime;
+
+		printf("%8i %12.1f %12.1f %12.1f %12.1f\n", userCounts[i],
+			(double) addTime*1000.0/userCounts[i],
+			(double) updateTime/UPDATE_SAMPLES,
+			(double) punchTime*1000.0/NUM_PUNCHES,
+			(double) removeTime*1000.0/userCounts[i]);
+
+		rakPeer->DetachPlugin(server);
+		NatPunchthroughServer::DestroyInstance(server);
+	}
+
+	RakPeerInterface::DestroyInstance(rakPeer);
+	return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures NetworkIDManager with 1 thousand to 1 million objects, as ReplicaManager3 resolves a NetworkID for each replica it receives.
+// Times assigning IDs to new objects, looking up IDs in random order, looking up IDs that are not tracked, and destroying the objects.
+// For comparison, also times lookups in 1024 chains of objects, the way NetworkIDManager stored them before.
+// NetworkIDManagerTest in the Tests project checks that every lookup returns the right object.
+
+#include "Benchmarks.h"
+
+#include "slikenet/NetworkIDManager.h"
+#include "slikenet/NetworkIDObject.h"
+#include "slikenet/GetTime.h"
+#include <cstdio>
+
+using namespace SLNet;
+
+static const int objectCounts[]={1000, 10000, 100000, 1000000};
+static const int NUM_LOOKUPS=100000;
+static const unsigned int NUM_CHAINS=1024;
+
+// Keeps the compiler from optimizing the lookups away
+static unsigned int foundCount;
+
+static unsigned int seed=42;
+static unsigned int Random(unsigned int range)
+{
+	seed=seed*1103515245+12345;
+	return ((seed>>8) ^ (seed<<14))%range;
+}
+
+// Objects in 1024 chains by NetworkID, as NetworkIDManager kept them before
+struct ChainedObject
+{
+	NetworkID networkId;
+	NetworkIDObject *object;
+	ChainedObject *next;
+};
+
+static NetworkIDObject *FindInChains(ChainedObject **chains, NetworkID networkId)
+{
+	ChainedObject *chainedObject=chains[networkId%NUM_CHAINS];
+	while (chainedObject)
+	{
+		if (chainedObject->networkId==networkId)
+			return chainedObject->object;
+		chainedObject=chainedObject->next;
+	}
+	return 0;
+}
+
+int NetworkIDManagerBenchmark(void)
+{
+	printf("NetworkIDManager benchmark.\n");
+	printf("Tracks 1 thousand to 1 million objects, and prints nanoseconds per object or lookup.\n");
+	printf("\n");
+
+	printf("%10s %10s %10s %10s %10s %10s\n", "Objects", "Assign", "Lookup", "Not found", "Chained", "Destroy");
+	for (unsigned int i=0; i < sizeof(objectCounts)/sizeof(objectCounts[0]); i++)
+	{
+		const int objectCount=objectCounts[i];
+		NetworkIDManager networkIDManager;
+		NetworkIDObject *objects=new NetworkIDObject[objectCount];
+
+		SLNet::TimeUS startTime=SLNet::GetTimeUS();
+		for (int j=0; j < objectCount; j++)
+			objects[j].SetNetworkIDManager(&networkIDManager);
+		SLNet::TimeUS assignTime=SLNet::GetTimeUS()-startTime;
+
+		NetworkID *lookupIds=new NetworkID[NUM_LOOKUPS];
+		for (int j=0; j < NUM_LOOKUPS; j++)
+			lookupIds[j]=objects[Random(objectCount)].GetNetworkID();
+
+		startTime=SLNet::GetTimeUS();
+		for (int j=0; j < NUM_LOOKUPS; j++)
+		{
+			if (networkIDManager.GET_OBJECT_FROM_ID<NetworkIDObject*>(lookupIds[j])!=0)
+				foundCount++;
+		}
+		SLNet::TimeUS lookupTime=SLNet::GetTimeUS()-startTime;
+
+		// IDs next to the assigned ones, which is what another authority would assign
+		startTime=SLNet::GetTimeUS();
+		for (int j=0; j < NUM_LOOKUPS; j++)
+		{
+			if (networkIDManager.GET_OBJECT_FROM_ID<NetworkIDObject*>(lookupIds[j]+objectCount+1)!=0)
+				foundCount++;
+		}
+		SLNet::TimeUS notFoundTime=SLNet::GetTimeUS()-startTime;
+
+		ChainedObject **chains=new ChainedObject*[NUM_CHAINS];
+		for (unsigned int j=0; j < NUM_CHAINS; j++)
+			chains[j]=0;
+		ChainedObject *chainedObjects=new ChainedObject[objectCount];
+		for (int j=0; j < objectCount; j++)
+		{
+			ChainedObject *chainedObject=&chainedObjects[j];
+			chainedObject->networkId=objects[j].GetNetworkID();
+			chainedObject->object=&objects[j];
+			chainedObject->next=chains[chainedObject->networkId%NUM_CHAINS];
+			chains[chainedObject->networkId%NUM_CHAINS]=chainedObject;
+		}
+		startTime=SLNet::GetTimeUS();
+		for (int j=0; j < NUM_LOOKUPS; j++)
+		{
+			if (FindInChains(chains, lookupIds[j])!=0)
+				foundCount++;
+		}
+		SLNet::TimeUS chainedTime=SLNet::GetTimeUS()-startTime;
+		delete [] chainedObjects;
+		delete [] chains;
+
+		startTime=SLNet::GetTimeUS();
+		delete [] objects;
+		SLNet::TimeUS destroyTime=SLNet::GetTimeUS()-startTime;
+
+		delete [] lookupIds;
+
+		printf("%10i %10.1f %10.1f %10.1f %10.1f %10.1f\n", objectCount,
+			(double) assignTime*1000.0/objectCount,
+			(double) lookupTime*1000.0/NUM_LOOKUPS,
+			(double) notFoundTime*1000.0/NUM_LOOKUPS,
+			(double) chainedTime*1000.0/NUM_LOOKUPS,
+			(double) destroyTime*1000.0/objectCount);
+	}
+
+	printf("\nLookups found %u objects\n", foundCount);
+	return 0;
+}
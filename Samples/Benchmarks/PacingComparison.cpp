@@ -0,0 +1,224 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Compares sending with and without RakPeerInterface::SetPerConnectionPacing() over loopback.
+// A sender streams 64 KB messages to a receiver, and alongside them sends a small gameplay message every 16 milliseconds.
+// Reports the largest number of datagrams sent back to back, the pacing rate, bulk goodput, the latency of the gameplay messages, and how much data was retransmitted.
+// ApplyNetworkSimulator() only works in debug builds. In release builds, every run has the conditions of loopback.
+
+#include "Benchmarks.h"
+
+#include "slikenet/peerinterface.h"
+#include "slikenet/MessageIdentifiers.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include "slikenet/statistics.h"
+#include "slikenet/DS_List.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string.h>
+
+using namespace SLNet;
+
+static const unsigned short SENDER_PORT=60210;
+static const unsigned short RECEIVER_PORT=60211;
+static const SLNet::TimeMS RUN_TIME_MS=3000;
+static const int BULK_MESSAGE_SIZE=64*1024;
+static const int GAMEPLAY_MESSAGE_SIZE=32;
+static const SLNet::TimeMS GAMEPLAY_INTERVAL_MS=16;
+// Keep about this much bulk data queued in the sender
+static const double SEND_BUFFER_BYTES=512*1024;
+
+static const MessageID ID_BULK=ID_USER_PACKET_ENUM;
+static const MessageID ID_GAMEPLAY=ID_USER_PACKET_ENUM+1;
+
+struct PacingController
+{
+	CongestionControlType type;
+	const char *name;
+};
+
+static const PacingController controllers[]=
+{
+	{SLIDING_WINDOW_CONGESTION_CONTROL, "SlidingWindow"},
+	{UDT_CONGESTION_CONTROL, "UDT"},
+	{BBR_CONGESTION_CONTROL, "BBR"},
+};
+
+// 0 is pacing off
+static const unsigned burstSizes[]={0, 16, 4};
+
+static int CompareLatency(const void *a, const void *b)
+{
+	SLNet::TimeUS x=*(const SLNet::TimeUS *) a, y=*(const SLNet::TimeUS *) b;
+	return x<y ? -1 : (x>y ? 1 : 0);
+}
+
+static bool Connect(RakPeerInterface *sender, RakPeerInterface *receiver, SystemAddress *receiverAddress)
+{
+	if (receiver->Connect("127.0.0.1", SENDER_PORT, 0, 0)!=CONNECTION_ATTEMPT_STARTED)
+		return false;
+
+	SLNet::TimeMS timeout=SLNet::GetTimeMS()+5000;
+	bool senderConnected=false, receiverConnected=false;
+	while ((senderConnected==false || receiverConnected==false) && SLNet::GetTimeMS()<timeout)
+	{
+		Packet *p;
+		for (p=sender->Receive(); p; sender->DeallocatePacket(p), p=sender->Receive())
+		{
+			if (p->data[0]==ID_NEW_INCOMING_CONNECTION)
+			{
+				*receiverAddress=p->systemAddress;
+				senderConnected=true;
+			}
+		}
+		for (p=receiver->Receive(); p; receiver->DeallocatePacket(p), p=receiver->Receive())
+		{
+			if (p->data[0]==ID_CONNECTION_REQUEST_ACCEPTED)
+				receiverConnected=true;
+		}
+		RakSleep(10);
+	}
+	return senderConnected && receiverConnected;
+}
+
+static void RunTest(const PacingController &controller, unsigned maxBurstDatagrams)
+{
+	RakPeerInterface *sender=RakPeerInterface::GetInstance();
+	RakPeerInterface *receiver=RakPeerInterface::GetInstance();
+	sender->SetCongestionControl(controller.type, UNASSIGNED_SYSTEM_ADDRESS);
+	sender->SetPerConnectionPacing(maxBurstDatagrams);
+	sender->SetMaximumIncomingConnections(1);
+	SocketDescriptor senderSocket(SENDER_PORT, "127.0.0.1"), receiverSocket(RECEIVER_PORT, "127.0.0.1");
+	if (sender->Startup(1, &senderSocket, 1)!=RAKNET_STARTED || receiver->Startup(1, &receiverSocket, 1)!=RAKNET_STARTED)
+	{
+		printf("%-14s %5u Startup failed\n", controller.name, maxBurstDatagrams);
+		RakPeerInterface::DestroyInstance(sender);
+		RakPeerInterface::DestroyInstance(receiver);
+		return;
+	}
+
+	// A link with some latency and loss, so that congestion control has a window to burst
+	sender->ApplyNetworkSimulator(0.005f, 10, 0);
+	receiver->ApplyNetworkSimulator(0.0f, 10, 0);
+
+	SystemAddress receiverAddress;
+	if (Connect(sender, receiver, &receiverAddress)==false)
+	{
+		printf("%-14s %5u Connect failed\n", controller.name, maxBurstDatagrams);
+		sender->Shutdown(0);
+		receiver->Shutdown(0);
+		RakPeerInterface::DestroyInstance(sender);
+		RakPeerInterface::DestroyInstance(receiver);
+		return;
+	}
+
+	char *bulkMessage=new char[BULK_MESSAGE_SIZE];
+	memset(bulkMessage, 0, BULK_MESSAGE_SIZE);
+	bulkMessage[0]=ID_BULK;
+	char gameplayMessage[GAMEPLAY_MESSAGE_SIZE];
+	memset(gameplayMessage, 0, sizeof(gameplayMessage));
+	gameplayMessage[0]=ID_GAMEPLAY;
+
+	uint64_t bulkBytesReceived=0;
+	DataStructures::List<SLNet::TimeUS> gameplayLatencies;
+	RakNetStatistics rns;
+	uint64_t pacingRateSum=0;
+	unsigned int pacingRateSamples=0;
+	SLNet::TimeMS startTime=SLNet::GetTimeMS();
+	SLNet::TimeMS nextGameplayTime=startTime;
+	while (SLNet::GetTimeMS()-startTime < RUN_TIME_MS)
+	{
+		if (sender->GetStatistics(receiverAddress, &rns))
+		{
+			if (rns.bytesInSendBuffer[LOW_PRIORITY] < SEND_BUFFER_BYTES)
+				sender->Send(bulkMessage, BULK_MESSAGE_SIZE, LOW_PRIORITY, RELIABLE_ORDERED, 1, receiverAddress, false);
+			if (rns.pacingBytesPerSecond!=0)
+			{
+				pacingRateSum+=rns.pacingBytesPerSecond;
+				pacingRateSamples++;
+			}
+		}
+
+		if (SLNet::GetTimeMS()>=nextGameplayTime)
+		{
+			SLNet::TimeUS sendTime=SLNet::GetTimeUS();
+			memcpy(gameplayMessage+1, &sendTime, sizeof(sendTime));
+			sender->Send(gameplayMessage, GAMEPLAY_MESSAGE_SIZE, HIGH_PRIORITY, RELIABLE_ORDERED, 0, receiverAddress, false);
+			nextGameplayTime+=GAMEPLAY_INTERVAL_MS;
+		}
+
+		Packet *p;
+		for (p=receiver->Receive(); p; receiver->DeallocatePacket(p), p=receiver->Receive())
+		{
+			if (p->data[0]==ID_BULK)
+				bulkBytesReceived+=p->length;
+			else if (p->data[0]==ID_GAMEPLAY && p->length==GAMEPLAY_MESSAGE_SIZE)
+			{
+				SLNet::TimeUS sendTime;
+				memcpy(&sendTime, p->data+1, sizeof(sendTime));
+				gameplayLatencies.Insert(SLNet::GetTimeUS()-sendTime, _FILE_AND_LINE_);
+			}
+		}
+		for (p=sender->Receive(); p; sender->DeallocatePacket(p), p=sender->Receive())
+			;
+		RakSleep(1);
+	}
+
+	double seconds=(double) (SLNet::GetTimeMS()-startTime) / 1000.0;
+	sender->GetStatistics(receiverAddress, &rns);
+	uint64_t bytesSent=rns.runningTotal[USER_MESSAGE_BYTES_SENT]+rns.runningTotal[USER_MESSAGE_BYTES_RESENT];
+	double averageLatency=0.0, tailLatency=0.0;
+	if (gameplayLatencies.Size()>0)
+	{
+		SLNet::TimeUS *latencies=new SLNet::TimeUS[gameplayLatencies.Size()];
+		SLNet::TimeUS latencySum=0;
+		for (unsigned int i=0; i < gameplayLatencies.Size(); i++)
+		{
+			latencies[i]=gameplayLatencies[i];
+			latencySum+=latencies[i];
+		}
+		qsort(latencies, gameplayLatencies.Size(), sizeof(SLNet::TimeUS), CompareLatency);
+		averageLatency=(double) latencySum / (double) gameplayLatencies.Size() / 1000.0;
+		tailLatency=(double) latencies[gameplayLatencies.Size()*99/100] / 1000.0;
+		delete [] latencies;
+	}
+	printf("%-14s %5u %8u %8.2f MB/s %8.2f MB/s %8.1f ms %8.1f ms %8.2f %%\n",
+		controller.name,
+		maxBurstDatagrams,
+		rns.largestBurstDatagrams,
+		pacingRateSamples ? (double) (pacingRateSum/pacingRateSamples) / 1000000.0 : 0.0,
+		(double) bulkBytesReceived / seconds / 1000000.0,
+		averageLatency,
+		tailLatency,
+		bytesSent ? (double) rns.runningTotal[USER_MESSAGE_BYTES_RESENT] * 100.0 / (double) bytesSent : 0.0);
+
+	delete [] bulkMessage;
+	sender->Shutdown(0);
+	receiver->Shutdown(0);
+	RakPeerInterface::DestroyInstance(sender);
+	RakPeerInterface::DestroyInstance(receiver);
+}
+
+int PacingComparison(void)
+{
+	printf("Pacing comparison.\n");
+	printf("Streams 64 KB messages over loopback with 20 ms ping and 0.5%% loss, together with a small gameplay message every 16 ms, with and without pacing.\n");
+#ifndef _DEBUG
+	printf("Not a debug build, so the network simulator is inactive and every run has the conditions of loopback.\n");
+#endif
+	printf("\n");
+
+	printf("%-14s %5s %8s %13s %13s %11s %11s %10s\n", "Controller", "Burst", "Largest", "Pacing rate", "Goodput", "Gameplay", "99th pct", "Resent");
+	for (unsigned int i=0; i < sizeof(controllers)/sizeof(controllers[0]); i++)
+	{
+		for (unsigned int j=0; j < sizeof(burstSizes)/sizeof(burstSizes[0]); j++)
+			RunTest(controllers[i], burstSizes[j]);
+	}
+
+	return 0;
+}
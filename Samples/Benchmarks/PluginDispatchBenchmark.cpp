@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures what RakPeer::Receive() costs per message with 0 to 16 plugins attached.
+// Each plugin handles one message ID of its own. Runs once with plugins that get every message in OnReceive(),
+// and once with plugins that list their message ID in GetReceivedMessageIDs(), so RakPeer only passes them that message.
+// Queues mostly game messages that no plugin handles, and some messages for each plugin, with PushBackPacket(), then times Receive().
+// PluginDispatchTest in the Tests project checks that every plugin gets its messages in order.
+
+#include "Benchmarks.h"
+
+#include "slikenet/peerinterface.h"
+#include "slikenet/PluginInterface2.h"
+#include "slikenet/MessageIdentifiers.h"
+#include "slikenet/GetTime.h"
+#include <cstdio>
+
+using namespace SLNet;
+
+static const int pluginCounts[]={0, 1, 4, 8, 12, 16};
+static const int MAX_PLUGINS=16;
+static const int NUM_MESSAGES=500000;
+// One in this many messages is for a plugin
+static const int PLUGIN_MESSAGE_INTERVAL=16;
+static const int BATCH_SIZE=1000;
+
+class MessagePlugin : public PluginInterface2
+{
+public:
+	MessagePlugin(MessageID _messageId, bool _listsMessageIDs) : messageId(_messageId), listsMessageIDs(_listsMessageIDs) {}
+
+	virtual PluginReceiveResult OnReceive(Packet *packet)
+	{
+		if (packet->data[0]==messageId)
+			return RR_STOP_PROCESSING_AND_DEALLOCATE;
+		return RR_CONTINUE_PROCESSING;
+	}
+	virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const
+	{
+		if (listsMessageIDs==false)
+			return false;
+		messageIDs[messageId]=true;
+		return true;
+	}
+
+	MessageID messageId;
+	bool listsMessageIDs;
+};
+
+int PluginDispatchBenchmark(void)
+{
+	printf("Plugin dispatch benchmark.\n");
+	printf("Passes %i messages through RakPeer::Receive() with 0 to %i plugins, and prints nanoseconds per message.\n", NUM_MESSAGES, MAX_PLUGINS);
+	printf("\n");
+
+	RakPeerInterface *rakPeer=RakPeerInterface::GetInstance();
+	SocketDescriptor socketDescriptor;
+	if (rakPeer->Startup(1, &socketDescriptor, 1)!=RAKNET_STARTED)
+	{
+		printf("Startup failed\n");
+		RakPeerInterface::DestroyInstance(rakPeer);
+		return 1;
+	}
+
+	Packet *receivedPackets[BATCH_SIZE];
+	printf("%8s %14s %14s\n", "Plugins", "Every message", "Listed IDs");
+	for (unsigned int i=0; i < sizeof(pluginCounts)/sizeof(pluginCounts[0]); i++)
+	{
+		double nanoseconds[2];
+		for (int listsMessageIDs=0; listsMessageIDs < 2; listsMessageIDs++)
+		{
+			MessagePlugin *plugins[MAX_PLUGINS];
+			for (int j=0; j < pluginCounts[i]; j++)
+			{
+				plugins[j]=new MessagePlugin((MessageID) (ID_USER_PACKET_ENUM+1+j), listsMessageIDs!=0);
+				rakPeer->AttachPlugin(plugins[j]);
+			}
+
+			// Queue the messages in batches, and only time Receive()
+			int gameMessageCount=0;
+			SLNet::TimeUS elapsed=0;
+			for (int j=0; j < NUM_MESSAGES; j+=BATCH_SIZE)
+			{
+				for (int k=j; k < j+BATCH_SIZE; k++)
+				{
+					Packet *packet=rakPeer->AllocatePacket(8);
+					if (k%PLUGIN_MESSAGE_INTERVAL==0 && pluginCounts[i]>0)
+						packet->data[0]=(MessageID) (ID_USER_PACKET_ENUM+1+(k/PLUGIN_MESSAGE_INTERVAL)%pluginCounts[i]);
+					else
+						packet->data[0]=ID_USER_PACKET_ENUM;
+					rakPeer->PushBackPacket(packet, false);
+				}
+
+				SLNet::TimeUS startTime=SLNet::GetTimeUS();
+				Packet *received;
+				while ((received=rakPeer->Receive())!=0)
+					receivedPackets[gameMessageCount++]=received;
+				elapsed+=SLNet::GetTimeUS()-startTime;
+
+				for (int k=0; k < gameMessageCount; k++)
+					rakPeer->DeallocatePacket(receivedPackets[k]);
+				gameMessageCount=0;
+			}
+			nanoseconds[listsMessageIDs]=(double) elapsed*1000.0/NUM_MESSAGES;
+
+			for (int j=0; j < pluginCounts[i]; j++)
+			{
+				rakPeer->DetachPlugin(plugins[j]);
+				delete plugins[j];
+			}
+		}
+		printf("%8i %14.1f %14.1f\n", pluginCounts[i], nanoseconds[0], nanoseconds[1]);
+	}
+
+	rakPeer->Shutdown(0);
+	RakPeerInterface::DestroyInstance(rakPeer);
+	return 0;
+}
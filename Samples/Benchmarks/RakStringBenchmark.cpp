@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures how fast RakString is copied, assigned, and hashed with RakString::ToInteger() from several threads at once.
+// All threads work on the same source strings, as when a name held by one object is copied into messages by every thread.
+// A short string is stored inline in each copy, while copies of a long string share one reference counted allocation.
+
+#include "Benchmarks.h"
+
+#include "slikenet/string.h"
+#include "slikenet/thread.h"
+#include "slikenet/LocklessTypes.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include <cstdio>
+
+using namespace SLNet;
+
+static const unsigned int ITERATIONS_PER_THREAD=2000000;
+static const unsigned int MAX_THREADS=8;
+
+enum Operation
+{
+	OPERATION_COPY,
+	OPERATION_ASSIGN,
+	OPERATION_HASH
+};
+
+static const char *operationNames[]={"Copy", "Assign", "Hash"};
+
+struct ThreadArguments
+{
+	const RakString *source;
+	const RakString *otherSource;
+	Operation operation;
+	// Keeps the compiler from removing the work
+	unsigned long result;
+};
+
+static LocklessUint32_t threadsDone;
+
+RAK_THREAD_DECLARATION(RakStringThread)
+{
+	ThreadArguments *threadArguments=(ThreadArguments *) arguments;
+	unsigned long result=0;
+	switch (threadArguments->operation)
+	{
+	case OPERATION_COPY:
+		for (unsigned int i=0; i < ITERATIONS_PER_THREAD; i++)
+		{
+			RakString copy(*threadArguments->source);
+			result+=(unsigned char) copy.C_String()[i&7];
+		}
+		break;
+	case OPERATION_ASSIGN:
+		{
+			RakString target;
+			for (unsigned int i=0; i < ITERATIONS_PER_THREAD; i++)
+			{
+				target=(i&1) ? *threadArguments->source : *threadArguments->otherSource;
+				result+=(unsigned char) target.C_String()[i&7];
+			}
+		}
+		break;
+	case OPERATION_HASH:
+		for (unsigned int i=0; i < ITERATIONS_PER_THREAD; i++)
+			result+=RakString::ToInteger(*threadArguments->source);
+		break;
+	}
+	threadArguments->result=result;
+	threadsDone.Increment();
+	return 0;
+}
+
+// Returns millions of operations per second over all threads
+static double RunTest(const RakString &source, const RakString &otherSource, Operation operation, unsigned int numThreads)
+{
+	ThreadArguments threadArguments[MAX_THREADS];
+	threadsDone.Store(0);
+	SLNet::TimeUS startTime=SLNet::GetTimeUS();
+	for (unsigned int i=0; i < numThreads; i++)
+	{
+		threadArguments[i].source=&source;
+		threadArguments[i].otherSource=&otherSource;
+		threadArguments[i].operation=operation;
+		threadArguments[i].result=0;
+		if (SLNet::RakThread::Create(&RakStringThread, &threadArguments[i])!=0)
+		{
+			printf("Failed to create a thread\n");
+			return 0.0;
+		}
+	}
+	while (threadsDone.Load()!=numThreads)
+		RakSleep(1);
+	SLNet::TimeUS elapsed=SLNet::GetTimeUS()-startTime;
+	return (double) ITERATIONS_PER_THREAD * numThreads / (double) elapsed;
+}
+
+int RakStringBenchmark(void)
+{
+	printf("RakString benchmark.\n");
+	printf("Copies, assigns, and hashes the same strings from 1 to %u threads, and prints millions of operations per second over all threads.\n", MAX_THREADS);
+	printf("Strings of up to %i bytes are stored inline. sizeof(RakString) is %u.\n", RAKSTRING_INLINE_SIZE, (unsigned int) sizeof(RakString));
+	printf("\n");
+
+	RakString shortString("PlayerName_0042"), otherShortString("PlayerName_0043");
+	RakString longString("Lobby/Europe/West/Ranked/Room_0042 hosted by PlayerName_0042 with a long description");
+	RakString otherLongString("Lobby/Europe/West/Ranked/Room_0043 hosted by PlayerName_0043 with a long description");
+
+	printf("%-8s %-6s", "Op", "Length");
+	for (unsigned int numThreads=1; numThreads <= MAX_THREADS; numThreads*=2)
+		printf(" %7u thr", numThreads);
+	printf("\n");
+
+	for (int operation=OPERATION_COPY; operation <= OPERATION_HASH; operation++)
+	{
+		for (int isLong=0; isLong < 2; isLong++)
+		{
+			const RakString &source=isLong ? longString : shortString;
+			const RakString &otherSource=isLong ? otherLongString : otherShortString;
+			printf("%-8s %-6u", operationNames[operation], (unsigned int) source.GetLength());
+			for (unsigned int numThreads=1; numThreads <= MAX_THREADS; numThreads*=2)
+				printf(" %11.1f", RunTest(source, otherSource, (Operation) operation, numThreads));
+			printf("\n");
+		}
+	}
+
+	return 0;
+}
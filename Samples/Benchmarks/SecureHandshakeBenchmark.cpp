@@ -0,0 +1,405 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures how many secure handshakes a server answers per second, with the challenges answered on the network thread
+// and with RakPeerInterface::SetSecureHandshakeThreads() on 1 to 4 worker threads.
+// The clients are not RakPeer instances. Each client is a plain UDP socket, and its challenge is generated before the timed part,
+// so the clients only copy bytes while the server is timed. All clients send their connection requests at once,
+// and the time until every client got ID_OPEN_CONNECTION_REPLY_2 with the answer to its challenge is measured.
+// While the clients connect, another socket sends ID_UNCONNECTED_PING to the server, which the network thread answers between
+// the packets it processes. The ping round trip shows how long the network thread takes for one update cycle, so it shows
+// whether answering the challenges stalls it.
+// The last run uses a short queue, so the server drops connection requests and the clients send them again.
+// Worker threads can only answer faster than the network thread on a machine with more cores than worker threads.
+// UpdateShardsTest in the Tests project checks that handshakes answered on worker threads connect.
+
+#include "Benchmarks.h"
+
+#include "slikenet/peerinterface.h"
+#include "slikenet/MessageIdentifiers.h"
+#include "slikenet/NativeFeatureIncludes.h"
+#include "slikenet/SecureHandshake.h"
+#include "slikenet/socket2.h"
+#include "slikenet/SocketIncludes.h"
+#include "slikenet/BitStream.h"
+#include "slikenet/DS_Queue.h"
+#include "slikenet/SimpleMutex.h"
+#include "slikenet/SignaledEvent.h"
+#include "slikenet/version.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include <cstdio>
+
+using namespace SLNet;
+
+#if LIBCAT_SECURITY==1
+static const unsigned int NUM_CLIENTS=256;
+// Index of the socket that sends the pings
+static const unsigned int PING_SOCKET=NUM_CLIENTS;
+static const SLNet::TimeMS RESEND_MS=250;
+static const SLNet::TimeMS PING_TIMEOUT_MS=1000;
+static const SLNet::TimeMS TIMEOUT_MS=60000;
+// Padded size of ID_OPEN_CONNECTION_REQUEST_1, which the server uses as the MTU
+static const unsigned int REQUEST_1_SIZE=576;
+// Same as OFFLINE_MESSAGE_DATA_ID in RakPeer.cpp, which marks messages from unconnected systems
+static const unsigned char OFFLINE_MESSAGE_DATA_ID[16]={0x00,0xFF,0xFF,0x00,0xFE,0xFE,0xFE,0xFE,0xFD,0xFD,0xFD,0xFD,0x12,0x34,0x56,0x78};
+
+struct Run
+{
+	unsigned int threads;
+	unsigned int maxQueueLength;
+};
+static const Run runs[]={{0, 1024}, {1, 1024}, {2, 1024}, {4, 1024}, {2, 4}};
+
+// Queues the datagrams the receive threads of all sockets read, for the main thread
+class QueueEventHandler : public RNS2EventHandler
+{
+public:
+	QueueEventHandler() {receivedEvent.InitEvent();}
+	~QueueEventHandler() {receivedEvent.CloseEvent();}
+	virtual void OnRNS2Recv(RNS2RecvStruct *recvStruct)
+	{
+		mutex.Lock();
+		received.Push(recvStruct, _FILE_AND_LINE_);
+		mutex.Unlock();
+		receivedEvent.SetEvent();
+	}
+	virtual void DeallocRNS2RecvStruct(RNS2RecvStruct *s, const char *file, unsigned int line)
+	{
+		SLNet::OP_DELETE(s, file, line);
+	}
+	virtual RNS2RecvStruct *AllocRNS2RecvStruct(const char *file, unsigned int line)
+	{
+		return SLNet::OP_NEW<RNS2RecvStruct>(file, line);
+	}
+	RNS2RecvStruct *Pop(void)
+	{
+		RNS2RecvStruct *s=0;
+		mutex.Lock();
+		if (received.Size())
+			s=received.Pop();
+		mutex.Unlock();
+		return s;
+	}
+
+	SignaledEvent receivedEvent;
+
+private:
+	DataStructures::Queue<RNS2RecvStruct*> received;
+	SimpleMutex mutex;
+};
+
+struct Ping
+{
+	uint32_t index;
+	bool inFlight;
+	SLNet::TimeUS sendTime;
+	SLNet::TimeUS totalRoundTrip;
+	SLNet::TimeUS maxRoundTrip;
+	unsigned int count;
+};
+
+struct Client
+{
+	RNS2_Berkley *socket;
+	cat::ClientEasyHandshake handshake;
+	char challenge[cat::EasyHandshake::CHALLENGE_BYTES];
+	char answer[cat::EasyHandshake::ANSWER_BYTES];
+	bool answered;
+	SLNet::TimeMS lastSendTime;
+};
+
+static RNS2_Berkley *BindSocket(unsigned int index, RNS2EventHandler *eventHandler)
+{
+	RNS2_BerkleyBindParameters bbp;
+	bbp.port=0;
+	bbp.hostAddress=(char*) "127.0.0.1";
+	bbp.addressFamily=AF_INET;
+	bbp.type=SOCK_DGRAM;
+	bbp.protocol=0;
+	bbp.nonBlockingSocket=false;
+	bbp.setBroadcast=false;
+	bbp.setIPHdrIncl=false;
+	bbp.doNotFragment=false;
+	bbp.pollingThreadPriority=0;
+	bbp.eventHandler=eventHandler;
+	bbp.remotePortRakNetWasStartedOn_PS3_PS4_PSP2=0;
+	bbp.reusePort=false;
+	RNS2_Berkley *s=(RNS2_Berkley*) RakNetSocket2Allocator::AllocRNS2();
+	if (s->Bind(&bbp, _FILE_AND_LINE_)!=BR_SUCCESS || s->CreateRecvPollingThread(0)!=0)
+	{
+		RakNetSocket2Allocator::DeallocRNS2(s);
+		return 0;
+	}
+	s->SetUserConnectionSocketIndex(index);
+	return s;
+}
+
+static void SendBitStream(RakNetSocket2 *socket, BitStream *bs, const SystemAddress &serverAddress)
+{
+	RNS2_SendParameters bsp;
+	bsp.data=(char*) bs->GetData();
+	bsp.length=(int) bs->GetNumberOfBytesUsed();
+	bsp.systemAddress=serverAddress;
+	socket->Send(&bsp, _FILE_AND_LINE_);
+}
+
+static void SendRequest1(Client *client, const SystemAddress &serverAddress)
+{
+	BitStream bs;
+	bs.Write((MessageID) ID_OPEN_CONNECTION_REQUEST_1);
+	bs.WriteAlignedBytes(OFFLINE_MESSAGE_DATA_ID, sizeof(OFFLINE_MESSAGE_DATA_ID));
+	bs.Write((MessageID) RAKNET_PROTOCOL_VERSION);
+	bs.PadWithZeroToByteLength(REQUEST_1_SIZE);
+	SendBitStream(client->socket, &bs, serverAddress);
+	client->lastSendTime=SLNet::GetTimeMS();
+}
+
+// Answers ID_OPEN_CONNECTION_REPLY_1 with the challenge, as RakPeer does
+static void SendRequest2(Client *client, unsigned int clientIndex, RNS2RecvStruct *reply1, const SystemAddress &serverAddress)
+{
+	BitStream bsIn((unsigned char*) reply1->data, (BitSize_t) reply1->bytesRead, false);
+	bsIn.IgnoreBytes(sizeof(MessageID)+sizeof(OFFLINE_MESSAGE_DATA_ID));
+	RakNetGUID serverGuid;
+	bsIn.Read(serverGuid);
+	unsigned char serverHasSecurity=0;
+	uint32_t cookie;
+	bsIn.Read(serverHasSecurity);
+	if (serverHasSecurity==0 || bsIn.Read(cookie)==false)
+		return;
+	bsIn.IgnoreBytes(cat::EasyHandshake::PUBLIC_KEY_BYTES);
+	uint16_t mtu;
+	if (bsIn.Read(mtu)==false)
+		return;
+
+	BitStream bsOut;
+	bsOut.Write((MessageID) ID_OPEN_CONNECTION_REQUEST_2);
+	bsOut.WriteAlignedBytes(OFFLINE_MESSAGE_DATA_ID, sizeof(OFFLINE_MESSAGE_DATA_ID));
+	bsOut.Write(cookie);
+	bsOut.Write((unsigned char) 1);
+	bsOut.WriteAlignedBytes((const unsigned char*) client->challenge, sizeof(client->challenge));
+	bsOut.Write(serverAddress);
+	bsOut.Write(mtu);
+	bsOut.Write(RakNetGUID(clientIndex+1));
+	SendBitStream(client->socket, &bsOut, serverAddress);
+}
+
+// Returns false if the reply has no answer to the challenge
+static bool ReadReply2(Client *client, RNS2RecvStruct *reply2)
+{
+	BitStream bsIn((unsigned char*) reply2->data, (BitSize_t) reply2->bytesRead, false);
+	bsIn.IgnoreBytes(sizeof(MessageID)+sizeof(OFFLINE_MESSAGE_DATA_ID));
+	RakNetGUID serverGuid;
+	SystemAddress ourAddress;
+	uint16_t mtu;
+	bool requiresSecurity=false;
+	bsIn.Read(serverGuid);
+	bsIn.Read(ourAddress);
+	bsIn.Read(mtu);
+	bsIn.Read(requiresSecurity);
+	return requiresSecurity && bsIn.ReadAlignedBytes((unsigned char*) client->answer, sizeof(client->answer));
+}
+
+static void SendPing(RakNetSocket2 *socket, Ping *ping, const SystemAddress &serverAddress)
+{
+	BitStream bs;
+	bs.Write((MessageID) ID_UNCONNECTED_PING);
+	bs.Write((SLNet::Time) ++ping->index);
+	bs.WriteAlignedBytes(OFFLINE_MESSAGE_DATA_ID, sizeof(OFFLINE_MESSAGE_DATA_ID));
+	bs.Write(RakNetGUID(NUM_CLIENTS+1));
+	ping->sendTime=SLNet::GetTimeUS();
+	ping->inFlight=true;
+	SendBitStream(socket, &bs, serverAddress);
+}
+
+static void ReadPong(Ping *ping, RNS2RecvStruct *pong)
+{
+	BitStream bsIn((unsigned char*) pong->data, (BitSize_t) pong->bytesRead, false);
+	MessageID messageId=ID_CONNECTED_PING;
+	SLNet::Time pongIndex;
+	bsIn.Read(messageId);
+	if (messageId!=ID_UNCONNECTED_PONG || bsIn.Read(pongIndex)==false || pongIndex!=(SLNet::Time) ping->index || ping->inFlight==false)
+		return;
+	SLNet::TimeUS roundTrip=pong->timeRead-ping->sendTime;
+	ping->totalRoundTrip+=roundTrip;
+	if (roundTrip > ping->maxRoundTrip)
+		ping->maxRoundTrip=roundTrip;
+	ping->count++;
+	ping->inFlight=false;
+}
+
+static bool RunHandshakes(const Run &run, char *publicKey, char *privateKey, Client *clients, RNS2_Berkley *pingSocket, QueueEventHandler *eventHandler)
+{
+	RakPeerInterface *server=RakPeerInterface::GetInstance();
+	server->InitializeSecurity(publicKey, privateKey);
+	server->SetSecureHandshakeThreads(run.threads, run.maxQueueLength);
+	SocketDescriptor socketDescriptor(0, "127.0.0.1");
+	if (server->Startup(NUM_CLIENTS, &socketDescriptor, 1)!=RAKNET_STARTED)
+	{
+		RakPeerInterface::DestroyInstance(server);
+		return false;
+	}
+	server->SetMaximumIncomingConnections(NUM_CLIENTS);
+	SystemAddress serverAddress("127.0.0.1", server->GetMyBoundAddress().GetPort());
+
+	unsigned int i;
+	for (i=0; i < NUM_CLIENTS; i++)
+	{
+		if (clients[i].handshake.Initialize(publicKey)==false || clients[i].handshake.GenerateChallenge(clients[i].challenge)==false)
+		{
+			server->Shutdown(0);
+			RakPeerInterface::DestroyInstance(server);
+			return false;
+		}
+		clients[i].answered=false;
+	}
+	RNS2RecvStruct *recvStruct;
+	while ((recvStruct=eventHandler->Pop())!=0)
+		eventHandler->DeallocRNS2RecvStruct(recvStruct, _FILE_AND_LINE_);
+
+	SLNet::TimeUS startTime=SLNet::GetTimeUS();
+	for (i=0; i < NUM_CLIENTS; i++)
+		SendRequest1(&clients[i], serverAddress);
+
+	unsigned int answeredCount=0;
+	Ping ping={0, false, 0, 0, 0, 0};
+	SLNet::TimeMS startTimeMS=SLNet::GetTimeMS();
+	while (answeredCount < NUM_CLIENTS && SLNet::GetTimeMS()-startTimeMS < TIMEOUT_MS)
+	{
+		if (ping.inFlight==false || SLNet::GetTimeUS()-ping.sendTime > (SLNet::TimeUS) PING_TIMEOUT_MS*1000)
+			SendPing(pingSocket, &ping, serverAddress);
+
+		eventHandler->receivedEvent.WaitOnEvent(1);
+		while ((recvStruct=eventHandler->Pop())!=0)
+		{
+			unsigned int index=recvStruct->socket->GetUserConnectionSocketIndex();
+			unsigned char messageId=recvStruct->bytesRead > 0 ? (unsigned char) recvStruct->data[0] : 0;
+			if (index==PING_SOCKET)
+				ReadPong(&ping, recvStruct);
+			else if (index < NUM_CLIENTS && clients[index].answered==false)
+			{
+				if (messageId==ID_OPEN_CONNECTION_REPLY_1)
+					SendRequest2(&clients[index], index, recvStruct, serverAddress);
+				else if (messageId==ID_OPEN_CONNECTION_REPLY_2 && ReadReply2(&clients[index], recvStruct))
+				{
+					clients[index].answered=true;
+					answeredCount++;
+				}
+			}
+			eventHandler->DeallocRNS2RecvStruct(recvStruct, _FILE_AND_LINE_);
+		}
+
+		// Requests the server dropped because its queue was full are sent again
+		SLNet::TimeMS timeMS=SLNet::GetTimeMS();
+		for (i=0; i < NUM_CLIENTS; i++)
+		{
+			if (clients[i].answered==false && timeMS-clients[i].lastSendTime > RESEND_MS)
+				SendRequest1(&clients[i], serverAddress);
+		}
+
+		Packet *packet;
+		for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+			;
+	}
+	SLNet::TimeUS elapsed=SLNet::GetTimeUS()-startTime;
+
+	// A ping sent while the network thread answered the last challenges is still part of the run
+	while (ping.inFlight && SLNet::GetTimeUS()-ping.sendTime < (SLNet::TimeUS) PING_TIMEOUT_MS*1000)
+	{
+		eventHandler->receivedEvent.WaitOnEvent(1);
+		while ((recvStruct=eventHandler->Pop())!=0)
+		{
+			if (recvStruct->socket->GetUserConnectionSocketIndex()==PING_SOCKET)
+				ReadPong(&ping, recvStruct);
+			eventHandler->DeallocRNS2RecvStruct(recvStruct, _FILE_AND_LINE_);
+		}
+	}
+
+	uint32_t serverAnsweredCount, failedCount, droppedCount;
+	unsigned int queueLength, maxQueueLength;
+	server->GetSecureHandshakeStatistics(&serverAnsweredCount, &failedCount, &droppedCount, &queueLength, &maxQueueLength);
+
+	double handshakesPerSecond=(double) answeredCount*1000000.0/(double) (elapsed>0 ? elapsed : 1);
+	printf("%7u %7u %12.0f %8u %8u %9u %11.2f %11.2f\n", run.threads, run.maxQueueLength, handshakesPerSecond,
+		serverAnsweredCount, droppedCount, maxQueueLength,
+		ping.count>0 ? (double) ping.totalRoundTrip/(double) ping.count/1000.0 : 0.0, (double) ping.maxRoundTrip/1000.0);
+
+	server->Shutdown(0);
+	RakPeerInterface::DestroyInstance(server);
+	return true;
+}
+#endif
+
+int SecureHandshakeBenchmark(void)
+{
+	printf("Secure handshake benchmark.\n");
+	printf("Sends secure connection requests to a server with 0 to 4 handshake threads, and prints answered handshakes per second and the ping time of the network thread.\n");
+	printf("\n");
+
+#if LIBCAT_SECURITY==1
+	cat::EasyHandshake handshake;
+	char publicKey[cat::EasyHandshake::PUBLIC_KEY_BYTES];
+	char privateKey[cat::EasyHandshake::PRIVATE_KEY_BYTES];
+	if (handshake.GenerateServerKey(publicKey, privateKey)==false)
+	{
+		printf("Failed to generate the server keys\n");
+		return 1;
+	}
+
+	QueueEventHandler eventHandler;
+	Client *clients=new Client[NUM_CLIENTS];
+	RNS2_Berkley *pingSocket=BindSocket(PING_SOCKET, &eventHandler);
+	bool bound=pingSocket!=0;
+	unsigned int i;
+	for (i=0; i < NUM_CLIENTS; i++)
+	{
+		clients[i].socket=BindSocket(i, &eventHandler);
+		if (clients[i].socket==0)
+			bound=false;
+	}
+
+	bool succeeded=bound;
+	if (bound)
+	{
+		printf("%u clients send their requests at once. 0 threads answers the challenges on the network thread.\n", NUM_CLIENTS);
+		printf("%7s %7s %12s %8s %8s %9s %11s %11s\n", "Threads", "Queue", "Handshakes/s", "Answered", "Dropped", "Max queue", "Avg ping ms", "Max ping ms");
+		for (i=0; i < sizeof(runs)/sizeof(runs[0]); i++)
+		{
+			if (RunHandshakes(runs[i], publicKey, privateKey, clients, pingSocket, &eventHandler)==false)
+			{
+				printf("Startup failed\n");
+				succeeded=false;
+				break;
+			}
+		}
+	}
+	else
+		printf("Failed to bind the client sockets\n");
+
+	for (i=0; i < NUM_CLIENTS; i++)
+	{
+		if (clients[i].socket)
+		{
+			clients[i].socket->BlockOnStopRecvPollingThread();
+			RakNetSocket2Allocator::DeallocRNS2(clients[i].socket);
+		}
+	}
+	if (pingSocket)
+	{
+		pingSocket->BlockOnStopRecvPollingThread();
+		RakNetSocket2Allocator::DeallocRNS2(pingSocket);
+	}
+	delete[] clients;
+	RNS2RecvStruct *recvStruct;
+	while ((recvStruct=eventHandler.Pop())!=0)
+		eventHandler.DeallocRNS2RecvStruct(recvStruct, _FILE_AND_LINE_);
+	return succeeded ? 0 : 1;
+#else
+	printf("Define LIBCAT_SECURITY 1 in NativeFeatureIncludesOverrides.h to run this benchmark\n");
+	return 0;
+#endif
+}
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures what it costs a server to send the same message to a list of subscribers, as CloudServer, RelayPlugin and ReadyEvent do.
+// Clients connect to a server over the loopback address. The server sends messages of 64 and 1024 bytes to every client,
+// once with one RakPeerInterface::Send() per client and once with one RakPeerInterface::SendToList() per message.
+// Times the calls on the sending thread, and the whole run until every client got every message.
+// SendToListTest in the Tests project checks that every client gets every message in order and unchanged.
+
+#include "Benchmarks.h"
+
+#include "slikenet/peerinterface.h"
+#include "slikenet/MessageIdentifiers.h"
+#include "slikenet/BitStream.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include <cstdio>
+
+using namespace SLNet;
+
+static const int NUM_CLIENTS=32;
+static const int messageSizes[]={64, 1024};
+static const unsigned int MESSAGES_PER_RUN=2000;
+// Messages sent that the slowest client did not receive yet
+static const unsigned int MAX_MESSAGES_IN_FLIGHT=200;
+static const SLNet::TimeMS TIMEOUT_MS=60000;
+
+static unsigned char PayloadByte(unsigned int messageIndex, int offset)
+{
+	return (unsigned char) (messageIndex*31+offset);
+}
+
+static void WriteMessage(BitStream *bs, unsigned int messageIndex, int messageSize)
+{
+	bs->Reset();
+	bs->Write((MessageID) ID_USER_PACKET_ENUM);
+	bs->Write(messageIndex);
+	for (int i=1+sizeof(messageIndex); i < messageSize; i++)
+		bs->Write(PayloadByte(messageIndex, i));
+}
+
+// Returns false if not every client got every message in time
+static bool RunFanOut(RakPeerInterface *server, RakPeerInterface **clients, int messageSize, bool useSendToList, double *sendMicroseconds, double *totalMilliseconds)
+{
+	AddressOrGUID targets[NUM_CLIENTS];
+	unsigned int receivedCounts[NUM_CLIENTS];
+	int i;
+	for (i=0; i < NUM_CLIENTS; i++)
+	{
+		targets[i]=clients[i]->GetMyGUID();
+		receivedCounts[i]=0;
+	}
+
+	BitStream bs;
+	unsigned int sentCount=0, slowestCount=0;
+	SLNet::TimeUS sendTime=0;
+	SLNet::TimeUS startTime=SLNet::GetTimeUS();
+	SLNet::TimeMS startTimeMS=SLNet::GetTimeMS();
+	while (slowestCount < MESSAGES_PER_RUN && SLNet::GetTimeMS()-startTimeMS < TIMEOUT_MS)
+	{
+		while (sentCount < MESSAGES_PER_RUN && sentCount-slowestCount < MAX_MESSAGES_IN_FLIGHT)
+		{
+			WriteMessage(&bs, sentCount, messageSize);
+			SLNet::TimeUS callStartTime=SLNet::GetTimeUS();
+			if (useSendToList)
+				server->SendToList(&bs, HIGH_PRIORITY, RELIABLE_ORDERED, 0, targets, NUM_CLIENTS);
+			else
+			{
+				for (i=0; i < NUM_CLIENTS; i++)
+					server->Send(&bs, HIGH_PRIORITY, RELIABLE_ORDERED, 0, targets[i], false);
+			}
+			sendTime+=SLNet::GetTimeUS()-callStartTime;
+			sentCount++;
+		}
+
+		Packet *packet;
+		slowestCount=MESSAGES_PER_RUN;
+		for (i=0; i < NUM_CLIENTS; i++)
+		{
+			for (packet=clients[i]->Receive(); packet; clients[i]->DeallocatePacket(packet), packet=clients[i]->Receive())
+			{
+				if (packet->data[0]==ID_USER_PACKET_ENUM)
+					receivedCounts[i]++;
+			}
+			if (receivedCounts[i] < slowestCount)
+				slowestCount=receivedCounts[i];
+		}
+		for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+			;
+		RakSleep(0);
+	}
+
+	*sendMicroseconds=(double) sendTime/MESSAGES_PER_RUN;
+	*totalMilliseconds=(double) (SLNet::GetTimeUS()-startTime)/1000.0;
+	return slowestCount==MESSAGES_PER_RUN;
+}
+
+int SendToListBenchmark(void)
+{
+	printf("SendToList benchmark.\n");
+	printf("Sends the same message from a server to %d clients over the loopback address, with one Send() per client and with one SendToList(), and prints the time per message.\n", NUM_CLIENTS);
+	printf("\n");
+
+	RakPeerInterface *server=RakPeerInterface::GetInstance();
+	SocketDescriptor socketDescriptor(0, "127.0.0.1");
+	if (server->Startup(NUM_CLIENTS, &socketDescriptor, 1)!=RAKNET_STARTED)
+	{
+		printf("Startup failed\n");
+		RakPeerInterface::DestroyInstance(server);
+		return 1;
+	}
+	server->SetMaximumIncomingConnections(NUM_CLIENTS);
+	unsigned short serverPort=server->GetMyBoundAddress().GetPort();
+
+	RakPeerInterface *clients[NUM_CLIENTS];
+	int i;
+	for (i=0; i < NUM_CLIENTS; i++)
+	{
+		clients[i]=RakPeerInterface::GetInstance();
+		SocketDescriptor clientSocketDescriptor(0, "127.0.0.1");
+		clients[i]->Startup(1, &clientSocketDescriptor, 1);
+		clients[i]->Connect("127.0.0.1", serverPort, 0, 0);
+	}
+
+	int connectedCount=0;
+	SLNet::TimeMS startTime=SLNet::GetTimeMS();
+	while (connectedCount < NUM_CLIENTS && SLNet::GetTimeMS()-startTime < TIMEOUT_MS)
+	{
+		Packet *packet;
+		for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+		{
+			if (packet->data[0]==ID_NEW_INCOMING_CONNECTION)
+				connectedCount++;
+		}
+		for (i=0; i < NUM_CLIENTS; i++)
+		{
+			for (packet=clients[i]->Receive(); packet; clients[i]->DeallocatePacket(packet), packet=clients[i]->Receive())
+				;
+		}
+		RakSleep(1);
+	}
+
+	bool completed=connectedCount==NUM_CLIENTS;
+	if (completed)
+	{
+		printf("%8s %14s %14s %14s %14s\n", "Message", "Send() us", "SendToList us", "Send() ms", "SendToList ms");
+		for (unsigned int j=0; j < sizeof(messageSizes)/sizeof(messageSizes[0]); j++)
+		{
+			double sendCall, sendTotal, listCall, listTotal;
+			if (RunFanOut(server, clients, messageSizes[j], false, &sendCall, &sendTotal)==false ||
+				RunFanOut(server, clients, messageSizes[j], true, &listCall, &listTotal)==false)
+			{
+				printf("Clients did not get every message in time\n");
+				completed=false;
+				break;
+			}
+			printf("%8i %14.2f %14.2f %14.1f %14.1f\n", messageSizes[j], sendCall, listCall, sendTotal, listTotal);
+		}
+		printf("\nThe us columns are the time per message on the sending thread, and the ms columns the time until every client got all %u messages\n", MESSAGES_PER_RUN);
+	}
+	else
+		printf("Only %d of %d clients connected\n", connectedCount, NUM_CLIENTS);
+
+	for (i=0; i < NUM_CLIENTS; i++)
+	{
+		clients[i]->Shutdown(0);
+		RakPeerInterface::DestroyInstance(clients[i]);
+	}
+	server->Shutdown(0);
+	RakPeerInterface::DestroyInstance(server);
+	return completed ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures raw UDP throughput of RakNetSocket2 over loopback, without RakPeer.
+// Sends the same number of datagrams once with one Send() per datagram, and once with SendBatch().
+// On Linux, SendBatch() uses sendmmsg() and the receive thread uses recvmmsg(), unless RAKNET_SOCKET_BATCH_SIZE is defined as 1.
+// To compare receive throughput, build once with the default and once with RAKNET_SOCKET_BATCH_SIZE defined as 1.
+
+#include "Benchmarks.h"
+
+#include "slikenet/socket2.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/sleep.h"
+#include "slikenet/memoryoverride.h"
+#include "slikenet/SocketIncludes.h"
+#include <cstdio>
+#include <ctime>
+#include <string.h>
+
+using namespace SLNet;
+
+static const unsigned short RECEIVER_PORT=60100;
+static const unsigned short SENDER_PORT=60101;
+static const unsigned int DATAGRAMS_PER_RUN=500000;
+static const int DATAGRAM_SIZE=512;
+
+class CountingEventHandler : public RNS2EventHandler
+{
+public:
+	CountingEventHandler() {}
+	virtual void OnRNS2Recv(RNS2RecvStruct *recvStruct)
+	{
+		numReceived.Increment();
+		DeallocRNS2RecvStruct(recvStruct, _FILE_AND_LINE_);
+	}
+	virtual void DeallocRNS2RecvStruct(RNS2RecvStruct *s, const char *file, unsigned int line)
+	{
+		pool.Push(s, file, line);
+	}
+	virtual RNS2RecvStruct *AllocRNS2RecvStruct(const char *file, unsigned int line)
+	{
+		RNS2RecvStruct *s=pool.Pop();
+		if (s==0)
+			s=SLNet::OP_NEW<RNS2RecvStruct>(file, line);
+		return s;
+	}
+	void Clear(void)
+	{
+		RNS2RecvStruct *s;
+		while ((s=pool.Pop())!=0)
+			SLNet::OP_DELETE(s, _FILE_AND_LINE_);
+	}
+
+	SLNet::LocklessUint32_t numReceived;
+	// Recycles structs between the receive thread and OnRNS2Recv
+	struct Pool
+	{
+		RNS2RecvStruct *Pop(void) {RNS2RecvStruct *s=0; mutex.Lock(); if (queue.Size()) s=queue.Pop(); mutex.Unlock(); return s;}
+		void Push(RNS2RecvStruct *s, const char *file, unsigned int line) {mutex.Lock(); queue.Push(s, file, line); mutex.Unlock();}
+		DataStructures::Queue<RNS2RecvStruct*> queue;
+		SimpleMutex mutex;
+	} pool;
+};
+
+static RNS2_Berkley *BindSocket(unsigned short port, RNS2EventHandler *eventHandler)
+{
+	RNS2_BerkleyBindParameters bbp;
+	bbp.port=port;
+	bbp.hostAddress=(char*) "127.0.0.1";
+	bbp.addressFamily=AF_INET;
+	bbp.type=SOCK_DGRAM;
+	bbp.protocol=0;
+	bbp.nonBlockingSocket=false;
+	bbp.setBroadcast=false;
+	bbp.setIPHdrIncl=false;
+	bbp.doNotFragment=false;
+	bbp.pollingThreadPriority=0;
+	bbp.eventHandler=eventHandler;
+	bbp.remotePortRakNetWasStartedOn_PS3_PS4_PSP2=0;
+	bbp.reusePort=false;
+	RNS2_Berkley *s=(RNS2_Berkley*) RakNetSocket2Allocator::AllocRNS2();
+	if (s->Bind(&bbp, _FILE_AND_LINE_)!=BR_SUCCESS)
+	{
+		RakNetSocket2Allocator::DeallocRNS2(s);
+		return 0;
+	}
+	return s;
+}
+
+// Process CPU time in seconds, summed over all threads
+static double GetCPUSeconds(void)
+{
+	return (double) clock() / (double) CLOCKS_PER_SEC;
+}
+
+static void RunTest(const char *name, bool useSendBatch, RakNetSocket2 *sender, SystemAddress receiverAddress, CountingEventHandler *eventHandler)
+{
+	static char data[RAKNET_SOCKET_BATCH_SIZE][DATAGRAM_SIZE];
+	RNS2_SendParameters sendParameters[RAKNET_SOCKET_BATCH_SIZE];
+	for (unsigned int i=0; i < RAKNET_SOCKET_BATCH_SIZE; i++)
+	{
+		memset(data[i], (int) i, DATAGRAM_SIZE);
+		sendParameters[i].data=data[i];
+		sendParameters[i].length=DATAGRAM_SIZE;
+		sendParameters[i].systemAddress=receiverAddress;
+	}
+
+	uint32_t receivedBefore=eventHandler->numReceived.GetValue();
+	SLNet::TimeUS startTime=SLNet::GetTimeUS();
+	double startCPU=GetCPUSeconds();
+
+	for (unsigned int numSent=0; numSent < DATAGRAMS_PER_RUN; numSent+=RAKNET_SOCKET_BATCH_SIZE)
+	{
+		if (useSendBatch)
+			sender->SendBatch(sendParameters, RAKNET_SOCKET_BATCH_SIZE, _FILE_AND_LINE_);
+		else
+		{
+			for (unsigned int i=0; i < RAKNET_SOCKET_BATCH_SIZE; i++)
+				sender->Send(&sendParameters[i], _FILE_AND_LINE_);
+		}
+	}
+
+	// Let the receive thread drain the socket buffer
+	uint32_t received=eventHandler->numReceived.GetValue();
+	do
+	{
+		RakSleep(50);
+		uint32_t receivedNow=eventHandler->numReceived.GetValue();
+		if (receivedNow==received)
+			break;
+		received=receivedNow;
+	} while (1);
+	received-=receivedBefore;
+
+	double seconds=(double) (SLNet::GetTimeUS()-startTime) / 1000000.0;
+	double cpuSeconds=GetCPUSeconds()-startCPU;
+	if (cpuSeconds<=0.0)
+		cpuSeconds=1.0/(double) CLOCKS_PER_SEC;
+	printf("%-12s sent %u, received %u in %.2f s. %.0f packets/s, %.0f packets/s per core\n",
+		name, DATAGRAMS_PER_RUN, received, seconds, (double) received/seconds, (double) received/cpuSeconds);
+}
+
+int SocketBatchBenchmark(void)
+{
+	printf("Socket batch benchmark.\n");
+	printf("Measures RakNetSocket2 send and receive throughput over loopback with and without batched system calls.\n");
+	printf("Batch size: %i datagrams of %i bytes.\n", RAKNET_SOCKET_BATCH_SIZE, DATAGRAM_SIZE);
+	printf("\n");
+
+	CountingEventHandler eventHandler;
+	RNS2_Berkley *receiver=BindSocket(RECEIVER_PORT, &eventHandler);
+	RNS2_Berkley *sender=BindSocket(SENDER_PORT, &eventHandler);
+	if (receiver==0 || sender==0)
+	{
+		printf("Failed to bind sockets. Ports %i and %i must be free.\n", RECEIVER_PORT, SENDER_PORT);
+		return 1;
+	}
+	if (receiver->CreateRecvPollingThread(0)!=0)
+	{
+		printf("Failed to start the receive thread.\n");
+		return 1;
+	}
+	// Wait for the receive thread to start, and for the test sends done by Bind()
+	RakSleep(100);
+
+	RunTest("Send()", false, sender, receiver->GetBoundAddress(), &eventHandler);
+	RunTest("SendBatch()", true, sender, receiver->GetBoundAddress(), &eventHandler);
+
+	receiver->BlockOnStopRecvPollingThread();
+	RakNetSocket2Allocator::DeallocRNS2(receiver);
+	RakNetSocket2Allocator::DeallocRNS2(sender);
+	eventHandler.Clear();
+	return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures how many characters per second StringCompressor encodes and decodes with its default English tree,
+// and how many bytes per second DataCompressor compresses and decompresses, which builds a tree for each call.
+// SerializationTest in the Tests project checks that every string and buffer comes back unchanged.
+
+#include "Benchmarks.h"
+
+#include "slikenet/StringCompressor.h"
+#include "slikenet/DataCompressor.h"
+#include "slikenet/BitStream.h"
+#include "slikenet/GetTime.h"
+#include <cstdio>
+#include <string.h>
+
+using namespace SLNet;
+
+static const int STRING_ITERATIONS=200000;
+static const int DATA_ITERATIONS=200;
+static const int DATA_SIZE=64*1024;
+
+// Typical chat, lobby and RPC strings
+static const char *strings[]=
+{
+	"gg",
+	"Anyone up for another round?",
+	"PlayerName_0042",
+	"Lobby/Europe/West/Ranked",
+	"The quick brown fox jumps over the lazy dog, then waits at the respawn point for 10 seconds.",
+	"SetPlayerLoadout(weapon=\"rifle\", ammo=120, grenades=2)",
+};
+
+int StringCompressorBenchmark(void)
+{
+	printf("StringCompressor benchmark.\n");
+	printf("Encodes and decodes strings with StringCompressor, and buffers with DataCompressor, and prints millions of characters per second.\n");
+	printf("\n");
+
+	StringCompressor::AddReference();
+	StringCompressor *stringCompressor=StringCompressor::Instance();
+	const int numStrings=sizeof(strings)/sizeof(strings[0]);
+
+	BitStream bitStream;
+	size_t characters=0;
+	SLNet::TimeUS startTime=SLNet::GetTimeUS();
+	for (int i=0; i < STRING_ITERATIONS; i++)
+	{
+		bitStream.Reset();
+		for (int j=0; j < numStrings; j++)
+		{
+			stringCompressor->EncodeString(strings[j], 256, &bitStream);
+			characters+=strlen(strings[j]);
+		}
+	}
+	SLNet::TimeUS encodeTime=SLNet::GetTimeUS()-startTime;
+
+	char output[256];
+	startTime=SLNet::GetTimeUS();
+	for (int i=0; i < STRING_ITERATIONS; i++)
+	{
+		bitStream.ResetReadPointer();
+		for (int j=0; j < numStrings; j++)
+			stringCompressor->DecodeString(output, 256, &bitStream);
+	}
+	SLNet::TimeUS decodeTime=SLNet::GetTimeUS()-startTime;
+
+	printf("StringCompressor: %.1f bits per character\n", (double) bitStream.GetNumberOfBitsUsed()*STRING_ITERATIONS/characters);
+	printf("%-22s %10.2f Mchars/s\n", "EncodeString", (double) characters/encodeTime);
+	printf("%-22s %10.2f Mchars/s\n", "DecodeString", (double) characters/decodeTime);
+
+	// Text with some binary data mixed in
+	unsigned char *data=new unsigned char[DATA_SIZE];
+	unsigned int seed=42;
+	for (int i=0; i < DATA_SIZE; i++)
+	{
+		seed=seed*1103515245+12345;
+		if ((seed>>16)%8==0)
+			data[i]=(unsigned char) (seed>>8);
+		else
+			data[i]=(unsigned char) strings[4][i%strlen(strings[4])];
+	}
+
+	BitStream compressed;
+	startTime=SLNet::GetTimeUS();
+	for (int i=0; i < DATA_ITERATIONS; i++)
+	{
+		compressed.Reset();
+		DataCompressor::Compress(data, DATA_SIZE, &compressed);
+	}
+	SLNet::TimeUS compressTime=SLNet::GetTimeUS()-startTime;
+
+	startTime=SLNet::GetTimeUS();
+	for (int i=0; i < DATA_ITERATIONS; i++)
+	{
+		compressed.ResetReadPointer();
+		unsigned char *decompressed;
+		DataCompressor::DecompressAndAllocate(&compressed, &decompressed);
+		rakFree_Ex(decompressed, _FILE_AND_LINE_);
+	}
+	SLNet::TimeUS decompressTime=SLNet::GetTimeUS()-startTime;
+	delete [] data;
+
+	printf("\nDataCompressor: %i bytes to %i bytes\n", DATA_SIZE, (int) BITS_TO_BYTES(compressed.GetNumberOfBitsUsed()));
+	printf("%-22s %10.2f MB/s\n", "Compress", (double) DATA_SIZE*DATA_ITERATIONS/compressTime);
+	printf("%-22s %10.2f MB/s\n", "DecompressAndAllocate", (double) DATA_SIZE*DATA_ITERATIONS/decompressTime);
+
+	StringCompressor::RemoveReference();
+	return 0;
+}
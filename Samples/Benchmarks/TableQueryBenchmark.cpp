@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+// Measures DataStructures::Table::QueryTable() on a table of rooms, as a room browser queries it for each client request.
+// Runs each filter mix on the same rows without and with Table::AddIndex() on the filtered columns.
+// TableIndexTest in the Tests project checks that both return the same rows.
+// Also measures UpdateCell() with indices, and a query after each update, as when the player count of a room changes.
+
+#include "Benchmarks.h"
+
+#include "slikenet/DS_Table.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/linux_adapter.h"
+#include "slikenet/osx_adapter.h"
+#include <cstdio>
+
+using namespace DataStructures;
+
+static const unsigned NUM_ROWS=100000;
+static const int QUERY_ITERATIONS=50;
+static const int NUM_UPDATES=20000;
+
+static const char *gameModes[]={"Deathmatch", "Team deathmatch", "Capture the flag", "King of the hill", "Domination", "Search and destroy", "Free for all", "Co-op"};
+static const char *regions[]={"Europe", "North America", "South America", "Asia", "Oceania", "Africa"};
+
+enum Columns
+{
+	COLUMN_GAME_MODE,
+	COLUMN_MAP,
+	COLUMN_REGION,
+	COLUMN_PLAYERS,
+	COLUMN_MAX_PLAYERS,
+	COLUMN_SKILL,
+	COLUMN_PING
+};
+
+struct FilterMix
+{
+	const char *name;
+	int numFilters;
+	Table::FilterQuery filters[4];
+	Table::Cell values[4];
+};
+
+static unsigned int seed=42;
+static unsigned int Random(unsigned int range)
+{
+	seed=seed*1103515245+12345;
+	return (seed>>8)%range;
+}
+
+static void AddFilter(FilterMix *mix, unsigned columnIndex, Table::FilterQueryType operation, int numericValue, const char *stringValue)
+{
+	if (stringValue)
+		mix->values[mix->numFilters].Set(stringValue);
+	else
+		mix->values[mix->numFilters].Set(numericValue);
+	mix->filters[mix->numFilters].columnIndex=columnIndex;
+	mix->filters[mix->numFilters].operation=operation;
+	mix->filters[mix->numFilters].cellValue=&mix->values[mix->numFilters];
+	mix->numFilters++;
+}
+
+// Returns microseconds per query
+static double RunQuery(Table &table, FilterMix &mix, Table &result)
+{
+	SLNet::TimeUS startTime=SLNet::GetTimeUS();
+	for (int i=0; i < QUERY_ITERATIONS; i++)
+		table.QueryTable(0, 0, mix.filters, mix.numFilters, 0, 0, &result);
+	return (double) (SLNet::GetTimeUS()-startTime)/QUERY_ITERATIONS;
+}
+
+int TableQueryBenchmark(void)
+{
+	printf("Table query benchmark.\n");
+	printf("Queries a table of %u rooms with common room browser filters, without and with indices, and prints microseconds per query.\n", NUM_ROWS);
+	printf("\n");
+
+	Table table;
+	table.AddColumn("Game mode", Table::STRING);
+	table.AddColumn("Map", Table::STRING);
+	table.AddColumn("Region", Table::STRING);
+	table.AddColumn("Players", Table::NUMERIC);
+	table.AddColumn("Max players", Table::NUMERIC);
+	table.AddColumn("Skill", Table::NUMERIC);
+	table.AddColumn("Ping", Table::NUMERIC);
+
+	char mapName[32];
+	for (unsigned rowId=0; rowId < NUM_ROWS; rowId++)
+	{
+		Table::Row *row=table.AddRow(rowId);
+		row->UpdateCell(COLUMN_GAME_MODE, gameModes[Random(sizeof(gameModes)/sizeof(gameModes[0]))]);
+		sprintf_s(mapName, "Map_%02u", Random(50));
+		row->UpdateCell(COLUMN_MAP, mapName);
+		row->UpdateCell(COLUMN_REGION, regions[Random(sizeof(regions)/sizeof(regions[0]))]);
+		double maxPlayers=(double) (4+4*Random(4));
+		row->UpdateCell(COLUMN_MAX_PLAYERS, maxPlayers);
+		row->UpdateCell(COLUMN_PLAYERS, (double) Random((unsigned) maxPlayers+1));
+		row->UpdateCell(COLUMN_SKILL, (double) Random(3000));
+		row->UpdateCell(COLUMN_PING, (double) (10+Random(300)));
+	}
+
+	FilterMix mixes[6];
+	for (int i=0; i < 6; i++)
+		mixes[i].numFilters=0;
+	mixes[0].name="Game mode";
+	AddFilter(&mixes[0], COLUMN_GAME_MODE, Table::QF_EQUAL, 0, "Capture the flag");
+	mixes[1].name="Map and region";
+	AddFilter(&mixes[1], COLUMN_MAP, Table::QF_EQUAL, 0, "Map_07");
+	AddFilter(&mixes[1], COLUMN_REGION, Table::QF_EQUAL, 0, "Europe");
+	mixes[2].name="Skill range";
+	AddFilter(&mixes[2], COLUMN_SKILL, Table::QF_GREATER_THAN_EQ, 1400, 0);
+	AddFilter(&mixes[2], COLUMN_SKILL, Table::QF_LESS_THAN_EQ, 1600, 0);
+	mixes[3].name="Mode, skill, ping";
+	AddFilter(&mixes[3], COLUMN_GAME_MODE, Table::QF_EQUAL, 0, "Domination");
+	AddFilter(&mixes[3], COLUMN_SKILL, Table::QF_GREATER_THAN, 1000, 0);
+	AddFilter(&mixes[3], COLUMN_SKILL, Table::QF_LESS_THAN, 2000, 0);
+	AddFilter(&mixes[3], COLUMN_PING, Table::QF_LESS_THAN, 100, 0);
+	mixes[4].name="Not empty, ping";
+	AddFilter(&mixes[4], COLUMN_PLAYERS, Table::QF_GREATER_THAN_EQ, 1, 0);
+	AddFilter(&mixes[4], COLUMN_PING, Table::QF_LESS_THAN, 250, 0);
+	mixes[5].name="Exact players";
+	AddFilter(&mixes[5], COLUMN_PLAYERS, Table::QF_EQUAL, 16, 0);
+	AddFilter(&mixes[5], COLUMN_MAX_PLAYERS, Table::QF_EQUAL, 16, 0);
+
+	// Same rows, never indexed
+	Table unindexed;
+	unindexed=table;
+
+	SLNet::TimeUS startTime=SLNet::GetTimeUS();
+	table.AddIndex(COLUMN_GAME_MODE);
+	table.AddIndex(COLUMN_MAP);
+	table.AddIndex(COLUMN_REGION);
+	table.AddIndex(COLUMN_PLAYERS);
+	table.AddIndex(COLUMN_MAX_PLAYERS);
+	table.AddIndex(COLUMN_SKILL);
+	table.AddIndex(COLUMN_PING);
+	printf("Indexing 7 columns took %.1f ms\n\n", (double) (SLNet::GetTimeUS()-startTime)/1000.0);
+
+	Table resultWithout, resultWith;
+	printf("%-20s %8s %12s %12s %8s\n", "Filters", "Rows", "Scan us", "Indexed us", "Speedup");
+	for (int i=0; i < 6; i++)
+	{
+		double withoutIndices=RunQuery(unindexed, mixes[i], resultWithout);
+		double withIndices=RunQuery(table, mixes[i], resultWith);
+		printf("%-20s %8u %12.0f %12.0f %7.1fx\n", mixes[i].name, resultWith.GetRowCount(), withoutIndices, withIndices, withoutIndices/withIndices);
+	}
+
+	// Rooms fill and empty while clients browse
+	unsigned rowIds[NUM_UPDATES];
+	int players[NUM_UPDATES];
+	for (int i=0; i < NUM_UPDATES; i++)
+	{
+		rowIds[i]=Random(NUM_ROWS);
+		players[i]=(int) Random(17);
+	}
+	startTime=SLNet::GetTimeUS();
+	for (int i=0; i < NUM_UPDATES; i++)
+		table.UpdateCell(rowIds[i], COLUMN_PLAYERS, players[i]);
+	SLNet::TimeUS updateTime=SLNet::GetTimeUS()-startTime;
+	printf("\nUpdateCell() with indices: %.2f us\n", (double) updateTime/NUM_UPDATES);
+
+	startTime=SLNet::GetTimeUS();
+	for (int i=0; i < QUERY_ITERATIONS; i++)
+	{
+		table.UpdateCell(rowIds[i], COLUMN_PLAYERS, players[NUM_UPDATES-1-i]);
+		table.QueryTable(0, 0, mixes[5].filters, mixes[5].numFilters, 0, 0, &resultWith);
+	}
+	printf("UpdateCell() then query \"%s\": %.0f us\n", mixes[5].name, (double) (SLNet::GetTimeUS()-startTime)/QUERY_ITERATIONS);
+	return 0;
+}
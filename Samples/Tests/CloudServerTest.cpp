@@ -0,0 +1,354 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "CloudServerTest.h"
+
+#include <string.h>
+
+/*
+Description:
+Tests that CloudServer keeps the rows of many keys apart, as a presence service holds them.
+An uploader posts thousands of keys under a few primary keys. A subscriber gets a sample of them, subscribes to them, and is notified when the uploader posts them again.
+Then the uploader releases some keys and disconnects, which releases the rest.
+
+Success conditions:
+Gets return one row per key with the data posted last.
+Every subscribed key notifies the subscriber of the new data, and of its release.
+Released keys, and the keys of the uploader that disconnected, return no rows.
+
+Failure conditions:
+The clients do not connect.
+A get returns no row, several rows or old data for a key.
+A notification is missing or has the wrong data.
+A released key still returns a row.
+
+*/
+
+static const unsigned int NUM_KEYS=5000;
+static const unsigned int NUM_PRIMARY_KEYS=16;
+static const unsigned int CHECK_KEYS=100;
+static const RakNet::TimeMS TIMEOUT_MS=10000;
+
+// The data of a key is its index and how often it was posted
+struct KeyData
+{
+	unsigned int keyIndex;
+	unsigned int version;
+};
+
+struct GetResult
+{
+	unsigned int keyIndex;
+	unsigned int rowCount;
+	KeyData data;
+};
+
+class RecordingCloudClientCallback : public CloudClientCallback
+{
+public:
+	virtual void OnGet(CloudQueryResult *result, bool *deallocateRowsAfterReturn)
+	{
+		(void) deallocateRowsAfterReturn;
+		GetResult getResult;
+		getResult.keyIndex=result->cloudQuery.keys.Size()==1 ? result->cloudQuery.keys[0].secondaryKey : (unsigned int) -1;
+		getResult.rowCount=result->rowsReturned.Size();
+		memset(&getResult.data, 0, sizeof(getResult.data));
+		if (getResult.rowCount>0 && result->rowsReturned[0]->length==sizeof(KeyData))
+			memcpy(&getResult.data, result->rowsReturned[0]->data, sizeof(KeyData));
+		getResults.Push(getResult, _FILE_AND_LINE_);
+	}
+	virtual void OnSubscriptionNotification(CloudQueryRow *result, bool wasUpdated, bool *deallocateRowAfterReturn)
+	{
+		(void) deallocateRowAfterReturn;
+		GetResult notification;
+		notification.keyIndex=result->key.secondaryKey;
+		notification.rowCount=wasUpdated ? 1 : 0;
+		memset(&notification.data, 0, sizeof(notification.data));
+		if (wasUpdated && result->length==sizeof(KeyData))
+			memcpy(&notification.data, result->data, sizeof(KeyData));
+		notifications.Push(notification, _FILE_AND_LINE_);
+	}
+
+	DataStructures::List<GetResult> getResults;
+	DataStructures::List<GetResult> notifications;
+};
+
+static CloudKey GetKey(unsigned int keyIndex)
+{
+	return CloudKey(RakString("presence/region%u", keyIndex%NUM_PRIMARY_KEYS), keyIndex);
+}
+
+// Calls Receive() on the server and both clients, and passes responses to the CloudClient of the client
+static void ReceiveAll(RakPeerInterface **peers, CloudClient **cloudClients)
+{
+	for (int i=0; i < 3; i++)
+	{
+		for (Packet *packet=peers[i]->Receive(); packet; peers[i]->DeallocatePacket(packet), packet=peers[i]->Receive())
+		{
+			if (i==0)
+				continue;
+			if (packet->data[0]==ID_CLOUD_GET_RESPONSE)
+				cloudClients[i-1]->OnGetReponse(packet);
+			else if (packet->data[0]==ID_CLOUD_SUBSCRIPTION_NOTIFICATION)
+				cloudClients[i-1]->OnSubscriptionNotification(packet);
+		}
+	}
+}
+
+// Receives until the callback has \a count results in \a list
+static bool WaitForResults(RakPeerInterface **peers, CloudClient **cloudClients, DataStructures::List<GetResult> &list, unsigned int count)
+{
+	RakNet::TimeMS startTime=RakNet::GetTimeMS();
+	while (list.Size() < count && RakNet::GetTimeMS()-startTime < TIMEOUT_MS)
+	{
+		ReceiveAll(peers, cloudClients);
+		RakSleep(1);
+	}
+	return list.Size()==count;
+}
+
+// The subscriber gets each key in \a keyIndices, and returns true if each returned one row with the version in \a versions, or none if that version is 0 or \a versions is 0
+static bool CheckGets(RakPeerInterface **peers, CloudClient **cloudClients, RecordingCloudClientCallback *callback, RakNetGUID serverGuid, const unsigned int *keyIndices, const unsigned int *versions, bool subscribe)
+{
+	callback->getResults.Clear(false, _FILE_AND_LINE_);
+	unsigned int i;
+	for (i=0; i < CHECK_KEYS; i++)
+	{
+		CloudQuery query;
+		query.keys.Push(GetKey(keyIndices[i]), _FILE_AND_LINE_);
+		query.subscribeToResults=subscribe;
+		cloudClients[1]->Get(&query, serverGuid);
+	}
+	if (WaitForResults(peers, cloudClients, callback->getResults, CHECK_KEYS)==false)
+		return false;
+	for (i=0; i < CHECK_KEYS; i++)
+	{
+		const GetResult &getResult=callback->getResults[i];
+		if (getResult.keyIndex!=keyIndices[i])
+			return false;
+		unsigned int version=versions ? versions[keyIndices[i]] : 0;
+		if (version==0)
+		{
+			if (getResult.rowCount!=0)
+				return false;
+		}
+		else if (getResult.rowCount!=1 || getResult.data.keyIndex!=keyIndices[i] || getResult.data.version!=version)
+			return false;
+	}
+	return true;
+}
+
+// Messages of different clients are not ordered with each other, so the uploader gets the key it posted last to know the server has all its posts
+static bool WaitForPosts(RakPeerInterface **peers, CloudClient **cloudClients, RecordingCloudClientCallback *uploaderCallback, RakNetGUID serverGuid, unsigned int lastKeyIndex)
+{
+	uploaderCallback->getResults.Clear(false, _FILE_AND_LINE_);
+	CloudQuery query;
+	query.keys.Push(GetKey(lastKeyIndex), _FILE_AND_LINE_);
+	cloudClients[0]->Get(&query, serverGuid);
+	return WaitForResults(peers, cloudClients, uploaderCallback->getResults, 1) && uploaderCallback->getResults[0].rowCount==1;
+}
+
+static void Post(CloudClient *cloudClient, RakNetGUID serverGuid, unsigned int keyIndex, unsigned int *versions)
+{
+	CloudKey key=GetKey(keyIndex);
+	KeyData data;
+	data.keyIndex=keyIndex;
+	data.version=++versions[keyIndex];
+	cloudClient->Post(&key, (const unsigned char*) &data, sizeof(data), serverGuid);
+}
+
+int CloudServerTest::RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses)
+{
+	(void) params;
+
+	// Server, uploader, subscriber
+	RakPeerInterface *peers[3];
+	CloudClient *cloudClients[2];
+	RecordingCloudClientCallback callbacks[2];
+	CloudAllocator allocator;
+	int i;
+	for (i=0; i < 3; i++)
+	{
+		peers[i]=RakPeerInterface::GetInstance();
+		destroyList.Push(peers[i],_FILE_AND_LINE_);
+		SocketDescriptor socketDescriptor(0, "127.0.0.1");
+		peers[i]->Startup(2, &socketDescriptor, 1);
+	}
+	CloudServer *cloudServer=CloudServer::GetInstance();
+	pluginList.Push(cloudServer,_FILE_AND_LINE_);
+	peers[0]->AttachPlugin(cloudServer);
+	peers[0]->SetMaximumIncomingConnections(2);
+	for (i=0; i < 2; i++)
+	{
+		cloudClients[i]=CloudClient::GetInstance();
+		pluginList.Push(cloudClients[i],_FILE_AND_LINE_);
+		cloudClients[i]->SetDefaultCallbacks(&allocator, &callbacks[i]);
+		peers[i+1]->AttachPlugin(cloudClients[i]);
+		peers[i+1]->Connect("127.0.0.1", peers[0]->GetMyBoundAddress().GetPort(), 0, 0);
+	}
+
+	RakNet::TimeMS startTime=RakNet::GetTimeMS();
+	while (peers[0]->NumberOfConnections()<2 && RakNet::GetTimeMS()-startTime < TIMEOUT_MS)
+	{
+		ReceiveAll(peers, cloudClients);
+		RakSleep(10);
+	}
+	if (peers[0]->NumberOfConnections()!=2)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[1-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 1;
+	}
+	RakNetGUID serverGuid=peers[0]->GetMyGUID();
+
+	if (isVerbose)
+		printf("Posting %u keys and getting them\n", NUM_KEYS);
+	unsigned int *versions=new unsigned int[NUM_KEYS];
+	unsigned int j;
+	for (j=0; j < NUM_KEYS; j++)
+	{
+		versions[j]=0;
+		Post(cloudClients[0], serverGuid, j, versions);
+	}
+	// Posted twice, so a get has to return the second post
+	for (j=0; j < NUM_KEYS; j+=3)
+		Post(cloudClients[0], serverGuid, j, versions);
+	unsigned int checkKeys[CHECK_KEYS];
+	for (j=0; j < CHECK_KEYS; j++)
+		checkKeys[j]=j*(NUM_KEYS/CHECK_KEYS)+j%(NUM_KEYS/CHECK_KEYS);
+	if (WaitForPosts(peers, cloudClients, &callbacks[0], serverGuid, NUM_KEYS-1)==false ||
+		CheckGets(peers, cloudClients, &callbacks[1], serverGuid, checkKeys, versions, false)==false)
+	{
+		delete [] versions;
+		if (isVerbose)
+			DebugTools::ShowError(errorList[2-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 2;
+	}
+
+	if (isVerbose)
+		printf("Subscribing and posting again\n");
+	if (CheckGets(peers, cloudClients, &callbacks[1], serverGuid, checkKeys, versions, true)==false)
+	{
+		delete [] versions;
+		if (isVerbose)
+			DebugTools::ShowError(errorList[2-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 2;
+	}
+	for (j=0; j < CHECK_KEYS; j++)
+		Post(cloudClients[0], serverGuid, checkKeys[j], versions);
+	bool notified=WaitForResults(peers, cloudClients, callbacks[1].notifications, CHECK_KEYS);
+	for (j=0; j < CHECK_KEYS && notified; j++)
+	{
+		const GetResult &notification=callbacks[1].notifications[j];
+		if (notification.keyIndex!=checkKeys[j] || notification.rowCount!=1 || notification.data.keyIndex!=checkKeys[j] || notification.data.version!=versions[checkKeys[j]])
+			notified=false;
+	}
+	if (notified==false)
+	{
+		delete [] versions;
+		if (isVerbose)
+			DebugTools::ShowError(errorList[3-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 3;
+	}
+
+	if (isVerbose)
+		printf("Releasing keys\n");
+	// The first half of the checked keys, then every key of the uploader when it disconnects
+	DataStructures::List<CloudKey> releasedKeys;
+	for (j=0; j < CHECK_KEYS/2; j++)
+		releasedKeys.Push(GetKey(checkKeys[j]), _FILE_AND_LINE_);
+	cloudClients[0]->Release(releasedKeys, serverGuid);
+	callbacks[1].notifications.Clear(false, _FILE_AND_LINE_);
+	notified=WaitForResults(peers, cloudClients, callbacks[1].notifications, CHECK_KEYS/2);
+	for (j=0; j < CHECK_KEYS/2 && notified; j++)
+	{
+		if (callbacks[1].notifications[j].keyIndex!=checkKeys[j] || callbacks[1].notifications[j].rowCount!=0)
+			notified=false;
+	}
+	if (notified==false)
+	{
+		delete [] versions;
+		if (isVerbose)
+			DebugTools::ShowError(errorList[3-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 3;
+	}
+	// Released keys return no rows, the others still return theirs
+	for (j=0; j < CHECK_KEYS/2; j++)
+		versions[checkKeys[j]]=0;
+	bool released=CheckGets(peers, cloudClients, &callbacks[1], serverGuid, checkKeys, versions, false);
+
+	// The server released the keys of the uploader once it notified the subscriber of the other half
+	callbacks[1].notifications.Clear(false, _FILE_AND_LINE_);
+	peers[1]->CloseConnection(serverGuid, true);
+	if (released && WaitForResults(peers, cloudClients, callbacks[1].notifications, CHECK_KEYS-CHECK_KEYS/2)==false)
+		released=false;
+	if (released && CheckGets(peers, cloudClients, &callbacks[1], serverGuid, checkKeys, 0, false)==false)
+		released=false;
+	delete [] versions;
+	if (released==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[4-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 4;
+	}
+
+	return 0;
+}
+
+RakString CloudServerTest::GetTestName()
+{
+
+	return "CloudServerTest";
+
+}
+
+RakString CloudServerTest::ErrorCodeToString(int errorCode)
+{
+
+	if (errorCode>0&&(unsigned int)errorCode<=errorList.Size())
+	{
+		return errorList[errorCode-1];
+	}
+	else
+	{
+		return "Undefined Error";
+	}
+
+}
+
+void CloudServerTest::DestroyPeers()
+{
+
+	int theSize=destroyList.Size();
+
+	for (int i=0; i < theSize; i++)
+		RakPeerInterface::DestroyInstance(destroyList[i]);
+
+	destroyList.Clear(false,_FILE_AND_LINE_);
+
+	theSize=pluginList.Size();
+
+	for (int i=0; i < theSize; i++)
+		delete pluginList[i];
+
+	pluginList.Clear(false,_FILE_AND_LINE_);
+
+}
+
+CloudServerTest::CloudServerTest(void)
+{
+
+	errorList.Push("Clients did not connect to the server",_FILE_AND_LINE_);
+	errorList.Push("A get did not return the data posted last",_FILE_AND_LINE_);
+	errorList.Push("A subscription did not notify of a post or release",_FILE_AND_LINE_);
+	errorList.Push("A released key still returned a row, or a key that was not released returned none",_FILE_AND_LINE_);
+
+}
+
+CloudServerTest::~CloudServerTest(void)
+{
+}
@@ -0,0 +1,235 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "FileListScanTest.h"
+
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <direct.h>
+#define rmdir _rmdir
+#else
+#include <unistd.h>
+#endif
+
+/*
+Description:
+Tests that FileList::AddFilesFromDirectory() finds the same files with the same hashes and data on any number of scan threads, and with a hash cache.
+Writes files of sizes around the read block size to a directory next to the executable, scans it, and deletes it again.
+Scans with FileList::SetHashCache() once to fill the cache and once with it filled, then changes a file and scans again. This takes about 3 seconds.
+
+Success conditions:
+Every scan returns the same files, hashes and data as scanning on the calling thread without a cache.
+The cache holds an entry for every file after the first scan, and a changed file gets its new hash.
+
+Failure conditions:
+The files could not be written.
+A scan on scan threads, or with the cache, returns different files, hashes or data.
+The cache was not filled, or returned the old hash for a changed file.
+
+*/
+
+static const char *SCAN_DIRECTORY="FileListScanTestFiles";
+static const char *HASH_CACHE_FILE="FileListScanTestHashes.bin";
+static const int NUM_SUBDIRECTORIES=4;
+static const int FILES_PER_SUBDIRECTORY=16;
+// Empty files, and files that end just before, at and after a read block of 64 KB
+static const unsigned int fileSizes[]={0, 1, 4096, 65535, 65536, 65537, 131072+100, 300000};
+static const int threadCounts[]={1, 2, 4};
+
+static unsigned int FileSize(int subdirectory, int file)
+{
+	return fileSizes[(subdirectory*FILES_PER_SUBDIRECTORY+file)%(sizeof(fileSizes)/sizeof(fileSizes[0]))];
+}
+
+static bool WriteFile(int subdirectory, int file, char firstByte)
+{
+	static char data[300000];
+	unsigned int seed=42+subdirectory*FILES_PER_SUBDIRECTORY+file;
+	unsigned int size=FileSize(subdirectory, file);
+	for (unsigned int i=0; i < size; i++)
+	{
+		seed=seed*1103515245+12345;
+		data[i]=(char) (seed>>16);
+	}
+	if (size>0)
+		data[0]=firstByte;
+	char path[256];
+	sprintf(path, "%s/dir%02i/file%03i.dat", SCAN_DIRECTORY, subdirectory, file);
+	return WriteFileWithDirectories(path, data, size);
+}
+
+static void DeleteFiles(void)
+{
+	FileList fileList;
+	fileList.AddFilesFromDirectory(0, SCAN_DIRECTORY, false, false, true, FileListNodeContext(0,0,0,0));
+	for (unsigned int i=0; i < fileList.fileList.Size(); i++)
+		remove(fileList.fileList[i].fullPathToFile.C_String());
+
+	char path[256];
+	for (int i=0; i < NUM_SUBDIRECTORIES; i++)
+	{
+		sprintf(path, "%s/dir%02i", SCAN_DIRECTORY, i);
+		rmdir(path);
+	}
+	rmdir(SCAN_DIRECTORY);
+	remove(HASH_CACHE_FILE);
+}
+
+static bool SameFiles(const FileList &a, const FileList &b)
+{
+	if (a.fileList.Size()!=b.fileList.Size())
+		return false;
+	for (unsigned int i=0; i < a.fileList.Size(); i++)
+	{
+		const FileListNode &x=a.fileList[i], &y=b.fileList[i];
+		if (x.filename!=y.filename || x.fileLengthBytes!=y.fileLengthBytes || x.dataLengthBytes!=y.dataLengthBytes)
+			return false;
+		if (x.dataLengthBytes && memcmp(x.data, y.data, x.dataLengthBytes)!=0)
+			return false;
+	}
+	return true;
+}
+
+static void Scan(FileList *fileList, int numThreads, const char *hashCache, bool writeData)
+{
+	fileList->Clear();
+	fileList->SetScanThreads(numThreads);
+	fileList->SetHashCache(hashCache);
+	fileList->AddFilesFromDirectory(0, SCAN_DIRECTORY, true, writeData, true, FileListNodeContext(0,0,0,0));
+}
+
+int FileListScanTest::RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses)
+{
+	(void) params;
+
+	DeleteFiles();
+	bool written=true;
+	int i, j;
+	for (i=0; i < NUM_SUBDIRECTORIES && written; i++)
+	{
+		for (j=0; j < FILES_PER_SUBDIRECTORY && written; j++)
+			written=WriteFile(i, j, (char) j);
+	}
+	RakNet::TimeMS filesWrittenTime=RakNet::GetTimeMS();
+	if (written==false)
+	{
+		DeleteFiles();
+		if (isVerbose)
+			DebugTools::ShowError(errorList[1-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 1;
+	}
+
+	if (isVerbose)
+		printf("Scanning on scan threads\n");
+	// Hash only, and hash and data, on the calling thread
+	FileList references[2], fileList;
+	for (int writeData=0; writeData < 2; writeData++)
+	{
+		Scan(&references[writeData], 0, 0, writeData!=0);
+		if (references[writeData].fileList.Size()!=(unsigned int) (NUM_SUBDIRECTORIES*FILES_PER_SUBDIRECTORY))
+		{
+			DeleteFiles();
+			if (isVerbose)
+				DebugTools::ShowError(errorList[2-1],!noPauses && isVerbose,__LINE__,__FILE__);
+			return 2;
+		}
+		for (unsigned int k=0; k < sizeof(threadCounts)/sizeof(threadCounts[0]); k++)
+		{
+			Scan(&fileList, threadCounts[k], 0, writeData!=0);
+			if (SameFiles(fileList, references[writeData])==false)
+			{
+				DeleteFiles();
+				if (isVerbose)
+					DebugTools::ShowError(errorList[2-1],!noPauses && isVerbose,__LINE__,__FILE__);
+				return 2;
+			}
+		}
+	}
+
+	if (isVerbose)
+		printf("Scanning with a hash cache\n");
+	// Recently modified files are not cached
+	while (RakNet::GetTimeMS()-filesWrittenTime < 3000)
+		RakSleep(100);
+	for (i=0; i < 2; i++)
+	{
+		Scan(&fileList, i*2, HASH_CACHE_FILE, false);
+		if (SameFiles(fileList, references[0])==false)
+		{
+			DeleteFiles();
+			if (isVerbose)
+				DebugTools::ShowError(errorList[3-1],!noPauses && isVerbose,__LINE__,__FILE__);
+			return 3;
+		}
+	}
+	FileHashCache hashCache;
+	if (hashCache.Load(HASH_CACHE_FILE)==false || hashCache.GetLoadedEntryCount()!=(unsigned int) (NUM_SUBDIRECTORIES*FILES_PER_SUBDIRECTORY))
+	{
+		DeleteFiles();
+		if (isVerbose)
+			DebugTools::ShowError(errorList[4-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 4;
+	}
+
+	if (isVerbose)
+		printf("Scanning with a hash cache after changing a file\n");
+	// Same size, different contents
+	WriteFile(1, 7, (char) 100);
+	Scan(&references[0], 0, 0, false);
+	Scan(&fileList, 0, HASH_CACHE_FILE, false);
+	bool matches=SameFiles(fileList, references[0]);
+	DeleteFiles();
+	if (matches==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[5-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 5;
+	}
+
+	return 0;
+}
+
+RakString FileListScanTest::GetTestName()
+{
+
+	return "FileListScanTest";
+
+}
+
+RakString FileListScanTest::ErrorCodeToString(int errorCode)
+{
+
+	if (errorCode>0&&(unsigned int)errorCode<=errorList.Size())
+	{
+		return errorList[errorCode-1];
+	}
+	else
+	{
+		return "Undefined Error";
+	}
+
+}
+
+void FileListScanTest::DestroyPeers()
+{
+}
+
+FileListScanTest::FileListScanTest(void)
+{
+
+	errorList.Push("Could not write the files to scan",_FILE_AND_LINE_);
+	errorList.Push("Scan threads returned different files, hashes or data",_FILE_AND_LINE_);
+	errorList.Push("Scan with the hash cache returned different files or hashes",_FILE_AND_LINE_);
+	errorList.Push("Hash cache does not hold an entry for every file",_FILE_AND_LINE_);
+	errorList.Push("Hash cache returned the old hash of a changed file",_FILE_AND_LINE_);
+
+}
+
+FileListScanTest::~FileListScanTest(void)
+{
+}
@@ -28,4 +28,13 @@
 #include "SystemAddressAndGuidTest.h"
 #include "PacketAndLowLevelTestsTest.h"
 #include "MiscellaneousTestsTest.h"
+#include "SerializationTest.h"
+#include "NetworkIDManagerTest.h"
+#include "TableIndexTest.h"
+#include "PluginDispatchTest.h"
+#include "CloudServerTest.h"
+#include "NatPunchthroughServerTest.h"
+#include "FileListScanTest.h"
+#include "SendToListTest.h"
+#include "UpdateShardsTest.h"
 
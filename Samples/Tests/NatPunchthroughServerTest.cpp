@@ -0,0 +1,257 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "NatPunchthroughServerTest.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+Description:
+Tests that NatPunchthroughServer completes punches between many users, and times out attempts the recipient never answers.
+Users are not connected. The test calls OnNewConnection(), OnReceive() and OnClosedConnection() on the plugin with made up GUIDs and addresses,
+and answers ID_NAT_GET_MOST_RECENT_PORT and sends ID_NAT_CLIENT_READY the way NatPunchthroughClient does. The peer is not started.
+Some users with waiting attempts leave before the timeout. This takes about 10 seconds.
+
+Success conditions:
+Every punch completes.
+The waiting attempts of users that stayed time out after 10 seconds and not before. Attempts of users that left do not time out.
+
+Failure conditions:
+A punch does not start or does not complete.
+A waiting attempt times out early, late or not at all, or an attempt of a user that left times out.
+
+*/
+
+static const int NUM_USERS=1000;
+// Attempts between the first users that never get an answer, so they wait for their timeout
+static const int PENDING_ATTEMPTS=100;
+// Senders of the last pending attempts leave before the timeout
+static const int LEAVING_USERS=20;
+static const int NUM_PUNCHES=1000;
+static const RakNet::TimeMS PUNCH_TIMEOUT_MS=10000;
+
+static unsigned int seed=42;
+static unsigned int Random(unsigned int range)
+{
+	seed=seed*1103515245+12345;
+	return ((seed>>8) ^ (seed<<14))%range;
+}
+
+// Counts the messages of the server for each step of a punch
+struct CountingDebugInterface : public NatPunchthroughServerDebugInterface
+{
+	CountingDebugInterface() : startedCount(0), completedCount(0), timedOutCount(0) {}
+	virtual void OnServerMessage(const char *msg)
+	{
+		if (strncmp(msg, "Sending NAT_ATTEMPT_PHASE_GETTING_RECENT_PORTS", 46)==0)
+			startedCount++;
+		else if (strncmp(msg, "Sending ID_NAT_CONNECT_AT_TIME to sender", 40)==0)
+			completedCount++;
+		else if (strncmp(msg, "Sending ID_NAT_TARGET_UNRESPONSIVE", 34)==0)
+			timedOutCount++;
+	}
+
+	int startedCount, completedCount, timedOutCount;
+};
+
+// Passes the messages of made up users to the server
+class PunchthroughUsers
+{
+public:
+	PunchthroughUsers() : nextSessionId(0)
+	{
+		char ip[32];
+		for (int i=0; i < NUM_USERS; i++)
+		{
+			guids[i]=RakNetGUID(((uint64_t) Random(0xFFFFFFFF) << 32) | (uint64_t) i);
+			sprintf(ip, "10.%i.%i.%i", (i>>16) & 255, (i>>8) & 255, i & 255);
+			addresses[i]=SystemAddress(ip, (unsigned short) (1024+Random(60000)));
+		}
+	}
+
+	void Connect(NatPunchthroughServer *server, int user)
+	{
+		server->OnNewConnection(addresses[user], guids[user], true);
+	}
+	void Disconnect(NatPunchthroughServer *server, int user)
+	{
+		server->OnClosedConnection(addresses[user], guids[user], LCR_DISCONNECTION_NOTIFICATION);
+	}
+
+	// Returns the session ID the server gives the attempt. Every request takes one, even if it is refused
+	uint16_t Request(NatPunchthroughServer *server, int sender, int recipient)
+	{
+		BitStream bs;
+		bs.Write((MessageID) ID_NAT_PUNCHTHROUGH_REQUEST);
+		bs.Write(guids[recipient]);
+		Deliver(server, sender, bs);
+		return nextSessionId++;
+	}
+	void SendMostRecentPort(NatPunchthroughServer *server, int user, uint16_t sessionId)
+	{
+		BitStream bs;
+		bs.Write((MessageID) ID_NAT_GET_MOST_RECENT_PORT);
+		bs.Write(sessionId);
+		bs.Write((unsigned short) (addresses[user].GetPort()+1));
+		Deliver(server, user, bs);
+	}
+	void SendReady(NatPunchthroughServer *server, int user)
+	{
+		BitStream bs;
+		bs.Write((MessageID) ID_NAT_CLIENT_READY);
+		Deliver(server, user, bs);
+	}
+	void Punch(NatPunchthroughServer *server, int sender, int recipient)
+	{
+		uint16_t sessionId=Request(server, sender, recipient);
+		SendMostRecentPort(server, sender, sessionId);
+		SendMostRecentPort(server, recipient, sessionId);
+		SendReady(server, sender);
+		SendReady(server, recipient);
+	}
+
+protected:
+	void Deliver(NatPunchthroughServer *server, int user, BitStream &bs)
+	{
+		Packet packet;
+		packet.systemAddress=addresses[user];
+		packet.guid=guids[user];
+		packet.data=bs.GetData();
+		packet.length=bs.GetNumberOfBytesUsed();
+		packet.bitSize=bs.GetNumberOfBitsUsed();
+		packet.deleteData=false;
+		packet.wasGeneratedLocally=false;
+		server->OnReceive(&packet);
+	}
+
+	RakNetGUID guids[NUM_USERS];
+	SystemAddress addresses[NUM_USERS];
+	uint16_t nextSessionId;
+};
+
+int NatPunchthroughServerTest::RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses)
+{
+	(void) params;
+
+	RakPeerInterface *peer=RakPeerInterface::GetInstance();
+	destroyList.Push(peer,_FILE_AND_LINE_);
+	NatPunchthroughServer *server=NatPunchthroughServer::GetInstance();
+	pluginList.Push(server,_FILE_AND_LINE_);
+	CountingDebugInterface debugInterface;
+	server->SetDebugInterface(&debugInterface);
+	peer->AttachPlugin(server);
+
+	PunchthroughUsers *users=new PunchthroughUsers;
+	int i;
+	for (i=0; i < NUM_USERS; i++)
+		users->Connect(server, i);
+
+	if (isVerbose)
+		printf("Punching between %i users\n", NUM_USERS);
+	RakNet::TimeMS pendingStartTime=RakNet::GetTimeMS();
+	for (i=0; i < PENDING_ATTEMPTS; i++)
+		users->Request(server, i*2, i*2+1);
+	for (i=0; i < NUM_PUNCHES; i++)
+	{
+		// Two different users that are not in the pending attempts
+		int sender=PENDING_ATTEMPTS*2+(int) Random(NUM_USERS-PENDING_ATTEMPTS*2);
+		int recipient;
+		do
+		{
+			recipient=PENDING_ATTEMPTS*2+(int) Random(NUM_USERS-PENDING_ATTEMPTS*2);
+		} while (recipient==sender);
+		users->Punch(server, sender, recipient);
+	}
+	if (debugInterface.startedCount!=PENDING_ATTEMPTS+NUM_PUNCHES || debugInterface.completedCount!=NUM_PUNCHES)
+	{
+		delete users;
+		server->SetDebugInterface(0);
+		if (isVerbose)
+			DebugTools::ShowError(errorList[1-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 1;
+	}
+
+	if (isVerbose)
+		printf("Waiting for attempts to time out\n");
+	for (i=PENDING_ATTEMPTS-LEAVING_USERS; i < PENDING_ATTEMPTS; i++)
+		users->Disconnect(server, i*2);
+	RakNet::TimeMS firstTimeout=0;
+	while (RakNet::GetTimeMS()-pendingStartTime < PUNCH_TIMEOUT_MS+2000)
+	{
+		server->Update();
+		if (debugInterface.timedOutCount>0 && firstTimeout==0)
+			firstTimeout=RakNet::GetTimeMS()-pendingStartTime;
+		RakSleep(10);
+	}
+	for (i=0; i < NUM_USERS; i++)
+		users->Disconnect(server, i);
+	delete users;
+	server->SetDebugInterface(0);
+	if (isVerbose)
+		printf("%i of %i waiting attempts timed out, the first after %u ms\n", debugInterface.timedOutCount, PENDING_ATTEMPTS-LEAVING_USERS, firstTimeout);
+	if (debugInterface.timedOutCount!=PENDING_ATTEMPTS-LEAVING_USERS || firstTimeout < PUNCH_TIMEOUT_MS)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[2-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 2;
+	}
+
+	return 0;
+}
+
+RakString NatPunchthroughServerTest::GetTestName()
+{
+
+	return "NatPunchthroughServerTest";
+
+}
+
+RakString NatPunchthroughServerTest::ErrorCodeToString(int errorCode)
+{
+
+	if (errorCode>0&&(unsigned int)errorCode<=errorList.Size())
+	{
+		return errorList[errorCode-1];
+	}
+	else
+	{
+		return "Undefined Error";
+	}
+
+}
+
+void NatPunchthroughServerTest::DestroyPeers()
+{
+
+	int theSize=destroyList.Size();
+
+	for (int i=0; i < theSize; i++)
+		RakPeerInterface::DestroyInstance(destroyList[i]);
+
+	destroyList.Clear(false,_FILE_AND_LINE_);
+
+	theSize=pluginList.Size();
+
+	for (int i=0; i < theSize; i++)
+		delete pluginList[i];
+
+	pluginList.Clear(false,_FILE_AND_LINE_);
+
+}
+
+NatPunchthroughServerTest::NatPunchthroughServerTest(void)
+{
+
+	errorList.Push("Punches did not start or did not complete",_FILE_AND_LINE_);
+	errorList.Push("Waiting attempts did not time out after 10 seconds, or attempts of users that left timed out",_FILE_AND_LINE_);
+
+}
+
+NatPunchthroughServerTest::~NatPunchthroughServerTest(void)
+{
+}
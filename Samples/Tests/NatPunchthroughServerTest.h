@@ -0,0 +1,38 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#pragma once
+
+
+#include "TestInterface.h"
+
+#include "RakString.h"
+
+#include "RakPeerInterface.h"
+#include "NatPunchthroughServer.h"
+#include "MessageIdentifiers.h"
+#include "BitStream.h"
+#include "GetTime.h"
+#include "RakSleep.h"
+#include "DebugTools.h"
+
+using namespace RakNet;
+class NatPunchthroughServerTest : public TestInterface
+{
+public:
+	NatPunchthroughServerTest(void);
+	~NatPunchthroughServerTest(void);
+	int RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses);//should return 0 if no error, or the error number
+	RakString GetTestName();
+	RakString ErrorCodeToString(int errorCode);
+	void DestroyPeers();
+
+private:
+	DataStructures::List <RakString> errorList;
+	DataStructures::List <RakPeerInterface *> destroyList;
+	DataStructures::List <PluginInterface2 *> pluginList;
+};
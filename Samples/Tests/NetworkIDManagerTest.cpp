@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "NetworkIDManagerTest.h"
+
+/*
+Description:
+Tracks 100 thousand objects in a NetworkIDManager, then destroys half of them in random order, gives some of the rest
+the IDs another authority would assign, and tracks new objects in the freed slots.
+
+Success conditions:
+Every lookup returns the object with that ID, and IDs that are not tracked return 0.
+
+Failure conditions:
+A lookup returns the wrong object, or an object for an ID that is not tracked.
+
+*/
+
+static const int NUM_OBJECTS=100000;
+// Objects that get the IDs another authority would assign
+static const int NUM_MOVED=1000;
+
+static unsigned int seed=42;
+static unsigned int Random(unsigned int range)
+{
+	seed=seed*1103515245+12345;
+	return ((seed>>8) ^ (seed<<14))%range;
+}
+
+int NetworkIDManagerTest::RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses)
+{
+	(void) params;
+
+	NetworkIDManager networkIDManager;
+	NetworkIDObject **objects=new NetworkIDObject*[NUM_OBJECTS*2];
+	NetworkID *ids=new NetworkID[NUM_OBJECTS*2];
+	int *order=new int[NUM_OBJECTS];
+	int i;
+	for (i=0; i < NUM_OBJECTS*2; i++)
+		objects[i]=0;
+	for (i=0; i < NUM_OBJECTS; i++)
+	{
+		objects[i]=new NetworkIDObject;
+		objects[i]->SetNetworkIDManager(&networkIDManager);
+		ids[i]=objects[i]->GetNetworkID();
+		order[i]=i;
+	}
+
+	int errorCode=0;
+	if (isVerbose)
+		printf("Testing lookups of %i objects\n", NUM_OBJECTS);
+	for (i=0; i < NUM_OBJECTS && errorCode==0; i++)
+	{
+		if (networkIDManager.GET_OBJECT_FROM_ID<NetworkIDObject*>(ids[i])!=objects[i])
+			errorCode=1;
+		// IDs next to the assigned ones, which is what another authority would assign
+		else if (networkIDManager.GET_OBJECT_FROM_ID<NetworkIDObject*>(ids[i]+NUM_OBJECTS*4)!=0)
+			errorCode=2;
+	}
+
+	if (errorCode==0)
+	{
+		if (isVerbose)
+			printf("Testing lookups after destroying half of the objects in random order\n");
+		for (i=NUM_OBJECTS-1; i > 0; i--)
+		{
+			int j=(int) Random((unsigned int) i+1);
+			int swap=order[i];
+			order[i]=order[j];
+			order[j]=swap;
+		}
+		for (i=0; i < NUM_OBJECTS/2; i++)
+		{
+			delete objects[order[i]];
+			objects[order[i]]=0;
+		}
+		for (i=NUM_OBJECTS/2; i < NUM_OBJECTS/2+NUM_MOVED; i++)
+		{
+			ids[order[i]]+=NUM_OBJECTS*4;
+			objects[order[i]]->SetNetworkID(ids[order[i]]);
+		}
+		for (i=0; i < NUM_OBJECTS && errorCode==0; i++)
+		{
+			NetworkIDObject *found=networkIDManager.GET_OBJECT_FROM_ID<NetworkIDObject*>(ids[i]);
+			if (found!=objects[i])
+				errorCode=objects[i] ? 3 : 2;
+		}
+		for (i=NUM_OBJECTS/2; i < NUM_OBJECTS/2+NUM_MOVED && errorCode==0; i++)
+		{
+			if (networkIDManager.GET_OBJECT_FROM_ID<NetworkIDObject*>(ids[order[i]]-NUM_OBJECTS*4)!=0)
+				errorCode=2;
+		}
+	}
+
+	if (errorCode==0)
+	{
+		if (isVerbose)
+			printf("Testing lookups after tracking new objects\n");
+		for (i=NUM_OBJECTS; i < NUM_OBJECTS*2; i++)
+		{
+			objects[i]=new NetworkIDObject;
+			objects[i]->SetNetworkIDManager(&networkIDManager);
+			ids[i]=objects[i]->GetNetworkID();
+		}
+		for (i=0; i < NUM_OBJECTS*2 && errorCode==0; i++)
+		{
+			if (objects[i] && networkIDManager.GET_OBJECT_FROM_ID<NetworkIDObject*>(ids[i])!=objects[i])
+				errorCode=3;
+		}
+	}
+
+	for (i=0; i < NUM_OBJECTS*2; i++)
+		delete objects[i];
+	delete [] objects;
+	delete [] ids;
+	delete [] order;
+
+	if (errorCode!=0 && isVerbose)
+		DebugTools::ShowError(errorList[errorCode-1],!noPauses && isVerbose,__LINE__,__FILE__);
+	return errorCode;
+}
+
+RakString NetworkIDManagerTest::GetTestName()
+{
+
+	return "NetworkIDManagerTest";
+
+}
+
+RakString NetworkIDManagerTest::ErrorCodeToString(int errorCode)
+{
+
+	if (errorCode>0&&(unsigned int)errorCode<=errorList.Size())
+	{
+		return errorList[errorCode-1];
+	}
+	else
+	{
+		return "Undefined Error";
+	}
+
+}
+
+void NetworkIDManagerTest::DestroyPeers()
+{
+}
+
+NetworkIDManagerTest::NetworkIDManagerTest(void)
+{
+
+	errorList.Push("A lookup returned the wrong object",_FILE_AND_LINE_);
+	errorList.Push("A lookup of an ID that is not tracked returned an object",_FILE_AND_LINE_);
+	errorList.Push("A lookup returned the wrong object after objects were destroyed, moved or added",_FILE_AND_LINE_);
+
+}
+
+NetworkIDManagerTest::~NetworkIDManagerTest(void)
+{
+}
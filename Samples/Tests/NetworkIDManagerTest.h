@@ -0,0 +1,32 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#pragma once
+
+
+#include "TestInterface.h"
+
+#include "RakString.h"
+
+// Also declares NetworkIDObject
+#include "NetworkIDManager.h"
+#include "DebugTools.h"
+
+using namespace RakNet;
+class NetworkIDManagerTest : public TestInterface
+{
+public:
+	NetworkIDManagerTest(void);
+	~NetworkIDManagerTest(void);
+	int RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses);//should return 0 if no error, or the error number
+	RakString GetTestName();
+	RakString ErrorCodeToString(int errorCode);
+	void DestroyPeers();
+
+private:
+	DataStructures::List <RakString> errorList;
+};
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "PluginDispatchTest.h"
+
+/*
+Description:
+Tests that RakPeer::Receive() passes each message to the plugins that take its message ID, in the order of the plugin list.
+DetachPlugin() moves the last plugin into the place of the detached one, so the order after detaching is tested too.
+Attaches plugins that get every message next to plugins that list their message IDs in GetReceivedMessageIDs(), and queues messages with PushBackPacket().
+Some plugins stop processing the messages they handle. Then detaches a plugin and attaches another one, and tests again.
+
+Success conditions:
+Each message reaches the plugins that take it, in plugin list order, up to the first plugin that stops processing it.
+Receive() returns the messages no plugin stopped.
+
+Failure conditions:
+A plugin gets a message it did not list, does not get one it listed, or plugins get a message in a different order.
+Receive() returns a message a plugin stopped, or does not return one no plugin stopped.
+
+*/
+
+static const MessageID ID_GAME_MESSAGE=ID_USER_PACKET_ENUM;
+static const MessageID ID_FIRST_PLUGIN_MESSAGE=ID_USER_PACKET_ENUM+1;
+static const MessageID ID_SECOND_PLUGIN_MESSAGE=ID_USER_PACKET_ENUM+2;
+
+// Writes its number to the call log for each message it gets, and stops processing one message ID
+class RecordingPlugin : public PluginInterface2
+{
+public:
+	RecordingPlugin(char _name, DataStructures::List<char> *_callLog, int _stopMessageId, const MessageID *_listedMessageIds, int _numListedMessageIds)
+		: name(_name), callLog(_callLog), stopMessageId(_stopMessageId), listedMessageIds(_listedMessageIds), numListedMessageIds(_numListedMessageIds) {}
+
+	virtual PluginReceiveResult OnReceive(Packet *packet)
+	{
+		callLog->Push(name, _FILE_AND_LINE_);
+		if (packet->data[0]==stopMessageId)
+			return RR_STOP_PROCESSING_AND_DEALLOCATE;
+		return RR_CONTINUE_PROCESSING;
+	}
+	virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const
+	{
+		if (listedMessageIds==0)
+			return false;
+		for (int i=0; i < numListedMessageIds; i++)
+			messageIDs[listedMessageIds[i]]=true;
+		return true;
+	}
+
+	char name;
+	DataStructures::List<char> *callLog;
+	int stopMessageId;
+	const MessageID *listedMessageIds;
+	int numListedMessageIds;
+};
+
+// Queues one message, calls Receive(), and compares the plugins that got it with expectedCalls
+static bool Dispatch(RakPeerInterface *peer, MessageID messageId, DataStructures::List<char> &callLog, const char *expectedCalls, bool expectReceived)
+{
+	callLog.Clear(false, _FILE_AND_LINE_);
+	Packet *packet=peer->AllocatePacket(8);
+	packet->data[0]=messageId;
+	peer->PushBackPacket(packet, false);
+
+	bool received=false;
+	for (packet=peer->Receive(); packet; peer->DeallocatePacket(packet), packet=peer->Receive())
+	{
+		if (packet->data[0]==messageId)
+			received=true;
+	}
+	if (received!=expectReceived || callLog.Size()!=strlen(expectedCalls))
+		return false;
+	for (unsigned int i=0; i < callLog.Size(); i++)
+	{
+		if (callLog[i]!=expectedCalls[i])
+			return false;
+	}
+	return true;
+}
+
+int PluginDispatchTest::RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses)
+{
+	(void) params;
+
+	RakPeerInterface *peer=RakPeerInterface::GetInstance();
+	destroyList.Push(peer,_FILE_AND_LINE_);
+	SocketDescriptor socketDescriptor;
+	if (peer->Startup(1, &socketDescriptor, 1)!=RAKNET_STARTED)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[1-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 1;
+	}
+
+	static const MessageID firstMessageIds[]={ID_FIRST_PLUGIN_MESSAGE};
+	static const MessageID bothMessageIds[]={ID_FIRST_PLUGIN_MESSAGE, ID_SECOND_PLUGIN_MESSAGE};
+	DataStructures::List<char> callLog;
+	// a gets every message, b stops the first plugin message, c lists both plugin messages, d gets every message and stops the second plugin message,
+	// e lists both plugin messages and stops the first
+	RecordingPlugin *a=new RecordingPlugin('a', &callLog, -1, 0, 0);
+	RecordingPlugin *b=new RecordingPlugin('b', &callLog, ID_FIRST_PLUGIN_MESSAGE, firstMessageIds, 1);
+	RecordingPlugin *c=new RecordingPlugin('c', &callLog, -1, bothMessageIds, 2);
+	RecordingPlugin *d=new RecordingPlugin('d', &callLog, ID_SECOND_PLUGIN_MESSAGE, 0, 0);
+	RecordingPlugin *e=new RecordingPlugin('e', &callLog, ID_FIRST_PLUGIN_MESSAGE, bothMessageIds, 2);
+	pluginList.Push(a,_FILE_AND_LINE_);
+	pluginList.Push(b,_FILE_AND_LINE_);
+	pluginList.Push(c,_FILE_AND_LINE_);
+	pluginList.Push(d,_FILE_AND_LINE_);
+	pluginList.Push(e,_FILE_AND_LINE_);
+	peer->AttachPlugin(a);
+	peer->AttachPlugin(b);
+	peer->AttachPlugin(c);
+	peer->AttachPlugin(d);
+
+	if (isVerbose)
+		printf("Testing which plugins get each message\n");
+	if (Dispatch(peer, ID_GAME_MESSAGE, callLog, "ad", true)==false ||
+		Dispatch(peer, ID_FIRST_PLUGIN_MESSAGE, callLog, "ab", false)==false ||
+		Dispatch(peer, ID_SECOND_PLUGIN_MESSAGE, callLog, "acd", false)==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[2-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 2;
+	}
+
+	if (isVerbose)
+		printf("Testing after detaching and attaching plugins\n");
+	peer->DetachPlugin(d);
+	peer->AttachPlugin(e);
+	if (Dispatch(peer, ID_GAME_MESSAGE, callLog, "a", true)==false ||
+		Dispatch(peer, ID_FIRST_PLUGIN_MESSAGE, callLog, "ab", false)==false ||
+		Dispatch(peer, ID_SECOND_PLUGIN_MESSAGE, callLog, "ace", true)==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[3-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 3;
+	}
+	// e takes the place of b
+	peer->DetachPlugin(b);
+	if (Dispatch(peer, ID_GAME_MESSAGE, callLog, "a", true)==false ||
+		Dispatch(peer, ID_FIRST_PLUGIN_MESSAGE, callLog, "ae", false)==false ||
+		Dispatch(peer, ID_SECOND_PLUGIN_MESSAGE, callLog, "aec", true)==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[3-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 3;
+	}
+	// c takes the place of a
+	peer->DetachPlugin(a);
+	if (Dispatch(peer, ID_GAME_MESSAGE, callLog, "", true)==false ||
+		Dispatch(peer, ID_FIRST_PLUGIN_MESSAGE, callLog, "ce", false)==false ||
+		Dispatch(peer, ID_SECOND_PLUGIN_MESSAGE, callLog, "ce", true)==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[3-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 3;
+	}
+
+	return 0;
+}
+
+RakString PluginDispatchTest::GetTestName()
+{
+
+	return "PluginDispatchTest";
+
+}
+
+RakString PluginDispatchTest::ErrorCodeToString(int errorCode)
+{
+
+	if (errorCode>0&&(unsigned int)errorCode<=errorList.Size())
+	{
+		return errorList[errorCode-1];
+	}
+	else
+	{
+		return "Undefined Error";
+	}
+
+}
+
+void PluginDispatchTest::DestroyPeers()
+{
+
+	int theSize=destroyList.Size();
+
+	for (int i=0; i < theSize; i++)
+		RakPeerInterface::DestroyInstance(destroyList[i]);
+
+	destroyList.Clear(false,_FILE_AND_LINE_);
+
+	theSize=pluginList.Size();
+
+	for (int i=0; i < theSize; i++)
+		delete pluginList[i];
+
+	pluginList.Clear(false,_FILE_AND_LINE_);
+
+}
+
+PluginDispatchTest::PluginDispatchTest(void)
+{
+
+	errorList.Push("Peer did not start",_FILE_AND_LINE_);
+	errorList.Push("Plugins did not get the messages they take, in attach order",_FILE_AND_LINE_);
+	errorList.Push("Plugins did not get the messages they take after detaching and attaching plugins",_FILE_AND_LINE_);
+
+}
+
+PluginDispatchTest::~PluginDispatchTest(void)
+{
+}
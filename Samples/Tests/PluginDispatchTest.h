@@ -0,0 +1,35 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#pragma once
+
+
+#include "TestInterface.h"
+
+#include "RakString.h"
+
+#include "RakPeerInterface.h"
+#include "PluginInterface2.h"
+#include "MessageIdentifiers.h"
+#include "DebugTools.h"
+
+using namespace RakNet;
+class PluginDispatchTest : public TestInterface
+{
+public:
+	PluginDispatchTest(void);
+	~PluginDispatchTest(void);
+	int RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses);//should return 0 if no error, or the error number
+	RakString GetTestName();
+	RakString ErrorCodeToString(int errorCode);
+	void DestroyPeers();
+
+private:
+	DataStructures::List <RakString> errorList;
+	DataStructures::List <RakPeerInterface *> destroyList;
+	DataStructures::List <PluginInterface2 *> pluginList;
+};
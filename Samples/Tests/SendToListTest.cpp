@@ -0,0 +1,277 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "SendToListTest.h"
+
+/*
+Description:
+Tests that RakPeerInterface::SendToList() delivers one message to every connected system in the list, in order with messages from Send() on the same channel.
+A server sends to clients over the loopback address with SendToList() from a BitStream and from a SharedSendBuffer, to all clients and to some,
+and with Send() to single clients in between. Some lists also hold a system that is not connected. Some messages are large enough to be split.
+
+Success conditions:
+Every client gets the messages sent to it, in the order they were sent and unchanged, and no others.
+
+Failure conditions:
+The clients do not connect.
+A client misses a message, gets one that was not sent to it, or gets messages out of order or changed.
+
+*/
+
+static const int NUM_CLIENTS=8;
+static const unsigned int NUM_MESSAGES=300;
+static const RakNet::TimeMS TIMEOUT_MS=30000;
+
+static unsigned int MessageSize(unsigned int messageIndex)
+{
+	// Every tenth message is split
+	return messageIndex%10==0 ? 3000 : 64;
+}
+
+static unsigned char PayloadByte(unsigned int messageIndex, unsigned int offset)
+{
+	return (unsigned char) (messageIndex*31+offset);
+}
+
+static void WriteMessage(BitStream *bs, unsigned int messageIndex)
+{
+	bs->Reset();
+	bs->Write((MessageID) ID_USER_PACKET_ENUM);
+	bs->Write(messageIndex);
+	for (unsigned int i=1+sizeof(messageIndex); i < MessageSize(messageIndex); i++)
+		bs->Write(PayloadByte(messageIndex, i));
+}
+
+// Which clients a message goes to, and how it is sent
+enum SendMode
+{
+	TO_ALL,
+	TO_EVEN_CLIENTS,
+	TO_ONE_CLIENT,
+	SHARED_BUFFER_TO_ALL,
+	TO_ALL_AND_UNCONNECTED
+};
+
+static SendMode GetSendMode(unsigned int messageIndex)
+{
+	return (SendMode) (messageIndex%5);
+}
+
+static bool IsSentTo(unsigned int messageIndex, int clientIndex)
+{
+	switch (GetSendMode(messageIndex))
+	{
+	case TO_EVEN_CLIENTS:
+		return clientIndex%2==0;
+	case TO_ONE_CLIENT:
+		return (int) ((messageIndex/5)%NUM_CLIENTS)==clientIndex;
+	default:
+		return true;
+	}
+}
+
+static void SendMessage(RakPeerInterface *server, RakPeerInterface **clients, unsigned int messageIndex)
+{
+	BitStream bs;
+	WriteMessage(&bs, messageIndex);
+	AddressOrGUID targets[NUM_CLIENTS+1];
+	unsigned int numTargets=0;
+	for (int i=0; i < NUM_CLIENTS; i++)
+	{
+		if (IsSentTo(messageIndex, i))
+			targets[numTargets++]=clients[i]->GetMyGUID();
+	}
+
+	switch (GetSendMode(messageIndex))
+	{
+	case TO_ONE_CLIENT:
+		server->Send(&bs, HIGH_PRIORITY, RELIABLE_ORDERED, 0, targets[0], false);
+		break;
+	case SHARED_BUFFER_TO_ALL:
+		{
+			SharedSendBuffer *sharedSendBuffer=SharedSendBuffer::Allocate(&bs, _FILE_AND_LINE_);
+			server->SendToList(sharedSendBuffer, HIGH_PRIORITY, RELIABLE_ORDERED, 0, targets, numTargets);
+			sharedSendBuffer->Release(_FILE_AND_LINE_);
+		}
+		break;
+	case TO_ALL_AND_UNCONNECTED:
+		// Skipped, as it is not connected
+		targets[numTargets++]=RakNetGUID(12345);
+		server->SendToList(&bs, HIGH_PRIORITY, RELIABLE_ORDERED, 0, targets, numTargets);
+		break;
+	default:
+		server->SendToList(&bs, HIGH_PRIORITY, RELIABLE_ORDERED, 0, targets, numTargets);
+		break;
+	}
+}
+
+// Returns false if the message is not the next one sent to the client, or was changed
+static bool CheckMessage(Packet *packet, int clientIndex, unsigned int *nextMessageIndex)
+{
+	while (*nextMessageIndex < NUM_MESSAGES && IsSentTo(*nextMessageIndex, clientIndex)==false)
+		(*nextMessageIndex)++;
+	unsigned int messageIndex=*nextMessageIndex;
+	(*nextMessageIndex)++;
+	if (messageIndex>=NUM_MESSAGES || packet->length!=MessageSize(messageIndex))
+		return false;
+	BitStream bsIn(packet->data, packet->length, false);
+	bsIn.IgnoreBytes(sizeof(MessageID));
+	unsigned int readMessageIndex;
+	bsIn.Read(readMessageIndex);
+	if (readMessageIndex!=messageIndex)
+		return false;
+	for (unsigned int i=1+sizeof(messageIndex); i < packet->length; i++)
+	{
+		if (packet->data[i]!=PayloadByte(messageIndex, i))
+			return false;
+	}
+	return true;
+}
+
+int SendToListTest::RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses)
+{
+	(void) params;
+
+	RakPeerInterface *server=RakPeerInterface::GetInstance();
+	destroyList.Push(server,_FILE_AND_LINE_);
+	SocketDescriptor socketDescriptor(0, "127.0.0.1");
+	server->Startup(NUM_CLIENTS, &socketDescriptor, 1);
+	server->SetMaximumIncomingConnections(NUM_CLIENTS);
+	RakPeerInterface *clients[NUM_CLIENTS];
+	int i;
+	for (i=0; i < NUM_CLIENTS; i++)
+	{
+		clients[i]=RakPeerInterface::GetInstance();
+		destroyList.Push(clients[i],_FILE_AND_LINE_);
+		SocketDescriptor clientSocketDescriptor(0, "127.0.0.1");
+		clients[i]->Startup(1, &clientSocketDescriptor, 1);
+		clients[i]->Connect("127.0.0.1", server->GetMyBoundAddress().GetPort(), 0, 0);
+	}
+
+	Packet *packet;
+	int connectedCount=0;
+	RakNet::TimeMS startTime=RakNet::GetTimeMS();
+	while (connectedCount < NUM_CLIENTS && RakNet::GetTimeMS()-startTime < TIMEOUT_MS)
+	{
+		for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+		{
+			if (packet->data[0]==ID_NEW_INCOMING_CONNECTION)
+				connectedCount++;
+		}
+		RakSleep(10);
+	}
+	if (connectedCount!=NUM_CLIENTS)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[1-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 1;
+	}
+
+	if (isVerbose)
+		printf("Sending %u messages to lists of clients\n", NUM_MESSAGES);
+	unsigned int messageIndex;
+	for (messageIndex=0; messageIndex < NUM_MESSAGES; messageIndex++)
+		SendMessage(server, clients, messageIndex);
+
+	unsigned int nextMessageIndices[NUM_CLIENTS], receivedCounts[NUM_CLIENTS], expectedCounts[NUM_CLIENTS];
+	for (i=0; i < NUM_CLIENTS; i++)
+	{
+		nextMessageIndices[i]=0;
+		receivedCounts[i]=0;
+		expectedCounts[i]=0;
+		for (messageIndex=0; messageIndex < NUM_MESSAGES; messageIndex++)
+		{
+			if (IsSentTo(messageIndex, i))
+				expectedCounts[i]++;
+		}
+	}
+	bool matches=true, done=false;
+	startTime=RakNet::GetTimeMS();
+	while (matches && done==false && RakNet::GetTimeMS()-startTime < TIMEOUT_MS)
+	{
+		done=true;
+		for (i=0; i < NUM_CLIENTS; i++)
+		{
+			for (packet=clients[i]->Receive(); packet; clients[i]->DeallocatePacket(packet), packet=clients[i]->Receive())
+			{
+				if (packet->data[0]!=ID_USER_PACKET_ENUM)
+					continue;
+				if (CheckMessage(packet, i, &nextMessageIndices[i])==false)
+					matches=false;
+				receivedCounts[i]++;
+			}
+			if (receivedCounts[i]!=expectedCounts[i])
+				done=false;
+		}
+		for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+			;
+		RakSleep(10);
+	}
+	// Nothing more than expected arrives
+	RakSleep(100);
+	for (i=0; i < NUM_CLIENTS; i++)
+	{
+		for (packet=clients[i]->Receive(); packet; clients[i]->DeallocatePacket(packet), packet=clients[i]->Receive())
+		{
+			if (packet->data[0]==ID_USER_PACKET_ENUM)
+				matches=false;
+		}
+	}
+	if (matches==false || done==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[2-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 2;
+	}
+
+	return 0;
+}
+
+RakString SendToListTest::GetTestName()
+{
+
+	return "SendToListTest";
+
+}
+
+RakString SendToListTest::ErrorCodeToString(int errorCode)
+{
+
+	if (errorCode>0&&(unsigned int)errorCode<=errorList.Size())
+	{
+		return errorList[errorCode-1];
+	}
+	else
+	{
+		return "Undefined Error";
+	}
+
+}
+
+void SendToListTest::DestroyPeers()
+{
+
+	int theSize=destroyList.Size();
+
+	for (int i=0; i < theSize; i++)
+		RakPeerInterface::DestroyInstance(destroyList[i]);
+
+	destroyList.Clear(false,_FILE_AND_LINE_);
+
+}
+
+SendToListTest::SendToListTest(void)
+{
+
+	errorList.Push("Clients did not connect to the server",_FILE_AND_LINE_);
+	errorList.Push("Clients did not get the messages sent to them in order and unchanged",_FILE_AND_LINE_);
+
+}
+
+SendToListTest::~SendToListTest(void)
+{
+}
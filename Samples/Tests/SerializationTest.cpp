@@ -0,0 +1,322 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "SerializationTest.h"
+
+#include <string.h>
+
+/*
+Description:
+Tests that data comes back unchanged from:
+BitStream, for blocks of bits that start at every offset within a 64 bit word, and for mixed width values
+RakString, when short strings stored inline and long strings with shared storage are copied and hashed from several threads
+StringCompressor and DataCompressor
+
+Success conditions:
+All data reads back the way it was written.
+
+Failure conditions:
+A block of bits, a value, a string or a buffer differs after the round trip.
+A change to a copy of a RakString changes the string it was copied from.
+
+*/
+
+static unsigned int seed=42;
+static unsigned int Random(unsigned int range)
+{
+	seed=seed*1103515245+12345;
+	return ((seed>>8) ^ (seed<<14))%range;
+}
+
+// Writes blocks of many lengths after 0 to 71 bits, so the blocks start at every offset in a word, and reads them back
+bool SerializationTest::CheckBitRoundTrips(void)
+{
+	static const BitSize_t lengths[]={1, 7, 8, 9, 31, 32, 33, 63, 64, 65, 127, 128, 129, 1000, 2049};
+	unsigned char source[300], output[300];
+	for (int i=0; i < (int) sizeof(source); i++)
+		source[i]=(unsigned char) (i*131+7);
+
+	for (BitSize_t offset=0; offset < 72; offset++)
+	{
+		for (unsigned int i=0; i < sizeof(lengths)/sizeof(lengths[0]); i++)
+		{
+			BitStream bitStream;
+			BitSize_t j;
+			for (j=0; j < offset; j++)
+				bitStream.Write(j%3==0);
+			bitStream.WriteBits(source, lengths[i], true);
+			bitStream.Write((unsigned int) 0x12345678);
+
+			bool bit;
+			for (j=0; j < offset; j++)
+			{
+				if (bitStream.Read(bit)==false || bit!=(j%3==0))
+					return false;
+			}
+			memset(output, 0, sizeof(output));
+			if (bitStream.ReadBits(output, lengths[i], true)==false)
+				return false;
+			const BitSize_t wholeBytes=lengths[i]/8;
+			const int remainingBits=(int) (lengths[i]%8);
+			if (memcmp(output, source, wholeBytes)!=0)
+				return false;
+			if (remainingBits && ((output[wholeBytes]^source[wholeBytes]) & ((1<<remainingBits)-1))!=0)
+				return false;
+			unsigned int marker;
+			if (bitStream.Read(marker)==false || marker!=0x12345678)
+				return false;
+		}
+	}
+	return true;
+}
+
+// Bools, compressed integers, integer ranges, floats and 12 bit blocks, as ReplicaManager3 serialization writes them
+bool SerializationTest::CheckMixedWidthRoundTrip(void)
+{
+	static const int NUM_VALUES=1000;
+	bool bools[NUM_VALUES];
+	unsigned int compressed[NUM_VALUES];
+	unsigned short ranges[NUM_VALUES];
+	float floats[NUM_VALUES];
+	unsigned char bits[NUM_VALUES][2];
+	BitStream bitStream;
+	int i;
+	for (i=0; i < NUM_VALUES; i++)
+	{
+		bools[i]=Random(2)==0;
+		compressed[i]=Random(4) ? Random(256) : Random(0xFFFFFFFF);
+		ranges[i]=(unsigned short) Random(1001);
+		floats[i]=(float) Random(100000)/7.0f;
+		bits[i][0]=(unsigned char) Random(256);
+		bits[i][1]=(unsigned char) Random(16);
+		bitStream.Write(bools[i]);
+		bitStream.WriteCompressed(compressed[i]);
+		bitStream.WriteBitsFromIntegerRange(ranges[i], (unsigned short) 0, (unsigned short) 1000);
+		bitStream.Write(floats[i]);
+		bitStream.WriteBits(bits[i], 12, true);
+	}
+
+	for (i=0; i < NUM_VALUES; i++)
+	{
+		bool b;
+		unsigned int c;
+		unsigned short r;
+		float f;
+		unsigned char readBits[2]={0,0};
+		if (bitStream.Read(b)==false || bitStream.ReadCompressed(c)==false ||
+			bitStream.ReadBitsFromIntegerRange(r, (unsigned short) 0, (unsigned short) 1000)==false ||
+			bitStream.Read(f)==false || bitStream.ReadBits(readBits, 12, true)==false)
+			return false;
+		if (b!=bools[i] || c!=compressed[i] || r!=ranges[i] || f!=floats[i] || readBits[0]!=bits[i][0] || (readBits[1]&15)!=bits[i][1])
+			return false;
+	}
+	return bitStream.GetNumberOfUnreadBits()==0;
+}
+
+static const char *shortChars="PlayerName_0042";
+static const char *longChars="Lobby/Europe/West/Ranked/Room_0042 hosted by PlayerName_0042 with a long description";
+
+struct RakStringThreadArguments
+{
+	const RakString *shortString;
+	const RakString *longString;
+	unsigned long shortHash;
+	unsigned long longHash;
+	LocklessUint32_t *failures;
+	LocklessUint32_t *threadsDone;
+};
+
+RAK_THREAD_DECLARATION(CopyRakStrings)
+{
+	RakStringThreadArguments *threadArguments=(RakStringThreadArguments *) arguments;
+	RakString target;
+	for (unsigned int i=0; i < 100000; i++)
+	{
+		RakString copy(i&1 ? *threadArguments->shortString : *threadArguments->longString);
+		target=i&1 ? *threadArguments->longString : *threadArguments->shortString;
+		if (strcmp(copy.C_String(), i&1 ? shortChars : longChars)!=0 ||
+			RakString::ToInteger(target)!=(i&1 ? threadArguments->longHash : threadArguments->shortHash))
+			threadArguments->failures->Increment();
+	}
+	threadArguments->threadsDone->Increment();
+	return 0;
+}
+
+// Copies and hashes the same short and long strings from four threads
+bool SerializationTest::CheckRakStringCopies(void)
+{
+	static const unsigned int NUM_THREADS=4;
+	RakString shortString(shortChars), longString(longChars);
+	LocklessUint32_t failures, threadsDone;
+	RakStringThreadArguments threadArguments[NUM_THREADS];
+	for (unsigned int i=0; i < NUM_THREADS; i++)
+	{
+		threadArguments[i].shortString=&shortString;
+		threadArguments[i].longString=&longString;
+		threadArguments[i].shortHash=RakString::ToInteger(shortChars);
+		threadArguments[i].longHash=RakString::ToInteger(longChars);
+		threadArguments[i].failures=&failures;
+		threadArguments[i].threadsDone=&threadsDone;
+		if (RakThread::Create(&CopyRakStrings, &threadArguments[i])!=0)
+			return false;
+	}
+	while (threadsDone.Load()!=NUM_THREADS)
+		RakSleep(10);
+	if (failures.Load()!=0)
+		return false;
+
+	// Copies of both share nothing a change can reach
+	RakString shortCopy(shortString), longCopy(longString);
+	shortCopy+="!";
+	longCopy+="!";
+	longCopy.SetChar(0, 'l');
+	return shortString==shortChars && longString==longChars && shortCopy.GetLength()==strlen(shortChars)+1 && longCopy.C_String()[0]=='l';
+}
+
+bool SerializationTest::CheckStringCompressor(void)
+{
+	char longString[256];
+	for (int i=0; i < 255; i++)
+		longString[i]=(char) ('a'+i%26);
+	longString[255]=0;
+	const char *strings[]=
+	{
+		"",
+		"gg",
+		"Anyone up for another round?",
+		"SetPlayerLoadout(weapon=\"rifle\", ammo=120, grenades=2)",
+		"\xC9t\xE9 \x01\x7F\xFF",
+		longString
+	};
+	const int numStrings=sizeof(strings)/sizeof(strings[0]);
+
+	StringCompressor::AddReference();
+	BitStream bitStream;
+	int i;
+	for (i=0; i < numStrings; i++)
+		StringCompressor::Instance()->EncodeString(strings[i], 256, &bitStream);
+	bool matches=true;
+	char output[256];
+	for (i=0; i < numStrings && matches; i++)
+	{
+		if (StringCompressor::Instance()->DecodeString(output, 256, &bitStream)==false || strcmp(output, strings[i])!=0)
+			matches=false;
+	}
+	StringCompressor::RemoveReference();
+	return matches;
+}
+
+bool SerializationTest::CheckDataCompressor(void)
+{
+	static const unsigned int sizes[]={1, 100, 64*1024};
+	static unsigned char data[64*1024];
+	const char *text="The quick brown fox jumps over the lazy dog, then waits at the respawn point for 10 seconds.";
+	for (unsigned int i=0; i < sizeof(data); i++)
+		data[i]=Random(8)==0 ? (unsigned char) Random(256) : (unsigned char) text[i%strlen(text)];
+
+	for (unsigned int i=0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+	{
+		BitStream compressed;
+		DataCompressor::Compress(data, sizes[i], &compressed);
+		unsigned char *decompressed;
+		unsigned int decompressedSize=DataCompressor::DecompressAndAllocate(&compressed, &decompressed);
+		bool matches=decompressedSize==sizes[i] && memcmp(decompressed, data, sizes[i])==0;
+		rakFree_Ex(decompressed, _FILE_AND_LINE_);
+		if (matches==false)
+			return false;
+	}
+	return true;
+}
+
+int SerializationTest::RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses)
+{
+	(void) params;
+
+	if (isVerbose)
+		printf("Testing BitStream blocks at every bit offset\n");
+	if (CheckBitRoundTrips()==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[1-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 1;
+	}
+
+	if (isVerbose)
+		printf("Testing BitStream mixed width values\n");
+	if (CheckMixedWidthRoundTrip()==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[2-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 2;
+	}
+
+	if (isVerbose)
+		printf("Testing RakString copies from several threads\n");
+	if (CheckRakStringCopies()==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[3-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 3;
+	}
+
+	if (isVerbose)
+		printf("Testing StringCompressor and DataCompressor\n");
+	if (CheckStringCompressor()==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[4-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 4;
+	}
+	if (CheckDataCompressor()==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[5-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 5;
+	}
+
+	return 0;
+}
+
+RakString SerializationTest::GetTestName()
+{
+
+	return "SerializationTest";
+
+}
+
+RakString SerializationTest::ErrorCodeToString(int errorCode)
+{
+
+	if (errorCode>0&&(unsigned int)errorCode<=errorList.Size())
+	{
+		return errorList[errorCode-1];
+	}
+	else
+	{
+		return "Undefined Error";
+	}
+
+}
+
+void SerializationTest::DestroyPeers()
+{
+}
+
+SerializationTest::SerializationTest(void)
+{
+
+	errorList.Push("BitStream read back different bits than were written",_FILE_AND_LINE_);
+	errorList.Push("BitStream read back different mixed width values than were written",_FILE_AND_LINE_);
+	errorList.Push("RakString copies did not match, or a change to a copy changed the source",_FILE_AND_LINE_);
+	errorList.Push("StringCompressor decoded a different string",_FILE_AND_LINE_);
+	errorList.Push("DataCompressor decompressed different data",_FILE_AND_LINE_);
+
+}
+
+SerializationTest::~SerializationTest(void)
+{
+}
@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#pragma once
+
+
+#include "TestInterface.h"
+
+#include "RakString.h"
+
+#include "BitStream.h"
+#include "StringCompressor.h"
+#include "DataCompressor.h"
+#include "RakThread.h"
+#include "LocklessTypes.h"
+#include "RakSleep.h"
+#include "DebugTools.h"
+
+using namespace RakNet;
+class SerializationTest : public TestInterface
+{
+public:
+	SerializationTest(void);
+	~SerializationTest(void);
+	int RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses);//should return 0 if no error, or the error number
+	RakString GetTestName();
+	RakString ErrorCodeToString(int errorCode);
+	void DestroyPeers();
+
+private:
+	bool CheckBitRoundTrips(void);
+	bool CheckMixedWidthRoundTrip(void);
+	bool CheckRakStringCopies(void);
+	bool CheckStringCompressor(void);
+	bool CheckDataCompressor(void);
+
+	DataStructures::List <RakString> errorList;
+};
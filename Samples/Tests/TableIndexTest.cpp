@@ -0,0 +1,312 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "TableIndexTest.h"
+
+#include <stdio.h>
+
+using namespace DataStructures;
+
+/*
+Description:
+Tests that DataStructures::Table::QueryTable() returns the same rows with and without Table::AddIndex() on the filtered columns.
+Queries a table of rooms with string and numeric filters, then again after UpdateCell(), RemoveRow(), AddRow() and writes to Row::cells followed by UpdateIndices().
+
+Success conditions:
+Every query returns the same rows on the indexed table as on a copy of it that was never indexed.
+
+Failure conditions:
+AddIndex() fails for a NUMERIC or STRING column.
+A query returns different rows with indices.
+
+*/
+
+static const unsigned NUM_ROWS=20000;
+
+static const char *gameModes[]={"Deathmatch", "Team deathmatch", "Capture the flag", "King of the hill", "Domination", "Search and destroy", "Free for all", "Co-op"};
+static const char *regions[]={"Europe", "North America", "South America", "Asia", "Oceania", "Africa"};
+
+enum Columns
+{
+	COLUMN_GAME_MODE,
+	COLUMN_MAP,
+	COLUMN_REGION,
+	COLUMN_PLAYERS,
+	COLUMN_MAX_PLAYERS,
+	COLUMN_SKILL,
+	COLUMN_PING
+};
+
+struct FilterMix
+{
+	int numFilters;
+	Table::FilterQuery filters[4];
+	Table::Cell values[4];
+};
+
+static unsigned int seed=42;
+static unsigned int Random(unsigned int range)
+{
+	seed=seed*1103515245+12345;
+	return (seed>>8)%range;
+}
+
+static void AddFilter(FilterMix *mix, unsigned columnIndex, Table::FilterQueryType operation, int numericValue, const char *stringValue)
+{
+	if (stringValue)
+		mix->values[mix->numFilters].Set(stringValue);
+	else
+		mix->values[mix->numFilters].Set(numericValue);
+	mix->filters[mix->numFilters].columnIndex=columnIndex;
+	mix->filters[mix->numFilters].operation=operation;
+	mix->filters[mix->numFilters].cellValue=&mix->values[mix->numFilters];
+	mix->numFilters++;
+}
+
+static void FillRow(Table::Row *row)
+{
+	char mapName[32];
+	row->UpdateCell(COLUMN_GAME_MODE, gameModes[Random(sizeof(gameModes)/sizeof(gameModes[0]))]);
+	sprintf(mapName, "Map_%02u", Random(50));
+	row->UpdateCell(COLUMN_MAP, mapName);
+	row->UpdateCell(COLUMN_REGION, regions[Random(sizeof(regions)/sizeof(regions[0]))]);
+	double maxPlayers=(double) (4+4*Random(4));
+	row->UpdateCell(COLUMN_MAX_PLAYERS, maxPlayers);
+	row->UpdateCell(COLUMN_PLAYERS, (double) Random((unsigned) maxPlayers+1));
+	row->UpdateCell(COLUMN_SKILL, (double) Random(3000));
+	row->UpdateCell(COLUMN_PING, (double) (10+Random(300)));
+}
+
+static bool SameRows(Table &a, Table &b)
+{
+	if (a.GetRowCount()!=b.GetRowCount())
+		return false;
+	Page<unsigned, Table::Row*, _TABLE_BPLUS_TREE_ORDER> *x=a.GetListHead(), *y=b.GetListHead();
+	int i=0, j=0;
+	while (x && y)
+	{
+		if (x->keys[i]!=y->keys[j])
+			return false;
+		if (++i==x->size)
+		{
+			x=x->next;
+			i=0;
+		}
+		if (++j==y->size)
+		{
+			y=y->next;
+			j=0;
+		}
+	}
+	return true;
+}
+
+// Runs every filter mix on both tables
+static bool SameQueryResults(Table &indexed, Table &unindexed, FilterMix *mixes, int numMixes)
+{
+	Table resultWith, resultWithout;
+	for (int i=0; i < numMixes; i++)
+	{
+		indexed.QueryTable(0, 0, mixes[i].filters, mixes[i].numFilters, 0, 0, &resultWith);
+		unindexed.QueryTable(0, 0, mixes[i].filters, mixes[i].numFilters, 0, 0, &resultWithout);
+		if (SameRows(resultWith, resultWithout)==false)
+			return false;
+	}
+	return true;
+}
+
+int TableIndexTest::RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses)
+{
+	(void) params;
+
+	Table table;
+	table.AddColumn("Game mode", Table::STRING);
+	table.AddColumn("Map", Table::STRING);
+	table.AddColumn("Region", Table::STRING);
+	table.AddColumn("Players", Table::NUMERIC);
+	table.AddColumn("Max players", Table::NUMERIC);
+	table.AddColumn("Skill", Table::NUMERIC);
+	table.AddColumn("Ping", Table::NUMERIC);
+	table.AddColumn("Description", Table::BINARY);
+
+	unsigned rowId;
+	for (rowId=0; rowId < NUM_ROWS; rowId++)
+		FillRow(table.AddRow(rowId));
+
+	static const int NUM_MIXES=7;
+	FilterMix mixes[NUM_MIXES];
+	for (int i=0; i < NUM_MIXES; i++)
+		mixes[i].numFilters=0;
+	AddFilter(&mixes[0], COLUMN_GAME_MODE, Table::QF_EQUAL, 0, "Capture the flag");
+	AddFilter(&mixes[1], COLUMN_MAP, Table::QF_EQUAL, 0, "Map_07");
+	AddFilter(&mixes[1], COLUMN_REGION, Table::QF_EQUAL, 0, "Europe");
+	AddFilter(&mixes[2], COLUMN_SKILL, Table::QF_GREATER_THAN_EQ, 1400, 0);
+	AddFilter(&mixes[2], COLUMN_SKILL, Table::QF_LESS_THAN_EQ, 1600, 0);
+	AddFilter(&mixes[3], COLUMN_GAME_MODE, Table::QF_EQUAL, 0, "Domination");
+	AddFilter(&mixes[3], COLUMN_SKILL, Table::QF_GREATER_THAN, 1000, 0);
+	AddFilter(&mixes[3], COLUMN_SKILL, Table::QF_LESS_THAN, 2000, 0);
+	AddFilter(&mixes[3], COLUMN_PING, Table::QF_LESS_THAN, 100, 0);
+	AddFilter(&mixes[4], COLUMN_PLAYERS, Table::QF_GREATER_THAN_EQ, 1, 0);
+	AddFilter(&mixes[4], COLUMN_PING, Table::QF_LESS_THAN, 250, 0);
+	AddFilter(&mixes[5], COLUMN_PLAYERS, Table::QF_EQUAL, 16, 0);
+	AddFilter(&mixes[5], COLUMN_MAX_PLAYERS, Table::QF_EQUAL, 16, 0);
+	// Filters on indexed columns the index cannot answer, next to one it can
+	AddFilter(&mixes[6], COLUMN_REGION, Table::QF_NOT_EQUAL, 0, "Asia");
+	AddFilter(&mixes[6], COLUMN_MAX_PLAYERS, Table::QF_LESS_THAN_EQ, 8, 0);
+	AddFilter(&mixes[6], COLUMN_PING, Table::QF_IS_EMPTY, 0, 0);
+
+	// Same rows, never indexed
+	Table unindexed;
+	unindexed=table;
+
+	if (isVerbose)
+		printf("Indexing columns\n");
+	for (unsigned columnIndex=COLUMN_GAME_MODE; columnIndex <= COLUMN_PING; columnIndex++)
+	{
+		if (table.AddIndex(columnIndex)==false || table.HasIndex(columnIndex)==false)
+		{
+			if (isVerbose)
+				DebugTools::ShowError(errorList[1-1],!noPauses && isVerbose,__LINE__,__FILE__);
+			return 1;
+		}
+	}
+	if (table.AddIndex(COLUMN_PING+1) || table.AddIndex(COLUMN_GAME_MODE))
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[1-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 1;
+	}
+
+	if (isVerbose)
+		printf("Comparing query results with and without indices\n");
+	if (SameQueryResults(table, unindexed, mixes, NUM_MIXES)==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[2-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 2;
+	}
+
+	if (isVerbose)
+		printf("Comparing query results after UpdateCell()\n");
+	for (int i=0; i < 5000; i++)
+	{
+		unsigned updatedRowId=Random(NUM_ROWS);
+		int players=(int) Random(17);
+		table.UpdateCell(updatedRowId, COLUMN_PLAYERS, players);
+		unindexed.UpdateCell(updatedRowId, COLUMN_PLAYERS, players);
+		if (i%4==0)
+		{
+			char *region=(char *) regions[Random(sizeof(regions)/sizeof(regions[0]))];
+			table.UpdateCell(updatedRowId, COLUMN_REGION, region);
+			unindexed.UpdateCell(updatedRowId, COLUMN_REGION, region);
+		}
+		// Queries between updates, as a room browser does while rooms fill
+		if (i%1000==0 && SameQueryResults(table, unindexed, mixes, NUM_MIXES)==false)
+		{
+			if (isVerbose)
+				DebugTools::ShowError(errorList[3-1],!noPauses && isVerbose,__LINE__,__FILE__);
+			return 3;
+		}
+	}
+	if (SameQueryResults(table, unindexed, mixes, NUM_MIXES)==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[3-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 3;
+	}
+
+	if (isVerbose)
+		printf("Comparing query results after RemoveRow() and AddRow()\n");
+	for (int i=0; i < 2000; i++)
+	{
+		unsigned removedRowId=Random(NUM_ROWS);
+		table.RemoveRow(removedRowId);
+		unindexed.RemoveRow(removedRowId);
+	}
+	for (rowId=NUM_ROWS; rowId < NUM_ROWS+2000; rowId++)
+	{
+		unsigned int savedSeed=seed;
+		FillRow(table.AddRow(rowId));
+		table.UpdateIndices(rowId);
+		seed=savedSeed;
+		FillRow(unindexed.AddRow(rowId));
+	}
+	// Rows added empty are only found by QF_IS_EMPTY
+	for (; rowId < NUM_ROWS+2100; rowId++)
+	{
+		table.AddRow(rowId);
+		unindexed.AddRow(rowId);
+	}
+	if (SameQueryResults(table, unindexed, mixes, NUM_MIXES)==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[4-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 4;
+	}
+
+	if (isVerbose)
+		printf("Comparing query results after writing to Row::cells\n");
+	for (int i=0; i < 1000; i++)
+	{
+		unsigned updatedRowId=Random(NUM_ROWS+2000);
+		double skill=(double) Random(3000);
+		Table::Row *row=table.GetRowByID(updatedRowId);
+		if (row==0)
+			continue;
+		row->UpdateCell(COLUMN_SKILL, skill);
+		table.UpdateIndices(updatedRowId);
+		unindexed.GetRowByID(updatedRowId)->UpdateCell(COLUMN_SKILL, skill);
+	}
+	if (SameQueryResults(table, unindexed, mixes, NUM_MIXES)==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[5-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 5;
+	}
+
+	return 0;
+}
+
+RakString TableIndexTest::GetTestName()
+{
+
+	return "TableIndexTest";
+
+}
+
+RakString TableIndexTest::ErrorCodeToString(int errorCode)
+{
+
+	if (errorCode>0&&(unsigned int)errorCode<=errorList.Size())
+	{
+		return errorList[errorCode-1];
+	}
+	else
+	{
+		return "Undefined Error";
+	}
+
+}
+
+void TableIndexTest::DestroyPeers()
+{
+}
+
+TableIndexTest::TableIndexTest(void)
+{
+
+	errorList.Push("AddIndex failed for a column it should index, or indexed a column it should not",_FILE_AND_LINE_);
+	errorList.Push("Indexed query returned different rows",_FILE_AND_LINE_);
+	errorList.Push("Indexed query returned different rows after UpdateCell",_FILE_AND_LINE_);
+	errorList.Push("Indexed query returned different rows after RemoveRow and AddRow",_FILE_AND_LINE_);
+	errorList.Push("Indexed query returned different rows after UpdateIndices",_FILE_AND_LINE_);
+
+}
+
+TableIndexTest::~TableIndexTest(void)
+{
+}
@@ -55,6 +55,15 @@ int main(int argc, char *argv[])
 	testList.Push(new SystemAddressAndGuidTest(),_FILE_AND_LINE_);	
 	testList.Push(new PacketAndLowLevelTestsTest(),_FILE_AND_LINE_);
 	testList.Push(new MiscellaneousTestsTest(),_FILE_AND_LINE_);
+	testList.Push(new SerializationTest(),_FILE_AND_LINE_);
+	testList.Push(new NetworkIDManagerTest(),_FILE_AND_LINE_);
+	testList.Push(new TableIndexTest(),_FILE_AND_LINE_);
+	testList.Push(new PluginDispatchTest(),_FILE_AND_LINE_);
+	testList.Push(new CloudServerTest(),_FILE_AND_LINE_);
+	testList.Push(new NatPunchthroughServerTest(),_FILE_AND_LINE_);
+	testList.Push(new FileListScanTest(),_FILE_AND_LINE_);
+	testList.Push(new SendToListTest(),_FILE_AND_LINE_);
+	testList.Push(new UpdateShardsTest(),_FILE_AND_LINE_);
 
 	testListSize=testList.Size();
 
@@ -0,0 +1,343 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "UpdateShardsTest.h"
+
+#include <string.h>
+
+/*
+Description:
+Tests that a server with RakPeerInterface::SetNumberOfUpdateShards() echoes the messages of many clients in order and unchanged, with 1, 2 and 4 shards.
+Clients connect over the loopback address and each sends reliable ordered messages, some large enough to be split, which the server sends back.
+With LIBCAT_SECURITY, also runs every shard count with secure connections. The server answers the challenges on handshake threads with a short queue,
+so some challenges are dropped and the clients have to resend them. Before that, tests that ChaChaOutput::CryptMany() gives the same bytes as ChaChaOutput::Crypt(),
+as the shards decrypt the datagrams from one system together.
+
+Success conditions:
+Every client connects, and gets every message back in order and unchanged.
+CryptMany() gives the same bytes as Crypt().
+
+Failure conditions:
+A client does not connect, or the handshake threads failed a challenge.
+An echo is missing, out of order or changed.
+CryptMany() gives different bytes than Crypt().
+
+*/
+
+static const unsigned int NUM_CLIENTS=16;
+static const unsigned int shardCounts[]={1, 2, 4};
+static const unsigned int MESSAGES_PER_CLIENT=50;
+// Messages a client sent that did not come back yet
+static const unsigned int MAX_MESSAGES_IN_FLIGHT=16;
+static const RakNet::TimeMS TIMEOUT_MS=30000;
+
+static unsigned int MessageSize(unsigned int messageIndex)
+{
+	// Every fifth message is split
+	return messageIndex%5==0 ? 2000 : 64;
+}
+
+static unsigned char PayloadByte(unsigned int clientIndex, unsigned int messageIndex, unsigned int offset)
+{
+	return (unsigned char) (clientIndex*7+messageIndex*31+offset);
+}
+
+static void WriteMessage(BitStream *bs, unsigned int clientIndex, unsigned int messageIndex)
+{
+	bs->Reset();
+	bs->Write((MessageID) ID_USER_PACKET_ENUM);
+	bs->Write(clientIndex);
+	bs->Write(messageIndex);
+	for (unsigned int i=1+sizeof(clientIndex)+sizeof(messageIndex); i < MessageSize(messageIndex); i++)
+		bs->Write(PayloadByte(clientIndex, messageIndex, i));
+}
+
+static bool CheckMessage(Packet *packet, unsigned int clientIndex, unsigned int messageIndex)
+{
+	if (packet->length!=MessageSize(messageIndex))
+		return false;
+	BitStream bsIn(packet->data, packet->length, false);
+	bsIn.IgnoreBytes(sizeof(MessageID));
+	unsigned int readClientIndex, readMessageIndex;
+	bsIn.Read(readClientIndex);
+	bsIn.Read(readMessageIndex);
+	if (readClientIndex!=clientIndex || readMessageIndex!=messageIndex)
+		return false;
+	for (unsigned int i=1+sizeof(clientIndex)+sizeof(messageIndex); i < packet->length; i++)
+	{
+		if (packet->data[i]!=PayloadByte(clientIndex, messageIndex, i))
+			return false;
+	}
+	return true;
+}
+
+#if LIBCAT_SECURITY==1
+static unsigned int seed=42;
+static unsigned int Random(unsigned int range)
+{
+	seed=seed*1103515245+12345;
+	return ((seed>>8) ^ (seed<<14))%range;
+}
+
+// Crypts random batches with CryptMany() and each message on its own with Crypt(), and compares them.
+// Every third batch ends with an empty message, after which the blocks of the earlier messages must still be crypted.
+static bool CheckCryptMany(void)
+{
+	static const int MAX_BATCH=20;
+	static const int MAX_BYTES=1500;
+	static const int NUM_BATCHES=2000;
+
+	cat::u8 keyBytes[32];
+	for (int i=0; i < 32; i++)
+		keyBytes[i]=(cat::u8) Random(256);
+	cat::ChaChaKey key;
+	key.Set(keyBytes, sizeof(keyBytes));
+
+	static cat::u8 batch[MAX_BATCH][MAX_BYTES], single[MAX_BATCH][MAX_BYTES];
+	cat::u8 *buffers[MAX_BATCH];
+	int bytes[MAX_BATCH];
+	cat::u64 ivs[MAX_BATCH];
+	for (int i=0; i < NUM_BATCHES; i++)
+	{
+		int count=1+(int) Random(MAX_BATCH);
+		for (int j=0; j < count; j++)
+		{
+			bytes[j]=(int) Random(i%2 ? MAX_BYTES : 200);
+			if (i%3==0 && j==count-1)
+				bytes[j]=0;
+			for (int k=0; k < bytes[j]; k++)
+				batch[j][k]=single[j][k]=(cat::u8) Random(256);
+			buffers[j]=batch[j];
+			ivs[j]=((cat::u64) Random(0xFFFFFFFF) << 32) | (cat::u64) (i*MAX_BATCH+j);
+
+			cat::ChaChaOutput output(key, ivs[j]);
+			output.Crypt(single[j], single[j], bytes[j]);
+		}
+
+		cat::ChaChaOutput::CryptMany(key, ivs, buffers, bytes, count);
+		for (int j=0; j < count; j++)
+		{
+			if (memcmp(batch[j], single[j], bytes[j])!=0)
+				return false;
+		}
+	}
+	return true;
+}
+#endif
+
+// Returns 0 if every echo came back, or the error code
+int UpdateShardsTest::RunEcho(unsigned int shardCount, char *publicKey, char *privateKey)
+{
+	RakPeerInterface *server=RakPeerInterface::GetInstance();
+	destroyList.Push(server,_FILE_AND_LINE_);
+	server->SetNumberOfUpdateShards(shardCount);
+#if LIBCAT_SECURITY==1
+	if (publicKey)
+	{
+		server->InitializeSecurity(publicKey, privateKey);
+		server->SetSecureHandshakeThreads(2, 4);
+	}
+#else
+	(void) publicKey;
+	(void) privateKey;
+#endif
+	SocketDescriptor socketDescriptor(0, "127.0.0.1");
+	server->Startup(NUM_CLIENTS, &socketDescriptor, 1);
+	server->SetMaximumIncomingConnections((unsigned short) NUM_CLIENTS);
+
+	RakPeerInterface *clients[NUM_CLIENTS];
+	unsigned int sentCounts[NUM_CLIENTS], receivedCounts[NUM_CLIENTS];
+	unsigned int i;
+	for (i=0; i < NUM_CLIENTS; i++)
+	{
+		clients[i]=RakPeerInterface::GetInstance();
+		destroyList.Push(clients[i],_FILE_AND_LINE_);
+		SocketDescriptor clientSocketDescriptor(0, "127.0.0.1");
+		clients[i]->Startup(1, &clientSocketDescriptor, 1);
+#if LIBCAT_SECURITY==1
+		PublicKey pk;
+		pk.remoteServerPublicKey=publicKey;
+		pk.publicKeyMode=PKM_USE_KNOWN_PUBLIC_KEY;
+		clients[i]->Connect("127.0.0.1", server->GetMyBoundAddress().GetPort(), 0, 0, publicKey ? &pk : 0);
+#else
+		clients[i]->Connect("127.0.0.1", server->GetMyBoundAddress().GetPort(), 0, 0);
+#endif
+		sentCounts[i]=0;
+		receivedCounts[i]=0;
+	}
+
+	Packet *packet;
+	unsigned int connectedCount=0;
+	RakNet::TimeMS startTime=RakNet::GetTimeMS();
+	while (connectedCount < NUM_CLIENTS && RakNet::GetTimeMS()-startTime < TIMEOUT_MS)
+	{
+		for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+		{
+			if (packet->data[0]==ID_NEW_INCOMING_CONNECTION)
+				connectedCount++;
+		}
+		for (i=0; i < NUM_CLIENTS; i++)
+		{
+			for (packet=clients[i]->Receive(); packet; clients[i]->DeallocatePacket(packet), packet=clients[i]->Receive())
+				;
+		}
+		RakSleep(10);
+	}
+	if (connectedCount!=NUM_CLIENTS)
+		return 1;
+#if LIBCAT_SECURITY==1
+	if (publicKey)
+	{
+		uint32_t answeredCount, failedCount, droppedCount;
+		unsigned int queueLength, maxQueueLength;
+		server->GetSecureHandshakeStatistics(&answeredCount, &failedCount, &droppedCount, &queueLength, &maxQueueLength);
+		if (answeredCount < NUM_CLIENTS || failedCount!=0)
+			return 1;
+	}
+#endif
+
+	BitStream bs;
+	bool matches=true;
+	unsigned int doneCount=0;
+	startTime=RakNet::GetTimeMS();
+	while (matches && doneCount < NUM_CLIENTS && RakNet::GetTimeMS()-startTime < TIMEOUT_MS)
+	{
+		for (i=0; i < NUM_CLIENTS; i++)
+		{
+			while (sentCounts[i] < MESSAGES_PER_CLIENT && sentCounts[i]-receivedCounts[i] < MAX_MESSAGES_IN_FLIGHT)
+			{
+				WriteMessage(&bs, i, sentCounts[i]);
+				clients[i]->Send(&bs, HIGH_PRIORITY, RELIABLE_ORDERED, 0, UNASSIGNED_SYSTEM_ADDRESS, true);
+				sentCounts[i]++;
+			}
+		}
+
+		for (packet=server->Receive(); packet; server->DeallocatePacket(packet), packet=server->Receive())
+		{
+			if (packet->data[0]==ID_USER_PACKET_ENUM)
+				server->Send((const char*) packet->data, (int) packet->length, HIGH_PRIORITY, RELIABLE_ORDERED, 0, packet->guid, false);
+		}
+
+		for (i=0; i < NUM_CLIENTS; i++)
+		{
+			for (packet=clients[i]->Receive(); packet; clients[i]->DeallocatePacket(packet), packet=clients[i]->Receive())
+			{
+				if (packet->data[0]!=ID_USER_PACKET_ENUM)
+					continue;
+				if (CheckMessage(packet, i, receivedCounts[i])==false)
+					matches=false;
+				if (++receivedCounts[i]==MESSAGES_PER_CLIENT)
+					doneCount++;
+			}
+		}
+		RakSleep(1);
+	}
+	if (matches==false || doneCount!=NUM_CLIENTS)
+		return 2;
+
+	DestroyPeers();
+	return 0;
+}
+
+int UpdateShardsTest::RunTest(DataStructures::List<RakString> params,bool isVerbose,bool noPauses)
+{
+	(void) params;
+
+	unsigned int i;
+	int errorCode;
+	for (i=0; i < sizeof(shardCounts)/sizeof(shardCounts[0]); i++)
+	{
+		if (isVerbose)
+			printf("Echoing with %u update shards\n", shardCounts[i]);
+		errorCode=RunEcho(shardCounts[i], 0, 0);
+		if (errorCode!=0)
+		{
+			if (isVerbose)
+				DebugTools::ShowError(errorList[errorCode-1],!noPauses && isVerbose,__LINE__,__FILE__);
+			return errorCode;
+		}
+	}
+
+#if LIBCAT_SECURITY==1
+	if (isVerbose)
+		printf("Testing ChaChaOutput::CryptMany()\n");
+	if (CheckCryptMany()==false)
+	{
+		if (isVerbose)
+			DebugTools::ShowError(errorList[3-1],!noPauses && isVerbose,__LINE__,__FILE__);
+		return 3;
+	}
+
+	cat::EasyHandshake handshake;
+	char publicKey[cat::EasyHandshake::PUBLIC_KEY_BYTES];
+	char privateKey[cat::EasyHandshake::PRIVATE_KEY_BYTES];
+	handshake.GenerateServerKey(publicKey, privateKey);
+	for (i=0; i < sizeof(shardCounts)/sizeof(shardCounts[0]); i++)
+	{
+		if (isVerbose)
+			printf("Echoing with %u update shards over secure connections\n", shardCounts[i]);
+		errorCode=RunEcho(shardCounts[i], publicKey, privateKey);
+		if (errorCode!=0)
+		{
+			errorCode+=3;
+			if (isVerbose)
+				DebugTools::ShowError(errorList[errorCode-1],!noPauses && isVerbose,__LINE__,__FILE__);
+			return errorCode;
+		}
+	}
+#endif
+
+	return 0;
+}
+
+RakString UpdateShardsTest::GetTestName()
+{
+
+	return "UpdateShardsTest";
+
+}
+
+RakString UpdateShardsTest::ErrorCodeToString(int errorCode)
+{
+
+	if (errorCode>0&&(unsigned int)errorCode<=errorList.Size())
+	{
+		return errorList[errorCode-1];
+	}
+	else
+	{
+		return "Undefined Error";
+	}
+
+}
+
+void UpdateShardsTest::DestroyPeers()
+{
+
+	int theSize=destroyList.Size();
+
+	for (int i=0; i < theSize; i++)
+		RakPeerInterface::DestroyInstance(destroyList[i]);
+
+	destroyList.Clear(false,_FILE_AND_LINE_);
+
+}
+
+UpdateShardsTest::UpdateShardsTest(void)
+{
+
+	errorList.Push("Clients did not connect to the server",_FILE_AND_LINE_);
+	errorList.Push("Clients did not get every message back in order and unchanged",_FILE_AND_LINE_);
+	errorList.Push("ChaChaOutput::CryptMany gave different bytes than ChaChaOutput::Crypt",_FILE_AND_LINE_);
+	errorList.Push("Clients did not connect securely, or the handshake threads failed a challenge",_FILE_AND_LINE_);
+	errorList.Push("Clients did not get every message back in order and unchanged over secure connections",_FILE_AND_LINE_);
+
+}
+
+UpdateShardsTest::~UpdateShardsTest(void)
+{
+}
@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file BanList.h
+/// \internal
+/// \brief The list of banned addresses and address ranges of RakPeer
+///
+
+#ifndef __BAN_LIST_H
+#define __BAN_LIST_H
+
+#include "Export.h"
+#include "types.h"
+#include "DS_List.h"
+#include "SimpleMutex.h"
+#include "LocklessTypes.h"
+
+namespace SLNet
+{
+
+/// \internal
+/// \brief The list of banned addresses and address ranges of RakPeer
+/// \details Bans are parsed into binary prefixes of IPv6 addresses, with IPv4 addresses mapped to ::ffff:0:0/96. Understood are addresses such as
+/// 128.0.0.1 or 2001:db8::1, CIDR ranges such as 128.0.0.0/8 or 2001:db8::/32, and IPv4 wildcards that replace whole numbers such as 128.0.* .
+/// The prefixes are kept in an open addressing hash table keyed on the prefix and its length. A lookup probes the table once for each prefix length
+/// in use, so its cost does not depend on how many bans there are. Other patterns, such as 12*, are compared character by character as they always were.
+///
+/// IsBanned() does not lock a mutex, unless such patterns are in the list. Changes are serialized by a mutex and published with atomic stores.
+/// Memory a reader may still be using is freed by a later change, once no reader is active.
+/// Expired temporary bans are ignored by IsBanned(), and dropped the next time the table is rebuilt.
+class RAK_DLL_EXPORT BanList
+{
+public:
+	BanList();
+	~BanList();
+
+	/// \param[in] pattern Address, CIDR range or wildcard pattern.
+	/// \param[in] milliseconds How long the ban lasts. 0 for a permanent ban.
+	/// \return false if \a pattern is not understood
+	bool Add( const char *pattern, SLNet::TimeMS milliseconds );
+
+	/// Removes a ban added with the same pattern
+	void Remove( const char *pattern );
+
+	void Clear( void );
+
+	/// \param[in] pattern An address, or a range of addresses written like in Add()
+	/// \return true if all addresses in \a pattern are banned
+	bool IsBanned( const char *pattern );
+	bool IsBanned( const SystemAddress &systemAddress );
+
+	/// \return The number of bans, including expired ones that were not dropped yet
+	unsigned int Size( void ) const;
+
+protected:
+	static const int PREFIX_BYTES=16;
+
+	struct Entry
+	{
+		unsigned char prefix[PREFIX_BYTES];
+		unsigned char prefixLength;
+		SLNet::TimeMS timeout; // 0 for none
+	};
+	struct Table
+	{
+		// Power of two
+		unsigned int capacity;
+		LocklessPointer<Entry> *slots;
+	};
+	// The distinct prefix lengths in the table, in descending order
+	struct PrefixLengths
+	{
+		unsigned char lengths[PREFIX_BYTES*8+1];
+		unsigned int count;
+	};
+	struct Pattern
+	{
+		char pattern[16];
+		SLNet::TimeMS timeout; // 0 for none
+	};
+
+	// Marks a slot whose entry was removed, so that probing continues past it
+	static Entry tombstone;
+
+	static bool Parse( const char *pattern, unsigned char prefix[PREFIX_BYTES], unsigned char *prefixLength );
+	static void MaskPrefix( unsigned char prefix[PREFIX_BYTES], unsigned char prefixLength );
+	static unsigned int HashPrefix( const unsigned char prefix[PREFIX_BYTES], unsigned char prefixLength );
+	static bool IsExpired( SLNet::TimeMS timeout, SLNet::TimeMS time );
+	static bool MatchesPattern( const char *pattern, const char *IP );
+
+	bool IsPrefixBanned( const unsigned char prefix[PREFIX_BYTES], unsigned char prefixLength, const char *IP );
+	bool IsPatternBanned( const char *IP );
+	// Also returns the entry that was found in the slot, which readers must use rather than load the slot again while Remove() may change it
+	LocklessPointer<Entry> *FindSlot( Table *table, const unsigned char prefix[PREFIX_BYTES], unsigned char prefixLength, Entry **entry ) const;
+	Table *AllocateTable( unsigned int capacity ) const;
+	void Rebuild( unsigned int minimumCapacity );
+	void PublishPrefixLengths( void );
+	void FreeRetired( bool force );
+
+	// Read without a mutex
+	LocklessPointer<Table> table;
+	LocklessPointer<PrefixLengths> prefixLengths;
+	LocklessUint32_t activeReaders;
+	LocklessUint32_t patternsSize;
+
+	// Guards everything below, and all changes to the members above
+	SimpleMutex mutex;
+	// Entries in use, and entries and tombstones in use
+	unsigned int tableSize, tableSlotsUsed;
+	unsigned int prefixLengthCounts[PREFIX_BYTES*8+1];
+	DataStructures::List<Table*> retiredTables;
+	DataStructures::List<Entry*> retiredEntries;
+	DataStructures::List<PrefixLengths*> retiredPrefixLengths;
+	DataStructures::List<Pattern*> patterns;
+};
+
+} // namespace SLNet
+
+#endif
@@ -539,6 +539,12 @@ namespace SLNet
 		/// \return The length in bits of the stream.
 		BitSize_t CopyData( unsigned char** _data ) const;
 
+		/// \brief Same as CopyData(), but hands over the internal data instead of copying it, if the stream allocated it.
+		/// \details The stream is empty afterwards. Free \a _data with rakFree_Ex().
+		/// \param[out] _data The internal data, or an allocated copy of it
+		/// \return The length in bits of the stream.
+		BitSize_t MoveData( unsigned char** _data );
+
 		/// \internal
 		/// Set the stream to some initial data.
 		void SetData( unsigned char *inByteArray );
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/*
+Congestion control in the style of BBR (Cardwell et al., "BBR: Congestion-Based Congestion Control", ACM Queue 2016)
+
+Rather than reacting to loss, the sender keeps a model of the path:
+btlBw = the highest delivery rate measured over the last 10 round trips
+minRtt = the lowest round trip time measured over the last 10 seconds
+
+Sends are paced at pacingGain*btlBw, and the bytes in flight are limited to cwndGain*btlBw*minRtt.
+
+Startup:
+pacingGain=cwndGain=2.885, which doubles the delivery rate every round trip, until btlBw did not grow by 25% in 3 round trips
+Drain:
+pacingGain=1/2.885, until the queue built in startup is gone
+ProbeBW:
+pacingGain cycles through 1.25, 0.75, 1, 1, 1, 1, 1, 1, one phase per minRtt, to find more bandwidth and drain what it queued
+ProbeRTT:
+If minRtt was not measured again for 10 seconds, send with a window of 4 datagrams for 200 ms, so that the queue drains and minRtt can be measured
+
+Loss does not change the model, so random loss on a wireless link does not collapse the send rate like it does with CCRakNetSlidingWindow.
+*/
+
+#ifndef __CONGESTION_CONTROL_BBR_H
+#define __CONGESTION_CONTROL_BBR_H
+
+#include "CCRakNetSlidingWindow.h"
+#include "Rand.h"
+
+namespace SLNet
+{
+
+/// \brief Congestion control from a model of the bottleneck bandwidth and round trip time, with packet pacing
+/// \details Receiving, acks, datagram numbering and retransmission timeouts work like CCRakNetSlidingWindow, so either end of a connection can use either controller.
+class CCRakNetBBR : public CCRakNetSlidingWindow
+{
+	public:
+
+	CCRakNetBBR();
+	virtual ~CCRakNetBBR();
+
+	virtual void Init(CCTimeType curTime, uint32_t maxDatagramPayload);
+	virtual void Update(CCTimeType curTime, bool hasDataToSendOrResend);
+
+	/// Limited by the pacing rate and the congestion window
+	virtual int GetRetransmissionBandwidth(CCTimeType curTime, CCTimeType timeSinceLastTick, uint32_t unacknowledgedBytes, bool isContinuousSend);
+	virtual int GetTransmissionBandwidth(CCTimeType curTime, CCTimeType timeSinceLastTick, uint32_t unacknowledgedBytes, bool isContinuousSend);
+	/// When the pacing rate allows the next full datagram
+	virtual CCTimeType GetNextTransmissionTime(CCTimeType curTime) const;
+
+	virtual void OnSendBytes(CCTimeType curTime, uint32_t numBytes);
+	/// Records the delivery state when the datagram was sent, to measure the delivery rate when it is acked
+	virtual void OnSendDatagram(CCTimeType curTime, DatagramSequenceNumberType datagramSequenceNumber, uint32_t numBytes, bool isContinuousSend);
+
+	/// Loss does not change the model
+	virtual void OnResend(CCTimeType curTime, SLNet::TimeUS nextActionTime);
+	virtual void OnNAK(CCTimeType curTime, DatagramSequenceNumberType nakSequenceNumber);
+
+	/// Only updates the round trip time used for retransmissions
+	virtual void OnAck(CCTimeType curTime, CCTimeType rtt, bool hasBAndAS, BytesPerMicrosecond _B, BytesPerMicrosecond _AS, double totalUserDataBytesAcked, bool isContinuousSend, DatagramSequenceNumberType sequenceNumber );
+	/// Takes a delivery rate and round trip time sample, and updates the model
+	virtual void OnAckDatagram(CCTimeType curTime, DatagramSequenceNumberType sequenceNumber);
+
+	virtual bool GetIsInSlowStart(void) const {return mode==STARTUP;}
+	/// The pacing rate
+	virtual uint64_t GetBytesPerSecondLimitByCongestionControl(void) const;
+	/// The pacing rate. Sends are already paced by GetTransmissionBandwidth(), so this is only used when ReliabilityLayer paces as well
+	virtual double GetPacingRate(void) const;
+
+	/// Query for statistics
+	BytesPerMicrosecond GetBottleneckBandwidth(void) const;
+	CCTimeType GetMinRTT(void) const {return minRtt;}
+
+	protected:
+
+	enum Mode
+	{
+		STARTUP,
+		DRAIN,
+		PROBE_BW,
+		PROBE_RTT
+	} mode;
+
+	// The state of one datagram in flight
+	struct SentDatagram
+	{
+		CCTimeType sendTime;
+		// firstSendTime, deliveredTime and delivered when this datagram was sent
+		CCTimeType firstSendTime;
+		CCTimeType deliveredTime;
+		uint64_t delivered;
+		DatagramSequenceNumberType sequenceNumber;
+		uint32_t numBytes;
+		// Nothing else waited to be sent, so the delivery rate measured for this datagram may be below btlBw
+		bool isAppLimited;
+		bool isInFlight;
+	};
+
+	static const int BTLBW_FILTER_ROUNDS=10;
+	static const int GAIN_CYCLE_LENGTH=8;
+
+	void RefillPacingTokens(CCTimeType curTime);
+	void UpdateBtlBw(double deliveryRate, bool isAppLimited);
+	void UpdateMinRTT(CCTimeType curTime, CCTimeType rtt);
+	void CheckFullPipe(bool isAppLimited);
+	void CheckDrain(CCTimeType curTime);
+	void UpdateGainCycle(CCTimeType curTime);
+	void CheckProbeRTT(CCTimeType curTime);
+	void UpdateCwnd(uint32_t bytesAcked);
+	void UpdatePacingRate(void);
+	void EnterStartup(void);
+	void EnterProbeBW(CCTimeType curTime);
+	// btlBw*minRtt, plus the time the remote system may hold back acks
+	double GetBDP(void) const;
+	double GetMinCwnd(void) const;
+	// Doubles sentDatagrams, up to RESEND_BUFFER_ARRAY_LENGTH. Returns false if it is that long already
+	bool GrowSentDatagrams(void);
+
+	// Indexed by sequence number modulo sentDatagramsLength. Starts with DATAGRAM_MESSAGE_ID_ARRAY_LENGTH entries, and grows while
+	// more datagrams are in flight, as ReliabilityLayer keeps acks for as many datagrams as its resend buffer holds messages
+	SentDatagram *sentDatagrams;
+	unsigned int sentDatagramsLength;
+	unsigned int datagramsInFlight;
+	uint64_t bytesInFlight;
+
+	// Bytes acked over the lifetime of the connection, and when the last of them was acked
+	uint64_t delivered;
+	CCTimeType deliveredTime;
+	// Send time of the most recently acked datagram
+	CCTimeType firstSendTime;
+
+	// A round trip ends when a datagram sent after the previous end is acked
+	uint32_t roundCount;
+	uint64_t nextRoundDelivered;
+	bool roundStart;
+
+	// Highest delivery rate for each of the last BTLBW_FILTER_ROUNDS round trips, in bytes per CCTimeType unit
+	double btlBwFilter[BTLBW_FILTER_ROUNDS];
+	uint32_t btlBwFilterRound[BTLBW_FILTER_ROUNDS];
+	double btlBw;
+
+	CCTimeType minRtt;
+	CCTimeType minRttStamp;
+	bool minRttExpired;
+
+	// Startup ends after btlBw did not grow by 25% for 3 round trips
+	double fullBw;
+	int fullBwCount;
+	bool filledPipe;
+
+	double pacingGain, cwndGain;
+	int cycleIndex;
+	CCTimeType cycleStamp;
+
+	// Picks the first ProbeBW phase. The global randomMT() is not thread safe, and connections are updated on several threads
+	RakNetRandom rnr;
+
+	CCTimeType probeRttDoneStamp;
+	bool probeRttRoundDone;
+	double priorCwnd;
+
+	// Bytes per CCTimeType unit
+	double pacingRate;
+	// Bytes that may be sent now. Negative after a datagram larger than what was left
+	double pacingTokens;
+	CCTimeType lastPacingTime;
+};
+
+}
+
+#endif
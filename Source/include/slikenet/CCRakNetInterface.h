@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file CCRakNetInterface.h
+/// \brief The interface that the congestion control of each connection implements, and the controllers to choose from
+///
+
+#ifndef __CONGESTION_CONTROL_INTERFACE_H
+#define __CONGESTION_CONTROL_INTERFACE_H
+
+#include "defines.h"
+#include "NativeTypes.h"
+#include "time.h"
+#include "types.h"
+
+/// Sizeof an UDP header in byte
+#define UDP_HEADER_SIZE 28
+
+#define CC_DEBUG_PRINTF_1(x)
+#define CC_DEBUG_PRINTF_2(x,y)
+#define CC_DEBUG_PRINTF_3(x,y,z)
+#define CC_DEBUG_PRINTF_4(x,y,z,a)
+#define CC_DEBUG_PRINTF_5(x,y,z,a,b)
+//#define CC_DEBUG_PRINTF_1(x) printf(x)
+//#define CC_DEBUG_PRINTF_2(x,y) printf(x,y)
+//#define CC_DEBUG_PRINTF_3(x,y,z) printf(x,y,z)
+//#define CC_DEBUG_PRINTF_4(x,y,z,a) printf(x,y,z,a)
+//#define CC_DEBUG_PRINTF_5(x,y,z,a,b) printf(x,y,z,a,b)
+
+/// Set to 4 if you are using the iPod Touch TG. See http://www.jenkinssoftware.com/forum/index.php?topic=2717.0
+#define CC_TIME_TYPE_BYTES 8
+
+#if CC_TIME_TYPE_BYTES==8
+typedef SLNet::TimeUS CCTimeType;
+#else
+typedef SLNet::TimeMS CCTimeType;
+#endif
+
+typedef SLNet::uint24_t DatagramSequenceNumberType;
+typedef double BytesPerMicrosecond;
+typedef double BytesPerSecond;
+typedef double MicrosecondsPerByte;
+
+namespace SLNet
+{
+
+/// Which congestion control a connection uses. See RakPeerInterface::SetCongestionControl()
+enum CongestionControlType
+{
+	/// TCP style congestion window, which is halved on loss while sending continuously. See CCRakNetSlidingWindow
+	SLIDING_WINDOW_CONGESTION_CONTROL,
+
+	/// UDT, which adjusts the time between sends from packet pairs and losses. See CCRakNetUDT
+	UDT_CONGESTION_CONTROL,
+
+	/// Models the bottleneck bandwidth and round trip time of the path, and paces sends at that rate. Random loss does not slow it down. See CCRakNetBBR
+	BBR_CONGESTION_CONTROL
+};
+
+/// The controller of connections that did not choose one, selected by USE_SLIDING_WINDOW_CONGESTION_CONTROL
+#if USE_SLIDING_WINDOW_CONGESTION_CONTROL==1
+static const CongestionControlType DEFAULT_CONGESTION_CONTROL=SLIDING_WINDOW_CONGESTION_CONTROL;
+#else
+static const CongestionControlType DEFAULT_CONGESTION_CONTROL=UDT_CONGESTION_CONTROL;
+#endif
+
+/// \brief The congestion control of one connection, as used by ReliabilityLayer
+/// \details Besides congestion control, the controller numbers the datagrams of the connection, tracks which datagrams arrived in order, and decides when acks are sent.
+/// ReliabilityLayer holds one controller per connection and can replace it while the connection is open, so that the datagram numbering is carried over.
+/// See CCRakNetSlidingWindow for the order in which the methods are called.
+class CCRakNetInterface
+{
+public:
+	virtual ~CCRakNetInterface() {}
+
+	/// Reset all variables to their initial states, for a new connection
+	virtual void Init(CCTimeType curTime, uint32_t maxDatagramPayload)=0;
+
+	/// Update over time
+	virtual void Update(CCTimeType curTime, bool hasDataToSendOrResend)=0;
+
+	virtual int GetRetransmissionBandwidth(CCTimeType curTime, CCTimeType timeSinceLastTick, uint32_t unacknowledgedBytes, bool isContinuousSend)=0;
+	virtual int GetTransmissionBandwidth(CCTimeType curTime, CCTimeType timeSinceLastTick, uint32_t unacknowledgedBytes, bool isContinuousSend)=0;
+
+	/// While data waits because GetTransmissionBandwidth() returned 0, the update thread sleeps until this time at the latest
+	/// Controllers that pace their sends return when the next datagram may go out. Defaults to 10 milliseconds from now
+	virtual CCTimeType GetNextTransmissionTime(CCTimeType curTime) const;
+
+	/// Should call once per update tick, and send buffered acks if this returns true
+	virtual bool ShouldSendACKs(CCTimeType curTime, CCTimeType estimatedTimeToNextTick)=0;
+
+	/// Latest time at which ShouldSendACKs() returns true for the acks buffered so far
+	virtual CCTimeType GetNextACKTime(CCTimeType curTime) const=0;
+
+	/// Every data packet sent must contain a sequence number
+	virtual DatagramSequenceNumberType GetAndIncrementNextDatagramSequenceNumber(void)=0;
+	virtual DatagramSequenceNumberType GetNextDatagramSequenceNumber(void)=0;
+	/// The sequence number of the next datagram that should arrive from the remote system
+	virtual DatagramSequenceNumberType GetExpectedNextDatagramSequenceNumber(void) const=0;
+	/// Continue the numbering of a controller that this one replaces. Call after Init()
+	virtual void SetDatagramSequenceNumbers(DatagramSequenceNumberType nextDatagramSequenceNumber, DatagramSequenceNumberType expectedNextSequenceNumber)=0;
+
+	/// Call this when you send a message, and with the size of the headers of each datagram
+	virtual void OnSendBytes(CCTimeType curTime, uint32_t numBytes)=0;
+	/// Call this after sending a datagram with a sequence number, with its size including the UDP header. Does nothing by default
+	virtual void OnSendDatagram(CCTimeType curTime, DatagramSequenceNumberType datagramSequenceNumber, uint32_t numBytes, bool isContinuousSend);
+
+	/// Call this when you get a packet pair
+	virtual void OnGotPacketPair(DatagramSequenceNumberType datagramSequenceNumber, uint32_t sizeInBytes, CCTimeType curTime)=0;
+
+	/// Call this when you get a packet (including packet pairs)
+	/// If the DatagramSequenceNumberType is out of order, skippedMessageCount will be non-zero
+	virtual bool OnGotPacket(DatagramSequenceNumberType datagramSequenceNumber, bool isContinuousSend, CCTimeType curTime, uint32_t sizeInBytes, uint32_t *skippedMessageCount)=0;
+
+	/// Call when you get a NAK, with the sequence number of the lost message
+	virtual void OnResend(CCTimeType curTime, SLNet::TimeUS nextActionTime)=0;
+	virtual void OnNAK(CCTimeType curTime, DatagramSequenceNumberType nakSequenceNumber)=0;
+
+	/// Call this when an ACK arrives for a datagram that held reliable messages
+	virtual void OnAck(CCTimeType curTime, CCTimeType rtt, bool hasBAndAS, BytesPerMicrosecond _B, BytesPerMicrosecond _AS, double totalUserDataBytesAcked, bool isContinuousSend, DatagramSequenceNumberType sequenceNumber )=0;
+	virtual void OnDuplicateAck( CCTimeType curTime, DatagramSequenceNumberType sequenceNumber )=0;
+	/// Call this when an ACK arrives for any datagram that is still in the datagram history, reliable or not. Does nothing by default
+	virtual void OnAckDatagram(CCTimeType curTime, DatagramSequenceNumberType sequenceNumber);
+
+	/// Call when you send an ack, to see if the ack should have the B and AS parameters transmitted
+	virtual void OnSendAckGetBAndAS(CCTimeType curTime, bool *hasBAndAS, BytesPerMicrosecond *_B, BytesPerMicrosecond *_AS)=0;
+	/// Call when we send an ack
+	virtual void OnSendAck(CCTimeType curTime, uint32_t numBytes)=0;
+	/// Call when we send a NACK
+	virtual void OnSendNACK(CCTimeType curTime, uint32_t numBytes)=0;
+
+	/// Retransmission time out for the sender
+	virtual CCTimeType GetRTOForRetransmission(unsigned char timesSent) const=0;
+
+	/// Set the maximum amount of data that can be sent in one datagram
+	virtual void SetMTU(uint32_t bytes)=0;
+	/// Return what was set by SetMTU()
+	virtual uint32_t GetMTU(void) const=0;
+
+	/// Query for statistics
+	virtual double GetRTT(void) const=0;
+	virtual bool GetIsInSlowStart(void) const=0;
+	virtual uint64_t GetBytesPerSecondLimitByCongestionControl(void) const=0;
+	/// Bytes per second at which ReliabilityLayer spreads sends out when pacing is enabled, or 0 while the controller has no estimate
+	/// Somewhat above the rate the controller expects to send at, so that pacing does not become the limit
+	virtual double GetPacingRate(void) const=0;
+
+	/// Is a > b, accounting for variable overflow?
+	static bool GreaterThan(DatagramSequenceNumberType a, DatagramSequenceNumberType b);
+	/// Is a < b, accounting for variable overflow?
+	static bool LessThan(DatagramSequenceNumberType a, DatagramSequenceNumberType b);
+};
+
+}
+
+#endif
@@ -40,116 +40,88 @@ else use congestion avoidance
 
 */
 
-#include "defines.h"
-
-#if USE_SLIDING_WINDOW_CONGESTION_CONTROL==1
-
 #ifndef __CONGESTION_CONTROL_SLIDING_WINDOW_H
 #define __CONGESTION_CONTROL_SLIDING_WINDOW_H
 
-#include "NativeTypes.h"
-#include "time.h"
-#include "types.h"
+#include "CCRakNetInterface.h"
 #include "DS_Queue.h"
 
-/// Sizeof an UDP header in byte
-#define UDP_HEADER_SIZE 28
-
-#define CC_DEBUG_PRINTF_1(x)
-#define CC_DEBUG_PRINTF_2(x,y)
-#define CC_DEBUG_PRINTF_3(x,y,z)
-#define CC_DEBUG_PRINTF_4(x,y,z,a)
-#define CC_DEBUG_PRINTF_5(x,y,z,a,b)
-//#define CC_DEBUG_PRINTF_1(x) printf(x)
-//#define CC_DEBUG_PRINTF_2(x,y) printf(x,y)
-//#define CC_DEBUG_PRINTF_3(x,y,z) printf(x,y,z)
-//#define CC_DEBUG_PRINTF_4(x,y,z,a) printf(x,y,z,a)
-//#define CC_DEBUG_PRINTF_5(x,y,z,a,b) printf(x,y,z,a,b)
-
-/// Set to 4 if you are using the iPod Touch TG. See http://www.jenkinssoftware.com/forum/index.php?topic=2717.0
-#define CC_TIME_TYPE_BYTES 8
-
-#if CC_TIME_TYPE_BYTES==8
-typedef SLNet::TimeUS CCTimeType;
-#else
-typedef SLNet::TimeMS CCTimeType;
-#endif
-
-typedef SLNet::uint24_t DatagramSequenceNumberType;
-typedef double BytesPerMicrosecond;
-typedef double BytesPerSecond;
-typedef double MicrosecondsPerByte;
-
 namespace SLNet
 {
 
-class CCRakNetSlidingWindow
+class CCRakNetSlidingWindow : public CCRakNetInterface
 {
 	public:
 	
 	CCRakNetSlidingWindow();
-	~CCRakNetSlidingWindow();
+	virtual ~CCRakNetSlidingWindow();
 
 	/// Reset all variables to their initial states, for a new connection
-	void Init(CCTimeType curTime, uint32_t maxDatagramPayload);
+	virtual void Init(CCTimeType curTime, uint32_t maxDatagramPayload);
 
 	/// Update over time
-	void Update(CCTimeType curTime, bool hasDataToSendOrResend);
+	virtual void Update(CCTimeType curTime, bool hasDataToSendOrResend);
 
-	int GetRetransmissionBandwidth(CCTimeType curTime, CCTimeType timeSinceLastTick, uint32_t unacknowledgedBytes, bool isContinuousSend);
-	int GetTransmissionBandwidth(CCTimeType curTime, CCTimeType timeSinceLastTick, uint32_t unacknowledgedBytes, bool isContinuousSend);
+	virtual int GetRetransmissionBandwidth(CCTimeType curTime, CCTimeType timeSinceLastTick, uint32_t unacknowledgedBytes, bool isContinuousSend);
+	virtual int GetTransmissionBandwidth(CCTimeType curTime, CCTimeType timeSinceLastTick, uint32_t unacknowledgedBytes, bool isContinuousSend);
 
 	/// Acks do not have to be sent immediately. Instead, they can be buffered up such that groups of acks are sent at a time
 	/// This reduces overall bandwidth usage
 	/// How long they can be buffered depends on the retransmit time of the sender
 	/// Should call once per update tick, and send if needed
-	bool ShouldSendACKs(CCTimeType curTime, CCTimeType estimatedTimeToNextTick);
+	virtual bool ShouldSendACKs(CCTimeType curTime, CCTimeType estimatedTimeToNextTick);
+
+	/// Latest time at which ShouldSendACKs() returns true for the acks buffered so far
+	/// Used to sleep until acks are due rather than polling ShouldSendACKs()
+	virtual CCTimeType GetNextACKTime(CCTimeType curTime) const;
 
 	/// Every data packet sent must contain a sequence number
 	/// Call this function to get it. The sequence number is passed into OnGotPacketPair()
-	DatagramSequenceNumberType GetAndIncrementNextDatagramSequenceNumber(void);
-	DatagramSequenceNumberType GetNextDatagramSequenceNumber(void);
+	virtual DatagramSequenceNumberType GetAndIncrementNextDatagramSequenceNumber(void);
+	virtual DatagramSequenceNumberType GetNextDatagramSequenceNumber(void);
+	virtual DatagramSequenceNumberType GetExpectedNextDatagramSequenceNumber(void) const;
+	virtual void SetDatagramSequenceNumbers(DatagramSequenceNumberType _nextDatagramSequenceNumber, DatagramSequenceNumberType _expectedNextSequenceNumber);
 
 	/// Call this when you send packets
 	/// Every 15th and 16th packets should be sent as a packet pair if possible
 	/// When packets marked as a packet pair arrive, pass to OnGotPacketPair()
 	/// When any packets arrive, (additionally) pass to OnGotPacket
 	/// Packets should contain our system time, so we can pass rtt to OnNonDuplicateAck()
-	void OnSendBytes(CCTimeType curTime, uint32_t numBytes);
+	virtual void OnSendBytes(CCTimeType curTime, uint32_t numBytes);
 
 	/// Call this when you get a packet pair
-	void OnGotPacketPair(DatagramSequenceNumberType datagramSequenceNumber, uint32_t sizeInBytes, CCTimeType curTime);
+	virtual void OnGotPacketPair(DatagramSequenceNumberType datagramSequenceNumber, uint32_t sizeInBytes, CCTimeType curTime);
 
 	/// Call this when you get a packet (including packet pairs)
 	/// If the DatagramSequenceNumberType is out of order, skippedMessageCount will be non-zero
 	/// In that case, send a NAK for every sequence number up to that count
-	bool OnGotPacket(DatagramSequenceNumberType datagramSequenceNumber, bool isContinuousSend, CCTimeType curTime, uint32_t sizeInBytes, uint32_t *skippedMessageCount);
+	virtual bool OnGotPacket(DatagramSequenceNumberType datagramSequenceNumber, bool isContinuousSend, CCTimeType curTime, uint32_t sizeInBytes, uint32_t *skippedMessageCount);
 
 	/// Call when you get a NAK, with the sequence number of the lost message
 	/// Affects the congestion control
-	void OnResend(CCTimeType curTime, SLNet::TimeUS nextActionTime);
-	void OnNAK(CCTimeType curTime, DatagramSequenceNumberType nakSequenceNumber);
+	virtual void OnResend(CCTimeType curTime, SLNet::TimeUS nextActionTime);
+	virtual void OnNAK(CCTimeType curTime, DatagramSequenceNumberType nakSequenceNumber);
 
 	/// Call this when an ACK arrives.
 	/// hasBAndAS are possibly written with the ack, see OnSendAck()
 	/// B and AS are used in the calculations in UpdateWindowSizeAndAckOnAckPerSyn
 	/// B and AS are updated at most once per SYN 
-	void OnAck(CCTimeType curTime, CCTimeType rtt, bool hasBAndAS, BytesPerMicrosecond _B, BytesPerMicrosecond _AS, double totalUserDataBytesAcked, bool isContinuousSend, DatagramSequenceNumberType sequenceNumber );
-	void OnDuplicateAck( CCTimeType curTime, DatagramSequenceNumberType sequenceNumber );
+	virtual void OnAck(CCTimeType curTime, CCTimeType rtt, bool hasBAndAS, BytesPerMicrosecond _B, BytesPerMicrosecond _AS, double totalUserDataBytesAcked, bool isContinuousSend, DatagramSequenceNumberType sequenceNumber );
+	virtual void OnDuplicateAck( CCTimeType curTime, DatagramSequenceNumberType sequenceNumber );
 	
 	/// Call when you send an ack, to see if the ack should have the B and AS parameters transmitted
 	/// Call before calling OnSendAck()
-	void OnSendAckGetBAndAS(CCTimeType curTime, bool *hasBAndAS, BytesPerMicrosecond *_B, BytesPerMicrosecond *_AS);
+	virtual void OnSendAckGetBAndAS(CCTimeType curTime, bool *hasBAndAS, BytesPerMicrosecond *_B, BytesPerMicrosecond *_AS);
 
 	/// Call when we send an ack, to write B and AS if needed
 	/// B and AS are only written once per SYN, to prevent slow calculations
 	/// Also updates SND, the period between sends, since data is written out
 	/// Be sure to call OnSendAckGetBAndAS() before calling OnSendAck(), since whether you write it or not affects \a numBytes
-	void OnSendAck(CCTimeType curTime, uint32_t numBytes);
+	virtual void OnSendAck(CCTimeType curTime, uint32_t numBytes);
 
 	/// Call when we send a NACK
 	/// Also updates SND, the period between sends, since data is written out
-	void OnSendNACK(CCTimeType curTime, uint32_t numBytes);
+	virtual void OnSendNACK(CCTimeType curTime, uint32_t numBytes);
 	
 	/// Retransmission time out for the sender
 	/// If the time difference between when a message was last transmitted, and the current time is greater than RTO then packet is eligible for retransmission, pending congestion control
@@ -157,14 +129,14 @@ class CCRakNetSlidingWindow
 	/// If we have been continuously sending for the last RTO, and no ACK or NAK at all, SND*=2;
 	/// This is per message, which is different from UDT, but RakNet supports packetloss with continuing data where UDT is only RELIABLE_ORDERED
 	/// Minimum value is 100 milliseconds
-	CCTimeType GetRTOForRetransmission(unsigned char timesSent) const;
+	virtual CCTimeType GetRTOForRetransmission(unsigned char timesSent) const;
 
 	/// Set the maximum amount of data that can be sent in one datagram
 	/// Default to MAXIMUM_MTU_SIZE-UDP_HEADER_SIZE
-	void SetMTU(uint32_t bytes);
+	virtual void SetMTU(uint32_t bytes);
 
 	/// Return what was set by SetMTU()
-	uint32_t GetMTU(void) const;
+	virtual uint32_t GetMTU(void) const;
 
 	/// Query for statistics
 	BytesPerMicrosecond GetLocalSendRate(void) const {return 0;}
@@ -175,18 +147,15 @@ class CCRakNetSlidingWindow
 	double GetLinkCapacityBytesPerSecond(void) const {return 0;}
 
 	/// Query for statistics
-	double GetRTT(void) const;
+	virtual double GetRTT(void) const;
 
-	bool GetIsInSlowStart(void) const {return IsInSlowStart();}
+	virtual bool GetIsInSlowStart(void) const {return IsInSlowStart();}
 	uint32_t GetCWNDLimit(void) const {return (uint32_t) 0;}
 
-
-	/// Is a > b, accounting for variable overflow?
-	static bool GreaterThan(DatagramSequenceNumberType a, DatagramSequenceNumberType b);
-	/// Is a < b, accounting for variable overflow?
-	static bool LessThan(DatagramSequenceNumberType a, DatagramSequenceNumberType b);
 //	void SetTimeBetweenSendsLimit(unsigned int bitsPerSecond);
-	uint64_t GetBytesPerSecondLimitByCongestionControl(void) const;
+	virtual uint64_t GetBytesPerSecondLimitByCongestionControl(void) const;
+	/// The congestion window per round trip time
+	virtual double GetPacingRate(void) const;
 	  
 	protected:
 
@@ -214,6 +183,9 @@ class CCRakNetSlidingWindow
 
 	bool IsInSlowStart(void) const;
 
+	/// Adds a round trip time sample to lastRtt, estimatedRTT and deviationRtt
+	void UpdateRTT(CCTimeType rtt);
+
 	double lastRtt, estimatedRTT, deviationRtt;
 
 };
@@ -221,5 +193,3 @@ class CCRakNetSlidingWindow
 }
 
 #endif
-
-#endif
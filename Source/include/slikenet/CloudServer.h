@@ -30,6 +30,7 @@
 #include "NativeTypes.h"
 #include "string.h"
 #include "DS_Hash.h"
+#include "DS_LinearProbingHash.h"
 #include "CloudCommon.h"
 #include "DS_OrderedList.h"
 
@@ -133,6 +134,7 @@ public:
 protected:
 	virtual void Update(void);
 	virtual PluginReceiveResult OnReceive(Packet *packet);
+	virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const;
 	virtual void OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason );
 	virtual void OnRakPeerShutdown(void);
 
@@ -201,6 +203,8 @@ protected:
 
 		unsigned int uploaderCount, subscriberCount;
 		CloudKey key;
+		// CloudKeyToHash() of key
+		uint32_t keyHash;
 
 		// Data uploaded from or subscribed to for various systems
 		DataStructures::OrderedList<RakNetGUID, CloudData*, CloudServer::KeyDataPtrComp> keyData;
@@ -210,8 +214,21 @@ protected:
 		DataStructures::OrderedList<RakNetGUID, RakNetGUID> nonSpecificSubscribers;
 	};
 
-	static int KeyDataListComp( const CloudKey &key, CloudDataList * const &data );
-	DataStructures::OrderedList<CloudKey, CloudDataList*, CloudServer::KeyDataListComp> dataRepository;
+	// The hash is kept next to the key, so growing the table does not hash the key strings again
+	struct DataRepositoryKey
+	{
+		uint32_t keyHash;
+		// The key of the CloudDataList, or the key that is looked up
+		const CloudKey *key;
+		bool operator==(const DataRepositoryKey &k) const {return keyHash==k.keyHash && key->secondaryKey==k.key->secondaryKey && key->primaryKey==k.key->primaryKey;}
+		static unsigned int ToHash(const DataRepositoryKey &k) {return k.keyHash;}
+	};
+	// Every key that was uploaded or subscribed to
+	DataStructures::LinearProbingHash<DataRepositoryKey, CloudDataList*, DataRepositoryKey::ToHash> dataRepository;
+	static uint32_t CloudKeyToHash(const CloudKey &key);
+	CloudDataList *GetCloudDataList(const CloudKey &key);
+	void AddCloudDataList(CloudDataList *cloudDataList);
+	void RemoveCloudDataList(CloudDataList *cloudDataList);
 
 	struct KeySubscriberID
 	{
@@ -229,7 +246,8 @@ protected:
 		DataStructures::OrderedList<CloudKey,KeySubscriberID*,CloudServer::KeySubscriberIDComp> subscribedKeys;
 		uint64_t uploadedBytes;
 	};
-	DataStructures::Hash<RakNetGUID, RemoteCloudClient*, 2048, RakNetGUID::ToUint32> remoteSystems;
+	// Every client that uploads or subscribes is in here, so there are enough chains for tens of thousands of clients
+	DataStructures::Hash<RakNetGUID, RemoteCloudClient*, 65536, RakNetGUID::ToUint32> remoteSystems;
 
 	// For a given user, release all subscribed and uploaded keys
 	void ReleaseSystem(RakNetGUID clientAddress );
@@ -326,7 +344,7 @@ protected:
 		DataStructures::List<RemoteServer*> &remoteServersWithData
 		);
 
-	CloudServer::CloudDataList *GetOrAllocateCloudDataList(CloudKey key, bool *dataRepositoryExists, unsigned int &dataRepositoryIndex);
+	CloudServer::CloudDataList *GetOrAllocateCloudDataList(CloudKey key, bool *dataRepositoryExists);
 
 	void UnsubscribeFromKey(RemoteCloudClient *remoteCloudClient, RakNetGUID remoteCloudClientGuid, unsigned int keySubscriberIndex, CloudKey &cloudKey, DataStructures::List<RakNetGUID> &specificSystems);
 	void RemoveSpecificSubscriber(RakNetGUID specificSubscriber, CloudDataList *cloudDataList, RakNetGUID remoteCloudClientGuid);
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file ConnectionArena.h
+/// \internal
+/// \brief The memory of one connection of RakPeer, taken from pages shared by all connections
+///
+
+#ifndef __CONNECTION_ARENA_H
+#define __CONNECTION_ARENA_H
+
+#include "Export.h"
+#include "NativeTypes.h"
+#include "SimpleMutex.h"
+#include "LocklessTypes.h"
+#include "defines.h"
+
+namespace SLNet
+{
+
+/// \internal
+/// \brief Pages of CONNECTION_ARENA_PAGE_SIZE bytes, shared by the ConnectionArena of all connections of one RakPeer
+/// \details Pages released by a closed connection are kept for the next one, rather than returned to the heap, until Clear() is called. Threadsafe.
+class RAK_DLL_EXPORT ArenaPagePool
+{
+public:
+	ArenaPagePool();
+	~ArenaPagePool();
+
+	/// \return A page, or 0 when out of memory
+	void *Allocate( const char *file, unsigned int line );
+	void Release( void *page );
+
+	/// Frees the pages that are not in use
+	void Clear( const char *file, unsigned int line );
+
+	/// \return How many pages were taken from the heap, including the ones in use
+	unsigned int GetPageCount( void ) const {return pageCount.GetValue();}
+	/// \return How many pages are waiting to be used again
+	unsigned int GetFreePageCount( void ) const {return freePageCount.GetValue();}
+
+protected:
+	SimpleMutex mutex;
+	// Linked through their first bytes
+	void *freePages;
+	LocklessUint32_t pageCount, freePageCount;
+};
+
+/// \internal
+/// \brief The memory of one connection: its internal packets, its datagram history, and the copies of the messages it sends
+/// \details Blocks are carved from pages of an ArenaPagePool. A released block goes into a free list for its size class, from which the next
+/// allocation of that class takes it. Blocks larger than the largest size class come from the heap, but still count as in use.
+/// Clear() returns all pages at once when the connection closes.
+/// The arena is used by the thread that updates the connection. Only GetBytesInUse(), GetBytesReserved() and IsOverBudget() may be called from other threads.
+class RAK_DLL_EXPORT ConnectionArena
+{
+public:
+	ConnectionArena();
+	~ConnectionArena();
+
+	/// Where to get pages from. If 0 (the default), they are taken from and returned to the heap. Only change while no pages are held.
+	void SetPagePool( ArenaPagePool *_pagePool );
+
+	/// \return A block of at least \a numBytes bytes, aligned to 8 bytes, or 0 when out of memory
+	void *Allocate( unsigned int numBytes, const char *file, unsigned int line );
+	void Release( void *block, const char *file, unsigned int line );
+
+	/// Returns all pages, including blocks that were not released
+	void Clear( const char *file, unsigned int line );
+
+	/// Memory the arena does not own, such as data of a SharedSendBuffer, can be counted as in use too
+	void AddExternalBytes( unsigned int numBytes );
+	void SubtractExternalBytes( unsigned int numBytes );
+
+	/// \param[in] bytes Maximum bytes in use before IsOverBudget() returns true. 0 for no limit.
+	void SetBudget( unsigned int bytes ) {budget=bytes;}
+	unsigned int GetBudget( void ) const {return budget;}
+	bool IsOverBudget( void ) const {return budget!=0 && bytesInUse.Load()>=budget;}
+
+	/// \return Bytes of the blocks in use, including their headers, and external bytes
+	unsigned int GetBytesInUse( void ) const {return bytesInUse.Load();}
+	/// \return Bytes of the pages held, and of the blocks taken from the heap
+	unsigned int GetBytesReserved( void ) const {return bytesReserved.Load();}
+
+protected:
+	struct BlockHeader
+	{
+		// Index into SIZE_CLASSES, or HEAP_BLOCK
+		uint32_t sizeClass;
+		// Including the header
+		uint32_t blockSize;
+	};
+	// Keeps pages linked while they are held
+	struct PageHeader
+	{
+		PageHeader *next;
+		uint64_t padding;
+	};
+	// Keeps blocks from the heap linked, in front of their BlockHeader
+	struct HeapBlockLink
+	{
+		HeapBlockLink *prev, *next;
+	};
+
+	static const int SIZE_CLASS_COUNT=16;
+	static const uint32_t SIZE_CLASSES[SIZE_CLASS_COUNT];
+	static const uint32_t HEAP_BLOCK=0xFFFFFFFF;
+
+	bool AllocatePage( const char *file, unsigned int line );
+	void *AllocateHeapBlock( uint32_t blockSize, const char *file, unsigned int line );
+
+	ArenaPagePool *pagePool;
+	PageHeader *pages;
+	// Unused bytes at the end of the newest page
+	unsigned char *pageFreeStart, *pageFreeEnd;
+	// Released blocks, linked through the bytes after their header
+	BlockHeader *freeBlocks[SIZE_CLASS_COUNT];
+	HeapBlockLink *heapBlocks;
+
+	unsigned int budget;
+	LocklessUint32_t bytesInUse, bytesReserved;
+};
+
+/// \internal
+/// \brief The interface of DataStructures::MemoryPool, on top of a ConnectionArena
+/// Blocks go back into the arena when released, and all of them when the arena is cleared. Like MemoryPool, this does not call constructors or destructors.
+template <class MemoryBlockType>
+class RAK_DLL_EXPORT ArenaMemoryPool
+{
+public:
+	ArenaMemoryPool() {arena=0;}
+	void SetArena( ConnectionArena *_arena ) {arena=_arena;}
+	MemoryBlockType *Allocate( const char *file, unsigned int line ) {return (MemoryBlockType*) arena->Allocate(sizeof(MemoryBlockType), file, line);}
+	void Release( MemoryBlockType *m, const char *file, unsigned int line ) {arena->Release(m, file, line);}
+
+protected:
+	ConnectionArena *arena;
+};
+
+} // namespace SLNet
+
+#endif
@@ -116,6 +116,7 @@ protected:
 	virtual void OnNewConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, bool isIncoming);
 	/// \internal
 	virtual PluginReceiveResult OnReceive(Packet *packet);
+	virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const;
 
 	// List of systems I am connected to, which in turn stores which systems they are connected to
 	DataStructures::OrderedList<RakNetGUID, RemoteSystem*, ConnectionGraph2::RemoteSystemComp> remoteSystems;
@@ -737,7 +737,8 @@ namespace DataStructures
 		{
 			if (cur->children[branchIndex]->isLeaf==true && cur->children[branchIndex]->size==order)
 			{
-				if (branchIndex==childIndex+1)
+				int leafIndex;
+				if (branchIndex==childIndex+1 || GetIndexOf(key, cur->children[branchIndex], &leafIndex))
 				{
 					*success=false;
 					return 0; // Already exists
@@ -54,6 +54,9 @@ public:
 	/// \brief Free the memory used by the tree.
 	void FreeMemory( void );
 
+	/// Decoding looks up this many bits at once. Codes that are longer continue bit by bit from the tree node reached after these bits
+	static const int DECODING_TABLE_BITS=10;
+
 private:
 
 	/// The root node of the tree 
@@ -67,11 +70,27 @@ private:
 	{
 		unsigned char* encoding;
 		unsigned short bitLength;
+		/// The same bits as encoding, right aligned, if bitLength is at most 32
+		uint32_t codeWord;
 	};
 
 	CharacterEncoding encodingTable[ 256 ];
 
+	/// Indexed by the next DECODING_TABLE_BITS bits of the input
+	struct DecodingTableEntry
+	{
+		/// The leaf of the code that starts with these bits, or for longer codes the node reached after DECODING_TABLE_BITS bits
+		HuffmanEncodingTreeNode *node;
+		/// How many of the bits lead to node
+		unsigned short bitLength;
+	};
+
+	DecodingTableEntry decodingTable[ 1 << DECODING_TABLE_BITS ];
+
 	void InsertNodeIntoSortedList( HuffmanEncodingTreeNode * node, DataStructures::LinkedList<HuffmanEncodingTreeNode *> *huffmanEncodingTreeNodeList ) const;
+	void GenerateDecodingTable( void );
+	/// Decodes the sizeInBits bits of data starting at bit readOffset. Returns the number of characters decoded, including those past maxCharsToWrite
+	unsigned DecodeBits( const unsigned char *data, BitSize_t readOffset, BitSize_t sizeInBits, size_t maxCharsToWrite, unsigned char *output ) const;
 };
 
 } // namespace SLNet
@@ -0,0 +1,204 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file DS_LinearProbingHash.h
+/// \internal
+/// \brief Hash table with open addressing and linear probing, that grows and shrinks with the number of elements
+///
+
+
+#ifndef __LINEAR_PROBING_HASH_H
+#define __LINEAR_PROBING_HASH_H
+
+#include "assert.h"
+#include "Export.h"
+#include "memoryoverride.h"
+
+/// The namespace DataStructures was only added to avoid compiler errors for commonly named data structures
+/// As these data structures are stand-alone, you can use them outside of RakNet for your own projects if you wish.
+namespace DataStructures
+{
+	/// \brief Maps unique keys to pointers, with the pairs stored in one array rather than in allocated nodes
+	/// \details The number of slots is a power of two, and at most half of them are used, so runs of used slots stay short.
+	/// Removing an element moves later elements of its run back, so there are no tombstones and lookups never slow down over time.
+	/// The table doubles when it would become more than half full, and halves when less than an eighth is used, down to the number of slots it started with.
+	/// \param[in] key_type Compared with operator==, and copied when slots move
+	/// \param[in] data_type A pointer type. 0 marks an empty slot, so it cannot be stored
+	/// \param[in] hashFunction Only the low bits select the slot, so they must be well mixed
+	template <class key_type, class data_type, unsigned int (*hashFunction)(const key_type &) >
+	class RAK_DLL_EXPORT LinearProbingHash
+	{
+	public:
+		/// \param[in] _minimumSlotCount Rounded up to a power of two. The table never has fewer slots
+		LinearProbingHash(unsigned int _minimumSlotCount=16);
+		~LinearProbingHash();
+
+		/// \return The data stored with \a key, or 0 if there is none
+		data_type Get(const key_type &key) const;
+
+		/// \pre \a key is not in the table yet, and \a data is not 0
+		void Insert(const key_type &key, const data_type &data, const char *file, unsigned int line);
+
+		/// \return false if \a key was not in the table
+		bool Remove(const key_type &key, const char *file, unsigned int line);
+
+		/// Removes every element, and shrinks back to the minimum number of slots
+		void Clear(const char *file, unsigned int line);
+
+		/// \return The number of elements
+		unsigned int Size(void) const {return size;}
+
+		/// To iterate over the elements, together with GetDataAtSlot(). Inserting or removing elements moves them to other slots
+		unsigned int GetSlotCount(void) const {return slotCount;}
+		/// \return The data in the slot, or 0 if it is empty
+		data_type GetDataAtSlot(unsigned int slotIndex) const {return slots[slotIndex].data;}
+
+	protected:
+		// Not copyable, as it owns the slots
+		LinearProbingHash(const LinearProbingHash &);
+		LinearProbingHash &operator=(const LinearProbingHash &);
+
+		struct Slot
+		{
+			key_type key;
+			data_type data;
+		};
+
+		unsigned int GetHashIndex(const key_type &key) const {return (*hashFunction)(key) & (slotCount-1);}
+		void Resize(unsigned int newSlotCount, const char *file, unsigned int line);
+
+		Slot *slots;
+		unsigned int slotCount;
+		unsigned int size;
+		unsigned int minimumSlotCount;
+	};
+
+	template <class key_type, class data_type, unsigned int (*hashFunction)(const key_type &) >
+	LinearProbingHash<key_type, data_type, hashFunction>::LinearProbingHash(unsigned int _minimumSlotCount)
+	{
+		minimumSlotCount=1;
+		while (minimumSlotCount < _minimumSlotCount)
+			minimumSlotCount<<=1;
+		slots=0;
+		slotCount=0;
+		size=0;
+		Resize(minimumSlotCount, _FILE_AND_LINE_);
+	}
+
+	template <class key_type, class data_type, unsigned int (*hashFunction)(const key_type &) >
+	LinearProbingHash<key_type, data_type, hashFunction>::~LinearProbingHash()
+	{
+		SLNet::OP_DELETE_ARRAY(slots, _FILE_AND_LINE_);
+	}
+
+	template <class key_type, class data_type, unsigned int (*hashFunction)(const key_type &) >
+	data_type LinearProbingHash<key_type, data_type, hashFunction>::Get(const key_type &key) const
+	{
+		unsigned int slotIndex=GetHashIndex(key);
+		for (;;)
+		{
+			const Slot &slot=slots[slotIndex];
+			if (slot.data==0)
+				return 0;
+			if (slot.key==key)
+				return slot.data;
+			slotIndex=(slotIndex+1) & (slotCount-1);
+		}
+	}
+
+	template <class key_type, class data_type, unsigned int (*hashFunction)(const key_type &) >
+	void LinearProbingHash<key_type, data_type, hashFunction>::Insert(const key_type &key, const data_type &data, const char *file, unsigned int line)
+	{
+		RakAssert(data!=0);
+		if ((size+1)*2 > slotCount)
+			Resize(slotCount*2, file, line);
+
+		unsigned int slotIndex=GetHashIndex(key);
+		while (slots[slotIndex].data!=0)
+		{
+			// Duplicate key?
+			RakAssert((slots[slotIndex].key==key)==false);
+			slotIndex=(slotIndex+1) & (slotCount-1);
+		}
+		slots[slotIndex].key=key;
+		slots[slotIndex].data=data;
+		size++;
+	}
+
+	template <class key_type, class data_type, unsigned int (*hashFunction)(const key_type &) >
+	bool LinearProbingHash<key_type, data_type, hashFunction>::Remove(const key_type &key, const char *file, unsigned int line)
+	{
+		unsigned int slotIndex=GetHashIndex(key);
+		for (;;)
+		{
+			if (slots[slotIndex].data==0)
+				return false;
+			if (slots[slotIndex].key==key)
+				break;
+			slotIndex=(slotIndex+1) & (slotCount-1);
+		}
+
+		// Move later elements of the run back into the freed slot, unless that would put them before the slot their hash selects
+		unsigned int emptyIndex=slotIndex;
+		unsigned int nextIndex=slotIndex;
+		for (;;)
+		{
+			nextIndex=(nextIndex+1) & (slotCount-1);
+			if (slots[nextIndex].data==0)
+				break;
+			unsigned int nextHashIndex=GetHashIndex(slots[nextIndex].key);
+			if (((nextIndex-nextHashIndex) & (slotCount-1)) >= ((nextIndex-emptyIndex) & (slotCount-1)))
+			{
+				slots[emptyIndex]=slots[nextIndex];
+				emptyIndex=nextIndex;
+			}
+		}
+		slots[emptyIndex].data=0;
+		size--;
+
+		if (size*8 < slotCount && slotCount > minimumSlotCount)
+			Resize(slotCount/2, file, line);
+		return true;
+	}
+
+	template <class key_type, class data_type, unsigned int (*hashFunction)(const key_type &) >
+	void LinearProbingHash<key_type, data_type, hashFunction>::Clear(const char *file, unsigned int line)
+	{
+		if (slotCount!=minimumSlotCount)
+		{
+			SLNet::OP_DELETE_ARRAY(slots, file, line);
+			slotCount=minimumSlotCount;
+			slots=SLNet::OP_NEW_ARRAY<Slot>(slotCount, file, line);
+		}
+		for (unsigned int slotIndex=0; slotIndex < slotCount; slotIndex++)
+			slots[slotIndex].data=0;
+		size=0;
+	}
+
+	template <class key_type, class data_type, unsigned int (*hashFunction)(const key_type &) >
+	void LinearProbingHash<key_type, data_type, hashFunction>::Resize(unsigned int newSlotCount, const char *file, unsigned int line)
+	{
+		Slot *oldSlots=slots;
+		unsigned int oldSlotCount=slotCount;
+		slotCount=newSlotCount;
+		slots=SLNet::OP_NEW_ARRAY<Slot>(slotCount, file, line);
+		for (unsigned int slotIndex=0; slotIndex < slotCount; slotIndex++)
+			slots[slotIndex].data=0;
+		for (unsigned int oldIndex=0; oldIndex < oldSlotCount; oldIndex++)
+		{
+			if (oldSlots[oldIndex].data==0)
+				continue;
+			unsigned int slotIndex=GetHashIndex(oldSlots[oldIndex].key);
+			while (slots[slotIndex].data!=0)
+				slotIndex=(slotIndex+1) & (slotCount-1);
+			slots[slotIndex]=oldSlots[oldIndex];
+		}
+		SLNet::OP_DELETE_ARRAY(oldSlots, file, line);
+	}
+}
+
+#endif
@@ -0,0 +1,313 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file DS_LocklessQueue.h
+/// \internal
+/// A threadsafe queue built on a bounded ring buffer that does not lock a mutex unless the ring is full
+
+#ifndef __LOCKLESS_QUEUE_H
+#define __LOCKLESS_QUEUE_H
+
+#include "DS_Queue.h"
+#include "DS_MagazineMemoryPool.h"
+#include "SimpleMutex.h"
+#include "LocklessTypes.h"
+#include "memoryoverride.h"
+
+namespace DataStructures
+{
+	/// \brief A FIFO queue of small objects (usually pointers) for passing data between threads.
+	/// Push() and Pop() work on a bounded ring buffer with atomic operations only. Any number of threads may push and pop at the same time,
+	/// although RakPeer uses it with many producers and a single consumer. When the ring is full, pushed elements go into an overflow queue guarded by
+	/// a mutex, which Pop() drains after the ring. While the overflow queue is not empty, Push() appends to it too, so each producer's elements stay in order.
+	/// PushAtHead() is always guarded by the mutex.
+	template <class structureType>
+	class RAK_DLL_EXPORT LocklessQueue
+	{
+	public:
+		LocklessQueue();
+		~LocklessQueue();
+
+		/// Not threadsafe. Sets the number of elements the ring buffer holds, rounded up to a power of two.
+		void SetRingSize(unsigned int size);
+
+		void Push(const structureType &s);
+		void PushAtHead(const structureType &s);
+		/// \return false if the queue is empty
+		bool Pop(structureType &s);
+
+		/// Other threads can change the queue at any time, so this is only an estimate
+		bool IsEmpty(void) const {return Size()==0;}
+		unsigned int Size(void) const;
+
+		/// Not threadsafe. Removes all elements without freeing the ring buffer.
+		void Clear(const char *file, unsigned int line);
+
+		/// \return How often an atomic operation had to be retried because another thread changed the ring, or the mutex was locked because it was full
+		uint32_t GetContentionCount(void) const {return contentionCount.GetValue();}
+		/// \return How many elements were pushed into the overflow queue because the ring was full
+		uint32_t GetOverflowCount(void) const {return overflowCount.GetValue();}
+	protected:
+		struct Cell
+		{
+			// Equals the position to push next into this cell, or that position plus one after the push, until the element is popped
+			SLNet::LocklessUint32_t sequence;
+			structureType data;
+		};
+
+		bool PushRing(const structureType &s);
+		bool PopRing(structureType &s);
+
+		Cell *cells;
+		uint32_t ringMask;
+		// Keep the positions of producers and consumer on different cache lines
+		char padding1[64];
+		SLNet::LocklessUint32_t pushPosition;
+		char padding2[64];
+		SLNet::LocklessUint32_t popPosition;
+		char padding3[64];
+
+		// Guards headQueue and overflowQueue. Their sizes are mirrored so that Push() and Pop() can skip the mutex while both are empty
+		SLNet::SimpleMutex mutex;
+		Queue<structureType> headQueue, overflowQueue;
+		SLNet::LocklessUint32_t headQueueSize, overflowQueueSize;
+
+		SLNet::LocklessUint32_t contentionCount, overflowCount;
+	};
+
+	template <class structureType>
+	LocklessQueue<structureType>::LocklessQueue()
+	{
+		cells=0;
+		ringMask=0;
+	}
+
+	template <class structureType>
+	LocklessQueue<structureType>::~LocklessQueue()
+	{
+		SLNet::OP_DELETE_ARRAY(cells, _FILE_AND_LINE_);
+	}
+
+	template <class structureType>
+	void LocklessQueue<structureType>::SetRingSize(unsigned int size)
+	{
+		uint32_t ringSize=2;
+		while (ringSize < size)
+			ringSize<<=1;
+
+		SLNet::OP_DELETE_ARRAY(cells, _FILE_AND_LINE_);
+		cells=SLNet::OP_NEW_ARRAY<Cell>(ringSize, _FILE_AND_LINE_);
+		for (uint32_t i=0; i < ringSize; i++)
+			cells[i].sequence.Store(i);
+		ringMask=ringSize-1;
+		pushPosition.Store(0);
+		popPosition.Store(0);
+	}
+
+	template <class structureType>
+	void LocklessQueue<structureType>::Push(const structureType &s)
+	{
+		if (overflowQueueSize.Load()==0 && PushRing(s))
+			return;
+
+		contentionCount.Increment();
+		mutex.Lock();
+		// Pop() may have drained the overflow queue and the ring in the meantime
+		if (overflowQueue.IsEmpty()==false || PushRing(s)==false)
+		{
+			overflowQueue.Push(s, _FILE_AND_LINE_);
+			overflowQueueSize.Store(overflowQueue.Size());
+			overflowCount.Increment();
+		}
+		mutex.Unlock();
+	}
+
+	template <class structureType>
+	void LocklessQueue<structureType>::PushAtHead(const structureType &s)
+	{
+		mutex.Lock();
+		headQueue.PushAtHead(s, 0, _FILE_AND_LINE_);
+		headQueueSize.Store(headQueue.Size());
+		mutex.Unlock();
+	}
+
+	template <class structureType>
+	bool LocklessQueue<structureType>::Pop(structureType &s)
+	{
+		bool popped;
+		if (headQueueSize.Load()==0)
+		{
+			if (PopRing(s))
+				return true;
+			if (overflowQueueSize.Load()==0)
+				return false;
+		}
+
+		mutex.Lock();
+		if (headQueue.IsEmpty()==false)
+		{
+			s=headQueue.Pop();
+			headQueueSize.Store(headQueue.Size());
+			popped=true;
+		}
+		// Elements pushed into the ring before the overflow queue was used come first
+		else if (PopRing(s))
+			popped=true;
+		else if (overflowQueue.IsEmpty()==false)
+		{
+			s=overflowQueue.Pop();
+			overflowQueueSize.Store(overflowQueue.Size());
+			popped=true;
+		}
+		else
+			popped=false;
+		mutex.Unlock();
+		return popped;
+	}
+
+	template <class structureType>
+	unsigned int LocklessQueue<structureType>::Size(void) const
+	{
+		return (unsigned int) (pushPosition.Load()-popPosition.Load()) + headQueueSize.Load() + overflowQueueSize.Load();
+	}
+
+	template <class structureType>
+	void LocklessQueue<structureType>::Clear(const char *file, unsigned int line)
+	{
+		structureType s;
+		while (PopRing(s))
+			;
+		headQueue.Clear(file, line);
+		overflowQueue.Clear(file, line);
+		headQueueSize.Store(0);
+		overflowQueueSize.Store(0);
+	}
+
+	template <class structureType>
+	bool LocklessQueue<structureType>::PushRing(const structureType &s)
+	{
+		Cell *cell;
+		uint32_t position = pushPosition.Load();
+		for (;;)
+		{
+			cell = &cells[position & ringMask];
+			const int32_t difference = (int32_t) (cell->sequence.Load() - position);
+			if (difference==0)
+			{
+				if (pushPosition.CompareAndSet(position, position+1))
+					break;
+				contentionCount.Increment();
+			}
+			else if (difference<0)
+			{
+				// The consumer did not pop this cell yet, so the ring is full
+				return false;
+			}
+			position = pushPosition.Load();
+		}
+
+		cell->data=s;
+		cell->sequence.Store(position+1);
+		return true;
+	}
+
+	template <class structureType>
+	bool LocklessQueue<structureType>::PopRing(structureType &s)
+	{
+		Cell *cell;
+		uint32_t position = popPosition.Load();
+		for (;;)
+		{
+			cell = &cells[position & ringMask];
+			const int32_t difference = (int32_t) (cell->sequence.Load() - (position+1));
+			if (difference==0)
+			{
+				if (popPosition.CompareAndSet(position, position+1))
+					break;
+				contentionCount.Increment();
+			}
+			else if (difference<0)
+			{
+				// Nothing was pushed into this cell yet, so the ring is empty
+				return false;
+			}
+			position = popPosition.Load();
+		}
+
+		s=cell->data;
+		cell->sequence.Store(position+ringMask+1);
+		return true;
+	}
+
+	/// \brief The interface of ThreadsafeAllocatingQueue, on top of LocklessQueue and MagazineMemoryPool
+	template <class structureType>
+	class RAK_DLL_EXPORT LocklessAllocatingQueue
+	{
+	public:
+		LocklessAllocatingQueue() {queue.SetRingSize(1024);}
+
+		// Queue operations
+		void Push(structureType *s) {queue.Push(s);}
+		structureType *Pop(void);
+		/// Same as Pop(), kept for source compatibility with ThreadsafeAllocatingQueue
+		structureType *PopInaccurate(void) {return Pop();}
+		bool IsEmpty(void) const {return queue.IsEmpty();}
+		unsigned int Size(void) const {return queue.Size();}
+		void SetRingSize(unsigned int size) {queue.SetRingSize(size);}
+
+		// Memory pool operations
+		void SetPageSize(int size) {memoryPool.SetPageSize(size);}
+		structureType *Allocate(const char *file, unsigned int line);
+		void Deallocate(structureType *s, const char *file, unsigned int line);
+		/// Not threadsafe
+		void Clear(const char *file, unsigned int line);
+
+		uint32_t GetContentionCount(void) const {return queue.GetContentionCount() + memoryPool.GetContentionCount();}
+		uint32_t GetOverflowCount(void) const {return queue.GetOverflowCount();}
+	protected:
+		MagazineMemoryPool<structureType> memoryPool;
+		LocklessQueue<structureType*> queue;
+	};
+
+	template <class structureType>
+	structureType *LocklessAllocatingQueue<structureType>::Pop(void)
+	{
+		structureType *s;
+		if (queue.Pop(s))
+			return s;
+		return 0;
+	}
+
+	template <class structureType>
+	structureType *LocklessAllocatingQueue<structureType>::Allocate(const char *file, unsigned int line)
+	{
+		structureType *s = memoryPool.Allocate(file, line);
+		// Call new operator, memoryPool doesn't do this
+		s = new ((void*)s) structureType;
+		return s;
+	}
+
+	template <class structureType>
+	void LocklessAllocatingQueue<structureType>::Deallocate(structureType *s, const char *file, unsigned int line)
+	{
+		// Call delete operator, memory pool doesn't do this
+		s->~structureType();
+		memoryPool.Release(s, file, line);
+	}
+
+	template <class structureType>
+	void LocklessAllocatingQueue<structureType>::Clear(const char *file, unsigned int line)
+	{
+		structureType *s;
+		while (queue.Pop(s))
+			s->~structureType();
+		queue.Clear(file, line);
+		memoryPool.Clear(file, line);
+	}
+}
+
+#endif
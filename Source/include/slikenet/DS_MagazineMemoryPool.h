@@ -0,0 +1,277 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file DS_MagazineMemoryPool.h
+/// \internal
+/// A threadsafe memory pool, with caches of blocks in front of it so that most allocations and releases do not lock a mutex
+
+#ifndef __MAGAZINE_MEMORY_POOL_H
+#define __MAGAZINE_MEMORY_POOL_H
+
+#include "DS_MemoryPool.h"
+#include "SimpleMutex.h"
+#include "LocklessTypes.h"
+#include "thread.h"
+
+namespace DataStructures
+{
+	/// \brief A MemoryPool guarded by a mutex, with a cache of blocks (a magazine) for each thread in front of it.
+	/// The calling thread picks one of \a slotCount slots by its thread hash. Each slot holds a magazine of up to \a magazineSize blocks,
+	/// from which Allocate() takes and to which Release() returns blocks without locking the mutex. Only an empty magazine on Allocate() or a
+	/// full one on Release() goes to the mutex guarded depot, which trades it for a full or empty magazine. So when one thread allocates and another
+	/// releases, as with packets handed from the network thread to the user, the mutex is locked once per \a magazineSize blocks.
+	/// If the slot is being used by another thread, the next free slot is tried. If all are in use, the memory pool is used directly.
+	/// Like MemoryPool, this does not call constructors or destructors.
+	template <class MemoryBlockType, int magazineSize=64, int slotCount=8>
+	class RAK_DLL_EXPORT MagazineMemoryPool
+	{
+	public:
+		MagazineMemoryPool();
+		~MagazineMemoryPool();
+		void SetPageSize(int size); // Defaults to 16384 bytes
+		MemoryBlockType *Allocate(const char *file, unsigned int line);
+		void Release(MemoryBlockType *m, const char *file, unsigned int line);
+
+		/// Not threadsafe. Releases all blocks, including the ones that were not returned
+		void Clear(const char *file, unsigned int line);
+
+		/// \return How often a slot was in use by another thread, or a magazine had to be traded at the depot
+		uint32_t GetContentionCount(void) const {return contentionCount.GetValue();}
+	protected:
+		struct Magazine
+		{
+			MemoryBlockType *blocks[magazineSize];
+			int count;
+			Magazine *next;
+		};
+		struct Slot
+		{
+			SLNet::LocklessUint32_t inUse;
+			Magazine *magazine;
+			// Keep slots of different threads on different cache lines
+			char padding[64];
+		};
+
+		Slot *LockSlot(void);
+		Magazine *TradeEmptyMagazine(Magazine *magazine, const char *file, unsigned int line);
+		Magazine *TradeFullMagazine(Magazine *magazine, const char *file, unsigned int line);
+		Magazine *GetEmptyMagazine(const char *file, unsigned int line);
+		void FreeMagazines(Magazine *magazine, const char *file, unsigned int line);
+
+		// After this many full magazines, released blocks go back into memoryPool
+		static const int MAX_FULL_MAGAZINES=16;
+
+		Slot slots[slotCount];
+
+		// Guards everything below
+		SLNet::SimpleMutex depotMutex;
+		MemoryPool<MemoryBlockType> memoryPool;
+		Magazine *fullMagazines, *emptyMagazines;
+		int fullMagazinesSize;
+
+		SLNet::LocklessUint32_t contentionCount;
+	};
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::MagazineMemoryPool()
+	{
+		for (int i=0; i < slotCount; i++)
+			slots[i].magazine=0;
+		fullMagazines=0;
+		emptyMagazines=0;
+		fullMagazinesSize=0;
+	}
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::~MagazineMemoryPool()
+	{
+		Clear(_FILE_AND_LINE_);
+	}
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	void MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::SetPageSize(int size)
+	{
+		depotMutex.Lock();
+		memoryPool.SetPageSize(size);
+		depotMutex.Unlock();
+	}
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	MemoryBlockType* MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::Allocate(const char *file, unsigned int line)
+	{
+		MemoryBlockType *m;
+		Slot *slot = LockSlot();
+		if (slot==0)
+		{
+			depotMutex.Lock();
+			m=memoryPool.Allocate(file, line);
+			depotMutex.Unlock();
+			return m;
+		}
+
+		if (slot->magazine==0 || slot->magazine->count==0)
+			slot->magazine=TradeEmptyMagazine(slot->magazine, file, line);
+
+		if (slot->magazine!=0 && slot->magazine->count>0)
+			m=slot->magazine->blocks[--slot->magazine->count];
+		else
+			m=0;
+		slot->inUse.Store(0);
+		return m;
+	}
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	void MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::Release(MemoryBlockType *m, const char *file, unsigned int line)
+	{
+		Slot *slot = LockSlot();
+		if (slot!=0)
+		{
+			if (slot->magazine==0 || slot->magazine->count==magazineSize)
+				slot->magazine=TradeFullMagazine(slot->magazine, file, line);
+
+			if (slot->magazine!=0)
+			{
+				slot->magazine->blocks[slot->magazine->count++]=m;
+				slot->inUse.Store(0);
+				return;
+			}
+			slot->inUse.Store(0);
+		}
+
+		depotMutex.Lock();
+		memoryPool.Release(m, file, line);
+		depotMutex.Unlock();
+	}
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	void MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::Clear(const char *file, unsigned int line)
+	{
+		for (int i=0; i < slotCount; i++)
+		{
+			if (slots[i].magazine!=0)
+			{
+				slots[i].magazine->next=0;
+				FreeMagazines(slots[i].magazine, file, line);
+				slots[i].magazine=0;
+			}
+		}
+		FreeMagazines(fullMagazines, file, line);
+		FreeMagazines(emptyMagazines, file, line);
+		fullMagazines=0;
+		emptyMagazines=0;
+		fullMagazinesSize=0;
+
+		memoryPool.Clear(file, line);
+	}
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	typename MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::Slot* MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::LockSlot(void)
+	{
+		const unsigned int firstSlot = SLNet::RakThread::GetCurrentThreadHash() % slotCount;
+		for (int i=0; i < slotCount; i++)
+		{
+			Slot *slot = &slots[(firstSlot+i) % slotCount];
+			if (slot->inUse.CompareAndSet(0,1))
+				return slot;
+			contentionCount.Increment();
+		}
+		return 0;
+	}
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	typename MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::Magazine* MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::TradeEmptyMagazine(Magazine *magazine, const char *file, unsigned int line)
+	{
+		contentionCount.Increment();
+		depotMutex.Lock();
+		if (fullMagazines!=0)
+		{
+			if (magazine!=0)
+			{
+				magazine->next=emptyMagazines;
+				emptyMagazines=magazine;
+			}
+			magazine=fullMagazines;
+			fullMagazines=fullMagazines->next;
+			fullMagazinesSize--;
+		}
+		else
+		{
+			// Nothing was released, so fill half of the magazine from the memory pool
+			if (magazine==0)
+				magazine=GetEmptyMagazine(file, line);
+			while (magazine!=0 && magazine->count < magazineSize/2)
+			{
+				MemoryBlockType *m = memoryPool.Allocate(file, line);
+				if (m==0)
+					break;
+				magazine->blocks[magazine->count++]=m;
+			}
+		}
+		depotMutex.Unlock();
+		return magazine;
+	}
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	typename MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::Magazine* MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::TradeFullMagazine(Magazine *magazine, const char *file, unsigned int line)
+	{
+		contentionCount.Increment();
+		depotMutex.Lock();
+		if (magazine!=0)
+		{
+			if (fullMagazinesSize < MAX_FULL_MAGAZINES)
+			{
+				magazine->next=fullMagazines;
+				fullMagazines=magazine;
+				fullMagazinesSize++;
+				magazine=GetEmptyMagazine(file, line);
+			}
+			else
+			{
+				while (magazine->count>0)
+					memoryPool.Release(magazine->blocks[--magazine->count], file, line);
+			}
+		}
+		else
+			magazine=GetEmptyMagazine(file, line);
+		depotMutex.Unlock();
+		return magazine;
+	}
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	typename MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::Magazine* MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::GetEmptyMagazine(const char *file, unsigned int line)
+	{
+		Magazine *magazine;
+		if (emptyMagazines!=0)
+		{
+			magazine=emptyMagazines;
+			emptyMagazines=emptyMagazines->next;
+			return magazine;
+		}
+
+		magazine=(Magazine*) rakMalloc_Ex(sizeof(Magazine), file, line);
+		if (magazine!=0)
+			magazine->count=0;
+		return magazine;
+	}
+
+	template <class MemoryBlockType, int magazineSize, int slotCount>
+	void MagazineMemoryPool<MemoryBlockType, magazineSize, slotCount>::FreeMagazines(Magazine *magazine, const char *file, unsigned int line)
+	{
+		Magazine *next;
+		while (magazine!=0)
+		{
+			next=magazine->next;
+			// Needed with _DISABLE_MEMORY_POOL, where the memory pool does not free the blocks on Clear()
+			while (magazine->count>0)
+				memoryPool.Release(magazine->blocks[--magazine->count], file, line);
+			rakFree_Ex(magazine, file, line);
+			magazine=next;
+		}
+	}
+}
+
+#endif
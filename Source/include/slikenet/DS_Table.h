@@ -125,9 +125,14 @@ namespace DataStructures
 		// Note: If this structure is changed the struct in the swig files need to be changed as well
 		struct RAK_DLL_EXPORT Row
 		{
+			Row();
+
 			// list of cells
 			DataStructures::List<Cell*> cells;
 
+			// Position of this row in the indices of its table, see Table::AddIndex()
+			unsigned indexSlot;
+
 			/// Numeric
 			void UpdateCell(unsigned columnIndex, double value);
 
@@ -260,6 +265,28 @@ namespace DataStructures
 		bool UpdateCellByIndex(unsigned rowIndex, unsigned columnIndex, char *str);
 		bool UpdateCellByIndex(unsigned rowIndex, unsigned columnIndex, int byteLength, char *data);
 
+		/// \brief Indexes a column, so that QueryTable() only tests the rows that can match a filter on that column
+		/// \details NUMERIC columns get an ordered index, used by QF_EQUAL, QF_GREATER_THAN, QF_GREATER_THAN_EQ, QF_LESS_THAN and QF_LESS_THAN_EQ.
+		/// The index also holds the values of the column in one array, so filters on it that match many rows are tested without reading the rows.
+		/// STRING columns get a hashed index, used by QF_EQUAL.
+		/// QueryTable() starts from the index that matches the fewest rows, then tests those rows against all filters, so the results are the same as without indices.
+		/// The functions of Table keep the indices up to date. If you write to Row::cells directly, call UpdateIndices() for that row afterwards, or it may be missing from query results.
+		/// \param[in] columnIndex The column to index
+		/// \return false if the column does not exist, is already indexed, or is not NUMERIC or STRING
+		bool AddIndex(unsigned columnIndex);
+
+		/// \brief Removes the index added with AddIndex()
+		/// \param[in] columnIndex The indexed column
+		void RemoveIndex(unsigned columnIndex);
+
+		/// \return true if AddIndex() was called for this column
+		bool HasIndex(unsigned columnIndex) const;
+
+		/// \brief Updates the indices after the cells of a row were written directly, rather than with UpdateCell()
+		/// \param[in] rowId The ID of the row
+		/// \return false if there is no such row
+		bool UpdateIndices(unsigned rowId);
+
 		/// \brief Note this is much less efficient to call than GetRow, then working with the cells directly.
 		/// Numeric, string, binary
 		void GetCellValueByIndex(unsigned rowIndex, unsigned columnIndex, int *output);
@@ -332,18 +359,37 @@ namespace DataStructures
 		Table& operator = ( const Table& input );
 
 	protected:
-		Table::Row* AddRowColumns(unsigned rowId, Row *row, DataStructures::List<unsigned> columnIndices);
+		Table::Row* AddRowColumns(unsigned rowId, Row *row, DataStructures::List<unsigned> &columnIndices);
 
 		void DeleteRow(Row *row);
 
 		void QueryRow(DataStructures::List<unsigned> &inclusionFilterColumnIndices, DataStructures::List<unsigned> &columnIndicesToReturn, unsigned key, Table::Row* row, FilterQuery *inclusionFilters, Table *result);
 
+		// Returns false if no index helps with these filters, in which case all rows should be tested
+		bool QueryIndices(DataStructures::List<unsigned> &inclusionFilterColumnIndices, DataStructures::List<unsigned> &columnIndicesToReturn, FilterQuery *inclusionFilters, Table *result);
+
+		struct Index;
+		Index* GetIndex(unsigned columnIndex) const;
+		void AddRowToIndices(unsigned rowId, Row *row);
+		void RemoveRowFromIndices(Row *row);
+		void UpdateRowInIndices(Row *row, unsigned columnIndex);
+		void ClearIndices(void);
+
 		// 16 is arbitrary and is the order of the BPlus tree.  Higher orders are better for searching while lower orders are better for
 		// Insertions and deletions.
 		DataStructures::BPlusTree<unsigned, Row*, _TABLE_BPLUS_TREE_ORDER> rows;
 
 		// Columns in the table.
 		DataStructures::List<ColumnDescriptor> columns;
+
+		// Indexed columns, see AddIndex()
+		DataStructures::List<Index*> indices;
+
+		// While there are indices, each row has a slot, which is its position in the per row arrays of every index.
+		// Slots of removed rows have a row of 0 and are reused.
+		DataStructures::List<Row*> slotRows;
+		DataStructures::List<unsigned> slotRowIds;
+		DataStructures::List<unsigned> freeSlots;
 	};
 }
 
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file DS_TimerWheel.h
+/// \internal
+/// \brief Timers that expire at a given time, kept in a hierarchical timer wheel
+///
+
+
+#ifndef __TIMER_WHEEL_H
+#define __TIMER_WHEEL_H
+
+#include "Export.h"
+#include "NativeTypes.h"
+#include "time.h"
+
+namespace DataStructures
+{
+	/// \brief Schedules timers in a hierarchical timer wheel, so that scheduling, cancelling and expiring a timer take constant time no matter how many timers are scheduled
+	/// \details The lowest level has one slot per tick. Each slot of a higher level spans all slots of the level below it, and its timers cascade down when the lower level wraps around to it.
+	/// Timers are embedded in the objects they belong to and are linked into the slots, so the wheel never allocates.
+	/// A timer expires on the first call to Advance() at or after its expiry time, rounded up to a whole tick. It never expires early.
+	class RAK_DLL_EXPORT TimerWheel
+	{
+	public:
+		struct RAK_DLL_EXPORT Timer
+		{
+			Timer();
+			/// Cancels the timer if it is still scheduled
+			~Timer();
+			bool IsScheduled(void) const {return prev!=0;}
+
+			/// For the user of the timer, usually the object the timer is embedded in
+			void *userData;
+
+			/// \internal
+			Timer *next, *prev;
+			/// \internal
+			uint64_t expiryTick;
+			/// \internal
+			TimerWheel *timerWheel;
+		};
+
+		/// \param[in] _tickMS Milliseconds per slot of the lowest level. Timers expire up to this much late.
+		TimerWheel(SLNet::TimeMS _tickMS);
+		~TimerWheel();
+
+		/// Schedules \a timer to expire at \a expiryTime. If it is already scheduled, it is moved to the new time.
+		/// \param[in] timer Must stay valid until it expires or is cancelled
+		void Schedule(Timer *timer, SLNet::Time expiryTime);
+
+		/// Stops \a timer from expiring. Does nothing if it is not scheduled.
+		void Cancel(Timer *timer);
+
+		/// Moves the wheel forward to \a time. Call PopExpired() afterwards to get the timers that expired.
+		/// Call this regularly, and once before scheduling the first timer, as timers are placed relative to the last time passed here.
+		/// While no timers are scheduled, the wheel jumps straight to \a time.
+		void Advance(SLNet::Time time);
+
+		/// \return A timer that expired and is no longer scheduled, in the order they expired, or 0 if there are none left
+		Timer *PopExpired(void);
+
+		/// \return How many timers are scheduled, including the ones that expired but were not popped yet
+		unsigned int Size(void) const {return timerCount;}
+
+	protected:
+		// Not copyable, as the slots point to themselves when empty
+		TimerWheel(const TimerWheel &);
+		TimerWheel &operator=(const TimerWheel &);
+
+		enum
+		{
+			SLOT_BITS=6,
+			SLOTS_PER_LEVEL=1<<SLOT_BITS,
+			LEVELS=4
+		};
+
+		void Insert(Timer *timer);
+		void Cascade(int level);
+		static void Link(Timer *head, Timer *timer);
+		static void Unlink(Timer *timer);
+
+		SLNet::TimeMS tickMS;
+		// The last tick that was processed
+		uint64_t currentTick;
+		unsigned int timerCount;
+		// Each slot and the expired list are circular lists with a sentinel, so a timer can unlink itself without knowing its slot
+		Timer slots[LEVELS][SLOTS_PER_LEVEL];
+		Timer expired;
+	};
+}
+
+#endif
@@ -99,6 +99,11 @@ public:
 	/// \param[in] subdir Concatenated with pathToApplication to form the final path from which to allow uploads.
 	void AddUploadsFromSubdirectory(const char *subdir);
 
+	/// \brief Keep the hash of each file in \a cacheFile, so that only files that changed are hashed again
+	/// \details Used by AddUploadsFromSubdirectory(), GenerateHashes() and DownloadFromSubdirectory() when it hashes the local files. See FileList::SetHashCache()
+	/// \param[in] cacheFile Path to the cache file, which does not have to exist yet. Pass 0 to stop using a cache
+	void SetHashCache(const char *cacheFile);
+
 	/// \brief Downloads files from the matching parameter \a subdir in AddUploadsFromSubdirectory.
 	/// \details \a subdir must contain all starting characters in \a subdir in AddUploadsFromSubdirectory
 	/// Therefore,
@@ -158,10 +163,12 @@ public:
 	
 	/// \internal For plugin handling
 	virtual PluginReceiveResult OnReceive(Packet *packet);
+	virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const;
 protected:
 	void OnDownloadRequest(Packet *packet);
 
 	char applicationDirectory[512];
+	char hashCacheFile[512];
 	FileListTransfer *fileListTransfer;
 	FileList *availableUploads;
 	PacketPriority priority;
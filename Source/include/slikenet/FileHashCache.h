@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file FileHashCache.h
+/// \brief An index of file hashes kept on disk, so that a FileList only hashes the files that changed since the last scan
+///
+
+
+#include "NativeFeatureIncludes.h"
+#if _RAKNET_SUPPORT_FileOperations==1
+
+#ifndef __FILE_HASH_CACHE_H
+#define __FILE_HASH_CACHE_H
+
+#include "Export.h"
+#include "DS_List.h"
+#include "memoryoverride.h"
+#include "NativeTypes.h"
+#include "string.h"
+
+namespace SLNet
+{
+
+/// \brief The hash of each file by path, size and modification time, saved to and loaded from a file
+/// \details The file holds a header, the entries sorted by path, and the paths. Load() reads it with a single read, and GetHash() searches the loaded entries in place, so even a very large index loads without work per entry.<BR>
+/// Entries added since Load() are merged in by Save().<BR>
+/// Used by FileList::SetHashCache()
+class RAK_DLL_EXPORT FileHashCache
+{
+public:
+	FileHashCache();
+	~FileHashCache();
+
+	/// \brief Read the index from \a path, replacing what was loaded before
+	/// \return false, and the cache is empty, if \a path does not exist or was not written by Save() on a system of the same byte order
+	bool Load(const char *path);
+
+	/// \brief Write the loaded entries, merged with those added since, to \a path, and load the result
+	/// \return false if \a path could not be written
+	bool Save(const char *path);
+
+	/// \brief Look up the hash of a file
+	/// \return true if \a filePath was added with this size and modification time, in which case \a hash is set
+	bool GetHash(const char *filePath, uint64_t fileSize, int64_t modificationTime, unsigned int *hash) const;
+
+	/// \brief Record the hash of a file that was found
+	/// \details Replaces a loaded entry with the same path when saved
+	void AddEntry(const char *filePath, uint64_t fileSize, int64_t modificationTime, unsigned int hash);
+
+	/// \brief Drop the loaded entries in \a directory that were not added since Load(), as those files were not found again
+	/// \param[in] directory Path prefix of the entries to drop, ending with a slash
+	/// \param[in] recursive Also drop entries in subdirectories of \a directory
+	void RemoveMissingEntries(const char *directory, bool recursive);
+
+	/// \return true if Save() would write something else than what was loaded
+	bool HasChanges(void) const;
+
+	/// Frees all entries
+	void Clear(void);
+
+	/// Number of entries loaded
+	unsigned int GetLoadedEntryCount(void) const;
+
+protected:
+	// As stored in the file, after the header
+	struct LoadedEntry
+	{
+		uint64_t fileSize;
+		int64_t modificationTime;
+		// Into the paths after the entries
+		uint32_t pathOffset;
+		uint32_t pathLength;
+		uint32_t hash;
+		uint32_t unused;
+	};
+
+	struct AddedEntry
+	{
+		SLNet::RakString filePath;
+		uint64_t fileSize;
+		int64_t modificationTime;
+		unsigned int hash;
+		// Later entries of the same path win
+		unsigned int order;
+	};
+
+	enum LoadedEntryState
+	{
+		LOADED_ENTRY_UNCHANGED,
+		LOADED_ENTRY_CONFIRMED,
+		LOADED_ENTRY_DROPPED
+	};
+
+	const char *GetLoadedPath(unsigned int index) const;
+	// Index of the first loaded entry whose path is not less than filePath
+	unsigned int LowerBound(const char *filePath) const;
+	static int AddedEntryComp(const void *a, const void *b);
+
+	// Header, entries and paths as read from the file
+	char *loadedData;
+	const LoadedEntry *loadedEntries;
+	const char *loadedPaths;
+	unsigned int loadedEntryCount;
+	// One LoadedEntryState for each loaded entry
+	unsigned char *loadedEntryStates;
+	bool droppedLoadedEntries;
+
+	DataStructures::List<AddedEntry*> addedEntries;
+};
+
+} // namespace SLNet
+
+#endif
+
+#endif // _RAKNET_SUPPORT_FileOperations
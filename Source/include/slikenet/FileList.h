@@ -40,6 +40,7 @@ namespace SLNet
 /// Forward declarations
 class RakPeerInterface;
 class FileList;
+class FileHashCache;
 
 
 /// Represents once instance of a file
@@ -168,8 +169,20 @@ public:
 	/// \param[in] writeData Write the contents of each file
 	/// \param[in] recursive Whether or not to visit subdirectories
 	/// \param[in] context User defined byte to store with each file. Use for whatever you want.
+	/// \note Files are read in blocks, and only kept in memory if \a writeData is true. To keep only the hash and read the data when it is sent with an IncrementalReadInterface, pass writeHash true and writeData false, then call FlagFilesAsReferences()
 	void AddFilesFromDirectory(const char *applicationDirectory, const char *subDirectory, bool writeHash, bool writeData, bool recursive, FileListNodeContext context);
 
+	/// \brief Read and hash files on this many threads in AddFilesFromDirectory()
+	/// \details Files are still added in the order they are found, and the callbacks are still called from the thread calling AddFilesFromDirectory(). Defaults to 0, which reads and hashes on the calling thread
+	/// \param[in] numThreads How many threads to start for each call to AddFilesFromDirectory()
+	void SetScanThreads(int numThreads);
+
+	/// \brief Keep the hash of each file in \a cacheFile, so AddFilesFromDirectory() only hashes files whose size or modification time changed
+	/// \details Used when hashing without data, as with data every file is read anyway. The cache file is read by each AddFilesFromDirectory(), and written again if it found changes.<BR>
+	/// Files in the scanned directory that were not found again are removed from the cache, so several directories may share one cache file.
+	/// \param[in] cacheFile Path to the cache file, which does not have to exist yet. Pass 0 to stop using a cache
+	void SetHashCache(const char *cacheFile);
+
 	/// Deallocate all memory
 	void Clear(void);
 
@@ -254,7 +267,13 @@ public:
 	static bool FixEndingSlash(char *str);
 	static bool FixEndingSlash(char *str, size_t strLength);
 protected:
+	// AddFile() without looking for a file of the same name
+	void InsertFile(const char *filename, const char *fullPathToFile, const char *data, const unsigned dataLength, const unsigned fileLength, FileListNodeContext context, bool isAReference, bool takeDataPointer);
+
 	DataStructures::List<FileListProgress*> fileListProgressCallbacks;
+	int scanThreads;
+	FileHashCache *hashCache;
+	SLNet::RakString hashCacheFile;
 };
 
 } // namespace SLNet
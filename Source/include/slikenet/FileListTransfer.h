@@ -121,6 +121,7 @@ public:
 
 	/// \internal For plugin handling
 	virtual PluginReceiveResult OnReceive(Packet *packet);
+	virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const;
 	/// \internal For plugin handling
 	virtual void OnRakPeerShutdown(void);
 	/// \internal For plugin handling
@@ -230,6 +230,7 @@ public:
 
 	/// \internal
 	virtual PluginReceiveResult OnReceive(Packet *packet);
+	virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const;
 	/// \internal
 	virtual void OnRakPeerStartup(void);
 	/// \internal
@@ -25,15 +25,12 @@
 #include "memoryoverride.h"
 #include "defines.h"
 #include "NativeTypes.h"
-#include "defines.h"
-#if USE_SLIDING_WINDOW_CONGESTION_CONTROL!=1
-#include "CCRakNetUDT.h"
-#else
-#include "CCRakNetSlidingWindow.h"
-#endif
+#include "CCRakNetInterface.h"
 
 namespace SLNet {
 
+class SharedSendBuffer;
+
 typedef uint16_t SplitPacketIdType;
 typedef uint32_t SplitPacketIndexType;
 
@@ -77,6 +74,10 @@ struct InternalPacketRefCountedData
 {
 	unsigned char *sharedDataBlock;
 	unsigned int refCount;
+	/// If not 0, sharedDataBlock belongs to this buffer, which is released rather than sharedDataBlock freed
+	SharedSendBuffer *sharedSendBuffer;
+	/// Otherwise, whether sharedDataBlock is released to the arena of the reliability layer rather than freed
+	bool sharedDataBlockInArena;
 };
 
 /// Holds a user message, and related information
@@ -112,7 +113,10 @@ struct InternalPacket : public InternalPacketFixedSizeTransmissionHeader
 	
 		/// If allocation scheme is STACK, data points to stackData and should not be deallocated
 		/// This is only used when sending. Received packets are deallocated in RakPeer
-		STACK
+		STACK,
+
+		/// Data is allocated from the arena of the reliability layer. This is only used when sending, like STACK
+		ARENA
 	} allocationScheme;
 	InternalPacketRefCountedData *refCountedData;
 	/// How many attempts we made at sending this message
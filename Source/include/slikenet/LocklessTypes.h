@@ -37,19 +37,69 @@ public:
 	// Returns variable value after changing it
 	uint32_t Decrement(void);
 	uint32_t GetValue(void) const {return value;}
+	// Sets the variable to desired if it is equal to expected. Returns true if it was changed
+	bool CompareAndSet(uint32_t expected, uint32_t desired);
+	// Like GetValue(), but also orders all reads after it behind the read of the variable
+	uint32_t Load(void) const;
+	// Sets the variable, ordering all previous writes before it
+	void Store(uint32_t newValue);
 
 protected:
 #ifdef _WIN32
 	volatile LONG value;
 #elif defined(ANDROID) || defined(__S3E__) || defined(__APPLE__)
 	// __sync_fetch_and_add not supported apparently
-	SimpleMutex mutex;
+	mutable SimpleMutex mutex;
 	uint32_t value;
 #else
 	volatile uint32_t value;
 #endif
 };
 
+// A pointer that one thread can publish and others read without a mutex. Writers must be serialized by the caller
+template <class pointerType>
+class RAK_DLL_EXPORT LocklessPointer
+{
+public:
+	LocklessPointer() {pointer=0;}
+	// Orders all reads through the pointer behind the read of the pointer
+	pointerType *Load(void) const
+	{
+#if defined(ANDROID) || defined(__S3E__) || defined(__APPLE__)
+		pointerType *p;
+		mutex.Lock();
+		p=pointer;
+		mutex.Unlock();
+		return p;
+#elif defined(_WIN32)
+		// Reads of volatile variables have acquire semantics with Microsoft compilers (/volatile:ms, the default on x86 and x64)
+		return pointer;
+#else
+		return __atomic_load_n (&pointer, __ATOMIC_ACQUIRE);
+#endif
+	}
+	// Orders all writes to *newPointer before the write of the pointer
+	void Store(pointerType *newPointer)
+	{
+#if defined(ANDROID) || defined(__S3E__) || defined(__APPLE__)
+		mutex.Lock();
+		pointer=newPointer;
+		mutex.Unlock();
+#elif defined(_WIN32)
+		// Writes to volatile variables have release semantics with Microsoft compilers (/volatile:ms, the default on x86 and x64)
+		pointer=newPointer;
+#else
+		__atomic_store_n (&pointer, newPointer, __ATOMIC_RELEASE);
+#endif
+	}
+
+protected:
+#if defined(ANDROID) || defined(__S3E__) || defined(__APPLE__)
+	mutable SimpleMutex mutex;
+#endif
+	pointerType * volatile pointer;
+};
+
 }
 
 #endif
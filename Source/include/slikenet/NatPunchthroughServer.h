@@ -30,6 +30,8 @@
 #include "PacketPriority.h"
 #include "SocketIncludes.h"
 #include "DS_OrderedList.h"
+#include "DS_TimerWheel.h"
+#include "DS_LinearProbingHash.h"
 #include "string.h"
 
 namespace SLNet
@@ -101,6 +103,7 @@ public:
 
 	/// \internal For plugin handling
 	virtual PluginReceiveResult OnReceive(Packet *packet);
+	virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const;
 
 	/// \internal For plugin handling
 	virtual void OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason );
@@ -110,7 +113,7 @@ public:
 	struct User;
 	struct ConnectionAttempt
 	{
-		ConnectionAttempt() {sender=0; recipient=0; startTime=0; attemptPhase=NAT_ATTEMPT_PHASE_NOT_STARTED;}
+		ConnectionAttempt() {sender=0; recipient=0; startTime=0; attemptPhase=NAT_ATTEMPT_PHASE_NOT_STARTED; next[0]=0; next[1]=0; prev[0]=0; prev[1]=0; timeoutTimer.userData=this;}
 		User *sender, *recipient;
 		uint16_t sessionId;
 		SLNet::Time startTime;
@@ -119,26 +122,42 @@ public:
 			NAT_ATTEMPT_PHASE_NOT_STARTED,
 			NAT_ATTEMPT_PHASE_GETTING_RECENT_PORTS,
 		} attemptPhase;
+
+		// Links in the list of the sender (index 0) and of the recipient (index 1)
+		ConnectionAttempt *next[2], *prev[2];
+		int GetLinkIndex(const User *user) const {return user==sender ? 0 : 1;}
+		ConnectionAttempt *GetNext(const User *user) const {return next[GetLinkIndex(user)];}
+		// Scheduled when the attempt starts, and expires when the target is unresponsive
+		DataStructures::TimerWheel::Timer timeoutTimer;
 	};
 	struct User
 	{
+		User() {mostRecentPort=0; isReady=true; firstConnectionAttempt=0; lastConnectionAttempt=0; connectionAttemptCount=0;}
 		RakNetGUID guid;
 		SystemAddress systemAddress;
 		unsigned short mostRecentPort;
 		bool isReady;
 		DataStructures::OrderedList<RakNetGUID,RakNetGUID> groupPunchthroughRequests;
 
-		DataStructures::List<ConnectionAttempt *> connectionAttempts;
+		// Attempts as sender and as recipient, in the order they were requested. Iterate with ConnectionAttempt::GetNext()
+		ConnectionAttempt *firstConnectionAttempt, *lastConnectionAttempt;
+		unsigned int connectionAttemptCount;
+		void AddConnectionAttempt(ConnectionAttempt *ca);
 		bool HasConnectionAttemptToUser(User *user);
 		void DerefConnectionAttempt(ConnectionAttempt *ca);
 		void DeleteConnectionAttempt(ConnectionAttempt *ca);
 		void LogConnectionAttempts(SLNet::RakString &rs);
 	};
 	SLNet::Time lastUpdate;
-	static int NatPunchthroughUserComp( const RakNetGUID &key, User * const &data );
 protected:
 	void OnNATPunchthroughRequest(Packet *packet);
-	DataStructures::OrderedList<RakNetGUID, User*, NatPunchthroughServer::NatPunchthroughUserComp> users;
+
+	// Users by RakNetGUID
+	static unsigned int GUIDToHash(const uint64_t &guid);
+	DataStructures::LinearProbingHash<uint64_t, User*, NatPunchthroughServer::GUIDToHash> users;
+
+	// Timeouts of the connection attempts that were started
+	DataStructures::TimerWheel connectionAttemptTimers;
 
 	void OnGetMostRecentPort(Packet *packet);
 	void OnClientReady(Packet *packet);
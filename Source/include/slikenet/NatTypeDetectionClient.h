@@ -71,6 +71,7 @@ struct Packet;
 
 		/// \internal For plugin handling
 		virtual PluginReceiveResult OnReceive(Packet *packet);
+		virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const;
 
 		virtual void OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason );
 		virtual void OnRakPeerShutdown(void);
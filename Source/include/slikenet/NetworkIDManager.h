@@ -25,12 +25,13 @@
 #include "memoryoverride.h"
 #include "NetworkIDObject.h"
 #include "Rand.h"
+#include "DS_LinearProbingHash.h"
 
 namespace SLNet
 {
 
-/// Increase this value if you plan to have many persistent objects
-/// This value must match on all systems
+/// Number of slots NetworkIDManager starts with, rounded up to a power of two
+/// The table grows as more objects are tracked, so this does not limit the number of objects
 #define NETWORK_ID_MANAGER_HASH_LENGTH 1024
 
 /// This class is simply used to generate a unique number for a group of instances of NetworkIDObject
@@ -72,8 +73,8 @@ protected:
 
 	friend class NetworkIDObject;
 
-	NetworkIDObject *networkIdHash[NETWORK_ID_MANAGER_HASH_LENGTH];
-	unsigned int NetworkIDToHashIndex(NetworkID networkId);
+	static unsigned int NetworkIDToHash(const NetworkID &networkId);
+	DataStructures::LinearProbingHash<NetworkID, NetworkIDObject*, NetworkIDManager::NetworkIDToHash> networkIdObjects;
 	uint64_t startingOffset;
 	/// \internal
 	NetworkID GetNewNetworkID(void);
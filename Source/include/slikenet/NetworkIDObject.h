@@ -83,10 +83,6 @@ protected:
 
 	/// The parent set by SetParent()
 	void *parent;
-
-	/// \internal, used by NetworkIDManager
-	friend class NetworkIDManager;
-	NetworkIDObject *nextInstanceForNetworkIDManager;
 };
 
 } // namespace SLNet
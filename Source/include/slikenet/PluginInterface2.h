@@ -111,6 +111,13 @@ public:
 	/// \return True to allow the game and other plugins to get this message, false to absorb it
 	virtual PluginReceiveResult OnReceive(Packet *packet) {(void) packet; return RR_CONTINUE_PROCESSING;}
 
+	/// Queried when attached to RakPeer
+	/// Return true to have RakPeer call OnReceive() only for messages whose first byte is set in \a messageIDs, so other messages skip this plugin
+	/// Return false to have OnReceive() called for every message
+	/// A message starting with ID_TIMESTAMP is only passed on if ID_TIMESTAMP is set. TCPInterface still calls OnReceive() for every message
+	/// \param[out] messageIDs One entry for each message ID, all false when called
+	virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const {(void) messageIDs; return false;}
+
 	/// Called when RakPeer is initialized
 	virtual void OnRakPeerStartup(void) {}
 
@@ -198,6 +205,8 @@ protected:
 	void SendUnified( const SLNet::BitStream * bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast );
 	void SendUnified( const char * data, const int length, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast );
 	bool SendListUnified( const char **data, const int *lengths, const int numParameters, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast );
+	// Send the same message to each of \a targets. Through rakPeerInterface the message is copied only once for all of them
+	void SendToListUnified( const SLNet::BitStream * bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID *targets, unsigned int numTargets );
 
 	Packet *AllocatePacketUnified(unsigned dataSize);
 	void PushBackPacketUnified(Packet *packet, bool pushAtHead);
@@ -36,6 +36,7 @@
 #include "DS_RangeList.h"
 #include "DS_BPlusTree.h"
 #include "DS_MemoryPool.h"
+#include "ConnectionArena.h"
 #include "defines.h"
 #include "DS_Heap.h"
 #include "BitStream.h"
@@ -45,11 +46,12 @@
 #include "Rand.h"
 #include "socket2.h"
 
+#include "CCRakNetInterface.h"
+
+// The datagram format follows the default congestion control, so that both ends agree on it whatever controller each connection uses
 #if USE_SLIDING_WINDOW_CONGESTION_CONTROL!=1
-#include "CCRakNetUDT.h"
 #define INCLUDE_TIMESTAMP_WITH_DATAGRAMS 1
 #else
-#include "CCRakNetSlidingWindow.h"
 #define INCLUDE_TIMESTAMP_WITH_DATAGRAMS 0
 #endif
 
@@ -183,11 +185,31 @@ public:
 	/// \param[in] systemAddress The player that this data is from
 	/// \param[in] messageHandlerList A list of registered plugins
 	/// \param[in] mtuSize maximum datagram size
+	/// \param[in] decryptedLength The length DecryptDatagrams() decrypted \a buffer to, or DATAGRAM_NOT_DECRYPTED or DATAGRAM_NOT_AUTHENTIC. \a length stays the length that was received
 	/// \retval true Success
 	/// \retval false Modified packet
 	bool HandleSocketReceiveFromConnectedPlayer(
 		const char *buffer, unsigned int length, SystemAddress &systemAddress, DataStructures::List<PluginInterface2*> &messageHandlerList, int mtuSize,
-		RakNetSocket2 *s, RakNetRandom *rnr, CCTimeType timeRead, BitStream &updateBitStream);
+		RakNetSocket2 *s, RakNetRandom *rnr, CCTimeType timeRead, BitStream &updateBitStream, int decryptedLength=DATAGRAM_NOT_DECRYPTED);
+
+	/// Values of \a decryptedLength in HandleSocketReceiveFromConnectedPlayer() that are not a length
+	enum
+	{
+		/// The datagram is still encrypted if security is on
+		DATAGRAM_NOT_DECRYPTED=-1,
+		/// DecryptDatagrams() found that the datagram was not authentic. It still counts as received, as when HandleSocketReceiveFromConnectedPlayer() decrypts it
+		DATAGRAM_NOT_AUTHENTIC=-2
+	};
+
+#if LIBCAT_SECURITY==1
+	/// Decrypts several datagrams from this system together, with the same results as HandleSocketReceiveFromConnectedPlayer() decrypting them in the order given
+	/// Then pass every datagram to HandleSocketReceiveFromConnectedPlayer() with its received length and \a decryptedLength, in the same order
+	/// \param[in,out] buffers The datagrams, decrypted in place
+	/// \param[in] lengths Length of each datagram as it was received
+	/// \param[out] decryptedLengths Length of each decrypted datagram, or DATAGRAM_NOT_AUTHENTIC
+	/// \param[in] count Number of datagrams
+	void DecryptDatagrams(char **buffers, const unsigned int *lengths, int *decryptedLengths, unsigned int count);
+#endif
 
 	/// This allocates bytes and writes a user-level message to those bytes.
 	/// \param[out] data The message
@@ -204,8 +226,9 @@ public:
 	/// \param[in] MTUSize maximum datagram size
 	/// \param[in] currentTime Current time, as per SLNet::GetTimeMS()
 	/// \param[in] receipt This number will be returned back with ID_SND_RECEIPT_ACKED or ID_SND_RECEIPT_LOSS and is only returned with the reliability types that contain RECEIPT in the name
+	/// \param[in] sharedSendBuffer If not 0, \a data is the data of this buffer. It is referenced rather than copied, and \a makeDataCopy is ignored.
 	/// \return True or false for success or failure.
-	bool Send( char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, unsigned char orderingChannel, bool makeDataCopy, int MTUSize, CCTimeType currentTime, uint32_t receipt );
+	bool Send( char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, unsigned char orderingChannel, bool makeDataCopy, int MTUSize, CCTimeType currentTime, uint32_t receipt, SharedSendBuffer *sharedSendBuffer=0 );
 
 	/// Call once per game cycle.  Handles internal lists and actually does the send.
 	/// \param[in] s the communication  end point
@@ -242,6 +265,13 @@ public:
 	bool IsOutgoingDataWaiting(void);
 	bool AreAcksWaiting(void);
 
+	/// How long until Update() next has timed work to do: a resend, buffered acks, a send receipt timeout, or culling unreliable messages
+	/// Does not include incoming datagrams, which the caller is woken for separately
+	/// \param[in] time The same time value that would be passed to Update()
+	/// \param[in] maxWait Upper bound on the returned value, in microseconds
+	/// \return Microseconds to wait, 0 if Update() should run right away
+	SLNet::TimeUS GetTimeUntilNextUpdate( CCTimeType time, SLNet::TimeUS maxWait );
+
 	// Set outgoing lag and packet loss properties
 	void ApplyNetworkSimulator( double _maxSendBPS, SLNet::TimeMS _minExtraPing, SLNet::TimeMS _extraPingVariance );
 
@@ -251,6 +281,25 @@ public:
 
 	void SetSplitMessageProgressInterval(int interval);
 	void SetUnreliableTimeout(SLNet::TimeMS timeoutMS);
+
+	/// Where the arena of this layer gets its pages from. Only call while the layer holds no memory, such as right after it was constructed.
+	void SetArenaPagePool(ArenaPagePool *pagePool);
+	/// \param[in] bytes How much memory the packets, datagram history and outgoing messages of this layer may use before IsOverMemoryBudget() returns true. 0 for no limit.
+	void SetMemoryBudget(unsigned int bytes);
+	unsigned int GetMemoryBudget(void) const;
+	/// Threadsafe
+	bool IsOverMemoryBudget(void) const;
+	/// Threadsafe. Counts a message that was not sent because IsOverMemoryBudget() returned true, for GetStatistics()
+	void OnMessageRefusedByMemoryBudget(void);
+
+	/// Spreads the datagrams of each update over time, at the rate given by CCRakNetInterface::GetPacingRate()
+	/// \param[in] maxBurstDatagrams How many datagrams may be sent back to back. 0 to send everything congestion control allows at once (default).
+	void SetPacing(unsigned int maxBurstDatagrams);
+	unsigned int GetPacing(void) const;
+
+	/// Replaces the congestion control of this layer. The new controller continues the datagram numbering and the acks of the old one, so this may be called while connected.
+	void SetCongestionControl(CongestionControlType type);
+	CongestionControlType GetCongestionControl(void) const;
 	/// Has a lot of time passed since the last ack
 	bool AckTimeout(SLNet::Time curTime);
 	CCTimeType GetNextSendTime(void) const;
@@ -273,6 +322,11 @@ private:
 	/// \param[in] bitStream The data to send.
 	void SendBitStream( RakNetSocket2 *s, SystemAddress &systemAddress, SLNet::BitStream *bitStream, RakNetRandom *rnr, CCTimeType currentTime);
 
+#if RAKNET_SOCKET_BATCH_SIZE>1
+	/// Send the datagrams that SendBitStream() added to sendBatch, encrypting them together first on secure connections
+	void FlushSendBatch( RakNetSocket2 *s );
+#endif
+
 	///Parse an internalPacket and create a bitstream to represent this data
 	/// \return Returns number of bits used
 	BitSize_t WriteToBitStreamFromInternalPacket(SLNet::BitStream *bitStream, const InternalPacket *const internalPacket, CCTimeType curTime );
@@ -402,7 +456,7 @@ private:
 	// This is essentially an O(1) lookup to get a DatagramHistoryNode given an index
 	// datagramHistory holds a linked list of MessageNumberNode. Each MessageNumberNode refers to one element in resendList which can be cleared on an ack.
 	DataStructures::Queue<DatagramHistoryNode> datagramHistory;
-	DataStructures::MemoryPool<MessageNumberNode> datagramHistoryMessagePool;
+	ArenaMemoryPool<MessageNumberNode> datagramHistoryMessagePool;
 
 	struct UnreliableWithAckReceiptNode
 	{
@@ -423,9 +477,17 @@ private:
 	MessageNumberNode* AddSubsequentToDatagramHistory(MessageNumberNode *messageNumberNode, DatagramSequenceNumberType messageNumber);
 	DatagramSequenceNumberType datagramHistoryPopCount;
 	
-	DataStructures::MemoryPool<InternalPacket> internalPacketPool;
+	ArenaMemoryPool<InternalPacket> internalPacketPool;
 	// DataStructures::BPlusTree<DatagramSequenceNumberType, InternalPacket*, RESEND_TREE_ORDER> resendTree;
-	InternalPacket *resendBuffer[RESEND_BUFFER_ARRAY_LENGTH];
+	// Reliable messages waiting for an ack, at reliableMessageNumber & resendBufferMask. 0 until the first reliable message is sent.
+	// From the arena, doubled by ResendBufferOverflow() when full, and released after RESEND_BUFFER_IDLE_TIME_MS without messages in flight
+	InternalPacket **resendBuffer;
+	uint32_t resendBufferMask;
+	CCTimeType resendBufferLastUseTime;
+	bool GrowResendBuffer(void);
+	void ReleaseResendBuffer(void);
+	// How many datagrams to keep in datagramHistory, enough for the acks of a full resendBuffer
+	unsigned int GetDatagramHistoryLength(void) const;
 	InternalPacket *resendLinkedListHead;
 	InternalPacket *unreliableLinkedListHead;
 	void RemoveFromUnreliableLinkedList(InternalPacket *internalPacket);
@@ -570,16 +632,27 @@ private:
 	CCTimeType nextAckTimeToSend;
 
 	
-#if USE_SLIDING_WINDOW_CONGESTION_CONTROL==1
-	SLNet::CCRakNetSlidingWindow congestionManager;
-#else
-	SLNet::CCRakNetUDT congestionManager;
-#endif
+	static SLNet::CCRakNetInterface *AllocateCongestionControl(CongestionControlType type);
+	SLNet::CCRakNetInterface *congestionManager;
+	CongestionControlType congestionControlType;
+
+	// Adds the bytes that pacing allowed since lastPacingTime to pacingTokens
+	void RefillPacingTokens(CCTimeType time);
+	// 0 if pacing is off
+	unsigned int pacingBurstDatagrams;
+	// Bytes that may be sent now. Negative after a datagram larger than what was left
+	double pacingTokens;
+	// Bytes per second, from the last call to RefillPacingTokens()
+	double pacingRate;
+	CCTimeType lastPacingTime;
+	// Datagrams sent by the last update that sent any, and the most sent by one update
+	unsigned int lastBurstDatagrams, largestBurstDatagrams;
 
 
 	uint32_t unacknowledgedBytes;
 	
-	bool ResendBufferOverflow(void) const;
+	// Grows resendBuffer if the next reliable message would not fit. True if it does not fit anyway
+	bool ResendBufferOverflow(void);
 	void ValidateResendList(void) const;
 	void ResetPacketsAndDatagrams(void);
 	void PushPacket(CCTimeType time, InternalPacket *internalPacket, bool isReliable);
@@ -594,6 +667,11 @@ private:
 	void SortSplitPacketList(DataStructures::List<InternalPacket*> &data, unsigned int leftEdge, unsigned int rightEdge) const;
 	void SendACKs(RakNetSocket2 *s, SystemAddress &systemAddress, CCTimeType time, RakNetRandom *rnr, BitStream &updateBitStream);
 
+#if RAKNET_SOCKET_BATCH_SIZE>1
+	// Points to the caller's stack while Update() runs, so that each Update() pass sends its datagrams together. 0 otherwise
+	RNS2_SendBatch *sendBatch;
+#endif
+
 	DataStructures::List<InternalPacket*> packetsToSendThisUpdate;
 	DataStructures::List<bool> packetsToDeallocThisUpdate;
 	// boundary is in packetsToSendThisUpdate, inclusive
@@ -625,10 +703,16 @@ private:
 	void AllocInternalPacketData(InternalPacket *internalPacket, InternalPacketRefCountedData **refCounter, unsigned char *externallyAllocatedPtr, unsigned char *ourOffset);
 	// Set the data pointer to externallyAllocatedPtr, do not allocate
 	void AllocInternalPacketData(InternalPacket *internalPacket, unsigned char *externallyAllocatedPtr);
-	// Allocate new
+	// Reference the data of sharedSendBuffer, which is released when all references are lost
+	void AllocInternalPacketData(InternalPacket *internalPacket, SharedSendBuffer *sharedSendBuffer);
+	// Allocate new. Pass true for allowStack if the data is sent, so it never leaves this layer. It is then put in stackData or in the arena
 	void AllocInternalPacketData(InternalPacket *internalPacket, unsigned int numBytes, bool allowStack, const char *file, unsigned int line);
 	void FreeInternalPacketData(InternalPacket *internalPacket, const char *file, unsigned int line);
-	DataStructures::MemoryPool<InternalPacketRefCountedData> refCountedDataPool;
+	ArenaMemoryPool<InternalPacketRefCountedData> refCountedDataPool;
+
+	// Backs internalPacketPool, datagramHistoryMessagePool, refCountedDataPool and the copies of sent messages
+	ConnectionArena arena;
+	LocklessUint32_t messagesRefusedByMemoryBudget;
 
 	BPSTracker bpsMetrics[RNS_PER_SECOND_METRICS_COUNT];
 	CCTimeType lastBpsClear;
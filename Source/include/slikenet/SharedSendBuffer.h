@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file SharedSendBuffer.h
+/// \brief A reference counted message that RakPeer sends without copying it
+///
+
+#ifndef __SHARED_SEND_BUFFER_H
+#define __SHARED_SEND_BUFFER_H
+
+#include "Export.h"
+#include "types.h"
+#include "LocklessTypes.h"
+
+namespace SLNet
+{
+
+class BitStream;
+
+/// \brief A reference counted message that RakPeer sends without copying it
+/// \details RakPeerInterface::Send() copies a message once for the send call and once more for each system it is sent to. When a message is passed
+/// in a SharedSendBuffer instead, each system and each part of a split message only reference it, so broadcasting a large message touches its memory once.
+/// Create it with Allocate() and write the message to GetData(), or move the data of a BitStream into it with Allocate(BitStream*).
+/// Send() holds a reference until the message is acknowledged or dropped by all systems it was sent to, so the data must not be changed after the first send.
+/// Call Release() when you do not need the buffer anymore. References may be released on any thread.
+class RAK_DLL_EXPORT SharedSendBuffer
+{
+public:
+	/// \param[in] numberOfBytes The size of the message
+	/// \return A buffer with one reference, or 0 when out of memory
+	static SharedSendBuffer *Allocate( unsigned int numberOfBytes, const char *file, unsigned int line );
+
+	/// Moves the data of \a bitStream into a new buffer, leaving \a bitStream empty. The data is only copied if the bitstream did not allocate it.
+	/// \return A buffer with one reference, or 0 if \a bitStream is empty
+	static SharedSendBuffer *Allocate( BitStream *bitStream, const char *file, unsigned int line );
+
+	void AddReference( void );
+
+	/// Frees the buffer when this was the last reference
+	void Release( const char *file, unsigned int line );
+
+	unsigned char *GetData( void ) const {return data;}
+
+	BitSize_t GetNumberOfBits( void ) const {return numberOfBits;}
+
+	/// Messages do not have to end on a byte boundary. Defaults to all bytes passed to Allocate().
+	void SetNumberOfBits( BitSize_t bits ) {numberOfBits=bits;}
+
+	/// Other threads can change the count at any time, so this is only an estimate
+	unsigned int GetReferenceCount( void ) const {return refCount.GetValue();}
+
+protected:
+	SharedSendBuffer( unsigned char *_data, BitSize_t _numberOfBits );
+	static SharedSendBuffer *Create( unsigned char *_data, BitSize_t _numberOfBits, const char *file, unsigned int line );
+
+	unsigned char *data;
+	BitSize_t numberOfBits;
+	LocklessUint32_t refCount;
+};
+
+} // namespace SLNet
+
+#endif
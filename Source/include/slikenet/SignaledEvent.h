@@ -58,7 +58,6 @@ protected:
 
 
 #else
-	SimpleMutex isSignaledMutex;
 	bool isSignaled;
 #if !defined(ANDROID)
 	pthread_condattr_t condAttr;
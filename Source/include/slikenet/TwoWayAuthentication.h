@@ -96,6 +96,7 @@ public:
 	virtual void Update(void);
 	/// \internal
 	virtual PluginReceiveResult OnReceive(Packet *packet);
+	virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const;
 	/// \internal
 	virtual void OnRakPeerShutdown(void);
 	/// \internal
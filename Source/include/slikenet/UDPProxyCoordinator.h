@@ -56,6 +56,7 @@ namespace SLNet
 		/// \internal
 		virtual void Update(void);
 		virtual PluginReceiveResult OnReceive(Packet *packet);
+		virtual bool GetReceivedMessageIDs(bool messageIDs[256]) const;
 		virtual void OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason );
 
 		struct SenderAndTargetAddress
@@ -19,6 +19,7 @@
 #if (defined(__GNUC__) || defined(__ARMCC_VERSION) || defined(__GCCXML__) || defined(__S3E__) ) && !defined(__WIN32)
 
 #include <dirent.h>
+#include <time.h>
 
 #include "string.h"
 
@@ -44,6 +45,7 @@ typedef struct _finddata_t
 {
 	char            name[STRING_BUFFER_SIZE];
 	int            attrib;
+	time_t          time_write;
 	unsigned long   size;
 } _finddata;
 
@@ -134,9 +134,25 @@
 /// This is the maximum number of reliable user messages that can be on the wire at a time
 /// If this is too low, then high ping connections with a large throughput will be underutilized
 /// This will be evident because RakNetStatistics::messagesInSend buffer will increase over time, yet at the same time the outgoing bandwidth per second is less than your connection supports
+/// Each connection starts with room for RESEND_BUFFER_INITIAL_LENGTH messages when it first sends a reliable message, and doubles that up to this many while congestion control lets more be in flight
+/// Must be a power of two
 #ifndef RESEND_BUFFER_ARRAY_LENGTH
-#define RESEND_BUFFER_ARRAY_LENGTH 512
-#define RESEND_BUFFER_ARRAY_MASK 511
+#define RESEND_BUFFER_ARRAY_LENGTH 65536
+#endif
+
+/// Must be a power of two, and not more than RESEND_BUFFER_ARRAY_LENGTH
+#ifndef RESEND_BUFFER_INITIAL_LENGTH
+#define RESEND_BUFFER_INITIAL_LENGTH 64
+#endif
+
+/// After this many milliseconds without reliable messages in flight, a connection frees its resend buffer
+#ifndef RESEND_BUFFER_IDLE_TIME_MS
+#define RESEND_BUFFER_IDLE_TIME_MS 1000
+#endif
+
+/// RakString stores strings of up to this many bytes, including the terminating 0, in the object itself rather than in a reference counted allocation
+#ifndef RAKSTRING_INLINE_SIZE
+#define RAKSTRING_INLINE_SIZE 24
 #endif
 
 /// Uncomment if you want to link in the DLMalloc library to use with RakMemoryOverride
@@ -150,7 +166,35 @@
 #define GET_TIME_SPIKE_LIMIT 0
 #endif
 
-// Use sliding window congestion control instead of ping based congestion control
+/// RakPeer's update thread sleeps until the next resend, ack, ping or keep-alive is due, but never longer than this many milliseconds
+/// Incoming datagrams, shutdown and sends to an idle peer wake it right away
+#ifndef UPDATE_NETWORK_LOOP_MAX_WAIT_MS
+#define UPDATE_NETWORK_LOOP_MAX_WAIT_MS 1000
+#endif
+
+/// Non-immediate sends buffered while RakPeer's update thread is busy are sent at least this often, in milliseconds
+#ifndef UPDATE_NETWORK_LOOP_SEND_INTERVAL_MS
+#define UPDATE_NETWORK_LOOP_SEND_INTERVAL_MS 10
+#endif
+
+/// Linux only: each recvmmsg() call reads up to this many datagrams, and the datagrams of one ReliabilityLayer::Update() pass go out with up to this many per sendmmsg() call
+/// Define as 1 to use one recvfrom() and one sendto() per datagram
+#ifndef RAKNET_SOCKET_BATCH_SIZE
+#if defined(__linux__) && !defined(ANDROID)
+#define RAKNET_SOCKET_BATCH_SIZE 16
+#else
+#define RAKNET_SOCKET_BATCH_SIZE 1
+#endif
+#endif
+
+/// Linux only: coalesce back to back datagrams of equal size to the same system into one UDP_SEGMENT (GSO) send, and accept UDP_GRO coalesced receives
+/// A socket falls back to one datagram per send and receive if the kernel rejects these options. Requires RAKNET_SOCKET_BATCH_SIZE>1
+#ifndef RAKNET_SOCKET_UDP_OFFLOAD
+#define RAKNET_SOCKET_UDP_OFFLOAD 1
+#endif
+
+// Use sliding window congestion control instead of ping based congestion control for connections that did not choose one with RakPeerInterface::SetCongestionControl()
+// Also decides whether datagrams carry a timestamp, so both ends of a connection need the same value
 #ifndef USE_SLIDING_WINDOW_CONGESTION_CONTROL
 #define USE_SLIDING_WINDOW_CONGESTION_CONTROL 1
 #endif
@@ -193,10 +237,17 @@
 #define BUFFERED_PACKETS_PAGE_SIZE 8
 #endif
 
-// Controls how many allocations occur at once for the memory pool of incoming or outgoing datagrams.
-// Has small effect on memory usage per connection. Uses about 256 bytes*INTERNAL_PACKET_PAGE_SIZE per connection
-#ifndef INTERNAL_PACKET_PAGE_SIZE
-#define INTERNAL_PACKET_PAGE_SIZE 8
+// Size of the pages that the internal packets, datagram history and outgoing message copies of each connection are allocated from.
+// Each connection holds at least one page while it sends or receives. Pages of closed connections are reused by new ones until RakPeer::Shutdown()
+// Messages up to about 2000 bytes are copied into pages, if they fit. Must be a multiple of 16
+#ifndef CONNECTION_ARENA_PAGE_SIZE
+#define CONNECTION_ARENA_PAGE_SIZE 4096
+#endif
+
+// Number of packets, or commands such as Send(), that can wait between the user threads and the network thread of RakPeer without locking a mutex
+// More spill over into a mutex guarded queue. Uses about 16 bytes*RAKPEER_THREAD_QUEUE_RING_SIZE per instance of RakPeer, rounded up to a power of two
+#ifndef RAKPEER_THREAD_QUEUE_RING_SIZE
+#define RAKPEER_THREAD_QUEUE_RING_SIZE 4096
 #endif
 
 // If defined to 1, the user is responsible for calling RakPeer::RunUpdateCycle and RakPeer::RunRecvfrom
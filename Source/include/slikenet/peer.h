@@ -36,11 +36,14 @@
 //#include "socket.h"
 #include "smartptr.h"
 #include "DS_ThreadsafeAllocatingQueue.h"
+#include "DS_LocklessQueue.h"
+#include "BanList.h"
 #include "SignaledEvent.h"
 #include "NativeFeatureIncludes.h"
 #include "SecureHandshake.h"
 #include "LocklessTypes.h"
 #include "DS_Queue.h"
+#include "ThreadPool.h"
 
 namespace SLNet {
 /// Forward declarations
@@ -113,6 +116,24 @@ public:
 	/// \return True if the IP address is found in security exception list, else returns false.
 	bool IsInSecurityExceptionList(const char *ip);
 
+	/// \brief Answers the challenges of incoming secure connections on worker threads, instead of on the network thread.
+	/// \details Answering the challenge in ID_OPEN_CONNECTION_REQUEST_2 takes a key agreement, which is most of the CPU time of accepting a secure connection.
+	/// With \a numberOfThreads greater than 0, challenges are queued for the worker threads and the answers are sent from the network thread once they are ready.
+	/// Connection requests that arrive while \a maxQueueLength challenges are pending are ignored, and the client sends them again as if they were lost.
+	/// \pre Must be called while offline. Calls made after Startup() take effect on the next Startup().
+	/// \pre LIBCAT_SECURITY must be defined to 1 in NativeFeatureIncludes.h for this function to have any effect
+	/// \param[in] numberOfThreads Number of worker threads. 0 (the default) answers challenges on the network thread.
+	/// \param[in] maxQueueLength Maximum number of challenges that are queued or being answered at the same time.
+	void SetSecureHandshakeThreads( unsigned int numberOfThreads, unsigned int maxQueueLength=1024 );
+
+	/// \brief Returns counters for the challenges of incoming secure connections since Startup(), see SetSecureHandshakeThreads()
+	/// \param[out] answeredCount How many challenges were answered
+	/// \param[out] failedCount How many challenges were invalid
+	/// \param[out] droppedCount How many connection requests were ignored because \a maxQueueLength challenges were pending
+	/// \param[out] queueLength How many challenges are queued or being answered now
+	/// \param[out] maxQueueLength The highest \a queueLength so far
+	void GetSecureHandshakeStatistics( uint32_t *answeredCount, uint32_t *failedCount, uint32_t *droppedCount, unsigned int *queueLength, unsigned int *maxQueueLength );
+
 	/// \brief Sets the maximum number of incoming connections allowed.
 	/// \details If the number of incoming connections is less than the number of players currently connected,
 	/// no more players will be allowed to connect.  If this is greater than the maximum number of peers allowed,
@@ -248,6 +269,39 @@ public:
 	/// \note COMMON MISTAKE: When writing the first byte, bitStream->Write((unsigned char) ID_MY_TYPE) be sure it is casted to a byte, and you are not writing a 4 byte enumeration.
 	uint32_t Send( const SLNet::BitStream * bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, uint32_t forceReceiptNumber=0 );
 
+	/// \brief Sends a block of data to the specified system that you are connected to.
+	/// 
+	/// Same as the above version, but does not copy the data. Broadcasting a large message with this touches its memory once, rather than once for each system.
+	/// The systems it is sent to, and the parts of the message if it is split, reference \a sharedSendBuffer until they are done with it. See SharedSendBuffer.
+	/// \param[in] sharedSendBuffer Data to send. Send() adds its own reference, so release yours when you do not send it anymore. Do not change the data afterwards.
+	/// \param[in] priority Priority level to send on.  See PacketPriority.h
+	/// \param[in] reliability How reliably to send this data.  See PacketPriority.h
+	/// \param[in] orderingChannel Channel to order the messages on, when using ordered or sequenced messages. Messages are only ordered relative to other messages on the same stream.
+	/// \param[in] systemIdentifier System Address or RakNetGUID to send this packet to, or in the case of broadcasting, the address not to send it to.  Use UNASSIGNED_SYSTEM_ADDRESS to specify none.
+	/// \param[in] broadcast True to send this packet to all connected systems. If true, then systemAddress specifies who not to send the packet to.
+	/// \param[in] forceReceipt If 0, will automatically determine the receipt number to return. If non-zero, will return what you give it.
+	/// \return 0 on bad input. Otherwise a number that identifies this message. If \a reliability is a type that returns a receipt, on a later call to Receive() you will get ID_SND_RECEIPT_ACKED or ID_SND_RECEIPT_LOSS with bytes 1-4 inclusive containing this number
+	uint32_t Send( SharedSendBuffer *sharedSendBuffer, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, uint32_t forceReceiptNumber=0 );
+
+	/// \brief Sends the same block of data to each system in a list.
+	///
+	/// The data is copied once and buffered once for all of them, and the systems share that copy. Use this rather than calling Send() for each system, for example to notify the subscribers of a change.
+	/// \param[in] bitStream Data to send.
+	/// \param[in] priority Priority level to send on.  See PacketPriority.h
+	/// \param[in] reliability How reliably to send this data.  See PacketPriority.h
+	/// \param[in] orderingChannel Channel to order the messages on, when using ordered or sequenced messages. Messages are only ordered relative to other messages on the same stream.
+	/// \param[in] targets System Addresses or RakNetGUIDs to send to. Systems that are not connected are skipped. A system listed twice gets the data twice.
+	/// \param[in] numTargets Length of \a targets.
+	/// \param[in] forceReceipt If 0, will automatically determine the receipt number to return. If non-zero, will return what you give it.
+	/// \return 0 on bad input. Otherwise a number that identifies this message. If \a reliability is a type that returns a receipt, each system returns its own ID_SND_RECEIPT_ACKED or ID_SND_RECEIPT_LOSS with this number
+	uint32_t SendToList( const SLNet::BitStream * bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID *targets, unsigned int numTargets, uint32_t forceReceiptNumber=0 );
+
+	/// \brief Sends the same block of data to each system in a list.
+	///
+	/// Same as the above version, but does not copy the data. See SharedSendBuffer.
+	/// \param[in] sharedSendBuffer Data to send. SendToList() adds its own reference, so release yours when you do not send it anymore. Do not change the data afterwards.
+	uint32_t SendToList( SharedSendBuffer *sharedSendBuffer, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID *targets, unsigned int numTargets, uint32_t forceReceiptNumber=0 );
+
 	/// \brief Sends multiple blocks of data, concatenating them automatically.
 	///
 	/// This is equivalent to:
@@ -333,6 +387,7 @@ public:
 	/// \brief Bans an IP from connecting.
 	/// \details Banned IPs persist between connections but are not saved on shutdown nor loaded on startup.
 	/// \param[in] IP Dotted IP address. You can use * for a wildcard address, such as 128.0.0. * will ban all IP addresses starting with 128.0.0.
+	/// IPv6 addresses and CIDR ranges, such as 128.0.0.0/8 or 2001:db8::/32, are also accepted.
 	/// \param[in] milliseconds Gives time in milli seconds for a temporary ban of the IP address.  Use 0 for a permanent ban.
 	void AddToBanList( const char *IP, SLNet::TimeMS milliseconds=0 );
 
@@ -344,8 +399,8 @@ public:
 	void ClearBanList( void );
 
 	/// \brief Returns true or false indicating if a particular IP is banned.
-	/// \param[in] IP Dotted IP address.
-	/// \return True if IP matches any IPs in the ban list, accounting for any wildcards. False otherwise.
+	/// \param[in] IP Dotted IP address, or a range of addresses written like in AddToBanList().
+	/// \return True if IP matches any IPs in the ban list, accounting for any wildcards and CIDR ranges. False otherwise.
 	bool IsBanned( const char *IP );
 
 	/// \brief Enable or disable allowing frequent connections from the same IP adderss
@@ -588,6 +643,17 @@ public:
 	/// RNS2RecvStruct will only remain valid for the duration of the call
 	virtual void SetIncomingDatagramEventHandler( bool (*_incomingDatagramEventHandler)(RNS2RecvStruct *) );
 
+	/// \brief Partitions the connected systems into shards, each of which is updated by its own thread.
+	/// \details Each shard processes the incoming datagrams and runs ReliabilityLayer::Update() for its connections in parallel once per update cycle.
+	/// Connection state changes, buffered commands, and user packet dispatch remain on the main update thread.
+	/// \note While sharding is active, PluginInterface2::OnInternalPacket(), OnAck() and OnReliabilityLayerNotification() may be called concurrently from several shard threads.
+	/// \pre Must be called while offline. Calls made after Startup() take effect on the next Startup().
+	/// \param[in] numberOfShards Number of shards, including the one processed by the main update thread. 1 (the default) disables sharding.
+	virtual void SetNumberOfUpdateShards( unsigned int numberOfShards );
+
+	/// \return The value passed to SetNumberOfUpdateShards(), or 1 if it was never called.
+	virtual unsigned int GetNumberOfUpdateShards( void ) const;
+
 	// --------------------------------------------------------------------------------------------Network Simulator Functions--------------------------------------------------------------------------------------------
 	/// Adds simulated ping and packet loss to the outgoing data flow.
 	/// To simulate bi-directional ping and packet loss, you should call this on both the sender and the recipient, with half the total ping and packetloss value on each.
@@ -605,6 +671,31 @@ public:
 	/// \param[in] maxBitsPerSecond Maximum bits per second to send.  Use 0 for unlimited (default). Once set, it takes effect immedately and persists until called again.
 	virtual void SetPerConnectionOutgoingBandwidthLimit( unsigned maxBitsPerSecond );
 
+	/// Limits how much memory each connection may use for messages waiting to be sent or acknowledged, and for their bookkeeping.
+	/// While a connection is over the limit, Send() to that system returns 0, and unreliable broadcasts skip it. Reliable broadcasts are still sent.
+	/// \param[in] maxBytes Maximum bytes per connection. Use 0 for unlimited (default). Once set, it takes effect immediately and persists until called again.
+	virtual void SetPerConnectionMemoryBudget( unsigned maxBytes );
+
+	/// \return The value passed to SetPerConnectionMemoryBudget()
+	virtual unsigned GetPerConnectionMemoryBudget( void ) const;
+
+	/// Spreads the datagrams sent to each connection over time, at the rate its congestion control estimates, rather than sending everything the congestion window allows at once.
+	/// This keeps large messages from overflowing small router queues, at the cost of some CPU time for more frequent updates. See RakNetStatistics::pacingBytesPerSecond and RakNetStatistics::largestBurstDatagrams.
+	/// \param[in] maxBurstDatagrams How many datagrams may be sent back to back. Use 0 to turn pacing off (default). Once set, it takes effect immediately and persists until called again.
+	virtual void SetPerConnectionPacing( unsigned maxBurstDatagrams );
+
+	/// \return The value passed to SetPerConnectionPacing()
+	virtual unsigned GetPerConnectionPacing( void ) const;
+
+	/// Chooses the congestion control of connections. Both ends of a connection may use different controllers.
+	/// \param[in] type SLIDING_WINDOW_CONGESTION_CONTROL, UDT_CONGESTION_CONTROL or BBR_CONGESTION_CONTROL
+	/// \param[in] systemIdentifier The connection to change, which takes effect on the next update. Use UNASSIGNED_SYSTEM_ADDRESS to set the controller of connections made from now on. Defaults to DEFAULT_CONGESTION_CONTROL
+	virtual void SetCongestionControl( CongestionControlType type, const AddressOrGUID systemIdentifier );
+
+	/// \param[in] systemIdentifier A connection, or UNASSIGNED_SYSTEM_ADDRESS for the controller of new connections
+	/// \return The congestion control used by \a systemIdentifier. The controller of new connections if it is not connected.
+	virtual CongestionControlType GetCongestionControl( const AddressOrGUID systemIdentifier ) const;
+
 	/// Returns if you previously called ApplyNetworkSimulator
 	/// \return If you previously called ApplyNetworkSimulator
 	virtual bool IsNetworkSimulatorActive( void );
@@ -631,6 +722,11 @@ public:
 	/// \Returns how many messages are waiting when you call Receive()
 	virtual unsigned int GetReceiveBufferSize(void);
 
+	/// \brief Returns counters for the queues and the packet cache that pass data between your threads and the network thread
+	/// \param[out] contentionCount How often a thread had to retry, or lock a mutex, because other threads used the same queue or cache at the same time
+	/// \param[out] overflowCount How many packets and commands did not fit into the lock-free ring buffers, see RAKPEER_THREAD_QUEUE_RING_SIZE
+	virtual void GetThreadQueueStatistics( uint32_t *contentionCount, uint32_t *overflowCount );
+
 	// --------------------------------------------------------------------------------------------EVERYTHING AFTER THIS COMMENT IS FOR INTERNAL USE ONLY--------------------------------------------------------------------------------------------
 
 
@@ -663,6 +759,22 @@ public:
 		SLNet::Time clockDifferential;
 	};
 
+#if LIBCAT_SECURITY==1
+	/// \internal
+	/// \brief A challenge from ID_OPEN_CONNECTION_REQUEST_2 that is answered on a worker thread, see SetSecureHandshakeThreads()
+	struct SecureHandshakeJob
+	{
+		RakPeer *rakPeer;
+		SystemAddress systemAddress;
+		uint16_t mtu;
+		char challenge[cat::EasyHandshake::CHALLENGE_BYTES];
+		// Set by the worker thread
+		char answer[cat::EasyHandshake::ANSWER_BYTES];
+		cat::AuthenticatedEncryption authenticatedEncryption;
+		bool succeeded;
+	};
+#endif
+
 	/// \internal
 	/// \brief All the information representing a connected system
 	struct RemoteSystemStruct
@@ -693,6 +805,9 @@ public:
 		// If the server has bRequireClientKey = true, then this is set to the validated public key of the connected client
 		// Valid after connectMode reaches HANDLING_CONNECTION_REQUEST
 		char client_public_key[cat::EasyHandshake::PUBLIC_KEY_BYTES];
+
+		// While a worker thread answers the challenge of this system, answer is not set yet
+		SecureHandshakeJob *secureHandshakeJob;
 #endif
 
 		enum ConnectMode {NO_ACTION, DISCONNECT_ASAP, DISCONNECT_ASAP_SILENTLY, DISCONNECT_ON_NO_ACK, REQUESTED_CONNECTION, HANDLING_CONNECTION_REQUEST, UNVERIFIED_SENDER, CONNECTED} connectMode;
@@ -704,6 +819,7 @@ public:
 protected:
 
 	friend RAK_THREAD_DECLARATION(UpdateNetworkLoop);
+	friend RAK_THREAD_DECLARATION(UpdateShardLoop);
 	//friend RAK_THREAD_DECLARATION(RecvFromLoop);
 	friend RAK_THREAD_DECLARATION(UDTConnect);
 
@@ -823,16 +939,10 @@ protected:
 	// bool isSocketLayerBlocking;
 	// bool continualPing,isRecvfromThreadActive,isMainLoopThreadActive, endThreads, isSocketLayerBlocking;
 	unsigned int validationInteger;
-	SimpleMutex incomingQueueMutex, banListMutex; //,synchronizedMemoryQueueMutex, automaticVariableSynchronizationMutex;
+	SimpleMutex incomingQueueMutex; //,synchronizedMemoryQueueMutex, automaticVariableSynchronizationMutex;
 	//DataStructures::Queue<Packet *> incomingpacketSingleProducerConsumer; //, synchronizedMemorypacketSingleProducerConsumer;
 	// BitStream enumerationData;
 
-	struct BanStruct
-	{
-		char *IP;
-		SLNet::TimeMS timeout; // 0 for none
-	};
-
 	struct RequestedConnectionStruct
 	{
 		SystemAddress systemAddress;
@@ -864,9 +974,13 @@ protected:
 #endif
 
 	//DataStructures::List<DataStructures::List<MemoryBlock>* > automaticVariableSynchronizationList;
-	DataStructures::List<BanStruct*> banList;
+	BanList banList;
 	// Threadsafe, and not thread safe
 	DataStructures::List<PluginInterface2*> pluginListTS, pluginListNTS;
+	// The plugins whose OnReceive() gets each message ID, in the order of pluginListTS and then pluginListNTS
+	// The plugins for message ID i are receivePluginList[receivePluginListOffsets[i]] up to receivePluginList[receivePluginListOffsets[i+1]]
+	DataStructures::List<PluginInterface2*> receivePluginList;
+	unsigned int receivePluginListOffsets[257];
 
 	DataStructures::Queue<RequestedConnectionStruct*> requestedConnectionQueue;
 	SimpleMutex requestedConnectionQueueMutex;
@@ -885,6 +999,11 @@ protected:
 		NetworkID networkID;
 		bool blockingCommand; // Only used for RPC
 		char *data;
+		// Only used by BCS_SEND. If not 0, data is the data of this buffer, and the command holds a reference of it
+		SharedSendBuffer *sharedSendBuffer;
+		// Only used by BCS_SEND. If not 0, the systems to send to instead of systemIdentifier, owned by the command
+		AddressOrGUID *targets;
+		unsigned int numTargets;
 		bool haveRakNetCloseSocket;
 		unsigned connectionSocketIndex;
 		unsigned short remotePortRakNetWasStartedOn_PS3;
@@ -892,13 +1011,15 @@ protected:
 		RakNetSocket2* socket;
 		unsigned short port;
 		uint32_t receipt;
-		enum {BCS_SEND, BCS_CLOSE_CONNECTION, BCS_GET_SOCKET, BCS_CHANGE_SYSTEM_ADDRESS,/* BCS_USE_USER_SOCKET, BCS_REBIND_SOCKET_ADDRESS, BCS_RPC, BCS_RPC_SHIFT,*/ BCS_DO_NOTHING} command;
+		// Only used by BCS_SET_CONGESTION_CONTROL
+		CongestionControlType congestionControl;
+		enum {BCS_SEND, BCS_CLOSE_CONNECTION, BCS_GET_SOCKET, BCS_CHANGE_SYSTEM_ADDRESS, BCS_SET_CONGESTION_CONTROL,/* BCS_USE_USER_SOCKET, BCS_REBIND_SOCKET_ADDRESS, BCS_RPC, BCS_RPC_SHIFT,*/ BCS_DO_NOTHING} command;
 	};
 
 	// Single producer single consumer queue using a linked list
 	//BufferedCommandStruct* bufferedCommandReadIndex, bufferedCommandWriteIndex;
 
-	DataStructures::ThreadsafeAllocatingQueue<BufferedCommandStruct> bufferedCommands;
+	DataStructures::LocklessAllocatingQueue<BufferedCommandStruct> bufferedCommands;
 
 
 	// DataStructures::ThreadsafeAllocatingQueue<RNS2RecvStruct> bufferedPackets;
@@ -929,9 +1050,11 @@ protected:
 	void PingInternal( const SystemAddress target, bool performImmediate, PacketReliability reliability );
 	// This stores the user send calls to be handled by the update thread.  This way we don't have thread contention over systemAddresss
 	void CloseConnectionInternal( const AddressOrGUID& systemIdentifier, bool sendDisconnectionNotification, bool performImmediate, unsigned char orderingChannel, PacketPriority disconnectionNotificationPriority );
-	void SendBuffered( const char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, RemoteSystemStruct::ConnectMode connectionMode, uint32_t receipt );
+	void SendBuffered( const char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, RemoteSystemStruct::ConnectMode connectionMode, uint32_t receipt, SharedSendBuffer *sharedSendBuffer=0, AddressOrGUID *targets=0, unsigned int numTargets=0 );
 	void SendBufferedList( const char **data, const int *lengths, const int numParameters, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, RemoteSystemStruct::ConnectMode connectionMode, uint32_t receipt );
-	bool SendImmediate( char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, bool useCallerDataAllocation, SLNet::TimeUS currentTime, uint32_t receipt );
+	bool SendImmediate( char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, bool useCallerDataAllocation, SLNet::TimeUS currentTime, uint32_t receipt, SharedSendBuffer *sharedSendBuffer=0, const AddressOrGUID *targets=0, unsigned int numTargets=0 );
+	// True if a send to this one system should be refused because its connection is over perConnectionMemoryBudget
+	bool IsOverMemoryBudget( const AddressOrGUID systemIdentifier );
 	//bool HandleBufferedRPC(BufferedCommandStruct *bcs, SLNet::TimeMS time);
 	void ClearBufferedCommands(void);
 	void ClearBufferedPackets(void);
@@ -963,6 +1086,11 @@ protected:
 	RakNetGUID myGuid;
 
 	unsigned maxOutgoingBPS;
+	unsigned perConnectionMemoryBudget;
+	CongestionControlType defaultCongestionControl;
+	unsigned perConnectionPacing;
+	// Pages of the ConnectionArena of each reliability layer, kept when a connection closes for the next one
+	ArenaPagePool arenaPagePool;
 
 	// Nobody would use the internet simulator in a final build.
 #ifdef _DEBUG
@@ -993,13 +1121,17 @@ protected:
 
 
 	SignaledEvent quitAndDataEvents;
+	/// 1 while UpdateNetworkLoop sleeps longer than the usual send interval, so that buffered commands wake it.
+	/// Only changed with CompareAndSet(), which is a full barrier, so that either the loop sees a command that was just buffered or the sender sees the loop idle
+	LocklessUint32_t updateNetworkLoopIdle;
+	/// How long UpdateNetworkLoop can sleep before a resend, ack, ping, keep-alive or connection attempt is due
+	SLNet::TimeMS GetUpdateNetworkLoopWaitTime(void);
+	void WakeIdleUpdateNetworkLoop(void);
 	bool limitConnectionFrequencyFromTheSameIP;
 
-	SimpleMutex packetAllocationPoolMutex;
-	DataStructures::MemoryPool<Packet> packetAllocationPool;
+	DataStructures::MagazineMemoryPool<Packet> packetAllocationPool;
 
-	SimpleMutex packetReturnMutex;
-	DataStructures::Queue<Packet*> packetReturnQueue;
+	DataStructures::LocklessQueue<Packet*> packetReturnQueue;
 	Packet *AllocPacket(unsigned dataSize, const char *file, unsigned int line);
 	Packet *AllocPacket(unsigned dataSize, unsigned char *data, const char *file, unsigned int line);
 
@@ -1011,6 +1143,8 @@ protected:
 	void ResetSendReceipt(void);
 	void OnConnectedPong(SLNet::Time sendPingTime, SLNet::Time sendPongTime, RemoteSystemStruct *remoteSystem);
 	void CallPluginCallbacks(DataStructures::List<PluginInterface2*> &pluginList, Packet *packet);
+	// Fills receivePluginList from GetReceivedMessageIDs() of the attached plugins
+	void UpdateReceivePluginList(void);
 
 #if LIBCAT_SECURITY==1
 	// Encryption and security
@@ -1019,6 +1153,17 @@ protected:
 	cat::ServerEasyHandshake *_server_handshake;
 	cat::CookieJar *_cookie_jar;
 	bool InitializeClientSecurity(RequestedConnectionStruct *rcs, const char *public_key);
+
+	// Worker threads answering challenges, see SetSecureHandshakeThreads()
+	char my_private_key[cat::EasyHandshake::PRIVATE_KEY_BYTES];
+	unsigned int secureHandshakeThreadCount, maxSecureHandshakeQueueLength;
+	ThreadPool<SecureHandshakeJob*,SecureHandshakeJob*> secureHandshakeThreadPool;
+	// Only changed by the network thread
+	unsigned int secureHandshakeQueueLength, maxSecureHandshakeQueueLengthReached;
+	uint32_t secureHandshakesAnswered, secureHandshakesFailed, secureHandshakesDropped;
+	void StopSecureHandshakeThreads(void);
+	void ProcessSecureHandshakeResults(void);
+	static SecureHandshakeJob* AnswerSecureHandshakeCB(SecureHandshakeJob *job, bool *returnOutput, void* perThreadData);
 #endif
 
 
@@ -1029,6 +1174,39 @@ protected:
 	virtual void OnRNS2Recv(RNS2RecvStruct *recvStruct);
 	void FillIPList(void);
 
+	/// \internal
+	/// \brief A partition of the connected systems, see SetNumberOfUpdateShards()
+	/// A connection belongs to the shard remoteSystemIndex % updateShardCount. The lists are filled by the main update thread and only
+	/// processed by the shard while the main update thread waits for all shards to complete.
+	struct UpdateShard
+	{
+		UpdateShard();
+		~UpdateShard();
+
+		RakPeer *rakPeer;
+		DataStructures::List<RemoteSystemStruct*> remoteSystems;
+		DataStructures::List<RNS2RecvStruct*> incomingDatagrams;
+		BitStream updateBitStream;
+		RakNetRandom rnr;
+		SignaledEvent workEvent;
+		// Protected by updateShardMutex
+		bool hasWork;
+		volatile bool endThread;
+		volatile bool isThreadActive;
+	};
+	unsigned int updateShardCount;
+	unsigned int requestedUpdateShardCount;
+	UpdateShard *updateShards;
+	SimpleMutex updateShardMutex;
+	unsigned int updateShardsPending;
+	SignaledEvent updateShardsDoneEvent;
+	SLNet::TimeUS updateShardsTime;
+	bool updateShardsForceACKs;
+	bool StartUpdateShards(int threadPriority);
+	void StopUpdateShards(void);
+	void RunUpdateShards(void);
+	void RunUpdateShard(UpdateShard *shard);
+
 	private:
 		// internal helpers
 		void CloseConnectionInternal2(const AddressOrGUID& systemIdentifier, bool sendDisconnectionNotification, bool performImmediate, unsigned char orderingChannel, PacketPriority disconnectionNotificationPriority, RakNetSocket2& socket);
@@ -29,11 +29,13 @@
 #include "DS_List.h"
 #include "smartptr.h"
 #include "socket2.h"
+#include "CCRakNetInterface.h"
 
 namespace SLNet
 {
 // Forward declarations
 class BitStream;
+class SharedSendBuffer;
 class PluginInterface2;
 struct RPCMap;
 struct RakNetStatistics;
@@ -97,6 +99,24 @@ public:
 	/// \param[in] IP address to check.
 	virtual bool IsInSecurityExceptionList(const char *ip)=0;
 
+	/// \brief Answers the challenges of incoming secure connections on worker threads, instead of on the network thread.
+	/// \details Answering the challenge in ID_OPEN_CONNECTION_REQUEST_2 takes a key agreement, which is most of the CPU time of accepting a secure connection.
+	/// With \a numberOfThreads greater than 0, challenges are queued for the worker threads and the answers are sent from the network thread once they are ready.
+	/// Connection requests that arrive while \a maxQueueLength challenges are pending are ignored, and the client sends them again as if they were lost.
+	/// \pre Must be called while offline. Calls made after Startup() take effect on the next Startup().
+	/// \pre LIBCAT_SECURITY must be defined to 1 in NativeFeatureIncludes.h for this function to have any effect
+	/// \param[in] numberOfThreads Number of worker threads. 0 (the default) answers challenges on the network thread.
+	/// \param[in] maxQueueLength Maximum number of challenges that are queued or being answered at the same time.
+	virtual void SetSecureHandshakeThreads( unsigned int numberOfThreads, unsigned int maxQueueLength=1024 )=0;
+
+	/// \brief Returns counters for the challenges of incoming secure connections since Startup(), see SetSecureHandshakeThreads()
+	/// \param[out] answeredCount How many challenges were answered
+	/// \param[out] failedCount How many challenges were invalid
+	/// \param[out] droppedCount How many connection requests were ignored because \a maxQueueLength challenges were pending
+	/// \param[out] queueLength How many challenges are queued or being answered now
+	/// \param[out] maxQueueLength The highest \a queueLength so far
+	virtual void GetSecureHandshakeStatistics( uint32_t *answeredCount, uint32_t *failedCount, uint32_t *droppedCount, unsigned int *queueLength, unsigned int *maxQueueLength )=0;
+
 	/// Sets how many incoming connections are allowed. If this is less than the number of players currently connected,
 	/// no more players will be allowed to connect.  If this is greater than the maximum number of peers allowed,
 	/// it will be reduced to the maximum number of peers allowed.
@@ -221,6 +241,34 @@ public:
 	/// \note COMMON MISTAKE: When writing the first byte, bitStream->Write((unsigned char) ID_MY_TYPE) be sure it is casted to a byte, and you are not writing a 4 byte enumeration.
 	virtual uint32_t Send( const SLNet::BitStream * bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, uint32_t forceReceiptNumber=0 )=0;
 
+	/// Sends a block of data to the specified system that you are connected to.  Same as the above version, but does not copy the data.
+	/// The systems it is sent to, and the parts of the message if it is split, reference \a sharedSendBuffer until they are done with it. See SharedSendBuffer.
+	/// \param[in] sharedSendBuffer The data to send. Send() adds its own reference, so release yours when you do not send it anymore. Do not change the data afterwards.
+	/// \param[in] priority What priority level to send on.  See PacketPriority.h
+	/// \param[in] reliability How reliability to send this data.  See PacketPriority.h
+	/// \param[in] orderingChannel When using ordered or sequenced messages, what channel to order these on. Messages are only ordered relative to other messages on the same stream
+	/// \param[in] systemIdentifier Who to send this packet to, or in the case of broadcasting who not to send it to. Pass either a SystemAddress structure or a RakNetGUID structure. Use UNASSIGNED_SYSTEM_ADDRESS or to specify none
+	/// \param[in] broadcast True to send this packet to all connected systems. If true, then systemAddress specifies who not to send the packet to.
+	/// \param[in] forceReceipt If 0, will automatically determine the receipt number to return. If non-zero, will return what you give it.
+	/// \return 0 on bad input. Otherwise a number that identifies this message. If \a reliability is a type that returns a receipt, on a later call to Receive() you will get ID_SND_RECEIPT_ACKED or ID_SND_RECEIPT_LOSS with bytes 1-4 inclusive containing this number
+	virtual uint32_t Send( SharedSendBuffer *sharedSendBuffer, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, uint32_t forceReceiptNumber=0 )=0;
+
+	/// Sends the same block of data to each system in a list. The data is copied once and buffered once for all of them, and the systems share that copy.
+	/// Use this rather than calling Send() for each system, for example to notify the subscribers of a change.
+	/// \param[in] bitStream The data to send
+	/// \param[in] priority What priority level to send on.  See PacketPriority.h
+	/// \param[in] reliability How reliability to send this data.  See PacketPriority.h
+	/// \param[in] orderingChannel When using ordered or sequenced messages, what channel to order these on. Messages are only ordered relative to other messages on the same stream
+	/// \param[in] targets The systems to send to. Pass either SystemAddress structures or RakNetGUID structures. Systems that are not connected are skipped. A system listed twice gets the data twice.
+	/// \param[in] numTargets Length of \a targets
+	/// \param[in] forceReceipt If 0, will automatically determine the receipt number to return. If non-zero, will return what you give it.
+	/// \return 0 on bad input. Otherwise a number that identifies this message. If \a reliability is a type that returns a receipt, each system returns its own ID_SND_RECEIPT_ACKED or ID_SND_RECEIPT_LOSS with this number
+	virtual uint32_t SendToList( const SLNet::BitStream * bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID *targets, unsigned int numTargets, uint32_t forceReceiptNumber=0 )=0;
+
+	/// Same as the above version, but does not copy the data. See SharedSendBuffer.
+	/// \param[in] sharedSendBuffer The data to send. SendToList() adds its own reference, so release yours when you do not send it anymore. Do not change the data afterwards.
+	virtual uint32_t SendToList( SharedSendBuffer *sharedSendBuffer, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID *targets, unsigned int numTargets, uint32_t forceReceiptNumber=0 )=0;
+
 	/// Sends multiple blocks of data, concatenating them automatically.
 	///
 	/// This is equivalent to:
@@ -301,6 +349,7 @@ public:
 
 	/// Bans an IP from connecting.  Banned IPs persist between connections but are not saved on shutdown nor loaded on startup.
 	/// param[in] IP Dotted IP address. Can use * as a wildcard, such as 128.0.0.* will ban all IP addresses starting with 128.0.0
+	/// IPv6 addresses and CIDR ranges, such as 128.0.0.0/8 or 2001:db8::/32, are also accepted
 	/// \param[in] milliseconds how many ms for a temporary ban.  Use 0 for a permanent ban
 	virtual void AddToBanList( const char *IP, SLNet::TimeMS milliseconds=0 )=0;
 
@@ -313,7 +362,7 @@ public:
 
 	/// Returns true or false indicating if a particular IP is banned.
 	/// \param[in] IP - Dotted IP address.
-	/// \return true if IP matches any IPs in the ban list, accounting for any wildcards. False otherwise.
+	/// \return true if IP matches any IPs in the ban list, accounting for any wildcards and CIDR ranges. False otherwise.
 	virtual bool IsBanned( const char *IP )=0;
 
 	/// Enable or disable allowing frequent connections from the same IP adderss
@@ -552,6 +601,20 @@ public:
 	/// For RakNet connected systems, the first bit is always 1. So for your own game packets, make sure the first bit is always 0.
 	virtual void SetIncomingDatagramEventHandler( bool (*_incomingDatagramEventHandler)(RNS2RecvStruct *) )=0;
 
+	/// \brief Partitions the connected systems into shards, each of which is updated by its own thread.
+	/// \details By default a single thread processes incoming datagrams and runs ReliabilityLayer::Update() for every connection.
+	/// With \a numberOfShards greater than 1, every connection is assigned to one shard and the datagram processing and reliability layer update of each shard run in parallel once per update cycle.
+	/// Packets are still returned through Receive() and connection state changes, buffered commands, and user packet dispatch remain on the main update thread.
+	/// With security, each shard also encrypts and decrypts the datagrams of its connections, decrypting the datagrams that arrived from one system one after another together.
+	/// \note While sharding is active, PluginInterface2::OnInternalPacket(), OnAck() and OnReliabilityLayerNotification() may be called concurrently from several shard threads (never concurrently for the same connection).
+	/// All other plugin callbacks keep being called from the main update thread only.
+	/// \pre Must be called while offline. Calls made after Startup() take effect on the next Startup().
+	/// \param[in] numberOfShards Number of shards, including the one processed by the main update thread. 1 (the default) disables sharding.
+	virtual void SetNumberOfUpdateShards( unsigned int numberOfShards )=0;
+
+	/// \return The value passed to SetNumberOfUpdateShards(), or 1 if it was never called.
+	virtual unsigned int GetNumberOfUpdateShards( void ) const=0;
+
 	// --------------------------------------------------------------------------------------------Network Simulator Functions--------------------------------------------------------------------------------------------
 	/// Adds simulated ping and packet loss to the outgoing data flow.
 	/// To simulate bi-directional ping and packet loss, you should call this on both the sender and the recipient, with half the total ping and packetloss value on each.
@@ -569,6 +632,31 @@ public:
 	/// \param[in] maxBitsPerSecond Maximum bits per second to send.  Use 0 for unlimited (default). Once set, it takes effect immedately and persists until called again.
 	virtual void SetPerConnectionOutgoingBandwidthLimit( unsigned maxBitsPerSecond )=0;
 
+	/// Limits how much memory each connection may use for messages waiting to be sent or acknowledged, and for their bookkeeping.
+	/// While a connection is over the limit, Send() to that system returns 0, and unreliable broadcasts skip it. Reliable broadcasts are still sent.
+	/// \param[in] maxBytes Maximum bytes per connection. Use 0 for unlimited (default). Once set, it takes effect immediately and persists until called again.
+	virtual void SetPerConnectionMemoryBudget( unsigned maxBytes )=0;
+
+	/// \return The value passed to SetPerConnectionMemoryBudget()
+	virtual unsigned GetPerConnectionMemoryBudget( void ) const=0;
+
+	/// Spreads the datagrams sent to each connection over time, at the rate its congestion control estimates, rather than sending everything the congestion window allows at once.
+	/// This keeps large messages from overflowing small router queues, at the cost of some CPU time for more frequent updates. See RakNetStatistics::pacingBytesPerSecond and RakNetStatistics::largestBurstDatagrams.
+	/// \param[in] maxBurstDatagrams How many datagrams may be sent back to back. Use 0 to turn pacing off (default). Once set, it takes effect immediately and persists until called again.
+	virtual void SetPerConnectionPacing( unsigned maxBurstDatagrams )=0;
+
+	/// \return The value passed to SetPerConnectionPacing()
+	virtual unsigned GetPerConnectionPacing( void ) const=0;
+
+	/// Chooses the congestion control of connections. Both ends of a connection may use different controllers.
+	/// \param[in] type SLIDING_WINDOW_CONGESTION_CONTROL, UDT_CONGESTION_CONTROL or BBR_CONGESTION_CONTROL
+	/// \param[in] systemIdentifier The connection to change, which takes effect on the next update. Use UNASSIGNED_SYSTEM_ADDRESS to set the controller of connections made from now on. Defaults to DEFAULT_CONGESTION_CONTROL
+	virtual void SetCongestionControl( CongestionControlType type, const AddressOrGUID systemIdentifier )=0;
+
+	/// \param[in] systemIdentifier A connection, or UNASSIGNED_SYSTEM_ADDRESS for the controller of new connections
+	/// \return The congestion control used by \a systemIdentifier. The controller of new connections if it is not connected.
+	virtual CongestionControlType GetCongestionControl( const AddressOrGUID systemIdentifier ) const=0;
+
 	/// Returns if you previously called ApplyNetworkSimulator
 	/// \return If you previously called ApplyNetworkSimulator
 	virtual bool IsNetworkSimulatorActive( void )=0;
@@ -595,6 +683,11 @@ public:
 	/// \Returns how many messages are waiting when you call Receive()
 	virtual unsigned int GetReceiveBufferSize(void)=0;
 
+	/// \brief Returns counters for the queues and the packet cache that pass data between your threads and the network thread
+	/// \param[out] contentionCount How often a thread had to retry, or lock a mutex, because other threads used the same queue or cache at the same time
+	/// \param[out] overflowCount How many packets and commands did not fit into the lock-free ring buffers, see RAKPEER_THREAD_QUEUE_RING_SIZE
+	virtual void GetThreadQueueStatistics( uint32_t *contentionCount, uint32_t *overflowCount )=0;
+
 	// --------------------------------------------------------------------------------------------EVERYTHING AFTER THIS COMMENT IS FOR INTERNAL USE ONLY--------------------------------------------------------------------------------------------
 	
 	/// \internal
@@ -34,6 +34,28 @@
 
 // #define TEST_NATIVE_CLIENT_ON_WINDOWS
 
+// recvmmsg() and sendmmsg() read and write RAKNET_SOCKET_BATCH_SIZE datagrams per system call
+#if defined(__linux__) && !defined(ANDROID) && RAKNET_SOCKET_BATCH_SIZE>1
+#define RNS2_USE_MMSG 1
+#else
+#define RNS2_USE_MMSG 0
+#endif
+
+// UDP_SEGMENT sends and UDP_GRO receives, if the kernel supports them
+#if RNS2_USE_MMSG==1 && RAKNET_SOCKET_UDP_OFFLOAD==1
+#define RNS2_USE_UDP_OFFLOAD 1
+#else
+#define RNS2_USE_UDP_OFFLOAD 0
+#endif
+
+#if RNS2_USE_UDP_OFFLOAD==1
+// Receive buffer per coalesced datagram
+#define RNS2_GRO_BUFFER_SIZE 65536
+// Kernel limits of one UDP_SEGMENT send
+#define RNS2_GSO_MAX_SEGMENTS 64
+#define RNS2_GSO_MAX_BYTES 65507
+#endif
+
 #ifdef TEST_NATIVE_CLIENT_ON_WINDOWS
 #define __native_client__
 typedef int PP_Resource;
@@ -84,6 +106,15 @@ struct RNS2_SendParameters
 	int ttl;
 };
 
+// Datagrams written during one ReliabilityLayer::Update() pass, handed to RakNetSocket2::SendBatch() together
+struct RNS2_SendBatch
+{
+	RNS2_SendBatch() {count=0;}
+	RNS2_SendParameters sendParameters[RAKNET_SOCKET_BATCH_SIZE];
+	char data[RAKNET_SOCKET_BATCH_SIZE][MAXIMUM_MTU_SIZE];
+	unsigned int count;
+};
+
 struct RNS2RecvStruct
 {
 
@@ -129,6 +160,8 @@ public:
 	// In order for the handler to trigger, some platforms must call PollRecvFrom, some platforms this create an internal thread.
 	void SetRecvEventHandler(RNS2EventHandler *_eventHandler);
 	virtual RNS2SendResult Send( RNS2_SendParameters *sendParameters, const char *file, unsigned int line )=0;
+	// Sends count datagrams. Platforms without a batched send call Send() for each one
+	virtual void SendBatch( RNS2_SendParameters *sendParameters, unsigned int count, const char *file, unsigned int line );
 	RNS2Type GetSocketType(void) const;
 	void SetSocketType(RNS2Type t);
 	bool IsBerkleySocket(void) const;
@@ -277,6 +310,7 @@ struct RNS2_BerkleyBindParameters
 	int pollingThreadPriority;
 	RNS2EventHandler *eventHandler;
 	unsigned short remotePortRakNetWasStartedOn_PS3_PS4_PSP2;
+	bool reusePort; // Sets SO_REUSEPORT before binding, so that other sockets can bind the same port. Ignored where unsupported
 };
 
 // Every platform except Windows Store 8 can use the Berkley sockets interface
@@ -317,10 +351,22 @@ protected:
 	void SetNonBlockingSocket(unsigned long nonblocking);
 	void SetSocketOptions(void);
 	void SetBroadcastSocket(int broadcast);
+	void SetReusePortSocket(int reusePort);
 	void SetIPHdrIncl(int ipHdrIncl);
 	void RecvFromBlocking(RNS2RecvStruct *recvFromStruct);
 	void RecvFromBlockingIPV4(RNS2RecvStruct *recvFromStruct);
 	void RecvFromBlockingIPV4And6(RNS2RecvStruct *recvFromStruct);
+#if RNS2_USE_MMSG==1
+	// Blocks until at least one datagram arrives, then also reads the datagrams already queued, up to count
+	// Returns the number of recvFromStructs filled, from the start of the array
+	unsigned int RecvFromBlockingBatch(RNS2RecvStruct **recvFromStructs, unsigned int count);
+	void SendToBatch( RNS2_SendParameters *sendParameters, unsigned int count, const char *file, unsigned int line );
+#endif
+#if RNS2_USE_UDP_OFFLOAD==1
+	void SetUDPOffloadSocketOptions(void);
+	// Reads coalesced datagrams into buffers, which holds RAKNET_SOCKET_BATCH_SIZE*RNS2_GRO_BUFFER_SIZE bytes, and passes each datagram to the event handler
+	void RecvFromBlockingGRO(char *buffers);
+#endif
 
 	RNS2Socket rns2Socket;
 	RNS2_BerkleyBindParameters binding;
@@ -328,6 +374,11 @@ protected:
 	unsigned RecvFromLoopInt(void);
 	SLNet::LocklessUint32_t isRecvFromLoopThreadActive;
 	volatile bool endThreads;
+#if RNS2_USE_UDP_OFFLOAD==1
+	// Cleared if the kernel rejects UDP_SEGMENT, either when binding or on a later send
+	volatile bool udpGSOEnabled;
+	bool udpGROEnabled;
+#endif
 	// Constructor not called!
 
 #if defined(__APPLE__)
@@ -446,6 +497,9 @@ class RNS2_Linux : public RNS2_Berkley, public RNS2_Windows_Linux_360
 public:
 	RNS2BindResult Bind( RNS2_BerkleyBindParameters *bindParameters, const char *file, unsigned int line );
 	RNS2SendResult Send( RNS2_SendParameters *sendParameters, const char *file, unsigned int line );
+#if RNS2_USE_MMSG==1
+	void SendBatch( RNS2_SendParameters *sendParameters, unsigned int count, const char *file, unsigned int line );
+#endif
 
 	// ----------- STATICS ------------
 	static void GetMyIP( SystemAddress addresses[MAXIMUM_NUMBER_OF_INTERNAL_IDS] );
@@ -104,6 +104,27 @@ struct RAK_DLL_EXPORT RakNetStatistics
 	/// What is the average total packetloss over the lifetime of the connection?
 	float packetlossTotal;
 
+	/// How many bytes of the memory of this connection hold internal packets, datagram history and messages waiting to be sent or acknowledged?
+	uint64_t memoryBytesInUse;
+
+	/// How many bytes are held for this connection, in arena pages and larger blocks? See also memoryBytesInUse
+	uint64_t memoryBytesReserved;
+
+	/// The limit set by RakPeer::SetPerConnectionMemoryBudget(), or 0 for none
+	uint64_t memoryBudget;
+
+	/// How many messages did Send() refuse because memoryBytesInUse reached memoryBudget?
+	uint64_t messagesRefusedByMemoryBudget;
+
+	/// Bytes per second that sends are spread at, if RakPeerInterface::SetPerConnectionPacing() was called. 0 if pacing is off or has no rate yet.
+	uint64_t pacingBytesPerSecond;
+
+	/// How many datagrams went out back to back in the last update that sent any
+	unsigned int lastBurstDatagrams;
+
+	/// The most datagrams that went out back to back in one update
+	unsigned int largestBurstDatagrams;
+
 	RakNetStatistics& operator +=(const RakNetStatistics& other)
 	{
 		unsigned i;
@@ -119,6 +140,16 @@ struct RAK_DLL_EXPORT RakNetStatistics
 			runningTotal[i]+=other.runningTotal[i];
 		}
 
+		memoryBytesInUse+=other.memoryBytesInUse;
+		memoryBytesReserved+=other.memoryBytesReserved;
+		messagesRefusedByMemoryBudget+=other.messagesRefusedByMemoryBudget;
+
+		pacingBytesPerSecond+=other.pacingBytesPerSecond;
+		if (other.lastBurstDatagrams>lastBurstDatagrams)
+			lastBurstDatagrams=other.lastBurstDatagrams;
+		if (other.largestBurstDatagrams>largestBurstDatagrams)
+			largestBurstDatagrams=other.largestBurstDatagrams;
+
 		return *this;
 	}
 };
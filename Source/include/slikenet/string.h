@@ -17,7 +17,9 @@
 #define __RAK_STRING_H 
 
 #include "Export.h"
+#include "defines.h"
 #include "DS_List.h"
+#include "LocklessTypes.h"
 #include "types.h" // int64_t
 #include <stdio.h>
 #include "stdarg.h"
@@ -34,7 +36,8 @@ class BitStream;
 
 /// \brief String class
 /// \details Has the following improvements over std::string
-/// -Reference counting: Suitable to store in lists
+/// -Reference counting: Suitable to store in lists. Copies share one allocation, with a lockless reference count
+/// -Strings of up to RAKSTRING_INLINE_SIZE bytes are stored in the object, without an allocation
 /// -Variadic assignment operator
 /// -Doesn't cause linker errors
 class RAK_DLL_EXPORT RakString
@@ -50,14 +53,17 @@ public:
 	RakString( const RakString & rhs);
 
 	/// Implicit return of const char*
-	operator const char* () const {return sharedString->c_str;}
+	operator const char* () const {return GetBuffer();}
 
 	/// Same as std::string::c_str
-	const char *C_String(void) const {return sharedString->c_str;}
+	const char *C_String(void) const {return GetBuffer();}
 
 	// Lets you modify the string. Do not make the string longer - however, you can make it shorter, or change the contents.
 	// Pointer is only valid in the scope of RakString itself
-	char *C_StringUnsafe(void) {Clone(); return sharedString->c_str;}
+	char *C_StringUnsafe(void) {Clone(); return GetBuffer();}
+
+	/// Bytes that C_StringUnsafe() may write, including the terminating 0
+	size_t GetCapacity(void) const {return sharedString ? sharedString->bytesUsed : RAKSTRING_INLINE_SIZE;}
 
 	/// Assigment operators
 	RakString& operator = ( const RakString& rhs );
@@ -247,8 +253,7 @@ public:
 	/// Fix to be a file path, ending with /
 	SLNet::RakString& MakeFilePath(void);
 
-	/// RakString uses a freeList of old no-longer used strings
-	/// Call this function to clear this memory on shutdown
+	/// RakString used to keep a freeList of old no-longer used strings. Strings are now freed when the last reference goes away, so this does nothing
 	static void FreeMemory(void);
 	/// \internal
 	static void FreeMemoryNoMutex(void);
@@ -294,43 +299,41 @@ public:
 	/// \internal
 	static size_t GetSizeToAllocate(size_t bytes)
 	{
-		const size_t smallStringSize = 128-sizeof(unsigned int)-sizeof(size_t)-sizeof(char*)*2;
-		if (bytes<=smallStringSize)
-			return smallStringSize;
+		if (bytes<=RAKSTRING_INLINE_SIZE)
+			return RAKSTRING_INLINE_SIZE;
 		else
 			return bytes*2;
 	}
 
 	/// \internal
+	/// Header of a string too long to store inline. The characters follow it in the same allocation
 	struct SharedString
 	{
-		SimpleMutex *refCountMutex;
-		unsigned int refCount;
+		LocklessUint32_t refCount;
 		size_t bytesUsed;
-		char *bigString;
-		char *c_str;
-		char smallString[128-sizeof(unsigned int)-sizeof(size_t)-sizeof(char*)*2];		
+		char *c_str(void) {return (char*) (this+1);}
 	};
 
 	/// \internal
-	RakString( SharedString *_sharedString );
+	/// Returns a SharedString with a reference count of 1 and room for bytes characters
+	static SharedString *AllocateSharedString(size_t bytes);
+	/// \internal
+	static void ReleaseSharedString(SharedString *ss);
 
 	/// \internal
-	SharedString *sharedString;
+	/// Takes over the reference of _sharedString
+	RakString( SharedString *_sharedString );
 
-//	static SimpleMutex poolMutex;
-//	static DataStructures::MemoryPool<SharedString> pool;
 	/// \internal
-	static SharedString emptyString;
+	/// 0 while the string is stored in inlineString
+	SharedString *sharedString;
 
-	//static SharedString *sharedStringFreeList;
-	//static unsigned int sharedStringFreeListAllocationCount;
 	/// \internal
-	/// List of free objects to reduce memory reallocations
-	static DataStructures::List<SharedString*> freeList;
+	char inlineString[RAKSTRING_INLINE_SIZE];
 
 	static int RakStringComp( RakString const &key, RakString const &data );
 
+	/// Does nothing. RakString does not use a global mutex anymore
 	static void LockMutex(void);
 	static void UnlockMutex(void);
 
@@ -344,7 +347,10 @@ protected:
 	void Free(void);
 	unsigned char ToLower(unsigned char c);
 	unsigned char ToUpper(unsigned char c);
-	void Realloc(SharedString *inSharedString, size_t bytes);
+	/// Make room for at least bytes bytes, keeping the contents. Call Clone() first
+	void Realloc(size_t bytes);
+	char *GetBuffer(void) {return sharedString ? sharedString->c_str() : inlineString;}
+	const char *GetBuffer(void) const {return sharedString ? sharedString->c_str() : inlineString;}
 };
 
 }
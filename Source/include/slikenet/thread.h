@@ -64,6 +64,9 @@ public:
 #else
 	static int Create( void* start_address( void* ), void *arglist, int priority=0);
 #endif
+
+	/// \return A number identifying the calling thread. Different threads usually, but not always, get different numbers
+	static unsigned int GetCurrentThreadHash(void);
 };
 
 }
@@ -165,6 +165,11 @@ struct RAK_DLL_EXPORT SocketDescriptor
 
 	/// XBOX only: set IPPROTO_VDP if you want to use VDP. If enabled, this socket does not support broadcast to 255.255.255.255
 	unsigned int extraSocketOptions;
+
+	/// Linux only: open this many sockets on the same port with SO_REUSEPORT, each with its own receive thread.
+	/// The kernel hashes each remote system to one of them, and everything sent to that system leaves on the same socket.
+	/// The extra sockets are appended to the list returned by RakPeerInterface::GetSockets() and share this descriptor's socket index. 0 or 1 opens a single socket
+	unsigned int reusePortSocketCount;
 };
 
 extern bool NonNumericHostString( const char *host );
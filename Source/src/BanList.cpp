@@ -0,0 +1,494 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file
+///
+
+#include "slikenet/BanList.h"
+#include "slikenet/GetTime.h"
+#include "slikenet/SuperFastHash.h"
+#include "slikenet/memoryoverride.h"
+#include "slikenet/assert.h"
+#include <string.h>
+#include <stdlib.h>
+#include "slikenet/WindowsIncludes.h"
+#include "slikenet/SocketDefines.h"
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+#include "slikenet/linux_adapter.h"
+
+using namespace SLNet;
+
+BanList::Entry BanList::tombstone;
+
+BanList::BanList()
+{
+	tableSize=0;
+	tableSlotsUsed=0;
+	memset(prefixLengthCounts, 0, sizeof(prefixLengthCounts));
+	table.Store(AllocateTable(64));
+	prefixLengths.Store(SLNet::OP_NEW<PrefixLengths>(_FILE_AND_LINE_));
+	prefixLengths.Load()->count=0;
+}
+BanList::~BanList()
+{
+	Clear();
+
+	Table *t = table.Load();
+	SLNet::OP_DELETE_ARRAY(t->slots, _FILE_AND_LINE_);
+	SLNet::OP_DELETE(t, _FILE_AND_LINE_);
+	SLNet::OP_DELETE(prefixLengths.Load(), _FILE_AND_LINE_);
+	FreeRetired(true);
+}
+bool BanList::Add( const char *pattern, SLNet::TimeMS milliseconds )
+{
+	unsigned char prefix[PREFIX_BYTES];
+	unsigned char prefixLength;
+	SLNet::TimeMS timeout;
+
+	if (milliseconds==0)
+		timeout=0; // Infinite
+	else
+		timeout=SLNet::GetTimeMS()+milliseconds;
+
+	if (Parse(pattern, prefix, &prefixLength)==false)
+	{
+		// Compared character by character, as before. Such patterns were never longer than 15 characters
+		if (pattern == 0 || pattern[ 0 ] == 0 || strlen( pattern ) > 15)
+			return false;
+
+		mutex.Lock();
+		unsigned int index;
+		for (index=0; index < patterns.Size(); index++)
+		{
+			if (strcmp(pattern, patterns[index]->pattern)==0)
+				break;
+		}
+		if (index==patterns.Size())
+		{
+			patterns.Insert(SLNet::OP_NEW<Pattern>(_FILE_AND_LINE_), _FILE_AND_LINE_);
+			strcpy_s(patterns[index]->pattern, pattern);
+			patternsSize.Store(patterns.Size());
+		}
+		patterns[index]->timeout=timeout;
+		mutex.Unlock();
+		return true;
+	}
+
+	Entry *entry = SLNet::OP_NEW<Entry>(_FILE_AND_LINE_);
+	memcpy(entry->prefix, prefix, PREFIX_BYTES);
+	entry->prefixLength=prefixLength;
+	entry->timeout=timeout;
+
+	mutex.Lock();
+	Entry *oldEntry;
+	LocklessPointer<Entry> *slot = FindSlot(table.Load(), prefix, prefixLength, &oldEntry);
+	if (slot!=0)
+	{
+		// Already in the ban list. Readers may be looking at the old entry, so replace rather than change it
+		retiredEntries.Insert(oldEntry, _FILE_AND_LINE_);
+		slot->Store(entry);
+	}
+	else
+	{
+		if ((tableSlotsUsed+1)*2 > table.Load()->capacity)
+			Rebuild(tableSize+1);
+
+		Table *t = table.Load();
+		unsigned int index = HashPrefix(prefix, prefixLength) & (t->capacity-1);
+		for (;;)
+		{
+			Entry *e = t->slots[index].Load();
+			if (e==0 || e==&tombstone)
+			{
+				if (e==0)
+					tableSlotsUsed++;
+				t->slots[index].Store(entry);
+				break;
+			}
+			index=(index+1) & (t->capacity-1);
+		}
+		tableSize++;
+
+		if (prefixLengthCounts[prefixLength]++==0)
+			PublishPrefixLengths();
+	}
+	FreeRetired(false);
+	mutex.Unlock();
+	return true;
+}
+void BanList::Remove( const char *pattern )
+{
+	unsigned char prefix[PREFIX_BYTES];
+	unsigned char prefixLength;
+
+	if (Parse(pattern, prefix, &prefixLength)==false)
+	{
+		if (pattern == 0)
+			return;
+
+		mutex.Lock();
+		for (unsigned int index=0; index < patterns.Size(); index++)
+		{
+			if (strcmp(pattern, patterns[index]->pattern)==0)
+			{
+				SLNet::OP_DELETE(patterns[index], _FILE_AND_LINE_);
+				patterns.RemoveAtIndexFast(index);
+				patternsSize.Store(patterns.Size());
+				break;
+			}
+		}
+		mutex.Unlock();
+		return;
+	}
+
+	mutex.Lock();
+	Entry *entry;
+	LocklessPointer<Entry> *slot = FindSlot(table.Load(), prefix, prefixLength, &entry);
+	if (slot!=0)
+	{
+		retiredEntries.Insert(entry, _FILE_AND_LINE_);
+		slot->Store(&tombstone);
+		tableSize--;
+
+		if (--prefixLengthCounts[prefixLength]==0)
+			PublishPrefixLengths();
+	}
+	FreeRetired(false);
+	mutex.Unlock();
+}
+void BanList::Clear( void )
+{
+	mutex.Lock();
+	Table *t = table.Load();
+	for (unsigned int index=0; index < t->capacity; index++)
+	{
+		Entry *e = t->slots[index].Load();
+		if (e!=0 && e!=&tombstone)
+			retiredEntries.Insert(e, _FILE_AND_LINE_);
+	}
+	retiredTables.Insert(t, _FILE_AND_LINE_);
+	table.Store(AllocateTable(64));
+	tableSize=0;
+	tableSlotsUsed=0;
+	memset(prefixLengthCounts, 0, sizeof(prefixLengthCounts));
+	PublishPrefixLengths();
+
+	for (unsigned int index=0; index < patterns.Size(); index++)
+		SLNet::OP_DELETE(patterns[index], _FILE_AND_LINE_);
+	patterns.Clear(false, _FILE_AND_LINE_);
+	patternsSize.Store(0);
+
+	FreeRetired(false);
+	mutex.Unlock();
+}
+bool BanList::IsBanned( const char *pattern )
+{
+	unsigned char prefix[PREFIX_BYTES];
+	unsigned char prefixLength;
+
+	if (pattern == 0 || pattern[ 0 ] == 0)
+		return false;
+
+	if (Parse(pattern, prefix, &prefixLength)==false)
+		return IsPatternBanned(pattern);
+	return IsPrefixBanned(prefix, prefixLength, pattern);
+}
+bool BanList::IsBanned( const SystemAddress &systemAddress )
+{
+	unsigned char prefix[PREFIX_BYTES];
+
+#if RAKNET_SUPPORT_IPV6==1
+	if (systemAddress.GetIPVersion()==6)
+		memcpy(prefix, &systemAddress.address.addr6.sin6_addr, PREFIX_BYTES);
+	else
+#endif
+	{
+		memset(prefix, 0, 10);
+		prefix[10]=0xff;
+		prefix[11]=0xff;
+		memcpy(prefix+12, &systemAddress.address.addr4.sin_addr.s_addr, 4);
+	}
+
+	if (patternsSize.Load()==0)
+		return IsPrefixBanned(prefix, PREFIX_BYTES*8, 0);
+
+	char IP[64];
+	systemAddress.ToString(false, IP, static_cast<size_t>(64));
+	return IsPrefixBanned(prefix, PREFIX_BYTES*8, IP);
+}
+unsigned int BanList::Size( void ) const
+{
+	return tableSize + patternsSize.Load();
+}
+bool BanList::Parse( const char *pattern, unsigned char prefix[PREFIX_BYTES], unsigned char *prefixLength )
+{
+	char address[64];
+	int bits=-1;
+
+	if (pattern == 0 || pattern[ 0 ] == 0 || strlen( pattern ) >= sizeof(address))
+		return false;
+
+	const char *slash = strchr(pattern, '/');
+	const char *star = strchr(pattern, '*');
+	if (slash!=0)
+	{
+		if (slash[1] < '0' || slash[1] > '9')
+			return false;
+		char *end;
+		bits = (int) strtol(slash+1, &end, 10);
+		if (*end!=0)
+			return false;
+		strncpy_s(address, pattern, slash-pattern);
+	}
+	else if (star!=0)
+	{
+		// Only whole numbers of an IPv4 address can be replaced by *, as in 128.0.* or 128.0.*.*
+		if (star!=pattern && star[-1]!='.')
+			return false;
+		for (const char *c=star; *c; c++)
+		{
+			if (*c!='*' && *c!='.')
+				return false;
+		}
+
+		int numbers=0;
+		for (const char *c=pattern; c < star; c++)
+		{
+			if (*c=='.')
+				numbers++;
+		}
+		if (numbers>3)
+			return false;
+		strncpy_s(address, pattern, star-pattern);
+		for (int i=numbers; i < 4; i++)
+			strcat_s(address, i==3 ? "0" : "0.");
+		bits=numbers*8;
+	}
+	else
+		strcpy_s(address, pattern);
+
+	memset(prefix, 0, PREFIX_BYTES);
+	unsigned char ipv4[4];
+	if (inet_pton(AF_INET, address, ipv4)==1)
+	{
+		if (bits<0)
+			bits=32;
+		if (bits>32)
+			return false;
+		// IPv4-mapped IPv6 address, which is also what dual stack sockets report
+		prefix[10]=0xff;
+		prefix[11]=0xff;
+		memcpy(prefix+12, ipv4, 4);
+		bits+=96;
+	}
+	else if (star==0 && inet_pton(AF_INET6, address, prefix)==1)
+	{
+		if (bits<0)
+			bits=128;
+		if (bits>128)
+			return false;
+	}
+	else
+		return false;
+
+	*prefixLength=(unsigned char) bits;
+	MaskPrefix(prefix, *prefixLength);
+	return true;
+}
+void BanList::MaskPrefix( unsigned char prefix[PREFIX_BYTES], unsigned char prefixLength )
+{
+	int byteIndex = prefixLength/8;
+	if (byteIndex >= PREFIX_BYTES)
+		return;
+	if (prefixLength%8)
+		prefix[byteIndex++] &= (unsigned char) (0xff << (8-prefixLength%8));
+	memset(prefix+byteIndex, 0, PREFIX_BYTES-byteIndex);
+}
+unsigned int BanList::HashPrefix( const unsigned char prefix[PREFIX_BYTES], unsigned char prefixLength )
+{
+	return SuperFastHashIncremental((const char*) prefix, PREFIX_BYTES, prefixLength);
+}
+bool BanList::IsExpired( SLNet::TimeMS timeout, SLNet::TimeMS time )
+{
+	return timeout>0 && timeout<time;
+}
+bool BanList::MatchesPattern( const char *pattern, const char *IP )
+{
+	for (unsigned int characterIndex=0;; characterIndex++)
+	{
+		if ( pattern[ characterIndex ] == IP[ characterIndex ] )
+		{
+			// End of the string and the strings match
+			if ( IP[ characterIndex ] == 0 )
+				return true;
+		}
+		else
+		{
+			// Characters do not match, which bans the rest if it is a *
+			return pattern[ characterIndex ] == '*' && IP[ characterIndex ] != 0;
+		}
+	}
+}
+bool BanList::IsPrefixBanned( const unsigned char prefix[PREFIX_BYTES], unsigned char prefixLength, const char *IP )
+{
+	bool banned=false;
+	SLNet::TimeMS time = 0;
+
+	activeReaders.Increment();
+	Table *t = table.Load();
+	PrefixLengths *lengths = prefixLengths.Load();
+	for (unsigned int lengthIndex=0; lengthIndex < lengths->count && banned==false; lengthIndex++)
+	{
+		// A ban covers the address or range if it is the same or a shorter prefix of it
+		const unsigned char length = lengths->lengths[lengthIndex];
+		if (length > prefixLength)
+			continue;
+
+		unsigned char masked[PREFIX_BYTES];
+		memcpy(masked, prefix, PREFIX_BYTES);
+		MaskPrefix(masked, length);
+		// Remove() may replace the entry with the tombstone at any time, so only look at the entry that was found
+		Entry *entry;
+		if (FindSlot(t, masked, length, &entry)!=0)
+		{
+			if (time==0)
+				time = SLNet::GetTimeMS();
+			banned = IsExpired(entry->timeout, time)==false;
+		}
+	}
+	activeReaders.Decrement();
+
+	if (banned==false && IP!=0 && patternsSize.Load()>0)
+		banned=IsPatternBanned(IP);
+	return banned;
+}
+bool BanList::IsPatternBanned( const char *IP )
+{
+	if (patternsSize.Load()==0 || strlen(IP) > 15)
+		return false;
+
+	SLNet::TimeMS time = SLNet::GetTimeMS();
+	bool banned=false;
+
+	mutex.Lock();
+	unsigned int index=0;
+	while (index < patterns.Size())
+	{
+		if (IsExpired(patterns[index]->timeout, time))
+		{
+			SLNet::OP_DELETE(patterns[index], _FILE_AND_LINE_);
+			patterns.RemoveAtIndexFast(index);
+			patternsSize.Store(patterns.Size());
+		}
+		else if (MatchesPattern(patterns[index]->pattern, IP))
+		{
+			banned=true;
+			break;
+		}
+		else
+			index++;
+	}
+	mutex.Unlock();
+	return banned;
+}
+LocklessPointer<BanList::Entry> *BanList::FindSlot( Table *t, const unsigned char prefix[PREFIX_BYTES], unsigned char prefixLength, Entry **entry ) const
+{
+	unsigned int index = HashPrefix(prefix, prefixLength) & (t->capacity-1);
+	for (;;)
+	{
+		Entry *e = t->slots[index].Load();
+		if (e==0)
+			return 0;
+		if (e!=&tombstone && e->prefixLength==prefixLength && memcmp(e->prefix, prefix, PREFIX_BYTES)==0)
+		{
+			*entry=e;
+			return &t->slots[index];
+		}
+		index=(index+1) & (t->capacity-1);
+	}
+}
+BanList::Table *BanList::AllocateTable( unsigned int capacity ) const
+{
+	Table *t = SLNet::OP_NEW<Table>(_FILE_AND_LINE_);
+	t->capacity=capacity;
+	t->slots=SLNet::OP_NEW_ARRAY<LocklessPointer<Entry> >(capacity, _FILE_AND_LINE_);
+	return t;
+}
+void BanList::Rebuild( unsigned int minimumCapacity )
+{
+	// Copies the entries into a new table, without tombstones and expired bans, and publishes it
+	Table *oldTable = table.Load();
+	SLNet::TimeMS time = SLNet::GetTimeMS();
+	unsigned int capacity=64;
+	while (capacity < minimumCapacity*4)
+		capacity<<=1;
+
+	Table *newTable = AllocateTable(capacity);
+	tableSize=0;
+	for (unsigned int oldIndex=0; oldIndex < oldTable->capacity; oldIndex++)
+	{
+		Entry *e = oldTable->slots[oldIndex].Load();
+		if (e==0 || e==&tombstone)
+			continue;
+		if (IsExpired(e->timeout, time))
+		{
+			prefixLengthCounts[e->prefixLength]--;
+			retiredEntries.Insert(e, _FILE_AND_LINE_);
+			continue;
+		}
+
+		unsigned int index = HashPrefix(e->prefix, e->prefixLength) & (capacity-1);
+		while (newTable->slots[index].Load()!=0)
+			index=(index+1) & (capacity-1);
+		newTable->slots[index].Store(e);
+		tableSize++;
+	}
+	tableSlotsUsed=tableSize;
+
+	table.Store(newTable);
+	retiredTables.Insert(oldTable, _FILE_AND_LINE_);
+	PublishPrefixLengths();
+}
+void BanList::PublishPrefixLengths( void )
+{
+	PrefixLengths *lengths = SLNet::OP_NEW<PrefixLengths>(_FILE_AND_LINE_);
+	lengths->count=0;
+	// Longest first, so single addresses are checked before ranges
+	for (int length=PREFIX_BYTES*8; length >= 0; length--)
+	{
+		if (prefixLengthCounts[length]>0)
+			lengths->lengths[lengths->count++]=(unsigned char) length;
+	}
+	retiredPrefixLengths.Insert(prefixLengths.Load(), _FILE_AND_LINE_);
+	prefixLengths.Store(lengths);
+}
+void BanList::FreeRetired( bool force )
+{
+	// A reader that started before the changes were published may still use the retired memory. Readers that start later cannot reach it.
+	// CompareAndSet() is also a full barrier, so the check is ordered after the stores that published the changes
+	if (force==false && activeReaders.CompareAndSet(0,0)==false)
+		return;
+
+	for (unsigned int index=0; index < retiredTables.Size(); index++)
+	{
+		SLNet::OP_DELETE_ARRAY(retiredTables[index]->slots, _FILE_AND_LINE_);
+		SLNet::OP_DELETE(retiredTables[index], _FILE_AND_LINE_);
+	}
+	retiredTables.Clear(false, _FILE_AND_LINE_);
+	for (unsigned int index=0; index < retiredEntries.Size(); index++)
+		SLNet::OP_DELETE(retiredEntries[index], _FILE_AND_LINE_);
+	retiredEntries.Clear(false, _FILE_AND_LINE_);
+	for (unsigned int index=0; index < retiredPrefixLengths.Size(); index++)
+		SLNet::OP_DELETE(retiredPrefixLengths[index], _FILE_AND_LINE_);
+	retiredPrefixLengths.Clear(false, _FILE_AND_LINE_);
+}
@@ -40,6 +40,11 @@
 #include "slikenet/linux_adapter.h"
 #include "slikenet/osx_adapter.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BITSTREAM_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 // MSWin uses _copysign, others use copysign...
 #ifndef _WIN32
 #define _copysign copysign
@@ -414,11 +419,208 @@ bool BitStream::ReadAlignedBytesSafeAlloc( char ** outByteArray, unsigned int &i
 	return ReadAlignedBytes((unsigned char*) *outByteArray, inputLength);
 }
 
+static inline uint64_t LoadBigEndian64( const unsigned char *source )
+{
+	return ( (uint64_t) source[0] << 56 ) | ( (uint64_t) source[1] << 48 ) | ( (uint64_t) source[2] << 40 ) | ( (uint64_t) source[3] << 32 ) |
+		( (uint64_t) source[4] << 24 ) | ( (uint64_t) source[5] << 16 ) | ( (uint64_t) source[6] << 8 ) | (uint64_t) source[7];
+}
+
+static inline void StoreBigEndian64( unsigned char *destination, uint64_t value )
+{
+	destination[0] = (unsigned char) ( value >> 56 );
+	destination[1] = (unsigned char) ( value >> 48 );
+	destination[2] = (unsigned char) ( value >> 40 );
+	destination[3] = (unsigned char) ( value >> 32 );
+	destination[4] = (unsigned char) ( value >> 24 );
+	destination[5] = (unsigned char) ( value >> 16 );
+	destination[6] = (unsigned char) ( value >> 8 );
+	destination[7] = (unsigned char) value;
+}
+
+// Stores bytes 1 to numberOfBytes-1 of accumulator, counted from the most significant byte. The cases fall through, so that no loop is needed
+static inline void StoreAccumulatorTail( unsigned char *destination, uint64_t accumulator, BitSize_t numberOfBytes )
+{
+	switch ( numberOfBytes )
+	{
+	case 8: destination[7] = (unsigned char) accumulator;
+	case 7: destination[6] = (unsigned char) ( accumulator >> 8 );
+	case 6: destination[5] = (unsigned char) ( accumulator >> 16 );
+	case 5: destination[4] = (unsigned char) ( accumulator >> 24 );
+	case 4: destination[3] = (unsigned char) ( accumulator >> 32 );
+	case 3: destination[2] = (unsigned char) ( accumulator >> 40 );
+	case 2: destination[1] = (unsigned char) ( accumulator >> 48 );
+	}
+}
+
+// Loads numberOfBytes (0 to 8) bytes into the most significant bytes of the result
+static inline uint64_t LoadAccumulator( const unsigned char *source, BitSize_t numberOfBytes )
+{
+	uint64_t accumulator=0;
+	switch ( numberOfBytes )
+	{
+	case 8: accumulator |= (uint64_t) source[7];
+	case 7: accumulator |= (uint64_t) source[6] << 8;
+	case 6: accumulator |= (uint64_t) source[5] << 16;
+	case 5: accumulator |= (uint64_t) source[4] << 24;
+	case 4: accumulator |= (uint64_t) source[3] << 32;
+	case 3: accumulator |= (uint64_t) source[2] << 40;
+	case 2: accumulator |= (uint64_t) source[1] << 48;
+	case 1: accumulator |= (uint64_t) source[0] << 56;
+	}
+	return accumulator;
+}
+
+// The largest number of bits WriteBitsWord() and ReadBitsWord() handle at once. With up to 7 bits of offset, that still fits into 64 bits
+static const BitSize_t BITSTREAM_WORD_BITS=56;
+
+// Writes 1 to BITSTREAM_WORD_BITS bits, starting destinationBitOffset bits into destination.
+// The first destination byte is ORed with, the following ones are overwritten, and bytes after the last written bit are not changed.
+// rightAlignedBits means in the case of a partial byte, the bits are aligned from the right (bit 0) rather than the left (as in the normal internal representation)
+static inline void WriteBitsWord( unsigned char *destination, BitSize_t destinationBitOffset, const unsigned char *input, BitSize_t numberOfBits, bool rightAlignedBits )
+{
+	const BitSize_t wholeBytes = numberOfBits >> 3;
+	const BitSize_t partialBits = numberOfBits & 7;
+
+	// One byte or less, such as bools and the halves of compressed integers
+	if ( numberOfBits <= 8 )
+	{
+		unsigned char dataByte = input[ 0 ];
+		if ( partialBits != 0 && rightAlignedBits )
+			dataByte = (unsigned char) ( dataByte << ( 8 - partialBits ) ); // shift left to get the bits on the left, as in our internal representation
+		if ( destinationBitOffset == 0 )
+			destination[ 0 ] = dataByte;
+		else
+		{
+			destination[ 0 ] |= dataByte >> destinationBitOffset;
+			if ( destinationBitOffset + numberOfBits > 8 )
+				destination[ 1 ] = (unsigned char) ( dataByte << ( 8 - destinationBitOffset ) );
+		}
+		return;
+	}
+
+	// Otherwise gather the input into a 64 bit accumulator, shift it once, and store it
+	uint64_t accumulator = LoadAccumulator( input, wholeBytes );
+	if ( partialBits != 0 )
+	{
+		unsigned char dataByte = input[ wholeBytes ];
+		if ( rightAlignedBits )
+			dataByte = (unsigned char) ( dataByte << ( 8 - partialBits ) );
+		accumulator |= (uint64_t) dataByte << ( 56 - 8 * wholeBytes );
+	}
+
+	accumulator >>= destinationBitOffset;
+	if ( destinationBitOffset == 0 )
+		destination[ 0 ] = (unsigned char) ( accumulator >> 56 );
+	else
+		destination[ 0 ] |= (unsigned char) ( accumulator >> 56 );
+	StoreAccumulatorTail( destination, accumulator, BITS_TO_BYTES( destinationBitOffset + numberOfBits ) );
+}
+
+// Reads 1 to BITSTREAM_WORD_BITS bits, starting sourceBitOffset bits into source.
+// If wordFits, source has at least 8 bytes, so they are read with a single load and the bytes after the last read bit are masked off.
+static inline void ReadBitsWord( unsigned char *output, const unsigned char *source, BitSize_t sourceBitOffset, BitSize_t numberOfBits, bool alignBitsToRight, bool wordFits )
+{
+	const BitSize_t partialBits = numberOfBits & 7;
+
+	if ( numberOfBits <= 8 )
+	{
+		unsigned char dataByte = (unsigned char) ( source[ 0 ] << sourceBitOffset );
+		if ( sourceBitOffset + numberOfBits > 8 ) // If we have a second half, we didn't read enough bits in the first half
+			dataByte |= source[ 1 ] >> ( 8 - sourceBitOffset );
+		if ( partialBits != 0 && alignBitsToRight ) // Reading a partial byte, shift right so the data is aligned on the right
+			dataByte >>= 8 - partialBits;
+		output[ 0 ] = dataByte;
+		return;
+	}
+
+	const BitSize_t sourceBytes = BITS_TO_BYTES( sourceBitOffset + numberOfBits );
+	uint64_t accumulator;
+	if ( wordFits )
+		accumulator = LoadBigEndian64( source ) & ( ~(uint64_t) 0 << ( 64 - 8 * sourceBytes ) );
+	else
+		accumulator = LoadAccumulator( source, sourceBytes );
+	accumulator <<= sourceBitOffset;
+
+	const BitSize_t outputBytes = BITS_TO_BYTES( numberOfBits );
+	output[ 0 ] = (unsigned char) ( accumulator >> 56 );
+	StoreAccumulatorTail( output, accumulator, outputBytes );
+
+	// Reading a partial byte for the last byte, shift right so the data is aligned on the right
+	if ( partialBits != 0 && alignBitsToRight )
+		output[ outputBytes - 1 ] >>= 8 - partialBits;
+}
+
+// Writes numberOfBytes whole bytes starting bitOffset (1 to 7) bits into destination.
+// Like WriteBitsWord(), ORs the first destination byte and overwrites the rest, including the byte holding the last bitOffset bits.
+static void WriteUnalignedBytes( unsigned char *destination, BitSize_t bitOffset, const unsigned char *input, BitSize_t numberOfBytes )
+{
+	BitSize_t i=0;
+	destination[ 0 ] |= (unsigned char) ( input[ 0 ] >> bitOffset );
+
+#ifdef BITSTREAM_USE_SSE2
+	// Each destination byte after the first is made of two neighbouring input bytes. Put them into 16 bit lanes and shift those.
+	// Writes destination[i+1] to destination[i+16], so the first half of destination[i] must already be written
+	const __m128i shift = _mm_cvtsi32_si128( (int) bitOffset );
+	const __m128i lowByteMask = _mm_set1_epi16( 0x00FF );
+	for ( ; i + 17 <= numberOfBytes; i += 16 )
+	{
+		const __m128i firstHalves = _mm_loadu_si128( ( const __m128i* ) ( input + i ) );
+		const __m128i secondHalves = _mm_loadu_si128( ( const __m128i* ) ( input + i + 1 ) );
+		__m128i low = _mm_unpacklo_epi8( secondHalves, firstHalves );
+		__m128i high = _mm_unpackhi_epi8( secondHalves, firstHalves );
+		low = _mm_and_si128( _mm_srl_epi16( low, shift ), lowByteMask );
+		high = _mm_and_si128( _mm_srl_epi16( high, shift ), lowByteMask );
+		_mm_storeu_si128( ( __m128i* ) ( destination + i + 1 ), _mm_packus_epi16( low, high ) );
+	}
+#endif
+
+	// The bits that did not fit into the last destination byte are carried over to the next word
+	uint64_t carry = (uint64_t) destination[ i ] << 56;
+	for ( ; i + 8 <= numberOfBytes; i += 8 )
+	{
+		const uint64_t word = LoadBigEndian64( input + i );
+		StoreBigEndian64( destination + i, carry | ( word >> bitOffset ) );
+		carry = word << ( 64 - bitOffset );
+	}
+	for ( ; i < numberOfBytes; i++ )
+	{
+		destination[ i ] = (unsigned char) ( ( carry >> 56 ) | ( input[ i ] >> bitOffset ) );
+		carry = (uint64_t) (unsigned char) ( input[ i ] << ( 8 - bitOffset ) ) << 56;
+	}
+	destination[ i ] = (unsigned char) ( carry >> 56 );
+}
+
+// Reads numberOfBytes whole bytes starting bitOffset (1 to 7) bits into source
+static void ReadUnalignedBytes( unsigned char *output, const unsigned char *source, BitSize_t bitOffset, BitSize_t numberOfBytes )
+{
+	BitSize_t i=0;
+
+#ifdef BITSTREAM_USE_SSE2
+	const __m128i shift = _mm_cvtsi32_si128( (int) ( 8 - bitOffset ) );
+	const __m128i lowByteMask = _mm_set1_epi16( 0x00FF );
+	for ( ; i + 16 <= numberOfBytes; i += 16 )
+	{
+		const __m128i firstHalves = _mm_loadu_si128( ( const __m128i* ) ( source + i ) );
+		const __m128i secondHalves = _mm_loadu_si128( ( const __m128i* ) ( source + i + 1 ) );
+		__m128i low = _mm_unpacklo_epi8( secondHalves, firstHalves );
+		__m128i high = _mm_unpackhi_epi8( secondHalves, firstHalves );
+		low = _mm_and_si128( _mm_srl_epi16( low, shift ), lowByteMask );
+		high = _mm_and_si128( _mm_srl_epi16( high, shift ), lowByteMask );
+		_mm_storeu_si128( ( __m128i* ) ( output + i ), _mm_packus_epi16( low, high ) );
+	}
+#endif
+
+	for ( ; i + 8 <= numberOfBytes; i += 8 )
+		StoreBigEndian64( output + i, ( LoadBigEndian64( source + i ) << bitOffset ) | ( source[ i + 8 ] >> ( 8 - bitOffset ) ) );
+	for ( ; i < numberOfBytes; i++ )
+		output[ i ] = (unsigned char) ( ( source[ i ] << bitOffset ) | ( source[ i + 1 ] >> ( 8 - bitOffset ) ) );
+}
+
 // Write numberToWrite bits from the input source
 void BitStream::WriteBits( const unsigned char* inByteArray, BitSize_t numberOfBitsToWrite, const bool rightAlignedBits )
 {
-//	if (numberOfBitsToWrite<=0)
-//		return;
+	if (numberOfBitsToWrite<=0)
+		return;
 
 	AddBitsAndReallocate( numberOfBitsToWrite );
 
@@ -432,44 +634,27 @@ void BitStream::WriteBits( const unsigned char* inByteArray, BitSize_t numberOfB
 		return;
 	}
 
-	unsigned char dataByte;
-	const unsigned char* inputPtr=inByteArray;
-
-	// Faster to put the while at the top surprisingly enough
-	while ( numberOfBitsToWrite > 0 )
-		//do
+	// Short writes, such as from WriteCompressed or WriteBitsFromIntegerRange, are done without a loop
+	if ( numberOfBitsToWrite <= BITSTREAM_WORD_BITS )
 	{
-		dataByte = *( inputPtr++ );
-
-		if ( numberOfBitsToWrite < 8 && rightAlignedBits )   // rightAlignedBits means in the case of a partial byte, the bits are aligned from the right (bit 0) rather than the left (as in the normal internal representation)
-			dataByte <<= 8 - numberOfBitsToWrite;  // shift left to get the bits on the left, as in our internal representation
-
-		// Writing to a new byte each time
-		if ( numberOfBitsUsedMod8 == 0 )
-			* ( data + ( numberOfBitsUsed >> 3 ) ) = dataByte;
-		else
-		{
-			// Copy over the new data.
-			*( data + ( numberOfBitsUsed >> 3 ) ) |= dataByte >> ( numberOfBitsUsedMod8 ); // First half
+		WriteBitsWord( data + ( numberOfBitsUsed >> 3 ), numberOfBitsUsedMod8, inByteArray, numberOfBitsToWrite, rightAlignedBits );
+		numberOfBitsUsed += numberOfBitsToWrite;
+		return;
+	}
 
-			if ( 8 - ( numberOfBitsUsedMod8 ) < 8 && 8 - ( numberOfBitsUsedMod8 ) < numberOfBitsToWrite )   // If we didn't write it all out in the first half (8 - (numberOfBitsUsed%8) is the number we wrote in the first half)
-			{
-				*( data + ( numberOfBitsUsed >> 3 ) + 1 ) = (unsigned char) ( dataByte << ( 8 - ( numberOfBitsUsedMod8 ) ) ); // Second half (overlaps byte boundary)
-			}
-		}
+	// Copy the whole bytes, then the partial last byte
+	const BitSize_t numberOfBytes = numberOfBitsToWrite >> 3;
+	if ( numberOfBitsUsedMod8 == 0 )
+		memcpy( data + ( numberOfBitsUsed >> 3 ), inByteArray, numberOfBytes );
+	else
+		WriteUnalignedBytes( data + ( numberOfBitsUsed >> 3 ), numberOfBitsUsedMod8, inByteArray, numberOfBytes );
+	numberOfBitsUsed += numberOfBytes << 3;
 
-		if ( numberOfBitsToWrite >= 8 )
-		{
-			numberOfBitsUsed += 8;
-			numberOfBitsToWrite -= 8;
-		}
-		else
-		{
-			numberOfBitsUsed += numberOfBitsToWrite;
-			numberOfBitsToWrite=0;
-		}
+	if ( ( numberOfBitsToWrite & 7 ) != 0 )
+	{
+		WriteBitsWord( data + ( numberOfBitsUsed >> 3 ), numberOfBitsUsedMod8, inByteArray + numberOfBytes, numberOfBitsToWrite & 7, rightAlignedBits );
+		numberOfBitsUsed += numberOfBitsToWrite & 7;
 	}
-	// } while(numberOfBitsToWrite>0);
 }
 
 // Set the stream to some initial data.  For internal use
@@ -571,42 +756,27 @@ bool BitStream::ReadBits( unsigned char *inOutByteArray, BitSize_t numberOfBitsT
 
 
 
-	BitSize_t offset = 0;
-
-	memset( inOutByteArray, 0, (size_t) BITS_TO_BYTES( numberOfBitsToRead ) );
-
-	while ( numberOfBitsToRead > 0 )
+	// Short reads are done without a loop
+	if ( numberOfBitsToRead <= BITSTREAM_WORD_BITS )
 	{
-		*( inOutByteArray + offset ) |= *( data + ( readOffset >> 3 ) ) << ( readOffsetMod8 ); // First half
-
-		if ( readOffsetMod8 > 0 && numberOfBitsToRead > 8 - ( readOffsetMod8 ) )   // If we have a second half, we didn't read enough bytes in the first half
-			*( inOutByteArray + offset ) |= *( data + ( readOffset >> 3 ) + 1 ) >> ( 8 - ( readOffsetMod8 ) ); // Second half (overlaps byte boundary)
-
-		if (numberOfBitsToRead>=8)
-		{
-			numberOfBitsToRead -= 8;
-			readOffset += 8;
-			offset++;
-		}
-		else
-		{
-			int neg = (int) numberOfBitsToRead - 8;
-
-			if ( neg < 0 )   // Reading a partial byte for the last byte, shift right so the data is aligned on the right
-			{
-
-				if ( alignBitsToRight )
-					* ( inOutByteArray + offset ) >>= -neg;
-
-				readOffset += 8 + neg;
-			}
-			else
-				readOffset += 8;
+		const bool wordFits = ( ( readOffset >> 3 ) + 8 ) << 3 <= numberOfBitsAllocated;
+		ReadBitsWord( inOutByteArray, data + ( readOffset >> 3 ), readOffsetMod8, numberOfBitsToRead, alignBitsToRight, wordFits );
+		readOffset += numberOfBitsToRead;
+		return true;
+	}
 
-			offset++;
+	// Copy the whole bytes, then the partial last byte
+	const BitSize_t numberOfBytes = numberOfBitsToRead >> 3;
+	if ( readOffsetMod8 == 0 )
+		memcpy( inOutByteArray, data + ( readOffset >> 3 ), numberOfBytes );
+	else
+		ReadUnalignedBytes( inOutByteArray, data + ( readOffset >> 3 ), readOffsetMod8, numberOfBytes );
+	readOffset += numberOfBytes << 3;
 
-			numberOfBitsToRead=0;
-		}		
+	if ( ( numberOfBitsToRead & 7 ) != 0 )
+	{
+		ReadBitsWord( inOutByteArray + numberOfBytes, data + ( readOffset >> 3 ), readOffsetMod8, numberOfBitsToRead & 7, alignBitsToRight, false );
+		readOffset += numberOfBitsToRead & 7;
 	}
 
 	return true;
@@ -967,6 +1137,23 @@ BitSize_t BitStream::CopyData( unsigned char** _data ) const
 	return numberOfBitsUsed;
 }
 
+BitSize_t BitStream::MoveData( unsigned char** _data )
+{
+	const BitSize_t numberOfBitsMoved = numberOfBitsUsed;
+	if ( copyData && data != stackData && numberOfBitsAllocated > (BITSTREAM_STACK_ALLOCATION_SIZE << 3) )
+	{
+		*_data = data;
+		data = ( unsigned char* ) stackData;
+		numberOfBitsAllocated = BITSTREAM_STACK_ALLOCATION_SIZE << 3;
+	}
+	else
+		CopyData( _data );
+
+	numberOfBitsUsed = 0;
+	readOffset = 0;
+	return numberOfBitsMoved;
+}
+
 // Ignore data we don't intend to read
 void BitStream::IgnoreBits( const BitSize_t numberOfBits )
 {
@@ -0,0 +1,509 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "slikenet/CCRakNetBBR.h"
+#include "slikenet/assert.h"
+#include "slikenet/memoryoverride.h"
+
+static const CCTimeType UNSET_MIN_RTT=(CCTimeType) -1;
+
+#if CC_TIME_TYPE_BYTES==4
+// Longest time the remote system holds back acks. See CCRakNetSlidingWindow::ShouldSendACKs()
+static const CCTimeType SYN=10;
+static const CCTimeType MIN_RTT_FILTER_LENGTH=10000;
+static const CCTimeType PROBE_RTT_DURATION=200;
+// Largest burst that the pacing rate allows after the update thread was late
+static const CCTimeType PACING_BURST_TIME=2;
+static const double TIME_UNITS_PER_SECOND=1000.0;
+#else
+static const CCTimeType SYN=10000;
+static const CCTimeType MIN_RTT_FILTER_LENGTH=10000000;
+static const CCTimeType PROBE_RTT_DURATION=200000;
+static const CCTimeType PACING_BURST_TIME=2000;
+static const double TIME_UNITS_PER_SECOND=1000000.0;
+#endif
+
+// 2/ln(2), the lowest gain that doubles the delivery rate every round trip
+static const double HIGH_GAIN=2.885;
+static const double DRAIN_GAIN=1.0/2.885;
+static const double CWND_GAIN=2.0;
+static const double PACING_GAIN_CYCLE[]={1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+static const double FULL_BW_GROWTH=1.25;
+static const int FULL_BW_ROUNDS=3;
+static const int INITIAL_CWND_DATAGRAMS=10;
+static const int MIN_CWND_DATAGRAMS=4;
+
+using namespace SLNet;
+
+// ****************************************************** PUBLIC METHODS ******************************************************
+
+CCRakNetBBR::CCRakNetBBR()
+{
+	sentDatagrams=0;
+	sentDatagramsLength=0;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+CCRakNetBBR::~CCRakNetBBR()
+{
+	if (sentDatagrams)
+		SLNet::OP_DELETE_ARRAY(sentDatagrams, _FILE_AND_LINE_);
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::Init(CCTimeType curTime, uint32_t maxDatagramPayload)
+{
+	CCRakNetSlidingWindow::Init(curTime, maxDatagramPayload);
+
+	if (sentDatagrams==0)
+	{
+		sentDatagramsLength=DATAGRAM_MESSAGE_ID_ARRAY_LENGTH;
+		sentDatagrams=SLNet::OP_NEW_ARRAY<SentDatagram>(sentDatagramsLength, _FILE_AND_LINE_);
+	}
+	for (unsigned int i=0; i < sentDatagramsLength; i++)
+		sentDatagrams[i].isInFlight=false;
+	datagramsInFlight=0;
+	bytesInFlight=0;
+
+	delivered=0;
+	deliveredTime=curTime;
+	firstSendTime=curTime;
+
+	roundCount=0;
+	nextRoundDelivered=0;
+	roundStart=false;
+
+	for (int i=0; i < BTLBW_FILTER_ROUNDS; i++)
+	{
+		btlBwFilter[i]=0.0;
+		btlBwFilterRound[i]=0;
+	}
+	btlBw=0.0;
+
+	minRtt=UNSET_MIN_RTT;
+	minRttStamp=curTime;
+	minRttExpired=false;
+
+	fullBw=0.0;
+	fullBwCount=0;
+	filledPipe=false;
+
+	cycleIndex=0;
+	cycleStamp=curTime;
+	// Connections started in the same microsecond still get different phases
+	rnr.SeedMT((unsigned int) curTime ^ (unsigned int) (size_t) this);
+	probeRttDoneStamp=0;
+	probeRttRoundDone=false;
+
+	EnterStartup();
+	cwnd=INITIAL_CWND_DATAGRAMS*MAXIMUM_MTU_INCLUDING_UDP_HEADER;
+	priorCwnd=cwnd;
+
+	pacingRate=0.0;
+	pacingTokens=0.0;
+	lastPacingTime=curTime;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::Update(CCTimeType curTime, bool hasDataToSendOrResend)
+{
+	(void) curTime;
+	(void) hasDataToSendOrResend;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+int CCRakNetBBR::GetRetransmissionBandwidth(CCTimeType curTime, CCTimeType timeSinceLastTick, uint32_t unacknowledgedBytes, bool isContinuousSend)
+{
+	(void) timeSinceLastTick;
+	(void) isContinuousSend;
+
+	RefillPacingTokens(curTime);
+	if (pacingRate==0.0)
+		return unacknowledgedBytes;
+	if (pacingTokens<=0.0)
+		return 0;
+	if (pacingTokens < unacknowledgedBytes)
+		return (int) pacingTokens;
+	return unacknowledgedBytes;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+int CCRakNetBBR::GetTransmissionBandwidth(CCTimeType curTime, CCTimeType timeSinceLastTick, uint32_t unacknowledgedBytes, bool isContinuousSend)
+{
+	(void) timeSinceLastTick;
+
+	_isContinuousSend=isContinuousSend;
+
+	RefillPacingTokens(curTime);
+	if (unacknowledgedBytes>=cwnd)
+		return 0;
+	double window=cwnd-unacknowledgedBytes;
+	// Until the first delivery rate sample, only the initial window limits sends
+	if (pacingRate!=0.0 && pacingTokens < window)
+		window=pacingTokens;
+	if (window<=0.0)
+		return 0;
+	return (int) window;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+CCTimeType CCRakNetBBR::GetNextTransmissionTime(CCTimeType curTime) const
+{
+	if (pacingRate==0.0)
+		return CCRakNetSlidingWindow::GetNextTransmissionTime(curTime);
+
+	// With enough tokens, sends wait for acks to open the congestion window, which wake the update thread anyway
+	const double missingTokens=MAXIMUM_MTU_INCLUDING_UDP_HEADER-pacingTokens;
+	if (missingTokens<=0.0)
+		return CCRakNetSlidingWindow::GetNextTransmissionTime(curTime);
+	return curTime+(CCTimeType) (missingTokens/pacingRate)+1;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::OnSendBytes(CCTimeType curTime, uint32_t numBytes)
+{
+	(void) curTime;
+
+	if (pacingRate!=0.0)
+		pacingTokens-=numBytes;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::OnSendDatagram(CCTimeType curTime, DatagramSequenceNumberType datagramSequenceNumber, uint32_t numBytes, bool isContinuousSend)
+{
+	// After an idle period, the time since the last ack is not part of the delivery rate
+	if (datagramsInFlight==0)
+		firstSendTime=deliveredTime=curTime;
+
+	// The datagram in this slot was sent sentDatagramsLength datagrams ago. If it may still be acked, more datagrams are in flight than fit
+	unsigned int slotIndex=datagramSequenceNumber % sentDatagramsLength;
+	while (sentDatagrams[slotIndex].isInFlight && curTime-sentDatagrams[slotIndex].sendTime < GetRTOForRetransmission(1) && GrowSentDatagrams())
+		slotIndex=datagramSequenceNumber % sentDatagramsLength;
+
+	SentDatagram &sentDatagram=sentDatagrams[slotIndex];
+	if (sentDatagram.isInFlight)
+	{
+		// Neither acked nor NAKed within the retransmission timeout, so it is lost
+		datagramsInFlight--;
+		bytesInFlight-=sentDatagram.numBytes;
+	}
+	sentDatagram.sendTime=curTime;
+	sentDatagram.firstSendTime=firstSendTime;
+	sentDatagram.deliveredTime=deliveredTime;
+	sentDatagram.delivered=delivered;
+	sentDatagram.sequenceNumber=datagramSequenceNumber;
+	sentDatagram.numBytes=numBytes;
+	sentDatagram.isAppLimited=isContinuousSend==false;
+	sentDatagram.isInFlight=true;
+	datagramsInFlight++;
+	bytesInFlight+=numBytes;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::OnResend(CCTimeType curTime, SLNet::TimeUS nextActionTime)
+{
+	(void) curTime;
+	(void) nextActionTime;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::OnNAK(CCTimeType curTime, DatagramSequenceNumberType nakSequenceNumber)
+{
+	(void) curTime;
+
+	SentDatagram &sentDatagram=sentDatagrams[nakSequenceNumber % sentDatagramsLength];
+	if (sentDatagram.isInFlight==false || sentDatagram.sequenceNumber!=nakSequenceNumber)
+		return;
+	sentDatagram.isInFlight=false;
+	datagramsInFlight--;
+	bytesInFlight-=sentDatagram.numBytes;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::OnAck(CCTimeType curTime, CCTimeType rtt, bool hasBAndAS, BytesPerMicrosecond _B, BytesPerMicrosecond _AS, double totalUserDataBytesAcked, bool isContinuousSend, DatagramSequenceNumberType sequenceNumber )
+{
+	(void) curTime;
+	(void) hasBAndAS;
+	(void) _B;
+	(void) _AS;
+	(void) totalUserDataBytesAcked;
+	(void) sequenceNumber;
+
+	_isContinuousSend=isContinuousSend;
+	UpdateRTT(rtt);
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::OnAckDatagram(CCTimeType curTime, DatagramSequenceNumberType sequenceNumber)
+{
+	SentDatagram &sentDatagram=sentDatagrams[sequenceNumber % sentDatagramsLength];
+	if (sentDatagram.isInFlight==false || sentDatagram.sequenceNumber!=sequenceNumber)
+		return;
+	sentDatagram.isInFlight=false;
+	datagramsInFlight--;
+	bytesInFlight-=sentDatagram.numBytes;
+
+	delivered+=sentDatagram.numBytes;
+	deliveredTime=curTime;
+	firstSendTime=sentDatagram.sendTime;
+
+	// A round trip ends when a datagram is acked that was sent after the datagram that ended the previous round trip was acked
+	roundStart=sentDatagram.delivered>=nextRoundDelivered;
+	if (roundStart)
+	{
+		nextRoundDelivered=delivered;
+		roundCount++;
+	}
+
+	if (curTime>=sentDatagram.sendTime)
+		UpdateMinRTT(curTime, curTime-sentDatagram.sendTime);
+
+	// The delivery rate over the interval between sending or acking this and an earlier datagram, whichever is longer,
+	// so that neither bursts of sends nor bursts of acks overestimate it
+	CCTimeType sendElapsed=sentDatagram.sendTime-sentDatagram.firstSendTime;
+	CCTimeType ackElapsed=curTime-sentDatagram.deliveredTime;
+	CCTimeType interval=sendElapsed > ackElapsed ? sendElapsed : ackElapsed;
+	if (interval>0 && (minRtt==UNSET_MIN_RTT || interval>=minRtt))
+		UpdateBtlBw((double) (delivered-sentDatagram.delivered)/(double) interval, sentDatagram.isAppLimited);
+
+	CheckFullPipe(sentDatagram.isAppLimited);
+	CheckDrain(curTime);
+	UpdateGainCycle(curTime);
+	CheckProbeRTT(curTime);
+	UpdatePacingRate();
+	UpdateCwnd(sentDatagram.numBytes);
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+uint64_t CCRakNetBBR::GetBytesPerSecondLimitByCongestionControl(void) const
+{
+	return (uint64_t) (pacingRate*TIME_UNITS_PER_SECOND);
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+double CCRakNetBBR::GetPacingRate(void) const
+{
+	return pacingRate*TIME_UNITS_PER_SECOND;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+BytesPerMicrosecond CCRakNetBBR::GetBottleneckBandwidth(void) const
+{
+	return btlBw*TIME_UNITS_PER_SECOND/1000000.0;
+}
+// ****************************************************** PROTECTED METHODS ******************************************************
+void CCRakNetBBR::RefillPacingTokens(CCTimeType curTime)
+{
+	if (pacingRate!=0.0 && curTime>lastPacingTime)
+	{
+		pacingTokens+=pacingRate*(curTime-lastPacingTime);
+		double maxTokens=pacingRate*PACING_BURST_TIME;
+		if (maxTokens < 2.0*MAXIMUM_MTU_INCLUDING_UDP_HEADER)
+			maxTokens=2.0*MAXIMUM_MTU_INCLUDING_UDP_HEADER;
+		if (pacingTokens>maxTokens)
+			pacingTokens=maxTokens;
+	}
+	lastPacingTime=curTime;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::UpdateBtlBw(double deliveryRate, bool isAppLimited)
+{
+	// When nothing else waited to be sent, a lower rate says nothing about the path
+	if (isAppLimited && deliveryRate < btlBw)
+		return;
+
+	const int slot=roundCount % BTLBW_FILTER_ROUNDS;
+	if (btlBwFilterRound[slot]!=roundCount)
+	{
+		btlBwFilterRound[slot]=roundCount;
+		btlBwFilter[slot]=0.0;
+	}
+	if (deliveryRate>btlBwFilter[slot])
+		btlBwFilter[slot]=deliveryRate;
+
+	btlBw=0.0;
+	for (int i=0; i < BTLBW_FILTER_ROUNDS; i++)
+	{
+		if (roundCount-btlBwFilterRound[i] < (uint32_t) BTLBW_FILTER_ROUNDS && btlBwFilter[i]>btlBw)
+			btlBw=btlBwFilter[i];
+	}
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::UpdateMinRTT(CCTimeType curTime, CCTimeType rtt)
+{
+	minRttExpired=curTime > minRttStamp+MIN_RTT_FILTER_LENGTH;
+	if (minRtt==UNSET_MIN_RTT || rtt<=minRtt || minRttExpired)
+	{
+		minRtt=rtt;
+		minRttStamp=curTime;
+	}
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::CheckFullPipe(bool isAppLimited)
+{
+	if (filledPipe==false && roundStart && isAppLimited==false)
+	{
+		if (btlBw>=fullBw*FULL_BW_GROWTH)
+		{
+			fullBw=btlBw;
+			fullBwCount=0;
+		}
+		else if (++fullBwCount>=FULL_BW_ROUNDS)
+			filledPipe=true;
+	}
+
+	if (mode==STARTUP && filledPipe)
+	{
+		mode=DRAIN;
+		pacingGain=DRAIN_GAIN;
+		cwndGain=HIGH_GAIN;
+	}
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::CheckDrain(CCTimeType curTime)
+{
+	if (mode==DRAIN && bytesInFlight<=GetBDP())
+		EnterProbeBW(curTime);
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::UpdateGainCycle(CCTimeType curTime)
+{
+	if (mode!=PROBE_BW)
+		return;
+
+	const bool isFullLength=curTime-cycleStamp > minRtt;
+	bool nextPhase;
+	if (pacingGain<1.0)
+		// Done draining what the previous phase queued once in flight is down to the BDP
+		nextPhase=isFullLength || bytesInFlight<=GetBDP();
+	else
+		nextPhase=isFullLength;
+
+	if (nextPhase)
+	{
+		cycleIndex=(cycleIndex+1) % GAIN_CYCLE_LENGTH;
+		pacingGain=PACING_GAIN_CYCLE[cycleIndex];
+		cycleStamp=curTime;
+	}
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::CheckProbeRTT(CCTimeType curTime)
+{
+	if (mode!=PROBE_RTT && minRttExpired)
+	{
+		mode=PROBE_RTT;
+		pacingGain=1.0;
+		cwndGain=1.0;
+		priorCwnd=cwnd;
+		probeRttDoneStamp=0;
+	}
+
+	if (mode!=PROBE_RTT)
+		return;
+
+	if (probeRttDoneStamp==0)
+	{
+		if (bytesInFlight<=GetMinCwnd())
+		{
+			probeRttDoneStamp=curTime+PROBE_RTT_DURATION;
+			probeRttRoundDone=false;
+			nextRoundDelivered=delivered;
+		}
+	}
+	else
+	{
+		if (roundStart)
+			probeRttRoundDone=true;
+		if (probeRttRoundDone && curTime>probeRttDoneStamp)
+		{
+			minRttStamp=curTime;
+			minRttExpired=false;
+			if (cwnd<priorCwnd)
+				cwnd=priorCwnd;
+			if (filledPipe)
+				EnterProbeBW(curTime);
+			else
+				EnterStartup();
+		}
+	}
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::UpdateCwnd(uint32_t bytesAcked)
+{
+	const double minCwnd=GetMinCwnd();
+	if (mode==PROBE_RTT)
+	{
+		if (cwnd>minCwnd)
+			cwnd=minCwnd;
+		return;
+	}
+
+	double targetCwnd=GetBDP()*cwndGain;
+	if (btlBw==0.0 || minRtt==UNSET_MIN_RTT)
+		targetCwnd=INITIAL_CWND_DATAGRAMS*MAXIMUM_MTU_INCLUDING_UDP_HEADER;
+	if (targetCwnd<minCwnd)
+		targetCwnd=minCwnd;
+
+	if (filledPipe)
+	{
+		cwnd+=bytesAcked;
+		if (cwnd>targetCwnd)
+			cwnd=targetCwnd;
+	}
+	else if (cwnd<targetCwnd || delivered < (uint64_t) INITIAL_CWND_DATAGRAMS*MAXIMUM_MTU_INCLUDING_UDP_HEADER)
+		cwnd+=bytesAcked;
+
+	if (cwnd<minCwnd)
+		cwnd=minCwnd;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::UpdatePacingRate(void)
+{
+	const double rate=pacingGain*btlBw;
+	// Startup never lowers the pacing rate, since the first samples are taken before the pipe is full
+	if (filledPipe || rate>pacingRate)
+		pacingRate=rate;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::EnterStartup(void)
+{
+	mode=STARTUP;
+	pacingGain=HIGH_GAIN;
+	cwndGain=HIGH_GAIN;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetBBR::EnterProbeBW(CCTimeType curTime)
+{
+	mode=PROBE_BW;
+	cwndGain=CWND_GAIN;
+	// Start in a random phase, so that connections sharing a bottleneck do not probe at the same time, but not in the 0.75 phase,
+	// as Drain already emptied the queue. Like reference BBR, pick one of the phases after 1.25 and advance to the next one
+	cycleIndex=GAIN_CYCLE_LENGTH-1-(int) (rnr.RandomMT() % (GAIN_CYCLE_LENGTH-1));
+	cycleIndex=(cycleIndex+1) % GAIN_CYCLE_LENGTH;
+	pacingGain=PACING_GAIN_CYCLE[cycleIndex];
+	cycleStamp=curTime;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+double CCRakNetBBR::GetBDP(void) const
+{
+	if (minRtt==UNSET_MIN_RTT)
+		return INITIAL_CWND_DATAGRAMS*MAXIMUM_MTU_INCLUDING_UDP_HEADER;
+	return btlBw*(minRtt+SYN);
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+double CCRakNetBBR::GetMinCwnd(void) const
+{
+	return MIN_CWND_DATAGRAMS*MAXIMUM_MTU_INCLUDING_UDP_HEADER;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+bool CCRakNetBBR::GrowSentDatagrams(void)
+{
+	if (sentDatagramsLength>=RESEND_BUFFER_ARRAY_LENGTH)
+		return false;
+
+	const unsigned int length=sentDatagramsLength*2;
+	SentDatagram *newSentDatagrams=SLNet::OP_NEW_ARRAY<SentDatagram>(length, _FILE_AND_LINE_);
+	for (unsigned int i=0; i < length; i++)
+		newSentDatagrams[i].isInFlight=false;
+
+	// Datagrams in different slots of the old array are in different slots of the new one as well
+	for (unsigned int i=0; i < sentDatagramsLength; i++)
+	{
+		if (sentDatagrams[i].isInFlight)
+			newSentDatagrams[sentDatagrams[i].sequenceNumber % length]=sentDatagrams[i];
+	}
+	SLNet::OP_DELETE_ARRAY(sentDatagrams, _FILE_AND_LINE_);
+	sentDatagrams=newSentDatagrams;
+	sentDatagramsLength=length;
+	return true;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "slikenet/CCRakNetInterface.h"
+
+using namespace SLNet;
+
+// ----------------------------------------------------------------------------------------------------------------------------
+CCTimeType CCRakNetInterface::GetNextTransmissionTime(CCTimeType curTime) const
+{
+#if CC_TIME_TYPE_BYTES==4
+	return curTime+10;
+#else
+	return curTime+10000;
+#endif
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetInterface::OnSendDatagram(CCTimeType curTime, DatagramSequenceNumberType datagramSequenceNumber, uint32_t numBytes, bool isContinuousSend)
+{
+	(void) curTime;
+	(void) datagramSequenceNumber;
+	(void) numBytes;
+	(void) isContinuousSend;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetInterface::OnAckDatagram(CCTimeType curTime, DatagramSequenceNumberType sequenceNumber)
+{
+	(void) curTime;
+	(void) sequenceNumber;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+bool CCRakNetInterface::GreaterThan(DatagramSequenceNumberType a, DatagramSequenceNumberType b)
+{
+	// a > b?
+	const DatagramSequenceNumberType halfSpan =(DatagramSequenceNumberType) (((DatagramSequenceNumberType)(const uint32_t)-1)/(DatagramSequenceNumberType)2);
+	return b!=a && b-a>halfSpan;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+bool CCRakNetInterface::LessThan(DatagramSequenceNumberType a, DatagramSequenceNumberType b)
+{
+	// a < b?
+	const DatagramSequenceNumberType halfSpan = ((DatagramSequenceNumberType)(const uint32_t)-1)/(DatagramSequenceNumberType)2;
+	return b!=a && b-a<halfSpan;
+}
@@ -15,8 +15,6 @@
 
 #include "slikenet/CCRakNetSlidingWindow.h"
 
-#if USE_SLIDING_WINDOW_CONGESTION_CONTROL==1
-
 static const double UNSET_TIME_US=-1;
 
 #if CC_TIME_TYPE_BYTES==4
@@ -105,6 +103,13 @@ bool CCRakNetSlidingWindow::ShouldSendACKs(CCTimeType curTime, CCTimeType estima
 	return curTime >= oldestUnsentAck + SYN;
 }
 // ----------------------------------------------------------------------------------------------------------------------------
+CCTimeType CCRakNetSlidingWindow::GetNextACKTime(CCTimeType curTime) const
+{
+	if (GetSenderRTOForACK()==(CCTimeType) UNSET_TIME_US)
+		return curTime;
+	return oldestUnsentAck + SYN;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
 DatagramSequenceNumberType CCRakNetSlidingWindow::GetNextDatagramSequenceNumber(void)
 {
 	return nextDatagramSequenceNumber;
@@ -117,6 +122,18 @@ DatagramSequenceNumberType CCRakNetSlidingWindow::GetAndIncrementNextDatagramSeq
 	return dsnt;
 }
 // ----------------------------------------------------------------------------------------------------------------------------
+DatagramSequenceNumberType CCRakNetSlidingWindow::GetExpectedNextDatagramSequenceNumber(void) const
+{
+	return expectedNextSequenceNumber;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetSlidingWindow::SetDatagramSequenceNumbers(DatagramSequenceNumberType _nextDatagramSequenceNumber, DatagramSequenceNumberType _expectedNextSequenceNumber)
+{
+	nextDatagramSequenceNumber=_nextDatagramSequenceNumber;
+	nextCongestionControlBlock=_nextDatagramSequenceNumber;
+	expectedNextSequenceNumber=_expectedNextSequenceNumber;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
 void CCRakNetSlidingWindow::OnSendBytes(CCTimeType curTime, uint32_t numBytes)
 {
 	(void) curTime;
@@ -210,21 +227,8 @@ void CCRakNetSlidingWindow::OnAck(CCTimeType curTime, CCTimeType rtt, bool hasBA
 	(void) _AS;
 	(void) hasBAndAS;
 	(void) curTime;
-	(void) rtt;
 
-	lastRtt=(double) rtt;
-	if (estimatedRTT==UNSET_TIME_US)
-	{
-		estimatedRTT=(double) rtt;
-		deviationRtt=(double)rtt;
-	}
-	else
-	{
-		double d = .05;
-		double difference = rtt - estimatedRTT;
-		estimatedRTT = estimatedRTT + d * difference;
-		deviationRtt = deviationRtt + d * (std::abs(difference) - deviationRtt);
-	}
+	UpdateRTT(rtt);
 
 	_isContinuousSend=isContinuousSend;
 
@@ -343,23 +347,25 @@ double CCRakNetSlidingWindow::GetRTT(void) const
 	return lastRtt;
 }
 // ----------------------------------------------------------------------------------------------------------------------------
-bool CCRakNetSlidingWindow::GreaterThan(DatagramSequenceNumberType a, DatagramSequenceNumberType b)
-{
-	// a > b?
-	const DatagramSequenceNumberType halfSpan =(DatagramSequenceNumberType) (((DatagramSequenceNumberType)(const uint32_t)-1)/(DatagramSequenceNumberType)2);
-	return b!=a && b-a>halfSpan;
-}
-// ----------------------------------------------------------------------------------------------------------------------------
-bool CCRakNetSlidingWindow::LessThan(DatagramSequenceNumberType a, DatagramSequenceNumberType b)
+uint64_t CCRakNetSlidingWindow::GetBytesPerSecondLimitByCongestionControl(void) const
 {
-	// a < b?
-	const DatagramSequenceNumberType halfSpan = ((DatagramSequenceNumberType)(const uint32_t)-1)/(DatagramSequenceNumberType)2;
-	return b!=a && b-a<halfSpan;
+	return 0; // TODO
 }
 // ----------------------------------------------------------------------------------------------------------------------------
-uint64_t CCRakNetSlidingWindow::GetBytesPerSecondLimitByCongestionControl(void) const
+double CCRakNetSlidingWindow::GetPacingRate(void) const
 {
-	return 0; // TODO
+	if (estimatedRTT==UNSET_TIME_US || estimatedRTT<=0.0)
+		return 0.0;
+
+	// Gains as in Linux TCP pacing. In slow start, cwnd doubles every round trip, so pace at twice the current window
+#if CC_TIME_TYPE_BYTES==4
+	const double rttSeconds=estimatedRTT/1000.0;
+#else
+	const double rttSeconds=estimatedRTT/1000000.0;
+#endif
+	if (IsInSlowStart())
+		return 2.0*cwnd/rttSeconds;
+	return 1.2*cwnd/rttSeconds;
 }
 // ----------------------------------------------------------------------------------------------------------------------------
 CCTimeType CCRakNetSlidingWindow::GetSenderRTOForACK(void) const
@@ -374,4 +380,20 @@ bool CCRakNetSlidingWindow::IsInSlowStart(void) const
 	return cwnd <= ssThresh || ssThresh==0;
 }
 // ----------------------------------------------------------------------------------------------------------------------------
-#endif
+void CCRakNetSlidingWindow::UpdateRTT(CCTimeType rtt)
+{
+	lastRtt=(double) rtt;
+	if (estimatedRTT==UNSET_TIME_US)
+	{
+		estimatedRTT=(double) rtt;
+		deviationRtt=(double)rtt;
+	}
+	else
+	{
+		double d = .05;
+		double difference = rtt - estimatedRTT;
+		estimatedRTT = estimatedRTT + d * difference;
+		deviationRtt = deviationRtt + d * (std::abs(difference) - deviationRtt);
+	}
+}
+// ----------------------------------------------------------------------------------------------------------------------------
@@ -15,8 +15,6 @@
 
 #include "slikenet/CCRakNetUDT.h"
 
-#if USE_SLIDING_WINDOW_CONGESTION_CONTROL!=1
-
 #include "slikenet/Rand.h"
 #include "slikenet/MTUSize.h"
 #include <stdio.h>
@@ -30,6 +28,8 @@ using namespace SLNet;
 
 static const double UNSET_TIME_US=-1;
 static const double CWND_MIN_THRESHOLD=2.0;
+/// The window in slow start, in datagrams. This was the size of the resend buffer before it could grow. Slow start only ends on loss, so a larger window floods lossy links
+static const double CWND_MAX_DATAGRAMS=512.0;
 static const double UNDEFINED_TRANSFER_RATE=0.0;
 /// Interval at which to update aspects of the system
 /// 1. send acks
@@ -91,7 +91,7 @@ void CCRakNetUDT::Init(CCTimeType curTime, uint32_t maxDatagramPayload)
 	totalUserDataBytesSent=0;
 	oldestUnsentAck=0;
 	MAXIMUM_MTU_INCLUDING_UDP_HEADER=maxDatagramPayload;
-	CWND_MAX_THRESHOLD=RESEND_BUFFER_ARRAY_LENGTH;
+	CWND_MAX_THRESHOLD=CWND_MAX_DATAGRAMS;
 #if CC_TIME_TYPE_BYTES==4
 	const BytesPerMicrosecond DEFAULT_TRANSFER_RATE=(BytesPerMicrosecond) 3.6;
 #else
@@ -218,6 +218,24 @@ uint64_t CCRakNetUDT::GetBytesPerSecondLimitByCongestionControl(void) const
 #endif
 }
 // ----------------------------------------------------------------------------------------------------------------------------
+double CCRakNetUDT::GetPacingRate(void) const
+{
+#if CC_TIME_TYPE_BYTES==4
+	const double timeUnitsPerSecond=1000.0;
+#else
+	const double timeUnitsPerSecond=1000000.0;
+#endif
+	if (isInSlowStart)
+	{
+		// SND is not used yet. CWND grows by what was acked, so pace at twice the window per round trip
+		if (lastRttOnIncreaseSendRate==0)
+			return 0.0;
+		return 2.0*CWND*MAXIMUM_MTU_INCLUDING_UDP_HEADER*timeUnitsPerSecond/(double) lastRttOnIncreaseSendRate;
+	}
+	// SND is in CCTimeType units per byte
+	return 1.25*timeUnitsPerSecond/SND;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
 bool CCRakNetUDT::ShouldSendACKs(CCTimeType curTime, CCTimeType estimatedTimeToNextTick)
 {
 	CCTimeType rto = GetSenderRTOForACK();
@@ -240,6 +258,13 @@ bool CCRakNetUDT::ShouldSendACKs(CCTimeType curTime, CCTimeType estimatedTimeToN
 		estimatedTimeToNextTick+curTime < oldestUnsentAck+rto-RTT;
 }
 // ----------------------------------------------------------------------------------------------------------------------------
+CCTimeType CCRakNetUDT::GetNextACKTime(CCTimeType curTime) const
+{
+	if (GetSenderRTOForACK()==(CCTimeType) UNSET_TIME_US)
+		return curTime;
+	return oldestUnsentAck + SYN;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
 DatagramSequenceNumberType CCRakNetUDT::GetNextDatagramSequenceNumber(void)
 {
 	return nextDatagramSequenceNumber;
@@ -252,6 +277,18 @@ DatagramSequenceNumberType CCRakNetUDT::GetAndIncrementNextDatagramSequenceNumbe
 	return dsnt;
 }
 // ----------------------------------------------------------------------------------------------------------------------------
+DatagramSequenceNumberType CCRakNetUDT::GetExpectedNextDatagramSequenceNumber(void) const
+{
+	return expectedNextSequenceNumber;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
+void CCRakNetUDT::SetDatagramSequenceNumbers(DatagramSequenceNumberType _nextDatagramSequenceNumber, DatagramSequenceNumberType _expectedNextSequenceNumber)
+{
+	nextDatagramSequenceNumber=_nextDatagramSequenceNumber;
+	nextCongestionControlBlock=_nextDatagramSequenceNumber;
+	expectedNextSequenceNumber=_expectedNextSequenceNumber;
+}
+// ----------------------------------------------------------------------------------------------------------------------------
 void CCRakNetUDT::OnSendBytes(CCTimeType curTime, uint32_t numBytes)
 {
 	(void) curTime;
@@ -350,20 +387,6 @@ BytesPerMicrosecond CCRakNetUDT::CalculateListMedianRecursive(const BytesPerMicr
 	}
 }
 
-// ----------------------------------------------------------------------------------------------------------------------------
-bool CCRakNetUDT::GreaterThan(DatagramSequenceNumberType a, DatagramSequenceNumberType b)
-{
-	// a > b?
-	const DatagramSequenceNumberType halfSpan =(DatagramSequenceNumberType) (((DatagramSequenceNumberType)(const uint32_t)-1)/(DatagramSequenceNumberType)2);
-	return b!=a && b-a>halfSpan;
-}
-// ----------------------------------------------------------------------------------------------------------------------------
-bool CCRakNetUDT::LessThan(DatagramSequenceNumberType a, DatagramSequenceNumberType b)
-{
-	// a < b?
-	const DatagramSequenceNumberType halfSpan = ((DatagramSequenceNumberType)(const uint32_t)-1)/(DatagramSequenceNumberType)2;
-	return b!=a && b-a<halfSpan;
-}
 // ----------------------------------------------------------------------------------------------------------------------------
 CCTimeType CCRakNetUDT::GetSenderRTOForACK(void) const
 {
@@ -809,5 +832,3 @@ void CCRakNetUDT::SetTimeBetweenSendsLimit(unsigned int bitsPerSecond)
 		SND=limit;
 }
 */
-
-#endif
@@ -36,6 +36,8 @@ enum ServerToServerCommands
 
 using namespace SLNet;
 
+STATIC_FACTORY_DEFINITIONS(CloudServer,CloudServer);
+
 int CloudServer::RemoteServerComp(const RakNetGUID &key, RemoteServer* const &data )
 {
 	if (key < data->serverAddress)
@@ -64,18 +66,6 @@ int CloudServer::KeyDataPtrComp( const RakNetGUID &key, CloudData* const &data )
 		return 1;
 	return 0;
 }
-int CloudServer::KeyDataListComp( const CloudKey &key, CloudDataList * const &data )
-{
-	if (key.primaryKey < data->key.primaryKey)
-		return -1;
-	if (key.primaryKey > data->key.primaryKey)
-		return 1;
-	if (key.secondaryKey < data->key.secondaryKey)
-		return -1;
-	if (key.secondaryKey > data->key.secondaryKey)
-		return 1;
-	return 0;
-}
 int CloudServer::BufferedGetResponseFromServerComp(const RakNetGUID &key, CloudServer::BufferedGetResponseFromServer* const &data )
 {
 	if (key < data->serverAddress)
@@ -241,6 +231,15 @@ PluginReceiveResult CloudServer::OnReceive(Packet *packet)
 	}
 	return RR_CONTINUE_PROCESSING;
 }
+bool CloudServer::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_CLOUD_POST_REQUEST]=true;
+	messageIDs[ID_CLOUD_RELEASE_REQUEST]=true;
+	messageIDs[ID_CLOUD_GET_REQUEST]=true;
+	messageIDs[ID_CLOUD_UNSUBSCRIBE_REQUEST]=true;
+	messageIDs[ID_CLOUD_SERVER_TO_SERVER_COMMAND]=true;
+	return true;
+}
 void CloudServer::OnPostRequest(Packet *packet)
 {
 	SLNet::BitStream bsIn(packet->data, packet->length, false);
@@ -296,9 +295,8 @@ void CloudServer::OnPostRequest(Packet *packet)
 	}
 
 	bool cloudDataAlreadyUploaded;
-	unsigned int dataRepositoryIndex;
 	bool dataRepositoryExists;
-	CloudDataList* cloudDataList = GetOrAllocateCloudDataList(key, &dataRepositoryExists, dataRepositoryIndex);
+	CloudDataList* cloudDataList = GetOrAllocateCloudDataList(key, &dataRepositoryExists);
 	if (dataRepositoryExists==false)
 	{
 		cloudDataList->uploaderCount=1;
@@ -318,10 +316,10 @@ void CloudServer::OnPostRequest(Packet *packet)
 		if (maxUploadBytesPerClient>0 && remoteCloudClient->uploadedBytes+dataLengthBytes>maxUploadBytesPerClient)
 		{
 			// Undo prior insertion of cloudDataList into cloudData if needed
-			if (keyDataListExists==false)
+			if (dataRepositoryExists==false)
 			{
+				RemoveCloudDataList(cloudDataList);
 				SLNet::OP_DELETE(cloudDataList,_FILE_AND_LINE_);
-				dataRepository.RemoveAtIndex(dataRepositoryIndex);
 			}
 
 			if (remoteCloudClient->IsUnused())
@@ -389,8 +387,8 @@ void CloudServer::OnPostRequest(Packet *packet)
 			// Undo prior insertion of cloudDataList into cloudData if needed
 			if (dataRepositoryExists==false)
 			{
+				RemoveCloudDataList(cloudDataList);
 				SLNet::OP_DELETE(cloudDataList,_FILE_AND_LINE_);
-				dataRepository.RemoveAtIndex(dataRepositoryIndex);
 			}
 			return;
 		}
@@ -483,9 +481,7 @@ void CloudServer::OnReleaseRequest(Packet *packet)
 		unsigned int uploadedKeysIndex = remoteCloudClient->uploadedKeys.GetIndexFromKey(key,&objectExists);
 		if (objectExists)
 		{
-			bool dataRepositoryExists;
-			unsigned int dataRepositoryIndex = dataRepository.GetIndexFromKey(key, &dataRepositoryExists);
-			CloudDataList* cloudDataList = dataRepository[dataRepositoryIndex];
+			CloudDataList* cloudDataList = GetCloudDataList(key);
 			RakAssert(cloudDataList);
 
 			CloudData *cloudData;
@@ -516,8 +512,8 @@ void CloudServer::OnReleaseRequest(Packet *packet)
 
 				if (cloudDataList->IsUnused())
 				{
+					RemoveCloudDataList(cloudDataList);
 					SLNet::OP_DELETE(cloudDataList, _FILE_AND_LINE_);
-					dataRepository.RemoveAtIndex(dataRepositoryIndex);
 				}
 			}
 
@@ -639,9 +635,8 @@ void CloudServer::OnGetRequest(Packet *packet)
 			remoteCloudClient->subscribedKeys.InsertAtIndex(keySubscriberId, keySubscriberIndex, _FILE_AND_LINE_);
 
 			// Add CloudData in a similar way
-			unsigned int dataRepositoryIndex;
 			bool dataRepositoryExists;
-			CloudDataList* cloudDataList = GetOrAllocateCloudDataList(cloudKey, &dataRepositoryExists, dataRepositoryIndex);
+			CloudDataList* cloudDataList = GetOrAllocateCloudDataList(cloudKey, &dataRepositoryExists);
 
 			// If this is the first local client to subscribe to this key, call SendSubscribedKeyToServers
 			if (cloudDataList->subscriberCount==0)
@@ -756,19 +751,12 @@ void CloudServer::OnUnsubscribeRequest(Packet *packet)
 			return;
 	}
 
-//	CloudDataList *cloudDataList;
-	bool dataRepositoryExists;
-//	unsigned int dataRepositoryIndex;
-
 	for (index=0; index < keyCount; index++)
 	{
 		cloudKey = cloudKeys[index];
 
-	//	dataRepositoryIndex = 
-			dataRepository.GetIndexFromKey(cloudKey, &dataRepositoryExists);
-		if (dataRepositoryExists==false)
+		if (GetCloudDataList(cloudKey)==0)
 			continue;
-//		cloudDataList = dataRepository[dataRepositoryIndex];
 
 		unsigned int keySubscriberIndex;
 		bool hasKeySubscriber;
@@ -914,11 +902,9 @@ void CloudServer::OnClosedConnection(const SystemAddress &systemAddress, RakNetG
 		for (uploadedKeysIndex=0; uploadedKeysIndex < remoteCloudClient->uploadedKeys.Size(); uploadedKeysIndex++)
 		{
 			// Delete keys this system has uploaded
-			bool keyDataRepositoryExists;
-			unsigned int dataRepositoryIndex = dataRepository.GetIndexFromKey(remoteCloudClient->uploadedKeys[uploadedKeysIndex], &keyDataRepositoryExists);
-			if (keyDataRepositoryExists)
+			CloudDataList* cloudDataList = GetCloudDataList(remoteCloudClient->uploadedKeys[uploadedKeysIndex]);
+			if (cloudDataList)
 			{
-				CloudDataList* cloudDataList = dataRepository[dataRepositoryIndex];
 				bool keyDataExists;
 				unsigned int keyDataIndex = cloudDataList->keyData.GetIndexFromKey(rakNetGUID, &keyDataExists);
 				if (keyDataExists)
@@ -948,8 +934,8 @@ void CloudServer::OnClosedConnection(const SystemAddress &systemAddress, RakNetG
 							// Tell other servers that this key is no longer uploaded, so they do not request it from us
 							RemoveUploadedKeyFromServers(cloudDataList->key);
 
+							RemoveCloudDataList(cloudDataList);
 							SLNet::OP_DELETE(cloudDataList, _FILE_AND_LINE_);
-							dataRepository.RemoveAtIndex(dataRepositoryIndex);
 						}
 					}
 				}
@@ -962,11 +948,9 @@ void CloudServer::OnClosedConnection(const SystemAddress &systemAddress, RakNetG
 			KeySubscriberID* keySubscriberId;
 			keySubscriberId = remoteCloudClient->subscribedKeys[subscribedKeysIndex];
 
-			bool keyDataRepositoryExists;
-			unsigned int keyDataRepositoryIndex = dataRepository.GetIndexFromKey(remoteCloudClient->subscribedKeys[subscribedKeysIndex]->key, &keyDataRepositoryExists);
-			if (keyDataRepositoryExists)
+			CloudDataList* cloudDataList = GetCloudDataList(remoteCloudClient->subscribedKeys[subscribedKeysIndex]->key);
+			if (cloudDataList)
 			{
-				CloudDataList* cloudDataList = dataRepository[keyDataRepositoryIndex];
 				if (keySubscriberId->specificSystemsSubscribedTo.Size()==0)
 				{
 					cloudDataList->nonSpecificSubscribers.Remove(rakNetGUID);
@@ -1004,9 +988,11 @@ void CloudServer::OnRakPeerShutdown(void)
 void CloudServer::Clear(void)
 {
 	unsigned int i,j;
-	for (i=0; i < dataRepository.Size(); i++)
+	for (i=0; i < dataRepository.GetSlotCount(); i++)
 	{
-		CloudDataList *cloudDataList = dataRepository[i];
+		CloudDataList *cloudDataList = dataRepository.GetDataAtSlot(i);
+		if (cloudDataList==0)
+			continue;
 		for (j=0; j < cloudDataList->keyData.Size(); j++)
 		{
 			cloudDataList->keyData[j]->Clear();
@@ -1014,7 +1000,7 @@ void CloudServer::Clear(void)
 		}
 		SLNet::OP_DELETE(cloudDataList, _FILE_AND_LINE_);
 	}
-	dataRepository.Clear(false, _FILE_AND_LINE_);
+	dataRepository.Clear(_FILE_AND_LINE_);
 
 	for (i=0; i < remoteServers.Size(); i++)
 	{
@@ -1068,6 +1054,10 @@ void CloudServer::WriteCloudQueryRowFromResultList(unsigned int i, DataStructure
 }
 void CloudServer::NotifyClientSubscribersOfDataChange( CloudData *cloudData, CloudKey &key, DataStructures::OrderedList<RakNetGUID, RakNetGUID> &subscribers, bool wasUpdated )
 {
+	// Most keys have no subscribers, so do not serialize the row for nobody
+	if (subscribers.Size()==0)
+		return;
+
 	SLNet::BitStream bsOut;
 	bsOut.Write((MessageID) ID_CLOUD_SUBSCRIPTION_NOTIFICATION);
 	bsOut.Write(wasUpdated);
@@ -1081,29 +1071,37 @@ void CloudServer::NotifyClientSubscribersOfDataChange( CloudData *cloudData, Clo
 	row.clientGUID=cloudData->clientGUID;
 	row.Serialize(true,&bsOut,0);
 
+	DataStructures::List<AddressOrGUID> targets;
+	targets.Preallocate(subscribers.Size(), _FILE_AND_LINE_);
 	unsigned int i;
 	for (i=0; i < subscribers.Size(); i++)
-	{
-		SendUnified(&bsOut, HIGH_PRIORITY, RELIABLE_ORDERED, 0, subscribers[i], false);
-	}
+		targets.Push(subscribers[i], _FILE_AND_LINE_);
+	SendToListUnified(&bsOut, HIGH_PRIORITY, RELIABLE_ORDERED, 0, &targets[0], targets.Size());
 }
 void CloudServer::NotifyClientSubscribersOfDataChange( CloudQueryRow *row, DataStructures::OrderedList<RakNetGUID, RakNetGUID> &subscribers, bool wasUpdated )
 {
+	if (subscribers.Size()==0)
+		return;
+
 	SLNet::BitStream bsOut;
 	bsOut.Write((MessageID) ID_CLOUD_SUBSCRIPTION_NOTIFICATION);
 	bsOut.Write(wasUpdated);
 	row->Serialize(true,&bsOut,0);
 
+	DataStructures::List<AddressOrGUID> targets;
+	targets.Preallocate(subscribers.Size(), _FILE_AND_LINE_);
 	unsigned int i;
 	for (i=0; i < subscribers.Size(); i++)
-	{
-		SendUnified(&bsOut, HIGH_PRIORITY, RELIABLE_ORDERED, 0, subscribers[i], false);
-	}
+		targets.Push(subscribers[i], _FILE_AND_LINE_);
+	SendToListUnified(&bsOut, HIGH_PRIORITY, RELIABLE_ORDERED, 0, &targets[0], targets.Size());
 }
 void CloudServer::NotifyServerSubscribersOfDataChange( CloudData *cloudData, CloudKey &key, bool wasUpdated )
 {
 	// Find every server that has subscribed
 	// Send them change notifications
+	if (remoteServers.Size()==0)
+		return;
+
 	SLNet::BitStream bsOut;
 	bsOut.Write((MessageID)ID_CLOUD_SERVER_TO_SERVER_COMMAND);
 	bsOut.Write((MessageID)STSC_DATA_CHANGED);
@@ -1118,14 +1116,17 @@ void CloudServer::NotifyServerSubscribersOfDataChange( CloudData *cloudData, Clo
 	row.clientGUID=cloudData->clientGUID;
 	row.Serialize(true,&bsOut,0);
 
+	DataStructures::List<AddressOrGUID> targets;
 	unsigned int i;
 	for (i=0; i < remoteServers.Size(); i++)
 	{
 		if (remoteServers[i]->gotSubscribedAndUploadedKeys==false || remoteServers[i]->subscribedKeys.HasData(key))
 		{
-			SendUnified(&bsOut, HIGH_PRIORITY, RELIABLE_ORDERED, 0, remoteServers[i]->serverAddress, false);
+			targets.Push(remoteServers[i]->serverAddress, _FILE_AND_LINE_);
 		}
 	}
+	if (targets.Size()>0)
+		SendToListUnified(&bsOut, HIGH_PRIORITY, RELIABLE_ORDERED, 0, &targets[0], targets.Size());
 }
 void CloudServer::AddServer(RakNetGUID systemIdentifier)
 {
@@ -1253,7 +1254,6 @@ void CloudServer::ProcessCloudQueryWithAddresses( CloudServer::CloudQueryWithAdd
 	CloudQueryResult cloudQueryResult;
 	CloudQueryRow cloudQueryRow;
 	unsigned int queryIndex;
-	bool dataRepositoryExists;
 	CloudDataList* cloudDataList;
 	unsigned int keyDataIndex;
 
@@ -1263,11 +1263,9 @@ void CloudServer::ProcessCloudQueryWithAddresses( CloudServer::CloudQueryWithAdd
 	{
 		const CloudKey &key = cloudQueryWithAddresses.cloudQuery.keys[queryIndex];
 
-		unsigned int dataRepositoryIndex = dataRepository.GetIndexFromKey(key, &dataRepositoryExists);
-		if (dataRepositoryExists)
+		cloudDataList=GetCloudDataList(key);
+		if (cloudDataList)
 		{
-			cloudDataList=dataRepository[dataRepositoryIndex];
-
 			if (cloudDataList->uploaderCount>0)
 			{
 				// Return all keyData that was uploaded by specificSystems, or all if not specified
@@ -1305,18 +1303,23 @@ void CloudServer::SendUploadedAndSubscribedKeysToServer( RakNetGUID systemAddres
 	bsOut.Write((MessageID)ID_CLOUD_SERVER_TO_SERVER_COMMAND);
 	bsOut.Write((MessageID)STSC_ADD_UPLOADED_AND_SUBSCRIBED_KEYS);
 	bsOut.WriteCasted<uint16_t>(dataRepository.Size());
-	for (unsigned int i=0; i < dataRepository.Size(); i++)
-		dataRepository[i]->key.Serialize(true, &bsOut);
+	unsigned int i;
+	for (i=0; i < dataRepository.GetSlotCount(); i++)
+	{
+		if (dataRepository.GetDataAtSlot(i))
+			dataRepository.GetDataAtSlot(i)->key.Serialize(true, &bsOut);
+	}
 
 	BitSize_t startOffset, endOffset;
 	uint16_t subscribedKeyCount=0;
 	startOffset=bsOut.GetWriteOffset();
 	bsOut.WriteCasted<uint16_t>(subscribedKeyCount);
-	for (unsigned int i=0; i < dataRepository.Size(); i++)
+	for (i=0; i < dataRepository.GetSlotCount(); i++)
 	{
-		if (dataRepository[i]->subscriberCount>0)
+		CloudDataList *cloudDataList = dataRepository.GetDataAtSlot(i);
+		if (cloudDataList && cloudDataList->subscriberCount>0)
 		{
-			dataRepository[i]->key.Serialize(true, &bsOut);
+			cloudDataList->key.Serialize(true, &bsOut);
 			subscribedKeyCount++;
 		}
 	}
@@ -1499,16 +1502,12 @@ void CloudServer::OnServerDataChanged( Packet *packet )
 	CloudQueryRow row;
 	row.Serialize(false, &bsIn, this);
 
-	CloudDataList *cloudDataList;
-	bool dataRepositoryExists;
-	unsigned int dataRepositoryIndex;
-	dataRepositoryIndex = dataRepository.GetIndexFromKey(row.key, &dataRepositoryExists);
-	if (dataRepositoryExists==false)
+	CloudDataList *cloudDataList = GetCloudDataList(row.key);
+	if (cloudDataList==0)
 	{
 		DeallocateRowData(row.data);
 		return;
 	}
-	cloudDataList = dataRepository[dataRepositoryIndex];
 	CloudData *cloudData;
 	bool keyDataListExists;
 	unsigned int keyDataListIndex = cloudDataList->keyData.GetIndexFromKey(row.clientGUID, &keyDataListExists);
@@ -1560,26 +1559,57 @@ void CloudServer::GetServersWithUploadedKeys(
 	}
 }
 
-CloudServer::CloudDataList *CloudServer::GetOrAllocateCloudDataList(CloudKey key, bool *dataRepositoryExists, unsigned int &dataRepositoryIndex)
+CloudServer::CloudDataList *CloudServer::GetOrAllocateCloudDataList(CloudKey key, bool *dataRepositoryExists)
 {
-	CloudDataList *cloudDataList;
-
-	dataRepositoryIndex = dataRepository.GetIndexFromKey(key, dataRepositoryExists);
-	if (*dataRepositoryExists==false)
+	CloudDataList *cloudDataList = GetCloudDataList(key);
+	*dataRepositoryExists = cloudDataList!=0;
+	if (cloudDataList==0)
 	{
 		cloudDataList = SLNet::OP_NEW<CloudDataList>(_FILE_AND_LINE_);
 		cloudDataList->key=key;
+		cloudDataList->keyHash=CloudKeyToHash(key);
 		cloudDataList->uploaderCount=0;
 		cloudDataList->subscriberCount=0;
-		dataRepository.InsertAtIndex(cloudDataList,dataRepositoryIndex,_FILE_AND_LINE_);
-	}
-	else
-	{
-		cloudDataList = dataRepository[dataRepositoryIndex];
+		AddCloudDataList(cloudDataList);
 	}
 
 	return cloudDataList;
 }
+uint32_t CloudServer::CloudKeyToHash(const CloudKey &key)
+{
+	// Mix in the secondary key, as many keys share the primary key
+	uint32_t hash = (uint32_t) RakString::ToInteger(key.primaryKey) ^ (key.secondaryKey*0x9E3779B1u);
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6Bu;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35u;
+	hash ^= hash >> 16;
+	return hash;
+}
+CloudServer::CloudDataList *CloudServer::GetCloudDataList(const CloudKey &key)
+{
+	DataRepositoryKey repositoryKey;
+	repositoryKey.keyHash = CloudKeyToHash(key);
+	repositoryKey.key = &key;
+	return dataRepository.Get(repositoryKey);
+}
+void CloudServer::AddCloudDataList(CloudDataList *cloudDataList)
+{
+	DataRepositoryKey repositoryKey;
+	repositoryKey.keyHash = cloudDataList->keyHash;
+	repositoryKey.key = &cloudDataList->key;
+	dataRepository.Insert(repositoryKey, cloudDataList, _FILE_AND_LINE_);
+}
+void CloudServer::RemoveCloudDataList(CloudDataList *cloudDataList)
+{
+	DataRepositoryKey repositoryKey;
+	repositoryKey.keyHash = cloudDataList->keyHash;
+	repositoryKey.key = &cloudDataList->key;
+	if (dataRepository.Remove(repositoryKey, _FILE_AND_LINE_)==false)
+	{
+		RakAssert("CloudServer::RemoveCloudDataList didn't find cloudDataList" && 0);
+	}
+}
 
 void CloudServer::UnsubscribeFromKey(RemoteCloudClient *remoteCloudClient, RakNetGUID remoteCloudClientGuid, unsigned int keySubscriberIndex, CloudKey &cloudKey, DataStructures::List<RakNetGUID> &specificSystems)
 {
@@ -1589,15 +1619,12 @@ void CloudServer::UnsubscribeFromKey(RemoteCloudClient *remoteCloudClient, RakNe
 	if (keySubscriberId->specificSystemsSubscribedTo.Size()==0 && specificSystems.Size()>0)
 		return;
 
-	bool dataRepositoryExists;
-	CloudDataList *cloudDataList;
-	unsigned int dataRepositoryIndex = dataRepository.GetIndexFromKey(cloudKey, &dataRepositoryExists);
-	if (dataRepositoryExists==false)
+	CloudDataList *cloudDataList = GetCloudDataList(cloudKey);
+	if (cloudDataList==0)
 		return;
 
 	unsigned int i,j;
 
-	cloudDataList = dataRepository[dataRepositoryIndex];
 	if (specificSystems.Size()==0)
 	{
 		// Remove global subscriber. If returns false, have to remove specific subscribers
@@ -1636,8 +1663,8 @@ void CloudServer::UnsubscribeFromKey(RemoteCloudClient *remoteCloudClient, RakNe
 
 	if (cloudDataList->IsUnused())
 	{
+		RemoveCloudDataList(cloudDataList);
 		SLNet::OP_DELETE(cloudDataList, _FILE_AND_LINE_);
-		dataRepository.RemoveAtIndex(dataRepositoryIndex);
 	}
 }
 void CloudServer::RemoveSpecificSubscriber(RakNetGUID specificSubscriber, CloudDataList *cloudDataList, RakNetGUID remoteCloudClientGuid)
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "slikenet/ConnectionArena.h"
+#include "slikenet/memoryoverride.h"
+#include "slikenet/assert.h"
+
+using namespace SLNet;
+
+// Block sizes including the BlockHeader. Multiples of 16 keep the blocks after the 16 byte PageHeader aligned to 8 bytes
+const uint32_t ConnectionArena::SIZE_CLASSES[SIZE_CLASS_COUNT]={16,32,48,64,96,128,192,256,320,384,512,640,768,1024,1536,2048};
+
+ArenaPagePool::ArenaPagePool()
+{
+	freePages=0;
+}
+ArenaPagePool::~ArenaPagePool()
+{
+	Clear(_FILE_AND_LINE_);
+}
+void *ArenaPagePool::Allocate( const char *file, unsigned int line )
+{
+	void *page;
+	mutex.Lock();
+	page=freePages;
+	if (page)
+	{
+		freePages=*(void**)page;
+		freePageCount.Decrement();
+	}
+	mutex.Unlock();
+	if (page)
+		return page;
+
+	page=rakMalloc_Ex(CONNECTION_ARENA_PAGE_SIZE, file, line);
+	if (page)
+		pageCount.Increment();
+	return page;
+}
+void ArenaPagePool::Release( void *page )
+{
+	mutex.Lock();
+	*(void**)page=freePages;
+	freePages=page;
+	freePageCount.Increment();
+	mutex.Unlock();
+}
+void ArenaPagePool::Clear( const char *file, unsigned int line )
+{
+	mutex.Lock();
+	while (freePages)
+	{
+		void *page=freePages;
+		freePages=*(void**)page;
+		rakFree_Ex(page, file, line);
+		freePageCount.Decrement();
+		pageCount.Decrement();
+	}
+	mutex.Unlock();
+}
+
+ConnectionArena::ConnectionArena()
+{
+	pagePool=0;
+	pages=0;
+	pageFreeStart=pageFreeEnd=0;
+	for (int i=0; i < SIZE_CLASS_COUNT; i++)
+		freeBlocks[i]=0;
+	heapBlocks=0;
+	budget=0;
+}
+ConnectionArena::~ConnectionArena()
+{
+	Clear(_FILE_AND_LINE_);
+}
+void ConnectionArena::SetPagePool( ArenaPagePool *_pagePool )
+{
+	RakAssert(pages==0);
+	pagePool=_pagePool;
+}
+void *ConnectionArena::Allocate( unsigned int numBytes, const char *file, unsigned int line )
+{
+	const uint32_t blockSize=numBytes+sizeof(BlockHeader);
+	int sizeClass=0;
+	while (sizeClass < SIZE_CLASS_COUNT && SIZE_CLASSES[sizeClass] < blockSize)
+		sizeClass++;
+	if (sizeClass==SIZE_CLASS_COUNT || SIZE_CLASSES[sizeClass] > CONNECTION_ARENA_PAGE_SIZE-sizeof(PageHeader))
+		return AllocateHeapBlock(blockSize, file, line);
+
+	BlockHeader *header=freeBlocks[sizeClass];
+	if (header)
+		freeBlocks[sizeClass]=*(BlockHeader**)(header+1);
+	else
+	{
+		if ((uint32_t) (pageFreeEnd-pageFreeStart) < SIZE_CLASSES[sizeClass] && AllocatePage(file, line)==false)
+			return 0;
+		header=(BlockHeader*) pageFreeStart;
+		header->sizeClass=(uint32_t) sizeClass;
+		header->blockSize=SIZE_CLASSES[sizeClass];
+		pageFreeStart+=SIZE_CLASSES[sizeClass];
+	}
+
+	bytesInUse.Store(bytesInUse.GetValue()+header->blockSize);
+	return header+1;
+}
+void ConnectionArena::Release( void *block, const char *file, unsigned int line )
+{
+	if (block==0)
+		return;
+
+	BlockHeader *header=((BlockHeader*) block)-1;
+	RakAssert(bytesInUse.GetValue()>=header->blockSize);
+	bytesInUse.Store(bytesInUse.GetValue()-header->blockSize);
+	if (header->sizeClass==HEAP_BLOCK)
+	{
+		HeapBlockLink *link=((HeapBlockLink*) header)-1;
+		if (link->prev)
+			link->prev->next=link->next;
+		else
+			heapBlocks=link->next;
+		if (link->next)
+			link->next->prev=link->prev;
+		bytesReserved.Store(bytesReserved.GetValue()-header->blockSize-sizeof(HeapBlockLink));
+		rakFree_Ex(link, file, line);
+		return;
+	}
+
+	*(BlockHeader**)(header+1)=freeBlocks[header->sizeClass];
+	freeBlocks[header->sizeClass]=header;
+}
+void ConnectionArena::Clear( const char *file, unsigned int line )
+{
+	while (pages)
+	{
+		PageHeader *next=pages->next;
+		if (pagePool)
+			pagePool->Release(pages);
+		else
+			rakFree_Ex(pages, file, line);
+		pages=next;
+	}
+	while (heapBlocks)
+	{
+		HeapBlockLink *next=heapBlocks->next;
+		rakFree_Ex(heapBlocks, file, line);
+		heapBlocks=next;
+	}
+	pageFreeStart=pageFreeEnd=0;
+	for (int i=0; i < SIZE_CLASS_COUNT; i++)
+		freeBlocks[i]=0;
+	bytesInUse.Store(0);
+	bytesReserved.Store(0);
+}
+void ConnectionArena::AddExternalBytes( unsigned int numBytes )
+{
+	bytesInUse.Store(bytesInUse.GetValue()+numBytes);
+}
+void ConnectionArena::SubtractExternalBytes( unsigned int numBytes )
+{
+	RakAssert(bytesInUse.GetValue()>=numBytes);
+	bytesInUse.Store(bytesInUse.GetValue()-numBytes);
+}
+bool ConnectionArena::AllocatePage( const char *file, unsigned int line )
+{
+	PageHeader *page;
+	if (pagePool)
+		page=(PageHeader*) pagePool->Allocate(file, line);
+	else
+		page=(PageHeader*) rakMalloc_Ex(CONNECTION_ARENA_PAGE_SIZE, file, line);
+	if (page==0)
+	{
+		notifyOutOfMemory(file, line);
+		return false;
+	}
+
+	// Keep the rest of the previous page for smaller blocks
+	for (int i=SIZE_CLASS_COUNT-1; i >= 0; i--)
+	{
+		while ((uint32_t) (pageFreeEnd-pageFreeStart) >= SIZE_CLASSES[i])
+		{
+			BlockHeader *header=(BlockHeader*) pageFreeStart;
+			header->sizeClass=(uint32_t) i;
+			header->blockSize=SIZE_CLASSES[i];
+			*(BlockHeader**)(header+1)=freeBlocks[i];
+			freeBlocks[i]=header;
+			pageFreeStart+=SIZE_CLASSES[i];
+		}
+	}
+
+	page->next=pages;
+	pages=page;
+	pageFreeStart=(unsigned char*) (page+1);
+	pageFreeEnd=(unsigned char*) page+CONNECTION_ARENA_PAGE_SIZE;
+	bytesReserved.Store(bytesReserved.GetValue()+CONNECTION_ARENA_PAGE_SIZE);
+	return true;
+}
+void *ConnectionArena::AllocateHeapBlock( uint32_t blockSize, const char *file, unsigned int line )
+{
+	HeapBlockLink *link=(HeapBlockLink*) rakMalloc_Ex(sizeof(HeapBlockLink)+blockSize, file, line);
+	if (link==0)
+	{
+		notifyOutOfMemory(file, line);
+		return 0;
+	}
+	link->prev=0;
+	link->next=heapBlocks;
+	if (heapBlocks)
+		heapBlocks->prev=link;
+	heapBlocks=link;
+
+	BlockHeader *header=(BlockHeader*) (link+1);
+	header->sizeClass=HEAP_BLOCK;
+	header->blockSize=blockSize;
+	bytesInUse.Store(bytesInUse.GetValue()+blockSize);
+	bytesReserved.Store(bytesReserved.GetValue()+blockSize+sizeof(HeapBlockLink));
+	return header+1;
+}
@@ -310,4 +310,12 @@ PluginReceiveResult ConnectionGraph2::OnReceive(Packet *packet)
 	return RR_CONTINUE_PROCESSING;
 }
 
+bool ConnectionGraph2::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_REMOTE_CONNECTION_LOST]=true;
+	messageIDs[ID_REMOTE_DISCONNECTION_NOTIFICATION]=true;
+	messageIDs[ID_REMOTE_NEW_INCOMING_CONNECTION]=true;
+	return true;
+}
+
 #endif // _RAKNET_SUPPORT_*
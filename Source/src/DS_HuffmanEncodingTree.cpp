@@ -122,6 +122,7 @@ void HuffmanEncodingTree::GenerateFromFrequencyTable( unsigned int frequencyTabl
 
 	bool tempPath[ 256 ]; // Maximum path length is 256
 	unsigned short tempPathLength;
+	uint32_t codeWord;
 	HuffmanEncodingTreeNode *currentNode;
 	SLNet::BitStream bitStream;
 
@@ -149,20 +150,50 @@ void HuffmanEncodingTree::GenerateFromFrequencyTable( unsigned int frequencyTabl
 		while ( currentNode != root );
 
 		// Write to the bitstream in the reverse order that we stored the path, which gives us the correct order from the root to the leaf
+		codeWord = 0;
 		while ( tempPathLength-- > 0 )
 		{
 			if ( tempPath[ tempPathLength ] )   // Write 1's and 0's because writing a bool will write the BitStream TYPE_CHECKING validation bits if that is defined along with the actual data bit, which is not what we want
 				bitStream.Write1();
 			else
 				bitStream.Write0();
+
+			// Only used if the code is at most 32 bits long
+			codeWord = ( codeWord << 1 ) | ( tempPath[ tempPathLength ] ? 1 : 0 );
 		}
 
 		// Read data from the bitstream, which is written to the encoding table in bits and bitlength. Note this function allocates the encodingTable[counter].encoding pointer
 		encodingTable[ counter ].bitLength = ( unsigned char ) bitStream.CopyData( &encodingTable[ counter ].encoding );
+		encodingTable[ counter ].codeWord = codeWord;
 
 		// Reset the bitstream for the next iteration
 		bitStream.Reset();
 	}
+
+	GenerateDecodingTable();
+}
+
+void HuffmanEncodingTree::GenerateDecodingTable( void )
+{
+	// Walk the tree with the bits of each index, starting with the most significant bit, until reaching a leaf or running out of bits
+	for ( unsigned index = 0; index < ( 1 << DECODING_TABLE_BITS ); index++ )
+	{
+		HuffmanEncodingTreeNode *currentNode = root;
+		unsigned short bitLength = 0;
+
+		while ( currentNode->left && bitLength < DECODING_TABLE_BITS )
+		{
+			if ( index & ( 1 << ( DECODING_TABLE_BITS - 1 - bitLength ) ) )
+				currentNode = currentNode->right;
+			else
+				currentNode = currentNode->left;
+
+			bitLength++;
+		}
+
+		decodingTable[ index ].node = currentNode;
+		decodingTable[ index ].bitLength = bitLength;
+	}
 }
 
 // Pass an array of bytes to array and a preallocated BitStream to receive the output
@@ -170,12 +201,52 @@ void HuffmanEncodingTree::EncodeArray( unsigned char *input, size_t sizeInBytes,
 {		
 	unsigned counter;
 
+	// Code words are gathered in bitBuffer, most significant bit first, and whole bytes of it in block, which is written to output at once
+	uint64_t bitBuffer = 0;
+	unsigned bitBufferLength = 0;
+	unsigned char block[ 256 ];
+	unsigned blockLength = 0;
+
 	// For each input byte, Write out the corresponding series of 1's and 0's that give the encoded representation
-	for ( counter = 0; counter < sizeInBytes; counter++ )
+	for ( size_t index = 0; index < sizeInBytes; index++ )
 	{
-		output->WriteBits( encodingTable[ input[ counter ] ].encoding, encodingTable[ input[ counter ] ].bitLength, false ); // Data is left aligned
+		const CharacterEncoding &characterEncoding = encodingTable[ input[ index ] ];
+
+		if ( characterEncoding.bitLength > 32 )
+		{
+			// Rare code that does not fit bitBuffer. Write out what was gathered so far, then the code itself
+			output->WriteBits( block, blockLength * 8, false );
+			blockLength = 0;
+			block[ 0 ] = ( unsigned char ) ( bitBuffer >> 56 );
+			output->WriteBits( block, bitBufferLength, false );
+			bitBuffer = 0;
+			bitBufferLength = 0;
+			output->WriteBits( characterEncoding.encoding, characterEncoding.bitLength, false ); // Data is left aligned
+			continue;
+		}
+
+		// bitBufferLength is less than 8 here, so the code word fits
+		bitBuffer |= ( uint64_t ) characterEncoding.codeWord << ( 64 - bitBufferLength - characterEncoding.bitLength );
+		bitBufferLength += characterEncoding.bitLength;
+
+		while ( bitBufferLength >= 8 )
+		{
+			block[ blockLength++ ] = ( unsigned char ) ( bitBuffer >> 56 );
+			bitBuffer <<= 8;
+			bitBufferLength -= 8;
+		}
+
+		if ( blockLength > sizeof( block ) - 4 )
+		{
+			output->WriteBits( block, blockLength * 8, false );
+			blockLength = 0;
+		}
 	}
 
+	output->WriteBits( block, blockLength * 8, false );
+	block[ 0 ] = ( unsigned char ) ( bitBuffer >> 56 );
+	output->WriteBits( block, bitBufferLength, false );
+
 	// Byte align the output so the unassigned remaining bits don't equate to some actual value
 	if ( output->GetNumberOfBitsUsed() % 8 != 0 )
 	{
@@ -199,62 +270,85 @@ void HuffmanEncodingTree::EncodeArray( unsigned char *input, size_t sizeInBytes,
 
 unsigned HuffmanEncodingTree::DecodeArray(SLNet::BitStream * input, BitSize_t sizeInBits, size_t maxCharsToWrite, unsigned char *output )
 {
-	HuffmanEncodingTreeNode * currentNode;
-
-	unsigned outputWriteIndex;
-	outputWriteIndex = 0;
-	currentNode = root;
+	BitSize_t readOffset = input->GetReadOffset();
 
-	// For each bit, go left if it is a 0 and right if it is a 1.  When we reach a leaf, that gives us the desired value and we restart from the root
+	// Do not read past the data of input
+	BitSize_t bitsToDecode = sizeInBits;
+	if ( bitsToDecode > input->GetNumberOfUnreadBits() )
+		bitsToDecode = input->GetNumberOfUnreadBits();
 
-	for ( unsigned counter = 0; counter < sizeInBits; counter++ )
-	{
-		if ( input->ReadBit() == false )   // left!
-			currentNode = currentNode->left;
-		else
-			currentNode = currentNode->right;
-
-		if ( currentNode->left == 0 && currentNode->right == 0 )   // Leaf
-		{
-
-			if ( outputWriteIndex < maxCharsToWrite )
-				output[ outputWriteIndex ] = currentNode->value;
-
-			outputWriteIndex++;
-
-			currentNode = root;
-		}
-	}
+	unsigned outputWriteIndex = DecodeBits( input->GetData(), readOffset, bitsToDecode, maxCharsToWrite, output );
 
+	input->SetReadOffset( readOffset + sizeInBits );
 	return outputWriteIndex;
 }
 
 // Pass an array of encoded bytes to array and a preallocated BitStream to receive the output
 void HuffmanEncodingTree::DecodeArray( unsigned char *input, BitSize_t sizeInBits, SLNet::BitStream * output )
 {
-	HuffmanEncodingTreeNode * currentNode;
-
 	if ( sizeInBits <= 0 )
 		return ;
 
-	SLNet::BitStream bitStream( input, BITS_TO_BYTES(sizeInBits), false );
+	// Every code is at least one bit long
+	unsigned char *decoded = ( unsigned char* ) rakMalloc_Ex( sizeInBits, _FILE_AND_LINE_ );
+	unsigned decodedLength = DecodeBits( input, 0, sizeInBits, sizeInBits, decoded );
+	output->WriteBits( decoded, decodedLength * 8, true ); // Use WriteBits instead of Write(char) because we want to avoid TYPE_CHECKING
+	rakFree_Ex( decoded, _FILE_AND_LINE_ );
+}
 
-	currentNode = root;
+unsigned HuffmanEncodingTree::DecodeBits( const unsigned char *data, BitSize_t readOffset, BitSize_t sizeInBits, size_t maxCharsToWrite, unsigned char *output ) const
+{
+	HuffmanEncodingTreeNode * currentNode;
 
-	// For each bit, go left if it is a 0 and right if it is a 1.  When we reach a leaf, that gives us the desired value and we restart from the root
-	for ( unsigned counter = 0; counter < sizeInBits; counter++ )
+	unsigned outputWriteIndex;
+	outputWriteIndex = 0;
+
+	const BitSize_t endOffset = readOffset + sizeInBits;
+	const BitSize_t endByte = BITS_TO_BYTES( endOffset );
+
+	while ( readOffset < endOffset )
 	{
-		if ( bitStream.ReadBit() == false )   // left!
-			currentNode = currentNode->left;
+		// Look up the next DECODING_TABLE_BITS bits. Bits past the end are whatever follows in the last byte, or 0
+		BitSize_t byteIndex = readOffset >> 3;
+		uint32_t window;
+		if ( byteIndex + 3 <= endByte )
+			window = ( ( uint32_t ) data[ byteIndex ] << 16 ) | ( ( uint32_t ) data[ byteIndex + 1 ] << 8 ) | data[ byteIndex + 2 ];
 		else
-			currentNode = currentNode->right;
+		{
+			window = ( uint32_t ) data[ byteIndex ] << 16;
+			if ( byteIndex + 1 < endByte )
+				window |= ( uint32_t ) data[ byteIndex + 1 ] << 8;
+		}
+		unsigned index = ( window >> ( 24 - ( readOffset & 7 ) - DECODING_TABLE_BITS ) ) & ( ( 1 << DECODING_TABLE_BITS ) - 1 );
+
+		// A code that does not end before endOffset is the padding written by EncodeArray
+		const DecodingTableEntry &decodingTableEntry = decodingTable[ index ];
+		if ( decodingTableEntry.bitLength > endOffset - readOffset )
+			break;
+		readOffset += decodingTableEntry.bitLength;
+		currentNode = decodingTableEntry.node;
 
-		if ( currentNode->left == 0 && currentNode->right == 0 )   // Leaf
+		// For codes longer than the table, go left for each 0 bit and right for each 1 bit until reaching a leaf
+		while ( currentNode->left )
 		{
-			output->WriteBits( &( currentNode->value ), sizeof( char ) * 8, true ); // Use WriteBits instead of Write(char) because we want to avoid TYPE_CHECKING
-			currentNode = root;
+			if ( readOffset == endOffset )
+				return outputWriteIndex;
+
+			if ( data[ readOffset >> 3 ] & ( 0x80 >> ( readOffset & 7 ) ) )
+				currentNode = currentNode->right;
+			else
+				currentNode = currentNode->left;
+
+			readOffset++;
 		}
+
+		if ( outputWriteIndex < maxCharsToWrite )
+			output[ outputWriteIndex ] = currentNode->value;
+
+		outputWriteIndex++;
 	}
+
+	return outputWriteIndex;
 }
 
 // Insertion sort.  Slow but easy to write in this case
@@ -15,6 +15,9 @@
 
 #include "slikenet/DS_Table.h"
 #include "slikenet/DS_OrderedList.h"
+#include "slikenet/SuperFastHash.h"
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 #include "slikenet/assert.h"
 #include "slikenet/assert.h"
@@ -40,6 +43,299 @@ void FreeRow(Table::Row* input, int index)
 	}
 	SLNet::OP_DELETE(input, _FILE_AND_LINE_);
 }
+enum IndexSlotState
+{
+	// Empty cell, unused slot, or NaN in a NUMERIC column
+	INDEX_SLOT_ABSENT,
+	INDEX_SLOT_INDEXED,
+	// NUMERIC only: changed since the ordered entries were last sorted
+	INDEX_SLOT_PENDING,
+	// STRING only: a cell with no string, which QueryRow() does not test, so it is a candidate for every query
+	INDEX_SLOT_NULL_STRING
+};
+static const unsigned NO_INDEX_SLOT=(unsigned)-1;
+static const unsigned INITIAL_INDEX_BUCKET_COUNT=64;
+
+struct OrderedIndexEntry
+{
+	double value;
+	unsigned slot;
+};
+static int OrderedIndexEntryComp(const void *a, const void *b)
+{
+	const OrderedIndexEntry *x=(const OrderedIndexEntry*) a, *y=(const OrderedIndexEntry*) b;
+	if (x->value!=y->value)
+		return x->value<y->value ? -1 : 1;
+	return x->slot<y->slot ? -1 : (x->slot>y->slot ? 1 : 0);
+}
+
+// A row that passed the indices, to be tested by QueryRow()
+struct IndexCandidate
+{
+	unsigned rowId;
+	unsigned slot;
+};
+static int IndexCandidateComp(const void *a, const void *b)
+{
+	unsigned x=((const IndexCandidate*) a)->rowId, y=((const IndexCandidate*) b)->rowId;
+	return x<y ? -1 : (x>y ? 1 : 0);
+}
+
+struct Table::Index
+{
+	Index(unsigned column, ColumnType type);
+	~Index();
+
+	// Adds slots up to slotCount, all absent
+	void AddSlots(unsigned slotCount);
+	void SetSlot(unsigned slot, const Cell *cell);
+	void ClearSlot(unsigned slot);
+
+	// NUMERIC: drops the entries of changed slots and merges in the pending ones
+	void Sort(void);
+	// NUMERIC: the first entry whose value is not less than value, or greater than value
+	unsigned LowerBound(double value) const;
+	unsigned UpperBound(double value) const;
+
+	// STRING
+	unsigned GetBucket(unsigned hash) const;
+	void RemoveFromBucket(unsigned slot);
+	void Rehash(unsigned newBucketCount);
+
+	unsigned columnIndex;
+	ColumnType columnType;
+	// One IndexSlotState for each slot
+	DataStructures::List<unsigned char> states;
+
+	// NUMERIC: the value of each slot, so filters can test the column without reading the rows
+	DataStructures::List<double> values;
+	// NUMERIC: slots ordered by value. Entries of slots that are no longer INDEX_SLOT_INDEXED are stale until Sort()
+	OrderedIndexEntry *entries;
+	unsigned entryCount;
+	DataStructures::List<unsigned> pending;
+	bool sorted;
+
+	// STRING: each bucket is a list of slots linked through next
+	DataStructures::List<unsigned> hashes;
+	DataStructures::List<unsigned> next;
+	unsigned *buckets;
+	unsigned bucketCount;
+	unsigned hashedCount;
+	unsigned nullStringCount;
+};
+Table::Index::Index(unsigned column, ColumnType type)
+{
+	columnIndex=column;
+	columnType=type;
+	entries=0;
+	entryCount=0;
+	sorted=true;
+	buckets=0;
+	bucketCount=0;
+	hashedCount=0;
+	nullStringCount=0;
+	if (columnType==STRING)
+		Rehash(INITIAL_INDEX_BUCKET_COUNT);
+}
+Table::Index::~Index()
+{
+	if (entries)
+		rakFree_Ex(entries, _FILE_AND_LINE_);
+	if (buckets)
+		rakFree_Ex(buckets, _FILE_AND_LINE_);
+}
+void Table::Index::AddSlots(unsigned slotCount)
+{
+	while (states.Size() < slotCount)
+	{
+		states.Insert(INDEX_SLOT_ABSENT, _FILE_AND_LINE_);
+		if (columnType==NUMERIC)
+			values.Insert(0.0, _FILE_AND_LINE_);
+		else
+		{
+			hashes.Insert(0, _FILE_AND_LINE_);
+			next.Insert(NO_INDEX_SLOT, _FILE_AND_LINE_);
+		}
+	}
+}
+void Table::Index::SetSlot(unsigned slot, const Cell *cell)
+{
+	if (columnType==NUMERIC)
+	{
+		// NaN never passes a filter
+		if (cell->isEmpty || cell->i!=cell->i)
+		{
+			ClearSlot(slot);
+			return;
+		}
+		if (states[slot]==INDEX_SLOT_INDEXED && values[slot]==cell->i)
+			return;
+		values[slot]=cell->i;
+		if (states[slot]!=INDEX_SLOT_PENDING)
+		{
+			states[slot]=INDEX_SLOT_PENDING;
+			pending.Insert(slot, _FILE_AND_LINE_);
+			sorted=false;
+			// A slot can be pending more than once if it was cleared in between
+			if (pending.Size() > states.Size()*2)
+				Sort();
+		}
+	}
+	else
+	{
+		if (cell->isEmpty)
+		{
+			ClearSlot(slot);
+			return;
+		}
+		if (states[slot]==INDEX_SLOT_INDEXED)
+			RemoveFromBucket(slot);
+		else if (states[slot]==INDEX_SLOT_NULL_STRING)
+			nullStringCount--;
+		if (cell->c==0)
+		{
+			states[slot]=INDEX_SLOT_NULL_STRING;
+			nullStringCount++;
+			return;
+		}
+		states[slot]=INDEX_SLOT_INDEXED;
+		hashes[slot]=SuperFastHash(cell->c, (int) strlen(cell->c));
+		unsigned bucket=GetBucket(hashes[slot]);
+		next[slot]=buckets[bucket];
+		buckets[bucket]=slot;
+		if (++hashedCount > bucketCount)
+			Rehash(bucketCount*2);
+	}
+}
+void Table::Index::ClearSlot(unsigned slot)
+{
+	if (columnType==NUMERIC)
+	{
+		if (states[slot]!=INDEX_SLOT_ABSENT)
+			sorted=false;
+	}
+	else if (states[slot]==INDEX_SLOT_INDEXED)
+		RemoveFromBucket(slot);
+	else if (states[slot]==INDEX_SLOT_NULL_STRING)
+		nullStringCount--;
+	states[slot]=INDEX_SLOT_ABSENT;
+}
+void Table::Index::Sort(void)
+{
+	if (sorted)
+		return;
+
+	unsigned i, kept=0;
+	for (i=0; i < entryCount; i++)
+	{
+		if (states[entries[i].slot]==INDEX_SLOT_INDEXED)
+			entries[kept++]=entries[i];
+	}
+
+	OrderedIndexEntry *added=0;
+	unsigned addedCount=0;
+	if (pending.Size()>0)
+	{
+		added=(OrderedIndexEntry*) rakMalloc_Ex(pending.Size()*sizeof(OrderedIndexEntry), _FILE_AND_LINE_);
+		RakAssert(added);
+		for (i=0; i < pending.Size(); i++)
+		{
+			unsigned slot=pending[i];
+			if (states[slot]!=INDEX_SLOT_PENDING)
+				continue;
+			states[slot]=INDEX_SLOT_INDEXED;
+			added[addedCount].value=values[slot];
+			added[addedCount].slot=slot;
+			addedCount++;
+		}
+		qsort(added, addedCount, sizeof(OrderedIndexEntry), OrderedIndexEntryComp);
+		pending.Clear(true, _FILE_AND_LINE_);
+	}
+
+	if (addedCount==0)
+		entryCount=kept;
+	else
+	{
+		OrderedIndexEntry *merged=(OrderedIndexEntry*) rakMalloc_Ex((kept+addedCount)*sizeof(OrderedIndexEntry), _FILE_AND_LINE_);
+		RakAssert(merged);
+		unsigned keptIndex=0, addedIndex=0;
+		entryCount=0;
+		while (keptIndex < kept || addedIndex < addedCount)
+		{
+			if (addedIndex==addedCount || (keptIndex < kept && OrderedIndexEntryComp(&entries[keptIndex], &added[addedIndex])<0))
+				merged[entryCount++]=entries[keptIndex++];
+			else
+				merged[entryCount++]=added[addedIndex++];
+		}
+		if (entries)
+			rakFree_Ex(entries, _FILE_AND_LINE_);
+		entries=merged;
+	}
+	if (added)
+		rakFree_Ex(added, _FILE_AND_LINE_);
+	sorted=true;
+}
+unsigned Table::Index::LowerBound(double value) const
+{
+	unsigned lower=0, upper=entryCount;
+	while (lower < upper)
+	{
+		unsigned middle=lower+(upper-lower)/2;
+		if (entries[middle].value<value)
+			lower=middle+1;
+		else
+			upper=middle;
+	}
+	return lower;
+}
+unsigned Table::Index::UpperBound(double value) const
+{
+	unsigned lower=0, upper=entryCount;
+	while (lower < upper)
+	{
+		unsigned middle=lower+(upper-lower)/2;
+		if (entries[middle].value<=value)
+			lower=middle+1;
+		else
+			upper=middle;
+	}
+	return lower;
+}
+unsigned Table::Index::GetBucket(unsigned hash) const
+{
+	return hash & (bucketCount-1);
+}
+void Table::Index::RemoveFromBucket(unsigned slot)
+{
+	unsigned *link=&buckets[GetBucket(hashes[slot])];
+	while (*link!=slot)
+	{
+		RakAssert(*link!=NO_INDEX_SLOT);
+		link=&next[*link];
+	}
+	*link=next[slot];
+	hashedCount--;
+}
+void Table::Index::Rehash(unsigned newBucketCount)
+{
+	if (buckets)
+		rakFree_Ex(buckets, _FILE_AND_LINE_);
+	bucketCount=newBucketCount;
+	buckets=(unsigned*) rakMalloc_Ex(bucketCount*sizeof(unsigned), _FILE_AND_LINE_);
+	RakAssert(buckets);
+	unsigned i;
+	for (i=0; i < bucketCount; i++)
+		buckets[i]=NO_INDEX_SLOT;
+	for (i=0; i < states.Size(); i++)
+	{
+		if (states[i]==INDEX_SLOT_INDEXED)
+		{
+			unsigned bucket=GetBucket(hashes[i]);
+			next[i]=buckets[bucket];
+			buckets[bucket]=i;
+		}
+	}
+}
 Table::Cell::Cell()
 {
 	isEmpty=true;
@@ -262,6 +558,10 @@ Table::ColumnDescriptor::ColumnDescriptor(const char cn[_TABLE_MAX_COLUMN_NAME_L
 	columnType=ct;
 	strcpy_s(columnName, cn);
 }
+Table::Row::Row()
+{
+	indexSlot=NO_INDEX_SLOT;
+}
 void Table::Row::UpdateCell(unsigned columnIndex, double value)
 {
 	cells[columnIndex]->Clear();
@@ -306,6 +606,14 @@ void Table::RemoveColumn(unsigned columnIndex)
 	if (columnIndex >= columns.Size())
 		return;
 
+	RemoveIndex(columnIndex);
+	unsigned indexIndex;
+	for (indexIndex=0; indexIndex < indices.Size(); indexIndex++)
+	{
+		if (indices[indexIndex]->columnIndex > columnIndex)
+			indices[indexIndex]->columnIndex--;
+	}
+
 	columns.RemoveAtIndex(columnIndex);
 
 	// Remove this index from each row.
@@ -368,6 +676,8 @@ Table::Row* Table::AddRow(unsigned rowId)
 	unsigned rowIndex;
 	for (rowIndex=0; rowIndex < columns.Size(); rowIndex++)
 		newRow->cells.Insert(SLNet::OP_NEW<Table::Cell>(_FILE_AND_LINE_), _FILE_AND_LINE_ );
+	if (indices.Size()>0)
+		AddRowToIndices(rowId, newRow);
 	return newRow;
 }
 Table::Row* Table::AddRow(unsigned rowId, DataStructures::List<Cell> &initialCellValues)
@@ -386,7 +696,8 @@ Table::Row* Table::AddRow(unsigned rowId, DataStructures::List<Cell> &initialCel
 		else
 			newRow->cells.Insert(SLNet::OP_NEW<Table::Cell>(_FILE_AND_LINE_), _FILE_AND_LINE_ );
 	}
-	rows.Insert(rowId, newRow);
+	if (rows.Insert(rowId, newRow) && indices.Size()>0)
+		AddRowToIndices(rowId, newRow);
 	return newRow;
 }
 Table::Row* Table::AddRow(unsigned rowId, DataStructures::List<Cell*> &initialCellValues, bool copyCells)
@@ -409,10 +720,11 @@ Table::Row* Table::AddRow(unsigned rowId, DataStructures::List<Cell*> &initialCe
 		else
 			newRow->cells.Insert(SLNet::OP_NEW<Table::Cell>(_FILE_AND_LINE_), _FILE_AND_LINE_);
 	}
-	rows.Insert(rowId, newRow);
+	if (rows.Insert(rowId, newRow) && indices.Size()>0)
+		AddRowToIndices(rowId, newRow);
 	return newRow;
 }
-Table::Row* Table::AddRowColumns(unsigned rowId, Row *row, DataStructures::List<unsigned> columnIndices)
+Table::Row* Table::AddRowColumns(unsigned rowId, Row *row, DataStructures::List<unsigned> &columnIndices)
 {
 	Row *newRow = SLNet::OP_NEW<Row>( _FILE_AND_LINE_ );
 	unsigned columnIndex;
@@ -432,7 +744,8 @@ Table::Row* Table::AddRowColumns(unsigned rowId, Row *row, DataStructures::List<
 			newRow->cells.Insert(SLNet::OP_NEW<Table::Cell>(_FILE_AND_LINE_), _FILE_AND_LINE_);
 		}
 	}
-	rows.Insert(rowId, newRow);
+	if (rows.Insert(rowId, newRow) && indices.Size()>0)
+		AddRowToIndices(rowId, newRow);
 	return newRow;
 }
 bool Table::RemoveRow(unsigned rowId)
@@ -440,6 +753,7 @@ bool Table::RemoveRow(unsigned rowId)
 	Row *out;
 	if (rows.Delete(rowId, out))
 	{
+		RemoveRowFromIndices(out);
 		DeleteRow(out);
 		return true;
 	}
@@ -453,7 +767,9 @@ void Table::RemoveRows(Table *tableContainingRowIDs)
 	{
 		for (i=0; i < (unsigned)cur->size; i++)
 		{
-			rows.Delete(cur->keys[i]);
+			Row *out;
+			if (rows.Delete(cur->keys[i], out))
+				RemoveRowFromIndices(out);
 		}
 		cur=cur->next;
 	}
@@ -467,6 +783,7 @@ bool Table::UpdateCell(unsigned rowId, unsigned columnIndex, int value)
 	if (row)
 	{
 		row->UpdateCell(columnIndex, value);
+		UpdateRowInIndices(row, columnIndex);
 		return true;
 	}
 	return false;
@@ -479,6 +796,7 @@ bool Table::UpdateCell(unsigned rowId, unsigned columnIndex, char *str)
 	if (row)
 	{
 		row->UpdateCell(columnIndex, str);
+		UpdateRowInIndices(row, columnIndex);
 		return true;
 	}
 	return false;
@@ -491,6 +809,7 @@ bool Table::UpdateCell(unsigned rowId, unsigned columnIndex, int byteLength, cha
 	if (row)
 	{
 		row->UpdateCell(columnIndex, byteLength, data);
+		UpdateRowInIndices(row, columnIndex);
 		return true;
 	}
 	return false;
@@ -503,6 +822,7 @@ bool Table::UpdateCellByIndex(unsigned rowIndex, unsigned columnIndex, int value
 	if (row)
 	{
 		row->UpdateCell(columnIndex, value);
+		UpdateRowInIndices(row, columnIndex);
 		return true;
 	}
 	return false;
@@ -515,6 +835,7 @@ bool Table::UpdateCellByIndex(unsigned rowIndex, unsigned columnIndex, char *str
 	if (row)
 	{
 		row->UpdateCell(columnIndex, str);
+		UpdateRowInIndices(row, columnIndex);
 		return true;
 	}
 	return false;
@@ -527,6 +848,7 @@ bool Table::UpdateCellByIndex(unsigned rowIndex, unsigned columnIndex, int byteL
 	if (row)
 	{
 		row->UpdateCell(columnIndex, byteLength, data);
+		UpdateRowInIndices(row, columnIndex);
 		return true;
 	}
 	return false;
@@ -585,6 +907,136 @@ Table::FilterQuery::FilterQuery(unsigned column, Cell *cell, FilterQueryType op)
 	cellValue=cell;
 	operation=op;
 }
+bool Table::AddIndex(unsigned columnIndex)
+{
+	if (columnIndex >= columns.Size() || GetIndex(columnIndex)!=0)
+		return false;
+	if (columns[columnIndex].columnType!=NUMERIC && columns[columnIndex].columnType!=STRING)
+		return false;
+
+	if (indices.Size()==0)
+	{
+		// Give every row a slot
+		int i;
+		DataStructures::Page<unsigned, Row*, _TABLE_BPLUS_TREE_ORDER> *cur = rows.GetListHead();
+		while (cur)
+		{
+			for (i=0; i < cur->size; i++)
+				AddRowToIndices(cur->keys[i], cur->data[i]);
+			cur=cur->next;
+		}
+	}
+
+	Index *index = SLNet::OP_NEW_2<Index>(_FILE_AND_LINE_, columnIndex, columns[columnIndex].columnType);
+	index->AddSlots(slotRows.Size());
+	unsigned slot;
+	for (slot=0; slot < slotRows.Size(); slot++)
+	{
+		if (slotRows[slot])
+			index->SetSlot(slot, slotRows[slot]->cells[columnIndex]);
+	}
+	if (index->columnType==NUMERIC)
+		index->Sort();
+	indices.Insert(index, _FILE_AND_LINE_);
+	return true;
+}
+void Table::RemoveIndex(unsigned columnIndex)
+{
+	unsigned i;
+	for (i=0; i < indices.Size(); i++)
+	{
+		if (indices[i]->columnIndex==columnIndex)
+		{
+			SLNet::OP_DELETE(indices[i], _FILE_AND_LINE_);
+			indices.RemoveAtIndex(i);
+			break;
+		}
+	}
+
+	// Without indices, rows do not need slots
+	if (indices.Size()==0)
+		ClearIndices();
+}
+bool Table::HasIndex(unsigned columnIndex) const
+{
+	return GetIndex(columnIndex)!=0;
+}
+bool Table::UpdateIndices(unsigned rowId)
+{
+	Row *row = GetRowByID(rowId);
+	if (row==0)
+		return false;
+	unsigned i;
+	for (i=0; i < indices.Size(); i++)
+		indices[i]->SetSlot(row->indexSlot, row->cells[indices[i]->columnIndex]);
+	return true;
+}
+Table::Index* Table::GetIndex(unsigned columnIndex) const
+{
+	unsigned i;
+	for (i=0; i < indices.Size(); i++)
+	{
+		if (indices[i]->columnIndex==columnIndex)
+			return indices[i];
+	}
+	return 0;
+}
+void Table::AddRowToIndices(unsigned rowId, Row *row)
+{
+	unsigned slot, i;
+	if (freeSlots.Size()>0)
+	{
+		slot=freeSlots.Pop();
+		slotRows[slot]=row;
+		slotRowIds[slot]=rowId;
+	}
+	else
+	{
+		slot=slotRows.Size();
+		slotRows.Insert(row, _FILE_AND_LINE_);
+		slotRowIds.Insert(rowId, _FILE_AND_LINE_);
+		for (i=0; i < indices.Size(); i++)
+			indices[i]->AddSlots(slotRows.Size());
+	}
+	row->indexSlot=slot;
+
+	for (i=0; i < indices.Size(); i++)
+		indices[i]->SetSlot(slot, row->cells[indices[i]->columnIndex]);
+}
+void Table::RemoveRowFromIndices(Row *row)
+{
+	if (row->indexSlot==NO_INDEX_SLOT)
+		return;
+	unsigned i;
+	for (i=0; i < indices.Size(); i++)
+		indices[i]->ClearSlot(row->indexSlot);
+	slotRows[row->indexSlot]=0;
+	freeSlots.Push(row->indexSlot, _FILE_AND_LINE_);
+	row->indexSlot=NO_INDEX_SLOT;
+}
+void Table::UpdateRowInIndices(Row *row, unsigned columnIndex)
+{
+	if (row->indexSlot==NO_INDEX_SLOT)
+		return;
+	Index *index = GetIndex(columnIndex);
+	if (index)
+		index->SetSlot(row->indexSlot, row->cells[columnIndex]);
+}
+void Table::ClearIndices(void)
+{
+	unsigned i;
+	for (i=0; i < indices.Size(); i++)
+		SLNet::OP_DELETE(indices[i], _FILE_AND_LINE_);
+	indices.Clear(false, _FILE_AND_LINE_);
+	for (i=0; i < slotRows.Size(); i++)
+	{
+		if (slotRows[i])
+			slotRows[i]->indexSlot=NO_INDEX_SLOT;
+	}
+	slotRows.Clear(false, _FILE_AND_LINE_);
+	slotRowIds.Clear(false, _FILE_AND_LINE_);
+	freeSlots.Clear(false, _FILE_AND_LINE_);
+}
 Table::Row* Table::GetRowByID(unsigned rowId) const
 {
 	Row *row;
@@ -660,6 +1112,9 @@ void Table::QueryTable(unsigned *columnIndicesSubset, unsigned numColumnSubset,
 
 	if (rowIds==0 || numRowIDs==0)
 	{
+		if (QueryIndices(inclusionFilterColumnIndices, columnIndicesToReturn, inclusionFilters, result))
+			return;
+
 		// All rows
 		DataStructures::Page<unsigned, Row*, _TABLE_BPLUS_TREE_ORDER> *cur = rows.GetListHead();
 		while (cur)
@@ -842,6 +1297,231 @@ void Table::QueryRow(DataStructures::List<unsigned> &inclusionFilterColumnIndice
 	}
 }
 
+bool Table::QueryIndices(DataStructures::List<unsigned> &inclusionFilterColumnIndices, DataStructures::List<unsigned> &columnIndicesToReturn, FilterQuery *inclusionFilters, Table *result)
+{
+	// What the filters on each index allow. NUMERIC filters narrow an inclusive range, STRING filters give one string.
+	struct IndexConstraint
+	{
+		Index *index;
+		double lower, upper;
+		const char *str;
+		unsigned matchCount;
+	};
+	DataStructures::List<IndexConstraint> constraints;
+	unsigned i, j;
+	for (i=0; i < indices.Size(); i++)
+	{
+		IndexConstraint constraint;
+		constraint.index=indices[i];
+		constraint.lower=-HUGE_VAL;
+		constraint.upper=HUGE_VAL;
+		constraint.str=0;
+		bool constrained=false, noMatch=false;
+		for (j=0; j < inclusionFilterColumnIndices.Size(); j++)
+		{
+			if (inclusionFilterColumnIndices[j]!=constraint.index->columnIndex)
+				continue;
+			const Cell *cellValue=inclusionFilters[j].cellValue;
+			if (constraint.index->columnType==STRING)
+			{
+				// QueryRow() does not test strings against a filter without one
+				if (inclusionFilters[j].operation==QF_EQUAL && cellValue->c && constraint.str==0)
+				{
+					constraint.str=cellValue->c;
+					constrained=true;
+				}
+				continue;
+			}
+
+			FilterQueryType operation=inclusionFilters[j].operation;
+			if (operation!=QF_EQUAL && operation!=QF_GREATER_THAN && operation!=QF_GREATER_THAN_EQ && operation!=QF_LESS_THAN && operation!=QF_LESS_THAN_EQ)
+				continue;
+			double value=cellValue->i;
+			switch (operation)
+			{
+			case QF_EQUAL:
+				constraint.lower=value > constraint.lower ? value : constraint.lower;
+				constraint.upper=value < constraint.upper ? value : constraint.upper;
+				break;
+			case QF_GREATER_THAN:
+				if (value==HUGE_VAL)
+					noMatch=true;
+				else
+				{
+					value=nextafter(value, HUGE_VAL);
+					constraint.lower=value > constraint.lower ? value : constraint.lower;
+				}
+				break;
+			case QF_GREATER_THAN_EQ:
+				constraint.lower=value > constraint.lower ? value : constraint.lower;
+				break;
+			case QF_LESS_THAN:
+				if (value==-HUGE_VAL)
+					noMatch=true;
+				else
+				{
+					value=nextafter(value, -HUGE_VAL);
+					constraint.upper=value < constraint.upper ? value : constraint.upper;
+				}
+				break;
+			case QF_LESS_THAN_EQ:
+				constraint.upper=value < constraint.upper ? value : constraint.upper;
+				break;
+			default:
+				break;
+			}
+			// Nothing compares true with NaN
+			if (value!=value)
+				noMatch=true;
+			constrained=true;
+		}
+		if (constrained==false)
+			continue;
+
+		if (constraint.index->columnType==NUMERIC)
+		{
+			if (noMatch || constraint.lower > constraint.upper)
+				constraint.matchCount=0;
+			else
+			{
+				constraint.index->Sort();
+				constraint.matchCount=constraint.index->UpperBound(constraint.upper)-constraint.index->LowerBound(constraint.lower);
+			}
+		}
+		else
+		{
+			unsigned hash=SuperFastHash(constraint.str, (int) strlen(constraint.str));
+			constraint.matchCount=constraint.index->nullStringCount;
+			unsigned slot;
+			for (slot=constraint.index->buckets[constraint.index->GetBucket(hash)]; slot!=NO_INDEX_SLOT; slot=constraint.index->next[slot])
+			{
+				if (constraint.index->hashes[slot]==hash)
+					constraint.matchCount++;
+			}
+		}
+		constraints.Insert(constraint, _FILE_AND_LINE_);
+	}
+
+	if (constraints.Size()==0)
+		return false;
+
+	// Plan with the index that matches the fewest rows
+	unsigned best=0;
+	for (i=1; i < constraints.Size(); i++)
+	{
+		if (constraints[i].matchCount < constraints[best].matchCount)
+			best=i;
+	}
+
+	unsigned slotCount=slotRows.Size();
+	unsigned numericConstraintCount=0;
+	for (i=0; i < constraints.Size(); i++)
+	{
+		if (constraints[i].index->columnType==NUMERIC)
+			numericConstraintCount++;
+	}
+
+	if (constraints[best].matchCount*10 > slotCount)
+	{
+		// Too many matches for the index to be worth it. Test the NUMERIC filters on the values held by the indices,
+		// a column at a time over contiguous arrays, and only read the rows that pass.
+		if (numericConstraintCount==0)
+			return false;
+
+		unsigned char *passed=(unsigned char*) rakMalloc_Ex(slotCount, _FILE_AND_LINE_);
+		RakAssert(passed);
+		memset(passed, 1, slotCount);
+		for (i=0; i < constraints.Size(); i++)
+		{
+			const IndexConstraint &constraint=constraints[i];
+			if (constraint.index->columnType!=NUMERIC)
+				continue;
+			const double lower=constraint.lower, upper=constraint.upper;
+			const double *values=&constraint.index->values[0];
+			const unsigned char *states=&constraint.index->states[0];
+			unsigned slot;
+			for (slot=0; slot < slotCount; slot++)
+				passed[slot]&=(unsigned char) ((states[slot]!=INDEX_SLOT_ABSENT) & (values[slot]>=lower) & (values[slot]<=upper));
+		}
+
+		// In row ID order, as the result keeps its rows sorted by row ID
+		DataStructures::Page<unsigned, Row*, _TABLE_BPLUS_TREE_ORDER> *cur = rows.GetListHead();
+		while (cur)
+		{
+			for (i=0; i < (unsigned)cur->size; i++)
+			{
+				if (passed[cur->data[i]->indexSlot])
+					QueryRow(inclusionFilterColumnIndices, columnIndicesToReturn, cur->keys[i], cur->data[i], inclusionFilters, result);
+			}
+			cur=cur->next;
+		}
+		rakFree_Ex(passed, _FILE_AND_LINE_);
+		return true;
+	}
+
+	// Gather the rows the best index matches
+	const IndexConstraint &bestConstraint=constraints[best];
+	DataStructures::List<unsigned> matches;
+	if (bestConstraint.matchCount>0)
+	{
+		Index *index=bestConstraint.index;
+		if (index->columnType==NUMERIC)
+		{
+			unsigned entryIndex, end=index->UpperBound(bestConstraint.upper);
+			for (entryIndex=index->LowerBound(bestConstraint.lower); entryIndex < end; entryIndex++)
+				matches.Insert(index->entries[entryIndex].slot, _FILE_AND_LINE_);
+		}
+		else
+		{
+			unsigned hash=SuperFastHash(bestConstraint.str, (int) strlen(bestConstraint.str));
+			unsigned slot;
+			for (slot=index->buckets[index->GetBucket(hash)]; slot!=NO_INDEX_SLOT; slot=index->next[slot])
+			{
+				if (index->hashes[slot]==hash)
+					matches.Insert(slot, _FILE_AND_LINE_);
+			}
+			if (index->nullStringCount>0)
+			{
+				for (slot=0; slot < slotCount; slot++)
+				{
+					if (index->states[slot]==INDEX_SLOT_NULL_STRING)
+						matches.Insert(slot, _FILE_AND_LINE_);
+				}
+			}
+		}
+	}
+
+	// Test them against the other NUMERIC indices before reading the rows
+	DataStructures::List<IndexCandidate> candidates;
+	for (i=0; i < matches.Size(); i++)
+	{
+		unsigned slot=matches[i];
+		bool passed=true;
+		for (j=0; j < constraints.Size() && passed; j++)
+		{
+			const IndexConstraint &constraint=constraints[j];
+			if (j==best || constraint.index->columnType!=NUMERIC)
+				continue;
+			passed=constraint.index->states[slot]!=INDEX_SLOT_ABSENT &&
+				constraint.index->values[slot]>=constraint.lower && constraint.index->values[slot]<=constraint.upper;
+		}
+		if (passed)
+		{
+			IndexCandidate candidate;
+			candidate.rowId=slotRowIds[slot];
+			candidate.slot=slot;
+			candidates.Insert(candidate, _FILE_AND_LINE_);
+		}
+	}
+
+	// In row ID order, as the result keeps its rows sorted by row ID
+	if (candidates.Size()>0)
+		qsort(&candidates[0], candidates.Size(), sizeof(IndexCandidate), IndexCandidateComp);
+	for (i=0; i < candidates.Size(); i++)
+		QueryRow(inclusionFilterColumnIndices, columnIndicesToReturn, candidates[i].rowId, slotRows[candidates[i].slot], inclusionFilters, result);
+	return true;
+}
+
 static Table::SortQuery *_sortQueries;
 static unsigned _numSortQueries;
 static DataStructures::List<unsigned> *_columnIndices;
@@ -1072,6 +1752,7 @@ void Table::PrintRow(char *out, int outLength, char columnDelineator, bool print
 
 void Table::Clear(void)
 {
+	ClearIndices();
 	rows.ForEachData(FreeRow);
 	rows.Clear();
 	columns.Clear(true, _FILE_AND_LINE_);
@@ -1144,5 +1825,8 @@ Table& Table::operator = ( const Table& input )
 		cur=cur->next;
 	}
 
+	for (i=0; i < input.indices.Size(); i++)
+		AddIndex(input.indices[i]->columnIndex);
+
 	return *this;
 }
@@ -0,0 +1,171 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+/// \file DS_TimerWheel.cpp
+///
+
+
+#include "slikenet/DS_TimerWheel.h"
+#include "slikenet/assert.h"
+
+using namespace DataStructures;
+
+TimerWheel::Timer::Timer()
+{
+	userData=0;
+	next=0;
+	prev=0;
+	expiryTick=0;
+	timerWheel=0;
+}
+TimerWheel::Timer::~Timer()
+{
+	// The sentinels of the wheel have no timerWheel
+	if (IsScheduled() && timerWheel)
+		timerWheel->Cancel(this);
+}
+TimerWheel::TimerWheel(SLNet::TimeMS _tickMS)
+{
+	RakAssert(_tickMS>0);
+	tickMS=_tickMS;
+	currentTick=0;
+	timerCount=0;
+	for (int level=0; level < LEVELS; level++)
+	{
+		for (int slot=0; slot < SLOTS_PER_LEVEL; slot++)
+		{
+			slots[level][slot].next=&slots[level][slot];
+			slots[level][slot].prev=&slots[level][slot];
+		}
+	}
+	expired.next=&expired;
+	expired.prev=&expired;
+}
+TimerWheel::~TimerWheel()
+{
+	// Unschedule the timers that are left, so they do not cancel themselves from a wheel that no longer exists
+	for (int level=0; level < LEVELS; level++)
+	{
+		for (int slot=0; slot < SLOTS_PER_LEVEL; slot++)
+		{
+			while (slots[level][slot].next!=&slots[level][slot])
+				Unlink(slots[level][slot].next);
+		}
+	}
+	while (expired.next!=&expired)
+		Unlink(expired.next);
+}
+void TimerWheel::Schedule(Timer *timer, SLNet::Time expiryTime)
+{
+	if (timer->IsScheduled())
+		Cancel(timer);
+
+	timer->expiryTick=((uint64_t) expiryTime+tickMS-1) / tickMS;
+	timer->timerWheel=this;
+	Insert(timer);
+	timerCount++;
+}
+void TimerWheel::Cancel(Timer *timer)
+{
+	if (timer->IsScheduled()==false)
+		return;
+	RakAssert(timer->timerWheel==this);
+	Unlink(timer);
+	timerCount--;
+}
+void TimerWheel::Advance(SLNet::Time time)
+{
+	uint64_t targetTick=(uint64_t) time / tickMS;
+	if (timerCount==0)
+	{
+		// Nothing to cascade or expire on the way, so skip the idle ticks
+		if (targetTick > currentTick)
+			currentTick=targetTick;
+		return;
+	}
+
+	while (currentTick < targetTick)
+	{
+		currentTick++;
+
+		// Higher levels first, so timers cascade all the way down in one tick
+		for (int level=LEVELS-1; level > 0; level--)
+		{
+			if ((currentTick & (((uint64_t) 1 << (SLOT_BITS*level))-1))==0)
+				Cascade(level);
+		}
+
+		Timer *head=&slots[0][currentTick & (SLOTS_PER_LEVEL-1)];
+		while (head->next!=head)
+		{
+			Timer *timer=head->next;
+			Unlink(timer);
+			Link(&expired, timer);
+		}
+	}
+}
+TimerWheel::Timer *TimerWheel::PopExpired(void)
+{
+	if (expired.next==&expired)
+		return 0;
+	Timer *timer=expired.next;
+	Unlink(timer);
+	timerCount--;
+	return timer;
+}
+void TimerWheel::Insert(Timer *timer)
+{
+	if (timer->expiryTick <= currentTick)
+	{
+		Link(&expired, timer);
+		return;
+	}
+
+	uint64_t delta=timer->expiryTick-currentTick;
+	uint64_t tick=timer->expiryTick;
+	int level=0;
+	while (level < LEVELS-1 && delta >= ((uint64_t) 1 << (SLOT_BITS*(level+1))))
+		level++;
+	// Too far ahead for the top level. Park it in the furthest slot, and it is inserted again when it cascades.
+	if (delta >= ((uint64_t) 1 << (SLOT_BITS*LEVELS)))
+		tick=currentTick+((uint64_t) 1 << (SLOT_BITS*LEVELS))-1;
+	Link(&slots[level][(tick >> (SLOT_BITS*level)) & (SLOTS_PER_LEVEL-1)], timer);
+}
+void TimerWheel::Cascade(int level)
+{
+	Timer *head=&slots[level][(currentTick >> (SLOT_BITS*level)) & (SLOTS_PER_LEVEL-1)];
+
+	// Detach the slot first, as timers may go back into the same slot
+	Timer *first=head->next, *last=head->prev;
+	if (first==head)
+		return;
+	head->next=head;
+	head->prev=head;
+	last->next=0;
+
+	Timer *timer=first;
+	while (timer)
+	{
+		Timer *next=timer->next;
+		Insert(timer);
+		timer=next;
+	}
+}
+void TimerWheel::Link(Timer *head, Timer *timer)
+{
+	timer->prev=head->prev;
+	timer->next=head;
+	head->prev->next=timer;
+	head->prev=timer;
+}
+void TimerWheel::Unlink(Timer *timer)
+{
+	timer->prev->next=timer->next;
+	timer->next->prev=timer->prev;
+	timer->next=0;
+	timer->prev=0;
+}
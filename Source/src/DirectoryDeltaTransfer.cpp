@@ -82,6 +82,7 @@ STATIC_FACTORY_DEFINITIONS(DirectoryDeltaTransfer,DirectoryDeltaTransfer);
 DirectoryDeltaTransfer::DirectoryDeltaTransfer()
 {
 	applicationDirectory[0]=0;
+	hashCacheFile[0]=0;
 	fileListTransfer=0;
 	availableUploads = SLNet::OP_NEW<FileList>( _FILE_AND_LINE_ );
 	priority=HIGH_PRIORITY;
@@ -139,6 +140,14 @@ void DirectoryDeltaTransfer::AddUploadsFromSubdirectory(const char *subdir)
 {
 	availableUploads->AddFilesFromDirectory(applicationDirectory, subdir, true, false, true, FileListNodeContext(0,0,0,0));
 }
+void DirectoryDeltaTransfer::SetHashCache(const char *cacheFile)
+{
+	if (cacheFile==0)
+		hashCacheFile[0]=0;
+	else
+		strncpy_s(hashCacheFile, cacheFile, 511);
+	availableUploads->SetHashCache(hashCacheFile);
+}
 unsigned short DirectoryDeltaTransfer::DownloadFromSubdirectory(FileList &localFiles, const char *subdir, const char *outputSubdir, bool prependAppDirToOutputSubdir, SystemAddress host, FileListTransferCBInterface *onFileCallback, PacketPriority _priority, char _orderingChannel, FileListProgress *cb)
 {
 	RakAssert(host!=UNASSIGNED_SYSTEM_ADDRESS);
@@ -184,12 +193,15 @@ unsigned short DirectoryDeltaTransfer::DownloadFromSubdirectory(FileList &localF
 unsigned short DirectoryDeltaTransfer::DownloadFromSubdirectory(const char *subdir, const char *outputSubdir, bool prependAppDirToOutputSubdir, SystemAddress host, FileListTransferCBInterface *onFileCallback, PacketPriority _priority, char _orderingChannel, FileListProgress *cb)
 {
 	FileList localFiles;
+	localFiles.SetHashCache(hashCacheFile);
 	// Get a hash of all the files that we already have (if any)
 	localFiles.AddFilesFromDirectory(prependAppDirToOutputSubdir ? applicationDirectory : 0, outputSubdir, true, false, true, FileListNodeContext(0,0,0,0));
 	return DownloadFromSubdirectory(localFiles, subdir, outputSubdir, prependAppDirToOutputSubdir, host, onFileCallback, _priority, _orderingChannel, cb);
 }
 void DirectoryDeltaTransfer::GenerateHashes(FileList &localFiles, const char *outputSubdir, bool prependAppDirToOutputSubdir)
 {
+	if (hashCacheFile[0])
+		localFiles.SetHashCache(hashCacheFile);
 	localFiles.AddFilesFromDirectory(prependAppDirToOutputSubdir ? applicationDirectory : 0, outputSubdir, true, false, true, FileListNodeContext(0,0,0,0));
 }
 void DirectoryDeltaTransfer::ClearUploads(void)
@@ -237,6 +249,12 @@ PluginReceiveResult DirectoryDeltaTransfer::OnReceive(Packet *packet)
 	return RR_CONTINUE_PROCESSING;
 }
 
+bool DirectoryDeltaTransfer::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_DDT_DOWNLOAD_REQUEST]=true;
+	return true;
+}
+
 unsigned DirectoryDeltaTransfer::GetNumberOfFilesForUpload(void) const
 {
 	return availableUploads->fileList.Size();
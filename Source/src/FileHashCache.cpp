@@ -0,0 +1,311 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "slikenet/FileHashCache.h"
+
+#if _RAKNET_SUPPORT_FileOperations==1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "slikenet/assert.h"
+#include "slikenet/linux_adapter.h"
+#include "slikenet/osx_adapter.h"
+#if defined(_WIN32)
+#include "slikenet/WindowsIncludes.h"
+#endif
+
+using namespace SLNet;
+
+static const char FILE_HASH_CACHE_MAGIC[8]={'S','L','N','H','A','S','H','1'};
+// Written in native byte order, so a cache from a system of the other byte order does not load
+static const uint32_t FILE_HASH_CACHE_BYTE_ORDER=0x01020304;
+
+struct FileHashCacheHeader
+{
+	char magic[8];
+	uint32_t byteOrder;
+	uint32_t entryCount;
+	uint64_t pathBytes;
+};
+
+FileHashCache::FileHashCache()
+{
+	loadedData=0;
+	loadedEntries=0;
+	loadedPaths=0;
+	loadedEntryCount=0;
+	loadedEntryStates=0;
+	droppedLoadedEntries=false;
+}
+FileHashCache::~FileHashCache()
+{
+	Clear();
+}
+bool FileHashCache::Load(const char *path)
+{
+	Clear();
+
+	FILE *fp;
+	if (fopen_s(&fp, path, "rb")!=0)
+		return false;
+	fseek(fp, 0, SEEK_END);
+	long fileLength=ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if (fileLength < (long) sizeof(FileHashCacheHeader))
+	{
+		fclose(fp);
+		return false;
+	}
+
+	loadedData=(char*) rakMalloc_Ex(fileLength, _FILE_AND_LINE_);
+	RakAssert(loadedData);
+	size_t bytesRead=fread(loadedData, 1, fileLength, fp);
+	fclose(fp);
+
+	FileHashCacheHeader header;
+	memcpy(&header, loadedData, sizeof(header));
+	if (bytesRead!=(size_t) fileLength ||
+		memcmp(header.magic, FILE_HASH_CACHE_MAGIC, sizeof(header.magic))!=0 ||
+		header.byteOrder!=FILE_HASH_CACHE_BYTE_ORDER ||
+		sizeof(header)+(uint64_t) header.entryCount*sizeof(LoadedEntry)+header.pathBytes!=(uint64_t) fileLength)
+	{
+		Clear();
+		return false;
+	}
+
+	loadedEntries=(const LoadedEntry*) (loadedData+sizeof(header));
+	loadedPaths=loadedData+sizeof(header)+header.entryCount*sizeof(LoadedEntry);
+	for (unsigned int i=0; i < header.entryCount; i++)
+	{
+		// Every path must be within the file and terminated
+		if ((uint64_t) loadedEntries[i].pathOffset+loadedEntries[i].pathLength >= header.pathBytes ||
+			loadedPaths[loadedEntries[i].pathOffset+loadedEntries[i].pathLength]!=0)
+		{
+			Clear();
+			return false;
+		}
+	}
+
+	loadedEntryCount=header.entryCount;
+	loadedEntryStates=(unsigned char*) rakMalloc_Ex(loadedEntryCount+1, _FILE_AND_LINE_);
+	RakAssert(loadedEntryStates);
+	memset(loadedEntryStates, LOADED_ENTRY_UNCHANGED, loadedEntryCount+1);
+	return true;
+}
+bool FileHashCache::Save(const char *path)
+{
+	// Sort what was added by path, and keep the last entry of each path
+	AddedEntry **sortedAddedEntries=0;
+	unsigned int addedEntryCount=addedEntries.Size();
+	if (addedEntryCount>0)
+	{
+		sortedAddedEntries=(AddedEntry**) rakMalloc_Ex(addedEntryCount*sizeof(AddedEntry*), _FILE_AND_LINE_);
+		RakAssert(sortedAddedEntries);
+		for (unsigned int i=0; i < addedEntryCount; i++)
+			sortedAddedEntries[i]=addedEntries[i];
+		qsort(sortedAddedEntries, addedEntryCount, sizeof(AddedEntry*), AddedEntryComp);
+	}
+
+	// Merge with the loaded entries that were not dropped
+	LoadedEntry *entries=(LoadedEntry*) rakMalloc_Ex((loadedEntryCount+addedEntryCount+1)*sizeof(LoadedEntry), _FILE_AND_LINE_);
+	const char **paths=(const char**) rakMalloc_Ex((loadedEntryCount+addedEntryCount+1)*sizeof(const char*), _FILE_AND_LINE_);
+	RakAssert(entries && paths);
+	unsigned int entryCount=0, loadedIndex=0, addedIndex=0;
+	uint64_t pathBytes=0;
+	while (loadedIndex < loadedEntryCount || addedIndex < addedEntryCount)
+	{
+		if (loadedIndex < loadedEntryCount && loadedEntryStates[loadedIndex]==LOADED_ENTRY_DROPPED)
+		{
+			loadedIndex++;
+			continue;
+		}
+		if (addedIndex+1 < addedEntryCount && sortedAddedEntries[addedIndex]->filePath==sortedAddedEntries[addedIndex+1]->filePath)
+		{
+			addedIndex++;
+			continue;
+		}
+
+		int comp;
+		if (loadedIndex==loadedEntryCount)
+			comp=1;
+		else if (addedIndex==addedEntryCount)
+			comp=-1;
+		else
+			comp=strcmp(GetLoadedPath(loadedIndex), sortedAddedEntries[addedIndex]->filePath.C_String());
+
+		LoadedEntry &entry=entries[entryCount];
+		if (comp<0)
+		{
+			entry=loadedEntries[loadedIndex];
+			paths[entryCount]=GetLoadedPath(loadedIndex);
+			loadedIndex++;
+		}
+		else
+		{
+			// An added entry replaces a loaded entry of the same path
+			if (comp==0)
+				loadedIndex++;
+			const AddedEntry *addedEntry=sortedAddedEntries[addedIndex];
+			entry.fileSize=addedEntry->fileSize;
+			entry.modificationTime=addedEntry->modificationTime;
+			entry.pathLength=(uint32_t) addedEntry->filePath.GetLength();
+			entry.hash=addedEntry->hash;
+			entry.unused=0;
+			paths[entryCount]=addedEntry->filePath.C_String();
+			addedIndex++;
+		}
+		entry.pathOffset=(uint32_t) pathBytes;
+		pathBytes+=entry.pathLength+1;
+		entryCount++;
+	}
+
+	// Write to a temporary file first, so a failed write does not lose the old index
+	SLNet::RakString temporaryPath("%s.tmp", path);
+	FILE *fp;
+	bool succeeded=fopen_s(&fp, temporaryPath.C_String(), "wb")==0;
+	if (succeeded)
+	{
+		FileHashCacheHeader header;
+		memcpy(header.magic, FILE_HASH_CACHE_MAGIC, sizeof(header.magic));
+		header.byteOrder=FILE_HASH_CACHE_BYTE_ORDER;
+		header.entryCount=entryCount;
+		header.pathBytes=pathBytes;
+		succeeded=fwrite(&header, sizeof(header), 1, fp)==1;
+		if (succeeded && entryCount>0)
+			succeeded=fwrite(entries, sizeof(LoadedEntry), entryCount, fp)==entryCount;
+		for (unsigned int i=0; i < entryCount && succeeded; i++)
+			succeeded=fwrite(paths[i], 1, entries[i].pathLength+1, fp)==entries[i].pathLength+1;
+		if (fclose(fp)!=0)
+			succeeded=false;
+	}
+
+	rakFree_Ex(entries, _FILE_AND_LINE_);
+	rakFree_Ex(paths, _FILE_AND_LINE_);
+	if (sortedAddedEntries)
+		rakFree_Ex(sortedAddedEntries, _FILE_AND_LINE_);
+
+	// Replace the old index in one step, so it is either still there or the new one is
+	if (succeeded)
+	{
+#if defined(_WIN32)
+		succeeded=MoveFileExA(temporaryPath.C_String(), path, MOVEFILE_REPLACE_EXISTING)!=0;
+#else
+		succeeded=rename(temporaryPath.C_String(), path)==0;
+#endif
+	}
+	if (succeeded==false)
+	{
+		remove(temporaryPath.C_String());
+		return false;
+	}
+	return Load(path);
+}
+bool FileHashCache::GetHash(const char *filePath, uint64_t fileSize, int64_t modificationTime, unsigned int *hash) const
+{
+	unsigned int index=LowerBound(filePath);
+	if (index==loadedEntryCount || strcmp(GetLoadedPath(index), filePath)!=0)
+		return false;
+	const LoadedEntry &entry=loadedEntries[index];
+	if (entry.fileSize!=fileSize || entry.modificationTime!=modificationTime)
+		return false;
+	*hash=entry.hash;
+	return true;
+}
+void FileHashCache::AddEntry(const char *filePath, uint64_t fileSize, int64_t modificationTime, unsigned int hash)
+{
+	unsigned int index=LowerBound(filePath);
+	if (index < loadedEntryCount && strcmp(GetLoadedPath(index), filePath)==0)
+	{
+		const LoadedEntry &entry=loadedEntries[index];
+		if (entry.fileSize==fileSize && entry.modificationTime==modificationTime && entry.hash==hash &&
+			loadedEntryStates[index]!=LOADED_ENTRY_DROPPED)
+		{
+			loadedEntryStates[index]=LOADED_ENTRY_CONFIRMED;
+			return;
+		}
+		loadedEntryStates[index]=LOADED_ENTRY_DROPPED;
+		droppedLoadedEntries=true;
+	}
+
+	AddedEntry *addedEntry=SLNet::OP_NEW<AddedEntry>(_FILE_AND_LINE_);
+	addedEntry->filePath=filePath;
+	addedEntry->fileSize=fileSize;
+	addedEntry->modificationTime=modificationTime;
+	addedEntry->hash=hash;
+	addedEntry->order=addedEntries.Size();
+	addedEntries.Insert(addedEntry, _FILE_AND_LINE_);
+}
+void FileHashCache::RemoveMissingEntries(const char *directory, bool recursive)
+{
+	size_t directoryLength=strlen(directory);
+	for (unsigned int index=LowerBound(directory); index < loadedEntryCount; index++)
+	{
+		const char *filePath=GetLoadedPath(index);
+		if (strncmp(filePath, directory, directoryLength)!=0)
+			break;
+		if (recursive==false && (strchr(filePath+directoryLength, '/') || strchr(filePath+directoryLength, '\\')))
+			continue;
+		if (loadedEntryStates[index]==LOADED_ENTRY_UNCHANGED)
+		{
+			loadedEntryStates[index]=LOADED_ENTRY_DROPPED;
+			droppedLoadedEntries=true;
+		}
+	}
+}
+bool FileHashCache::HasChanges(void) const
+{
+	return droppedLoadedEntries || addedEntries.Size()>0;
+}
+void FileHashCache::Clear(void)
+{
+	if (loadedData)
+		rakFree_Ex(loadedData, _FILE_AND_LINE_);
+	if (loadedEntryStates)
+		rakFree_Ex(loadedEntryStates, _FILE_AND_LINE_);
+	loadedData=0;
+	loadedEntries=0;
+	loadedPaths=0;
+	loadedEntryCount=0;
+	loadedEntryStates=0;
+	droppedLoadedEntries=false;
+
+	for (unsigned int i=0; i < addedEntries.Size(); i++)
+		SLNet::OP_DELETE(addedEntries[i], _FILE_AND_LINE_);
+	addedEntries.Clear(false, _FILE_AND_LINE_);
+}
+unsigned int FileHashCache::GetLoadedEntryCount(void) const
+{
+	return loadedEntryCount;
+}
+const char *FileHashCache::GetLoadedPath(unsigned int index) const
+{
+	return loadedPaths+loadedEntries[index].pathOffset;
+}
+unsigned int FileHashCache::LowerBound(const char *filePath) const
+{
+	unsigned int lower=0, upper=loadedEntryCount;
+	while (lower < upper)
+	{
+		unsigned int middle=lower+(upper-lower)/2;
+		if (strcmp(GetLoadedPath(middle), filePath)<0)
+			lower=middle+1;
+		else
+			upper=middle;
+	}
+	return lower;
+}
+int FileHashCache::AddedEntryComp(const void *a, const void *b)
+{
+	const AddedEntry *x=*(const AddedEntry* const*) a, *y=*(const AddedEntry* const*) b;
+	int comp=strcmp(x->filePath.C_String(), y->filePath.C_String());
+	if (comp!=0)
+		return comp;
+	return x->order<y->order ? -1 : (x->order>y->order ? 1 : 0);
+}
+
+#endif // _RAKNET_SUPPORT_FileOperations
@@ -18,6 +18,7 @@
 #if _RAKNET_SUPPORT_FileOperations==1
 
 #include <stdio.h> // RAKNET_DEBUG_PRINTF
+#include <time.h>
 #include "slikenet/assert.h"
 #if defined(ANDROID)
 #include <asm/io.h>
@@ -45,6 +46,10 @@
 #include "slikenet/BitStream.h"
 #include "slikenet/FileOperations.h"
 #include "slikenet/SuperFastHash.h"
+#include "slikenet/FileHashCache.h"
+#include "slikenet/ThreadPool.h"
+#include "slikenet/SignaledEvent.h"
+#include "slikenet/LocklessTypes.h"
 #include "slikenet/assert.h"
 #include "slikenet/LinuxStrings.h"
 #include "slikenet/linux_adapter.h"
@@ -109,10 +114,14 @@ void FLP_Printf::OnSendAborted( SystemAddress systemAddress )
 }
 FileList::FileList()
 {
+	scanThreads=0;
+	hashCache=0;
 }
 FileList::~FileList()
 {
 	Clear();
+	if (hashCache)
+		SLNet::OP_DELETE(hashCache, _FILE_AND_LINE_);
 }
 void FileList::AddFile(const char *filepath, const char *filename, FileListNodeContext context)
 {
@@ -167,12 +176,6 @@ void FileList::AddFile(const char *filename, const char *fullPathToFile, const c
 {
 	if (filename==0)
 		return;
-	if (strlen(filename)>MAX_FILENAME_LENGTH)
-	{
-		// Should be enough for anyone
-		RakAssert(0);
-		return;
-	}
 	// If adding a reference, do not send data
 	RakAssert(isAReference==false || data==0);
 	// Avoid duplicate insertions unless the data is different, in which case overwrite the old data
@@ -195,6 +198,16 @@ void FileList::AddFile(const char *filename, const char *fullPathToFile, const c
 		}
 	}
 
+	InsertFile(filename, fullPathToFile, data, dataLength, fileLength, context, isAReference, takeDataPointer);
+}
+void FileList::InsertFile(const char *filename, const char *fullPathToFile, const char *data, const unsigned dataLength, const unsigned fileLength, FileListNodeContext context, bool isAReference, bool takeDataPointer)
+{
+	if (strlen(filename)>MAX_FILENAME_LENGTH)
+	{
+		// Should be enough for anyone
+		RakAssert(0);
+		return;
+	}
 	FileListNode n;
 //	size_t fileNameLen = strlen(filename);
 	if (dataLength && data)
@@ -225,18 +238,145 @@ void FileList::AddFile(const char *filename, const char *fullPathToFile, const c
 		
 	fileList.Insert(n, _FILE_AND_LINE_);
 }
+// Files modified this many seconds before a scan or later are not added to the hash cache, as they may change again without changing their modification time
+static const time_t HASH_CACHE_MODIFICATION_WINDOW=2;
+
+// Files are read and hashed in blocks of this size. Must match the block size of SuperFastHash(), as each block is hashed with SuperFastHashIncremental()
+static const unsigned int SCAN_READ_BLOCK=65536;
+
+// One file found by AddFilesFromDirectory(), read and hashed on the calling thread or a worker thread
+struct FileListScanJob
+{
+	SLNet::RakString fullPath;
+	// Length of the directory part of fullPath
+	size_t dirLength;
+	unsigned int fileLength;
+	int64_t modificationTime;
+	bool writeHash;
+	bool writeData;
+	// File contents, after the hash if writeHash is true
+	char *fileData;
+	unsigned int hash;
+	bool succeeded;
+	// hash is the hash of the file contents
+	bool hashed;
+	// Only written by the thread calling AddFilesFromDirectory()
+	bool done;
+	// Set by the worker thread once the fields above are written, before it sets finishedEvent
+	SLNet::LocklessUint32_t finished;
+	SLNet::SignaledEvent *finishedEvent;
+};
+
+static void* AllocateScanReadBlock(void)
+{
+	return rakMalloc_Ex(SCAN_READ_BLOCK, _FILE_AND_LINE_);
+}
+static void FreeScanReadBlock(void *readBlock)
+{
+	rakFree_Ex(readBlock, _FILE_AND_LINE_);
+}
+
+// Reads and hashes the file in one pass. Data is read straight into fileData, so only files that are kept are held in memory
+static void ReadAndHashFile(FileListScanJob *job, char *readBlock)
+{
+	job->succeeded=false;
+	job->hashed=false;
+	job->fileData=0;
+	job->hash=0;
+
+	FILE *fp;
+	if (fopen_s(&fp, job->fullPath.C_String(), "rb") != 0)
+	{
+		// Same as SuperFastHashFile()
+		job->succeeded=job->writeData==false;
+		return;
+	}
+
+	unsigned int dataOffset=0;
+	if (job->writeData)
+	{
+		if (job->writeHash)
+			dataOffset=HASH_LENGTH;
+		job->fileData=(char*) rakMalloc_Ex(job->fileLength+dataOffset, _FILE_AND_LINE_);
+		RakAssert(job->fileData);
+	}
+
+	unsigned int lastHash=job->fileLength;
+	unsigned int bytesRead=0;
+	while (bytesRead < job->fileLength)
+	{
+		unsigned int blockLength=job->fileLength-bytesRead;
+		if (blockLength > SCAN_READ_BLOCK)
+			blockLength=SCAN_READ_BLOCK;
+		char *block=job->fileData ? job->fileData+dataOffset+bytesRead : readBlock;
+		size_t blockRead=fread(block, 1, blockLength, fp);
+		// The file got shorter since it was found
+		if (blockRead < blockLength)
+			memset(block+blockRead, 0, blockLength-blockRead);
+		if (job->writeHash)
+			lastHash=SuperFastHashIncremental(block, (int) blockLength, lastHash);
+		else if (blockRead < blockLength)
+			break;
+		bytesRead+=blockLength;
+	}
+	fclose(fp);
+
+	if (job->writeData && bytesRead < job->fileLength)
+		memset(job->fileData+dataOffset+bytesRead, 0, job->fileLength-bytesRead);
+	if (job->writeHash)
+	{
+		job->hash=lastHash;
+		if (SLNet::BitStream::DoEndianSwap())
+			SLNet::BitStream::ReverseBytesInPlace((unsigned char*) &job->hash, sizeof(job->hash));
+		if (job->fileData)
+			memcpy(job->fileData, &job->hash, HASH_LENGTH);
+	}
+	job->succeeded=true;
+	job->hashed=job->writeHash;
+}
+
+static FileListScanJob* ScanFileCB(FileListScanJob *job, bool *returnOutput, void *perThreadData)
+{
+	ReadAndHashFile(job, (char*) perThreadData);
+	// The job may be deleted as soon as finished is set
+	SLNet::SignaledEvent *finishedEvent=job->finishedEvent;
+	job->finished.Store(1);
+	finishedEvent->SetEvent();
+	*returnOutput=false;
+	return job;
+}
+
+void FileList::SetScanThreads(int numThreads)
+{
+	scanThreads=numThreads;
+}
+void FileList::SetHashCache(const char *cacheFile)
+{
+	if (cacheFile==0 || cacheFile[0]==0)
+	{
+		if (hashCache)
+			SLNet::OP_DELETE(hashCache, _FILE_AND_LINE_);
+		hashCache=0;
+		hashCacheFile.Clear();
+		return;
+	}
+
+	if (hashCache==0)
+		hashCache=SLNet::OP_NEW<FileHashCache>(_FILE_AND_LINE_);
+	hashCacheFile=cacheFile;
+}
 void FileList::AddFilesFromDirectory(const char *applicationDirectory, const char *subDirectory, bool writeHash, bool writeData, bool recursive, FileListNodeContext context)
 {
 
 
 
 	DataStructures::Queue<char*> dirList;
+	DataStructures::List<FileListScanJob*> jobs;
 	char root[260];
 	char fullPath[520];
 	_finddata_t fileInfo;
 	intptr_t dir;
-	FILE *fp;
-	char *dirSoFar, *fileData;
+	char *dirSoFar;
 	dirSoFar=(char*) rakMalloc_Ex( 520, _FILE_AND_LINE_ );
 	RakAssert(dirSoFar);
 
@@ -262,6 +402,15 @@ void FileList::AddFilesFromDirectory(const char *applicationDirectory, const cha
 	}
 	for (unsigned int flpcIndex=0; flpcIndex < fileListProgressCallbacks.Size(); flpcIndex++)
 		fileListProgressCallbacks[flpcIndex]->OnAddFilesFromDirectoryStarted(this, dirSoFar);
+
+	bool useHashCache=hashCache!=0 && writeHash && writeData==false;
+	SLNet::RakString scanDirectory=dirSoFar;
+	time_t scanStartTime=time(0);
+	bool scannedAllDirectories=true;
+	// Read every time, as another FileList may have written it
+	if (useHashCache)
+		hashCache->Load(hashCacheFile.C_String());
+
 	// RAKNET_DEBUG_PRINTF("Adding files from directory %s\n",dirSoFar);
 	dirList.Push(dirSoFar, _FILE_AND_LINE_ );
 	while (dirList.Size())
@@ -280,7 +429,9 @@ void FileList::AddFilesFromDirectory(const char *applicationDirectory, const cha
 			unsigned i;
 			for (i=0; i < dirList.Size(); i++)
 				rakFree_Ex(dirList[i], _FILE_AND_LINE_ );
-			return;
+			// Still add the files found so far
+			scannedAllDirectories=false;
+			break;
 		}
 
 //		RAKNET_DEBUG_PRINTF("Adding %s. %i remaining.\n", fullPath, dirList.Size());
@@ -300,66 +451,26 @@ void FileList::AddFilesFromDirectory(const char *applicationDirectory, const cha
 			{
 				strcpy_s(fullPath, dirSoFar);
 				strcat_s(fullPath, fileInfo.name);
-				fileData=0;
-
-				for (unsigned int flpcIndex=0; flpcIndex < fileListProgressCallbacks.Size(); flpcIndex++)
-					fileListProgressCallbacks[flpcIndex]->OnFile(this, dirSoFar, fileInfo.name, fileInfo.size);
-
-				if (writeData && writeHash)
-				{
-					if (fopen_s(&fp, fullPath, "rb") == 0)
-					{
-						fileData= (char*) rakMalloc_Ex( fileInfo.size+HASH_LENGTH, _FILE_AND_LINE_ );
-						RakAssert(fileData);
-						fread(fileData+HASH_LENGTH, fileInfo.size, 1, fp);
-						fclose(fp);
-
-						unsigned int hash = SuperFastHash(fileData+HASH_LENGTH, fileInfo.size);
-						if (SLNet::BitStream::DoEndianSwap())
-							SLNet::BitStream::ReverseBytesInPlace((unsigned char*) &hash, sizeof(hash));
-						memcpy(fileData, &hash, HASH_LENGTH);
-
-						//					sha1.Reset();
-						//					sha1.Update( ( unsigned char* ) fileData+HASH_LENGTH, fileInfo.size );
-						//					sha1.Final();
-						//					memcpy(fileData, sha1.GetHash(), HASH_LENGTH);
-						// File data and hash
-						AddFile((const char*)fullPath+rootLen, fullPath, fileData, fileInfo.size+HASH_LENGTH, fileInfo.size, context);
-					}					
-				}
-				else if (writeHash)
-				{
-//					sha1.Reset();
-//					DR_SHA1.hashFile((char*)fullPath);
-//					sha1.Final();
 
-					unsigned int hash = SuperFastHashFile(fullPath);
-					if (SLNet::BitStream::DoEndianSwap())
-						SLNet::BitStream::ReverseBytesInPlace((unsigned char*) &hash, sizeof(hash));
-
-					// Hash only
-				//	AddFile((const char*)fullPath+rootLen, (const char*)sha1.GetHash(), HASH_LENGTH, fileInfo.size, context);
-					AddFile((const char*)fullPath+rootLen, fullPath, (const char*)&hash, HASH_LENGTH, fileInfo.size, context);
-				}
-				else if (writeData)
+				FileListScanJob *job = SLNet::OP_NEW<FileListScanJob>(_FILE_AND_LINE_);
+				job->fullPath=fullPath;
+				job->dirLength=strlen(dirSoFar);
+				job->fileLength=(unsigned int) fileInfo.size;
+				job->modificationTime=(int64_t) fileInfo.time_write;
+				job->writeHash=writeHash;
+				job->writeData=writeData;
+				job->fileData=0;
+				job->hash=0;
+				job->succeeded=true;
+				job->hashed=false;
+				job->done=writeHash==false && writeData==false;
+				job->finishedEvent=0;
+				if (useHashCache && hashCache->GetHash(fullPath, job->fileLength, job->modificationTime, &job->hash))
 				{
-					fileData= (char*) rakMalloc_Ex( fileInfo.size, _FILE_AND_LINE_ );
-					RakAssert(fileData);
-					fopen_s(&fp, fullPath, "rb");
-					fread(fileData, fileInfo.size, 1, fp);
-					fclose(fp);
-
-					// File data only
-					AddFile(fullPath+rootLen, fullPath, fileData, fileInfo.size, fileInfo.size, context);
+					job->hashed=true;
+					job->done=true;
 				}
-				else
-				{
-					// Just the filename
-					AddFile(fullPath+rootLen, fullPath, 0, 0, fileInfo.size, context);
-				}
-
-				if (fileData)
-					rakFree_Ex(fileData, _FILE_AND_LINE_ );
+				jobs.Insert(job, _FILE_AND_LINE_);
 			}
 			else if ((fileInfo.attrib & _A_SUBDIR) && (fileInfo.attrib & (_A_HIDDEN | _A_SYSTEM))==0 && recursive)
 			{
@@ -377,6 +488,108 @@ void FileList::AddFilesFromDirectory(const char *applicationDirectory, const cha
 		rakFree_Ex(dirSoFar, _FILE_AND_LINE_ );
 	}
 
+	// Read and hash on worker threads, while the files are added here in the order they were found
+	ThreadPool<FileListScanJob*,FileListScanJob*> threadPool;
+	SLNet::SignaledEvent finishedEvent;
+	bool useThreads=scanThreads>0 && jobs.Size()>1 && threadPool.StartThreads(scanThreads, 0, AllocateScanReadBlock, FreeScanReadBlock);
+	char *readBlock=0;
+	unsigned int i;
+	if (useThreads)
+	{
+		finishedEvent.InitEvent();
+		for (i=0; i < jobs.Size(); i++)
+		{
+			if (jobs[i]->done==false)
+			{
+				jobs[i]->finishedEvent=&finishedEvent;
+				threadPool.AddInput(ScanFileCB, jobs[i]);
+			}
+		}
+	}
+	else if (writeHash || writeData)
+		readBlock=(char*) AllocateScanReadBlock();
+
+	// Each file was found once, so there is nothing to replace unless the list already had files
+	bool checkDuplicates=fileList.Size()>0;
+	char dirName[520];
+	for (i=0; i < jobs.Size(); i++)
+	{
+		FileListScanJob *job=jobs[i];
+		if (job->done==false)
+		{
+			if (useThreads)
+			{
+				// Every file that finishes sets the event, in any order, so check this one again after each wakeup
+				while (job->finished.Load()==0)
+					finishedEvent.WaitOnEvent(1000);
+			}
+			else
+				ReadAndHashFile(job, readBlock);
+			job->done=true;
+		}
+
+		strcpy_s(fullPath, job->fullPath.C_String());
+		memcpy(dirName, fullPath, job->dirLength);
+		dirName[job->dirLength]=0;
+		for (unsigned int flpcIndex=0; flpcIndex < fileListProgressCallbacks.Size(); flpcIndex++)
+			fileListProgressCallbacks[flpcIndex]->OnFile(this, dirName, fullPath+job->dirLength, job->fileLength);
+
+		if (useHashCache && job->hashed && job->modificationTime+HASH_CACHE_MODIFICATION_WINDOW <= scanStartTime)
+			hashCache->AddEntry(fullPath, job->fileLength, job->modificationTime, job->hash);
+
+		if (job->succeeded)
+		{
+			const char *data;
+			unsigned int dataLength;
+			if (writeData)
+			{
+				// File data, after the hash if writeHash is true
+				data=job->fileData;
+				dataLength=job->fileLength+(writeHash ? HASH_LENGTH : 0);
+			}
+			else if (writeHash)
+			{
+				// Hash only
+				data=(const char*) &job->hash;
+				dataLength=HASH_LENGTH;
+			}
+			else
+			{
+				// Just the filename
+				data=0;
+				dataLength=0;
+			}
+			if (checkDuplicates)
+				AddFile((const char*)fullPath+rootLen, fullPath, data, dataLength, job->fileLength, context);
+			else
+			{
+				bool takeDataPointer=data!=0 && data==job->fileData && dataLength>0;
+				InsertFile((const char*)fullPath+rootLen, fullPath, data, dataLength, job->fileLength, context, false, takeDataPointer);
+				if (takeDataPointer)
+					job->fileData=0;
+			}
+		}
+
+		if (job->fileData)
+			rakFree_Ex(job->fileData, _FILE_AND_LINE_ );
+		SLNet::OP_DELETE(job, _FILE_AND_LINE_);
+	}
+
+	if (useThreads)
+	{
+		threadPool.StopThreads();
+		finishedEvent.CloseEvent();
+	}
+	if (readBlock)
+		FreeScanReadBlock(readBlock);
+
+	if (useHashCache)
+	{
+		if (scannedAllDirectories)
+			hashCache->RemoveMissingEntries(scanDirectory.C_String(), recursive);
+		if (hashCache->HasChanges())
+			hashCache->Save(hashCacheFile.C_String());
+	}
 }
 void FileList::Clear(void)
 {
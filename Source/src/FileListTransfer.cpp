@@ -525,6 +525,15 @@ PluginReceiveResult FileListTransfer::OnReceive(Packet *packet)
 
 	return RR_CONTINUE_PROCESSING;
 }
+bool FileListTransfer::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_FILE_LIST_TRANSFER_HEADER]=true;
+	messageIDs[ID_FILE_LIST_TRANSFER_FILE]=true;
+	messageIDs[ID_FILE_LIST_REFERENCE_PUSH]=true;
+	messageIDs[ID_FILE_LIST_REFERENCE_PUSH_ACK]=true;
+	messageIDs[ID_DOWNLOAD_PROGRESS]=true;
+	return true;
+}
 void FileListTransfer::OnRakPeerShutdown(void)
 {
 	threadPool.StopThreads();
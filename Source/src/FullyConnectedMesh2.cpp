@@ -299,6 +299,25 @@ PluginReceiveResult FullyConnectedMesh2::OnReceive(Packet *packet)
 
 	return RR_CONTINUE_PROCESSING;
 }
+bool FullyConnectedMesh2::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_REMOTE_NEW_INCOMING_CONNECTION]=true;
+	messageIDs[ID_FCM2_REQUEST_FCMGUID]=true;
+	messageIDs[ID_FCM2_RESPOND_CONNECTION_COUNT]=true;
+	messageIDs[ID_FCM2_INFORM_FCMGUID]=true;
+	messageIDs[ID_FCM2_UPDATE_MIN_TOTAL_CONNECTION_COUNT]=true;
+	messageIDs[ID_FCM2_NEW_HOST]=true;
+	messageIDs[ID_FCM2_VERIFIED_JOIN_START]=true;
+	messageIDs[ID_FCM2_VERIFIED_JOIN_CAPABLE]=true;
+	messageIDs[ID_FCM2_VERIFIED_JOIN_FAILED]=true;
+	messageIDs[ID_FCM2_VERIFIED_JOIN_ACCEPTED]=true;
+	messageIDs[ID_FCM2_VERIFIED_JOIN_REJECTED]=true;
+	messageIDs[ID_NAT_TARGET_UNRESPONSIVE]=true;
+	messageIDs[ID_NAT_TARGET_NOT_CONNECTED]=true;
+	messageIDs[ID_NAT_CONNECTION_TO_TARGET_LOST]=true;
+	messageIDs[ID_NAT_PUNCHTHROUGH_FAILED]=true;
+	return true;
+}
 void FullyConnectedMesh2::OnRakPeerStartup(void)
 {
 	Clear();
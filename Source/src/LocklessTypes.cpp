@@ -37,7 +37,7 @@ uint32_t LocklessUint32_t::Increment(void)
 	mutex.Unlock();
 	return v;
 #else
-	return __sync_fetch_and_add (&value, (uint32_t) 1);
+	return __sync_add_and_fetch (&value, (uint32_t) 1);
 #endif
 }
 uint32_t LocklessUint32_t::Decrement(void)
@@ -52,6 +52,50 @@ uint32_t LocklessUint32_t::Decrement(void)
 	mutex.Unlock();
 	return v;
 #else
-	return __sync_fetch_and_add (&value, (uint32_t) -1);
+	return __sync_sub_and_fetch (&value, (uint32_t) 1);
+#endif
+}
+bool LocklessUint32_t::CompareAndSet(uint32_t expected, uint32_t desired)
+{
+#ifdef _WIN32
+	return (uint32_t) InterlockedCompareExchange(&value, (LONG) desired, (LONG) expected)==expected;
+#elif defined(ANDROID) || defined(__S3E__) || defined(__APPLE__)
+	bool changed;
+	mutex.Lock();
+	changed=value==expected;
+	if (changed)
+		value=desired;
+	mutex.Unlock();
+	return changed;
+#else
+	return __sync_bool_compare_and_swap (&value, expected, desired);
+#endif
+}
+uint32_t LocklessUint32_t::Load(void) const
+{
+#ifdef _WIN32
+	// Reads of volatile variables have acquire semantics with Microsoft compilers (/volatile:ms, the default on x86 and x64)
+	return (uint32_t) value;
+#elif defined(ANDROID) || defined(__S3E__) || defined(__APPLE__)
+	uint32_t v;
+	mutex.Lock();
+	v=value;
+	mutex.Unlock();
+	return v;
+#else
+	return __atomic_load_n (&value, __ATOMIC_ACQUIRE);
+#endif
+}
+void LocklessUint32_t::Store(uint32_t newValue)
+{
+#ifdef _WIN32
+	// Writes to volatile variables have release semantics with Microsoft compilers (/volatile:ms, the default on x86 and x64)
+	value=(LONG) newValue;
+#elif defined(ANDROID) || defined(__S3E__) || defined(__APPLE__)
+	mutex.Lock();
+	value=newValue;
+	mutex.Unlock();
+#else
+	__atomic_store_n (&value, newValue, __ATOMIC_RELEASE);
 #endif
 }
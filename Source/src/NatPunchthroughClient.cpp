@@ -725,6 +725,20 @@ PluginReceiveResult NatPunchthroughClient::OnReceive(Packet *packet)
 	}
 	return RR_CONTINUE_PROCESSING;
 }
+bool NatPunchthroughClient::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_NAT_GET_MOST_RECENT_PORT]=true;
+	messageIDs[ID_NAT_PUNCHTHROUGH_FAILED]=true;
+	messageIDs[ID_NAT_PUNCHTHROUGH_SUCCEEDED]=true;
+	messageIDs[ID_NAT_RESPOND_BOUND_ADDRESSES]=true;
+	messageIDs[ID_OUT_OF_BAND_INTERNAL]=true;
+	messageIDs[ID_NAT_ALREADY_IN_PROGRESS]=true;
+	messageIDs[ID_NAT_TARGET_NOT_CONNECTED]=true;
+	messageIDs[ID_NAT_CONNECTION_TO_TARGET_LOST]=true;
+	messageIDs[ID_NAT_TARGET_UNRESPONSIVE]=true;
+	messageIDs[ID_TIMESTAMP]=true;
+	return true;
+}
 /*
 void NatPunchthroughClient::ProcessNextPunchthroughQueue(void)
 {
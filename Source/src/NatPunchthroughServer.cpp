@@ -43,30 +43,63 @@ void NatPunchthroughServerDebugInterface_PacketLogger::OnServerMessage(const cha
 }
 #endif
 
+// Ticks of the timer wheel for connection attempt timeouts. Update() only checks every 250 milliseconds anyway
+static const SLNet::TimeMS CONNECTION_ATTEMPT_TIMER_TICK_MS=50;
+
+static bool IsInConnectionAttempts(const NatPunchthroughServer::User *user, const NatPunchthroughServer::ConnectionAttempt *ca)
+{
+	if (ca->sender!=user && ca->recipient!=user)
+		return false;
+	return ca->prev[ca->GetLinkIndex(user)]!=0 || user->firstConnectionAttempt==ca;
+}
+
+void NatPunchthroughServer::User::AddConnectionAttempt(NatPunchthroughServer::ConnectionAttempt *ca)
+{
+	int linkIndex=ca->GetLinkIndex(this);
+	ca->next[linkIndex]=0;
+	ca->prev[linkIndex]=lastConnectionAttempt;
+	if (lastConnectionAttempt)
+		lastConnectionAttempt->next[lastConnectionAttempt->GetLinkIndex(this)]=ca;
+	else
+		firstConnectionAttempt=ca;
+	lastConnectionAttempt=ca;
+	connectionAttemptCount++;
+}
 void NatPunchthroughServer::User::DeleteConnectionAttempt(NatPunchthroughServer::ConnectionAttempt *ca)
 {
-	unsigned int index = connectionAttempts.GetIndexOf(ca);
-	if ((unsigned int)index!=(unsigned int)-1)
+	if (IsInConnectionAttempts(this, ca))
 	{
+		DerefConnectionAttempt(ca);
+		// Also cancels its timeout
 		SLNet::OP_DELETE(ca,_FILE_AND_LINE_);
-		connectionAttempts.RemoveAtIndex(index);
 	}
 }
 void NatPunchthroughServer::User::DerefConnectionAttempt(NatPunchthroughServer::ConnectionAttempt *ca)
 {
-	unsigned int index = connectionAttempts.GetIndexOf(ca);
-	if ((unsigned int)index!=(unsigned int)-1)
-	{
-		connectionAttempts.RemoveAtIndex(index);
-	}
+	if (IsInConnectionAttempts(this, ca)==false)
+		return;
+
+	int linkIndex=ca->GetLinkIndex(this);
+	ConnectionAttempt *prev=ca->prev[linkIndex], *next=ca->next[linkIndex];
+	if (prev)
+		prev->next[prev->GetLinkIndex(this)]=next;
+	else
+		firstConnectionAttempt=next;
+	if (next)
+		next->prev[next->GetLinkIndex(this)]=prev;
+	else
+		lastConnectionAttempt=prev;
+	ca->next[linkIndex]=0;
+	ca->prev[linkIndex]=0;
+	connectionAttemptCount--;
 }
 bool NatPunchthroughServer::User::HasConnectionAttemptToUser(User *user)
 {
-	unsigned int index;
-	for (index=0; index < connectionAttempts.Size(); index++)
+	ConnectionAttempt *ca;
+	for (ca=firstConnectionAttempt; ca; ca=ca->GetNext(this))
 	{
-		if (connectionAttempts[index]->recipient->guid==user->guid ||
-			connectionAttempts[index]->sender->guid==user->guid)
+		if (ca->recipient->guid==user->guid ||
+			ca->sender->guid==user->guid)
 			return true;
 	}
 	return false;
@@ -75,15 +108,16 @@ void NatPunchthroughServer::User::LogConnectionAttempts(SLNet::RakString &rs)
 {
 	rs.Clear();
 	unsigned int index;
+	ConnectionAttempt *ca;
 	char guidStr[128], ipStr[128];
 	guid.ToString(guidStr, 128);
 	systemAddress.ToString(true,ipStr,static_cast<size_t>(128));
 	rs= SLNet::RakString("User systemAddress=%s guid=%s\n", ipStr, guidStr);
-	rs+= SLNet::RakString("%i attempts in list:\n", connectionAttempts.Size());
-	for (index=0; index < connectionAttempts.Size(); index++)
+	rs+= SLNet::RakString("%i attempts in list:\n", connectionAttemptCount);
+	for (index=0, ca=firstConnectionAttempt; ca; index++, ca=ca->GetNext(this))
 	{
-		rs+= SLNet::RakString("%i. SessionID=%i ", index+1, connectionAttempts[index]->sessionId);
-		if (connectionAttempts[index]->sender==this)
+		rs+= SLNet::RakString("%i. SessionID=%i ", index+1, ca->sessionId);
+		if (ca->sender==this)
 			rs+="(We are sender) ";
 		else
 			rs+="(We are recipient) ";
@@ -91,37 +125,28 @@ void NatPunchthroughServer::User::LogConnectionAttempts(SLNet::RakString &rs)
 			rs+="(READY TO START) ";
 		else
 			rs+="(NOT READY TO START) ";
-		if (connectionAttempts[index]->attemptPhase==NatPunchthroughServer::ConnectionAttempt::NAT_ATTEMPT_PHASE_NOT_STARTED)
+		if (ca->attemptPhase==NatPunchthroughServer::ConnectionAttempt::NAT_ATTEMPT_PHASE_NOT_STARTED)
 			rs+="(NOT_STARTED). ";
 		else
 			rs+="(GETTING_RECENT_PORTS). ";
-		if (connectionAttempts[index]->sender==this)
+		if (ca->sender==this)
 		{
-			connectionAttempts[index]->recipient->guid.ToString(guidStr, 128);
-			connectionAttempts[index]->recipient->systemAddress.ToString(true,ipStr,static_cast<size_t>(128));
+			ca->recipient->guid.ToString(guidStr, 128);
+			ca->recipient->systemAddress.ToString(true,ipStr,static_cast<size_t>(128));
 		}
 		else
 		{
-			connectionAttempts[index]->sender->guid.ToString(guidStr, 128);
-			connectionAttempts[index]->sender->systemAddress.ToString(true,ipStr,static_cast<size_t>(128));
+			ca->sender->guid.ToString(guidStr, 128);
+			ca->sender->systemAddress.ToString(true,ipStr,static_cast<size_t>(128));
 		}
 
 		rs+= SLNet::RakString("Target systemAddress=%s, guid=%s.\n", ipStr, guidStr);
 	}
 }
 
-int SLNet::NatPunchthroughServer::NatPunchthroughUserComp( const RakNetGUID &key, User * const &data )
-{
-	if (key < data->guid)
-		return -1;
-	if (key > data->guid)
-		return 1;
-	return 0;
-}
-
 STATIC_FACTORY_DEFINITIONS(NatPunchthroughServer,NatPunchthroughServer);
 
-NatPunchthroughServer::NatPunchthroughServer()
+NatPunchthroughServer::NatPunchthroughServer() : users(64), connectionAttemptTimers(CONNECTION_ATTEMPT_TIMER_TICK_MS)
 {
 	lastUpdate=0;
 	sessionId=0;
@@ -129,18 +154,21 @@ NatPunchthroughServer::NatPunchthroughServer()
 	for (int i=0; i < MAXIMUM_NUMBER_OF_INTERNAL_IDS; i++)
 		boundAddresses[i]=UNASSIGNED_SYSTEM_ADDRESS;
 	boundAddressCount=0;
+	connectionAttemptTimers.Advance(SLNet::GetTime());
 }
 NatPunchthroughServer::~NatPunchthroughServer()
 {
 	User *user, *otherUser;
-	ConnectionAttempt *connectionAttempt;
-	unsigned int j;
-	while(users.Size())
+	ConnectionAttempt *connectionAttempt, *nextConnectionAttempt;
+	unsigned int i;
+	for (i=0; i < users.GetSlotCount(); i++)
 	{
-		user = users[0];
-		for (j=0; j < user->connectionAttempts.Size(); j++)
+		user = users.GetDataAtSlot(i);
+		if (user==0)
+			continue;
+		for (connectionAttempt=user->firstConnectionAttempt; connectionAttempt; connectionAttempt=nextConnectionAttempt)
 		{
-			connectionAttempt=user->connectionAttempts[j];
+			nextConnectionAttempt=connectionAttempt->GetNext(user);
 			if (connectionAttempt->sender==user)
 				otherUser=connectionAttempt->recipient;
 			else
@@ -148,10 +176,12 @@ NatPunchthroughServer::~NatPunchthroughServer()
 			otherUser->DeleteConnectionAttempt(connectionAttempt);
 		}
 		SLNet::OP_DELETE(user,_FILE_AND_LINE_);
-		users[0]=users[users.Size()-1];
-		users.RemoveAtIndex(users.Size()-1);
 	}
 }
+unsigned int NatPunchthroughServer::GUIDToHash(const uint64_t &guid)
+{
+	return (unsigned int) ((guid*0x9E3779B97F4A7C15ull) >> 32);
+}
 void NatPunchthroughServer::SetDebugInterface(NatPunchthroughServerDebugInterface *i)
 {
 	natPunchthroughServerDebugInterface=i;
@@ -160,71 +190,60 @@ void NatPunchthroughServer::Update(void)
 {
 	ConnectionAttempt *connectionAttempt;
 	User *user, *recipient;
-	unsigned int i,j;
+	DataStructures::TimerWheel::Timer *timer;
 	SLNet::Time time = SLNet::GetTime();
 	if (time > lastUpdate+250)
 	{
 		lastUpdate=time;
 
-		for (i=0; i < users.Size(); i++)
+		// Only the attempts that timed out, rather than every attempt of every user
+		connectionAttemptTimers.Advance(time);
+		while ((timer=connectionAttemptTimers.PopExpired())!=0)
 		{
-			user=users[i];
-			for (j=0; j < user->connectionAttempts.Size(); j++)
+			connectionAttempt=(ConnectionAttempt*) timer->userData;
+			user=connectionAttempt->sender;
+			SLNet::BitStream outgoingBs;
+			
+			// that other system might not be running the plugin
+			outgoingBs.Write((MessageID)ID_NAT_TARGET_UNRESPONSIVE);
+			outgoingBs.Write(connectionAttempt->recipient->guid);
+			outgoingBs.Write(connectionAttempt->sessionId);
+			rakPeerInterface->Send(&outgoingBs,HIGH_PRIORITY,RELIABLE_ORDERED,0,connectionAttempt->sender->systemAddress,false);
+
+			// 05/28/09 Previously only told sender about ID_NAT_CONNECTION_TO_TARGET_LOST
+			// However, recipient may be expecting it due to external code
+			// In that case, recipient would never get any response if the sender dropped
+			outgoingBs.Reset();
+			outgoingBs.Write((MessageID)ID_NAT_TARGET_UNRESPONSIVE);
+			outgoingBs.Write(connectionAttempt->sender->guid);
+			outgoingBs.Write(connectionAttempt->sessionId);
+			rakPeerInterface->Send(&outgoingBs,HIGH_PRIORITY,RELIABLE_ORDERED,0,connectionAttempt->recipient->systemAddress,false);
+
+			connectionAttempt->sender->isReady=true;
+			connectionAttempt->recipient->isReady=true;
+			recipient=connectionAttempt->recipient;
+
+
+			if (natPunchthroughServerDebugInterface)
 			{
-				connectionAttempt=user->connectionAttempts[j];
-				if (connectionAttempt->sender==user)
-				{
-					if (connectionAttempt->attemptPhase!=ConnectionAttempt::NAT_ATTEMPT_PHASE_NOT_STARTED &&
-						time > connectionAttempt->startTime &&
-						time > 10000 + connectionAttempt->startTime ) // Formerly 5000, but sometimes false positives
-					{
-						SLNet::BitStream outgoingBs;
-						
-						// that other system might not be running the plugin
-						outgoingBs.Write((MessageID)ID_NAT_TARGET_UNRESPONSIVE);
-						outgoingBs.Write(connectionAttempt->recipient->guid);
-						outgoingBs.Write(connectionAttempt->sessionId);
-						rakPeerInterface->Send(&outgoingBs,HIGH_PRIORITY,RELIABLE_ORDERED,0,connectionAttempt->sender->systemAddress,false);
-
-						// 05/28/09 Previously only told sender about ID_NAT_CONNECTION_TO_TARGET_LOST
-						// However, recipient may be expecting it due to external code
-						// In that case, recipient would never get any response if the sender dropped
-						outgoingBs.Reset();
-						outgoingBs.Write((MessageID)ID_NAT_TARGET_UNRESPONSIVE);
-						outgoingBs.Write(connectionAttempt->sender->guid);
-						outgoingBs.Write(connectionAttempt->sessionId);
-						rakPeerInterface->Send(&outgoingBs,HIGH_PRIORITY,RELIABLE_ORDERED,0,connectionAttempt->recipient->systemAddress,false);
-
-						connectionAttempt->sender->isReady=true;
-						connectionAttempt->recipient->isReady=true;
-						recipient=connectionAttempt->recipient;
-
-
-						if (natPunchthroughServerDebugInterface)
-						{
-							char str[1024];
-							char addr1[128], addr2[128];
-							// 8/01/09 Fixed bug where this was after DeleteConnectionAttempt()
-							connectionAttempt->sender->systemAddress.ToString(true,addr1,static_cast<size_t>(128));
-							connectionAttempt->recipient->systemAddress.ToString(true,addr2,static_cast<size_t>(128));
-							sprintf_s(str, "Sending ID_NAT_TARGET_UNRESPONSIVE to sender %s and recipient %s.", addr1, addr2);
-							natPunchthroughServerDebugInterface->OnServerMessage(str);
-							SLNet::RakString log;
-							connectionAttempt->sender->LogConnectionAttempts(log);
-							connectionAttempt->recipient->LogConnectionAttempts(log);
-						}
-
-
-						connectionAttempt->sender->DerefConnectionAttempt(connectionAttempt);
-						connectionAttempt->recipient->DeleteConnectionAttempt(connectionAttempt);
-
-						StartPunchthroughForUser(user);
-						StartPunchthroughForUser(recipient);
-
-						break;
-					}
-				}
+				char str[1024];
+				char addr1[128], addr2[128];
+				// 8/01/09 Fixed bug where this was after DeleteConnectionAttempt()
+				connectionAttempt->sender->systemAddress.ToString(true,addr1,static_cast<size_t>(128));
+				connectionAttempt->recipient->systemAddress.ToString(true,addr2,static_cast<size_t>(128));
+				sprintf_s(str, "Sending ID_NAT_TARGET_UNRESPONSIVE to sender %s and recipient %s.", addr1, addr2);
+				natPunchthroughServerDebugInterface->OnServerMessage(str);
+				SLNet::RakString log;
+				connectionAttempt->sender->LogConnectionAttempts(log);
+				connectionAttempt->recipient->LogConnectionAttempts(log);
 			}
+
+
+			connectionAttempt->sender->DerefConnectionAttempt(connectionAttempt);
+			connectionAttempt->recipient->DeleteConnectionAttempt(connectionAttempt);
+
+			StartPunchthroughForUser(user);
+			StartPunchthroughForUser(recipient);
 		}
 	}
 }
@@ -290,25 +309,32 @@ PluginReceiveResult NatPunchthroughServer::OnReceive(Packet *packet)
 	}
 	return RR_CONTINUE_PROCESSING;
 }
+bool NatPunchthroughServer::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_NAT_PUNCHTHROUGH_REQUEST]=true;
+	messageIDs[ID_NAT_GET_MOST_RECENT_PORT]=true;
+	messageIDs[ID_NAT_CLIENT_READY]=true;
+	messageIDs[ID_NAT_REQUEST_BOUND_ADDRESSES]=true;
+	messageIDs[ID_NAT_PING]=true;
+	messageIDs[ID_OUT_OF_BAND_INTERNAL]=true;
+	return true;
+}
 void NatPunchthroughServer::OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason )
 {
 	(void) lostConnectionReason;
 	(void) systemAddress;
 
 	unsigned int i=0;
-	bool objectExists;
-	i = users.GetIndexFromKey(rakNetGUID, &objectExists);
-	if (objectExists)
+	User *user = users.Get(rakNetGUID.g);
+	if (user)
 	{
 		SLNet::BitStream outgoingBs;
 		DataStructures::List<User *> freedUpInProgressUsers;
-		User *user = users[i];
 		User *otherUser;
-		unsigned int connectionAttemptIndex;
-		ConnectionAttempt *connectionAttempt;
-		for (connectionAttemptIndex=0; connectionAttemptIndex < user->connectionAttempts.Size(); connectionAttemptIndex++)
+		ConnectionAttempt *connectionAttempt, *nextConnectionAttempt;
+		for (connectionAttempt=user->firstConnectionAttempt; connectionAttempt; connectionAttempt=nextConnectionAttempt)
 		{
-			connectionAttempt=user->connectionAttempts[connectionAttemptIndex];
+			nextConnectionAttempt=connectionAttempt->GetNext(user);
 			outgoingBs.Reset();
 			if (connectionAttempt->recipient==user)
 			{
@@ -337,8 +363,8 @@ void NatPunchthroughServer::OnClosedConnection(const SystemAddress &systemAddres
 			otherUser->DeleteConnectionAttempt(connectionAttempt);
 		}
 
-		SLNet::OP_DELETE(users[i], _FILE_AND_LINE_);
-		users.RemoveAtIndex(i);
+		users.Remove(user->guid.g, _FILE_AND_LINE_);
+		SLNet::OP_DELETE(user, _FILE_AND_LINE_);
 
 		for (i=0; i < freedUpInProgressUsers.Size(); i++)
 		{
@@ -373,12 +399,18 @@ void NatPunchthroughServer::OnNewConnection(const SystemAddress &systemAddress,
 	(void) systemAddress;
 	(void) isIncoming;
 
+	if (users.Get(rakNetGUID.g))
+	{
+		RakAssert("NatPunchthroughServer::OnNewConnection got a duplicate GUID" && 0);
+		return;
+	}
+
 	User *user = SLNet::OP_NEW<User>(_FILE_AND_LINE_);
 	user->guid=rakNetGUID;
 	user->mostRecentPort=0;
 	user->systemAddress=systemAddress;
 	user->isReady=true;
-	users.Insert(rakNetGUID, user, true, _FILE_AND_LINE_);
+	users.Insert(user->guid.g, user, _FILE_AND_LINE_);
 
 //	printf("Adding to users %s\n", rakNetGUID.ToString());
 //	printf("DEBUG users[0] guid=%s\n", users[0]->guid.ToString());
@@ -391,16 +423,16 @@ void NatPunchthroughServer::OnNATPunchthroughRequest(Packet *packet)
 	RakNetGUID recipientGuid, senderGuid;
 	incomingBs.Read(recipientGuid);
 	senderGuid=packet->guid;
-	unsigned int i;
-	bool objectExists;
-	i = users.GetIndexFromKey(senderGuid, &objectExists);
-	RakAssert(objectExists);
+	User *sender = users.Get(senderGuid.g);
+	RakAssert(sender);
+	if (sender==0)
+		return;
 
 	ConnectionAttempt *ca = SLNet::OP_NEW<ConnectionAttempt>(_FILE_AND_LINE_);
-	ca->sender=users[i];
+	ca->sender=sender;
 	ca->sessionId=sessionId++;
-	i = users.GetIndexFromKey(recipientGuid, &objectExists);
-	if (objectExists==false || ca->sender == ca->recipient)
+	User *recipient = users.Get(recipientGuid.g);
+	if (recipient==0 || ca->sender == recipient)
 	{
 // 		printf("DEBUG %i\n", __LINE__);
 // 		printf("DEBUG recipientGuid=%s\n", recipientGuid.ToString());
@@ -412,7 +444,7 @@ void NatPunchthroughServer::OnNATPunchthroughRequest(Packet *packet)
 		SLNet::OP_DELETE(ca,_FILE_AND_LINE_);
 		return;
 	}
-	ca->recipient=users[i];
+	ca->recipient=recipient;
 	if (ca->recipient->HasConnectionAttemptToUser(ca->sender))
 	{
 		outgoingBs.Write((MessageID)ID_NAT_ALREADY_IN_PROGRESS);
@@ -422,20 +454,18 @@ void NatPunchthroughServer::OnNATPunchthroughRequest(Packet *packet)
 		return;
 	}
 
-	ca->sender->connectionAttempts.Insert(ca, _FILE_AND_LINE_ );
-	ca->recipient->connectionAttempts.Insert(ca, _FILE_AND_LINE_ );
+	ca->sender->AddConnectionAttempt(ca);
+	ca->recipient->AddConnectionAttempt(ca);
 
 	StartPunchthroughForUser(ca->sender);
 }
 void NatPunchthroughServer::OnClientReady(Packet *packet)
 {
-	unsigned int i;
-	bool objectExists;
-	i = users.GetIndexFromKey(packet->guid, &objectExists);
-	if (objectExists)
+	User *user = users.Get(packet->guid.g);
+	if (user)
 	{
-		users[i]->isReady=true;
-		StartPunchthroughForUser(users[i]);
+		user->isReady=true;
+		StartPunchthroughForUser(user);
 	}
 }
 void NatPunchthroughServer::OnGetMostRecentPort(Packet *packet)
@@ -447,11 +477,9 @@ void NatPunchthroughServer::OnGetMostRecentPort(Packet *packet)
 	bsIn.Read(curSessionId);
 	bsIn.Read(mostRecentPort);
 
-	unsigned int i,j;
-	User *user;
+	unsigned int j;
 	ConnectionAttempt *connectionAttempt;
-	bool objectExists;
-	i = users.GetIndexFromKey(packet->guid, &objectExists);
+	User *user = users.Get(packet->guid.g);
 
 	if (natPunchthroughServerDebugInterface)
 	{
@@ -459,19 +487,17 @@ void NatPunchthroughServer::OnGetMostRecentPort(Packet *packet)
 		char addr1[128], addr2[128];
 		packet->systemAddress.ToString(true,addr1,static_cast<size_t>(128));
 		packet->guid.ToString(addr2, 128);
-		log= SLNet::RakString("Got ID_NAT_GET_MOST_RECENT_PORT from systemAddress %s guid %s. port=%i. sessionId=%i. userFound=%i.", addr1, addr2, mostRecentPort, curSessionId, objectExists);
+		log= SLNet::RakString("Got ID_NAT_GET_MOST_RECENT_PORT from systemAddress %s guid %s. port=%i. sessionId=%i. userFound=%i.", addr1, addr2, mostRecentPort, curSessionId, user!=0);
 		natPunchthroughServerDebugInterface->OnServerMessage(log.C_String());
 	}
 
-	if (objectExists)
+	if (user)
 	{
-		user=users[i];
 		user->mostRecentPort=mostRecentPort;
 		SLNet::Time time = SLNet::GetTime();
 
-		for (j=0; j < user->connectionAttempts.Size(); j++)
+		for (connectionAttempt=user->firstConnectionAttempt; connectionAttempt; connectionAttempt=connectionAttempt->GetNext(user))
 		{
-			connectionAttempt=user->connectionAttempts[j];
 			if (connectionAttempt->attemptPhase==ConnectionAttempt::NAT_ATTEMPT_PHASE_GETTING_RECENT_PORTS &&
 				connectionAttempt->sender->mostRecentPort!=0 &&
 				connectionAttempt->recipient->mostRecentPort!=0 &&
@@ -578,10 +604,8 @@ void NatPunchthroughServer::StartPunchthroughForUser(User *user)
 
 	ConnectionAttempt *connectionAttempt;
 	User *sender,*recipient,*otherUser;
-	unsigned int i;
-	for (i=0; i < user->connectionAttempts.Size(); i++)
+	for (connectionAttempt=user->firstConnectionAttempt; connectionAttempt; connectionAttempt=connectionAttempt->GetNext(user))
 	{
-		connectionAttempt=user->connectionAttempts[i];
 		if (connectionAttempt->sender==user)
 		{
 			otherUser=connectionAttempt->recipient;
@@ -611,6 +635,8 @@ void NatPunchthroughServer::StartPunchthroughForUser(User *user)
 			recipient->isReady=false;
 			connectionAttempt->attemptPhase=ConnectionAttempt::NAT_ATTEMPT_PHASE_GETTING_RECENT_PORTS;
 			connectionAttempt->startTime= SLNet::GetTime();
+			// Times out when Update() runs more than 10000 ms after the start. Formerly 5000, but sometimes false positives
+			connectionAttemptTimers.Schedule(&connectionAttempt->timeoutTimer, connectionAttempt->startTime+10001);
 
 			sender->mostRecentPort=0;
 			recipient->mostRecentPort=0;
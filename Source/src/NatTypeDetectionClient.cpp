@@ -165,6 +165,13 @@ PluginReceiveResult NatTypeDetectionClient::OnReceive(Packet *packet)
 
 	return RR_CONTINUE_PROCESSING;
 }
+bool NatTypeDetectionClient::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_OUT_OF_BAND_INTERNAL]=true;
+	messageIDs[ID_NAT_TYPE_DETECTION_RESULT]=true;
+	messageIDs[ID_NAT_TYPE_DETECTION_REQUEST]=true;
+	return true;
+}
 void NatTypeDetectionClient::OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason )
 {
 	(void) lostConnectionReason;
@@ -364,6 +364,11 @@ PluginReceiveResult NatTypeDetectionServer::OnReceive(Packet *packet)
 	}
 	return RR_CONTINUE_PROCESSING;
 }
+bool NatTypeDetectionServer::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_NAT_TYPE_DETECTION_REQUEST]=true;
+	return true;
+}
 void NatTypeDetectionServer::OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason )
 {
 	(void) lostConnectionReason;
@@ -29,30 +29,20 @@ using namespace SLNet;
 
 STATIC_FACTORY_DEFINITIONS(NetworkIDManager,NetworkIDManager)
 
-NetworkIDManager::NetworkIDManager()
+NetworkIDManager::NetworkIDManager() : networkIdObjects(NETWORK_ID_MANAGER_HASH_LENGTH)
 {
 	startingOffset = RakPeerInterface::Get64BitUniqueRandomNumber();
-	Clear();
 }
 NetworkIDManager::~NetworkIDManager(void)
 {
-
 }
 void NetworkIDManager::Clear(void)
 {
-	memset(networkIdHash,0,sizeof(networkIdHash));
+	networkIdObjects.Clear(_FILE_AND_LINE_);
 }
 NetworkIDObject *NetworkIDManager::GET_BASE_OBJECT_FROM_ID(NetworkID x)
 {
-	unsigned int hashIndex=NetworkIDToHashIndex(x);
-	NetworkIDObject *nio=networkIdHash[hashIndex];
-	while (nio)
-	{
-		if (nio->GetNetworkID()==x)
-			return nio;
-		nio=nio->nextInstanceForNetworkIDManager;
-	}
-	return 0;
+	return networkIdObjects.Get(x);
 }
 NetworkID NetworkIDManager::GetNewNetworkID(void)
 {
@@ -65,10 +55,10 @@ NetworkID NetworkIDManager::GetNewNetworkID(void)
 	}
     return startingOffset;
 }
-unsigned int NetworkIDManager::NetworkIDToHashIndex(NetworkID networkId)
+unsigned int NetworkIDManager::NetworkIDToHash(const NetworkID &networkId)
 {
-//	return SuperFastHash((const char*) &networkId.guid.g,sizeof(networkId.guid.g)) % NETWORK_ID_MANAGER_HASH_LENGTH;
-	return (unsigned int) (networkId % NETWORK_ID_MANAGER_HASH_LENGTH);
+	// Multiplicative hash, so the runs of consecutive IDs from each authority do not pile up in adjacent slots
+	return (unsigned int) ((networkId*0x9E3779B97F4A7C15ull) >> 32);
 }
 void NetworkIDManager::TrackNetworkIDObject(NetworkIDObject *networkIdObject)
 {
@@ -76,32 +66,8 @@ void NetworkIDManager::TrackNetworkIDObject(NetworkIDObject *networkIdObject)
 	NetworkID rawId = networkIdObject->GetNetworkID();
 	RakAssert(rawId!=UNASSIGNED_NETWORK_ID);
 
-	networkIdObject->nextInstanceForNetworkIDManager=0;
-
-	unsigned int hashIndex=NetworkIDToHashIndex(rawId);
-//	printf("TrackNetworkIDObject hashIndex=%i guid=%s\n",hashIndex, networkIdObject->GetNetworkID().guid.ToString()); // removeme
-	if (networkIdHash[hashIndex]==0)
-	{
-		networkIdHash[hashIndex]=networkIdObject;
-		return;
-	}
-	NetworkIDObject *nio=networkIdHash[hashIndex];
-	// Duplicate insertion?
-	RakAssert(nio!=networkIdObject);
-	// Random GUID conflict?
-	RakAssert(nio->GetNetworkID()!=rawId);
-
-	while (nio->nextInstanceForNetworkIDManager!=0)
-	{		
-		nio=nio->nextInstanceForNetworkIDManager;
-
-		// Duplicate insertion?
-		RakAssert(nio!=networkIdObject);
-		// Random GUID conflict?
-		RakAssert(nio->GetNetworkID()!=rawId);
-	}
-
-	nio->nextInstanceForNetworkIDManager=networkIdObject;
+	// Asserts on duplicate insertion or a random GUID conflict
+	networkIdObjects.Insert(rawId, networkIdObject, _FILE_AND_LINE_);
 }
 void NetworkIDManager::StopTrackingNetworkIDObject(NetworkIDObject *networkIdObject)
 {
@@ -109,30 +75,8 @@ void NetworkIDManager::StopTrackingNetworkIDObject(NetworkIDObject *networkIdObj
 	NetworkID rawId = networkIdObject->GetNetworkID();
 	RakAssert(rawId!=UNASSIGNED_NETWORK_ID);
 
-	// RakAssert(networkIdObject->GetNetworkID()!=UNASSIGNED_NETWORK_ID);
-	unsigned int hashIndex=NetworkIDToHashIndex(rawId);
-//	printf("hashIndex=%i\n",hashIndex); // removeme
-	NetworkIDObject *nio=networkIdHash[hashIndex];
-	if (nio==0)
+	if (networkIdObjects.Remove(rawId, _FILE_AND_LINE_)==false)
 	{
 		RakAssert("NetworkIDManager::StopTrackingNetworkIDObject didn't find object" && 0);
-		return;
-	}
-	if (nio==networkIdObject)
-	{
-		networkIdHash[hashIndex]=nio->nextInstanceForNetworkIDManager;
-		return;
 	}
-
-	while (nio)
-	{
-		if (nio->nextInstanceForNetworkIDManager==networkIdObject)
-		{
-			nio->nextInstanceForNetworkIDManager=networkIdObject->nextInstanceForNetworkIDManager;
-			return;
-		}
-		nio=nio->nextInstanceForNetworkIDManager;
-	}
-
-	RakAssert("NetworkIDManager::StopTrackingNetworkIDObject didn't find object" && 0);
 }
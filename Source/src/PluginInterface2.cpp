@@ -100,6 +100,20 @@ void PluginInterface2::SendUnified( const char * data, const int length, PacketP
 		Update();
 	}
 }
+void PluginInterface2::SendToListUnified( const SLNet::BitStream * bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID *targets, unsigned int numTargets )
+{
+	if (numTargets==0)
+		return;
+
+	if (rakPeerInterface)
+	{
+		rakPeerInterface->SendToList(bitStream,priority,reliability,orderingChannel,targets,numTargets);
+		return;
+	}
+
+	for (unsigned int i=0; i < numTargets; i++)
+		SendUnified(bitStream,priority,reliability,orderingChannel,targets[i],false);
+}
 Packet *PluginInterface2::AllocatePacketUnified(unsigned dataSize)
 {
 	if (rakPeerInterface)
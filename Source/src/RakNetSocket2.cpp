@@ -71,6 +71,11 @@ bool RakNetSocket2::IsBerkleySocket(void) const {
 	return socketType!=RNS2T_CHROME && socketType!=RNS2T_WINDOWS_STORE_8;
 }
 SystemAddress RakNetSocket2::GetBoundAddress(void) const {return boundAddress;}
+void RakNetSocket2::SendBatch( RNS2_SendParameters *sendParameters, unsigned int count, const char *file, unsigned int line )
+{
+	for (unsigned int i=0; i < count; i++)
+		Send(&sendParameters[i], file, line);
+}
 
 RakNetSocket2* RakNetSocket2Allocator::AllocRNS2(void)
 {
@@ -252,6 +257,7 @@ bool IRNS2_Berkley::IsPortInUse(unsigned short port, const char *hostAddress, un
 	bbp.type=type; bbp.protocol=0; bbp.nonBlockingSocket=false;
 	bbp.setBroadcast=false;	bbp.doNotFragment=false; bbp.protocol=0;
 	bbp.setIPHdrIncl=false;
+	bbp.reusePort=false;
 	SystemAddress boundAddress;
 	RNS2_Berkley *rns2 = (RNS2_Berkley*) RakNetSocket2Allocator::AllocRNS2();
 	RNS2BindResult bindResult = rns2->Bind(&bbp, _FILE_AND_LINE_);
@@ -306,6 +312,71 @@ RAK_THREAD_DECLARATION(RNS2_Berkley::RecvFromLoop)
 	b->RecvFromLoopInt();
 	return 0;
 }
+#if RNS2_USE_MMSG==1
+unsigned RNS2_Berkley::RecvFromLoopInt(void)
+{
+	isRecvFromLoopThreadActive.Increment();
+
+#if RNS2_USE_UDP_OFFLOAD==1
+	if (udpGROEnabled)
+	{
+		// Coalesced datagrams do not fit into RNS2RecvStruct, so they are read into these buffers and copied out one datagram at a time
+		char *buffers=(char*) rakMalloc_Ex(RAKNET_SOCKET_BATCH_SIZE*RNS2_GRO_BUFFER_SIZE, _FILE_AND_LINE_);
+		if (buffers != nullptr)
+		{
+			while ( endThreads == false )
+				RecvFromBlockingGRO(buffers);
+			rakFree_Ex(buffers, _FILE_AND_LINE_);
+
+			isRecvFromLoopThreadActive.Decrement();
+			return 0;
+		}
+	}
+#endif
+
+	// Structs not filled by one recvmmsg() call are kept for the next one, so only the ones passed to the event handler are reallocated
+	RNS2RecvStruct *recvFromStructs[RAKNET_SOCKET_BATCH_SIZE];
+	unsigned int numRecvFromStructs=0;
+	while ( endThreads == false )
+	{
+		while (numRecvFromStructs < RAKNET_SOCKET_BATCH_SIZE)
+		{
+			RNS2RecvStruct *recvFromStruct=binding.eventHandler->AllocRNS2RecvStruct(_FILE_AND_LINE_);
+			if (recvFromStruct == nullptr)
+				break;
+			recvFromStruct->socket=this;
+			recvFromStructs[numRecvFromStructs++]=recvFromStruct;
+		}
+		if (numRecvFromStructs == 0)
+			continue;
+
+		unsigned int numReceived = RecvFromBlockingBatch(recvFromStructs, numRecvFromStructs);
+		if (numReceived == 0)
+		{
+			RakSleep(0);
+			continue;
+		}
+
+		for (unsigned int i=0; i < numReceived; i++)
+		{
+			if (recvFromStructs[i]->bytesRead>0)
+			{
+				RakAssert(recvFromStructs[i]->systemAddress.GetPort());
+				binding.eventHandler->OnRNS2Recv(recvFromStructs[i]);
+			}
+			else
+				binding.eventHandler->DeallocRNS2RecvStruct(recvFromStructs[i], _FILE_AND_LINE_);
+		}
+		numRecvFromStructs-=numReceived;
+		memmove(recvFromStructs, recvFromStructs+numReceived, numRecvFromStructs*sizeof(RNS2RecvStruct*));
+	}
+	for (unsigned int i=0; i < numRecvFromStructs; i++)
+		binding.eventHandler->DeallocRNS2RecvStruct(recvFromStructs[i], _FILE_AND_LINE_);
+	isRecvFromLoopThreadActive.Decrement();
+
+	return 0;
+}
+#else
 unsigned RNS2_Berkley::RecvFromLoopInt(void)
 {
 	isRecvFromLoopThreadActive.Increment();
@@ -335,9 +406,14 @@ unsigned RNS2_Berkley::RecvFromLoopInt(void)
 
 	return 0;
 }
+#endif
 RNS2_Berkley::RNS2_Berkley()
 {
 	rns2Socket=(RNS2Socket)INVALID_SOCKET;
+#if RNS2_USE_UDP_OFFLOAD==1
+	udpGSOEnabled=false;
+	udpGROEnabled=false;
+#endif
 }
 RNS2_Berkley::~RNS2_Berkley()
 {
@@ -368,6 +444,12 @@ void RNS2_Berkley::BlockOnStopRecvPollingThread(void)
 {
 	endThreads=true;
 
+#if defined(__linux__)
+	// With SO_REUSEPORT, the datagrams sent below may be delivered to another socket on the same port. Shutting down receives wakes this socket's thread instead
+	if (binding.reusePort)
+		shutdown(rns2Socket, SHUT_RD);
+#endif
+
 	// Get recvfrom to unblock
 	RNS2_SendParameters bsp;
 	unsigned long zero=0;
@@ -418,6 +500,9 @@ SocketLayerOverride* RNS2_Windows::GetSocketLayerOverride(void) {return slo;}
 #else
 RNS2BindResult RNS2_Linux::Bind( RNS2_BerkleyBindParameters *bindParameters, const char *file, unsigned int line ) {return BindShared(bindParameters, file, line);}
 RNS2SendResult RNS2_Linux::Send( RNS2_SendParameters *sendParameters, const char *file, unsigned int line ) {return Send_Windows_Linux_360NoVDP(rns2Socket,sendParameters, file, line);}
+#if RNS2_USE_MMSG==1
+void RNS2_Linux::SendBatch( RNS2_SendParameters *sendParameters, unsigned int count, const char *file, unsigned int line ) {return SendToBatch(sendParameters, count, file, line);}
+#endif
 void RNS2_Linux::GetMyIP( SystemAddress addresses[MAXIMUM_NUMBER_OF_INTERNAL_IDS] ) {return GetMyIP_Windows_Linux(addresses);}
 #endif // Linux
 
@@ -34,6 +34,16 @@
 
 #include "slikenet/Itoa.h"
 
+#if RNS2_USE_UDP_OFFLOAD==1
+#include <netinet/udp.h>           // used for UDP_SEGMENT and UDP_GRO
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
+
 void RNS2_Berkley::SetSocketOptions(void)
 {
 	int r;
@@ -57,6 +67,10 @@ void RNS2_Berkley::SetSocketOptions(void)
 	r = setsockopt__( rns2Socket, SOL_SOCKET, SO_SNDBUF, ( char * ) & sock_opt, sizeof ( sock_opt ) );
 	RakAssert(r==0);
 
+#if RNS2_USE_UDP_OFFLOAD==1
+	SetUDPOffloadSocketOptions();
+#endif
+
 }
 
 void RNS2_Berkley::SetNonBlockingSocket(unsigned long nonblocking)
@@ -72,6 +86,14 @@ void RNS2_Berkley::SetBroadcastSocket(int broadcast)
 {
 	setsockopt__( rns2Socket, SOL_SOCKET, SO_BROADCAST, ( char * ) & broadcast, sizeof( broadcast ) );
 }
+void RNS2_Berkley::SetReusePortSocket(int reusePort)
+{
+#if defined(SO_REUSEPORT)
+	setsockopt__( rns2Socket, SOL_SOCKET, SO_REUSEPORT, ( char * ) & reusePort, sizeof( reusePort ) );
+#else
+	(void) reusePort;
+#endif
+}
 void RNS2_Berkley::SetIPHdrIncl(int ipHdrIncl)
 {
 
@@ -176,6 +198,8 @@ RNS2BindResult RNS2_Berkley::BindSharedIPV4( RNS2_BerkleyBindParameters *bindPar
 	rns2Socket = (int) socket__( bindParameters->addressFamily, bindParameters->type, bindParameters->protocol );
 	if (rns2Socket == -1)
 		return BR_FAILED_TO_BIND_SOCKET;
+	if (bindParameters->reusePort)
+		SetReusePortSocket(1);
 
 	SetSocketOptions();
 	SetNonBlockingSocket(bindParameters->nonBlockingSocket);
@@ -286,6 +310,8 @@ RNS2BindResult RNS2_Berkley::BindSharedIPV4And6( RNS2_BerkleyBindParameters *bin
 
 		if (rns2Socket == -1)
 			return BR_FAILED_TO_BIND_SOCKET;
+		if (bindParameters->reusePort)
+			SetReusePortSocket(1);
 
 		ret = bind__(rns2Socket, aip->ai_addr, (int) aip->ai_addrlen );
 		if (ret>=0)
@@ -452,6 +478,240 @@ void RNS2_Berkley::RecvFromBlocking(RNS2RecvStruct *recvFromStruct)
 #endif
 }
 
+#if RNS2_USE_MMSG==1
+static void SetSystemAddressFromSockAddr(SystemAddress *systemAddress, const sockaddr_storage *their_addr)
+{
+	if (their_addr->ss_family==AF_INET)
+	{
+		memcpy(&systemAddress->address.addr4,(const sockaddr_in *)their_addr,sizeof(sockaddr_in));
+		systemAddress->debugPort=ntohs(systemAddress->address.addr4.sin_port);
+	}
+#if RAKNET_SUPPORT_IPV6==1
+	else
+	{
+		memcpy(&systemAddress->address.addr6,(const sockaddr_in6 *)their_addr,sizeof(sockaddr_in6));
+		systemAddress->debugPort=ntohs(systemAddress->address.addr6.sin6_port);
+	}
+#endif
+}
+
+unsigned int RNS2_Berkley::RecvFromBlockingBatch(RNS2RecvStruct **recvFromStructs, unsigned int count)
+{
+	mmsghdr msgs[RAKNET_SOCKET_BATCH_SIZE];
+	iovec iovecs[RAKNET_SOCKET_BATCH_SIZE];
+	sockaddr_storage their_addrs[RAKNET_SOCKET_BATCH_SIZE];
+	RakAssert(count<=RAKNET_SOCKET_BATCH_SIZE);
+
+	memset(msgs,0,sizeof(mmsghdr)*count);
+	for (unsigned int i=0; i < count; i++)
+	{
+		iovecs[i].iov_base=recvFromStructs[i]->data;
+		iovecs[i].iov_len=sizeof(recvFromStructs[i]->data);
+		msgs[i].msg_hdr.msg_iov=&iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen=1;
+		msgs[i].msg_hdr.msg_name=&their_addrs[i];
+		msgs[i].msg_hdr.msg_namelen=sizeof(sockaddr_storage);
+	}
+
+	// MSG_WAITFORONE: block for the first datagram only
+	int numReceived = recvmmsg(rns2Socket, msgs, count, MSG_WAITFORONE, nullptr);
+	if (numReceived<=0)
+		return 0;
+	SLNet::TimeUS timeRead = SLNet::GetTimeUS();
+
+	for (int i=0; i < numReceived; i++)
+	{
+		recvFromStructs[i]->bytesRead=(int) msgs[i].msg_len;
+		recvFromStructs[i]->timeRead=timeRead;
+		SetSystemAddressFromSockAddr(&recvFromStructs[i]->systemAddress, &their_addrs[i]);
+	}
+
+	return (unsigned int) numReceived;
+}
+
+#if RNS2_USE_UDP_OFFLOAD==1
+void RNS2_Berkley::SetUDPOffloadSocketOptions(void)
+{
+	// UDP_SEGMENT is passed with each send. Kernels without UDP GSO fail getsockopt() with ENOPROTOOPT
+	int segmentSize=0;
+	socklen_t optLen=sizeof(segmentSize);
+	udpGSOEnabled = getsockopt__(rns2Socket, SOL_UDP, UDP_SEGMENT, ( char * ) & segmentSize, &optLen)==0;
+
+	int enable=1;
+	udpGROEnabled = setsockopt__(rns2Socket, SOL_UDP, UDP_GRO, ( char * ) & enable, sizeof(enable))==0;
+}
+
+void RNS2_Berkley::RecvFromBlockingGRO(char *buffers)
+{
+	mmsghdr msgs[RAKNET_SOCKET_BATCH_SIZE];
+	iovec iovecs[RAKNET_SOCKET_BATCH_SIZE];
+	sockaddr_storage their_addrs[RAKNET_SOCKET_BATCH_SIZE];
+	char controls[RAKNET_SOCKET_BATCH_SIZE][CMSG_SPACE(sizeof(int))];
+
+	memset(msgs,0,sizeof(msgs));
+	for (unsigned int i=0; i < RAKNET_SOCKET_BATCH_SIZE; i++)
+	{
+		iovecs[i].iov_base=buffers+i*RNS2_GRO_BUFFER_SIZE;
+		iovecs[i].iov_len=RNS2_GRO_BUFFER_SIZE;
+		msgs[i].msg_hdr.msg_iov=&iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen=1;
+		msgs[i].msg_hdr.msg_name=&their_addrs[i];
+		msgs[i].msg_hdr.msg_namelen=sizeof(sockaddr_storage);
+		msgs[i].msg_hdr.msg_control=controls[i];
+		msgs[i].msg_hdr.msg_controllen=sizeof(controls[i]);
+	}
+
+	int numReceived = recvmmsg(rns2Socket, msgs, RAKNET_SOCKET_BATCH_SIZE, MSG_WAITFORONE, nullptr);
+	if (numReceived<=0)
+	{
+		RakSleep(0);
+		return;
+	}
+	SLNet::TimeUS timeRead = SLNet::GetTimeUS();
+
+	for (int i=0; i < numReceived; i++)
+	{
+		const char *data=(const char*) iovecs[i].iov_base;
+		int length=(int) msgs[i].msg_len;
+
+		// Coalesced datagrams carry the size of each datagram, all but the last of which have that size
+		int segmentSize=length;
+		for (cmsghdr *cmsg=CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg!=nullptr; cmsg=CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg))
+		{
+			if (cmsg->cmsg_level==SOL_UDP && cmsg->cmsg_type==UDP_GRO)
+				memcpy(&segmentSize, CMSG_DATA(cmsg), sizeof(segmentSize));
+		}
+		if (segmentSize<=0 || segmentSize>MAXIMUM_MTU_SIZE)
+			continue;
+
+		SystemAddress systemAddress;
+		SetSystemAddressFromSockAddr(&systemAddress, &their_addrs[i]);
+		RakAssert(systemAddress.GetPort());
+
+		for (int offset=0; offset < length; offset+=segmentSize)
+		{
+			RNS2RecvStruct *recvFromStruct=binding.eventHandler->AllocRNS2RecvStruct(_FILE_AND_LINE_);
+			if (recvFromStruct == nullptr)
+				break;
+			recvFromStruct->bytesRead = length-offset < segmentSize ? length-offset : segmentSize;
+			memcpy(recvFromStruct->data, data+offset, (size_t) recvFromStruct->bytesRead);
+			recvFromStruct->systemAddress=systemAddress;
+			recvFromStruct->timeRead=timeRead;
+			recvFromStruct->socket=this;
+			binding.eventHandler->OnRNS2Recv(recvFromStruct);
+		}
+	}
+}
+
+// How many datagrams from the start of sendParameters one UDP_SEGMENT send can carry
+// They must go to the same system, and all but the last must be exactly as long as the first. The last can be shorter
+static unsigned int GetUDPSegmentCount(const RNS2_SendParameters *sendParameters, unsigned int count)
+{
+	const int segmentSize=sendParameters[0].length;
+	int totalLength=segmentSize;
+	unsigned int segmentCount=1;
+	while (segmentCount < count &&
+		segmentCount < RNS2_GSO_MAX_SEGMENTS &&
+		sendParameters[segmentCount-1].length==segmentSize &&
+		sendParameters[segmentCount].length<=segmentSize &&
+		totalLength+sendParameters[segmentCount].length<=RNS2_GSO_MAX_BYTES &&
+		sendParameters[segmentCount].systemAddress==sendParameters[0].systemAddress)
+	{
+		totalLength+=sendParameters[segmentCount].length;
+		segmentCount++;
+	}
+	return segmentCount;
+}
+#endif // RNS2_USE_UDP_OFFLOAD==1
+
+void RNS2_Berkley::SendToBatch( RNS2_SendParameters *sendParameters, unsigned int count, const char *file, unsigned int line )
+{
+	mmsghdr msgs[RAKNET_SOCKET_BATCH_SIZE];
+	iovec iovecs[RAKNET_SOCKET_BATCH_SIZE];
+	// msgs[i] carries sendParameters[firstDatagram[i]] up to, but not including, sendParameters[firstDatagram[i+1]]
+	unsigned int firstDatagram[RAKNET_SOCKET_BATCH_SIZE+1];
+#if RNS2_USE_UDP_OFFLOAD==1
+	char controls[RAKNET_SOCKET_BATCH_SIZE][CMSG_SPACE(sizeof(uint16_t))];
+#endif
+	RakAssert(count<=RAKNET_SOCKET_BATCH_SIZE);
+
+	memset(msgs,0,sizeof(mmsghdr)*count);
+	unsigned int numMsgs=0;
+	unsigned int i=0;
+	while (i < count)
+	{
+		unsigned int numDatagrams=1;
+#if RNS2_USE_UDP_OFFLOAD==1
+		if (udpGSOEnabled)
+			numDatagrams=GetUDPSegmentCount(sendParameters+i, count-i);
+#endif
+
+		for (unsigned int j=i; j < i+numDatagrams; j++)
+		{
+			// Per datagram TTL is only supported by Send()
+			RakAssert(sendParameters[j].ttl==0);
+			iovecs[j].iov_base=sendParameters[j].data;
+			iovecs[j].iov_len=(size_t) sendParameters[j].length;
+		}
+
+		msghdr &msg=msgs[numMsgs].msg_hdr;
+		msg.msg_iov=&iovecs[i];
+		msg.msg_iovlen=numDatagrams;
+		if (sendParameters[i].systemAddress.address.addr4.sin_family==AF_INET)
+		{
+			msg.msg_name=&sendParameters[i].systemAddress.address.addr4;
+			msg.msg_namelen=sizeof(sockaddr_in);
+		}
+#if RAKNET_SUPPORT_IPV6==1
+		else
+		{
+			msg.msg_name=&sendParameters[i].systemAddress.address.addr6;
+			msg.msg_namelen=sizeof(sockaddr_in6);
+		}
+#endif
+
+#if RNS2_USE_UDP_OFFLOAD==1
+		if (numDatagrams>1)
+		{
+			// The kernel splits the payload back into datagrams of this size
+			msg.msg_control=controls[numMsgs];
+			msg.msg_controllen=sizeof(controls[numMsgs]);
+			cmsghdr *cmsg=CMSG_FIRSTHDR(&msg);
+			cmsg->cmsg_level=SOL_UDP;
+			cmsg->cmsg_type=UDP_SEGMENT;
+			cmsg->cmsg_len=CMSG_LEN(sizeof(uint16_t));
+			uint16_t segmentSize=(uint16_t) sendParameters[i].length;
+			memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+		}
+#endif
+
+		firstDatagram[numMsgs++]=i;
+		i+=numDatagrams;
+	}
+	firstDatagram[numMsgs]=count;
+
+	unsigned int numSent=0;
+	while (numSent < numMsgs)
+	{
+		int r = sendmmsg(rns2Socket, msgs+numSent, numMsgs-numSent, 0);
+		if (r<=0)
+		{
+#if RNS2_USE_UDP_OFFLOAD==1
+			// For example EIO if the device cannot checksum segmented datagrams. Do not try again on this socket
+			if (msgs[numSent].msg_hdr.msg_iovlen>1 && (errno==EIO || errno==EINVAL || errno==ENOPROTOOPT || errno==EOPNOTSUPP))
+				udpGSOEnabled=false;
+#endif
+			// sendmmsg() stops at the first message that fails. Send its datagrams by themselves, which reports the error, and continue after it
+			for (unsigned int j=firstDatagram[numSent]; j < firstDatagram[numSent+1]; j++)
+				Send(&sendParameters[j], file, line);
+			numSent++;
+		}
+		else
+			numSent+=(unsigned int) r;
+	}
+}
+#endif // RNS2_USE_MMSG==1
+
 #endif // !defined(WINDOWS_STORE_RT) && !defined(__native_client__)
 
 #endif // file header
@@ -179,6 +179,47 @@ void RAK_DLL_EXPORT SLNet::StatisticsToString(RakNetStatistics *s, char *buffer,
 				100.0f * s->valueOverLastSecond[ACTUAL_BYTES_SENT] / s->BPSLimitByOutgoingBandwidthLimit
 			);
 #pragma warning(push)
+#pragma warning(disable:4996)
+			strcat(buffer, buff2);
+#pragma warning(pop)
+		}
+		if (s->memoryBytesReserved != 0)
+		{
+			char buff2[256];
+			sprintf_s(buff2,
+				"Connection memory in use         %" PRINTF_64_BIT_MODIFIER "u of %" PRINTF_64_BIT_MODIFIER "u reserved\n"
+				"Connection memory budget         %" PRINTF_64_BIT_MODIFIER "u\n"
+				"Messages refused by budget       %" PRINTF_64_BIT_MODIFIER "u\n",
+				(long long unsigned int) s->memoryBytesInUse,
+				(long long unsigned int) s->memoryBytesReserved,
+				(long long unsigned int) s->memoryBudget,
+				(long long unsigned int) s->messagesRefusedByMemoryBudget
+			);
+#pragma warning(push)
+#pragma warning(disable:4996)
+			strcat(buffer, buff2);
+#pragma warning(pop)
+		}
+		if (s->pacingBytesPerSecond != 0)
+		{
+			char buff2[128];
+			sprintf_s(buff2,
+				"Pacing rate                      %" PRINTF_64_BIT_MODIFIER "u bytes per second\n",
+				(long long unsigned int) s->pacingBytesPerSecond
+			);
+#pragma warning(push)
+#pragma warning(disable:4996)
+			strcat(buffer, buff2);
+#pragma warning(pop)
+		}
+		{
+			char buff2[128];
+			sprintf_s(buff2,
+				"Datagrams per burst              %u last, %u largest\n",
+				s->lastBurstDatagrams,
+				s->largestBurstDatagrams
+			);
+#pragma warning(push)
 #pragma warning(disable:4996)
 			strcat(buffer, buff2);
 #pragma warning(pop)
@@ -315,5 +356,37 @@ void RAK_DLL_EXPORT SLNet::StatisticsToString( RakNetStatistics *s, char *buffer
 				);
 			strcat_s(buffer,bufferLength,buff2);
 		}
+		if (s->memoryBytesReserved!=0)
+		{
+			char buff2[256];
+			sprintf_s(buff2,
+				"Connection memory in use         %" PRINTF_64_BIT_MODIFIER "u of %" PRINTF_64_BIT_MODIFIER "u reserved\n"
+				"Connection memory budget         %" PRINTF_64_BIT_MODIFIER "u\n"
+				"Messages refused by budget       %" PRINTF_64_BIT_MODIFIER "u\n",
+				(long long unsigned int) s->memoryBytesInUse,
+				(long long unsigned int) s->memoryBytesReserved,
+				(long long unsigned int) s->memoryBudget,
+				(long long unsigned int) s->messagesRefusedByMemoryBudget
+				);
+			strcat_s(buffer,bufferLength,buff2);
+		}
+		if (s->pacingBytesPerSecond!=0)
+		{
+			char buff2[128];
+			sprintf_s(buff2,
+				"Pacing rate                      %" PRINTF_64_BIT_MODIFIER "u bytes per second\n",
+				(long long unsigned int) s->pacingBytesPerSecond
+				);
+			strcat_s(buffer,bufferLength,buff2);
+		}
+		{
+			char buff2[128];
+			sprintf_s(buff2,
+				"Datagrams per burst              %u last, %u largest\n",
+				s->lastBurstDatagrams,
+				s->largestBurstDatagrams
+				);
+			strcat_s(buffer,bufferLength,buff2);
+		}
 	}
 }
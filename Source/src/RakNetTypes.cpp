@@ -107,6 +107,7 @@ SocketDescriptor::SocketDescriptor() {
 	remotePortRakNetWasStartedOn_PS3_PSP2=0;
 	extraSocketOptions=0;
 	socketFamily=AF_INET;
+	reusePortSocketCount=1;
 }
 SocketDescriptor::SocketDescriptor(unsigned short _port, const char *_hostAddress)
 {
@@ -123,6 +124,7 @@ SocketDescriptor::SocketDescriptor(unsigned short _port, const char *_hostAddres
 		hostAddress[0]=0;
 	extraSocketOptions=0;
 	socketFamily=AF_INET;
+	reusePortSocketCount=1;
 }
 
 // Defaults to not in peer to peer mode for NetworkIDs.  This only sends the localSystemAddress portion in the BitStream class
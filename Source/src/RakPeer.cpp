@@ -53,6 +53,7 @@
 #include "slikenet/assert.h"
 #include "slikenet/version.h"
 #include "slikenet/NetworkIDManager.h"
+#include "slikenet/SharedSendBuffer.h"
 #include "slikenet/gettimeofday.h"
 #include "slikenet/SignaledEvent.h"
 #include "slikenet/SuperFastHash.h"
@@ -74,6 +75,7 @@
 namespace SLNet
 {
 RAK_THREAD_DECLARATION(UpdateNetworkLoop);
+RAK_THREAD_DECLARATION(UpdateShardLoop);
 RAK_THREAD_DECLARATION(RecvFromLoop);
 RAK_THREAD_DECLARATION(UDTConnect);
 }
@@ -140,6 +142,25 @@ struct PacketFollowedByData
 	unsigned char data[1];
 };
 
+#if LIBCAT_SECURITY==1
+// The handshake objects are not thread-safe, so each worker thread answers challenges with its own
+struct SecureHandshakeWorker
+{
+	cat::ServerEasyHandshake handshake;
+	bool initialized;
+};
+static void* AllocateSecureHandshakeWorker(void)
+{
+	SecureHandshakeWorker *worker=SLNet::OP_NEW<SecureHandshakeWorker>(_FILE_AND_LINE_);
+	worker->initialized=false;
+	return worker;
+}
+static void FreeSecureHandshakeWorker(void *worker)
+{
+	SLNet::OP_DELETE((SecureHandshakeWorker*) worker, _FILE_AND_LINE_);
+}
+#endif
+
 Packet *RakPeer::AllocPacket(unsigned dataSize, const char *file, unsigned int line)
 {
 	// Crashes when dataSize is 4 bytes - not sure why
@@ -153,9 +174,7 @@ Packet *RakPeer::AllocPacket(unsigned dataSize, const char *file, unsigned int l
 // 	return p;
 
 	SLNet::Packet *p;
-	packetAllocationPoolMutex.Lock();
 	p = packetAllocationPool.Allocate(file,line);
-	packetAllocationPoolMutex.Unlock();
 	p = new ((void*)p) Packet;
 	p->data=(unsigned char*) rakMalloc_Ex(dataSize,file,line);
 	p->length=dataSize;
@@ -170,9 +189,7 @@ Packet *RakPeer::AllocPacket(unsigned dataSize, unsigned char *data, const char
 {
 	// Packet *p = (Packet *)rakMalloc_Ex(sizeof(Packet), file, line);
 	SLNet::Packet *p;
-	packetAllocationPoolMutex.Lock();
 	p = packetAllocationPool.Allocate(file,line);
-	packetAllocationPoolMutex.Unlock();
 	p = new ((void*)p) Packet;
 	RakAssert(p);
 	p->data=data;
@@ -197,6 +214,13 @@ RakPeer::RakPeer()
 	_using_security = false;
 	_server_handshake = 0;
 	_cookie_jar = 0;
+	secureHandshakeThreadCount = 0;
+	maxSecureHandshakeQueueLength = 1024;
+	secureHandshakeQueueLength = 0;
+	maxSecureHandshakeQueueLengthReached = 0;
+	secureHandshakesAnswered = 0;
+	secureHandshakesFailed = 0;
+	secureHandshakesDropped = 0;
 #endif
 
 	StringCompressor::AddReference();
@@ -212,6 +236,7 @@ RakPeer::RakPeer()
 	activeSystemList = 0;
 	activeSystemListSize=0;
 	remoteSystemLookup=0;
+	memset(receivePluginListOffsets,0,sizeof(receivePluginListOffsets));
 	bytesSentPerSecond = bytesReceivedPerSecond = 0;
 	endThreads = true;
 	isMainLoopThreadActive = false;
@@ -237,10 +262,19 @@ RakPeer::RakPeer()
 	//unreliableTimeout=0;
 	unreliableTimeout=1000;
 	maxOutgoingBPS=0;
+	perConnectionMemoryBudget=0;
+	defaultCongestionControl=DEFAULT_CONGESTION_CONTROL;
+	perConnectionPacing=0;
 	firstExternalID=UNASSIGNED_SYSTEM_ADDRESS;
 	myGuid=UNASSIGNED_RAKNET_GUID;
 	userUpdateThreadPtr=0;
 	userUpdateThreadData=0;
+	updateShardCount=1;
+	requestedUpdateShardCount=1;
+	updateShards=0;
+	updateShardsPending=0;
+	updateShardsTime=0;
+	updateShardsForceACKs=false;
 
 #ifdef _DEBUG
 	// Wait longer to disconnect in debug so I don't get disconnected while tracing
@@ -256,11 +290,11 @@ RakPeer::RakPeer()
 #endif
 
 	bufferedCommands.SetPageSize(sizeof(BufferedCommandStruct)*16);
+	bufferedCommands.SetRingSize(RAKPEER_THREAD_QUEUE_RING_SIZE);
 	socketQueryOutput.SetPageSize(sizeof(SocketQueryOutput)*8);
 
-	packetAllocationPoolMutex.Lock();
 	packetAllocationPool.SetPageSize(sizeof(DataStructures::MemoryPool<Packet>::MemoryWithPage)*32);
-	packetAllocationPoolMutex.Unlock();
+	packetReturnQueue.SetRingSize(RAKPEER_THREAD_QUEUE_RING_SIZE);
 
 	remoteSystemIndexPool.SetPageSize(sizeof(DataStructures::MemoryPool<RemoteSystemIndex>::MemoryWithPage)*32);
 
@@ -309,6 +343,7 @@ RakPeer::RakPeer()
 	GenerateGUID();
 
 	quitAndDataEvents.InitEvent();
+	updateShardsDoneEvent.InitEvent();
 	limitConnectionFrequencyFromTheSameIP=false;
 	ResetSendReceipt();
 }
@@ -328,6 +363,7 @@ RakPeer::~RakPeer()
 	WSAStartupSingleton::Deref();
 
 	quitAndDataEvents.CloseEvent();
+	updateShardsDoneEvent.CloseEvent();
 
 #if LIBCAT_SECURITY==1
 	// Encryption and security
@@ -508,6 +544,7 @@ StartupResult RakPeer::Startup( unsigned int maxConnections, SocketDescriptor *s
 			bbp.pollingThreadPriority=threadPriority;
 			bbp.eventHandler=this;
 			bbp.remotePortRakNetWasStartedOn_PS3_PS4_PSP2=socketDescriptors[i].remotePortRakNetWasStartedOn_PS3_PSP2;
+			bbp.reusePort=socketDescriptors[i].reusePortSocketCount>1;
 			RNS2BindResult br = ((RNS2_Berkley*) r2)->Bind(&bbp, _FILE_AND_LINE_);
 
 			if (
@@ -573,8 +610,39 @@ StartupResult RakPeer::Startup( unsigned int maxConnections, SocketDescriptor *s
 
 	}
 
-#if !defined(__native_client__) && !defined(WINDOWS_STORE_RT)
+#if defined(__linux__) && defined(SO_REUSEPORT)
+	// Extra sockets on the port of socketList[i] go after all the sockets created above, so that socketList[i] stays the socket of socketDescriptors[i]
+	// Remote systems that connect are answered on the socket their datagrams arrived on, see AssignSystemAddressToRemoteSystemList()
 	for (i=0; i<socketDescriptorCount; i++)
+	{
+		if (socketList[i]->IsBerkleySocket()==false)
+			continue;
+
+		for (unsigned int reusePortSocketIndex=1; reusePortSocketIndex < socketDescriptors[i].reusePortSocketCount; reusePortSocketIndex++)
+		{
+			RakNetSocket2 *r2 = RakNetSocket2Allocator::AllocRNS2();
+			r2->SetUserConnectionSocketIndex(i);
+
+			RNS2_BerkleyBindParameters bbp;
+			memcpy(&bbp, ((RNS2_Berkley*) socketList[i])->GetBindings(), sizeof(RNS2_BerkleyBindParameters));
+			// The first socket may have been bound to port 0
+			bbp.port=socketList[i]->GetBoundAddress().GetPort();
+			bbp.hostAddress=(char*) socketDescriptors[i].hostAddress;
+			RNS2BindResult br = ((RNS2_Berkley*) r2)->Bind(&bbp, _FILE_AND_LINE_);
+			if (br!=BR_SUCCESS)
+			{
+				RakNetSocket2Allocator::DeallocRNS2(r2);
+				DerefAllSockets();
+				return SOCKET_PORT_ALREADY_IN_USE;
+			}
+
+			socketList.Push(r2, _FILE_AND_LINE_ );
+		}
+	}
+#endif
+
+#if !defined(__native_client__) && !defined(WINDOWS_STORE_RT)
+	for (i=0; i<socketList.Size(); i++)
 	{
 		if (socketList[i]->IsBerkleySocket())
 			((RNS2_Berkley*) socketList[i])->CreateRecvPollingThread(threadPriority);
@@ -629,6 +697,7 @@ StartupResult RakPeer::Startup( unsigned int maxConnections, SocketDescriptor *s
 			remoteSystemList[ i ].connectMode=RemoteSystemStruct::NO_ACTION;
 			remoteSystemList[ i ].MTUSize = defaultMTUSize;
 			remoteSystemList[ i ].remoteSystemIndex = (SystemIndex) i;
+			remoteSystemList[ i ].reliabilityLayer.SetArenaPagePool(&arenaPagePool);
 #ifdef _DEBUG
 			remoteSystemList[ i ].reliabilityLayer.ApplyNetworkSimulator(_packetloss, _minExtraPing, _extraPingVariance);
 #endif
@@ -657,6 +726,26 @@ StartupResult RakPeer::Startup( unsigned int maxConnections, SocketDescriptor *s
 		ClearBufferedPackets();
 		ClearSocketQueryOutput();
 
+		if (StartUpdateShards(threadPriority)==false)
+		{
+			Shutdown( 0, 0 );
+			return FAILED_TO_CREATE_NETWORK_THREAD;
+		}
+
+#if LIBCAT_SECURITY==1
+		secureHandshakeQueueLength=0;
+		maxSecureHandshakeQueueLengthReached=0;
+		secureHandshakesAnswered=0;
+		secureHandshakesFailed=0;
+		secureHandshakesDropped=0;
+		if (_using_security && secureHandshakeThreadCount>0 &&
+			secureHandshakeThreadPool.StartThreads(secureHandshakeThreadCount, 0, AllocateSecureHandshakeWorker, FreeSecureHandshakeWorker)==false)
+		{
+			Shutdown( 0, 0 );
+			return FAILED_TO_CREATE_NETWORK_THREAD;
+		}
+#endif
+
 		if ( isMainLoopThreadActive == false )
 		{
 #if RAKPEER_USER_THREADED!=1
@@ -792,6 +881,7 @@ bool RakPeer::InitializeSecurity(const char *public_key, const char *private_key
 		_server_handshake->FillCookieJar(_cookie_jar);
 
 		memcpy(my_public_key, public_key, sizeof(my_public_key));
+		memcpy(my_private_key, private_key, sizeof(my_private_key));
 
 		_using_security = true;
 		return true;
@@ -888,6 +978,46 @@ bool RakPeer::IsInSecurityExceptionList(const char *ip)
 	securityExceptionMutex.Unlock();
 	return false;
 }
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void RakPeer::SetSecureHandshakeThreads( unsigned int numberOfThreads, unsigned int maxQueueLength )
+{
+#if LIBCAT_SECURITY==1
+	if (maxQueueLength==0)
+		maxQueueLength=1;
+	secureHandshakeThreadCount=numberOfThreads;
+	maxSecureHandshakeQueueLength=maxQueueLength;
+#else
+	(void) numberOfThreads;
+	(void) maxQueueLength;
+#endif
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void RakPeer::GetSecureHandshakeStatistics( uint32_t *answeredCount, uint32_t *failedCount, uint32_t *droppedCount, unsigned int *queueLength, unsigned int *maxQueueLength )
+{
+#if LIBCAT_SECURITY==1
+	if (answeredCount)
+		*answeredCount=secureHandshakesAnswered;
+	if (failedCount)
+		*failedCount=secureHandshakesFailed;
+	if (droppedCount)
+		*droppedCount=secureHandshakesDropped;
+	if (queueLength)
+		*queueLength=secureHandshakeQueueLength;
+	if (maxQueueLength)
+		*maxQueueLength=maxSecureHandshakeQueueLengthReached;
+#else
+	if (answeredCount)
+		*answeredCount=0;
+	if (failedCount)
+		*failedCount=0;
+	if (droppedCount)
+		*droppedCount=0;
+	if (queueLength)
+		*queueLength=0;
+	if (maxQueueLength)
+		*maxQueueLength=0;
+#endif
+}
 
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Description:
@@ -1091,10 +1221,11 @@ void RakPeer::Shutdown( unsigned int blockDuration, unsigned char orderingChanne
 		pluginListNTS[i]->OnRakPeerShutdown();
 	}
 
-	quitAndDataEvents.SetEvent();
-
+	// Set endThreads first, or UpdateNetworkLoop could wake up, miss it, and sleep again
 	endThreads = true;
 
+	quitAndDataEvents.SetEvent();
+
 //	SLNet::TimeMS timeout;
 #if RAKPEER_USER_THREADED!=1
 
@@ -1151,6 +1282,11 @@ void RakPeer::Shutdown( unsigned int blockDuration, unsigned char orderingChanne
 
 #endif // RAKPEER_USER_THREADED!=1
 
+	StopUpdateShards();
+#if LIBCAT_SECURITY==1
+	StopSecureHandshakeThreads();
+#endif
+
 //	char c=0;
 //	unsigned int socketIndex;
 	// remoteSystemList in Single thread
@@ -1172,14 +1308,11 @@ void RakPeer::Shutdown( unsigned int blockDuration, unsigned char orderingChanne
 	//remoteSystemListSize = 0;
 
 	// Free any packets the user didn't deallocate
-	packetReturnMutex.Lock();
-	for (i=0; i < packetReturnQueue.Size(); i++)
-		DeallocatePacket(packetReturnQueue[i]);
+	Packet *packet;
+	while (packetReturnQueue.Pop(packet))
+		DeallocatePacket(packet);
 	packetReturnQueue.Clear(_FILE_AND_LINE_);
-	packetReturnMutex.Unlock();
-	packetAllocationPoolMutex.Lock();
 	packetAllocationPool.Clear(_FILE_AND_LINE_);
-	packetAllocationPoolMutex.Unlock();
 
 	/*
 	if (isRecvFromLoopThreadActive.GetValue()>0)
@@ -1208,6 +1341,7 @@ void RakPeer::Shutdown( unsigned int blockDuration, unsigned char orderingChanne
 	SLNet::OP_DELETE_ARRAY(temp, _FILE_AND_LINE_);
 	SLNet::OP_DELETE_ARRAY(activeSystemList, _FILE_AND_LINE_);
 	activeSystemList=0;
+	arenaPagePool.Clear(_FILE_AND_LINE_);
 
 	ClearRemoteSystemLookup();
 
@@ -1321,6 +1455,9 @@ uint32_t RakPeer::Send( const char *data, const int length, PacketPriority prior
 	if ( broadcast == false && systemIdentifier.IsUndefined())
 		return 0;
 
+	if ( broadcast == false && IsOverMemoryBudget(systemIdentifier) )
+		return 0;
+
 	uint32_t usedSendReceipt;
 	if (forceReceiptNumber!=0)
 		usedSendReceipt=forceReceiptNumber;
@@ -1380,6 +1517,9 @@ uint32_t RakPeer::Send( const SLNet::BitStream * bitStream, PacketPriority prior
 	if ( broadcast == false && systemIdentifier.IsUndefined() )
 		return 0;
 
+	if ( broadcast == false && IsOverMemoryBudget(systemIdentifier) )
+		return 0;
+
 	uint32_t usedSendReceipt;
 	if (forceReceiptNumber!=0)
 		usedSendReceipt=forceReceiptNumber;
@@ -1406,6 +1546,147 @@ uint32_t RakPeer::Send( const SLNet::BitStream * bitStream, PacketPriority prior
 	SendBuffered((const char*)bitStream->GetData(), bitStream->GetNumberOfBitsUsed(), priority, reliability, orderingChannel, systemIdentifier, broadcast, RemoteSystemStruct::NO_ACTION, usedSendReceipt);
 
 
+	return usedSendReceipt;
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t RakPeer::Send( SharedSendBuffer *sharedSendBuffer, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, uint32_t forceReceiptNumber )
+{
+#ifdef _DEBUG
+	RakAssert( sharedSendBuffer && sharedSendBuffer->GetNumberOfBits() > 0 );
+#endif
+
+	RakAssert( !( reliability >= NUMBER_OF_RELIABILITIES || reliability < 0 ) );
+	RakAssert( !( priority > NUMBER_OF_PRIORITIES || priority < 0 ) );
+	RakAssert( !( orderingChannel >= NUMBER_OF_ORDERED_STREAMS ) );
+
+	if ( sharedSendBuffer == 0 || sharedSendBuffer->GetNumberOfBits() == 0 )
+		return 0;
+
+	if ( remoteSystemList == 0 || endThreads == true )
+		return 0;
+
+	if ( broadcast == false && systemIdentifier.IsUndefined() )
+		return 0;
+
+	if ( broadcast == false && IsOverMemoryBudget(systemIdentifier) )
+		return 0;
+
+	uint32_t usedSendReceipt;
+	if (forceReceiptNumber!=0)
+		usedSendReceipt=forceReceiptNumber;
+	else
+		usedSendReceipt=IncrementNextSendReceipt();
+
+	if (broadcast==false && IsLoopbackAddress(systemIdentifier,true))
+	{
+		SendLoopback((const char*) sharedSendBuffer->GetData(),(int) BITS_TO_BYTES(sharedSendBuffer->GetNumberOfBits()));
+		if (reliability>=UNRELIABLE_WITH_ACK_RECEIPT)
+		{
+			char buff[5];
+			buff[0]=ID_SND_RECEIPT_ACKED;
+			sendReceiptSerialMutex.Lock();
+			memcpy(buff+1, &sendReceiptSerial,4);
+			sendReceiptSerialMutex.Unlock();
+			SendLoopback( buff, 5 );
+		}
+		return usedSendReceipt;
+	}
+
+	// Released by the update thread once the reliability layers took their references
+	sharedSendBuffer->AddReference();
+	SendBuffered((const char*)sharedSendBuffer->GetData(), sharedSendBuffer->GetNumberOfBits(), priority, reliability, orderingChannel, systemIdentifier, broadcast, RemoteSystemStruct::NO_ACTION, usedSendReceipt, sharedSendBuffer);
+
+	return usedSendReceipt;
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t RakPeer::SendToList( const SLNet::BitStream * bitStream, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID *targets, unsigned int numTargets, uint32_t forceReceiptNumber )
+{
+#ifdef _DEBUG
+	RakAssert( bitStream->GetNumberOfBytesUsed() > 0 );
+#endif
+
+	if ( bitStream->GetNumberOfBytesUsed() == 0 || numTargets == 0 )
+		return 0;
+
+	if ( remoteSystemList == 0 || endThreads == true )
+		return 0;
+
+	// The only copy of the data. Every system references it
+	SharedSendBuffer *sharedSendBuffer = SharedSendBuffer::Allocate(bitStream->GetNumberOfBytesUsed(), _FILE_AND_LINE_);
+	if (sharedSendBuffer==0)
+	{
+		notifyOutOfMemory(_FILE_AND_LINE_);
+		return 0;
+	}
+	memcpy(sharedSendBuffer->GetData(), bitStream->GetData(), (size_t) bitStream->GetNumberOfBytesUsed());
+	sharedSendBuffer->SetNumberOfBits(bitStream->GetNumberOfBitsUsed());
+
+	uint32_t usedSendReceipt=SendToList(sharedSendBuffer, priority, reliability, orderingChannel, targets, numTargets, forceReceiptNumber);
+	sharedSendBuffer->Release(_FILE_AND_LINE_);
+	return usedSendReceipt;
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t RakPeer::SendToList( SharedSendBuffer *sharedSendBuffer, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID *targets, unsigned int numTargets, uint32_t forceReceiptNumber )
+{
+#ifdef _DEBUG
+	RakAssert( sharedSendBuffer && sharedSendBuffer->GetNumberOfBits() > 0 );
+#endif
+
+	RakAssert( !( reliability >= NUMBER_OF_RELIABILITIES || reliability < 0 ) );
+	RakAssert( !( priority > NUMBER_OF_PRIORITIES || priority < 0 ) );
+	RakAssert( !( orderingChannel >= NUMBER_OF_ORDERED_STREAMS ) );
+
+	if ( sharedSendBuffer == 0 || sharedSendBuffer->GetNumberOfBits() == 0 || numTargets == 0 )
+		return 0;
+
+	if ( remoteSystemList == 0 || endThreads == true )
+		return 0;
+
+	uint32_t usedSendReceipt;
+	if (forceReceiptNumber!=0)
+		usedSendReceipt=forceReceiptNumber;
+	else
+		usedSendReceipt=IncrementNextSendReceipt();
+
+	// Owned by the buffered command, which resolves the systems on the update thread
+	AddressOrGUID *bufferedTargets = SLNet::OP_NEW_ARRAY<AddressOrGUID>(numTargets, _FILE_AND_LINE_);
+	unsigned int numBufferedTargets=0;
+	for (unsigned int targetIndex=0; targetIndex < numTargets; targetIndex++)
+	{
+		if (targets[targetIndex].IsUndefined())
+			continue;
+
+		if (IsLoopbackAddress(targets[targetIndex],true))
+		{
+			SendLoopback((const char*) sharedSendBuffer->GetData(),(int) BITS_TO_BYTES(sharedSendBuffer->GetNumberOfBits()));
+			if (reliability>=UNRELIABLE_WITH_ACK_RECEIPT)
+			{
+				char buff[5];
+				buff[0]=ID_SND_RECEIPT_ACKED;
+				sendReceiptSerialMutex.Lock();
+				memcpy(buff+1, &sendReceiptSerial,4);
+				sendReceiptSerialMutex.Unlock();
+				SendLoopback( buff, 5 );
+			}
+			continue;
+		}
+
+		if (IsOverMemoryBudget(targets[targetIndex]))
+			continue;
+
+		bufferedTargets[numBufferedTargets++]=targets[targetIndex];
+	}
+
+	if (numBufferedTargets==0)
+	{
+		SLNet::OP_DELETE_ARRAY(bufferedTargets, _FILE_AND_LINE_);
+		return usedSendReceipt;
+	}
+
+	// Released by the update thread once the reliability layers took their references
+	sharedSendBuffer->AddReference();
+	SendBuffered((const char*)sharedSendBuffer->GetData(), sharedSendBuffer->GetNumberOfBits(), priority, reliability, orderingChannel, UNASSIGNED_SYSTEM_ADDRESS, false, RemoteSystemStruct::NO_ACTION, usedSendReceipt, sharedSendBuffer, bufferedTargets, numBufferedTargets);
+
 	return usedSendReceipt;
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1450,6 +1731,9 @@ uint32_t RakPeer::SendList( const char **data, const int *lengths, const int num
 	if ( broadcast == false && systemIdentifier.IsUndefined() )
 		return 0;
 
+	if ( broadcast == false && IsOverMemoryBudget(systemIdentifier) )
+		return 0;
+
 	uint32_t usedSendReceipt;
 	if (forceReceiptNumber!=0)
 		usedSendReceipt=forceReceiptNumber;
@@ -1531,13 +1815,7 @@ Packet* RakPeer::Receive( void )
 
 	do
 	{
-		packetReturnMutex.Lock();
-		if (packetReturnQueue.IsEmpty())
-			packet=0;
-		else
-			packet = packetReturnQueue.Pop();
-		packetReturnMutex.Unlock();
-		if (packet==0)
+		if (packetReturnQueue.Pop(packet)==false)
 			return 0;
 
 //		unsigned char msgId;
@@ -1560,25 +1838,11 @@ Packet* RakPeer::Receive( void )
 		CallPluginCallbacks(pluginListTS, packet);
 		CallPluginCallbacks(pluginListNTS, packet);
 
-		for (i=0; i < pluginListTS.Size(); i++)
+		// Only the plugins that take this message ID
+		unsigned char messageId=packet->data[0];
+		for (i=receivePluginListOffsets[messageId]; i < receivePluginListOffsets[messageId+1]; i++)
 		{
- 			pluginResult=pluginListTS[i]->OnReceive(packet);
-			if (pluginResult==RR_STOP_PROCESSING_AND_DEALLOCATE)
-			{
-				DeallocatePacket( packet );
-				packet=0; // Will do the loop again and get another packet
-				break; // break out of the enclosing for
-			}
-			else if (pluginResult==RR_STOP_PROCESSING)
-			{
-				packet=0;
-				break;
-			}
-		}
-
-		for (i=0; i < pluginListNTS.Size(); i++)
-		{
-			pluginResult=pluginListNTS[i]->OnReceive(packet);
+			pluginResult=receivePluginList[i]->OnReceive(packet);
 			if (pluginResult==RR_STOP_PROCESSING_AND_DEALLOCATE)
 			{
 				DeallocatePacket( packet );
@@ -1614,9 +1878,7 @@ void RakPeer::DeallocatePacket( Packet *packet )
 	{
 		rakFree_Ex(packet->data, _FILE_AND_LINE_ );
 		packet->~Packet();
-		packetAllocationPoolMutex.Lock();
 		packetAllocationPool.Release(packet,_FILE_AND_LINE_);
-		packetAllocationPoolMutex.Unlock();
 	}
 	else
 	{
@@ -1856,47 +2118,12 @@ void RakPeer::GetSystemList(DataStructures::List<SystemAddress> &addresses, Data
 // Parameters
 // IP - Dotted IP address.  Can use * as a wildcard, such as 128.0.0.* will ban
 // All IP addresses starting with 128.0.0
+// Also takes IPv6 addresses and CIDR ranges, such as 128.0.0.0/8 or 2001:db8::/32
 // milliseconds - how many ms for a temporary ban.  Use 0 for a permanent ban
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void RakPeer::AddToBanList( const char *IP, SLNet::TimeMS milliseconds )
 {
-	unsigned index;
-	SLNet::TimeMS time = SLNet::GetTimeMS();
-
-	if ( IP == 0 || IP[ 0 ] == 0 || strlen( IP ) > 15 )
-		return ;
-
-	// If this guy is already in the ban list, do nothing
-	index = 0;
-
-	banListMutex.Lock();
-
-	for ( ; index < banList.Size(); index++ )
-	{
-		if ( strcmp( IP, banList[ index ]->IP ) == 0 )
-		{
-			// Already in the ban list.  Just update the time
-			if (milliseconds==0)
-				banList[ index ]->timeout=0; // Infinite
-			else
-				banList[ index ]->timeout=time+milliseconds;
-			banListMutex.Unlock();
-			return;
-		}
-	}
-
-	banListMutex.Unlock();
-
-	BanStruct *banStruct = SLNet::OP_NEW<BanStruct>( _FILE_AND_LINE_ );
-	banStruct->IP = (char*) rakMalloc_Ex( 16, _FILE_AND_LINE_ );
-	if (milliseconds==0)
-		banStruct->timeout=0; // Infinite
-	else
-		banStruct->timeout=time+milliseconds;
-	strcpy_s( banStruct->IP, 16, IP );
-	banListMutex.Lock();
-	banList.Insert( banStruct, _FILE_AND_LINE_ );
-	banListMutex.Unlock();
+	banList.Add( IP, milliseconds );
 }
 
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1909,36 +2136,7 @@ void RakPeer::AddToBanList( const char *IP, SLNet::TimeMS milliseconds )
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void RakPeer::RemoveFromBanList( const char *IP )
 {
-	unsigned index;
-	BanStruct *temp;
-
-	if ( IP == 0 || IP[ 0 ] == 0 || strlen( IP ) > 15 )
-		return ;
-
-	index = 0;
-	temp=0;
-
-	banListMutex.Lock();
-
-	for ( ; index < banList.Size(); index++ )
-	{
-		if ( strcmp( IP, banList[ index ]->IP ) == 0 )
-		{
-			temp = banList[ index ];
-			banList[ index ] = banList[ banList.Size() - 1 ];
-			banList.RemoveAtIndex( banList.Size() - 1 );
-			break;
-		}
-	}
-
-	banListMutex.Unlock();
-
-	if (temp)
-	{
-		rakFree_Ex(temp->IP, _FILE_AND_LINE_ );
-		SLNet::OP_DELETE(temp, _FILE_AND_LINE_);
-	}
-
+	banList.Remove( IP );
 }
 
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1947,19 +2145,7 @@ void RakPeer::RemoveFromBanList( const char *IP )
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void RakPeer::ClearBanList( void )
 {
-	unsigned index;
-	index = 0;
-	banListMutex.Lock();
-
-	for ( ; index < banList.Size(); index++ )
-	{
-		rakFree_Ex(banList[ index ]->IP, _FILE_AND_LINE_ );
-		SLNet::OP_DELETE(banList[ index ], _FILE_AND_LINE_);
-	}
-
-	banList.Clear(false, _FILE_AND_LINE_);
-
-	banListMutex.Unlock();
+	banList.Clear();
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void RakPeer::SetLimitIPConnectionFrequency(bool b)
@@ -1980,84 +2166,7 @@ void RakPeer::SetLimitIPConnectionFrequency(bool b)
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 bool RakPeer::IsBanned( const char *IP )
 {
-	unsigned banListIndex, characterIndex;
-	SLNet::TimeMS time;
-	BanStruct *temp;
-
-	if ( IP == 0 || IP[ 0 ] == 0 || strlen( IP ) > 15 )
-		return false;
-
-	banListIndex = 0;
-
-	if ( banList.Size() == 0 )
-		return false; // Skip the mutex if possible
-
-	time = SLNet::GetTimeMS();
-
-	banListMutex.Lock();
-
-	while ( banListIndex < banList.Size() )
-	{
-		if (banList[ banListIndex ]->timeout>0 && banList[ banListIndex ]->timeout<time)
-		{
-			// Delete expired ban
-			temp = banList[ banListIndex ];
-			banList[ banListIndex ] = banList[ banList.Size() - 1 ];
-			banList.RemoveAtIndex( banList.Size() - 1 );
-			rakFree_Ex(temp->IP, _FILE_AND_LINE_ );
-			SLNet::OP_DELETE(temp, _FILE_AND_LINE_);
-		}
-		else
-		{
-			characterIndex = 0;
-
-			for(;;)
-			{
-				if ( banList[ banListIndex ]->IP[ characterIndex ] == IP[ characterIndex ] )
-				{
-					// Equal characters
-
-					if ( IP[ characterIndex ] == 0 )
-					{
-						banListMutex.Unlock();
-						// End of the string and the strings match
-
-						return true;
-					}
-
-					characterIndex++;
-				}
-
-				else
-				{
-					if ( banList[ banListIndex ]->IP[ characterIndex ] == 0 || IP[ characterIndex ] == 0 )
-					{
-						// End of one of the strings
-						break;
-					}
-
-					// Characters do not match
-					if ( banList[ banListIndex ]->IP[ characterIndex ] == '*' )
-					{
-						banListMutex.Unlock();
-
-						// Domain is banned.
-						return true;
-					}
-
-					// Characters do not match and it is not a *
-					break;
-				}
-			}
-
-			banListIndex++;
-		}
-	}
-
-	banListMutex.Unlock();
-
-	// No match found.
-	return false;
+	return banList.IsBanned( IP );
 }
 
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -2759,6 +2868,7 @@ void RakPeer::AttachPlugin( PluginInterface2 *plugin )
 			plugin->SetRakPeerInterface(this);
 			plugin->OnAttach();
 			pluginListNTS.Insert(plugin, _FILE_AND_LINE_);
+			UpdateReceivePluginList();
 		}
 	}
 	else
@@ -2768,6 +2878,7 @@ void RakPeer::AttachPlugin( PluginInterface2 *plugin )
 			plugin->SetRakPeerInterface(this);
 			plugin->OnAttach();
 			pluginListTS.Insert(plugin, _FILE_AND_LINE_);
+			UpdateReceivePluginList();
 		}
 	}
 }
@@ -2805,6 +2916,7 @@ void RakPeer::DetachPlugin( PluginInterface2 *plugin )
 			pluginListTS.RemoveFromEnd();
 		}
 	}
+	UpdateReceivePluginList();
 	plugin->OnDetach();
 	plugin->SetRakPeerInterface(0);
 }
@@ -2826,12 +2938,10 @@ void RakPeer::PushBackPacket( Packet *packet, bool pushAtHead)
 	for (i=0; i < pluginListNTS.Size(); i++)
 		pluginListNTS[i]->OnPushBackPacket((const char*) packet->data, packet->bitSize, packet->systemAddress);
 
-	packetReturnMutex.Lock();
 	if (pushAtHead)
-		packetReturnQueue.PushAtHead(packet,0,_FILE_AND_LINE_);
+		packetReturnQueue.PushAtHead(packet);
 	else
-		packetReturnQueue.Push(packet,_FILE_AND_LINE_);
-	packetReturnMutex.Unlock();
+		packetReturnQueue.Push(packet);
 }
 
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -2845,6 +2955,7 @@ void RakPeer::ChangeSystemAddress(RakNetGUID guid, const SystemAddress &systemAd
 	bcs->systemIdentifier.rakNetGuid=guid;
 	bcs->command=BufferedCommandStruct::BCS_CHANGE_SYSTEM_ADDRESS;
 	bufferedCommands.Push(bcs);
+	WakeIdleUpdateNetworkLoop();
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 Packet* RakPeer::AllocatePacket(unsigned dataSize)
@@ -2861,6 +2972,7 @@ RakNetSocket2* RakPeer::GetSocket( const SystemAddress target )
 	bcs->systemIdentifier=target;
 	bcs->data=0;
 	bufferedCommands.Push(bcs);
+	quitAndDataEvents.SetEvent();
 
 	// Block up to one second to get the socket, although it should actually take virtually no time
 	SocketQueryOutput *sqo;
@@ -2899,6 +3011,7 @@ void RakPeer::GetSockets( DataStructures::List<RakNetSocket2* > &sockets )
 	bcs->systemIdentifier=UNASSIGNED_SYSTEM_ADDRESS;
 	bcs->data=0;
 	bufferedCommands.Push(bcs);
+	quitAndDataEvents.SetEvent();
 
 	// Block up to one second to get the socket, although it should actually take virtually no time
 	SocketQueryOutput *sqo;
@@ -2957,9 +3070,75 @@ void RakPeer::ApplyNetworkSimulator( float packetloss, unsigned short minExtraPi
 
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
-void RakPeer::SetPerConnectionOutgoingBandwidthLimit( unsigned maxBitsPerSecond )
+void RakPeer::SetPerConnectionOutgoingBandwidthLimit( unsigned maxBitsPerSecond )
+{
+	maxOutgoingBPS=maxBitsPerSecond;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void RakPeer::SetPerConnectionMemoryBudget( unsigned maxBytes )
+{
+	perConnectionMemoryBudget=maxBytes;
+	for ( unsigned short i = 0; i < maximumNumberOfPeers; i++ )
+		remoteSystemList[ i ].reliabilityLayer.SetMemoryBudget(perConnectionMemoryBudget);
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned RakPeer::GetPerConnectionMemoryBudget( void ) const
+{
+	return perConnectionMemoryBudget;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void RakPeer::SetPerConnectionPacing( unsigned maxBurstDatagrams )
+{
+	perConnectionPacing=maxBurstDatagrams;
+	for ( unsigned short i = 0; i < maximumNumberOfPeers; i++ )
+		remoteSystemList[ i ].reliabilityLayer.SetPacing(perConnectionPacing);
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned RakPeer::GetPerConnectionPacing( void ) const
+{
+	return perConnectionPacing;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void RakPeer::SetCongestionControl( CongestionControlType type, const AddressOrGUID systemIdentifier )
+{
+	if (systemIdentifier.IsUndefined())
+	{
+		defaultCongestionControl=type;
+		return;
+	}
+
+	// The reliability layer is only changed by the update thread
+	BufferedCommandStruct *bcs;
+	bcs=bufferedCommands.Allocate( _FILE_AND_LINE_ );
+	bcs->data = 0;
+	bcs->systemIdentifier=systemIdentifier;
+	bcs->congestionControl=type;
+	bcs->command=BufferedCommandStruct::BCS_SET_CONGESTION_CONTROL;
+	bufferedCommands.Push(bcs);
+	WakeIdleUpdateNetworkLoop();
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+CongestionControlType RakPeer::GetCongestionControl( const AddressOrGUID systemIdentifier ) const
 {
-	maxOutgoingBPS=maxBitsPerSecond;
+	if (systemIdentifier.IsUndefined()==false)
+	{
+		RemoteSystemStruct * remoteSystem = GetRemoteSystem( systemIdentifier, false, true );
+		if ( remoteSystem != 0 )
+			return remoteSystem->reliabilityLayer.GetCongestionControl();
+	}
+	return defaultCongestionControl;
 }
 
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -2993,6 +3172,18 @@ void RakPeer::SetIncomingDatagramEventHandler( bool (*_incomingDatagramEventHand
 	incomingDatagramEventHandler=_incomingDatagramEventHandler;
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void RakPeer::SetNumberOfUpdateShards( unsigned int numberOfShards )
+{
+	if (numberOfShards==0)
+		numberOfShards=1;
+	requestedUpdateShardCount=numberOfShards;
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+unsigned int RakPeer::GetNumberOfUpdateShards( void ) const
+{
+	return requestedUpdateShardCount;
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 bool RakPeer::SendOutOfBand(const char *host, unsigned short remotePort, const char *data, BitSize_t dataLength, unsigned connectionSocketIndex )
 {
 	if ( IsActive() == false )
@@ -3128,11 +3319,15 @@ bool RakPeer::GetStatistics( const unsigned int index, RakNetStatistics *rns )
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 unsigned int RakPeer::GetReceiveBufferSize(void)
 {
-	unsigned int size;
-	packetReturnMutex.Lock();
-	size=packetReturnQueue.Size();
-	packetReturnMutex.Unlock();
-	return size;
+	return packetReturnQueue.Size();
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void RakPeer::GetThreadQueueStatistics( uint32_t *contentionCount, uint32_t *overflowCount )
+{
+	if (contentionCount)
+		*contentionCount=bufferedCommands.GetContentionCount()+packetReturnQueue.GetContentionCount()+packetAllocationPool.GetContentionCount();
+	if (overflowCount)
+		*overflowCount=bufferedCommands.GetOverflowCount()+packetReturnQueue.GetOverflowCount();
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 int RakPeer::GetIndexFromSystemAddress( const SystemAddress systemAddress, bool calledFromNetworkThread ) const
@@ -3315,6 +3510,7 @@ ConnectionAttemptResult RakPeer::SendConnectionRequest( const char* host, unsign
 	}
 	requestedConnectionQueue.Push(rcs, _FILE_AND_LINE_ );
 	requestedConnectionQueueMutex.Unlock();
+	WakeIdleUpdateNetworkLoop();
 
 	return CONNECTION_ATTEMPT_STARTED;
 }
@@ -3369,6 +3565,7 @@ ConnectionAttemptResult RakPeer::SendConnectionRequest( const char* host, unsign
 	}
 	requestedConnectionQueue.Push(rcs, _FILE_AND_LINE_ );
 	requestedConnectionQueueMutex.Unlock();
+	WakeIdleUpdateNetworkLoop();
 
 	return CONNECTION_ATTEMPT_STARTED;
 }
@@ -3645,6 +3842,12 @@ RakPeer::RemoteSystemStruct * RakPeer::AssignSystemAddressToRemoteSystemList( co
 			remoteSystem->reliabilityLayer.SetSplitMessageProgressInterval(splitMessageProgressInterval);
 			remoteSystem->reliabilityLayer.SetUnreliableTimeout(unreliableTimeout);
 			remoteSystem->reliabilityLayer.SetTimeoutTime(defaultTimeoutTime);
+			remoteSystem->reliabilityLayer.SetMemoryBudget(perConnectionMemoryBudget);
+			remoteSystem->reliabilityLayer.SetCongestionControl(defaultCongestionControl);
+			remoteSystem->reliabilityLayer.SetPacing(perConnectionPacing);
+#if LIBCAT_SECURITY==1
+			remoteSystem->secureHandshakeJob=0;
+#endif
 			AddToActiveSystemList(assignedIndex);
 			if (incomingRakNetSocket->GetBoundAddress()==bindingAddress)
 			{
@@ -4197,28 +4400,41 @@ void RakPeer::CloseConnectionInternal2(const AddressOrGUID& systemIdentifier, bo
 			bcs->orderingChannel=orderingChannel;
 			bcs->priority=disconnectionNotificationPriority;
 			bufferedCommands.Push(bcs);
+			WakeIdleUpdateNetworkLoop();
 		}
 	}
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void RakPeer::SendBuffered( const char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, RemoteSystemStruct::ConnectMode connectionMode, uint32_t receipt )
+void RakPeer::SendBuffered( const char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, RemoteSystemStruct::ConnectMode connectionMode, uint32_t receipt, SharedSendBuffer *sharedSendBuffer, AddressOrGUID *targets, unsigned int numTargets )
 {
 	BufferedCommandStruct *bcs;
 
 	bcs=bufferedCommands.Allocate( _FILE_AND_LINE_ );
-	bcs->data = (char*) rakMalloc_Ex( (size_t) BITS_TO_BYTES(numberOfBitsToSend), _FILE_AND_LINE_ ); // Making a copy doesn't lose efficiency because I tell the reliability layer to use this allocation for its own copy
-	if (bcs->data==0)
+	bcs->sharedSendBuffer=sharedSendBuffer;
+	bcs->targets=targets;
+	bcs->numTargets=numTargets;
+	if (sharedSendBuffer)
 	{
-		notifyOutOfMemory(_FILE_AND_LINE_);
-		bufferedCommands.Deallocate(bcs, _FILE_AND_LINE_);
-		return;
+		// The reference taken by the caller is handed to bcs
+		bcs->data = (char*) data;
+	}
+	else
+	{
+		bcs->data = (char*) rakMalloc_Ex( (size_t) BITS_TO_BYTES(numberOfBitsToSend), _FILE_AND_LINE_ ); // Making a copy doesn't lose efficiency because I tell the reliability layer to use this allocation for its own copy
+		if (bcs->data==0)
+		{
+			notifyOutOfMemory(_FILE_AND_LINE_);
+			SLNet::OP_DELETE_ARRAY(targets, _FILE_AND_LINE_);
+			bufferedCommands.Deallocate(bcs, _FILE_AND_LINE_);
+			return;
+		}
+		memcpy(bcs->data, data, (size_t) BITS_TO_BYTES(numberOfBitsToSend));
 	}
 	
 	RakAssert( !( reliability >= NUMBER_OF_RELIABILITIES || reliability < 0 ) );
 	RakAssert( !( priority > NUMBER_OF_PRIORITIES || priority < 0 ) );
 	RakAssert( !( orderingChannel >= NUMBER_OF_ORDERED_STREAMS ) );
 
-	memcpy(bcs->data, data, (size_t) BITS_TO_BYTES(numberOfBitsToSend));
 	bcs->numberOfBitsToSend=numberOfBitsToSend;
 	bcs->priority=priority;
 	bcs->reliability=reliability;
@@ -4235,6 +4451,8 @@ void RakPeer::SendBuffered( const char *data, BitSize_t numberOfBitsToSend, Pack
 		// Forces pending sends to go out now, rather than waiting to the next update interval
 		quitAndDataEvents.SetEvent();
 	}
+	else
+		WakeIdleUpdateNetworkLoop();
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void RakPeer::SendBufferedList( const char **data, const int *lengths, const int numParameters, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, RemoteSystemStruct::ConnectMode connectionMode, uint32_t receipt )
@@ -4280,6 +4498,9 @@ void RakPeer::SendBufferedList( const char **data, const int *lengths, const int
 
 	bcs=bufferedCommands.Allocate( _FILE_AND_LINE_ );
 	bcs->data = dataAggregate;
+	bcs->sharedSendBuffer=0;
+	bcs->targets=0;
+	bcs->numTargets=0;
 	bcs->numberOfBitsToSend=BYTES_TO_BITS(totalLength);
 	bcs->priority=priority;
 	bcs->reliability=reliability;
@@ -4296,9 +4517,11 @@ void RakPeer::SendBufferedList( const char **data, const int *lengths, const int
 		// Forces pending sends to go out now, rather than waiting to the next update interval
 		quitAndDataEvents.SetEvent();
 	}
+	else
+		WakeIdleUpdateNetworkLoop();
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-bool RakPeer::SendImmediate( char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, bool useCallerDataAllocation, SLNet::TimeUS currentTime, uint32_t receipt )
+bool RakPeer::SendImmediate( char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, char orderingChannel, const AddressOrGUID systemIdentifier, bool broadcast, bool useCallerDataAllocation, SLNet::TimeUS currentTime, uint32_t receipt, SharedSendBuffer *sharedSendBuffer, const AddressOrGUID *targets, unsigned int numTargets )
 {
 	unsigned *sendList;
 	unsigned sendListSize;
@@ -4316,8 +4539,29 @@ bool RakPeer::SendImmediate( char *data, BitSize_t numberOfBitsToSend, PacketPri
 	else
 		remoteSystemIndex=(unsigned int) -1;
 
+	if (targets)
+	{
+		// A list can be too long for the stack
+		sendList = (unsigned *) rakMalloc_Ex(sizeof(unsigned)*numTargets, _FILE_AND_LINE_);
+		for (unsigned int targetIndex=0; targetIndex < numTargets; targetIndex++)
+		{
+			if (targets[targetIndex].systemAddress!=UNASSIGNED_SYSTEM_ADDRESS)
+				remoteSystemIndex=GetIndexFromSystemAddress( targets[targetIndex].systemAddress, true );
+			else
+				remoteSystemIndex=GetSystemIndexFromGuid(targets[targetIndex].rakNetGuid);
+
+			if (remoteSystemIndex!=(unsigned int) -1 &&
+				remoteSystemList[remoteSystemIndex].isActive &&
+				remoteSystemList[remoteSystemIndex].connectMode!=RemoteSystemStruct::DISCONNECT_ASAP &&
+				remoteSystemList[remoteSystemIndex].connectMode!=RemoteSystemStruct::DISCONNECT_ASAP_SILENTLY &&
+				remoteSystemList[remoteSystemIndex].connectMode!=RemoteSystemStruct::DISCONNECT_ON_NO_ACK)
+			{
+				sendList[sendListSize++]=remoteSystemIndex;
+			}
+		}
+	}
 	// 03/06/06 - If broadcast is false, use the optimized version of GetIndexFromSystemAddress
-	if (broadcast==false)
+	else if (broadcast==false)
 	{
 		if (remoteSystemIndex==(unsigned int) -1)
 		{
@@ -4364,7 +4608,10 @@ bool RakPeer::SendImmediate( char *data, BitSize_t numberOfBitsToSend, PacketPri
 
 	if (sendListSize==0)
 	{
+		if (targets)
+			rakFree_Ex(sendList, _FILE_AND_LINE_ );
 		#if !defined(USE_ALLOCA)
+		else
 			rakFree_Ex(sendList, _FILE_AND_LINE_ );
 		#endif
 
@@ -4373,9 +4620,21 @@ bool RakPeer::SendImmediate( char *data, BitSize_t numberOfBitsToSend, PacketPri
 
 	for (sendListIndex=0; sendListIndex < sendListSize; sendListIndex++)
 	{
+		// User messages that may be lost anyway are not sent to systems over their memory budget. Send() refuses the others before they are buffered.
+		if (useCallerDataAllocation &&
+			(reliability==UNRELIABLE || reliability==UNRELIABLE_SEQUENCED) &&
+			remoteSystemList[sendList[sendListIndex]].reliabilityLayer.IsOverMemoryBudget())
+		{
+			remoteSystemList[sendList[sendListIndex]].reliabilityLayer.OnMessageRefusedByMemoryBudget();
+			continue;
+		}
+
 		// Send may split the packet and thus deallocate data.  Don't assume data is valid if we use the callerAllocationData
-		bool useData = useCallerDataAllocation && callerDataAllocationUsed==false && sendListIndex+1==sendListSize;
-		remoteSystemList[sendList[sendListIndex]].reliabilityLayer.Send( data, numberOfBitsToSend, priority, reliability, orderingChannel, useData==false, remoteSystemList[sendList[sendListIndex]].MTUSize, currentTime, receipt );
+		// A shared send buffer is only referenced, so all systems use it and the caller keeps its own reference
+		// With a memory budget, the message is copied into the arena of the connection so that it counts against the budget
+		bool useData = useCallerDataAllocation && sharedSendBuffer==0 && callerDataAllocationUsed==false && sendListIndex+1==sendListSize &&
+			remoteSystemList[sendList[sendListIndex]].reliabilityLayer.GetMemoryBudget()==0;
+		remoteSystemList[sendList[sendListIndex]].reliabilityLayer.Send( data, numberOfBitsToSend, priority, reliability, orderingChannel, useData==false, remoteSystemList[sendList[sendListIndex]].MTUSize, currentTime, receipt, sharedSendBuffer );
 		if (useData)
 			callerDataAllocationUsed=true;
 
@@ -4390,14 +4649,30 @@ bool RakPeer::SendImmediate( char *data, BitSize_t numberOfBitsToSend, PacketPri
 			remoteSystemList[sendList[sendListIndex]].lastReliableSend=(SLNet::TimeMS)(currentTime/(SLNet::TimeUS)1000);
 	}
 
+	if (targets)
+		rakFree_Ex(sendList, _FILE_AND_LINE_ );
 #if !defined(USE_ALLOCA)
-	rakFree_Ex(sendList, _FILE_AND_LINE_ );
+	else
+		rakFree_Ex(sendList, _FILE_AND_LINE_ );
 #endif
 
 	// Return value only meaningful if true was passed for useCallerDataAllocation.  Means the reliability layer used that data copy, so the caller should not deallocate it
 	return callerDataAllocationUsed;
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool RakPeer::IsOverMemoryBudget( const AddressOrGUID systemIdentifier )
+{
+	if (perConnectionMemoryBudget==0)
+		return false;
+
+	RemoteSystemStruct *remoteSystem=GetRemoteSystem(systemIdentifier, false, true);
+	if (remoteSystem==0 || remoteSystem->reliabilityLayer.IsOverMemoryBudget()==false)
+		return false;
+
+	remoteSystem->reliabilityLayer.OnMessageRefusedByMemoryBudget();
+	return true;
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void RakPeer::ResetSendReceipt(void)
 {
 	sendReceiptSerialMutex.Lock();
@@ -4435,8 +4710,12 @@ void RakPeer::ClearBufferedCommands(void)
 
 	while ((bcs=bufferedCommands.Pop())!=0)
 	{
-		if (bcs->data)
+		if (bcs->command==BufferedCommandStruct::BCS_SEND && bcs->sharedSendBuffer)
+			bcs->sharedSendBuffer->Release(_FILE_AND_LINE_);
+		else if (bcs->data)
 			rakFree_Ex(bcs->data, _FILE_AND_LINE_ );
+		if (bcs->command==BufferedCommandStruct::BCS_SEND && bcs->targets)
+			SLNet::OP_DELETE_ARRAY(bcs->targets, _FILE_AND_LINE_);
 
 		bufferedCommands.Deallocate(bcs, _FILE_AND_LINE_);
 	}
@@ -4467,9 +4746,7 @@ void RakPeer::ClearRequestedConnectionList(void)
 }
 inline void RakPeer::AddPacketToProducer(SLNet::Packet *p)
 {
-	packetReturnMutex.Lock();
-	packetReturnQueue.Push(p,_FILE_AND_LINE_);
-	packetReturnMutex.Unlock();
+	packetReturnQueue.Push(p);
 }
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 union Buff6AndBuff8
@@ -4560,9 +4837,7 @@ bool ProcessOfflineNetworkPacket( SystemAddress systemAddress, const char *data,
 	unsigned i;
 
 
-	char str1[64];
-	systemAddress.ToString(false, str1,static_cast<size_t>(64));
-	if (rakPeer->IsBanned( str1 ))
+	if (rakPeer->banList.IsBanned( systemAddress ))
 	{
 		for (i=0; i < rakPeer->pluginListNTS.Size(); i++)
 			rakPeer->pluginListNTS[i]->OnDirectSocketReceive(data, length*8, systemAddress);
@@ -5217,6 +5492,7 @@ bool ProcessOfflineNetworkPacket( SystemAddress systemAddress, const char *data,
 
 			if (rakPeer->_using_security)
 			{
+				char str1[64];
 				systemAddress.ToString(false, str1, static_cast<size_t>(64));
 				requiresSecurityOfThisClient=rakPeer->IsInSecurityExceptionList(str1)==false;
 
@@ -5317,6 +5593,10 @@ bool ProcessOfflineNetworkPacket( SystemAddress systemAddress, const char *data,
 #if LIBCAT_SECURITY==1
 				if (requiresSecurityOfThisClient)
 				{
+					// The answer is sent once the worker thread is done
+					if (rssFromSA->secureHandshakeJob)
+						return true;
+
 					CAT_AUDIT_PRINTF("AUDIT: Resending public key and answer from packetloss.  Sending ID_OPEN_CONNECTION_REPLY_2\n");
 					bsAnswer.WriteAlignedBytes((const unsigned char *) rssFromSA->answer,sizeof(rssFromSA->answer));
 				}
@@ -5368,6 +5648,16 @@ bool ProcessOfflineNetworkPacket( SystemAddress systemAddress, const char *data,
 				return true;
 			}
 
+#if LIBCAT_SECURITY==1
+			bool answerOnWorkerThread=requiresSecurityOfThisClient && rakPeer->secureHandshakeThreadPool.WasStarted();
+			if (answerOnWorkerThread && rakPeer->secureHandshakeQueueLength>=rakPeer->maxSecureHandshakeQueueLength)
+			{
+				// Ignore the request as if it was lost. The client sends it again
+				rakPeer->secureHandshakesDropped++;
+				return true;
+			}
+#endif // LIBCAT_SECURITY
+
 			bool thisIPConnectedRecently=false;
 			rssFromSA = rakPeer->AssignSystemAddressToRemoteSystemList(systemAddress, RakPeer::RemoteSystemStruct::UNVERIFIED_SENDER, rakNetSocket, &thisIPConnectedRecently, bindingAddress, mtu, guid, requiresSecurityOfThisClient);
 
@@ -5390,17 +5680,34 @@ bool ProcessOfflineNetworkPacket( SystemAddress systemAddress, const char *data,
 			}
 
 #if LIBCAT_SECURITY==1
+			if (answerOnWorkerThread)
+			{
+				// ProcessSecureHandshakeResults() sends ID_OPEN_CONNECTION_REPLY_2 with the answer
+				RakPeer::SecureHandshakeJob *job = SLNet::OP_NEW<RakPeer::SecureHandshakeJob>(_FILE_AND_LINE_);
+				job->rakPeer=rakPeer;
+				job->systemAddress=systemAddress;
+				job->mtu=mtu;
+				memcpy(job->challenge, remoteHandshakeChallenge, sizeof(job->challenge));
+				rssFromSA->secureHandshakeJob=job;
+				rakPeer->secureHandshakeThreadPool.AddInput(RakPeer::AnswerSecureHandshakeCB, job);
+				if (++rakPeer->secureHandshakeQueueLength > rakPeer->maxSecureHandshakeQueueLengthReached)
+					rakPeer->maxSecureHandshakeQueueLengthReached=rakPeer->secureHandshakeQueueLength;
+				return true;
+			}
+
 			if (requiresSecurityOfThisClient)
 			{
 				CAT_AUDIT_PRINTF("AUDIT: Writing public key.  Sending ID_OPEN_CONNECTION_REPLY_2\n");
 				if (rakPeer->_server_handshake->ProcessChallenge(remoteHandshakeChallenge, rssFromSA->answer, rssFromSA->reliabilityLayer.GetAuthenticatedEncryption() ))
 				{
 					CAT_AUDIT_PRINTF("AUDIT: Challenge good!\n");
+					rakPeer->secureHandshakesAnswered++;
 					// Keep going to OK block
 				}
 				else
 				{
 					CAT_AUDIT_PRINTF("AUDIT: Challenge BAD!\n");
+					rakPeer->secureHandshakesFailed++;
 
 					// Unassign this remote system
 					rakPeer->DereferenceRemoteSystem(systemAddress);
@@ -5618,10 +5925,30 @@ bool RakPeer::RunUpdateCycle(BitStream &updateBitStream )
 		}
 		if (socketListIndex!=socketList.Size())
 		*/
+		if (updateShardCount>1)
+		{
+			// Offline messages are handled right away. Datagrams from connected systems are handed to the shard owning the connection
+			bool isOfflineMessage;
+			if (ProcessOfflineNetworkPacket(recvFromStruct->systemAddress, recvFromStruct->data, recvFromStruct->bytesRead, this, recvFromStruct->socket, &isOfflineMessage, recvFromStruct->timeRead)==false &&
+				isOfflineMessage==false)
+			{
+				remoteSystem = GetRemoteSystemFromSystemAddress( recvFromStruct->systemAddress, true, true );
+				if (remoteSystem)
+				{
+					updateShards[remoteSystem->remoteSystemIndex % updateShardCount].incomingDatagrams.Push(recvFromStruct, _FILE_AND_LINE_);
+					continue;
+				}
+			}
+		}
+		else
 			ProcessNetworkPacket(recvFromStruct->systemAddress, recvFromStruct->data, recvFromStruct->bytesRead, this, recvFromStruct->socket, recvFromStruct->timeRead, updateBitStream);
-			DeallocRNS2RecvStruct(recvFromStruct, _FILE_AND_LINE_);
+		DeallocRNS2RecvStruct(recvFromStruct, _FILE_AND_LINE_);
 	}
 
+#if LIBCAT_SECURITY==1
+	ProcessSecureHandshakeResults();
+#endif
+
 	while ((bcs=bufferedCommands.PopInaccurate())!=0)
 	{
 		if (bcs->command==BufferedCommandStruct::BCS_SEND)
@@ -5633,9 +5960,13 @@ bool RakPeer::RunUpdateCycle(BitStream &updateBitStream )
 				timeMS = (SLNet::TimeMS)(timeNS/(SLNet::TimeUS)1000);
 			}
 
-			callerDataAllocationUsed=SendImmediate((char*)bcs->data, bcs->numberOfBitsToSend, bcs->priority, bcs->reliability, bcs->orderingChannel, bcs->systemIdentifier, bcs->broadcast, true, timeNS, bcs->receipt);
-			if ( callerDataAllocationUsed==false )
+			callerDataAllocationUsed=SendImmediate((char*)bcs->data, bcs->numberOfBitsToSend, bcs->priority, bcs->reliability, bcs->orderingChannel, bcs->systemIdentifier, bcs->broadcast, true, timeNS, bcs->receipt, bcs->sharedSendBuffer, bcs->targets, bcs->numTargets);
+			if (bcs->sharedSendBuffer)
+				bcs->sharedSendBuffer->Release(_FILE_AND_LINE_);
+			else if ( callerDataAllocationUsed==false )
 				rakFree_Ex(bcs->data, _FILE_AND_LINE_ );
+			if (bcs->targets)
+				SLNet::OP_DELETE_ARRAY(bcs->targets, _FILE_AND_LINE_);
 
 			// Set the new connection state AFTER we call sendImmediate in case we are setting it to a disconnection state, which does not allow further sends
 			if (bcs->connectionMode!=RemoteSystemStruct::NO_ACTION )
@@ -5660,6 +5991,12 @@ bool RakPeer::RunUpdateCycle(BitStream &updateBitStream )
 				ReferenceRemoteSystem(bcs->systemIdentifier.systemAddress, existingSystemIndex);
 			}
 		}
+		else if (bcs->command==BufferedCommandStruct::BCS_SET_CONGESTION_CONTROL)
+		{
+			remoteSystem=GetRemoteSystem( bcs->systemIdentifier, true, true );
+			if (remoteSystem)
+				remoteSystem->reliabilityLayer.SetCongestionControl(bcs->congestionControl);
+		}
 		else if (bcs->command==BufferedCommandStruct::BCS_GET_SOCKET)
 		{
 			SocketQueryOutput *sqo;
@@ -5835,6 +6172,25 @@ bool RakPeer::RunUpdateCycle(BitStream &updateBitStream )
 		requestedConnectionQueueMutex.Unlock();
 	}
 
+	if (updateShardCount>1)
+	{
+		if (timeNS==0)
+		{
+			timeNS = SLNet::GetTimeUS();
+			timeMS = (SLNet::TimeMS)(timeNS/(SLNet::TimeUS)1000);
+		}
+
+		// Run the reliability layers of all shards in parallel. This thread waits until all of them are done, so nothing below races with the shards
+		for ( activeSystemListIndex = 0; activeSystemListIndex < activeSystemListSize; ++activeSystemListIndex )
+		{
+			remoteSystem = activeSystemList[ activeSystemListIndex ];
+			updateShards[remoteSystem->remoteSystemIndex % updateShardCount].remoteSystems.Push(remoteSystem, _FILE_AND_LINE_);
+		}
+		updateShardsTime=timeNS;
+		updateShardsForceACKs=endThreads;
+		RunUpdateShards();
+	}
+
 	// remoteSystemList in network thread
 	for ( activeSystemListIndex = 0; activeSystemListIndex < activeSystemListSize; ++activeSystemListIndex )
 	//for ( remoteSystemIndex = 0; remoteSystemIndex < remoteSystemListSize; ++remoteSystemIndex )
@@ -5875,7 +6231,11 @@ bool RakPeer::RunUpdateCycle(BitStream &updateBitStream )
 				}
 			}
 
-			if (endThreads)
+			if (updateShardCount>1)
+			{
+				// already updated by RunUpdateShards()
+			}
+			else if (endThreads)
 				// for the final call, make sure we send out any outstanding ACKs
 				remoteSystem->reliabilityLayer.UpdateAndForceACKs( remoteSystem->rakNetSocket, systemAddress, remoteSystem->MTUSize, timeNS, maxOutgoingBPS, pluginListNTS, &rnr, updateBitStream ); // systemAddress only used for the internet simulator test
 			else
@@ -6267,6 +6627,257 @@ bool RakPeer::RunUpdateCycle(BitStream &updateBitStream )
 	return true;
 }
 
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+RakPeer::UpdateShard::UpdateShard() :
+	rakPeer(0),
+	updateBitStream( MAXIMUM_MTU_SIZE
+#if LIBCAT_SECURITY==1
+		+ cat::AuthenticatedEncryption::OVERHEAD_BYTES
+#endif
+		),
+	hasWork(false),
+	endThread(false),
+	isThreadActive(false)
+{
+	workEvent.InitEvent();
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+RakPeer::UpdateShard::~UpdateShard()
+{
+	workEvent.CloseEvent();
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool RakPeer::StartUpdateShards(int threadPriority)
+{
+	unsigned int i, threadsCreated;
+
+	RakAssert(updateShards==0);
+	updateShardCount=requestedUpdateShardCount;
+	if (updateShardCount<=1)
+	{
+		updateShardCount=1;
+		return true;
+	}
+
+	updateShards = SLNet::OP_NEW_ARRAY<UpdateShard>(updateShardCount, _FILE_AND_LINE_);
+	for (i=0; i < updateShardCount; i++)
+		updateShards[i].rakPeer=this;
+
+	// The first shard is processed by the main update thread
+	for (threadsCreated=0; threadsCreated < updateShardCount-1; threadsCreated++)
+	{
+		if (SLNet::RakThread::Create(UpdateShardLoop, &updateShards[threadsCreated+1], threadPriority)!=0)
+			break;
+	}
+
+	// Wait for the threads to activate, so StopUpdateShards() can rely on isThreadActive
+	for (i=1; i <= threadsCreated; i++)
+	{
+		while (updateShards[i].isThreadActive==false)
+			RakSleep(0);
+	}
+
+	return threadsCreated==updateShardCount-1;
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void RakPeer::StopUpdateShards(void)
+{
+	unsigned int i, j;
+
+	if (updateShards==0)
+		return;
+
+	for (i=1; i < updateShardCount; i++)
+	{
+		updateShards[i].endThread=true;
+		updateShards[i].workEvent.SetEvent();
+	}
+	for (i=1; i < updateShardCount; i++)
+	{
+		while (updateShards[i].isThreadActive)
+			RakSleep(15);
+	}
+
+	for (i=0; i < updateShardCount; i++)
+	{
+		for (j=0; j < updateShards[i].incomingDatagrams.Size(); j++)
+			DeallocRNS2RecvStruct(updateShards[i].incomingDatagrams[j], _FILE_AND_LINE_);
+	}
+
+	SLNet::OP_DELETE_ARRAY(updateShards, _FILE_AND_LINE_);
+	updateShards=0;
+	updateShardCount=1;
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void RakPeer::RunUpdateShards(void)
+{
+	unsigned int i, pending;
+
+	updateShardMutex.Lock();
+	updateShardsPending=updateShardCount;
+	for (i=0; i < updateShardCount; i++)
+		updateShards[i].hasWork=true;
+	updateShardMutex.Unlock();
+
+	for (i=1; i < updateShardCount; i++)
+		updateShards[i].workEvent.SetEvent();
+
+	RunUpdateShard(&updateShards[0]);
+
+	for (;;)
+	{
+		updateShardMutex.Lock();
+		pending=updateShardsPending;
+		updateShardMutex.Unlock();
+		if (pending==0)
+			break;
+		updateShardsDoneEvent.WaitOnEvent(1);
+	}
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void RakPeer::RunUpdateShard(UpdateShard *shard)
+{
+	unsigned int i, j, count, pending;
+	bool hasWork;
+	RemoteSystemStruct *remoteSystem;
+	RNS2RecvStruct *recvFromStruct;
+	SystemAddress systemAddress;
+
+	updateShardMutex.Lock();
+	hasWork=shard->hasWork;
+	updateShardMutex.Unlock();
+	if (hasWork==false)
+		return;
+
+	for (i=0; i < shard->incomingDatagrams.Size(); i+=count)
+	{
+		recvFromStruct=shard->incomingDatagrams[i];
+		count=1;
+
+		// The connection might have been closed by a buffered command since the datagram was assigned to this shard
+		remoteSystem = GetRemoteSystemFromSystemAddress( recvFromStruct->systemAddress, true, true );
+		if (remoteSystem)
+		{
+#if LIBCAT_SECURITY==1
+			// Sockets read the datagrams from one system one after another, so decrypt those together
+			char *buffers[RAKNET_SOCKET_BATCH_SIZE];
+			unsigned int lengths[RAKNET_SOCKET_BATCH_SIZE];
+			int decryptedLengths[RAKNET_SOCKET_BATCH_SIZE];
+			buffers[0]=recvFromStruct->data;
+			lengths[0]=(unsigned int) recvFromStruct->bytesRead;
+			while (count < RAKNET_SOCKET_BATCH_SIZE && i+count < shard->incomingDatagrams.Size() &&
+				shard->incomingDatagrams[i+count]->systemAddress==recvFromStruct->systemAddress)
+			{
+				buffers[count]=shard->incomingDatagrams[i+count]->data;
+				lengths[count]=(unsigned int) shard->incomingDatagrams[i+count]->bytesRead;
+				count++;
+			}
+			remoteSystem->reliabilityLayer.DecryptDatagrams(buffers, lengths, decryptedLengths, count);
+
+			// Also the datagrams that were not authentic, which count as received in the statistics
+			for (j=0; j < count; j++)
+			{
+				remoteSystem->reliabilityLayer.HandleSocketReceiveFromConnectedPlayer(
+					buffers[j], lengths[j], shard->incomingDatagrams[i+j]->systemAddress, pluginListNTS, remoteSystem->MTUSize,
+					shard->incomingDatagrams[i+j]->socket, &shard->rnr, shard->incomingDatagrams[i+j]->timeRead, shard->updateBitStream, decryptedLengths[j]);
+			}
+#else
+			remoteSystem->reliabilityLayer.HandleSocketReceiveFromConnectedPlayer(
+				recvFromStruct->data, recvFromStruct->bytesRead, recvFromStruct->systemAddress, pluginListNTS, remoteSystem->MTUSize,
+				recvFromStruct->socket, &shard->rnr, recvFromStruct->timeRead, shard->updateBitStream);
+#endif
+		}
+		for (j=0; j < count; j++)
+			DeallocRNS2RecvStruct(shard->incomingDatagrams[i+j], _FILE_AND_LINE_);
+	}
+	shard->incomingDatagrams.Clear(true, _FILE_AND_LINE_);
+
+	for (i=0; i < shard->remoteSystems.Size(); i++)
+	{
+		remoteSystem=shard->remoteSystems[i];
+		systemAddress=remoteSystem->systemAddress;
+		if (updateShardsForceACKs)
+			remoteSystem->reliabilityLayer.UpdateAndForceACKs( remoteSystem->rakNetSocket, systemAddress, remoteSystem->MTUSize, updateShardsTime, maxOutgoingBPS, pluginListNTS, &shard->rnr, shard->updateBitStream );
+		else
+			remoteSystem->reliabilityLayer.Update( remoteSystem->rakNetSocket, systemAddress, remoteSystem->MTUSize, updateShardsTime, maxOutgoingBPS, pluginListNTS, &shard->rnr, shard->updateBitStream );
+	}
+	shard->remoteSystems.Clear(true, _FILE_AND_LINE_);
+
+	updateShardMutex.Lock();
+	shard->hasWork=false;
+	pending=--updateShardsPending;
+	updateShardMutex.Unlock();
+
+	if (pending==0)
+		updateShardsDoneEvent.SetEvent();
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void ShortenUpdateNetworkLoopWait(SLNet::TimeMS &waitMS, SLNet::Time deadline, SLNet::Time timeMS)
+{
+	if (deadline <= timeMS)
+		waitMS=0;
+	else if (deadline - timeMS < waitMS)
+		waitMS=(SLNet::TimeMS) (deadline - timeMS);
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+SLNet::TimeMS RakPeer::GetUpdateNetworkLoopWaitTime(void)
+{
+	// The user callback is expected to run on every update interval
+	if (userUpdateThreadPtr)
+		return UPDATE_NETWORK_LOOP_SEND_INTERVAL_MS;
+
+	SLNet::TimeUS timeNS = SLNet::GetTimeUS();
+	SLNet::Time timeMS = (SLNet::TimeMS)(timeNS/(SLNet::TimeUS)1000);
+	SLNet::TimeMS waitMS = UPDATE_NETWORK_LOOP_MAX_WAIT_MS;
+	unsigned int i;
+
+	// Connection attempts are resent when timeMS > nextRequestTime
+	requestedConnectionQueueMutex.Lock();
+	for (i=0; i < requestedConnectionQueue.Size(); i++)
+		ShortenUpdateNetworkLoopWait(waitMS, requestedConnectionQueue[i]->nextRequestTime+1, timeMS);
+	requestedConnectionQueueMutex.Unlock();
+
+	// Same conditions as in RunUpdateCycle()
+	for ( i = 0; i < activeSystemListSize && waitMS > 0; ++i )
+	{
+		RemoteSystemStruct *remoteSystem = activeSystemList[ i ];
+
+		// Round up, so we do not wake just before the deadline and find nothing to do
+		SLNet::TimeUS reliabilityLayerWait = remoteSystem->reliabilityLayer.GetTimeUntilNextUpdate(timeNS, (SLNet::TimeUS) waitMS*(SLNet::TimeUS)1000);
+		waitMS = (SLNet::TimeMS) ((reliabilityLayerWait+(SLNet::TimeUS)999)/(SLNet::TimeUS)1000);
+
+		switch (remoteSystem->connectMode)
+		{
+		case RemoteSystemStruct::CONNECTED:
+			ShortenUpdateNetworkLoopWait(waitMS, remoteSystem->lastReliableSend+remoteSystem->reliabilityLayer.GetTimeoutTime()/2+1, timeMS);
+			if (occasionalPing || remoteSystem->lowestPing == (unsigned short)-1)
+				ShortenUpdateNetworkLoopWait(waitMS, remoteSystem->nextPingTime+1, timeMS);
+			break;
+		case RemoteSystemStruct::REQUESTED_CONNECTION:
+		case RemoteSystemStruct::HANDLING_CONNECTION_REQUEST:
+		case RemoteSystemStruct::UNVERIFIED_SENDER:
+			ShortenUpdateNetworkLoopWait(waitMS, remoteSystem->connectionTime+10000+1, timeMS);
+			break;
+		default:
+			// Disconnecting. Poll until the outgoing data and acks are done
+			if (waitMS > UPDATE_NETWORK_LOOP_SEND_INTERVAL_MS)
+				waitMS = UPDATE_NETWORK_LOOP_SEND_INTERVAL_MS;
+			break;
+		}
+	}
+
+	return waitMS;
+}
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void RakPeer::WakeIdleUpdateNetworkLoop(void)
+{
+	// Otherwise the command goes out on the next update interval anyway.
+	// The command was buffered before this, and the full barrier orders it before the read of the flag
+	if (updateNetworkLoopIdle.CompareAndSet(1, 0))
+		quitAndDataEvents.SetEvent();
+}
+
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 void RakPeer::OnRNS2Recv(RNS2RecvStruct *recvStruct)
@@ -6375,8 +6986,26 @@ RAK_THREAD_DECLARATION(SLNet::UpdateNetworkLoop)
 
 		rakPeer->RunUpdateCycle(updateBitStream);
 
-		// Pending sends go out this often, unless quitAndDataEvents is set
-		rakPeer->quitAndDataEvents.WaitOnEvent(10);
+		// That was the final run, so do not sleep again
+		if (running==false)
+			break;
+
+		// Sleep until the next deadline of any connection. Incoming datagrams and shutdown set quitAndDataEvents to wake up right away
+		SLNet::TimeMS waitMS = rakPeer->GetUpdateNetworkLoopWaitTime();
+		if (waitMS > UPDATE_NETWORK_LOOP_SEND_INTERVAL_MS)
+		{
+			rakPeer->updateNetworkLoopIdle.CompareAndSet(0, 1);
+
+			// Commands buffered before updateNetworkLoopIdle was set did not wake us. Pending sends go out this often.
+			// The full barrier of CompareAndSet() orders this read after the flag was set
+			if (rakPeer->bufferedCommands.IsEmpty()==false)
+				waitMS = UPDATE_NETWORK_LOOP_SEND_INTERVAL_MS;
+		}
+		// Wait at least 1 ms, so a deadline that Update() cannot act on yet (such as a resend held back by congestion control) does not spin
+		if (waitMS == 0)
+			waitMS = 1;
+		rakPeer->quitAndDataEvents.WaitOnEvent((int) waitMS);
+		rakPeer->updateNetworkLoopIdle.CompareAndSet(1, 0);
 
 		/*
 
@@ -6429,6 +7058,23 @@ RAK_THREAD_DECLARATION(SLNet::UpdateNetworkLoop)
 
 }
 
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+RAK_THREAD_DECLARATION(SLNet::UpdateShardLoop)
+{
+	RakPeer::UpdateShard *shard = ( RakPeer::UpdateShard * ) arguments;
+	shard->isThreadActive = true;
+
+	while ( shard->endThread == false )
+	{
+		// Woken by RunUpdateShards() once per update cycle, or by StopUpdateShards()
+		shard->workEvent.WaitOnEvent(UPDATE_NETWORK_LOOP_MAX_WAIT_MS);
+		shard->rakPeer->RunUpdateShard(shard);
+	}
+
+	shard->isThreadActive = false;
+	return 0;
+}
+
 void RakPeer::CallPluginCallbacks(DataStructures::List<PluginInterface2*> &pluginList, Packet *packet)
 {
 	for (unsigned int i=0; i < pluginList.Size(); i++)
@@ -6481,6 +7127,130 @@ void RakPeer::CallPluginCallbacks(DataStructures::List<PluginInterface2*> &plugi
 	}
 }
 
+void RakPeer::UpdateReceivePluginList(void)
+{
+	unsigned int pluginCount=pluginListTS.Size()+pluginListNTS.Size();
+	bool *messageIDs=0;
+	if (pluginCount>0)
+		messageIDs=(bool*) rakMalloc_Ex(pluginCount*256*sizeof(bool), _FILE_AND_LINE_);
+
+	unsigned int pluginIndex, messageId;
+	for (pluginIndex=0; pluginIndex < pluginCount; pluginIndex++)
+	{
+		PluginInterface2 *plugin = pluginIndex < pluginListTS.Size() ? pluginListTS[pluginIndex] : pluginListNTS[pluginIndex-pluginListTS.Size()];
+		bool *pluginMessageIDs=messageIDs+pluginIndex*256;
+		for (messageId=0; messageId < 256; messageId++)
+			pluginMessageIDs[messageId]=false;
+		if (plugin->GetReceivedMessageIDs(pluginMessageIDs)==false)
+		{
+			for (messageId=0; messageId < 256; messageId++)
+				pluginMessageIDs[messageId]=true;
+		}
+	}
+
+	receivePluginList.Clear(true, _FILE_AND_LINE_);
+	for (messageId=0; messageId < 256; messageId++)
+	{
+		receivePluginListOffsets[messageId]=receivePluginList.Size();
+		for (pluginIndex=0; pluginIndex < pluginCount; pluginIndex++)
+		{
+			if (messageIDs[pluginIndex*256+messageId])
+				receivePluginList.Insert(pluginIndex < pluginListTS.Size() ? pluginListTS[pluginIndex] : pluginListNTS[pluginIndex-pluginListTS.Size()], _FILE_AND_LINE_);
+		}
+	}
+	receivePluginListOffsets[256]=receivePluginList.Size();
+
+	if (messageIDs)
+		rakFree_Ex(messageIDs, _FILE_AND_LINE_);
+}
+
+#if LIBCAT_SECURITY==1
+RakPeer::SecureHandshakeJob* RakPeer::AnswerSecureHandshakeCB(SecureHandshakeJob *job, bool *returnOutput, void* perThreadData)
+{
+	SecureHandshakeWorker *worker=(SecureHandshakeWorker*) perThreadData;
+	if (worker->initialized==false)
+		worker->initialized=worker->handshake.Initialize(job->rakPeer->my_public_key, job->rakPeer->my_private_key);
+	job->succeeded=worker->initialized && worker->handshake.ProcessChallenge(job->challenge, job->answer, &job->authenticatedEncryption);
+	*returnOutput=true;
+	// Send the answer without waiting for the next update cycle
+	job->rakPeer->quitAndDataEvents.SetEvent();
+	return job;
+}
+
+void RakPeer::StopSecureHandshakeThreads(void)
+{
+	if (secureHandshakeThreadPool.WasStarted()==false)
+		return;
+	secureHandshakeThreadPool.StopThreads();
+
+	unsigned int i;
+	secureHandshakeThreadPool.LockInput();
+	for (i=0; i < secureHandshakeThreadPool.InputSize(); i++)
+		SLNet::OP_DELETE(secureHandshakeThreadPool.GetInputAtIndex(i), _FILE_AND_LINE_);
+	secureHandshakeThreadPool.UnlockInput();
+	secureHandshakeThreadPool.LockOutput();
+	for (i=0; i < secureHandshakeThreadPool.OutputSize(); i++)
+		SLNet::OP_DELETE(secureHandshakeThreadPool.GetOutputAtIndex(i), _FILE_AND_LINE_);
+	secureHandshakeThreadPool.UnlockOutput();
+	secureHandshakeThreadPool.Clear();
+	secureHandshakeQueueLength=0;
+}
+
+void RakPeer::ProcessSecureHandshakeResults(void)
+{
+	while (secureHandshakeThreadPool.HasOutputFast() && secureHandshakeThreadPool.HasOutput())
+	{
+		SecureHandshakeJob *job=secureHandshakeThreadPool.GetOutput();
+		secureHandshakeQueueLength--;
+
+		// The connection may have timed out, or was assigned to another system, while the challenge was answered
+		RemoteSystemStruct *remoteSystem=GetRemoteSystemFromSystemAddress(job->systemAddress, true, true);
+		if (remoteSystem==0 || remoteSystem->secureHandshakeJob!=job || remoteSystem->connectMode!=RemoteSystemStruct::UNVERIFIED_SENDER)
+		{
+			SLNet::OP_DELETE(job, _FILE_AND_LINE_);
+			continue;
+		}
+		remoteSystem->secureHandshakeJob=0;
+
+		if (job->succeeded==false)
+		{
+			CAT_AUDIT_PRINTF("AUDIT: Challenge BAD!\n");
+			secureHandshakesFailed++;
+
+			// Unassign this remote system
+			DereferenceRemoteSystem(job->systemAddress);
+			SLNet::OP_DELETE(job, _FILE_AND_LINE_);
+			continue;
+		}
+
+		CAT_AUDIT_PRINTF("AUDIT: Challenge good!\n");
+		secureHandshakesAnswered++;
+		memcpy(remoteSystem->answer, job->answer, sizeof(remoteSystem->answer));
+		*remoteSystem->reliabilityLayer.GetAuthenticatedEncryption()=job->authenticatedEncryption;
+
+		// Same as the answer to ID_OPEN_CONNECTION_REQUEST_2 in ProcessOfflineNetworkPacket()
+		SLNet::BitStream bsAnswer;
+		bsAnswer.Write((MessageID)ID_OPEN_CONNECTION_REPLY_2);
+		bsAnswer.WriteAlignedBytes((const unsigned char*) OFFLINE_MESSAGE_DATA_ID, sizeof(OFFLINE_MESSAGE_DATA_ID));
+		bsAnswer.Write(GetGuidFromSystemAddress(UNASSIGNED_SYSTEM_ADDRESS));
+		bsAnswer.Write(job->systemAddress);
+		bsAnswer.Write(job->mtu);
+		bsAnswer.Write(true);
+		bsAnswer.WriteAlignedBytes((const unsigned char *) remoteSystem->answer,sizeof(remoteSystem->answer));
+
+		for (unsigned int i=0; i < pluginListNTS.Size(); i++)
+			pluginListNTS[i]->OnDirectSocketSend((const char*) bsAnswer.GetData(), bsAnswer.GetNumberOfBitsUsed(), job->systemAddress);
+		RNS2_SendParameters bsp;
+		bsp.data = (char*) bsAnswer.GetData();
+		bsp.length = bsAnswer.GetNumberOfBytesUsed();
+		bsp.systemAddress = job->systemAddress;
+		remoteSystem->rakNetSocket->Send(&bsp, _FILE_AND_LINE_);
+
+		SLNet::OP_DELETE(job, _FILE_AND_LINE_);
+	}
+}
+#endif
+
 void RakPeer::FillIPList(void)
 {
 	if (ipList[0]!=UNASSIGNED_SYSTEM_ADDRESS)
@@ -21,7 +21,6 @@
 #include <string.h>
 #include "slikenet/LinuxStrings.h"
 #include "slikenet/StringCompressor.h"
-#include "slikenet/SimpleMutex.h"
 #include <stdlib.h>
 #include "slikenet/Itoa.h"
 #include <limits>
@@ -30,29 +29,6 @@
 
 using namespace SLNet;
 
-//DataStructures::MemoryPool<RakString::SharedString> RakString::pool;
-RakString::SharedString RakString::emptyString={0,0,0,(char*) "",(char*) ""};
-//RakString::SharedString *RakString::sharedStringFreeList=0;
-//unsigned int RakString::sharedStringFreeListAllocationCount=0;
-DataStructures::List<RakString::SharedString*> RakString::freeList;
-
-class RakStringCleanup
-{
-public:
-	~RakStringCleanup()
-	{
-		SLNet::RakString::FreeMemoryNoMutex();
-	}
-};
-
-static RakStringCleanup cleanup;
-
-SimpleMutex& GetPoolMutex(void)
-{
-	static SimpleMutex poolMutex;
-	return poolMutex;
-}
-
 int SLNet::RakString::RakStringComp( RakString const &key, RakString const &data )
 {
 	return key.StrCmp(data);
@@ -60,14 +36,17 @@ int SLNet::RakString::RakStringComp( RakString const &key, RakString const &data
 
 RakString::RakString()
 {
-	sharedString=&emptyString;
+	sharedString=0;
+	inlineString[0]=0;
 }
 RakString::RakString( RakString::SharedString *_sharedString )
 {
 	sharedString=_sharedString;
+	inlineString[0]=0;
 }
 RakString::RakString(char input)
 {
+	sharedString=0;
 	char str[2];
 	str[0]=input;
 	str[1]=0;
@@ -75,18 +54,23 @@ RakString::RakString(char input)
 }
 RakString::RakString(unsigned char input)
 {
+	sharedString=0;
 	char str[2];
 	str[0]=(char) input;
 	str[1]=0;
 	Assign(str);
 }
 RakString::RakString(const unsigned char *format, ...){
+	sharedString=0;
+	inlineString[0]=0;
 	va_list ap;
 	va_start(ap, format);
 	Assign((const char*) format,ap);
 	va_end(ap);
 }
 RakString::RakString(const char *format, ...){
+	sharedString=0;
+	inlineString[0]=0;
 	va_list ap;
 	va_start(ap, format);
 	Assign(format,ap);
@@ -94,23 +78,11 @@ RakString::RakString(const char *format, ...){
 }
 RakString::RakString( const RakString & rhs)
 {
-	if (rhs.sharedString==&emptyString)
-	{
-		sharedString=&emptyString;
-		return;
-	}
-
-	rhs.sharedString->refCountMutex->Lock();
-	if (rhs.sharedString->refCount==0)
-	{
-		sharedString=&emptyString;
-	}
+	sharedString=rhs.sharedString;
+	if (sharedString)
+		sharedString->refCount.Increment();
 	else
-	{
-		rhs.sharedString->refCount++;
-		sharedString=rhs.sharedString;
-	}
-	rhs.sharedString->refCountMutex->Unlock();
+		memcpy(inlineString, rhs.inlineString, RAKSTRING_INLINE_SIZE);
 }
 RakString::~RakString()
 {
@@ -118,25 +90,27 @@ RakString::~RakString()
 }
 RakString& RakString::operator = ( const RakString& rhs )
 {
-	Free();
-	if (rhs.sharedString==&emptyString)
+	if (this==&rhs)
 		return *this;
 
-	rhs.sharedString->refCountMutex->Lock();
-	if (rhs.sharedString->refCount==0)
-	{
-		sharedString=&emptyString;
-	}
-	else
-	{
-		sharedString=rhs.sharedString;
-		sharedString->refCount++;
-	}
-	rhs.sharedString->refCountMutex->Unlock();
+	// Take the new reference first, in case rhs is only kept alive by this string
+	if (rhs.sharedString)
+		rhs.sharedString->refCount.Increment();
+	Free();
+	sharedString=rhs.sharedString;
+	if (sharedString==0)
+		memcpy(inlineString, rhs.inlineString, RAKSTRING_INLINE_SIZE);
 	return *this;
 }
 RakString& RakString::operator = ( const char *str )
 {
+	if (str>=GetBuffer() && str<GetBuffer()+GetCapacity())
+	{
+		// Assigning part of this string to itself
+		RakString copy;
+		copy.Assign(str);
+		return operator = (copy);
+	}
 	Free();
 	Assign(str);
 	return *this;
@@ -160,28 +134,18 @@ RakString& RakString::operator = ( const char c )
 	buff[1]=0;
 	return operator = ((const char*)buff);
 }
-void RakString::Realloc(SharedString *inSharedString, size_t bytes)
+void RakString::Realloc(size_t bytes)
 {
-	if (bytes<= inSharedString->bytesUsed)
+	if (bytes<= GetCapacity())
 		return;
 
 	RakAssert(bytes>0);
-	size_t oldBytes = inSharedString->bytesUsed;
-	size_t newBytes;
-	const size_t smallStringSize = 128-sizeof(unsigned int)-sizeof(size_t)-sizeof(char*)*2;
-	newBytes = GetSizeToAllocate(bytes);
-	if (oldBytes <=(size_t) smallStringSize && newBytes > (size_t) smallStringSize)
-	{
-		inSharedString->bigString=(char*) rakMalloc_Ex(newBytes, _FILE_AND_LINE_);
-		strcpy_s(inSharedString->bigString, newBytes, inSharedString->smallString);
-		inSharedString->c_str= inSharedString->bigString;
-	}
-	else if (oldBytes > smallStringSize)
-	{
-		inSharedString->bigString=(char*) rakRealloc_Ex(inSharedString->bigString,newBytes, _FILE_AND_LINE_);
-		inSharedString->c_str= inSharedString->bigString;
-	}
-	inSharedString->bytesUsed=newBytes;
+	RakAssert(sharedString==0 || sharedString->refCount.GetValue()==1);
+	SharedString *ss = AllocateSharedString(GetSizeToAllocate(bytes));
+	strcpy_s(ss->c_str(), ss->bytesUsed, GetBuffer());
+	if (sharedString)
+		ReleaseSharedString(sharedString);
+	sharedString=ss;
 }
 RakString& RakString::operator +=( const RakString& rhs)
 {
@@ -196,8 +160,8 @@ RakString& RakString::operator +=( const RakString& rhs)
 	{
 		Clone();
 		size_t strLen=rhs.GetLength()+GetLength()+1;
-		Realloc(sharedString, strLen+GetLength());
-		strcat_s(sharedString->c_str,sharedString->bytesUsed,rhs.C_String());
+		Realloc(strLen+GetLength());
+		strcat_s(GetBuffer(),GetCapacity(),rhs.C_String());
 	}
 	return *this;
 }
@@ -214,8 +178,8 @@ RakString& RakString::operator +=( const char *str )
 	{
 		Clone();
 		size_t strLen=strlen(str)+GetLength()+1;
-		Realloc(sharedString, strLen);
-		strcat_s(sharedString->c_str,sharedString->bytesUsed,str);
+		Realloc(strLen);
+		strcat_s(GetBuffer(),GetCapacity(),str);
 	}
 	return *this;
 }
@@ -241,123 +205,69 @@ RakString& RakString::operator +=( const char c )
 unsigned char RakString::operator[] ( const unsigned int position ) const
 {
 	RakAssert(position<GetLength());
-	return sharedString->c_str[position];
+	return GetBuffer()[position];
 }
 bool RakString::operator==(const RakString &rhs) const
 {
-	return strcmp(sharedString->c_str,rhs.sharedString->c_str)==0;
+	return strcmp(GetBuffer(),rhs.GetBuffer())==0;
 }
 bool RakString::operator==(const char *str) const
 {
-	return strcmp(sharedString->c_str,str)==0;
+	return strcmp(GetBuffer(),str)==0;
 }
 bool RakString::operator==(char *str) const
 {
-	return strcmp(sharedString->c_str,str)==0;
+	return strcmp(GetBuffer(),str)==0;
 }
 bool RakString::operator < ( const RakString& right ) const
 {
-	return strcmp(sharedString->c_str,right.C_String()) < 0;
+	return strcmp(GetBuffer(),right.C_String()) < 0;
 }
 bool RakString::operator <= ( const RakString& right ) const
 {
-	return strcmp(sharedString->c_str,right.C_String()) <= 0;
+	return strcmp(GetBuffer(),right.C_String()) <= 0;
 }
 bool RakString::operator > ( const RakString& right ) const
 {
-	return strcmp(sharedString->c_str,right.C_String()) > 0;
+	return strcmp(GetBuffer(),right.C_String()) > 0;
 }
 bool RakString::operator >= ( const RakString& right ) const
 {
-	return strcmp(sharedString->c_str,right.C_String()) >= 0;
+	return strcmp(GetBuffer(),right.C_String()) >= 0;
 }
 bool RakString::operator!=(const RakString &rhs) const
 {
-	return strcmp(sharedString->c_str,rhs.sharedString->c_str)!=0;
+	return strcmp(GetBuffer(),rhs.GetBuffer())!=0;
 }
 bool RakString::operator!=(const char *str) const
 {
-	return strcmp(sharedString->c_str,str)!=0;
+	return strcmp(GetBuffer(),str)!=0;
 }
 bool RakString::operator!=(char *str) const
 {
-	return strcmp(sharedString->c_str,str)!=0;
+	return strcmp(GetBuffer(),str)!=0;
 }
 const SLNet::RakString operator+(const SLNet::RakString &lhs, const SLNet::RakString &rhs)
 {
-	if (lhs.IsEmpty() && rhs.IsEmpty())
-	{
-		return RakString(&RakString::emptyString);
-	}
 	if (lhs.IsEmpty())
-	{
-		rhs.sharedString->refCountMutex->Lock();
-		if (rhs.sharedString->refCount==0)
-		{
-			rhs.sharedString->refCountMutex->Unlock();
-			lhs.sharedString->refCountMutex->Lock();
-			lhs.sharedString->refCount++;
-			lhs.sharedString->refCountMutex->Unlock();
-			return RakString(lhs.sharedString);
-		}
-		else
-		{
-			rhs.sharedString->refCount++;
-			rhs.sharedString->refCountMutex->Unlock();
-			return RakString(rhs.sharedString);
-		}
-		// rhs.sharedString->refCountMutex->Unlock();
-	}
+		return rhs;
 	if (rhs.IsEmpty())
-	{
-		lhs.sharedString->refCountMutex->Lock();
-		lhs.sharedString->refCount++;
-		lhs.sharedString->refCountMutex->Unlock();
-		return RakString(lhs.sharedString);
-	}
+		return lhs;
 
 	size_t len1 = lhs.GetLength();
 	size_t len2 = rhs.GetLength();
 	size_t allocatedBytes = len1 + len2 + 1;
-	allocatedBytes = RakString::GetSizeToAllocate(allocatedBytes);
-	RakString::SharedString *sharedString;
-
-	RakString::LockMutex();
-	// sharedString = RakString::pool.Allocate( _FILE_AND_LINE_ );
-	if (RakString::freeList.Size()==0)
-	{
-		//RakString::sharedStringFreeList=(RakString::SharedString*) rakRealloc_Ex(RakString::sharedStringFreeList,(RakString::sharedStringFreeListAllocationCount+1024)*sizeof(RakString::SharedString), _FILE_AND_LINE_);
-		unsigned i;
-		for (i=0; i < 128; i++)
-		{
-		//	RakString::freeList.Insert(RakString::sharedStringFreeList+i+RakString::sharedStringFreeListAllocationCount);
-			RakString::SharedString *ss;
-			ss = (RakString::SharedString*) rakMalloc_Ex(sizeof(RakString::SharedString), _FILE_AND_LINE_);
-			ss->refCountMutex= SLNet::OP_NEW<SimpleMutex>(_FILE_AND_LINE_);
-			RakString::freeList.Insert(ss, _FILE_AND_LINE_);
-
-		}
-		//RakString::sharedStringFreeListAllocationCount+=1024;
-	}
-	sharedString = RakString::freeList[RakString::freeList.Size()-1];
-	RakString::freeList.RemoveAtIndex(RakString::freeList.Size()-1);
-	RakString::UnlockMutex();
-
-	const int smallStringSize = 128-sizeof(unsigned int)-sizeof(size_t)-sizeof(char*)*2;
-	sharedString->bytesUsed=allocatedBytes;
-	sharedString->refCount=1;
-	if (allocatedBytes <= (size_t) smallStringSize)
-	{
-		sharedString->c_str=sharedString->smallString;
-	}
-	else
+	if (allocatedBytes <= RAKSTRING_INLINE_SIZE)
 	{
-		sharedString->bigString=(char*)rakMalloc_Ex(sharedString->bytesUsed, _FILE_AND_LINE_);
-		sharedString->c_str=sharedString->bigString;
+		RakString result;
+		memcpy(result.inlineString, lhs.C_String(), len1);
+		memcpy(result.inlineString+len1, rhs.C_String(), len2+1);
+		return result;
 	}
 
-	strcpy_s(sharedString->c_str, sharedString->bytesUsed, lhs);
-	strcat_s(sharedString->c_str, sharedString->bytesUsed, rhs);
+	RakString::SharedString *sharedString = RakString::AllocateSharedString(RakString::GetSizeToAllocate(allocatedBytes));
+	memcpy(sharedString->c_str(), lhs.C_String(), len1);
+	memcpy(sharedString->c_str()+len1, rhs.C_String(), len2+1);
 
 	return RakString(sharedString);
 }
@@ -365,21 +275,21 @@ const char * RakString::ToLower(void)
 {
 	Clone();
 
-	size_t strLen = strlen(sharedString->c_str);
+	size_t strLen = strlen(GetBuffer());
 	unsigned i;
 	for (i=0; i < strLen; i++)
-		sharedString->c_str[i]=ToLower(sharedString->c_str[i]);
-	return sharedString->c_str;
+		GetBuffer()[i]=ToLower(GetBuffer()[i]);
+	return GetBuffer();
 }
 const char * RakString::ToUpper(void)
 {
 	Clone();
 
-	size_t strLen = strlen(sharedString->c_str);
+	size_t strLen = strlen(GetBuffer());
 	unsigned i;
 	for (i=0; i < strLen; i++)
-		sharedString->c_str[i]=ToUpper(sharedString->c_str[i]);
-	return sharedString->c_str;
+		GetBuffer()[i]=ToUpper(GetBuffer()[i]);
+	return GetBuffer();
 }
 void RakString::Set(const char *format, ...)
 {
@@ -391,14 +301,14 @@ void RakString::Set(const char *format, ...)
 }
 bool RakString::IsEmpty(void) const
 {
-	return sharedString==&emptyString;
+	return GetBuffer()[0]==0;
 }
 size_t RakString::GetLength(void) const
 {
-	return strlen(sharedString->c_str);
+	return strlen(GetBuffer());
 }
 // http://porg.es/blog/counting-characters-in-utf-8-strings-is-faster
-int porges_strlen2(char *s)
+int porges_strlen2(const char *s)
 {
 	int i = 0;
 	int iBefore = 0;
@@ -428,7 +338,7 @@ ascii:  i++;
 }
 size_t RakString::GetLengthUTF8(void) const
 {
-	return porges_strlen2(sharedString->c_str);
+	return porges_strlen2(GetBuffer());
 }
 void RakString::Replace(unsigned index, unsigned count, unsigned char c)
 {
@@ -437,7 +347,7 @@ void RakString::Replace(unsigned index, unsigned count, unsigned char c)
 	unsigned countIndex=0;
 	while (countIndex<count)
 	{
-		sharedString->c_str[index]=c;
+		GetBuffer()[index]=c;
 		index++;
 		countIndex++;
 	}
@@ -447,7 +357,7 @@ void RakString::SetChar( unsigned index, unsigned char c )
 {
 	RakAssert(index < GetLength());
 	Clone();
-	sharedString->c_str[index]=c;
+	GetBuffer()[index]=c;
 }
 void RakString::SetChar( unsigned index, SLNet::RakString s )
 {
@@ -466,7 +376,7 @@ WCHAR * RakString::ToWideChar(void)
 	//
 	// Special case of nullptr or empty input string
 	//
-	if ( (sharedString->c_str == nullptr) || (*sharedString->c_str == '\0') )
+	if ( (GetBuffer() == nullptr) || (*GetBuffer() == '\0') )
 	{
 		// Return empty string
 		WCHAR* buf = SLNet::OP_NEW_ARRAY<WCHAR>(1, __FILE__, __LINE__);
@@ -480,7 +390,7 @@ WCHAR * RakString::ToWideChar(void)
 	int cchUTF16 = ::MultiByteToWideChar(
 		CP_UTF8,                // convert from UTF-8
 		0,						// Flags
-		sharedString->c_str,    // source UTF-8 string
+		GetBuffer(),    // source UTF-8 string
 		-1,                     // -1 means string is zero-terminated
 		nullptr,                // unused - no conversion done in this step
 		0                       // request size of destination buffer, in WCHAR's
@@ -503,7 +413,7 @@ WCHAR * RakString::ToWideChar(void)
 	int result = ::MultiByteToWideChar(
 		CP_UTF8,                // convert from UTF-8
 		0,						// Buffer
-		sharedString->c_str,    // source UTF-8 string
+		GetBuffer(),    // source UTF-8 string
 		-1,                     // -1 means string is zero-terminated
 		pszUTF16,               // destination buffer
 		cchUTF16                // size of destination buffer, in WCHAR's
@@ -541,7 +451,7 @@ void RakString::FromWideChar(const wchar_t *source)
 
                           source,         // Source Unicode string
                           -1,                    // -1 means string is zero-terminated
-                          sharedString->c_str,          // Destination char string
+                          GetBuffer(),          // Destination char string
                           static_cast<int>(bufSize),  // Size of buffer
                           nullptr,                  // No default character
                           nullptr );                // Don't care about this flag
@@ -568,7 +478,7 @@ size_t RakString::Find(const char *stringToFind,size_t pos)
 
 	for (size_t i=pos;i<len;i++)
 	{
-		if (stringToFind[matchPos]==sharedString->c_str[i])
+		if (stringToFind[matchPos]==GetBuffer()[i])
 		{
 			if(matchPos==0)
 			{
@@ -595,20 +505,20 @@ void RakString::TruncateUTF8(unsigned int length)
 	int i = 0;
 	unsigned int count = 0;
 
-	while (sharedString->c_str[i]!=0)
+	while (GetBuffer()[i]!=0)
 	{
 		if (count==length)
 		{
-			sharedString->c_str[i]=0;
+			GetBuffer()[i]=0;
 			return;
 		}
-		else if (sharedString->c_str[i]>0)
+		else if (GetBuffer()[i]>0)
 		{
 			i++;
 		}
 		else
 		{
-			switch (0xF0 & sharedString->c_str[i])
+			switch (0xF0 & GetBuffer()[i])
 			{
 			case 0xE0: i += 3; break;
 			case 0xF0: i += 4; break;
@@ -640,8 +550,8 @@ RakString RakString::SubStr(unsigned int index, size_t count) const
 	copy.Allocate(numBytes+1);
 	size_t i;
 	for (i=0; i < numBytes; i++)
-		copy.sharedString->c_str[i]=sharedString->c_str[index+i];
-	copy.sharedString->c_str[i]=0;
+		copy.GetBuffer()[i]=GetBuffer()[index+i];
+	copy.GetBuffer()[i]=0;
 	return copy;
 }
 void RakString::Erase(unsigned int index, unsigned int count)
@@ -653,19 +563,19 @@ void RakString::Erase(unsigned int index, unsigned int count)
 	unsigned i;
 	for (i=index; i < len-count; i++)
 	{
-		sharedString->c_str[i]=sharedString->c_str[i+count];
+		GetBuffer()[i]=GetBuffer()[i+count];
 	}
-	sharedString->c_str[i]=0;
+	GetBuffer()[i]=0;
 }
 void RakString::TerminateAtLastCharacter(char c)
 {
 	int i, len=(int) GetLength();
 	for (i=len-1; i >= 0; i--)
 	{
-		if (sharedString->c_str[i]==c)
+		if (GetBuffer()[i]==c)
 		{
 			Clone();
-			sharedString->c_str[i]=0;
+			GetBuffer()[i]=0;
 			return;
 		}
 	}
@@ -675,7 +585,7 @@ void RakString::StartAfterLastCharacter(char c)
 	int i, len=(int) GetLength();
 	for (i=len-1; i >= 0; i--)
 	{
-		if (sharedString->c_str[i]==c)
+		if (GetBuffer()[i]==c)
 		{
 			++i;
 			if (i < len)
@@ -691,12 +601,12 @@ void RakString::TerminateAtFirstCharacter(char c)
 	unsigned int i, len=(unsigned int) GetLength();
 	for (i=0; i < len; i++)
 	{
-		if (sharedString->c_str[i]==c)
+		if (GetBuffer()[i]==c)
 		{
 			if (i > 0)
 			{
 				Clone();
-				sharedString->c_str[i]=0;
+				GetBuffer()[i]=0;
 			}
 		}
 	}
@@ -706,7 +616,7 @@ void RakString::StartAfterFirstCharacter(char c)
 	unsigned int i, len=(unsigned int) GetLength();
 	for (i=0; i < len; i++)
 	{
-		if (sharedString->c_str[i]==c)
+		if (GetBuffer()[i]==c)
 		{
 			++i;
 			if (i < len)
@@ -723,7 +633,7 @@ int RakString::GetCharacterCount(char c)
 	unsigned int i, len=(unsigned int) GetLength();
 	for (i=0; i < len; i++)
 	{
-		if (sharedString->c_str[i]==c)
+		if (GetBuffer()[i]==c)
 		{
 			++count;
 		}
@@ -736,36 +646,36 @@ void RakString::RemoveCharacter(char c)
 		return;
 
 	unsigned int readIndex, writeIndex=0;
-	for (readIndex=0; sharedString->c_str[readIndex]; readIndex++)
+	for (readIndex=0; GetBuffer()[readIndex]; readIndex++)
 	{
-		if (sharedString->c_str[readIndex]!=c)
-			sharedString->c_str[writeIndex++]=sharedString->c_str[readIndex];
+		if (GetBuffer()[readIndex]!=c)
+			GetBuffer()[writeIndex++]=GetBuffer()[readIndex];
 		else
 			Clone();
 	}
-	sharedString->c_str[writeIndex]=0;
+	GetBuffer()[writeIndex]=0;
 	if (writeIndex==0)
 		Clear();
 }
 int RakString::StrCmp(const RakString &rhs) const
 {
-	return strcmp(sharedString->c_str, rhs.C_String());
+	return strcmp(GetBuffer(), rhs.C_String());
 }
 int RakString::StrNCmp(const RakString &rhs, size_t num) const
 {
-	return strncmp(sharedString->c_str, rhs.C_String(), num);
+	return strncmp(GetBuffer(), rhs.C_String(), num);
 }
 int RakString::StrICmp(const RakString &rhs) const
 {
-	return _stricmp(sharedString->c_str, rhs.C_String());
+	return _stricmp(GetBuffer(), rhs.C_String());
 }
 void RakString::Printf(void)
 {
-	RAKNET_DEBUG_PRINTF("%s", sharedString->c_str);
+	RAKNET_DEBUG_PRINTF("%s", GetBuffer());
 }
 void RakString::FPrintf(FILE *fp)
 {
-	fprintf(fp,"%s", sharedString->c_str);
+	fprintf(fp,"%s", GetBuffer());
 }
 bool RakString::IPAddressMatch(const char *IP)
 {
@@ -778,7 +688,7 @@ bool RakString::IPAddressMatch(const char *IP)
 
 	for(;;)
 	{
-		if (sharedString->c_str[ characterIndex ] == IP[ characterIndex ] )
+		if (GetBuffer()[ characterIndex ] == IP[ characterIndex ] )
 		{
 			// Equal characters
 			if ( IP[ characterIndex ] == 0 )
@@ -793,14 +703,14 @@ bool RakString::IPAddressMatch(const char *IP)
 
 		else
 		{
-			if ( sharedString->c_str[ characterIndex ] == 0 || IP[ characterIndex ] == 0 )
+			if ( GetBuffer()[ characterIndex ] == 0 || IP[ characterIndex ] == 0 )
 			{
 				// End of one of the strings
 				break;
 			}
 
 			// Characters do not match
-			if ( sharedString->c_str[ characterIndex ] == '*' )
+			if ( GetBuffer()[ characterIndex ] == '*' )
 			{
 				// Domain is banned.
 				return true;
@@ -817,11 +727,11 @@ bool RakString::IPAddressMatch(const char *IP)
 }
 bool RakString::ContainsNonprintableExceptSpaces(void) const
 {
-	size_t strLen = strlen(sharedString->c_str);
+	size_t strLen = strlen(GetBuffer());
 	unsigned i;
 	for (i=0; i < strLen; i++)
 	{
-		if (sharedString->c_str[i] < ' ' || sharedString->c_str[i] >126)
+		if (GetBuffer()[i] < ' ' || GetBuffer()[i] >126)
 			return true;
 	}
 	return false;
@@ -830,22 +740,22 @@ bool RakString::IsEmailAddress(void) const
 {
 	if (IsEmpty())
 		return false;
-	size_t strLen = strlen(sharedString->c_str);
+	size_t strLen = strlen(GetBuffer());
 	if (strLen < 6) // a@b.de
 		return false;
-	if (sharedString->c_str[strLen-4]!='.' && sharedString->c_str[strLen-3]!='.') // .com, .net., .org, .de
+	if (GetBuffer()[strLen-4]!='.' && GetBuffer()[strLen-3]!='.') // .com, .net., .org, .de
 		return false;
 	unsigned i;
 	// Has non-printable?
 	for (i=0; i < strLen; i++)
 	{
-		if (sharedString->c_str[i] <= ' ' || sharedString->c_str[i] >126)
+		if (GetBuffer()[i] <= ' ' || GetBuffer()[i] >126)
 			return false;
 	}
 	int atCount=0;
 	for (i=0; i < strLen; i++)
 	{
-		if (sharedString->c_str[i]=='@')
+		if (GetBuffer()[i]=='@')
 		{
 			atCount++;
 		}
@@ -855,7 +765,7 @@ bool RakString::IsEmailAddress(void) const
 	int dotCount=0;
 	for (i=0; i < strLen; i++)
 	{
-		if (sharedString->c_str[i]=='.')
+		if (GetBuffer()[i]=='.')
 		{
 			dotCount++;
 		}
@@ -869,15 +779,15 @@ bool RakString::IsEmailAddress(void) const
 SLNet::RakString& RakString::URLEncode(void)
 {
 	RakString result;
-	size_t strLen = strlen(sharedString->c_str);
-	result.Allocate(strLen*3);
-	char *output=result.sharedString->c_str;
+	size_t strLen = strlen(GetBuffer());
+	result.Allocate(strLen*3+1);
+	char *output=result.GetBuffer();
 	unsigned int outputIndex=0;
 	unsigned i;
 	unsigned char c;
 	for (i=0; i < strLen; i++)
 	{
-		c=sharedString->c_str[i];
+		c=GetBuffer()[i];
 		if (
 			(c<=47) ||
 			(c>=58 && c<=64) ||
@@ -905,9 +815,9 @@ SLNet::RakString& RakString::URLEncode(void)
 SLNet::RakString& RakString::URLDecode(void)
 {
 	RakString result;
-	size_t strLen = strlen(sharedString->c_str);
-	result.Allocate(strLen);
-	char *output=result.sharedString->c_str;
+	size_t strLen = strlen(GetBuffer());
+	result.Allocate(strLen+1);
+	char *output=result.GetBuffer();
 	unsigned int outputIndex=0;
 	char c;
 	char hexDigits[2];
@@ -915,11 +825,11 @@ SLNet::RakString& RakString::URLDecode(void)
 	unsigned int i;
 	for (i=0; i < strLen; i++)
 	{
-		c=sharedString->c_str[i];
+		c=GetBuffer()[i];
 		if (c=='%')
 		{
-			hexDigits[0]=sharedString->c_str[++i];
-			hexDigits[1]=sharedString->c_str[++i];
+			hexDigits[0]=GetBuffer()[++i];
+			hexDigits[1]=GetBuffer()[++i];
 			
 			if (hexDigits[0]==' ')
 				hexValues[0]=0;
@@ -957,39 +867,39 @@ void RakString::SplitURI(SLNet::RakString &header, SLNet::RakString &domain, SLN
 	domain.Clear();
 	path.Clear();
 
-	size_t strLen = strlen(sharedString->c_str);
+	size_t strLen = strlen(GetBuffer());
 
 	char c;
 	unsigned int i=0;
-	if (strncmp(sharedString->c_str, "http://", 7)==0)
+	if (strncmp(GetBuffer(), "http://", 7)==0)
 		i+=(unsigned int) strlen("http://");
-	else if (strncmp(sharedString->c_str, "https://", 8)==0)
+	else if (strncmp(GetBuffer(), "https://", 8)==0)
 		i+=(unsigned int) strlen("https://");
 	
-	if (strncmp(sharedString->c_str, "www.", 4)==0)
+	if (strncmp(GetBuffer(), "www.", 4)==0)
 		i+=(unsigned int) strlen("www.");
 
 	if (i!=0)
 	{
 		header.Allocate(i+1);
-		strncpy_s(header.sharedString->c_str, header.sharedString->bytesUsed, sharedString->c_str, i);
-		header.sharedString->c_str[i]=0;
+		strncpy_s(header.GetBuffer(), header.GetCapacity(), GetBuffer(), i);
+		header.GetBuffer()[i]=0;
 	}
 
 
 	domain.Allocate(strLen-i+1);
-	char *domainOutput=domain.sharedString->c_str;
+	char *domainOutput=domain.GetBuffer();
 	unsigned int outputIndex=0;
 	for (; i < strLen; i++)
 	{
-		c=sharedString->c_str[i];
+		c=GetBuffer()[i];
 		if (c=='/')
 		{
 			break;
 		}
 		else
 		{
-			domainOutput[outputIndex++]=sharedString->c_str[i];
+			domainOutput[outputIndex++]=GetBuffer()[i];
 		}
 	}
 
@@ -997,10 +907,10 @@ void RakString::SplitURI(SLNet::RakString &header, SLNet::RakString &domain, SLN
 
 	path.Allocate(strLen-header.GetLength()-outputIndex+1);
 	outputIndex=0;
-	char *pathOutput=path.sharedString->c_str;
+	char *pathOutput=path.GetBuffer();
 	for (; i < strLen; i++)
 	{
-		pathOutput[outputIndex++]=sharedString->c_str[i];
+		pathOutput[outputIndex++]=GetBuffer()[i];
 	}
 	pathOutput[outputIndex]=0;
 }
@@ -1011,31 +921,31 @@ SLNet::RakString& RakString::SQLEscape(void)
 	int index;
 	for (index=0; index < strLen; index++)
 	{
-		if (sharedString->c_str[index]=='\'' ||
-			sharedString->c_str[index]=='"' ||
-			sharedString->c_str[index]=='\\')
+		if (GetBuffer()[index]=='\'' ||
+			GetBuffer()[index]=='"' ||
+			GetBuffer()[index]=='\\')
 			escapedCharacterCount++;
 	}
 	if (escapedCharacterCount==0)
 		return *this;
 
 	Clone();
-	Realloc(sharedString, strLen+escapedCharacterCount);
+	Realloc(strLen+escapedCharacterCount+1);
 	int writeIndex, readIndex;
 	writeIndex = strLen+escapedCharacterCount;
 	readIndex=strLen;
 	while (readIndex>=0)
 	{
-		if (sharedString->c_str[readIndex]=='\'' ||
-			sharedString->c_str[readIndex]=='"' ||
-			sharedString->c_str[readIndex]=='\\')
+		if (GetBuffer()[readIndex]=='\'' ||
+			GetBuffer()[readIndex]=='"' ||
+			GetBuffer()[readIndex]=='\\')
 		{
-			sharedString->c_str[writeIndex--]=sharedString->c_str[readIndex--];
-			sharedString->c_str[writeIndex--]='\\';
+			GetBuffer()[writeIndex--]=GetBuffer()[readIndex--];
+			GetBuffer()[writeIndex--]='\\';
 		}
 		else
 		{
-			sharedString->c_str[writeIndex--]=sharedString->c_str[readIndex--];
+			GetBuffer()[writeIndex--]=GetBuffer()[readIndex--];
 		}
 	}
 	return *this;
@@ -1184,24 +1094,24 @@ SLNet::RakString& RakString::MakeFilePath(void)
 
 	SLNet::RakString fixedString = *this;
 	fixedString.Clone();
-	for (int i=0; fixedString.sharedString->c_str[i]; i++)
+	for (int i=0; fixedString.GetBuffer()[i]; i++)
 	{
 #ifdef _WIN32
-		if (fixedString.sharedString->c_str[i]=='/')
-			fixedString.sharedString->c_str[i]='\\';
+		if (fixedString.GetBuffer()[i]=='/')
+			fixedString.GetBuffer()[i]='\\';
 #else
-		if (fixedString.sharedString->c_str[i]=='\\')
-			fixedString.sharedString->c_str[i]='/';
+		if (fixedString.GetBuffer()[i]=='\\')
+			fixedString.GetBuffer()[i]='/';
 #endif
 	}
 
 #ifdef _WIN32
-	if (fixedString.sharedString->c_str[strlen(fixedString.sharedString->c_str)-1]!='\\')
+	if (fixedString.GetBuffer()[strlen(fixedString.GetBuffer())-1]!='\\')
 	{
 		fixedString+='\\';
 	}
 #else
-	if (fixedString.sharedString->c_str[strlen(fixedString.sharedString->c_str)-1]!='/')
+	if (fixedString.GetBuffer()[strlen(fixedString.GetBuffer())-1]!='/')
 	{
 		fixedString+='/';
 	}
@@ -1213,22 +1123,13 @@ SLNet::RakString& RakString::MakeFilePath(void)
 }
 void RakString::FreeMemory(void)
 {
-	LockMutex();
-	FreeMemoryNoMutex();
-	UnlockMutex();
 }
 void RakString::FreeMemoryNoMutex(void)
 {
-	for (unsigned int i=0; i < freeList.Size(); i++)
-	{
-		SLNet::OP_DELETE(freeList[i]->refCountMutex,_FILE_AND_LINE_);
-		rakFree_Ex(freeList[i], _FILE_AND_LINE_ );
-	}
-	freeList.Clear(false, _FILE_AND_LINE_);
 }
 void RakString::Serialize(BitStream *bs) const
 {
-	Serialize(sharedString->c_str, bs);
+	Serialize(GetBuffer(), bs);
 }
 void RakString::Serialize(const char *str, BitStream *bs)
 {
@@ -1256,9 +1157,9 @@ bool RakString::Deserialize(BitStream *bs)
 	if (l>0)
 	{
 		Allocate(((unsigned int) l)+1);
-		b=bs->ReadAlignedBytes((unsigned char*) sharedString->c_str, l);
+		b=bs->ReadAlignedBytes((unsigned char*) GetBuffer(), l);
 		if (b)
-			sharedString->c_str[l]=0;
+			GetBuffer()[l]=0;
 		else
 			Clear();
 	}
@@ -1332,59 +1233,47 @@ void RakString::Clear(void)
 }
 void RakString::Allocate(size_t len)
 {
-	RakString::LockMutex();
-	// sharedString = RakString::pool.Allocate( _FILE_AND_LINE_ );
-	if (RakString::freeList.Size()==0)
-	{
-		//RakString::sharedStringFreeList=(RakString::SharedString*) rakRealloc_Ex(RakString::sharedStringFreeList,(RakString::sharedStringFreeListAllocationCount+1024)*sizeof(RakString::SharedString), _FILE_AND_LINE_);
-		unsigned i;
-		for (i=0; i < 128; i++)
-		{
-			//	RakString::freeList.Insert(RakString::sharedStringFreeList+i+RakString::sharedStringFreeListAllocationCount);
-	//		RakString::freeList.Insert((RakString::SharedString*)rakMalloc_Ex(sizeof(RakString::SharedString), _FILE_AND_LINE_), _FILE_AND_LINE_);
-
-			RakString::SharedString *ss;
-			ss = (RakString::SharedString*) rakMalloc_Ex(sizeof(RakString::SharedString), _FILE_AND_LINE_);
-			ss->refCountMutex= SLNet::OP_NEW<SimpleMutex>(_FILE_AND_LINE_);
-			RakString::freeList.Insert(ss, _FILE_AND_LINE_);
-		}
-		//RakString::sharedStringFreeListAllocationCount+=1024;
-	}
-	sharedString = RakString::freeList[RakString::freeList.Size()-1];
-	RakString::freeList.RemoveAtIndex(RakString::freeList.Size()-1);
-	RakString::UnlockMutex();
-
-	const size_t smallStringSize = 128-sizeof(unsigned int)-sizeof(size_t)-sizeof(char*)*2;
-	sharedString->refCount=1;
-	if (len <= smallStringSize)
-	{
-		sharedString->bytesUsed=smallStringSize;
-		sharedString->c_str=sharedString->smallString;
-	}
-	else
+	// Replaces the contents
+	Free();
+	if (len > RAKSTRING_INLINE_SIZE)
+		sharedString=AllocateSharedString(len<<1);
+}
+RakString::SharedString *RakString::AllocateSharedString(size_t bytes)
+{
+	SharedString *ss = (SharedString*) rakMalloc_Ex(sizeof(SharedString)+bytes, _FILE_AND_LINE_);
+	// Placement new, since LocklessUint32_t holds a mutex on some platforms
+	ss = new ((void*)ss) SharedString;
+	ss->refCount.Store(1);
+	ss->bytesUsed=bytes;
+	return ss;
+}
+void RakString::ReleaseSharedString(SharedString *ss)
+{
+	if (ss->refCount.Decrement()==0)
 	{
-		sharedString->bytesUsed=len<<1;
-		sharedString->bigString=(char*)rakMalloc_Ex(sharedString->bytesUsed, _FILE_AND_LINE_);
-		sharedString->c_str=sharedString->bigString;
+		ss->~SharedString();
+		rakFree_Ex(ss, _FILE_AND_LINE_ );
 	}
 }
 void RakString::Assign(const char *str)
 {
 	if (str==0 || str[0]==0)
 	{
-		sharedString=&emptyString;
+		sharedString=0;
+		inlineString[0]=0;
 		return;
 	}
 
 	size_t len = strlen(str)+1;
 	Allocate(len);
-	memcpy(sharedString->c_str, str, len);
+	memcpy(GetBuffer(), str, len);
 }
 void RakString::Assign(const char *str, va_list ap)
 {
 	if (str==0 || str[0]==0)
 	{
-		sharedString=&emptyString;
+		sharedString=0;
+		inlineString[0]=0;
 		return;
 	}
 
@@ -1428,11 +1317,9 @@ SLNet::RakString RakString::Assign(const char *str,size_t pos, size_t n )
 {
 	size_t incomingLen=strlen(str);
 
-	Clone();
-
 	if (str==0 || str[0]==0||pos>=incomingLen)
 	{
-		sharedString=&emptyString;
+		Free();
 		return (*this);
 	}
 
@@ -1443,10 +1330,12 @@ SLNet::RakString RakString::Assign(const char *str,size_t pos, size_t n )
 	}
 	const char * tmpStr=&(str[pos]); 
 
-	size_t len = n+1;
-	Allocate(len);
-	memcpy(sharedString->c_str, tmpStr, len);
-	sharedString->c_str[n]=0;
+	// str may point into this string
+	RakString copy;
+	copy.Allocate(n+1);
+	memcpy(copy.GetBuffer(), tmpStr, n);
+	copy.GetBuffer()[n]=0;
+	*this=copy;
 
 	return (*this);
 }
@@ -1486,70 +1375,40 @@ void RakString::AppendBytes(const char *bytes, size_t count)
 {
 	if (IsEmpty())
 	{
-		Allocate(count);
-		memcpy(sharedString->c_str, bytes, count+1);
-		sharedString->c_str[count]=0;
+		Allocate(count+1);
+		memcpy(GetBuffer(), bytes, count);
+		GetBuffer()[count]=0;
 	}
 	else
 	{
 		Clone();
 		unsigned int length=(unsigned int) GetLength();
-		Realloc(sharedString, count+length+1);
-		memcpy(sharedString->c_str+length, bytes, count);
-		sharedString->c_str[length+count]=0;
+		Realloc(count+length+1);
+		memcpy(GetBuffer()+length, bytes, count);
+		GetBuffer()[length+count]=0;
 	}
 
 	
 }
 void RakString::Clone(void)
 {
-	RakAssert(sharedString!=&emptyString);
-	if (sharedString==&emptyString)
-	{
-		return;
-	}
-
-	// Empty or solo then no point to cloning
-	sharedString->refCountMutex->Lock();
-	if (sharedString->refCount==1)
-	{
-		sharedString->refCountMutex->Unlock();
+	// Inline or solo then no point to cloning
+	if (sharedString==0 || sharedString->refCount.Load()==1)
 		return;
-	}
 
-	sharedString->refCount--;
-	sharedString->refCountMutex->Unlock();
-	Assign(sharedString->c_str);
+	SharedString *oldSharedString=sharedString;
+	sharedString=0;
+	Assign(oldSharedString->c_str());
+	ReleaseSharedString(oldSharedString);
 }
 void RakString::Free(void)
 {
-	if (sharedString==&emptyString)
-		return;
-	sharedString->refCountMutex->Lock();
-	sharedString->refCount--;
-	if (sharedString->refCount==0)
-	{
-		sharedString->refCountMutex->Unlock();
-		const size_t smallStringSize = 128-sizeof(unsigned int)-sizeof(size_t)-sizeof(char*)*2;
-		if (sharedString->bytesUsed>smallStringSize)
-			rakFree_Ex(sharedString->bigString, _FILE_AND_LINE_ );
-		/*
-		poolMutex->Lock();
-		pool.Release(sharedString);
-		poolMutex->Unlock();
-		*/
-
-		RakString::LockMutex();
-		RakString::freeList.Insert(sharedString, _FILE_AND_LINE_);
-		RakString::UnlockMutex();
-
-		sharedString=&emptyString;
-	}
-	else
+	if (sharedString)
 	{
-		sharedString->refCountMutex->Unlock();
+		ReleaseSharedString(sharedString);
+		sharedString=0;
 	}
-	sharedString=&emptyString;
+	inlineString[0]=0;
 }
 unsigned char RakString::ToLower(unsigned char c)
 {
@@ -1565,11 +1424,9 @@ unsigned char RakString::ToUpper(unsigned char c)
 }
 void RakString::LockMutex(void)
 {
-	GetPoolMutex().Lock();
 }
 void RakString::UnlockMutex(void)
 {
-	GetPoolMutex().Unlock();
 }
 
 /*
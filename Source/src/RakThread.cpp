@@ -138,6 +138,21 @@ int RakThread::Create( void* start_address( void* ), void *arglist, int priority
 #endif
 }
 
+unsigned int RakThread::GetCurrentThreadHash(void)
+{
+#ifdef _WIN32
+	return (unsigned int) GetCurrentThreadId();
+#else
+	// pthread_t is an opaque type, so fold its bytes
+	pthread_t self = pthread_self();
+	const unsigned char *bytes = (const unsigned char *) &self;
+	unsigned int hash = 2166136261u;
+	for (unsigned int i=0; i < sizeof(self); i++)
+		hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+#endif
+}
+
 
 
 
@@ -305,6 +305,15 @@ PluginReceiveResult ReadyEvent::OnReceive(Packet *packet)
 
 	return RR_CONTINUE_PROCESSING;
 }
+bool ReadyEvent::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_READY_EVENT_UNSET]=true;
+	messageIDs[ID_READY_EVENT_SET]=true;
+	messageIDs[ID_READY_EVENT_ALL_SET]=true;
+	messageIDs[ID_READY_EVENT_FORCE_ALL_SET]=true;
+	messageIDs[ID_READY_EVENT_QUERY]=true;
+	return true;
+}
 bool ReadyEvent::AddToWaitListInternal(unsigned eventIndex, RakNetGUID guid)
 {
 	ReadyEventNode *ren = readyEventNodeList[eventIndex];
@@ -520,11 +529,25 @@ void ReadyEvent::SendReadyUpdate(unsigned eventIndex, unsigned systemIndex, bool
 void ReadyEvent::BroadcastReadyUpdate(unsigned eventIndex, bool forceIfNotDefault)
 {
 	ReadyEventNode *ren = readyEventNodeList[eventIndex];
+	// Every system gets the same update, so collect the ones that need it and send it once
+	DataStructures::List<AddressOrGUID> targets;
 	unsigned systemIndex;
 	for (systemIndex=0; systemIndex < ren->systemList.Size(); systemIndex++)
 	{
-		SendReadyUpdate(eventIndex, systemIndex, forceIfNotDefault);
+		if ((ren->eventStatus!=ren->systemList[systemIndex].lastSentStatus) ||
+			(forceIfNotDefault && ren->eventStatus!=ID_READY_EVENT_UNSET))
+		{
+			targets.Push(ren->systemList[systemIndex].rakNetGuid, _FILE_AND_LINE_);
+			ren->systemList[systemIndex].lastSentStatus=ren->eventStatus;
+		}
 	}
+	if (targets.Size()==0)
+		return;
+
+	SLNet::BitStream bs;
+	bs.Write(ren->eventStatus);
+	bs.Write(ren->eventId);
+	SendToListUnified(&bs, HIGH_PRIORITY, RELIABLE_ORDERED, channel, &targets[0], targets.Size());
 }
 void ReadyEvent::SendReadyStateQuery(unsigned eventId, RakNetGUID guid)
 {
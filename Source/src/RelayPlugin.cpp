@@ -224,6 +224,12 @@ PluginReceiveResult RelayPlugin::OnReceive(Packet *packet)
 	return RR_CONTINUE_PROCESSING;
 }
 
+bool RelayPlugin::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_RELAY_PLUGIN]=true;
+	return true;
+}
+
 void RelayPlugin::OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason )
 {
 	(void) lostConnectionReason;
@@ -326,15 +332,19 @@ void RelayPlugin::LeaveGroup(StrAndGuidAndRoom **strAndGuidSender)
 }
 void RelayPlugin::NotifyUsersInRoom(RP_Group *room, int msg, const RakString& message)
 {
-	for (unsigned int i=0; i < room->usersInRoom.Size(); i++)
-	{
-		BitStream bsOut;
-		bsOut.WriteCasted<MessageID>(ID_RELAY_PLUGIN);
-		bsOut.WriteCasted<MessageID>(msg);
-		bsOut.WriteCompressed(message);
+	if (room->usersInRoom.Size()==0)
+		return;
 
-		SendUnified(&bsOut, HIGH_PRIORITY, RELIABLE_ORDERED, 0, room->usersInRoom[i].guid, false);
-	}
+	BitStream bsOut;
+	bsOut.WriteCasted<MessageID>(ID_RELAY_PLUGIN);
+	bsOut.WriteCasted<MessageID>(msg);
+	bsOut.WriteCompressed(message);
+
+	DataStructures::List<AddressOrGUID> targets;
+	targets.Preallocate(room->usersInRoom.Size(), _FILE_AND_LINE_);
+	for (unsigned int i=0; i < room->usersInRoom.Size(); i++)
+		targets.Push(room->usersInRoom[i].guid, _FILE_AND_LINE_);
+	SendToListUnified(&bsOut, HIGH_PRIORITY, RELIABLE_ORDERED, 0, &targets[0], targets.Size());
 }
 void RelayPlugin::SendMessageToRoom(StrAndGuidAndRoom **strAndGuidSender, BitStream* message)
 {
@@ -354,11 +364,15 @@ void RelayPlugin::SendMessageToRoom(StrAndGuidAndRoom **strAndGuidSender, BitStr
 			bsOut.Write(message);
 
 			RP_Group *room = chatRooms[i];
+			DataStructures::List<AddressOrGUID> targets;
+			targets.Preallocate(room->usersInRoom.Size(), _FILE_AND_LINE_);
 			for (unsigned int j=0; j < room->usersInRoom.Size(); j++)
 			{
 				if (room->usersInRoom[j].guid!=(*strAndGuidSender)->guid)
-					SendUnified(&bsOut, HIGH_PRIORITY, RELIABLE_ORDERED, 0, room->usersInRoom[j].guid, false);
+					targets.Push(room->usersInRoom[j].guid, _FILE_AND_LINE_);
 			}
+			if (targets.Size()>0)
+				SendToListUnified(&bsOut, HIGH_PRIORITY, RELIABLE_ORDERED, 0, &targets[0], targets.Size());
 
 			break;
 		}
@@ -25,6 +25,10 @@
 #include "slikenet/assert.h"
 #include "slikenet/Rand.h"
 #include "slikenet/MessageIdentifiers.h"
+#include "slikenet/SharedSendBuffer.h"
+#include "slikenet/CCRakNetSlidingWindow.h"
+#include "slikenet/CCRakNetUDT.h"
+#include "slikenet/CCRakNetBBR.h"
 #ifdef USE_THREADED_SEND
 #include "slikenet/SendToThread.h"
 #endif
@@ -54,6 +58,14 @@ static const CCTimeType MAX_TIME_BETWEEN_PACKETS= 350000; // 350 milliseconds
 //static const CCTimeType HISTOGRAM_RESTART_CYCLE=10000000; // Every 10 seconds reset the histogram
 #endif
 static const int DEFAULT_HAS_RECEIVED_PACKET_QUEUE_SIZE=512;
+// RakPeer updates at most once per millisecond, so pacing lets this much of the pacing rate go out at once, even if that is more than the burst size
+#if CC_TIME_TYPE_BYTES==4
+static const CCTimeType PACING_UPDATE_INTERVAL=1;
+static const double PACING_TIME_UNITS_PER_SECOND=1000.0;
+#else
+static const CCTimeType PACING_UPDATE_INTERVAL=1000;
+static const double PACING_TIME_UNITS_PER_SECOND=1000000.0;
+#endif
 static const CCTimeType STARTING_TIME_BETWEEN_PACKETS=MAX_TIME_BETWEEN_PACKETS;
 //static const long double TIME_BETWEEN_PACKETS_INCREASE_MULTIPLIER_DEFAULT=.02;
 //static const long double TIME_BETWEEN_PACKETS_DECREASE_MULTIPLIER_DEFAULT=1.0 / 9.0;
@@ -368,6 +380,9 @@ return 1;
 // Add 21 to the default MTU so if we encrypt it can hold potentially 21 more bytes of extra data + padding.
 ReliabilityLayer::ReliabilityLayer()
 {
+#if RAKNET_SOCKET_BATCH_SIZE>1
+	sendBatch=0;
+#endif
 
 #ifdef _DEBUG
 	// Wait longer to disconnect in debug so I don't get disconnected while tracing
@@ -389,11 +404,14 @@ ReliabilityLayer::ReliabilityLayer()
 	}
 #endif
 
+	congestionControlType=DEFAULT_CONGESTION_CONTROL;
+	congestionManager=AllocateCongestionControl(congestionControlType);
+
 	InitializeVariables();
 //int i = sizeof(InternalPacket);
-	datagramHistoryMessagePool.SetPageSize(sizeof(MessageNumberNode)*128);
-	internalPacketPool.SetPageSize(sizeof(InternalPacket)*INTERNAL_PACKET_PAGE_SIZE);
-	refCountedDataPool.SetPageSize(sizeof(InternalPacketRefCountedData)*32);
+	datagramHistoryMessagePool.SetArena(&arena);
+	internalPacketPool.SetArena(&arena);
+	refCountedDataPool.SetArena(&arena);
 }
 
 //-------------------------------------------------------------------------------------------------------
@@ -402,6 +420,7 @@ ReliabilityLayer::ReliabilityLayer()
 ReliabilityLayer::~ReliabilityLayer()
 {
 	FreeMemory( true ); // Free all memory immediately
+	SLNet::OP_DELETE(congestionManager, _FILE_AND_LINE_);
 }
 //-------------------------------------------------------------------------------------------------------
 // Resets the layer for reuse
@@ -421,7 +440,7 @@ void ReliabilityLayer::Reset(bool resetVariables, int mtuSize, bool _useSecurity
 #else
 		(void) _useSecurity;
 #endif // LIBCAT_SECURITY
-		congestionManager.Init(SLNet::GetTimeUS(), mtuSize - UDP_HEADER_SIZE);
+		congestionManager->Init(SLNet::GetTimeUS(), mtuSize - UDP_HEADER_SIZE);
 	}
 }
 
@@ -451,6 +470,7 @@ void ReliabilityLayer::InitializeVariables()
 	memset( orderedReadIndex, 0, NUMBER_OF_ORDERED_STREAMS * sizeof(OrderingIndexType) );
 	memset( highestSequencedReadIndex, 0, NUMBER_OF_ORDERED_STREAMS * sizeof(OrderingIndexType) );
 	memset( &statistics, 0, sizeof( statistics ) );
+	messagesRefusedByMemoryBudget.Store(0);
 	memset( &heapIndexOffsets, 0, sizeof( heapIndexOffsets ) );
 	
 	statistics.connectionStartTime = SLNet::GetTimeUS();
@@ -501,9 +521,19 @@ void ReliabilityLayer::InitializeVariables()
 	//	histogramStart=(CCTimeType)0;
 	//	histogramBitsSent=0;
 	unacknowledgedBytes=0;
+	resendBuffer=0;
+	resendBufferMask=0;
+	resendBufferLastUseTime=0;
 	resendLinkedListHead=0;
 	totalUserDataBytesAcked=0;
 
+	pacingBurstDatagrams=0;
+	pacingTokens=0.0;
+	pacingRate=0.0;
+	lastPacingTime=lastUpdateTime;
+	lastBurstDatagrams=0;
+	largestBurstDatagrams=0;
+
 	datagramHistoryPopCount=0;
 
 	InitHeapWeights();
@@ -601,7 +631,7 @@ void ReliabilityLayer::FreeThreadSafeMemory( void )
 
 	//resendList.ForEachData(DeleteInternalPacket);
 	//	resendTree.Clear(_FILE_AND_LINE_);
-	memset(resendBuffer, 0, sizeof(resendBuffer));
+	ReleaseResendBuffer();
 	statistics.messagesInResendBuffer=0;
 	statistics.bytesInResendBuffer=0;
 
@@ -655,10 +685,6 @@ void ReliabilityLayer::FreeThreadSafeMemory( void )
 	datagramSizesInBytes.Clear(false, _FILE_AND_LINE_);
 	datagramSizesInBytes.Preallocate(128, _FILE_AND_LINE_);
 
-	internalPacketPool.Clear(_FILE_AND_LINE_);
-
-	refCountedDataPool.Clear(_FILE_AND_LINE_);
-
 	/*
 	DataStructures::Page<DatagramSequenceNumberType, DatagramMessageIDList*, RESEND_TREE_ORDER> *cur = datagramMessageIDTree.GetListHead();
 	while (cur)
@@ -678,13 +704,15 @@ void ReliabilityLayer::FreeThreadSafeMemory( void )
 		datagramHistory.Pop();
 		datagramHistoryPopCount++;
 	}
-	datagramHistoryMessagePool.Clear(_FILE_AND_LINE_);
 	datagramHistoryPopCount=0;
 
 	acknowlegements.Clear();
 	NAKs.Clear();
 
 	unreliableLinkedListHead=0;
+
+	// Everything allocated from internalPacketPool, datagramHistoryMessagePool and refCountedDataPool goes back to the page pool
+	arena.Clear(_FILE_AND_LINE_);
 }
 
 //-------------------------------------------------------------------------------------------------------
@@ -697,10 +725,11 @@ void ReliabilityLayer::FreeThreadSafeMemory( void )
 //-------------------------------------------------------------------------------------------------------
 bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 	const char *buffer, unsigned int length, SystemAddress &systemAddress, DataStructures::List<PluginInterface2*> &messageHandlerList, int mtuSize,
-	RakNetSocket2 *s, RakNetRandom *rnr, CCTimeType timeRead, BitStream &updateBitStream)
+	RakNetSocket2 *s, RakNetRandom *rnr, CCTimeType timeRead, BitStream &updateBitStream, int decryptedLength)
 {
 	// unreferenced parameters
 	(void)mtuSize;
+	(void)decryptedLength;
 
 	RakAssert(buffer != nullptr);
 
@@ -726,13 +755,21 @@ bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 
 #if LIBCAT_SECURITY == 1
 	if (useSecurity) {
-		unsigned int received = length;
+		if (decryptedLength == DATAGRAM_NOT_DECRYPTED) {
+			unsigned int received = length;
+
+			if (!auth_enc.Decrypt((cat::u8*)buffer, received)) {
+				return false;
+			}
 
-		if (!auth_enc.Decrypt((cat::u8*)buffer, received)) {
+			length = received;
+		}
+		else if (decryptedLength == DATAGRAM_NOT_AUTHENTIC) {
 			return false;
 		}
-
-		length = received;
+		else {
+			length = (unsigned int) decryptedLength;
+		}
 	}
 #endif
 
@@ -766,7 +803,7 @@ bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 #endif
 		{
 			// Sanity check. This could happen due to type overflow, especially since I only send the low 4 bytes to reduce bandwidth
-			rtt=(CCTimeType) congestionManager.GetRTT();
+			rtt=(CCTimeType) congestionManager->GetRTT();
 		}
 		//	RakAssert(rtt < 500000);
 		//	printf("%i ", (SLNet::TimeMS)(rtt/1000));
@@ -779,7 +816,7 @@ bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 			dhf.AS = 0;
 		}
 #endif
-		//		congestionManager.OnAck(timeRead, rtt, dhf.hasBAndAS, dhf.B, dhf.AS, totalUserDataBytesAcked );
+		//		congestionManager->OnAck(timeRead, rtt, dhf.hasBAndAS, dhf.B, dhf.AS, totalUserDataBytesAcked );
 
 		incomingAcks.Clear();
 		if (!incomingAcks.Deserialize(&socketData)) {
@@ -834,12 +871,14 @@ bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 					return true;
 				}
 
+				congestionManager->OnAckDatagram(timeRead, datagramNumber);
+
 				CCTimeType whenSent;
 				MessageNumberNode *messageNumberNode = GetMessageNumberNodeByDatagramIndex(datagramNumber, &whenSent);
 				if (messageNumberNode) {
 				//	printf("%p Got ack for %i\n", this, datagramNumber.val);
 #if INCLUDE_TIMESTAMP_WITH_DATAGRAMS==1
-					congestionManager.OnAck(timeRead, rtt, dhf.hasBAndAS, 0, dhf.AS, totalUserDataBytesAcked, bandwidthExceededStatistic, datagramNumber);
+					congestionManager->OnAck(timeRead, rtt, dhf.hasBAndAS, 0, dhf.AS, totalUserDataBytesAcked, bandwidthExceededStatistic, datagramNumber);
 #else
 					CCTimeType ping;
 					if (timeRead > whenSent) {
@@ -847,7 +886,7 @@ bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 					} else {
 						ping = 0;
 					}
-					congestionManager.OnAck(timeRead, ping, dhf.hasBAndAS, 0, dhf.AS, totalUserDataBytesAcked, bandwidthExceededStatistic, datagramNumber);
+					congestionManager->OnAck(timeRead, ping, dhf.hasBAndAS, 0, dhf.AS, totalUserDataBytesAcked, bandwidthExceededStatistic, datagramNumber);
 #endif
 					while (messageNumberNode) {
 						// TESTING1
@@ -863,7 +902,7 @@ bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 // 					// Previously used slot, rather than empty unreliable slot
 // 					printf("%p Ack %i is duplicate\n", this, datagramNumber.val);
 // 
-//  				congestionManager.OnDuplicateAck(timeRead, datagramNumber);
+//  				congestionManager->OnDuplicateAck(timeRead, datagramNumber);
 // 				}
 			}
 		}
@@ -898,7 +937,7 @@ bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 			// Sanity check
 			//RakAssert(incomingNAKs.ranges[i].maxIndex.val-incomingNAKs.ranges[i].minIndex.val<1000);
 			for (messageNumber = incomingNAKs.ranges[i].minIndex; messageNumber <= incomingNAKs.ranges[i].maxIndex; messageNumber++) {
-				congestionManager.OnNAK(timeRead, messageNumber);
+				congestionManager->OnNAK(timeRead, messageNumber);
 
 				// REMOVEME
 				//				printf("%p NAK %i\n", this, dhf.datagramNumber.val);
@@ -914,7 +953,7 @@ bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 				MessageNumberNode *messageNumberNode = GetMessageNumberNodeByDatagramIndex(messageNumber, &timeSent);
 				while (messageNumberNode) {
 					// Update timers so resends occur immediately
-					InternalPacket *internalPacket = resendBuffer[messageNumberNode->messageNumber & (uint32_t) RESEND_BUFFER_ARRAY_MASK];
+					InternalPacket *internalPacket = resendBuffer ? resendBuffer[messageNumberNode->messageNumber & resendBufferMask] : 0;
 					if (internalPacket) {
 						if (internalPacket->nextActionTime != 0) {
 							internalPacket->nextActionTime = timeRead;
@@ -927,7 +966,7 @@ bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 		}
 	} else {
 		uint32_t skippedMessageCount;
-		if (!congestionManager.OnGotPacket(dhf.datagramNumber, dhf.isContinuousSend, timeRead, length, &skippedMessageCount)) {
+		if (!congestionManager->OnGotPacket(dhf.datagramNumber, dhf.isContinuousSend, timeRead, length, &skippedMessageCount)) {
 			for (unsigned int messageHandlerIndex = 0; messageHandlerIndex < messageHandlerList.Size(); messageHandlerIndex++) {
 				messageHandlerList[messageHandlerIndex]->OnReliabilityLayerNotification("congestionManager.OnGotPacket failed", BYTES_TO_BITS(length), systemAddress, true);
 			}
@@ -935,7 +974,7 @@ bool ReliabilityLayer::HandleSocketReceiveFromConnectedPlayer(
 			return true;
 		}
 		if (dhf.isPacketPair) {
-			congestionManager.OnGotPacketPair(dhf.datagramNumber, length, timeRead);
+			congestionManager->OnGotPacketPair(dhf.datagramNumber, length, timeRead);
 		}
 
 		DatagramHeaderFormat dhfNAK;
@@ -1552,6 +1591,53 @@ CONTINUE_SOCKET_DATA_PARSE_LOOP:
 	return true;
 }
 
+#if LIBCAT_SECURITY==1
+//-------------------------------------------------------------------------------------------------------
+void ReliabilityLayer::DecryptDatagrams(char **buffers, const unsigned int *lengths, int *decryptedLengths, unsigned int count)
+{
+	unsigned int i;
+	if (!useSecurity)
+	{
+		for (i=0; i < count; i++)
+			decryptedLengths[i]=(int) lengths[i];
+		return;
+	}
+
+	// HandleSocketReceiveFromConnectedPlayer() ignores datagrams this short before decrypting
+	cat::u8 *encrypted[RAKNET_SOCKET_BATCH_SIZE];
+	cat::u32 encryptedLengths[RAKNET_SOCKET_BATCH_SIZE];
+	bool decrypted[RAKNET_SOCKET_BATCH_SIZE];
+	unsigned int start, end, encryptedCount;
+	for (start=0; start < count; start=end)
+	{
+		end=start+RAKNET_SOCKET_BATCH_SIZE < count ? start+RAKNET_SOCKET_BATCH_SIZE : count;
+		encryptedCount=0;
+		for (i=start; i < end; i++)
+		{
+			if (lengths[i]>2)
+			{
+				encrypted[encryptedCount]=(cat::u8*) buffers[i];
+				encryptedLengths[encryptedCount++]=lengths[i];
+			}
+		}
+
+		auth_enc.DecryptMany(encrypted, encryptedLengths, decrypted, (int) encryptedCount);
+
+		encryptedCount=0;
+		for (i=start; i < end; i++)
+		{
+			if (lengths[i]>2)
+			{
+				decryptedLengths[i]=decrypted[encryptedCount] ? (int) encryptedLengths[encryptedCount] : DATAGRAM_NOT_AUTHENTIC;
+				encryptedCount++;
+			}
+			else
+				decryptedLengths[i]=(int) lengths[i];
+		}
+	}
+}
+#endif
+
 //-------------------------------------------------------------------------------------------------------
 // This gets an end-user packet already parsed out. Returns number of BITS put into the buffer
 //-------------------------------------------------------------------------------------------------------
@@ -1587,7 +1673,7 @@ BitSize_t ReliabilityLayer::Receive( unsigned char **data )
 // reliability is what reliability to use
 // ordering channel is from 0 to 255 and specifies what stream to use
 //-------------------------------------------------------------------------------------------------------
-bool ReliabilityLayer::Send( char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, unsigned char orderingChannel, bool makeDataCopy, int MTUSize, CCTimeType currentTime, uint32_t receipt )
+bool ReliabilityLayer::Send( char *data, BitSize_t numberOfBitsToSend, PacketPriority priority, PacketReliability reliability, unsigned char orderingChannel, bool makeDataCopy, int MTUSize, CCTimeType currentTime, uint32_t receipt, SharedSendBuffer *sharedSendBuffer )
 {
 #ifdef _DEBUG
 	RakAssert( !( reliability >= NUMBER_OF_RELIABILITIES || reliability < 0 ) );
@@ -1630,7 +1716,13 @@ bool ReliabilityLayer::Send( char *data, BitSize_t numberOfBitsToSend, PacketPri
 
 	internalPacket->creationTime = currentTime;
 
-	if ( makeDataCopy )
+	if ( sharedSendBuffer )
+	{
+		// Referenced by this packet, or by its parts if it is split
+		RakAssert((unsigned char*) data==sharedSendBuffer->GetData());
+		AllocInternalPacketData(internalPacket, sharedSendBuffer);
+	}
+	else if ( makeDataCopy )
 	{
 		AllocInternalPacketData(internalPacket, numberOfBytesToSend, true, _FILE_AND_LINE_ );
 		//internalPacket->data = (unsigned char*) rakMalloc_Ex( numberOfBytesToSend, _FILE_AND_LINE_ );
@@ -1741,7 +1833,15 @@ void ReliabilityLayer::Update( RakNetSocket2 *s, SystemAddress &systemAddress, i
 							  RakNetRandom *rnr,
 							  BitStream &updateBitStream)
 {
+#if RAKNET_SOCKET_BATCH_SIZE>1
+	RNS2_SendBatch batch;
+	sendBatch=&batch;
+	UpdateInternal(s, systemAddress, MTUSize, time, bitsPerSecondLimit, messageHandlerList, rnr, updateBitStream, false);
+	FlushSendBatch(s);
+	sendBatch=0;
+#else
 	UpdateInternal(s, systemAddress, MTUSize, time, bitsPerSecondLimit, messageHandlerList, rnr, updateBitStream, false);
+#endif
 }
 
 void ReliabilityLayer::UpdateAndForceACKs( RakNetSocket2 *s, SystemAddress &systemAddress, int MTUSize, CCTimeType time,
@@ -1750,7 +1850,15 @@ void ReliabilityLayer::UpdateAndForceACKs( RakNetSocket2 *s, SystemAddress &syst
 							  RakNetRandom *rnr,
 							  BitStream &updateBitStream)
 {
+#if RAKNET_SOCKET_BATCH_SIZE>1
+	RNS2_SendBatch batch;
+	sendBatch=&batch;
+	UpdateInternal(s, systemAddress, MTUSize, time, bitsPerSecondLimit, messageHandlerList, rnr, updateBitStream, true);
+	FlushSendBatch(s);
+	sendBatch=0;
+#else
 	UpdateInternal(s, systemAddress, MTUSize, time, bitsPerSecondLimit, messageHandlerList, rnr, updateBitStream, true);
+#endif
 }
 
 void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAddress, int MTUSize, CCTimeType time,
@@ -1810,6 +1918,14 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 		timeSinceLastTick=100000;
 #endif
 
+	// Idle connections do not hold on to a resend buffer
+#if CC_TIME_TYPE_BYTES==4
+	if (resendBuffer && statistics.messagesInResendBuffer==0 && time-resendBufferLastUseTime > (CCTimeType) RESEND_BUFFER_IDLE_TIME_MS)
+#else
+	if (resendBuffer && statistics.messagesInResendBuffer==0 && time-resendBufferLastUseTime > (CCTimeType) RESEND_BUFFER_IDLE_TIME_MS*(CCTimeType)1000)
+#endif
+		ReleaseResendBuffer();
+
 	if (unreliableTimeout>0)
 	{
 		if (timeSinceLastTick>=timeToNextUnreliableCull)
@@ -1872,7 +1988,7 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 		return;
 	}
 
-	if (forceSendACKs || congestionManager.ShouldSendACKs(time,timeSinceLastTick))
+	if (forceSendACKs || congestionManager->ShouldSendACKs(time,timeSinceLastTick))
 	{
 		SendACKs(s, systemAddress, time, rnr, updateBitStream);
 	}
@@ -1890,7 +2006,7 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 	}
 
 	DatagramHeaderFormat dhf;
-	dhf.needsBAndAs=congestionManager.GetIsInSlowStart();
+	dhf.needsBAndAs=congestionManager->GetIsInSlowStart();
 	dhf.isContinuousSend=bandwidthExceededStatistic;
 	// 	bandwidthExceededStatistic=sendPacketSet[0].IsEmpty()==false ||
 	// 		sendPacketSet[1].IsEmpty()==false ||
@@ -1900,10 +2016,10 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 
 	const bool hasDataToSendOrResend = IsResendQueueEmpty()==false || bandwidthExceededStatistic;
 	RakAssert(NUMBER_OF_PRIORITIES==4);
-	congestionManager.Update(time, hasDataToSendOrResend);
+	congestionManager->Update(time, hasDataToSendOrResend);
 
 	statistics.BPSLimitByOutgoingBandwidthLimit = BITS_TO_BYTES(bitsPerSecondLimit);
-	statistics.BPSLimitByCongestionControl = congestionManager.GetBytesPerSecondLimitByCongestionControl();
+	statistics.BPSLimitByCongestionControl = congestionManager->GetBytesPerSecondLimitByCongestionControl();
 
 	unsigned int i;
 	if (time > lastBpsClear+
@@ -1956,8 +2072,21 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 		dhf.hasBAndAS=false;
 		ResetPacketsAndDatagrams();
 
-		int transmissionBandwidth = congestionManager.GetTransmissionBandwidth(time, timeSinceLastTick, unacknowledgedBytes,dhf.isContinuousSend);
-		int retransmissionBandwidth = congestionManager.GetRetransmissionBandwidth(time, timeSinceLastTick, unacknowledgedBytes,dhf.isContinuousSend);
+		int transmissionBandwidth = congestionManager->GetTransmissionBandwidth(time, timeSinceLastTick, unacknowledgedBytes,dhf.isContinuousSend);
+		int retransmissionBandwidth = congestionManager->GetRetransmissionBandwidth(time, timeSinceLastTick, unacknowledgedBytes,dhf.isContinuousSend);
+		if (pacingBurstDatagrams>0)
+		{
+			// Send no more than the pacing tokens allow. GetTimeUntilNextUpdate() wakes us up when there are tokens again
+			RefillPacingTokens(time);
+			if (pacingRate>0.0)
+			{
+				const int pacingBandwidth = pacingTokens>0.0 ? (int) pacingTokens : 0;
+				if (transmissionBandwidth>pacingBandwidth)
+					transmissionBandwidth=pacingBandwidth;
+				if (retransmissionBandwidth>pacingBandwidth)
+					retransmissionBandwidth=pacingBandwidth;
+			}
+		}
 		if (retransmissionBandwidth>0 || transmissionBandwidth>0)
 		{
 			statistics.isLimitedByCongestionControl=false;
@@ -1994,12 +2123,12 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 
 						// Testing1
 // 						if (internalPacket->reliability==RELIABLE_ORDERED || internalPacket->reliability==RELIABLE_ORDERED_WITH_ACK_RECEIPT)
-// 							printf("RESEND reliableMessageNumber %i with datagram %i\n", internalPacket->reliableMessageNumber.val, congestionManager.GetNextDatagramSequenceNumber().val);
+// 							printf("RESEND reliableMessageNumber %i with datagram %i\n", internalPacket->reliableMessageNumber.val, congestionManager->GetNextDatagramSequenceNumber().val);
 
 						PushPacket(time,internalPacket,true); // Affects GetNewTransmissionBandwidth()
 						internalPacket->timesSent++;
-						congestionManager.OnResend(time, internalPacket->nextActionTime);
-						internalPacket->retransmissionTime = congestionManager.GetRTOForRetransmission(internalPacket->timesSent);
+						congestionManager->OnResend(time, internalPacket->nextActionTime);
+						internalPacket->retransmissionTime = congestionManager->GetRTOForRetransmission(internalPacket->timesSent);
 						internalPacket->nextActionTime = internalPacket->retransmissionTime+time;
 
 						pushedAnything=true;
@@ -2007,9 +2136,9 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 						for (unsigned int messageHandlerIndex=0; messageHandlerIndex < messageHandlerList.Size(); messageHandlerIndex++)
 						{
 #if CC_TIME_TYPE_BYTES==4
-							messageHandlerList[messageHandlerIndex]->OnInternalPacket(internalPacket, packetsToSendThisUpdateDatagramBoundaries.Size()+congestionManager.GetNextDatagramSequenceNumber(), systemAddress, (SLNet::TimeMS) time, true);
+							messageHandlerList[messageHandlerIndex]->OnInternalPacket(internalPacket, packetsToSendThisUpdateDatagramBoundaries.Size()+congestionManager->GetNextDatagramSequenceNumber(), systemAddress, (SLNet::TimeMS) time, true);
 #else
-							messageHandlerList[messageHandlerIndex]->OnInternalPacket(internalPacket, packetsToSendThisUpdateDatagramBoundaries.Size()+congestionManager.GetNextDatagramSequenceNumber(), systemAddress, (SLNet::TimeMS)(time/(CCTimeType)1000), true);
+							messageHandlerList[messageHandlerIndex]->OnInternalPacket(internalPacket, packetsToSendThisUpdateDatagramBoundaries.Size()+congestionManager->GetNextDatagramSequenceNumber(), systemAddress, (SLNet::TimeMS)(time/(CCTimeType)1000), true);
 #endif
 						}
 
@@ -2038,6 +2167,10 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 			statistics.isLimitedByCongestionControl=true;
 		}
 
+		// Resends took their share of the pacing tokens
+		if (pacingBurstDatagrams>0 && pacingRate>0.0 && transmissionBandwidth>(int) pacingTokens-(int)BITS_TO_BYTES(allDatagramSizesSoFar))
+			transmissionBandwidth=(int) pacingTokens-(int)BITS_TO_BYTES(allDatagramSizesSoFar);
+
 		if ((int)BITS_TO_BYTES(allDatagramSizesSoFar)<transmissionBandwidth)
 		{
 			//	printf("S+ ");
@@ -2124,7 +2257,7 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 					{
 						internalPacket->messageNumberAssigned=true;
 						internalPacket->reliableMessageNumber=sendReliableMessageNumberIndex;
-						internalPacket->retransmissionTime = congestionManager.GetRTOForRetransmission(internalPacket->timesSent+1);
+						internalPacket->retransmissionTime = congestionManager->GetRTOForRetransmission(internalPacket->timesSent+1);
 						internalPacket->nextActionTime = internalPacket->retransmissionTime+time;
 #if CC_TIME_TYPE_BYTES==4
 						const CCTimeType threshhold = 10000;
@@ -2137,12 +2270,15 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 							RakAssert(time-internalPacket->nextActionTime < threshhold);
 						}
 						//resendTree.Insert( internalPacket->reliableMessageNumber, internalPacket);
-						if (resendBuffer[internalPacket->reliableMessageNumber & (uint32_t) RESEND_BUFFER_ARRAY_MASK]!=0)
+						// ResendBufferOverflow() made room
+						RakAssert(resendBuffer!=0);
+						if (resendBuffer[internalPacket->reliableMessageNumber & resendBufferMask]!=0)
 						{
 							//								bool overflow = ResendBufferOverflow();
 							RakAssert(0);
 						}
-						resendBuffer[internalPacket->reliableMessageNumber & (uint32_t) RESEND_BUFFER_ARRAY_MASK] = internalPacket;
+						resendBuffer[internalPacket->reliableMessageNumber & resendBufferMask] = internalPacket;
+						resendBufferLastUseTime=time;
 						statistics.messagesInResendBuffer++;
 						statistics.bytesInResendBuffer+=BITS_TO_BYTES(internalPacket->dataBitLength);
 
@@ -2157,9 +2293,9 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 					else if (internalPacket->reliability == UNRELIABLE_WITH_ACK_RECEIPT)
 					{
 						unreliableWithAckReceiptHistory.Push(UnreliableWithAckReceiptNode(
-							congestionManager.GetNextDatagramSequenceNumber() + packetsToSendThisUpdateDatagramBoundaries.Size(),
+							congestionManager->GetNextDatagramSequenceNumber() + packetsToSendThisUpdateDatagramBoundaries.Size(),
 							internalPacket->sendReceiptSerial,
-							congestionManager.GetRTOForRetransmission(internalPacket->timesSent+1)+time
+							congestionManager->GetRTOForRetransmission(internalPacket->timesSent+1)+time
 							), _FILE_AND_LINE_);
 					}
 
@@ -2169,7 +2305,7 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 
 					// Testing1
 // 					if (internalPacket->reliability==RELIABLE_ORDERED || internalPacket->reliability==RELIABLE_ORDERED_WITH_ACK_RECEIPT)
-// 						printf("SEND reliableMessageNumber %i in datagram %i\n", internalPacket->reliableMessageNumber.val, congestionManager.GetNextDatagramSequenceNumber().val);
+// 						printf("SEND reliableMessageNumber %i in datagram %i\n", internalPacket->reliableMessageNumber.val, congestionManager->GetNextDatagramSequenceNumber().val);
 
 					PushPacket(time,internalPacket, isReliable);
 					internalPacket->timesSent++;
@@ -2177,9 +2313,9 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 					for (unsigned int messageHandlerIndex=0; messageHandlerIndex < messageHandlerList.Size(); messageHandlerIndex++)
 					{
 #if CC_TIME_TYPE_BYTES==4
-						messageHandlerList[messageHandlerIndex]->OnInternalPacket(internalPacket, packetsToSendThisUpdateDatagramBoundaries.Size()+congestionManager.GetNextDatagramSequenceNumber(), systemAddress, (SLNet::TimeMS)time, true);
+						messageHandlerList[messageHandlerIndex]->OnInternalPacket(internalPacket, packetsToSendThisUpdateDatagramBoundaries.Size()+congestionManager->GetNextDatagramSequenceNumber(), systemAddress, (SLNet::TimeMS)time, true);
 #else
-						messageHandlerList[messageHandlerIndex]->OnInternalPacket(internalPacket, packetsToSendThisUpdateDatagramBoundaries.Size()+congestionManager.GetNextDatagramSequenceNumber(), systemAddress, (SLNet::TimeMS)(time/(CCTimeType)1000), true);
+						messageHandlerList[messageHandlerIndex]->OnInternalPacket(internalPacket, packetsToSendThisUpdateDatagramBoundaries.Size()+congestionManager->GetNextDatagramSequenceNumber(), systemAddress, (SLNet::TimeMS)(time/(CCTimeType)1000), true);
 #endif
 					}
 					pushedAnything=true;
@@ -2202,12 +2338,19 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 		}
 
 
+		if (packetsToSendThisUpdateDatagramBoundaries.Size()>0)
+		{
+			lastBurstDatagrams=packetsToSendThisUpdateDatagramBoundaries.Size();
+			if (lastBurstDatagrams>largestBurstDatagrams)
+				largestBurstDatagrams=lastBurstDatagrams;
+		}
+
 		for (unsigned int datagramIndex=0; datagramIndex < packetsToSendThisUpdateDatagramBoundaries.Size(); datagramIndex++)
 		{
 			if (datagramIndex>0)
 				dhf.isContinuousSend=true;
 			MessageNumberNode* messageNumberNode = 0;
-			dhf.datagramNumber=congestionManager.GetAndIncrementNextDatagramSequenceNumber();
+			dhf.datagramNumber=congestionManager->GetAndIncrementNextDatagramSequenceNumber();
 			dhf.isPacketPair=datagramsToSendThisUpdateIsPair[datagramIndex];
 
 			//printf("%p pushing datagram %i\n", this, dhf.datagramNumber.val);
@@ -2273,11 +2416,16 @@ void ReliabilityLayer::UpdateInternal( RakNetSocket2 *s, SystemAddress &systemAd
 			// Store what message ids were sent with this datagram
 			//	datagramMessageIDTree.Insert(dhf.datagramNumber,idList);
 
-			congestionManager.OnSendBytes(time,UDP_HEADER_SIZE+DatagramHeaderFormat::GetDataHeaderByteLength());
+			congestionManager->OnSendBytes(time,UDP_HEADER_SIZE+DatagramHeaderFormat::GetDataHeaderByteLength());
 
+			const uint32_t datagramBytes=UDP_HEADER_SIZE+updateBitStream.GetNumberOfBytesUsed();
 			SendBitStream( s, systemAddress, &updateBitStream, rnr, time );
+			if (pacingBurstDatagrams>0 && pacingRate>0.0)
+				pacingTokens-=datagramBytes;
 
 			bandwidthExceededStatistic=outgoingPacketBuffer.Size()>0;
+			// Datagrams sent while nothing else waits are application limited
+			congestionManager->OnSendDatagram(time, dhf.datagramNumber, datagramBytes, bandwidthExceededStatistic);
 			// 			bandwidthExceededStatistic=sendPacketSet[0].IsEmpty()==false ||
 			// 				sendPacketSet[1].IsEmpty()==false ||
 			// 				sendPacketSet[2].IsEmpty()==false ||
@@ -2366,22 +2514,31 @@ void ReliabilityLayer::SendBitStream( RakNetSocket2 *s, SystemAddress &systemAdd
 	}
 #endif
 
+	// Bytes that FlushSendBatch() adds when it encrypts the batched datagrams
+	unsigned int batchEncryptionOverhead=0;
 #if LIBCAT_SECURITY==1
 	if (useSecurity)
 	{
-		unsigned char *buffer = reinterpret_cast<unsigned char*>( bitStream->GetData() );
+#if RAKNET_SOCKET_BATCH_SIZE>1 && !defined(USE_THREADED_SEND)
+		if (sendBatch)
+			batchEncryptionOverhead=cat::AuthenticatedEncryption::OVERHEAD_BYTES;
+		else
+#endif
+		{
+			unsigned char *buffer = reinterpret_cast<unsigned char*>( bitStream->GetData() );
 
-		int buffer_size = bitStream->GetNumberOfBitsAllocated() / 8;
+			int buffer_size = bitStream->GetNumberOfBitsAllocated() / 8;
 
-		// Verify there is enough room for encrypted output and encrypt
-		// Encrypt() will increase length
-		SLNET_VERIFY(auth_enc.Encrypt(buffer, buffer_size, length));
+			// Verify there is enough room for encrypted output and encrypt
+			// Encrypt() will increase length
+			SLNET_VERIFY(auth_enc.Encrypt(buffer, buffer_size, length));
+		}
 	}
 #endif
 
-	bpsMetrics[(int) ACTUAL_BYTES_SENT].Push1(currentTime,length);
+	bpsMetrics[(int) ACTUAL_BYTES_SENT].Push1(currentTime,length+batchEncryptionOverhead);
 
-	RakAssert(length <= congestionManager.GetMTU());
+	RakAssert(length+batchEncryptionOverhead <= congestionManager->GetMTU());
 
 #ifdef USE_THREADED_SEND
 	SendToThread::SendToThreadBlock *block =  SendToThread::AllocateBlock();
@@ -2395,6 +2552,22 @@ void ReliabilityLayer::SendBitStream( RakNetSocket2 *s, SystemAddress &systemAdd
 #else
 	// SocketLayer::SendTo( s, ( char* ) bitStream->GetData(), length, systemAddress, __FILE__, __LINE__  );
 
+#if RAKNET_SOCKET_BATCH_SIZE>1
+	if (sendBatch)
+	{
+		if (sendBatch->count==RAKNET_SOCKET_BATCH_SIZE)
+			FlushSendBatch(s);
+
+		// updateBitStream is reused for the next datagram, so copy the data
+		memcpy(sendBatch->data[sendBatch->count], bitStream->GetData(), length);
+		RNS2_SendParameters &bsp = sendBatch->sendParameters[sendBatch->count++];
+		bsp.data = sendBatch->data[sendBatch->count-1];
+		bsp.length = length;
+		bsp.systemAddress = systemAddress;
+		return;
+	}
+#endif
+
 	RNS2_SendParameters bsp;
 	bsp.data = (char*) bitStream->GetData();
 	bsp.length = length;
@@ -2403,6 +2576,36 @@ void ReliabilityLayer::SendBitStream( RakNetSocket2 *s, SystemAddress &systemAdd
 #endif
 }
 
+#if RAKNET_SOCKET_BATCH_SIZE>1
+//-------------------------------------------------------------------------------------------------------
+void ReliabilityLayer::FlushSendBatch( RakNetSocket2 *s )
+{
+	if (sendBatch->count>0)
+	{
+#if LIBCAT_SECURITY==1
+		if (useSecurity)
+		{
+			// SendBitStream() left these for us to encrypt together
+			cat::u8 *buffers[RAKNET_SOCKET_BATCH_SIZE];
+			cat::u32 bufferSizes[RAKNET_SOCKET_BATCH_SIZE], lengths[RAKNET_SOCKET_BATCH_SIZE];
+			unsigned int i;
+			for (i=0; i < sendBatch->count; i++)
+			{
+				buffers[i]=(cat::u8*) sendBatch->data[i];
+				bufferSizes[i]=MAXIMUM_MTU_SIZE;
+				lengths[i]=(cat::u32) sendBatch->sendParameters[i].length;
+			}
+			SLNET_VERIFY(auth_enc.EncryptMany(buffers, bufferSizes, lengths, (int) sendBatch->count));
+			for (i=0; i < sendBatch->count; i++)
+				sendBatch->sendParameters[i].length=(int) lengths[i];
+		}
+#endif
+		s->SendBatch(sendBatch->sendParameters, sendBatch->count, _FILE_AND_LINE_);
+		sendBatch->count=0;
+	}
+}
+#endif
+
 //-------------------------------------------------------------------------------------------------------
 // Are we waiting for any data to be sent out or be processed by the player?
 //-------------------------------------------------------------------------------------------------------
@@ -2428,6 +2631,81 @@ bool ReliabilityLayer::AreAcksWaiting(void)
 	return acknowlegements.Size() > 0;
 }
 //-------------------------------------------------------------------------------------------------------
+// Shortens wait so that the caller wakes up at deadline. Deadlines in the past wake up right away
+//-------------------------------------------------------------------------------------------------------
+static void ShortenWaitToDeadline( CCTimeType &wait, CCTimeType deadline, CCTimeType time )
+{
+	// Same overflow safe test as in UpdateInternal()
+	if ( time - deadline < (((CCTimeType)-1)/2) )
+		wait=0;
+	else if ( deadline - time < wait )
+		wait=deadline - time;
+}
+//-------------------------------------------------------------------------------------------------------
+SLNet::TimeUS ReliabilityLayer::GetTimeUntilNextUpdate( CCTimeType time, SLNet::TimeUS maxWait )
+{
+#if CC_TIME_TYPE_BYTES==4
+	time/=1000;
+	CCTimeType wait=(CCTimeType) (maxWait/(SLNet::TimeUS)1000);
+	// While data is held back by congestion control or the bandwidth limit, retry this often
+	const CCTimeType sendRetryInterval = 10;
+#else
+	CCTimeType wait=maxWait;
+	const CCTimeType sendRetryInterval = 10000;
+#endif
+
+	if (deadConnection)
+		return 0;
+
+	if (outgoingPacketBuffer.Size()>0)
+	{
+		if (wait > sendRetryInterval)
+			wait=sendRetryInterval;
+		ShortenWaitToDeadline(wait, congestionManager->GetNextTransmissionTime(time), time);
+	}
+
+	// Wake up when pacing allows the next full datagram
+	if (pacingBurstDatagrams>0 && pacingRate>0.0 && (outgoingPacketBuffer.Size()>0 || resendLinkedListHead))
+	{
+		const double mtu=(double) congestionManager->GetMTU();
+		if (pacingTokens<mtu)
+			ShortenWaitToDeadline(wait, lastPacingTime+(CCTimeType) ((mtu-pacingTokens)*PACING_TIME_UNITS_PER_SECOND/pacingRate)+1, time);
+	}
+
+	if (acknowlegements.Size()>0)
+		ShortenWaitToDeadline(wait, congestionManager->GetNextACKTime(time), time);
+
+	if (resendLinkedListHead)
+		ShortenWaitToDeadline(wait, resendLinkedListHead->nextActionTime, time);
+
+	for (unsigned int i=0; i < unreliableWithAckReceiptHistory.Size(); i++)
+		ShortenWaitToDeadline(wait, unreliableWithAckReceiptHistory[i].nextActionTime, time);
+
+	if (unreliableTimeout>0 && unreliableLinkedListHead)
+		ShortenWaitToDeadline(wait, lastUpdateTime+timeToNextUnreliableCull, time);
+
+#ifdef _DEBUG
+	if (delayList.Size())
+	{
+#if CC_TIME_TYPE_BYTES==4
+		ShortenWaitToDeadline(wait, delayList.Peek()->sendTime, time);
+#else
+		SLNet::TimeMS timeMs=(SLNet::TimeMS) (time/(CCTimeType)1000);
+		if (delayList.Peek()->sendTime <= timeMs)
+			wait=0;
+		else if ((CCTimeType)(delayList.Peek()->sendTime-timeMs)*(CCTimeType)1000 < wait)
+			wait=(CCTimeType)(delayList.Peek()->sendTime-timeMs)*(CCTimeType)1000;
+#endif
+	}
+#endif
+
+#if CC_TIME_TYPE_BYTES==4
+	return (SLNet::TimeUS) wait*(SLNet::TimeUS)1000;
+#else
+	return wait;
+#endif
+}
+//-------------------------------------------------------------------------------------------------------
 void ReliabilityLayer::ApplyNetworkSimulator( double _packetloss, SLNet::TimeMS _minExtraPing, SLNet::TimeMS _extraPingVariance )
 {
 #ifndef _DEBUG
@@ -2460,6 +2738,89 @@ void ReliabilityLayer::SetUnreliableTimeout(SLNet::TimeMS timeoutMS)
 #endif
 }
 
+//-------------------------------------------------------------------------------------------------------
+void ReliabilityLayer::SetArenaPagePool(ArenaPagePool *pagePool)
+{
+	arena.SetPagePool(pagePool);
+}
+//-------------------------------------------------------------------------------------------------------
+void ReliabilityLayer::SetMemoryBudget(unsigned int bytes)
+{
+	arena.SetBudget(bytes);
+}
+//-------------------------------------------------------------------------------------------------------
+unsigned int ReliabilityLayer::GetMemoryBudget(void) const
+{
+	return arena.GetBudget();
+}
+//-------------------------------------------------------------------------------------------------------
+bool ReliabilityLayer::IsOverMemoryBudget(void) const
+{
+	return arena.IsOverBudget();
+}
+//-------------------------------------------------------------------------------------------------------
+void ReliabilityLayer::SetCongestionControl(CongestionControlType type)
+{
+	if (type==congestionControlType)
+		return;
+
+	CCRakNetInterface *newCongestionManager=AllocateCongestionControl(type);
+	newCongestionManager->Init(SLNet::GetTimeUS(), congestionManager->GetMTU());
+	newCongestionManager->SetDatagramSequenceNumbers(congestionManager->GetNextDatagramSequenceNumber(), congestionManager->GetExpectedNextDatagramSequenceNumber());
+	SLNet::OP_DELETE(congestionManager, _FILE_AND_LINE_);
+	congestionManager=newCongestionManager;
+	congestionControlType=type;
+}
+//-------------------------------------------------------------------------------------------------------
+CongestionControlType ReliabilityLayer::GetCongestionControl(void) const
+{
+	return congestionControlType;
+}
+//-------------------------------------------------------------------------------------------------------
+void ReliabilityLayer::SetPacing(unsigned int maxBurstDatagrams)
+{
+	pacingBurstDatagrams=maxBurstDatagrams;
+}
+//-------------------------------------------------------------------------------------------------------
+unsigned int ReliabilityLayer::GetPacing(void) const
+{
+	return pacingBurstDatagrams;
+}
+//-------------------------------------------------------------------------------------------------------
+void ReliabilityLayer::RefillPacingTokens(CCTimeType time)
+{
+	pacingRate=congestionManager->GetPacingRate();
+
+	// Same overflow safe test as in UpdateInternal()
+	if (time - lastPacingTime < (((CCTimeType)-1)/2))
+		pacingTokens+=pacingRate*(double)(time-lastPacingTime)/PACING_TIME_UNITS_PER_SECOND;
+	lastPacingTime=time;
+
+	double maxTokens=(double) pacingBurstDatagrams*(double) congestionManager->GetMTU();
+	if (maxTokens < pacingRate*(double)PACING_UPDATE_INTERVAL/PACING_TIME_UNITS_PER_SECOND)
+		maxTokens=pacingRate*(double)PACING_UPDATE_INTERVAL/PACING_TIME_UNITS_PER_SECOND;
+	if (pacingTokens>maxTokens)
+		pacingTokens=maxTokens;
+}
+//-------------------------------------------------------------------------------------------------------
+CCRakNetInterface *ReliabilityLayer::AllocateCongestionControl(CongestionControlType type)
+{
+	switch (type)
+	{
+	case UDT_CONGESTION_CONTROL:
+		return SLNet::OP_NEW<CCRakNetUDT>(_FILE_AND_LINE_);
+	case BBR_CONGESTION_CONTROL:
+		return SLNet::OP_NEW<CCRakNetBBR>(_FILE_AND_LINE_);
+	default:
+		return SLNet::OP_NEW<CCRakNetSlidingWindow>(_FILE_AND_LINE_);
+	}
+}
+//-------------------------------------------------------------------------------------------------------
+void ReliabilityLayer::OnMessageRefusedByMemoryBudget(void)
+{
+	messagesRefusedByMemoryBudget.Increment();
+}
+
 //-------------------------------------------------------------------------------------------------------
 // This will return true if we should not send at this time
 //-------------------------------------------------------------------------------------------------------
@@ -2539,12 +2900,12 @@ unsigned ReliabilityLayer::RemovePacketFromResendListAndDeleteOlderReliableSeque
 
 	//	bool deleted;
 	//	deleted=resendTree.Delete(messageNumber, internalPacket);
-	internalPacket = resendBuffer[messageNumber & RESEND_BUFFER_ARRAY_MASK];
+	internalPacket = resendBuffer ? resendBuffer[messageNumber & resendBufferMask] : 0;
 	// May ask to remove twice, for example resend twice, then second ack
 	if (internalPacket && internalPacket->reliableMessageNumber==messageNumber)
 	{
 	//	ValidateResendList();
-		resendBuffer[messageNumber & RESEND_BUFFER_ARRAY_MASK]=0;
+		resendBuffer[messageNumber & resendBufferMask]=0;
 		CC_DEBUG_PRINTF_2("AckRcv %i ", messageNumber);
 
 		statistics.messagesInResendBuffer--;
@@ -3041,7 +3402,10 @@ void ReliabilityLayer::SplitPacket( InternalPacket *internalPacket )
 	// This identifies which packet this is in the set
 	splitPacketIndex = 0;
 
+	// If the data is already reference counted, the parts add to that count rather than starting their own
 	InternalPacketRefCountedData *refCounter=0;
+	if (internalPacket->allocationScheme==InternalPacket::REF_COUNTED)
+		refCounter=internalPacket->refCountedData;
 
 	// Do a loop to send out all the packets
 	do
@@ -3069,6 +3433,9 @@ void ReliabilityLayer::SplitPacket( InternalPacket *internalPacket )
 		RakAssert(internalPacketArray[ splitPacketIndex ]->dataBitLength<BYTES_TO_BITS(MAXIMUM_MTU_SIZE));
 	} while ( ++splitPacketIndex < internalPacket->splitPacketCount );
 
+	if (internalPacket->allocationScheme==InternalPacket::ARENA)
+		refCounter->sharedDataBlockInArena=true;
+
 	splitPacketId++; // It's ok if this wraps to 0
 
 	//	InternalPacket *workingPacket;
@@ -3097,6 +3464,9 @@ void ReliabilityLayer::SplitPacket( InternalPacket *internalPacket )
 
 	// Do not delete, original is referenced by all split packets to avoid numerous allocations. See AllocInternalPacketData above
 	//	FreeInternalPacketData(internalPacket, _FILE_AND_LINE_ );
+	// Only drop the reference of the original, the parts still hold theirs
+	if (internalPacket->allocationScheme==InternalPacket::REF_COUNTED)
+		internalPacket->refCountedData->refCount--;
 	ReleaseToInternalPacketPool( internalPacket );
 
 	if (usedAlloca==false)
@@ -3487,6 +3857,15 @@ RakNetStatistics * ReliabilityLayer::GetStatistics( RakNetStatistics *rns )
 	rns->isLimitedByOutgoingBandwidthLimit=statistics.isLimitedByOutgoingBandwidthLimit;
 	rns->BPSLimitByOutgoingBandwidthLimit=statistics.BPSLimitByOutgoingBandwidthLimit;
 
+	rns->memoryBytesInUse=arena.GetBytesInUse();
+	rns->memoryBytesReserved=arena.GetBytesReserved();
+	rns->memoryBudget=arena.GetBudget();
+	rns->messagesRefusedByMemoryBudget=messagesRefusedByMemoryBudget.GetValue();
+
+	rns->pacingBytesPerSecond=pacingBurstDatagrams>0 ? (uint64_t) pacingRate : 0;
+	rns->lastBurstDatagrams=lastBurstDatagrams;
+	rns->largestBurstDatagrams=largestBurstDatagrams;
+
 	return rns;
 }
 
@@ -3555,7 +3934,7 @@ void ReliabilityLayer::PushPacket(CCTimeType time, InternalPacket *internalPacke
 // 		SLNet::TimeMS diff = curTime-t;
 // 	}
 
-	congestionManager.OnSendBytes(time, BITS_TO_BYTES(internalPacket->dataBitLength)+BITS_TO_BYTES(internalPacket->headerLength));
+	congestionManager->OnSendBytes(time, BITS_TO_BYTES(internalPacket->dataBitLength)+BITS_TO_BYTES(internalPacket->headerLength));
 }
 //-------------------------------------------------------------------------------------------------------
 void ReliabilityLayer::PushDatagram(void)
@@ -3709,7 +4088,7 @@ void ReliabilityLayer::SendACKs(RakNetSocket2 *s, SystemAddress &systemAddress,
 		bool hasBAndAS;
 		if (remoteSystemNeedsBAndAS)
 		{
-			congestionManager.OnSendAckGetBAndAS(time, &hasBAndAS,&B,&AS);
+			congestionManager->OnSendAckGetBAndAS(time, &hasBAndAS,&B,&AS);
 			dhf.AS=(float)AS;
 			dhf.hasBAndAS=hasBAndAS;
 		}
@@ -3724,10 +4103,10 @@ void ReliabilityLayer::SendACKs(RakNetSocket2 *s, SystemAddress &systemAddress,
 		CC_DEBUG_PRINTF_1("AckSnd ");
 		acknowlegements.Serialize(&updateBitStream, maxDatagramPayload, true);
 		SendBitStream( s, systemAddress, &updateBitStream, rnr, time );
-		congestionManager.OnSendAck(time,updateBitStream.GetNumberOfBytesUsed());
+		congestionManager->OnSendAck(time,updateBitStream.GetNumberOfBytesUsed());
 
 		// I think this is causing a bug where if the estimated bandwidth is very low for the recipient, only acks ever get sent
-		//	congestionManager.OnSendBytes(time,UDP_HEADER_SIZE+updateBitStream.GetNumberOfBytesUsed());
+		//	congestionManager->OnSendBytes(time,UDP_HEADER_SIZE+updateBitStream.GetNumberOfBytesUsed());
 	}
 }
 /*
@@ -3814,7 +4193,7 @@ void ReliabilityLayer::AddToUnreliableLinkedList(InternalPacket *internalPacket)
 void ReliabilityLayer::ValidateResendList(void) const
 {
 // 	unsigned int count1=0, count2=0;
-// 	for (unsigned int i=0; i < RESEND_BUFFER_ARRAY_LENGTH; i++)
+// 	for (unsigned int i=0; resendBuffer && i <= resendBufferMask; i++)
 // 	if (resendBuffer[i])
 // 	count1++;
 // 
@@ -3831,13 +4210,58 @@ void ReliabilityLayer::ValidateResendList(void) const
 // 	RakAssert(count2<=RESEND_BUFFER_ARRAY_LENGTH);
 }
 //-------------------------------------------------------------------------------------------------------
-bool ReliabilityLayer::ResendBufferOverflow(void) const
+bool ReliabilityLayer::ResendBufferOverflow(void)
 {
-	int index1 = sendReliableMessageNumberIndex & (uint32_t) RESEND_BUFFER_ARRAY_MASK;
-	//	int index2 = (sendReliableMessageNumberIndex+(uint32_t)1) & (uint32_t) RESEND_BUFFER_ARRAY_MASK;
-	RakAssert(index1<RESEND_BUFFER_ARRAY_LENGTH);
-	return resendBuffer[index1]!=0; // || resendBuffer[index2]!=0;
+	if (resendBuffer!=0 && resendBuffer[sendReliableMessageNumberIndex & resendBufferMask]==0)
+		return false;
 
+	// The message sent one buffer length ago is still in flight, so congestion control lets more messages out than the buffer holds
+	return GrowResendBuffer()==false;
+}
+//-------------------------------------------------------------------------------------------------------
+bool ReliabilityLayer::GrowResendBuffer(void)
+{
+	const uint32_t length = resendBuffer==0 ? (uint32_t) RESEND_BUFFER_INITIAL_LENGTH : (resendBufferMask+1)*2;
+	if (length > (uint32_t) RESEND_BUFFER_ARRAY_LENGTH)
+		return false;
+
+	InternalPacket **newResendBuffer = (InternalPacket **) arena.Allocate(length*sizeof(InternalPacket*), _FILE_AND_LINE_);
+	if (newResendBuffer==0)
+	{
+		notifyOutOfMemory(_FILE_AND_LINE_);
+		return false;
+	}
+	memset(newResendBuffer, 0, length*sizeof(InternalPacket*));
+
+	// Messages in flight span less than the old length, so they do not collide in the new one either
+	if (resendBuffer)
+	{
+		for (uint32_t i=0; i <= resendBufferMask; i++)
+		{
+			if (resendBuffer[i])
+				newResendBuffer[resendBuffer[i]->reliableMessageNumber & (length-1)]=resendBuffer[i];
+		}
+		arena.Release(resendBuffer, _FILE_AND_LINE_);
+	}
+	resendBuffer=newResendBuffer;
+	resendBufferMask=length-1;
+	return true;
+}
+//-------------------------------------------------------------------------------------------------------
+void ReliabilityLayer::ReleaseResendBuffer(void)
+{
+	if (resendBuffer)
+		arena.Release(resendBuffer, _FILE_AND_LINE_);
+	resendBuffer=0;
+	resendBufferMask=0;
+}
+//-------------------------------------------------------------------------------------------------------
+unsigned int ReliabilityLayer::GetDatagramHistoryLength(void) const
+{
+	// Each datagram in flight holds at least one reliable message, unless it is unreliable
+	if (resendBuffer && resendBufferMask+1 > DATAGRAM_MESSAGE_ID_ARRAY_LENGTH)
+		return resendBufferMask+1;
+	return DATAGRAM_MESSAGE_ID_ARRAY_LENGTH;
 }
 //-------------------------------------------------------------------------------------------------------
 ReliabilityLayer::MessageNumberNode* ReliabilityLayer::GetMessageNumberNodeByDatagramIndex(DatagramSequenceNumberType index, CCTimeType *timeSent)
@@ -3845,7 +4269,7 @@ ReliabilityLayer::MessageNumberNode* ReliabilityLayer::GetMessageNumberNodeByDat
 	if (datagramHistory.IsEmpty())
 		return nullptr;
 
-	if (congestionManager.LessThan(index, datagramHistoryPopCount))
+	if (CCRakNetInterface::LessThan(index, datagramHistoryPopCount))
 		return nullptr;
 
 	DatagramSequenceNumberType offsetIntoList = index - datagramHistoryPopCount;
@@ -3873,7 +4297,7 @@ void ReliabilityLayer::RemoveFromDatagramHistory(DatagramSequenceNumberType inde
 void ReliabilityLayer::AddFirstToDatagramHistory(DatagramSequenceNumberType datagramNumber, CCTimeType timeSent)
 {
 	(void) datagramNumber;
-	if (datagramHistory.Size()>DATAGRAM_MESSAGE_ID_ARRAY_LENGTH)
+	if (datagramHistory.Size()>GetDatagramHistoryLength())
 	{
 		RemoveFromDatagramHistory(datagramHistoryPopCount);
 		datagramHistory.Pop();
@@ -3888,7 +4312,7 @@ ReliabilityLayer::MessageNumberNode* ReliabilityLayer::AddFirstToDatagramHistory
 {
 	(void) datagramNumber;
 //	RakAssert(datagramHistoryPopCount+(unsigned int) datagramHistory.Size()==datagramNumber);
-	if (datagramHistory.Size()>DATAGRAM_MESSAGE_ID_ARRAY_LENGTH)
+	if (datagramHistory.Size()>GetDatagramHistoryLength())
 	{
 		RemoveFromDatagramHistory(datagramHistoryPopCount);
 		datagramHistory.Pop();
@@ -3921,6 +4345,8 @@ void ReliabilityLayer::AllocInternalPacketData(InternalPacket *internalPacket, I
 		// *refCounter = SLNet::OP_NEW<InternalPacketRefCountedData>(_FILE_AND_LINE_);
 		(*refCounter)->refCount=1;
 		(*refCounter)->sharedDataBlock=externallyAllocatedPtr;
+		(*refCounter)->sharedSendBuffer=0;
+		(*refCounter)->sharedDataBlockInArena=false;
 	}
 	else
 		(*refCounter)->refCount++;
@@ -3933,6 +4359,17 @@ void ReliabilityLayer::AllocInternalPacketData(InternalPacket *internalPacket, u
 	internalPacket->data=externallyAllocatedPtr;
 }
 //-------------------------------------------------------------------------------------------------------
+void ReliabilityLayer::AllocInternalPacketData(InternalPacket *internalPacket, SharedSendBuffer *sharedSendBuffer)
+{
+	// One reference of sharedSendBuffer for each reliability layer, the packets of this layer are counted by refCountedData
+	InternalPacketRefCountedData *refCounter=0;
+	AllocInternalPacketData(internalPacket, &refCounter, sharedSendBuffer->GetData(), sharedSendBuffer->GetData());
+	refCounter->sharedSendBuffer=sharedSendBuffer;
+	sharedSendBuffer->AddReference();
+	// Not owned by the arena, but counts against the memory budget of this layer as long as it is referenced
+	arena.AddExternalBytes((unsigned int) BITS_TO_BYTES(sharedSendBuffer->GetNumberOfBits()));
+}
+//-------------------------------------------------------------------------------------------------------
 void ReliabilityLayer::AllocInternalPacketData(InternalPacket *internalPacket, unsigned int numBytes, bool allowStack, const char *file, unsigned int line)
 {
 	if (allowStack && numBytes <= sizeof(internalPacket->stackData))
@@ -3940,6 +4377,11 @@ void ReliabilityLayer::AllocInternalPacketData(InternalPacket *internalPacket, u
 		internalPacket->allocationScheme=InternalPacket::STACK;
 		internalPacket->data=internalPacket->stackData;
 	}
+	else if (allowStack)
+	{
+		internalPacket->allocationScheme=InternalPacket::ARENA;
+		internalPacket->data=(unsigned char*) arena.Allocate(numBytes,file,line);
+	}
 	else
 	{
 		internalPacket->allocationScheme=InternalPacket::NORMAL;
@@ -3960,7 +4402,15 @@ void ReliabilityLayer::FreeInternalPacketData(InternalPacket *internalPacket, co
 		internalPacket->refCountedData->refCount--;
 		if (internalPacket->refCountedData->refCount==0)
 		{
-			rakFree_Ex(internalPacket->refCountedData->sharedDataBlock, file, line );
+			if (internalPacket->refCountedData->sharedSendBuffer)
+			{
+				arena.SubtractExternalBytes((unsigned int) BITS_TO_BYTES(internalPacket->refCountedData->sharedSendBuffer->GetNumberOfBits()));
+				internalPacket->refCountedData->sharedSendBuffer->Release(file, line);
+			}
+			else if (internalPacket->refCountedData->sharedDataBlockInArena)
+				arena.Release(internalPacket->refCountedData->sharedDataBlock, file, line );
+			else
+				rakFree_Ex(internalPacket->refCountedData->sharedDataBlock, file, line );
 			internalPacket->refCountedData->sharedDataBlock=0;
 			// SLNet::OP_DELETE(internalPacket->refCountedData,file, line);
 			refCountedDataPool.Release(internalPacket->refCountedData,file, line);
@@ -3975,6 +4425,11 @@ void ReliabilityLayer::FreeInternalPacketData(InternalPacket *internalPacket, co
 		rakFree_Ex(internalPacket->data, file, line );
 		internalPacket->data=0;
 	}
+	else if (internalPacket->allocationScheme==InternalPacket::ARENA)
+	{
+		arena.Release(internalPacket->data, file, line );
+		internalPacket->data=0;
+	}
 	else
 	{
 		// Data was on stack
@@ -3984,7 +4439,7 @@ void ReliabilityLayer::FreeInternalPacketData(InternalPacket *internalPacket, co
 //-------------------------------------------------------------------------------------------------------
 unsigned int ReliabilityLayer::GetMaxDatagramSizeExcludingMessageHeaderBytes(void)
 {
-	unsigned int val = congestionManager.GetMTU() - DatagramHeaderFormat::GetDataHeaderByteLength();
+	unsigned int val = congestionManager->GetMTU() - DatagramHeaderFormat::GetDataHeaderByteLength();
 
 #if LIBCAT_SECURITY==1
 	if (useSecurity)
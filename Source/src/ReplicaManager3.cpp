@@ -732,6 +732,19 @@ PluginReceiveResult ReplicaManager3::OnReceive(Packet *packet)
 
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
+bool ReplicaManager3::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_TIMESTAMP]=true;
+	messageIDs[ID_REPLICA_MANAGER_CONSTRUCTION]=true;
+	messageIDs[ID_REPLICA_MANAGER_SERIALIZE]=true;
+	messageIDs[ID_REPLICA_MANAGER_DOWNLOAD_STARTED]=true;
+	messageIDs[ID_REPLICA_MANAGER_DOWNLOAD_COMPLETE]=true;
+	messageIDs[ID_REPLICA_MANAGER_SCOPE_CHANGE]=true;
+	return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
 void Connection_RM3::AutoConstructByQuery(ReplicaManager3 *replicaManager3, WorldId worldId)
 {
 	ValidateLists(replicaManager3);
@@ -394,6 +394,16 @@ PluginReceiveResult Router2::OnReceive(Packet *packet)
 
 	return RR_CONTINUE_PROCESSING;
 }
+bool Router2::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_ROUTER_2_INTERNAL]=true;
+	messageIDs[ID_OUT_OF_BAND_INTERNAL]=true;
+	messageIDs[ID_ROUTER_2_FORWARDING_ESTABLISHED]=true;
+	messageIDs[ID_ROUTER_2_REROUTED]=true;
+	messageIDs[ID_CONNECTION_REQUEST_ACCEPTED]=true;
+	messageIDs[ID_ROUTER_2_FORWARDING_NO_PATH]=true;
+	return true;
+}
 void Router2::Update(void)
 {
 	SLNet::TimeMS curTime = SLNet::GetTimeMS();
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2026, SLikeSoft UG (haftungsbeschränkt)
+ *
+ *  This source code is licensed under the MIT-style license found in the
+ *  license.txt file in the root directory of this source tree.
+ */
+
+#include "slikenet/SharedSendBuffer.h"
+#include "slikenet/BitStream.h"
+#include "slikenet/memoryoverride.h"
+#include "slikenet/assert.h"
+#include <new>
+
+using namespace SLNet;
+
+SharedSendBuffer::SharedSendBuffer( unsigned char *_data, BitSize_t _numberOfBits ) : refCount(1)
+{
+	data=_data;
+	numberOfBits=_numberOfBits;
+}
+
+SharedSendBuffer *SharedSendBuffer::Allocate( unsigned int numberOfBytes, const char *file, unsigned int line )
+{
+	if (numberOfBytes==0)
+		return 0;
+
+	unsigned char *data = (unsigned char*) rakMalloc_Ex( numberOfBytes, file, line );
+	if (data==0)
+	{
+		notifyOutOfMemory(file, line);
+		return 0;
+	}
+	SharedSendBuffer *sharedSendBuffer = Create( data, BYTES_TO_BITS(numberOfBytes), file, line );
+	if (sharedSendBuffer==0)
+		rakFree_Ex( data, file, line );
+	return sharedSendBuffer;
+}
+
+SharedSendBuffer *SharedSendBuffer::Allocate( BitStream *bitStream, const char *file, unsigned int line )
+{
+	if (bitStream->GetNumberOfBitsUsed()==0)
+		return 0;
+
+	unsigned char *data;
+	const BitSize_t numberOfBits = bitStream->MoveData( &data );
+	SharedSendBuffer *sharedSendBuffer = Create( data, numberOfBits, file, line );
+	if (sharedSendBuffer==0)
+		rakFree_Ex( data, file, line );
+	return sharedSendBuffer;
+}
+
+void SharedSendBuffer::AddReference( void )
+{
+	refCount.Increment();
+}
+
+void SharedSendBuffer::Release( const char *file, unsigned int line )
+{
+	RakAssert(refCount.GetValue()>0);
+	if (refCount.Decrement()==0)
+	{
+		rakFree_Ex( data, file, line );
+		this->~SharedSendBuffer();
+		rakFree_Ex( this, file, line );
+	}
+}
+
+SharedSendBuffer *SharedSendBuffer::Create( unsigned char *_data, BitSize_t _numberOfBits, const char *file, unsigned int line )
+{
+	// The constructor is protected, so this does what OP_NEW would do
+	void *buffer = rakMalloc_Ex( sizeof(SharedSendBuffer), file, line );
+	if (buffer==0)
+	{
+		notifyOutOfMemory(file, line);
+		return 0;
+	}
+	return new (buffer) SharedSendBuffer( _data, _numberOfBits );
+}
@@ -159,6 +159,7 @@ bool TableSerializer::DeserializeRow(SLNet::BitStream *in, DataStructures::Table
 			return false;
 		}
 	}
+	out->UpdateIndices(key);
 	return true;
 }
 void TableSerializer::SerializeCell(SLNet::BitStream *out, DataStructures::Table::Cell *cell, DataStructures::Table::ColumnType columnType)
@@ -324,6 +324,15 @@ PluginReceiveResult TeamBalancer::OnReceive(Packet *packet)
 
 	return RR_CONTINUE_PROCESSING;
 }
+bool TeamBalancer::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_FCM2_NEW_HOST]=true;
+	messageIDs[ID_TEAM_BALANCER_INTERNAL]=true;
+	messageIDs[ID_TEAM_BALANCER_TEAM_ASSIGNED]=true;
+	messageIDs[ID_TEAM_BALANCER_REQUESTED_TEAM_FULL]=true;
+	messageIDs[ID_TEAM_BALANCER_REQUESTED_TEAM_LOCKED]=true;
+	return true;
+}
 void TeamBalancer::OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason )
 {
 	(void) systemAddress;
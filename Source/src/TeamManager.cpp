@@ -2263,6 +2263,17 @@ PluginReceiveResult TeamManager::OnReceive(Packet *packet)
 
 // --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
+bool TeamManager::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_FCM2_NEW_HOST]=true;
+	messageIDs[ID_TEAM_BALANCER_TEAM_ASSIGNED]=true;
+	messageIDs[ID_TEAM_BALANCER_TEAM_REQUESTED_CANCELLED]=true;
+	messageIDs[ID_TEAM_BALANCER_INTERNAL]=true;
+	return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
 void TeamManager::OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason )
 {
 	for (unsigned int i=0; i < worldsList.Size(); i++)
@@ -237,6 +237,16 @@ PluginReceiveResult TwoWayAuthentication::OnReceive(Packet *packet)
 	
 	return RR_CONTINUE_PROCESSING;
 }
+bool TwoWayAuthentication::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_TWO_WAY_AUTHENTICATION_NEGOTIATION]=true;
+	messageIDs[ID_TWO_WAY_AUTHENTICATION_OUTGOING_CHALLENGE_FAILURE]=true;
+	messageIDs[ID_TWO_WAY_AUTHENTICATION_OUTGOING_CHALLENGE_SUCCESS]=true;
+	messageIDs[ID_TWO_WAY_AUTHENTICATION_INCOMING_CHALLENGE_SUCCESS]=true;
+	messageIDs[ID_TWO_WAY_AUTHENTICATION_INCOMING_CHALLENGE_FAILURE]=true;
+	messageIDs[ID_TWO_WAY_AUTHENTICATION_OUTGOING_CHALLENGE_TIMEOUT]=true;
+	return true;
+}
 void TwoWayAuthentication::OnRakPeerShutdown(void)
 {
 	Clear();
@@ -246,6 +246,12 @@ PluginReceiveResult UDPProxyClient::OnReceive(Packet *packet)
 	}
 	return RR_CONTINUE_PROCESSING;
 }
+bool UDPProxyClient::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_UNCONNECTED_PONG]=true;
+	messageIDs[ID_UDP_PROXY_GENERAL]=true;
+	return true;
+}
 void UDPProxyClient::OnRakPeerShutdown(void)
 {
 	Clear();
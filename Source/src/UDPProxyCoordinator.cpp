@@ -136,6 +136,11 @@ PluginReceiveResult UDPProxyCoordinator::OnReceive(Packet *packet)
 	}
 	return RR_CONTINUE_PROCESSING;
 }
+bool UDPProxyCoordinator::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_UDP_PROXY_GENERAL]=true;
+	return true;
+}
 void UDPProxyCoordinator::OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason )
 {
 	(void) lostConnectionReason;
@@ -129,6 +129,11 @@ PluginReceiveResult UDPProxyServer::OnReceive(Packet *packet)
 	}
 	return RR_CONTINUE_PROCESSING;
 }
+bool UDPProxyServer::GetReceivedMessageIDs(bool messageIDs[256]) const
+{
+	messageIDs[ID_UDP_PROXY_GENERAL]=true;
+	return true;
+}
 void UDPProxyServer::OnClosedConnection(const SystemAddress &systemAddress, RakNetGUID rakNetGUID, PI2_LostConnectionReason lostConnectionReason )
 {
 	(void) lostConnectionReason;
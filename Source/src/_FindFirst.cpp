@@ -136,6 +136,7 @@ int _findnext(long h, _finddata_t *f)
                                  // directories only. Links currently
                                  // are not supported.
 
+                f->time_write = filestat.st_mtime;
                 f->size = filestat.st_size;
                 strncpy_s(f->name, entry->d_name, STRING_BUFFER_SIZE);
                 
@@ -237,12 +237,15 @@ errno_t strncpy_s(char *strDest, size_t numberOfElements, const char *strSource,
 		}
 	}
 	else {
-		// otherwise we use count, but have to check that the destination buffer is of sufficient size
-		if ((count > numberOfElements) || ((count == numberOfElements) && (strSource[count] != '\0'))) {
+		// otherwise we copy up to count characters, but have to check that the destination buffer is of sufficient size
+		numChars = 0;
+		while ((numChars < count) && (strSource[numChars] != '\0')) {
+			++numChars;
+		}
+		if (numChars >= numberOfElements) {
 			strDest[0] = '\0'; // ensure trailing \0 is written
 			return 34; // error: ERANGE
 		}
-		numChars = count;
 	}
 
 	(void)strncpy(strDest, strSource, numChars);